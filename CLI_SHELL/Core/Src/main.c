@@ -25,6 +25,18 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "CLI_SHELL.h"
+#include "CLI_SHELL_ART.h"
+#include "CLI_SHELL_UART.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_BOOT.h"
+#include "CLI_SHELL_CRASH.h"
+#include "CLI_SHELL_MPU.h"
+#include "CLI_SHELL_RTOS.h"
+#include "CLI_SHELL_DEFER.h"
+#if SHELL_RTOS_ENABLED
+#include "FreeRTOS.h"
+#include "task.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -44,7 +56,11 @@
 /* Private variables ---------------------------------------------------------*/
 
 /* USER CODE BEGIN PV */
-
+SHELL_CTX_DEFINE(operatorShell, SHELL_RX_RING_LEN);		/* CDC ACM virtual COM port */
+SHELL_CTX_DEFINE(automationShell, SHELL_RX_RING_LEN);	/* Vendor bulk interface */
+#if SHELL_UART_ENABLED
+SHELL_CTX_DEFINE(uartShell, SHELL_RX_RING_LEN);			/* USART1 with DMA */
+#endif
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -66,7 +82,13 @@ static void MX_GPIO_Init(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
-
+  shellBootStamp(bootStage_main);
+  shellCrashInit();
+  shellMpuInit();
+#if SHELL_FAST_BOOT
+  // The crystal starts up while HAL_Init() runs, SystemClock_Config() finds it ready
+  SET_BIT(RCC->CR, RCC_CR_HSEON);
+#endif
   /* USER CODE END 1 */
   
 
@@ -76,21 +98,72 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
-
+  shellBootStamp(bootStage_hal);
   /* USER CODE END Init */
 
   /* Configure the system clock */
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
-
+  shellBootStamp(bootStage_clock);
+  shellArtInit();
+#if SHELL_FAST_BOOT
+  // The shells first, MX_USB_DEVICE_Init() waits 50 ms for the forced device mode
+  shellInit(&operatorShell, &CDC_Transport_FS, CDC_CH_OPERATOR);
+  shellInit(&automationShell, &CDC_Transport_FS, CDC_CH_AUTOMATION);
+#if SHELL_UART_ENABLED
+  if (shellUartInit(SHELL_UART_BAUD))
+  {
+    shellInit(&uartShell, &shellUartTransport, 0);
+  }
+#endif
+  shellBootStamp(bootStage_shell);
+#endif
   /* USER CODE END SysInit */
 
   /* Initialize all configured peripherals */
   MX_GPIO_Init();
   MX_USB_DEVICE_Init();
   /* USER CODE BEGIN 2 */
-
+  shellBootStamp(bootStage_periph);
+#if !SHELL_FAST_BOOT
+  shellInit(&operatorShell, &CDC_Transport_FS, CDC_CH_OPERATOR);
+  shellInit(&automationShell, &CDC_Transport_FS, CDC_CH_AUTOMATION);
+#if SHELL_UART_ENABLED
+  if (shellUartInit(SHELL_UART_BAUD))
+  {
+    shellInit(&uartShell, &shellUartTransport, 0);
+  }
+#endif
+  shellBootStamp(bootStage_shell);
+#endif
+  shellBootStamp(bootStage_loop);
+#if SHELL_RTOS_ENABLED
+  {
+    // The shell task runs the loop below, the scheduler does not return
+    static shell_ctx_t* const shellInstances[] = {
+      &operatorShell,
+      &automationShell,
+#if SHELL_UART_ENABLED
+      &uartShell,
+#endif
+    };
+    shellRtosStart(shellInstances, sizeof(shellInstances) / sizeof(shellInstances[0]));
+    vTaskStartScheduler();
+  }
+#elif SHELL_DEFER_ENABLED
+  {
+    // PendSV runs the shell from here on, the loop below only sleeps
+    static shell_ctx_t* const shellInstances[] = {
+      &operatorShell,
+      &automationShell,
+#if SHELL_UART_ENABLED
+      &uartShell,
+#endif
+    };
+    shellDeferStart(shellInstances, sizeof(shellInstances) / sizeof(shellInstances[0]));
+  }
+#endif
   /* USER CODE END 2 */
 
   /* Infinite loop */
@@ -98,7 +171,16 @@ int main(void)
   while (1)
   {
 
-	  checkShellStatus();
+#if !SHELL_DEFER_ENABLED
+	  checkShellStatus(&operatorShell);
+	  checkShellStatus(&automationShell);
+#if SHELL_UART_ENABLED
+	  checkShellStatus(&uartShell);
+#endif
+#endif
+
+	  // Sleeps until the next interrupt unless one of them left work
+	  shellEventWait();
 
 
     /* USER CODE END WHILE */
@@ -128,9 +210,9 @@ void SystemClock_Config(void)
   RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
   RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSE;
   RCC_OscInitStruct.PLL.PLLM = 4;
-  RCC_OscInitStruct.PLL.PLLN = 72;
+  RCC_OscInitStruct.PLL.PLLN = 96;
   RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
-  RCC_OscInitStruct.PLL.PLLQ = 3;
+  RCC_OscInitStruct.PLL.PLLQ = 4;
   if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
   {
     Error_Handler();
@@ -144,7 +226,7 @@ void SystemClock_Config(void)
   RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
   RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
 
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_3) != HAL_OK)
   {
     Error_Handler();
   }
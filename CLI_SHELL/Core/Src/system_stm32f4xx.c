@@ -106,7 +106,7 @@
 /*!< Uncomment the following line if you need to relocate your vector Table in
      Internal SRAM. */
 /* #define VECT_TAB_SRAM */
-#define VECT_TAB_OFFSET  0x00 /*!< Vector Table base offset field. 
+#define VECT_TAB_OFFSET  0x10000 /*!< Vector Table base offset field, sector 4, start of the program (CLI_SHELL_FWUPDATE.h). 
                                    This value must be a multiple of 0x200. */
 /******************************************************************************/
 
@@ -77,6 +77,18 @@ defined in linker script */
 Reset_Handler:  
   ldr   sp, =_estack    		 /* set stack pointer */
 
+/* Start the DWT cycle counter from 0, the boot stages are stamped with it (CLI_SHELL_BOOT.h) */
+  ldr  r0, =0xE000EDFC           /* CoreDebug->DEMCR */
+  ldr  r1, [r0]
+  orr  r1, r1, #0x01000000       /* TRCENA */
+  str  r1, [r0]
+  ldr  r0, =0xE0001000           /* DWT->CTRL */
+  movs r1, #0
+  str  r1, [r0, #4]              /* DWT->CYCCNT */
+  ldr  r1, [r0]
+  orr  r1, r1, #1                /* CYCCNTENA */
+  str  r1, [r0]
+
 /* Copy the data segment initializers from flash to SRAM */  
   movs  r1, #0
   b  LoopCopyDataInit
@@ -93,6 +105,8 @@ LoopCopyDataInit:
   adds  r2, r0, r1
   cmp  r2, r3
   bcc  CopyDataInit
+  ldr  r0, =0xE0001004           /* DWT->CYCCNT */
+  ldr  r4, [r0]                  /* bootStage_data */
   ldr  r2, =_sbss
   b  LoopFillZerobss
 /* Zero fill the bss segment. */  
@@ -104,6 +118,31 @@ LoopFillZerobss:
   ldr  r3, = _ebss
   cmp  r2, r3
   bcc  FillZerobss
+  ldr  r5, [r0]                  /* bootStage_bss */
+
+/* Paint the free RAM up to the stack with SHELL_MEM_PAINT (CLI_SHELL_MEM.h), "mem" finds the stack peak.
+   Skipped with SHELL_FAST_BOOT (shellBootPaint = 0). */
+  ldr  r3, =shellBootPaint
+  ldrb r3, [r3]
+  cbz  r3, PaintDone
+  ldr  r3, =0xC5C5C5C5
+  b  LoopPaintStack
+PaintStack:
+  str  r3, [r2], #4
+
+LoopPaintStack:
+  cmp  r2, sp
+  bcc  PaintStack
+PaintDone:
+  ldr  r6, [r0]                  /* bootStage_paint */
+
+/* Store the startup stamps in shellBootTimes (zeroed above): recorded, then the cycles */
+  ldr  r1, =shellBootTimes
+  movs r3, #7
+  str  r3, [r1]
+  str  r4, [r1, #4]
+  str  r5, [r1, #8]
+  str  r6, [r1, #12]
 
 /* Call the clock system intitialization function.*/
   bl  SystemInit   
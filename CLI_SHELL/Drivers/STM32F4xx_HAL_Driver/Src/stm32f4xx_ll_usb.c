@@ -703,6 +703,7 @@ HAL_StatusTypeDef USB_EPStartXfer(USB_OTG_GlobalTypeDef *USBx, USB_OTG_EPTypeDef
   uint32_t USBx_BASE = (uint32_t)USBx;
   uint32_t epnum = (uint32_t)ep->num;
   uint16_t pktcnt;
+  uint32_t len;
 
   /* IN endpoint */
   if (ep->is_in == 1U)
@@ -762,8 +763,27 @@ HAL_StatusTypeDef USB_EPStartXfer(USB_OTG_GlobalTypeDef *USBx, USB_OTG_EPTypeDef
 
       if (ep->type != EP_TYPE_ISOC)
       {
-        /* Enable the Tx FIFO Empty Interrupt for this EP */
-        if (ep->xfer_len > 0U)
+        /* Load the packets that fit the FIFO now, instead of waiting for the
+           first Tx FIFO empty interrupt. The interrupt is not enabled yet, so
+           PCD_WriteEmptyTxFifo cannot write in between. */
+        while (ep->xfer_count < ep->xfer_len)
+        {
+          len = ep->xfer_len - ep->xfer_count;
+          if (len > ep->maxpacket)
+          {
+            len = ep->maxpacket;
+          }
+          if ((USBx_INEP(epnum)->DTXFSTS & USB_OTG_DTXFSTS_INEPTFSAV) < ((len + 3U) / 4U))
+          {
+            break;
+          }
+          (void)USB_WritePacket(USBx, ep->xfer_buff, ep->num, (uint16_t)len, dma);
+          ep->xfer_buff  += len;
+          ep->xfer_count += len;
+        }
+
+        /* Enable the Tx FIFO Empty Interrupt for this EP for the rest */
+        if (ep->xfer_count < ep->xfer_len)
         {
           USBx_DEVICE->DIEPEMPMSK |= 1UL << (ep->num & EP_ADDR_MSK);
         }
@@ -944,15 +964,37 @@ HAL_StatusTypeDef USB_WritePacket(USB_OTG_GlobalTypeDef *USBx, uint8_t *src, uin
 {
   uint32_t USBx_BASE = (uint32_t)USBx;
   uint32_t *pSrc = (uint32_t *)src;
+  __IO uint32_t *pFifo;
   uint32_t count32b, i;
 
   if (dma == 0U)
   {
     count32b = ((uint32_t)len + 3U) / 4U;
-    for (i = 0U; i < count32b; i++)
+    if (((uint32_t)src & 3U) == 0U)
+    {
+      /* Word aligned source: plain word loads, four FIFO pushes per iteration */
+      pFifo = &USBx_DFIFO((uint32_t)ch_ep_num);
+      for (i = count32b >> 2; i > 0U; i--)
+      {
+        *pFifo = pSrc[0];
+        *pFifo = pSrc[1];
+        *pFifo = pSrc[2];
+        *pFifo = pSrc[3];
+        pSrc += 4;
+      }
+      for (i = count32b & 3U; i > 0U; i--)
+      {
+        *pFifo = *pSrc;
+        pSrc++;
+      }
+    }
+    else
     {
-      USBx_DFIFO((uint32_t)ch_ep_num) = __UNALIGNED_UINT32_READ(pSrc);
-      pSrc++;
+      for (i = 0U; i < count32b; i++)
+      {
+        USBx_DFIFO((uint32_t)ch_ep_num) = __UNALIGNED_UINT32_READ(pSrc);
+        pSrc++;
+      }
     }
   }
 
@@ -970,8 +1012,48 @@ void *USB_ReadPacket(USB_OTG_GlobalTypeDef *USBx, uint8_t *dest, uint16_t len)
 {
   uint32_t USBx_BASE = (uint32_t)USBx;
   uint32_t *pDest = (uint32_t *)dest;
+  __IO uint32_t *pFifo;
   uint32_t i;
   uint32_t count32b = ((uint32_t)len + 3U) / 4U;
+  uint32_t word;
+  uint8_t *pTail;
+
+  if (((uint32_t)dest & 3U) == 0U)
+  {
+    /* Word aligned destination: plain word stores, four FIFO pops per iteration.
+       A partial last word is stored byte by byte, so nothing past len is written. */
+    pFifo = &USBx_DFIFO(0U);
+    count32b = (uint32_t)len / 4U;
+    for (i = count32b >> 2; i > 0U; i--)
+    {
+      pDest[0] = *pFifo;
+      pDest[1] = *pFifo;
+      pDest[2] = *pFifo;
+      pDest[3] = *pFifo;
+      pDest += 4;
+    }
+    for (i = count32b & 3U; i > 0U; i--)
+    {
+      *pDest = *pFifo;
+      pDest++;
+    }
+
+    i = (uint32_t)len & 3U;
+    if (i != 0U)
+    {
+      word = *pFifo;
+      pTail = (uint8_t *)pDest;
+      do
+      {
+        *pTail = (uint8_t)word;
+        pTail++;
+        word >>= 8;
+        i--;
+      } while (i != 0U);
+      pDest++;
+    }
+    return ((void *)pDest);
+  }
 
   for (i = 0U; i < count32b; i++)
   {
@@ -0,0 +1,208 @@
+#!/usr/bin/env python3
+"""Link benchmark of the CLI Shell: round trip percentiles and MB/s of one port.
+
+Drives the benchmark commands of CLI_SHELL_TPUT.h over a text session:
+
+    shell_bench.py /dev/ttyACM0                       # ping series, then the three directions
+    shell_bench.py usb --sizes 0,256,1024 -n 1000     # vendor interface (shell_usb.py)
+    shell_bench.py /dev/ttyACM0 --bytes 4000000 --no-ping
+
+"ping p<i> n<size>" is sent --count times per response size, one at a time, and
+the round trip is taken from the write of the line to the OK line. The report
+shows the percentiles (nearest rank) and the mean time between two pings on
+the device clock (PONG tick). "tput d0" (IN, "source"), "tput d1" (OUT, "sink") and
+"tput d2" (loopback) then move --bytes each. Every direction shows the MB/s of
+the host clock, from the command line to the result line, next to the MB/s the
+device reported.
+
+The port takes the names of shell_client.py (serial device, host:port,
+usb[:<serial>]) and must be in a text session ("mode m0"). Nothing else may
+talk to the board while it runs.
+"""
+
+import argparse
+import asyncio
+import math
+import re
+import sys
+import time
+
+from shell_client import TEXT_CODES, open_port
+
+OK = "-->OK!"
+RESULT = re.compile(rb"(IN|OUT|LOOP): (\d+) bytes in (\d+) ms, (\d+) B/s(?:, (\d+) dropped)?")
+PONG = re.compile(r"PONG (\d+) (\d+)")
+CHUNK = 4096
+FILL = b"U"  # anything but 0x03 (Ctrl-C) and the letters of the result line
+
+
+class Link:
+    """Raw bytes of one port, a line or a marker at a time."""
+
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+        self.buffer = bytearray()
+
+    async def _more(self, timeout):
+        data = await asyncio.wait_for(self.reader.read(CHUNK), timeout)
+        if not data:
+            raise ConnectionError("port closed")
+        self.buffer += data
+
+    async def line(self, timeout):
+        while True:
+            end = self.buffer.find(b"\n")
+            if end >= 0:
+                line = self.buffer[:end].decode(errors="replace").rstrip("\r")
+                del self.buffer[:end + 1]
+                return line
+            await self._more(timeout)
+
+    async def response(self, timeout):
+        """Output lines up to the response line, raises unless it is OK."""
+        lines = []
+        while True:
+            line = await self.line(timeout)
+            if line in TEXT_CODES:
+                if line != OK:
+                    raise RuntimeError("answered %s" % line)
+                return lines
+            lines.append(line)
+
+    async def skip_to(self, pattern, timeout):
+        """Drops raw bytes until pattern matches a whole line, returns (bytes dropped, groups)."""
+        dropped = 0
+        while True:
+            match = pattern.search(self.buffer)
+            if match and self.buffer.find(b"\n", match.end()) >= 0:
+                groups = match.groups()
+                dropped += match.start()
+                del self.buffer[:self.buffer.find(b"\n", match.end()) + 1]
+                return dropped, groups
+            for code in TEXT_CODES:
+                if code != OK and code.encode() in self.buffer:
+                    raise RuntimeError("answered %s" % code)
+            # Keep a tail that could be the start of the result line
+            keep = max(0, len(self.buffer) - 64)
+            dropped += keep
+            del self.buffer[:keep]
+            await self._more(timeout)
+
+    def write(self, data):
+        self.writer.write(data)
+
+    async def settle(self):
+        """Ends a partial line and drops whatever the port still had."""
+        self.write(b"\r")
+        await self.writer.drain()
+        await asyncio.sleep(0.2)
+        while True:
+            try:
+                await asyncio.wait_for(self.reader.read(CHUNK), 0.1)
+            except asyncio.TimeoutError:
+                break
+        self.buffer.clear()
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[max(0, math.ceil(p / 100.0 * len(ordered)) - 1)]
+
+
+async def ping_series(link, size, count, timeout):
+    rtts = []
+    device_ms = []
+    last = None
+    for i in range(count):
+        start = time.perf_counter()
+        link.write(("ping p%d n%d\r" % (i, size)).encode())
+        lines = await link.response(timeout)
+        rtts.append((time.perf_counter() - start) * 1e6)
+        match = next((m for m in map(PONG.search, lines) if m), None)
+        if match is None:
+            raise RuntimeError("no PONG line in %r" % lines)
+        tick = int(match.group(1))
+        if last is not None:
+            device_ms.append(tick - last)
+        last = tick
+    return rtts, device_ms
+
+
+async def tput(link, direction, total, timeout):
+    """Runs "tput d<direction> n<total>", returns (host seconds, groups of the result line)."""
+    start = time.perf_counter()
+    link.write(("tput d%d n%d\r" % (direction, total)).encode())
+    await link.writer.drain()
+
+    if direction == 0:
+        received, result = await link.skip_to(RESULT, timeout)
+    else:
+        async def send():
+            left = total
+            while left:
+                n = min(left, CHUNK)
+                link.write(FILL * n)
+                await link.writer.drain()
+                left -= n
+
+        sender = asyncio.ensure_future(send())
+        try:
+            received, result = await link.skip_to(RESULT, timeout)
+        finally:
+            await sender
+    elapsed = time.perf_counter() - start
+    await link.response(timeout)
+    if direction == 2 and received < total:
+        raise RuntimeError("loopback: %d of %d bytes came back" % (received, total))
+    return elapsed, result
+
+
+async def run(args):
+    reader, writer = await open_port(args.port, args.baud)
+    link = Link(reader, writer)
+    try:
+        await link.settle()
+
+        if args.ping:
+            print("ping, %d each     p50 us   p90 us   p99 us   max us  device ms/ping" % args.count)
+            for size in args.sizes:
+                rtts, device_ms = await ping_series(link, size, args.count, args.timeout)
+                per_ping = sum(device_ms) / len(device_ms) if device_ms else 0
+                print("%5d bytes     %9.0f%9.0f%9.0f%9.0f  %.3f" % (
+                    size, percentile(rtts, 50), percentile(rtts, 90), percentile(rtts, 99), max(rtts), per_ping))
+
+        if args.tput:
+            print("direction          bytes   host MB/s  device MB/s")
+            for direction, name in ((0, "IN (source)"), (1, "OUT (sink)"), (2, "loopback")):
+                elapsed, result = await tput(link, direction, args.bytes, args.timeout)
+                moved = int(result[1])
+                dropped = int(result[4] or 0)
+                extra = "  (%d dropped by the device)" % dropped if dropped else ""
+                print("%-14s %10d %11.3f %12.3f%s" % (
+                    name, moved, moved / elapsed / 1e6, int(result[3]) / 1e6, extra))
+    finally:
+        writer.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial device, host:port or usb[:<serial>]")
+    parser.add_argument("-n", "--count", type=int, default=200, help="pings per response size")
+    parser.add_argument("--sizes", default="0,64,256,1024",
+                        type=lambda text: [int(size) for size in text.split(",")],
+                        help="ping response pad sizes, up to SHELL_PING_MAX_PAD")
+    parser.add_argument("--bytes", type=int, default=1000000, help="bytes per tput direction")
+    parser.add_argument("--no-ping", dest="ping", action="store_false", help="skip the ping series")
+    parser.add_argument("--no-tput", dest="tput", action="store_false", help="skip the throughput tests")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds without data before giving up")
+    parser.add_argument("--baud", type=int, default=115200, help="UART port baud rate")
+    args = parser.parse_args()
+
+    if sys.platform == "win32":
+        asyncio.set_event_loop_policy(asyncio.WindowsProactorEventLoopPolicy())
+    asyncio.run(run(args))
+
+
+if __name__ == "__main__":
+    main()
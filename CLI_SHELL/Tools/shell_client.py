@@ -0,0 +1,580 @@
+#!/usr/bin/env python3
+"""Host client of the CLI Shell: pipelined commands to many boards at once.
+
+Speaks the text protocol (tagged lines, "#42 -->OK!") and the binary frames of
+CLI_SHELL_BINARY.h from one asyncio event loop, epoll on Linux, IOCP on Windows.
+
+    shell_client.py /dev/ttyACM0 -c ver                 # one board, one command
+    shell_client.py /dev/ttyACM* -c ver -c clock         # every board, both commands
+    shell_client.py /dev/ttyACM0 10.0.0.7:5000 -c "perf" -n 100   # 100 each, pipelined
+
+A port is a serial device (raw mode, no baud rate setting needed for USB CDC,
+--baud for a USART), "host:port" for a TCP link or "usb[:<serial>]" for the
+vendor bulk interface through libusb (shell_usb.py). On Windows serial ports
+need pyserial and are read by a thread per board.
+
+As a library:
+
+    async with await Board.open("/dev/ttyACM0") as board:
+        rsp = await board.command("setLed l1 s1")   # Response, rsp.ok, rsp.output
+        await board.enter_binary()
+        rsp = await board.call("setLed", l=u8(1), s=u8(1))
+
+    fleet = await Fleet.open(["/dev/ttyACM0", "/dev/ttyACM1"])
+    results = await fleet.command("ver")            # {port: Response}
+    await fleet.sync()                              # one synced clock (CLI_SHELL_TSYNC.h)
+    await fleet.arm("PB4", "gpio p0 s0x20")          # runs on every board at the sync edge
+
+Every text line goes out with a tag of its own and is answered by tag, binary
+requests by seq, so any number can be in flight. A USB port loses no input: the
+device holds its OUT endpoint back (NAK) while the receive ring is full and the
+host controller retries, so requests go out as fast as they are made. A USART
+has no such flow control, what does not fit the receive ring (SHELL_RX_RING_LEN,
+256 bytes on the smallest profile) is lost. On a USART link, a TCP bridge to one
+included, the client keeps at most --window bytes of requests unanswered and
+holds the next one back until answers free enough of them.
+
+Output lines of a bridge carry no tag. They go to the oldest request still
+waiting, which is the one running as long as the answers come in order. A job
+(CLI_SHELL_JOB.h) answers out of order: the output of the lines run meanwhile
+has then gone to the job, or the job's output to them. Those answers are not
+trusted silently, Response.suspect marks every request whose output may be
+someone else's or incomplete. Lines that come while nothing is waiting (an
+"every" command) are kept in Board.unsolicited.
+"""
+
+import argparse
+import asyncio
+import os
+import re
+import struct
+import sys
+import time
+
+from shell_lz import CRC_LEN, HEADER_LEN, RESPONSES, SOF_RSP, STATUS_MORE, STATUS_PACKED, crc16, unpack
+
+SOF_REQ = 0xA5
+SOF_REQ_LEN = 7  # header and CRC of a request frame
+MAX_PAYLOAD = 255
+TAG_LIMIT = 1000000000  # SHELL_TAG_DIGITS
+WINDOW = 256  # USART links only
+USB_VID = 1155  # USBD_VID, USBD_PID_FS of usbd_desc.c
+USB_PID = 22336
+
+# Response line text (after the tag) -> response code
+TEXT_CODES = {
+    "-->OK!": 0,
+    "-->Function Error!": 1,
+    "Command Error!": 2,
+    "Argument Error!": 3,
+    "Line Too Long!": 4,
+    "Frame Error!": 5,
+    "-->Cancelled!": 6,
+}
+TAGGED = re.compile(r"^#(\d+) (.*)$")
+
+
+def u8(value):
+    return struct.pack("<B", value)
+
+
+def u16(value):
+    return struct.pack("<H", value)
+
+
+def u32(value):
+    return struct.pack("<I", value)
+
+
+def f32(value):
+    return struct.pack("<f", value)
+
+
+def tlv(token, value):
+    """One TLV of a request payload. value is bytes (see u8() etc.), str or None for a flag."""
+    if value is None or value is True:
+        value = b""
+    elif isinstance(value, str):
+        value = value.encode()
+    elif not isinstance(value, (bytes, bytearray)):
+        raise TypeError("argument %s: give bytes, u8()/u16()/u32()/f32(), str or None" % token)
+    return bytes([ord(token) - ord("a"), len(value)]) + bytes(value)
+
+
+class Response:
+    """Answer to one request: response code and the output that came with it."""
+
+    def __init__(self, code, output, suspect=False):
+        self.code = code
+        self.output = output  # str in text mode, bytes (CBOR or text) in binary mode
+        self.suspect = suspect  # answered out of order, output may belong to another request
+
+    @property
+    def ok(self):
+        return self.code == 0
+
+    @property
+    def name(self):
+        return RESPONSES[self.code] if self.code < len(RESPONSES) else str(self.code)
+
+    def __repr__(self):
+        return "Response(%s, %r%s)" % (self.name, self.output, ", suspect" if self.suspect else "")
+
+
+class _Pending:
+    def __init__(self, future, size, on_done=None):
+        self.future = future
+        self.size = size
+        self.output = []
+        self.on_done = on_done
+        self.suspect = False
+
+
+class _TtyWriter:
+    """Non-blocking writes to a serial device, the rest goes out when the fd is writable."""
+
+    def __init__(self, loop, fd):
+        self.loop = loop
+        self.fd = fd
+        self.buffer = bytearray()
+        self.empty = asyncio.Event()
+        self.empty.set()
+
+    def write(self, data):
+        self.buffer += data
+        self._flush()
+
+    def _flush(self):
+        try:
+            sent = os.write(self.fd, self.buffer) if self.buffer else 0
+        except BlockingIOError:
+            sent = 0
+        del self.buffer[:sent]
+        if self.buffer:
+            self.empty.clear()
+            self.loop.add_writer(self.fd, self._flush)
+        else:
+            self.loop.remove_writer(self.fd)
+            self.empty.set()
+
+    async def drain(self):
+        await self.empty.wait()
+
+    def close(self):
+        self.loop.remove_reader(self.fd)
+        self.loop.remove_writer(self.fd)
+        os.close(self.fd)
+
+
+class _ThreadWriter:
+    """pyserial port written from the loop, read by a thread (Windows)."""
+
+    def __init__(self, ser):
+        self.ser = ser
+
+    def write(self, data):
+        self.ser.write(data)
+
+    async def drain(self):
+        pass
+
+    def close(self):
+        self.ser.close()
+
+
+def usart_link(port):
+    """Whether port reaches the shell through a USART (or a TCP bridge to one), not USB."""
+    if port == "usb" or port.startswith("usb:"):
+        return False
+    host, _, tcp = port.rpartition(":")
+    if host and tcp.isdigit():
+        return True
+    if os.name == "nt":
+        from serial.tools import list_ports
+
+        return not any(info.device.upper() == port.upper() and info.vid == USB_VID and info.pid == USB_PID
+                       for info in list_ports.comports())
+    name = os.path.basename(os.path.realpath(port))
+    return not name.startswith(("ttyACM", "cu.usbmodem", "tty.usbmodem"))
+
+
+async def open_port(port, baud=115200):
+    """Returns (StreamReader, writer) for a serial device, "host:port" or "usb[:<serial>]"."""
+    if port == "usb" or port.startswith("usb:"):
+        from shell_usb import open_vendor  # pyusb, only needed for the vendor interface
+
+        return await open_vendor(port)
+    loop = asyncio.get_running_loop()
+    host, _, tcp = port.rpartition(":")
+    if host and tcp.isdigit():
+        return await asyncio.open_connection(host, int(tcp))
+
+    reader = asyncio.StreamReader()
+    if os.name == "nt":
+        import serial  # pyserial, only needed for serial ports on Windows
+        import threading
+
+        ser = serial.Serial(port, baud, timeout=0.05)
+
+        def pump():
+            while ser.is_open:
+                try:
+                    data = ser.read(ser.in_waiting or 1)
+                except serial.SerialException:
+                    break
+                if data:
+                    loop.call_soon_threadsafe(reader.feed_data, data)
+            loop.call_soon_threadsafe(reader.feed_eof)
+
+        threading.Thread(target=pump, daemon=True).start()
+        return reader, _ThreadWriter(ser)
+
+    import termios
+    import tty
+
+    fd = os.open(port, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+    tty.setraw(fd)
+    attrs = termios.tcgetattr(fd)
+    speed = getattr(termios, "B%d" % baud, termios.B115200)
+    attrs[4] = attrs[5] = speed
+    attrs[2] |= termios.CLOCAL | termios.CREAD
+    termios.tcsetattr(fd, termios.TCSANOW, attrs)
+    termios.tcflush(fd, termios.TCIOFLUSH)
+
+    def readable():
+        try:
+            data = os.read(fd, 4096)
+        except BlockingIOError:
+            return
+        except OSError:
+            data = b""
+        if data:
+            reader.feed_data(data)
+        else:
+            loop.remove_reader(fd)
+            reader.feed_eof()
+
+    loop.add_reader(fd, readable)
+    return reader, _TtyWriter(loop, fd)
+
+
+class Board:
+    """One shell port. All requests of a board share its reader task and its window."""
+
+    def __init__(self, name, reader, writer, window=0):
+        self.name = name
+        self.reader = reader
+        self.writer = writer
+        self.window = window  # 0 without a limit
+        self.binary = False
+        self.commands = None  # name -> cmdIdx, from "help"
+        self.unsolicited = []
+        self._inflight = 0
+        self._credit = asyncio.Condition()
+        self._pending = {}  # tag or seq -> _Pending, in the order sent
+        self._tag = 0
+        self._seq = 0
+        self._task = asyncio.ensure_future(self._read())
+
+    @classmethod
+    async def open(cls, port, window=None, baud=115200):
+        """window None takes WINDOW for a USART link and no limit for USB."""
+        if window is None:
+            window = WINDOW if usart_link(port) else 0
+        reader, writer = await open_port(port, baud)
+        return cls(port, reader, writer, window)
+
+    async def __aenter__(self):
+        return self
+
+    async def __aexit__(self, *exc):
+        await self.close()
+
+    async def close(self):
+        self._task.cancel()
+        self.writer.close()
+        for pending in self._pending.values():
+            if not pending.future.done():
+                pending.future.set_exception(ConnectionError("%s closed" % self.name))
+        self._pending.clear()
+
+    # Window -----------------------------------------------------------------
+
+    async def _take(self, size):
+        if not self.window:
+            return 0
+        size = min(size, self.window)
+        async with self._credit:
+            await self._credit.wait_for(lambda: self._inflight + size <= self.window)
+            self._inflight += size
+        return size
+
+    def _give(self, size):
+        if not size:
+            return
+        self._inflight -= size
+
+        async def notify():
+            async with self._credit:
+                self._credit.notify_all()
+
+        asyncio.ensure_future(notify())
+
+    async def idle(self):
+        """Waits until every request sent so far is answered."""
+        while self._pending:
+            await asyncio.gather(*(p.future for p in list(self._pending.values())), return_exceptions=True)
+
+    # Requests ---------------------------------------------------------------
+
+    async def _send(self, key, data, size, timeout, on_done=None):
+        future = asyncio.get_running_loop().create_future()
+        self._pending[key] = _Pending(future, size, on_done)
+        self.writer.write(data)
+        await self.writer.drain()
+        try:
+            return await asyncio.wait_for(asyncio.shield(future), timeout)
+        except asyncio.TimeoutError:
+            # A late answer is then kept as unsolicited
+            if self._pending.pop(key, None) is not None:
+                self._give(size)
+            raise
+
+    async def command(self, line, timeout=5.0, _on_done=None):
+        """Sends one text line, returns its Response once the tagged answer came."""
+        if self.binary:
+            raise RuntimeError("%s is in binary mode" % self.name)
+        self._tag = (self._tag + 1) % TAG_LIMIT
+        tag = self._tag
+        data = ("#%d %s\r" % (tag, line)).encode()
+        size = await self._take(len(data))
+        return await self._send(tag, data, size, timeout, _on_done)
+
+    async def call(self, command, timeout=5.0, **args):
+        """Sends one binary request, command is a name or a cmdIdx, args are TLVs (see tlv())."""
+        if not self.binary:
+            raise RuntimeError("%s is in text mode" % self.name)
+        index = self.commands[command] if isinstance(command, str) else command
+        payload = b"".join(tlv(token, value) for token, value in args.items())
+        if len(payload) > MAX_PAYLOAD:
+            raise ValueError("payload of %d bytes" % len(payload))
+        size = await self._take(SOF_REQ_LEN + len(payload))
+        # The window keeps far fewer than 256 requests in flight, a free seq is always found
+        while self._seq in self._pending:
+            self._seq = (self._seq + 1) & 0xFF
+        seq = self._seq
+        self._seq = (self._seq + 1) & 0xFF
+        body = bytes([seq]) + struct.pack("<HB", index, len(payload)) + payload
+        data = bytes([SOF_REQ]) + body + struct.pack("<H", crc16(body))
+        leaving = index == self.commands.get("mode") and args.get("m") == u8(0)
+        return await self._send(seq, data, size, timeout, self._leave_binary if leaving else None)
+
+    async def load_commands(self):
+        """Reads the command indices of the binary protocol from "help"."""
+        rsp = await self.command("help")
+        names = [line.split("\t", 1)[0] for line in rsp.output.splitlines() if "\t| " in line]
+        self.commands = {name: i for i, name in enumerate(names[1:])}  # first one is the heading
+        return self.commands
+
+    async def enter_binary(self, compress=False):
+        """Switches the session to binary frames ("mode m1")."""
+        if self.commands is None:
+            await self.load_commands()
+        await self.idle()
+        rsp = await self.command("mode m1" + (" z1" if compress else ""), _on_done=self._enter_binary)
+        if not rsp.ok:
+            raise RuntimeError("%s: mode m1 answered %s" % (self.name, rsp.name))
+
+    async def leave_binary(self):
+        await self.idle()
+        await self.call("mode", m=u8(0))
+
+    def _enter_binary(self, rsp):
+        # Switched by the reader right after the OK line, the next bytes are frames
+        self.binary = rsp.ok
+
+    def _leave_binary(self, rsp):
+        self.binary = not rsp.ok
+
+    # Answers ----------------------------------------------------------------
+
+    def _finish(self, key, code, output):
+        pending = self._pending.pop(key, None)
+        if pending is None:
+            self.unsolicited.append(output)
+            return
+        self._give(pending.size)
+        rsp = Response(code, output, pending.suspect)
+        if pending.on_done is not None:
+            pending.on_done(rsp)
+        if not pending.future.done():
+            pending.future.set_result(rsp)
+
+    async def _read(self):
+        buffer = bytearray()
+        parts = {}
+        try:
+            while True:
+                data = await self.reader.read(4096)
+                if not data:
+                    break
+                buffer += data
+                if self.binary:
+                    self._frames(buffer, parts)
+                else:
+                    self._lines(buffer, parts)
+        finally:
+            for pending in list(self._pending.values()):
+                if not pending.future.done():
+                    pending.future.set_exception(ConnectionError("%s closed" % self.name))
+
+    def _lines(self, buffer, parts):
+        while not self.binary:
+            end = buffer.find(b"\n")
+            if end < 0:
+                return
+            line = buffer[:end].decode(errors="replace").rstrip("\r")
+            del buffer[:end + 1]
+            match = TAGGED.match(line)
+            if match and match.group(2) in TEXT_CODES:
+                tag = int(match.group(1))
+                pending = self._pending.get(tag)
+                if pending is not None and next(iter(self._pending)) != tag:
+                    # Out of order: what this line printed went to the older ones, or theirs to it
+                    for other in self._pending.values():
+                        other.suspect = True
+                        if other is pending:
+                            break
+                self._finish(tag, TEXT_CODES[match.group(2)], "\n".join(pending.output) if pending else "")
+            elif self._pending:
+                next(iter(self._pending.values())).output.append(line)
+            else:
+                self.unsolicited.append(line)
+        # The rest of the buffer is framed already
+        self._frames(buffer, parts)
+
+    def _frames(self, buffer, parts):
+        while True:
+            start = buffer.find(bytes([SOF_RSP]))
+            if start < 0:
+                buffer.clear()
+                return
+            del buffer[:start]
+            if len(buffer) < HEADER_LEN:
+                return
+            end = HEADER_LEN + buffer[3] + CRC_LEN
+            if len(buffer) < end:
+                return
+            body = bytes(buffer[1:end - CRC_LEN])
+            if crc16(body) != buffer[end - CRC_LEN] | (buffer[end - 1] << 8):
+                # Stream/watch frame or damage, look for the next SOF
+                del buffer[:1]
+                continue
+            del buffer[:end]
+            seq, status, data = body[0], body[1], body[HEADER_LEN - 1:]
+            parts.setdefault(seq, bytearray()).extend(data)
+            if status & STATUS_MORE:
+                continue
+            data = bytes(parts.pop(seq))
+            if status & STATUS_PACKED:
+                data = unpack(data)
+            self._finish(seq, status & ~(STATUS_MORE | STATUS_PACKED), data)
+            if not self.binary:
+                # "mode m0" was answered, text follows
+                self._lines(buffer, parts)
+                return
+
+
+class Fleet:
+    """Many boards driven from one event loop."""
+
+    def __init__(self, boards):
+        self.boards = boards
+
+    @classmethod
+    async def open(cls, ports, window=None, baud=115200):
+        return cls(await asyncio.gather(*(Board.open(port, window, baud) for port in ports)))
+
+    async def close(self):
+        await asyncio.gather(*(board.close() for board in self.boards))
+
+    async def command(self, line, timeout=5.0):
+        """Runs line on every board, returns {board name: Response or exception}."""
+        results = await asyncio.gather(*(board.command(line, timeout) for board in self.boards),
+                                       return_exceptions=True)
+        return {board.name: rsp for board, rsp in zip(self.boards, results)}
+
+    async def sync(self, timeout=5.0):
+        """Gives every board the same time sync epoch, the frame the first board is at.
+
+        The boards must share the host controller. The frame numbers wrap after 2 s,
+        the epoch has to reach every board before that (CLI_SHELL_TSYNC.h).
+        """
+        rsp = await self.boards[0].command("tsync", timeout)
+        match = re.search(r"frame (\d+)", rsp.output)
+        if not rsp.ok or not match:
+            raise RuntimeError("%s: no SOF frame in %r" % (self.boards[0].name, rsp.output))
+        return await self.command("tsync f%s" % match.group(1), min(timeout, 1.0))
+
+    async def arm(self, pin, line, timeout=5.0):
+        """Arms the same command line on every board, run by the next edge of pin.
+
+        pin is "P<port><pin>" with an optional edge, "PB4-" (CLI_SHELL_ARM.h). Each board
+        reports the fire in Board.unsolicited, "Fired: OK, at <us> us, ...".
+        """
+        results = await self.command("arm %s %s" % (pin, line), timeout)
+        failed = [name for name, rsp in results.items() if isinstance(rsp, Exception) or not rsp.ok]
+        if failed:
+            await self.command("arm d1", timeout)
+            raise RuntimeError("arm failed on %s" % ", ".join(failed))
+        return results
+
+
+async def run(args):
+    fleet = await Fleet.open(args.ports, args.window, args.baud)
+    try:
+        for line in args.command:
+            start = time.monotonic()
+            jobs = [asyncio.gather(*(board.command(line, args.timeout) for _ in range(args.count)),
+                                   return_exceptions=True) for board in fleet.boards]
+            results = await asyncio.gather(*jobs)
+            elapsed = time.monotonic() - start
+            for board, rsps in zip(fleet.boards, results):
+                last = rsps[-1]
+                failed = sum(1 for rsp in rsps if not isinstance(rsp, Response) or not rsp.ok)
+                if args.count == 1:
+                    print("%s> %s: %s" % (board.name, line, last.name if isinstance(last, Response) else last))
+                    if isinstance(last, Response) and last.suspect:
+                        print("%s> answered out of order, the output may belong to another request" % board.name)
+                    if isinstance(last, Response) and last.output:
+                        print(last.output)
+                else:
+                    suspect = sum(1 for rsp in rsps if isinstance(rsp, Response) and rsp.suspect)
+                    print("%s> %s: %d sent, %d failed%s" % (board.name, line, args.count, failed,
+                                                           ", %d out of order" % suspect if suspect else ""))
+            if args.count > 1:
+                total = args.count * len(fleet.boards)
+                print("%d commands in %.3f s (%.0f/s)" % (total, elapsed, total / elapsed))
+    finally:
+        await fleet.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("ports", nargs="+", help="serial devices or host:port")
+    parser.add_argument("-c", "--command", action="append", required=True, help="command line, repeatable")
+    parser.add_argument("-n", "--count", type=int, default=1, help="send each command this often, pipelined")
+    parser.add_argument("--window", type=int, default=None,
+                        help="request bytes unanswered per board, 0 for no limit (default %d on a USART "
+                             "link, none on USB)" % WINDOW)
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds per answer")
+    parser.add_argument("--baud", type=int, default=115200, help="UART port baud rate")
+    args = parser.parse_args()
+
+    if sys.platform == "win32":
+        asyncio.set_event_loop_policy(asyncio.WindowsProactorEventLoopPolicy())
+    asyncio.run(run(args))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,203 @@
+/** @file shell_fuzz.c
+ *
+ * @brief libFuzzer harness of the CLI Shell core: text lines, binary frames and the parser
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Runs against the host build of the core (CLI_SHELL_HOST.h). From USB_DEVICE/App:
+ *      clang -g -O1 -fsanitize=fuzzer,address,undefined -DSHELL_HOST_BUILD=1 -I.
+ *         ../../Tools/shell_fuzz.c CLI_SHELL.c CLI_SHELL_BINARY.c CLI_SHELL_BENCH.c
+ *         CLI_SHELL_BOOT.c CLI_SHELL_CACHE.c CLI_SHELL_CONVERT.c CLI_SHELL_CRC.c CLI_SHELL_EDIT.c
+ *         CLI_SHELL_FORMAT.c CLI_SHELL_GATEWAY.c CLI_SHELL_HISTORY.c CLI_SHELL_HOST.c
+ *         CLI_SHELL_JOB.c CLI_SHELL_LZ.c CLI_SHELL_NOTIFY.c CLI_SHELL_PERF.c CLI_SHELL_PIPE.c
+ *         CLI_SHELL_POOL.c CLI_SHELL_RESULT.c CLI_SHELL_REGRESS.c CLI_SHELL_RING.c
+ *         CLI_SHELL_TRACE.c CLI_SHELL_URGENT.c CLI_SHELL_VAR.c CLI_SHELL_VM.c -o shell_fuzz
+ *      ./shell_fuzz -max_len=2048 corpus/
+ *  - The first byte of an input picks the path, the rest is the data:
+ *      0 - text session: the bytes go to shellHostFeed() as typed (lines, editing keys, Ctrl-C)
+ *      1 - binary session: after "mode m1" the data is cut into request frames. Each frame takes
+ *          | seq | cmdIdx (2) | payloadLen | payload | from the data, the harness adds the SOF
+ *          and a valid CRC16, so the mutations reach the TLV decoding and the commands.
+ *      2 - binary session, raw: the data goes unchanged after "mode m1" (resync, bad CRCs)
+ *      3 - parser: one line through tokenizeLine(), matchCommand() and validateArgs() directly
+ *  - Every input starts on a fresh instance (shellInit() again), text mode. Variables, the
+ *    history and the statistics of the core carry over from one input to the next.
+ *  - Without libFuzzer (gcc), -DSHELL_FUZZ_MAIN=1 instead of -fsanitize=fuzzer adds a main() that
+ *    runs every file named on the command line once, e.g. to replay a crash or a corpus.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define FUZZ_PATH_TEXT			0
+#define FUZZ_PATH_FRAMES		1
+#define FUZZ_PATH_RAW			2
+#define FUZZ_PATH_PARSER		3
+#define FUZZ_NUM_PATHS			4
+
+#define FUZZ_FRAME_FIELDS		4			/*!< seq, cmdIdx (2), payloadLen taken from the data	*/
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+SHELL_CTX_DEFINE(fuzzCtx, 256);
+
+static const uint8_t binaryMode[] = "mode m1\r";
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+// Parser internals of CLI_SHELL.c, not part of CLI_SHELL.h
+shell_error cleanParserOutput(shellParserOutput_t* cmdParseOut);
+shell_error tokenizeLine(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut);
+bool validateArgs(shellParserOutput_t* cmdParserOutput, uint16_t commandIndex);
+
+static void fuzzFrames(const uint8_t* data, size_t size);
+static void fuzzParser(const uint8_t* data, size_t size);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Cuts the data into request frames with a valid SOF and CRC16 and feeds them
+  * @note	A payload length beyond the data left is cut down to it. A last piece shorter than
+  * 		the frame fields is dropped.
+  * @param[IN]  data Frame fields and payloads back to back
+  * @param[IN]  size Number of bytes
+  * @retval NONE
+  */
+static void fuzzFrames(const uint8_t* data, size_t size) {
+	uint8_t frame[SHELL_BIN_FRAME_LEN];
+
+	while (size >= FUZZ_FRAME_FIELDS) {
+		size_t payloadLen = data[3];
+
+		if (payloadLen > size - FUZZ_FRAME_FIELDS) {
+			payloadLen = size - FUZZ_FRAME_FIELDS;
+		}
+
+		frame[0] = SHELL_BIN_SOF_REQ;
+		memcpy(&frame[1], data, FUZZ_FRAME_FIELDS);
+		frame[4] = (uint8_t)payloadLen;
+		memcpy(&frame[SHELL_BIN_REQ_HEADER_LEN], data + FUZZ_FRAME_FIELDS, payloadLen);
+
+		uint32_t len = SHELL_BIN_REQ_HEADER_LEN + payloadLen;
+		uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &frame[1], len - 1);
+		frame[len++] = (uint8_t)crc;
+		frame[len++] = (uint8_t)(crc >> 8);
+
+		shellHostFeed(&fuzzCtx, frame, len);
+		data += FUZZ_FRAME_FIELDS + payloadLen;
+		size -= FUZZ_FRAME_FIELDS + payloadLen;
+	}
+}
+
+/**
+  * @brief  Runs one line through the parser stages the dispatcher uses
+  * @note	The line is copied into a buffer of the size of the instance line buffer, longer
+  * 		data is cut, as assembleLine() would.
+  * @param[IN]  data Line without the terminator
+  * @param[IN]  size Number of bytes
+  * @retval NONE
+  */
+static void fuzzParser(const uint8_t* data, size_t size) {
+	uint8_t line[SHELL_BUFFER_LEN + 1];
+	shellParserOutput_t out;
+	int16_t index = -1;
+
+	if (size > SHELL_BUFFER_LEN) {
+		size = SHELL_BUFFER_LEN;
+	}
+	memcpy(line, data, size);
+
+	cleanParserOutput(&out);
+	if (tokenizeLine(line, (uint32_t)size, &out) != SHELL_OK) {
+		return;
+	}
+	if (matchCommand(&out, &index) == SHELL_OK && index >= 0) {
+		validateArgs(&out, (uint16_t)index);
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  libFuzzer entry point, one input
+  * @param[IN]  data Path selector, then the data
+  * @param[IN]  size Number of bytes
+  * @retval int Always 0
+  */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+	if (size == 0) {
+		return 0;
+	}
+
+	shellHostOutput = NULL;
+	if (shellInit(&fuzzCtx, &shellHostTransport, 0) != SHELL_OK) {
+		abort();
+	}
+
+	switch (data[0] % FUZZ_NUM_PATHS) {
+		case FUZZ_PATH_TEXT:
+			shellHostFeed(&fuzzCtx, data + 1, (uint32_t)(size - 1));
+			break;
+		case FUZZ_PATH_FRAMES:
+			shellHostFeed(&fuzzCtx, binaryMode, sizeof(binaryMode) - 1);
+			fuzzFrames(data + 1, size - 1);
+			break;
+		case FUZZ_PATH_RAW:
+			shellHostFeed(&fuzzCtx, binaryMode, sizeof(binaryMode) - 1);
+			shellHostFeed(&fuzzCtx, data + 1, (uint32_t)(size - 1));
+			break;
+		default:
+			fuzzParser(data + 1, size - 1);
+			break;
+	}
+	return 0;
+}
+
+#if SHELL_FUZZ_MAIN
+/**
+  * @brief  Runs every file named on the command line once, for builds without libFuzzer
+  * @param[IN]  argc Number of arguments
+  * @param[IN]  argv Input files
+  * @retval int 0, 1 if a file could not be read
+  */
+int main(int argc, char** argv) {
+	static uint8_t input[1 << 20];
+
+	for (int i = 1; i < argc; i++) {
+		FILE* file = fopen(argv[i], "rb");
+
+		if (file == NULL) {
+			perror(argv[i]);
+			return 1;
+		}
+		size_t size = fread(input, 1, sizeof(input), file);
+		fclose(file);
+		LLVMFuzzerTestOneInput(input, size);
+	}
+	return 0;
+}
+#endif
+
+/*** end of file ***/
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""Unpacks the compressed responses of a binary CLI Shell session.
+
+Reads what the device sent in a binary session started with "mode m1 z1"
+(a capture of the port, or stdin) and prints every response it finds, see
+CLI_SHELL_LZ.h for the format and CLI_SHELL_BINARY.h for the frames.
+
+    shell_lz.py capture.bin
+    shell_lz.py capture.bin --hex       # data as hex instead of text
+    shell_lz.py capture.bin --raw out   # unpacked data of all responses
+
+Responses are joined from their frames (SHELL_BIN_STATUS_MORE) and unpacked if
+SHELL_BIN_STATUS_PACKED is set. Each one shows its seq, response code, the data
+size and what it took on the wire. unpack() can be imported by other tools.
+"""
+
+import argparse
+import sys
+
+SOF_RSP = 0x5A
+HEADER_LEN = 4
+CRC_LEN = 2
+STATUS_MORE = 0x80
+STATUS_PACKED = 0x40
+
+WINDOW = 256
+MIN_MATCH = 3
+
+RESPONSES = ["OK", "FNC_ERR", "CMD_ERR", "ARG_ERR", "LEN_ERR", "FRAME_ERR", "CANCELLED"]
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC16 of CLI_SHELL_BINARY.h (CCITT, polynomial 0x1021)."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def unpack(data):
+    """Unpacks the data of one response (the data of all its frames joined)."""
+    out = bytearray(WINDOW)  # the window starts as zeros
+    i = 0
+    while i < len(data):
+        flags = data[i]
+        i += 1
+        for bit in range(8):
+            if i >= len(data):
+                break
+            if flags & (1 << bit):
+                if i + 1 >= len(data):
+                    raise ValueError("match cut short at byte %d" % i)
+                distance, length = data[i], data[i + 1] + MIN_MATCH
+                i += 2
+                if distance == 0:
+                    raise ValueError("distance 0 at byte %d" % (i - 2))
+                for _ in range(length):
+                    out.append(out[-distance])
+            else:
+                out.append(data[i])
+                i += 1
+    return bytes(out[WINDOW:])
+
+
+def frames(capture):
+    """Yields (seq, status, data) of every response frame with a good CRC."""
+    i = 0
+    while i + HEADER_LEN + CRC_LEN <= len(capture):
+        if capture[i] != SOF_RSP:
+            i += 1
+            continue
+        length = capture[i + 3]
+        end = i + HEADER_LEN + length + CRC_LEN
+        if end > len(capture):
+            break
+        body = capture[i + 1:end - CRC_LEN]
+        crc = capture[end - CRC_LEN] | (capture[end - 1] << 8)
+        if crc16(body) != crc:
+            # Stream/watch frames or a damaged frame, look for the next SOF
+            i += 1
+            continue
+        yield body[0], body[1], body[HEADER_LEN - 1:]
+        i = end
+
+
+def responses(capture):
+    """Yields (seq, code, data, wire bytes) per response, data unpacked."""
+    parts = {}
+    for seq, status, data in frames(capture):
+        wire = parts.setdefault(seq, [bytearray(), 0])
+        wire[0] += data
+        wire[1] += HEADER_LEN + len(data) + CRC_LEN
+        if status & STATUS_MORE:
+            continue
+        data, size = parts.pop(seq)
+        if status & STATUS_PACKED:
+            data = unpack(bytes(data))
+        yield seq, status & ~(STATUS_MORE | STATUS_PACKED), bytes(data), size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", nargs="?", help="capture of the session, stdin without")
+    parser.add_argument("--hex", action="store_true", help="print the data as hex")
+    parser.add_argument("--raw", help="write the unpacked data of all responses to this file")
+    args = parser.parse_args()
+
+    if args.file:
+        with open(args.file, "rb") as f:
+            capture = f.read()
+    else:
+        capture = sys.stdin.buffer.read()
+
+    total = wire = 0
+    raw = bytearray()
+    for seq, code, data, size in responses(capture):
+        name = RESPONSES[code] if code < len(RESPONSES) else str(code)
+        print("seq %3d %-9s %6d bytes, %6d on the wire" % (seq, name, len(data), size))
+        if data:
+            print(data.hex(" ") if args.hex else data.decode(errors="replace"))
+        total += len(data)
+        wire += size
+        raw += data
+
+    if wire:
+        print("%d bytes of data in %d bytes of frames (%.2fx)" % (total, wire, total / wire))
+    if args.raw:
+        with open(args.raw, "wb") as f:
+            f.write(raw)
+
+
+if __name__ == "__main__":
+    main()
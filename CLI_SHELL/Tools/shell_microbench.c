@@ -0,0 +1,213 @@
+/** @file shell_microbench.c
+ *
+ * @brief Host microbenchmark of the CLI Shell parser: tokenizeLine(), matchCommand() and validateArgs()
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Runs against the host build of the core (CLI_SHELL_HOST.h). From USB_DEVICE/App:
+ *      cc -O2 -DSHELL_HOST_BUILD=1 -I. ../../Tools/shell_microbench.c CLI_SHELL.c
+ *         CLI_SHELL_BINARY.c CLI_SHELL_BENCH.c CLI_SHELL_BOOT.c CLI_SHELL_CACHE.c
+ *         CLI_SHELL_CONVERT.c CLI_SHELL_CRC.c CLI_SHELL_EDIT.c CLI_SHELL_FORMAT.c
+ *         CLI_SHELL_GATEWAY.c CLI_SHELL_HISTORY.c CLI_SHELL_HOST.c CLI_SHELL_JOB.c CLI_SHELL_LZ.c
+ *         CLI_SHELL_NOTIFY.c CLI_SHELL_PERF.c CLI_SHELL_PIPE.c CLI_SHELL_POOL.c CLI_SHELL_RESULT.c
+ *         CLI_SHELL_REGRESS.c CLI_SHELL_RING.c CLI_SHELL_TRACE.c CLI_SHELL_URGENT.c
+ *         CLI_SHELL_VAR.c CLI_SHELL_VM.c -o shell_microbench
+ *      ./shell_microbench [seconds per case, default 0.2]
+ *  - Each stage is timed on its own over the lines of benchCases[]: the tokenizer on a fresh copy
+ *    of the line, the lookup and the argument validation on a tokenized line (the validated flag
+ *    is cleared every round, so the conversion runs each time). The line copy and the parser
+ *    output reset are timed alone as "copy" and subtracted from the tokenizer.
+ *  - The rounds double until a case ran for the time given, the report shows nanoseconds per
+ *    call of the last run (CLOCK_MONOTONIC). "bench" on the target measures the whole pipeline
+ *    in cycles, this is the reference for changes to the parser on a PC.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "CLI_SHELL.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define MICRO_MIN_ROUNDS		64U
+#define MICRO_DEFAULT_SECONDS	0.2
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef enum {
+	microStage_copy,
+	microStage_tokenize,
+	microStage_match,
+	microStage_validate,
+	NUM_OF_MICRO_STAGES
+} microStage_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+SHELL_CTX_DEFINE(microCtx, 256);
+
+/**
+  * @brief  Lines of the benchmark, without the terminator. Plain, padded, prefix, extra and error paths.
+  */
+static const char* const benchCases[] = {
+	"setLed l1 s0",
+	"   setLed    l2     s1   ",
+	"setLed l1 s1 q9 z7 x3",
+	"mode m0",
+	"ver",
+	"help",
+	"noSuchCommand a1",
+};
+
+#define NUM_OF_BENCH_CASES		(sizeof(benchCases) / sizeof(benchCases[0]))
+
+static const char* const stageNames[NUM_OF_MICRO_STAGES] = { "copy", "tokenize", "match", "validate" };
+
+static volatile uint32_t microSink;				/*!< Keeps the results alive at -O2	*/
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+// Parser internals of CLI_SHELL.c, not part of CLI_SHELL.h
+shell_error cleanParserOutput(shellParserOutput_t* cmdParseOut);
+shell_error tokenizeLine(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut);
+bool validateArgs(shellParserOutput_t* cmdParserOutput, uint16_t commandIndex);
+
+static double microSeconds(void);
+static void microRun(microStage_t stage, const char* text, uint32_t rounds);
+static double microTime(microStage_t stage, const char* text, double seconds);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Monotonic time
+  * @param  NONE
+  * @retval double Seconds
+  */
+static double microSeconds(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+  * @brief  Calls one stage a number of times on one line
+  * @param[IN]  stage Stage to run
+  * @param[IN]  text Line without the terminator
+  * @param[IN]  rounds Number of calls
+  * @retval NONE
+  */
+static void microRun(microStage_t stage, const char* text, uint32_t rounds) {
+	uint8_t line[SHELL_BUFFER_LEN + 1];
+	shellParserOutput_t out;
+	uint32_t len = (uint32_t)strlen(text);
+	int16_t index = -1;
+
+	// Match and validate start from the tokenized line
+	memcpy(line, text, len);
+	cleanParserOutput(&out);
+	tokenizeLine(line, len, &out);
+	matchCommand(&out, &index);
+
+	for (uint32_t i = 0; i < rounds; i++) {
+		switch (stage) {
+			case microStage_copy:
+				memcpy(line, text, len);
+				cleanParserOutput(&out);
+				microSink += line[0];
+				break;
+			case microStage_tokenize:
+				memcpy(line, text, len);
+				cleanParserOutput(&out);
+				microSink += (uint32_t)tokenizeLine(line, len, &out) + out.numArgs;
+				break;
+			case microStage_match:
+				microSink += (uint32_t)matchCommand(&out, &index) + (uint32_t)index;
+				break;
+			default:
+				if (index >= 0) {
+					out.validated = false;
+					microSink += validateArgs(&out, (uint16_t)index);
+				}
+				break;
+		}
+	}
+}
+
+/**
+  * @brief  Doubles the rounds of a stage until they take the time given
+  * @param[IN]  stage Stage to run
+  * @param[IN]  text Line without the terminator
+  * @param[IN]  seconds Minimum run time
+  * @retval double Nanoseconds per call of the last run
+  */
+static double microTime(microStage_t stage, const char* text, double seconds) {
+	uint32_t rounds = MICRO_MIN_ROUNDS;
+
+	while (true) {
+		double start = microSeconds();
+		microRun(stage, text, rounds);
+		double elapsed = microSeconds() - start;
+
+		if (elapsed >= seconds || rounds >= (UINT32_MAX / 2U)) {
+			return elapsed * 1e9 / rounds;
+		}
+		rounds *= 2U;
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Times every stage on every line and prints the table
+  * @param[IN]  argc Number of arguments
+  * @param[IN]  argv Seconds per case (optional)
+  * @retval int 0, 1 if the instance could not be initialized
+  */
+int main(int argc, char** argv) {
+	double seconds = (argc > 1) ? atof(argv[1]) : MICRO_DEFAULT_SECONDS;
+	double ns[NUM_OF_MICRO_STAGES];
+
+	// shellInit() builds the name index matchCommand() looks the commands up in
+	shellHostOutput = NULL;
+	if (shellInit(&microCtx, &shellHostTransport, 0) != SHELL_OK) {
+		fprintf(stderr, "shellInit failed\n");
+		return 1;
+	}
+
+	printf("%-28s %10s %10s %10s %10s\n", "line (ns/call)", stageNames[microStage_tokenize],
+			stageNames[microStage_match], stageNames[microStage_validate], "total");
+	for (uint32_t i = 0; i < NUM_OF_BENCH_CASES; i++) {
+		for (uint8_t stage = 0; stage < NUM_OF_MICRO_STAGES; stage++) {
+			ns[stage] = microTime((microStage_t)stage, benchCases[i], seconds);
+		}
+
+		double tokenize = ns[microStage_tokenize] - ns[microStage_copy];
+		if (tokenize < 0) {
+			tokenize = 0;
+		}
+		printf("%-28.28s %10.1f %10.1f %10.1f %10.1f\n", benchCases[i], tokenize, ns[microStage_match],
+				ns[microStage_validate], tokenize + ns[microStage_match] + ns[microStage_validate]);
+	}
+	return 0;
+}
+
+/*** end of file ***/
@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Turns a "trace d1" export of the CLI Shell into a timeline.
+
+Reads the export straight from the shell port (needs pyserial) or from a file
+captured earlier, see CLI_SHELL_TRACE.h for the format.
+
+    shell_trace.py --port /dev/ttyACM0          # sends "trace d1", decodes the answer
+    shell_trace.py --port /dev/ttyACM0 --save trace.bin
+    shell_trace.py trace.bin
+
+Every line shows the time since the first entry, the time since the previous
+entry and the event. Exports of a locked time sync ("TRC2", CLI_SHELL_TSYNC.h)
+add the time of the entries since the last reset on the synced clock, the same
+on every board of the host controller. The ring survives a soft reset, the cycle counter does not:
+the timeline starts over at a "reset" entry. A summary of the time between the stages of each command
+(receive, parser, bridge, transmit) follows.
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = b"TRC2"
+MAGIC_V1 = b"TRC1"  # without the sync fields
+HEADER = struct.Struct("<4sIII")
+SYNC = struct.Struct("<III")
+ENTRY = struct.Struct("<IBBH")
+NO_PORT = 0xFF
+
+EVENTS = {
+    1: "rx",
+    2: "cmdStart",
+    3: "bridgeStart",
+    4: "bridgeEnd",
+    5: "txStart",
+    6: "txDone",
+    7: "reset",
+    8: "overrun",
+}
+
+# Stage name: event that starts it, event that ends it
+STAGES = [
+    ("rx -> cmdStart", "rx", "cmdStart"),
+    ("cmdStart -> bridgeStart", "cmdStart", "bridgeStart"),
+    ("bridge", "bridgeStart", "bridgeEnd"),
+    ("bridgeEnd -> txStart", "bridgeEnd", "txStart"),
+    ("txStart -> txDone", "txStart", "txDone"),
+]
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC16 of CLI_SHELL_BINARY.h (CCITT, polynomial 0x1021)."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if (crc & 0x8000) else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def read_port(port, baud):
+    import serial  # pyserial, only needed for --port
+
+    with serial.Serial(port, baud, timeout=2) as ser:
+        ser.reset_input_buffer()
+        ser.write(b"trace d1\r")
+        # Skip anything still queued in front of the export
+        window = b""
+        while window not in (MAGIC, MAGIC_V1):
+            byte = ser.read(1)
+            if not byte:
+                raise SystemExit("no trace export received")
+            window = (window + byte)[-len(MAGIC):]
+        size = HEADER.size + (SYNC.size if window == MAGIC else 0)
+        header = window + ser.read(size - len(MAGIC))
+        count = HEADER.unpack(header)[1]
+        body = ser.read(count * ENTRY.size)
+        line = ser.read_until(b"\n")
+        ser.read_until(b"\n")  # command response
+    return header + body, line.decode(errors="replace")
+
+
+def decode(data, line=None):
+    magic, count, clock, lost = HEADER.unpack_from(data)
+    if magic not in (MAGIC, MAGIC_V1):
+        raise SystemExit("not a trace export")
+    size = HEADER.size
+    sync = None
+    if magic == MAGIC:
+        sync = SYNC.unpack_from(data, size)
+        size += SYNC.size
+    end = size + count * ENTRY.size
+    if len(data) < end:
+        raise SystemExit("export cut short: %d of %d bytes" % (len(data), end))
+    if line:
+        match = re.search(r"CRC 0x([0-9A-Fa-f]{4})", line)
+        if match and int(match.group(1), 16) != crc16(data[:end]):
+            print("warning: CRC mismatch, the export is damaged", file=sys.stderr)
+    entries = [ENTRY.unpack_from(data, size + i * ENTRY.size) for i in range(count)]
+    return entries, clock, lost, sync
+
+
+def synced(cycles, sync):
+    """Synced time of a cycle stamp, from the SOF reference of the header."""
+    sof_cycles, sof_us, per_ms = sync
+    diff = (cycles - sof_cycles) & 0xFFFFFFFF
+    if diff >= 1 << 31:
+        diff -= 1 << 32
+    return (sof_us + diff * 1000 / per_ms) % (1 << 32)
+
+
+def timeline(entries, clock, lost, sync=None):
+    us = 1e6 / clock
+    print("%d entries, %d Hz, %d lost to overwrites" % (len(entries), clock, lost))
+    if not entries:
+        return
+    if sync and not sync[2]:
+        sync = None
+    # Only entries after the last reset share the cycle counter of the reference
+    since = max([i for i, entry in enumerate(entries) if EVENTS.get(entry[1]) == "reset"] + [0])
+
+    start = entries[0][0]
+    prev = start
+    elapsed = 0
+    last = {}
+    stages = {name: [] for name, _, _ in STAGES}
+
+    for index, (cycles, event, port, arg) in enumerate(entries):
+        if EVENTS.get(event) == "reset":
+            # Kept over a reset, the counter started again from 0
+            print("---- reset ----")
+            elapsed = 0
+            prev = cycles
+            last.clear()
+        # The counter wraps every 2^32 cycles, differences stay valid
+        elapsed += (cycles - prev) & 0xFFFFFFFF
+        delta = (cycles - prev) & 0xFFFFFFFF
+        prev = cycles
+        name = EVENTS.get(event, "user%d" % event if event >= 0x80 else "event%d" % event)
+        where = "-" if port == NO_PORT else str(port)
+        at = ""
+        if sync:
+            at = "%14.3f us  " % synced(cycles, sync) if index >= since else "%14s     " % "-"
+        print("%s%12.3f us %+10.3f us  port %s  %-12s %d" % (at, elapsed * us, delta * us, where, name, arg))
+
+        for stage, first, second in STAGES:
+            if name == second and (port, first) in last:
+                stages[stage].append(((cycles - last.pop((port, first))) & 0xFFFFFFFF) * us)
+        last[(port, name)] = cycles
+
+    print()
+    print("%-24s %6s %10s %10s %10s" % ("stage", "count", "min us", "mean us", "max us"))
+    for stage, _, _ in STAGES:
+        times = stages[stage]
+        if times:
+            print("%-24s %6d %10.3f %10.3f %10.3f"
+                  % (stage, len(times), min(times), sum(times) / len(times), max(times)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("file", nargs="?", help="export captured earlier")
+    parser.add_argument("--port", help="shell port, sends \"trace d1\"")
+    parser.add_argument("--baud", type=int, default=115200, help="UART port baud rate")
+    parser.add_argument("--save", help="also write the raw export to this file")
+    args = parser.parse_args()
+
+    line = None
+    if args.port:
+        data, line = read_port(args.port, args.baud)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("give a file or --port")
+
+    if args.save:
+        with open(args.save, "wb") as f:
+            f.write(data)
+
+    timeline(*decode(data, line))
+
+
+if __name__ == "__main__":
+    main()
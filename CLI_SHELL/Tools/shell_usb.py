@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""libusb client of the CLI Shell: the vendor bulk interface, without a serial driver.
+
+The automation shell of the board sits on interface 2 of the composite device,
+EP 0x03 OUT and EP 0x83 IN (usbd_composite.h). No tty, no line coding: the
+bytes of the text lines and binary frames go straight to the bulk pipes.
+Needs pyusb and the libusb-1.0 runtime. Windows binds WinUSB on its own
+(MS OS descriptors), Linux needs read/write access to the device node (udev).
+
+    shell_usb.py --list                              # boards found, with serial numbers
+    shell_usb.py -c ver                              # the first board
+    shell_usb.py -s 3276359F3039 -c "perf" -n 100    # one board, 100 pipelined
+    shell_usb.py --all -c ver                        # every board
+
+The port name "usb" or "usb:<serial>" opens the same link in shell_client.py,
+as a library too:
+
+    async with await Board.open("usb:3276359F3039") as board:
+        await board.enter_binary()
+
+USB holds the OUT endpoint back while the receive ring of the board is full,
+no input is lost and no request window is needed.
+"""
+
+import argparse
+import asyncio
+import queue
+import sys
+import threading
+
+from shell_client import USB_PID, USB_VID, run
+
+VND_INTERFACE = 2
+VND_OUT_EP = 0x03
+VND_IN_EP = 0x83
+VND_PACKET = 64  # VND_DATA_FS_MAX_PACKET_SIZE
+READ_TIMEOUT_MS = 100
+
+
+def find(serial=None):
+    """The boards on the bus, or the one with that serial number."""
+    import usb.core
+
+    devices = list(usb.core.find(find_all=True, idVendor=USB_VID, idProduct=USB_PID))
+    if serial is not None:
+        devices = [dev for dev in devices if dev.serial_number == serial]
+    return devices
+
+
+class VendorLink:
+    """Claimed vendor interface of one board, read by a thread, written by another."""
+
+    def __init__(self, dev):
+        import usb.util
+
+        self.dev = dev
+        self.name = "usb:%s" % dev.serial_number
+        if sys.platform.startswith("linux") and dev.is_kernel_driver_active(VND_INTERFACE):
+            dev.detach_kernel_driver(VND_INTERFACE)
+        usb.util.claim_interface(dev, VND_INTERFACE)
+        self._out = queue.Queue()
+        self._open = True
+
+    def start(self, loop, reader):
+        """Feeds reader from the IN endpoint and writes the queued data to the OUT endpoint."""
+        threading.Thread(target=self._pump_in, args=(loop, reader), daemon=True).start()
+        threading.Thread(target=self._pump_out, daemon=True).start()
+
+    def _pump_in(self, loop, reader):
+        import usb.core
+
+        while self._open:
+            try:
+                # One packet per transfer: a response ending on a full packet has no ZLP
+                data = bytes(self.dev.read(VND_IN_EP, VND_PACKET, READ_TIMEOUT_MS))
+            except usb.core.USBTimeoutError:
+                continue
+            except usb.core.USBError:
+                break
+            if data:
+                loop.call_soon_threadsafe(reader.feed_data, data)
+        loop.call_soon_threadsafe(reader.feed_eof)
+
+    def _pump_out(self):
+        import usb.core
+
+        while True:
+            data = self._out.get()
+            if data is None:
+                return
+            try:
+                # No timeout: a full receive ring NAKs, the write waits for room
+                self.dev.write(VND_OUT_EP, data, 0)
+            except usb.core.USBError:
+                return
+
+    def write(self, data):
+        self._out.put(bytes(data))
+
+    async def drain(self):
+        pass
+
+    def close(self):
+        import usb.util
+
+        self._open = False
+        self._out.put(None)
+        usb.util.release_interface(self.dev, VND_INTERFACE)
+        usb.util.dispose_resources(self.dev)
+
+
+async def open_vendor(port):
+    """Returns (StreamReader, writer) for "usb" (the first board) or "usb:<serial>"."""
+    _, _, serial = port.partition(":")
+    devices = find(serial or None)
+    if not devices:
+        raise ConnectionError("%s: no board found" % port)
+    reader = asyncio.StreamReader()
+    link = VendorLink(devices[0])
+    link.start(asyncio.get_running_loop(), reader)
+    return reader, link
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--list", action="store_true", help="list the boards and exit")
+    parser.add_argument("-s", "--serial", action="append", help="board serial number, repeatable")
+    parser.add_argument("--all", action="store_true", help="every board on the bus")
+    parser.add_argument("-c", "--command", action="append", help="command line, repeatable")
+    parser.add_argument("-n", "--count", type=int, default=1, help="send each command this often, pipelined")
+    parser.add_argument("--timeout", type=float, default=5.0, help="seconds per answer")
+    args = parser.parse_args()
+
+    if args.list:
+        for dev in find():
+            print("usb:%s  bus %d address %d" % (dev.serial_number, dev.bus, dev.address))
+        return
+    if not args.command:
+        parser.error("give a command (-c) or --list")
+
+    if args.all:
+        args.ports = ["usb:%s" % dev.serial_number for dev in find()]
+    else:
+        args.ports = ["usb:%s" % serial for serial in args.serial] if args.serial else ["usb"]
+    if not args.ports:
+        sys.exit("no board found")
+    args.window = 0
+    args.baud = 0
+    asyncio.run(run(args))
+
+
+if __name__ == "__main__":
+    main()
@@ -7,14 +7,119 @@
  * - 1.0: 5-18-2020 (Crandell) Original
  * - 1.1: 5-19-2020 Added function which cleans the parser output prior to reloading it.
  * 					Also added function pointer feedback so that the shell can relay "OK" or "Function Error"
+ * - 1.2: 10-14-2026 Replaced scrubWhiteSpace/exctractCommand/extractArguments with a single-pass tokenizer.
+ * 					The parser output now holds (offset, length) slices into the line buffer instead of copies.
+ * - 1.3: 10-14-2026 matchCommand() binary searches the (sorted) Command Table. shellInit() verifies the ordering.
+ * - 1.4: 10-14-2026 rxShellInput() pushes into a lock-free SPSC ring which checkShellStatus() drains.
+ * - 1.5: 10-14-2026 Line assembler: CR, LF or CRLF terminators, fragments joined across packets,
+ * 					several commands per packet and overlong lines rejected.
+ * - 1.6: 10-14-2026 Responses are queued through the CDC transmit queue and flushed at the end of each poll.
+ * - 1.7: 10-14-2026 Binary framed command mode (CLI_SHELL_BINARY.c), switched at runtime with "mode".
+ * - 1.8: 10-14-2026 "{ cmd1 ; cmd2 ; ... }" runs a batch of commands with one combined response.
+ * - 1.9: 10-14-2026 DWT cycle statistics per command and stage (CLI_SHELL_PERF.c), dumped with "perf".
+ * - 1.10: 10-14-2026 Benchmark configuration and "bench" command (CLI_SHELL_BENCH.c).
+ * - 1.11: 10-14-2026 validateArgs() converts each argument once and stores the typed value.
+ * - 1.12: 10-14-2026 Arguments converted by CLI_SHELL_CONVERT.c instead of strtol, range checks fixed.
+ * - 1.13: 10-14-2026 Token index/mask in the parser output. Mandatory check is one mask compare.
+ * - 1.14: 10-14-2026 Command table, indices and mandatory masks generated from CLI_SHELL_COMMANDS.h lists.
+ * - 1.15: 10-14-2026 Command table is const and stays in flash.
+ * - 1.16: 10-14-2026 Help is streamed line by line (shellOutputReserve) and can be filtered by prefix.
+ * - 1.17: 10-14-2026 USB class data comes from the static block pool (CLI_SHELL_POOL), perf reports its usage.
+ * - 1.18: 10-14-2026 Bridges may return SHELL_BUSY to run as a job, answered once the job is done (CLI_SHELL_JOB).
+ * - 1.19: 10-14-2026 Ctrl-C (text mode) and CDC break set an abort flag from the receive interrupt.
+ * - 1.20: 10-14-2026 "stream" command (CLI_SHELL_STREAM).
+ * - 1.21: 10-14-2026 "clock" command (CLI_SHELL_CLOCK).
+ * - 1.22: 10-14-2026 "art" command (CLI_SHELL_ART).
+ * - 1.23: 10-14-2026 assembleLine, tokenizeLine and matchCommand are SHELL_RAMFUNC (.RamFunc section).
+ * - 1.24: 10-14-2026 "tput" command (CLI_SHELL_TPUT). Jobs that own the input stop line/frame assembly.
+ * - 1.25: 10-14-2026 "perf" shows the USB frame statistics.
+ * - 1.26: 10-14-2026 One shell instance per transport port. checkShellStatus() serves every port in turn.
+ * - 1.27: 10-14-2026 All state lives in the shell_ctx_t instance passed to every function, no globals.
+ * - 1.28: 10-14-2026 Output goes through the instance's transport table (shellTransport_t).
+ * - 1.29: 10-14-2026 "mrd" and "mwr" commands (CLI_SHELL_MEM).
+ * - 1.30: 10-14-2026 "macro" command (CLI_SHELL_MACRO). shellDispatch() feeds the recording.
+ * - 1.31: 10-14-2026 "get" and "set" commands (CLI_SHELL_KV).
+ * - 1.32: 10-14-2026 checkShellStatus() reports ended flash operations (shellFlashPoll), "flash" command.
+ * - 1.33: 10-14-2026 "every" periodic commands (CLI_SHELL_SCHED), shellResolveCommand().
+ * - 1.34: 10-14-2026 checkShellStatus() processes input captures (shellCapturePoll), "capture" command.
+ * - 1.35: 10-14-2026 "pattern" command (CLI_SHELL_PATTERN).
+ * - 1.36: 10-14-2026 shellStr_t response builder replaces sprintf/strcpy in the batch, response, help and perf output.
+ * - 1.37: 10-14-2026 matchCommand() walks a trie over the sorted table, unique prefixes, tab completion in assembleLine().
+ * - 1.38: 10-14-2026 Receive and abort signal the main loop (CLI_SHELL_EVENT), checkShellStatus() flags leftover work.
+ * - 1.39: 10-14-2026 "mem" command (CLI_SHELL_MEM).
+ * - 1.40: 10-14-2026 Trace hooks in shellProcessCommand() and shellDispatch() (CLI_SHELL_TRACE).
+ * - 1.41: 10-14-2026 Failed bridges are logged over SWO (CLI_SHELL_ITM).
+ * - 1.42: 10-14-2026 "usbstat" command (CLI_SHELL_USBSTAT).
+ * - 1.43: 10-14-2026 "isr" command (CLI_SHELL_ISR).
+ * - 1.44: 10-14-2026 First command boot stamp and "boot" command (CLI_SHELL_BOOT).
+ * - 1.45: 10-14-2026 shellInit() starts the trace ring, which is kept over a soft reset (CLI_SHELL_TRACE).
+ * - 1.46: 10-14-2026 shellProcessCommand() notes the line for the fault record (CLI_SHELL_CRASH).
+ * - 1.47: 10-14-2026 Request tags, shellProcessLine() takes "#<n>" off the line and the response carries it.
+ * - 1.48: 10-14-2026 checkShellStatus() samples the watch list, Ctrl-C stops it (CLI_SHELL_WATCH).
+ * - 1.49: 10-15-2026 "mode z1" compresses the responses of a binary session (CLI_SHELL_LZ).
+ * - 1.50: 10-15-2026 checkShellStatus() resumes reception held back for a full ring (transportRxResume).
+ * - 1.51: 10-15-2026 Urgent lane, text lines of urgent commands run ahead of the others (CLI_SHELL_URGENT).
+ * - 1.52: 10-15-2026 Cacheable commands are answered from kept responses (CLI_SHELL_CACHE).
+ * - 1.53: 10-15-2026 Array arguments, SHELL_ARG_LEN is checked by validateArgType() for the other types.
+ * - 1.54: 10-15-2026 Optional FreeRTOS port, the shell runs in its own task (CLI_SHELL_RTOS).
+ * - 1.55: 10-15-2026 Optional deferred processing, the passes run in PendSV (CLI_SHELL_DEFER).
+ * - 1.56: 10-15-2026 "notify" command, events on the CDC notification endpoint (CLI_SHELL_NOTIFY).
+ * - 1.57: 10-15-2026 Zero-copy output into the transmit queue (shellOutputAcquire/shellOutputCommit).
+ * - 1.58: 10-15-2026 Lines addressed "@<node>" go to downstream boards (CLI_SHELL_GATEWAY).
+ * - 1.59: 10-15-2026 checkShellStatus() runs the reset of a firmware update (CLI_SHELL_FWUPDATE).
+ * - 1.60: 10-15-2026 checkShellStatus() polls the I2C request queue (CLI_SHELL_I2C).
+ * - 1.61: 10-15-2026 Arguments starting with '$' are expressions over shell variables (CLI_SHELL_VAR).
+ * - 1.62: 10-15-2026 Regression suite hooks: streamed case lines, muted output capture (CLI_SHELL_REGRESS).
+ * - 1.63: 10-15-2026 shellDispatch() checks the bridge deadline (SHELL_DEADLINE_LIST), "perf" shows the overruns.
+ * - 1.64: 10-15-2026 Commands registered at runtime (shellRegisterCommand(), CLI_SHELL_MODULE), the trie walks a name index in RAM.
+ * - 1.65: 10-15-2026 Command history, shellProcessLine() replays "!!" and "!<n>" and records the line, assembleLine() takes the arrow keys.
+ * - 1.66: 10-15-2026 assembleLine() edits the line at a cursor and echoes it, one flush per drained ring (CLI_SHELL_EDIT).
+ * - 1.67: 10-15-2026 Command pipeline: rxShellInput() parses the next line ahead while a line runs, checkShellStatus() takes it (CLI_SHELL_PIPE).
+ * - 1.68: 10-15-2026 validateArgs() runs the generated validator of a table command, validateArgType() is left to registered ones.
+ * - 1.69: 10-15-2026 checkShellStatus() hands the receive ring depth to the clock governor (CLI_SHELL_CLOCK).
+ * - 1.70: 10-15-2026 shellRunLine() arms "arm P<pin> <line>" lines, checkShellStatus() reports the fire (CLI_SHELL_ARM).
+ * - 1.71: 10-15-2026 shellInit() restores the saved session settings, "mode" saves them (CLI_SHELL_SESSION).
+ * - 1.72: 10-15-2026 Name index as parallel arrays over the name pool, matchCommand() looks exact names up by hash first.
+ * - 1.73: 10-15-2026 shellStrSend(), the text responses and the binary frames wait for transmit room instead of being cut.
+ * - 1.74: 10-15-2026 shellOutputReserve() waits once per stall: txStalled until there is room or the next line or frame.
+ * - 1.75: 10-15-2026 Usage notes describe the line editing and the local echo (CLI_SHELL_EDIT.h).
+ * - 1.76: 10-15-2026 completeCommand() waits for transmit room for the completed characters too.
  *
  * Usage and Installation Notes:
- *  - "rxShellInput()" should be called when a command has been issued. In the case of USB CLI,
- * 		this function should be called within CDC_Receive_FS() function within usbd_cdc_if.c
- *  - The main loop should call "checkShellStatus()" periodically. If a command has been sent,
- * 		this function will service the command.
- *  - This module is designed to be light weight and will run within a non-OS environment - RTOS is not supported.
- *  - To add commands, see CLI_SHELL_COMMANDS.h
+ *  - Define one instance per transport port with SHELL_CTX_DEFINE() and start it with
+ * 		"shellInit(&ctx, &transport, port)". shellInit() attaches the instance to its port.
+ *  - "rxShellInput()" should be called with the attached instance whenever data has been received.
+ * 		In the case of USB CLI (CDC_Transport_FS), this is done within CDC_Receive_FS() (operator port)
+ * 		and VND_Receive_FS() (automation port) within usbd_cdc_if.c. The USART transport
+ * 		(shellUartTransport) does it from its DMA and idle line interrupts (CLI_SHELL_UART.c).
+ * 		Commands are terminated with a Return and/or Line Feed (see SHELL_LINE_TERMINATORS).
+ *  - The main loop should call "checkShellStatus()" periodically for every instance. If a command
+ * 		has been sent, this function will service the command, then flush any queued output.
+ * 		Between passes it may sleep with shellEventWait() (CLI_SHELL_EVENT.h).
+ *  - Every instance has its own line buffer, session mode and batch/binary state, and its output goes
+ * 		back to its own port only. Only one job runs at a time (CLI_SHELL_JOB.h), whichever instance starts it.
+ *  - This module is designed to be light weight and runs within a non-OS environment. With FreeRTOS
+ * 		(SHELL_RTOS_ENABLED=1) it runs in a shell task of its own instead of the main loop, see
+ * 		CLI_SHELL_RTOS.h. Other tasks then write to a port with shellRtosWrite() only. Without an
+ * 		RTOS the passes can run in the PendSV exception (SHELL_DEFER_ENABLED=1, CLI_SHELL_DEFER.h),
+ * 		so a busy main loop does not delay the commands.
+ *  - A text session edits the line as it is typed: backspace, delete, cursor and history keys
+ * 		(CLI_SHELL_EDIT.h). Local echo is off by default, a host sending lines gets the responses
+ * 		only. With echo on (ctx->edit.echo, SHELL_EDIT_ECHO after shellInit(), "term e1") every
+ * 		change is sent back, typed characters and VT100 sequences for the edits within the line.
+ *  - In a text session Tab completes the command word as far as it is unique. If several commands
+ * 		fit, they are listed and the line typed so far is shown again. A unique prefix of a command
+ * 		runs that command (SHELL_PREFIX_MATCH). The completion is sent with or without echo.
+ *  - A text line may start with a tag, "#42 setLed l1 s1". The response line of that command (or
+ * 		batch) starts with the same tag, "#42 -->OK!". A command that runs as a job answers when
+ * 		the job is done, after the lines that came in meanwhile, still with its own tag.
+ *  - Bridges with a lot of output may format straight into the transmit queue: shellOutputAcquire(ctx, n)
+ * 		returns room for n bytes (NULL if there is none right now), shellOutputCommit(ctx, len) sends
+ * 		the len bytes written there. Binary sessions and wrapped blocks go through a staging buffer
+ * 		of SHELL_OUTPUT_STAGE_LEN and are copied once on commit. One block at a time.
+ *  - A line addressed "@<node> <line>" runs on a downstream board registered with
+ * 		shellGatewayAddNode(), its answers come back prefixed "@<node>" (CLI_SHELL_GATEWAY.h).
+ *  - To add commands, see CLI_SHELL_COMMANDS.h. Modules add theirs at boot, see CLI_SHELL_MODULE.h.
  *
  * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
  */
@@ -25,105 +130,163 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
-#include <stdio.h>
-#include <stdlib.h>
 
 #include "CLI_SHELL_COMMANDS.h"
 #include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_BENCH.h"
+#include "CLI_SHELL_REGRESS.h"
+#include "CLI_SHELL_CONVERT.h"
+#include "CLI_SHELL_FORMAT.h"
+#include "CLI_SHELL_POOL.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_MACRO.h"
+#include "CLI_SHELL_FLASH.h"
+#include "CLI_SHELL_SCHED.h"
+#include "CLI_SHELL_ARM.h"
+#include "CLI_SHELL_CAPTURE.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_TRACE.h"
+#include "CLI_SHELL_ITM.h"
+#include "CLI_SHELL_BOOT.h"
+#include "CLI_SHELL_CRASH.h"
+#include "CLI_SHELL_WATCH.h"
+#include "CLI_SHELL_URGENT.h"
+#include "CLI_SHELL_CACHE.h"
+#include "CLI_SHELL_GATEWAY.h"
+#include "CLI_SHELL_FWUPDATE.h"
+#include "CLI_SHELL_I2C.h"
+#include "CLI_SHELL_VAR.h"
+#include "CLI_SHELL_MODULE.h"
+#include "CLI_SHELL_PIPE.h"
+#include "CLI_SHELL_CLOCK.h"
+#include "CLI_SHELL_SESSION.h"
 
 /********************************************************************************
  * DEFINES
  *******************************************************************************/
+#define SHELL_MAX_COMMANDS			(NUM_OF_COMMANDS + SHELL_MODULE_MAX_COMMANDS)
 
+#define cmdTrieChar(index, depth)	((uint8_t)cmdNames[(index)][(depth)])
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A node of the command name trie
+  * @note	The trie is the sorted name index itself: the names below a node are the index
+  * 		entries [first, last), which all start with the same depth characters. The entries
+  * 		of a child have the same next character and are found by binary search on it, so the
+  * 		trie costs no memory of its own and cannot go stale. A registered command is one
+  * 		insertion into the index (shellRegisterCommand()).
+  */
+typedef struct {
+	uint16_t first;							/*!< First entry of the node				*/
+	uint16_t last;							/*!< One past the last entry				*/
+	uint8_t depth;							/*!< Characters shared by the entries		*/
+} cmdTrieNode_t;
+
+/**
+  * @brief  Validator of a Command Table entry (SHELL_GEN_VALIDATOR)
+  */
+typedef bool (*cmdValidator_t)(shellParserOutput_t* cmdParserOutput);
 
 /********************************************************************************
  * MODULAR VARIABLES
  *******************************************************************************/
-bool cliShellInitialized = false;
+static shellPerfStat_t cmdPerfStats[SHELL_MAX_COMMANDS];	/*!< By command index (all instances)	*/
 
-shellBufferHandle_t shellBuffer;		/*!< Global Command Buffer Storage		*/
+/**
+  * @brief  The name index, sorted by name (strcmp), as parallel arrays: the trie searches only
+  * 		touch the name pointers, 4 bytes apart, and the names in the pool (shellCmdNamePool).
+  * 		Starts as the Command Table, in its order.
+  */
+static const char* cmdNames[SHELL_MAX_COMMANDS] = {
+		SHELL_COMMAND_LIST(SHELL_GEN_NAME_ENTRY)
+};
+static uint16_t cmdNameCommands[SHELL_MAX_COMMANDS] = {
+		SHELL_COMMAND_LIST(SHELL_GEN_INDEX)
+};
+static uint16_t cmdNameCount = NUM_OF_COMMANDS;
+
+/**
+  * @brief  The hash index, sorted by the FNV-1a hash of the name (cmdNameHash()), as parallel
+  * 		arrays: a lookup binary searches the packed hashes and compares one name. Built by the
+  * 		first shellInit(), empty until then.
+  */
+static uint32_t cmdHashes[SHELL_MAX_COMMANDS];
+static const char* cmdHashNames[SHELL_MAX_COMMANDS];
+static uint16_t cmdHashCommands[SHELL_MAX_COMMANDS];
+static uint16_t cmdHashCount;
+
+static const shellCmdTemplate_t* runtimeCmds[SHELL_MODULE_MAX_COMMANDS];	/*!< Index NUM_OF_COMMANDS + n	*/
+static uint32_t runtimeMandatoryMask[SHELL_MODULE_MAX_COMMANDS];
+static uint16_t runtimeCmdCount;
+
+static uint8_t outputStage[SHELL_OUTPUT_STAGE_LEN];		/*!< shellOutputAcquire() without a queue block	*/
 
 /********************************************************************************
  * PRIVATE PROTOTYPES
  *******************************************************************************/
-shell_error scrubWhiteSpace(void);
 shell_error cleanParserOutput(shellParserOutput_t* cmdParseOut);
 argToken_t getTokenFromChar(char chrToken);
-shell_error exctractCommand(shellParserOutput_t* cmdParseOut);
-shell_error extractArguments(shellParserOutput_t* cmdParseOut);
+shell_error tokenizeLine(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut);
 
 /*------------------------------------------------------------------------------*/
-bool validateArgType(argType_t argDataType, uint8_t* dataString);
-bool validateArgs(shellParserOutput_t* cmdParserOutput, uint8_t commandIndex);
-shell_error matchCommand(shellParserOutput_t* cmdParserOutput, int8_t* commandIndex);
-shell_error getCommand(shellParserOutput_t* cmdParserOutput, uint8_t* commandTableIndex);
+int16_t walkArgArray(const shellParserOutput_t* cmdParserOutput, uint8_t argIndex, argType_t argDataType,
+		void* items, uint8_t maxItems);
+static inline bool convertArg(argType_t argDataType, shellParserOutput_t* cmdParserOutput, uint8_t argIndex)
+		__attribute__((always_inline));
+bool validateArgType(argType_t argDataType, shellParserOutput_t* cmdParserOutput, uint8_t argIndex);
+bool validateArgs(shellParserOutput_t* cmdParserOutput, uint16_t commandIndex);
+bool validateCommandTable(void);
+shell_error matchCommandLinear(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex);
+shell_error matchCommand(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex);
+shell_error getCommand(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t* commandTableIndex);
+bool cmdTrieStep(cmdTrieNode_t* node, uint8_t c);
+bool cmdTrieWalk(cmdTrieNode_t* node, const uint8_t* name, uint32_t len);
+uint32_t cmdNameHash(const uint8_t* name);
+void cmdHashInsert(const char* name, uint16_t command);
 
 /*------------------------------------------------------------------------------*/
-shell_error shellProcessCommand(void);
-shell_error shellParseCommand(shellParserOutput_t* cmdParseOut);
-shell_error shellSendResponse(responseCode_t code);
+bool assembleLine(shell_ctx_t* ctx);
+bool completeCommand(shell_ctx_t* ctx);
+shell_error shellProcessLine(shell_ctx_t* ctx);
+shell_error shellProcessBatch(shell_ctx_t* ctx, uint8_t* line, uint32_t len);
+shell_error shellProcessCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len);
+shell_error shellParseCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut);
+void checkDeadline(shell_ctx_t* ctx, uint16_t commandIndex);
 
 
 /********************************************************************************
  * PRIVATE FUNCTIONS
  *******************************************************************************/
 /**
-  * @brief  Scrubs all whitespace from the received command
-  * @param  NONE
-  * @retval shell_error Error Return Value
-  */
-shell_error scrubWhiteSpace(void) {
-	shell_error status = SHELL_OK;
-
-	// Get the current Length of the Buffer
-	uint8_t currentLength = shellBuffer.rxLen;
-
-	// Scrub Leading Whitespace
-	while (shellBuffer.rxBuffer[0] == ' ' && currentLength > 0) {
-		/* Shift Array to the Left */
-		for (uint8_t i = 0; i < currentLength - 1; i++) {
-			shellBuffer.rxBuffer[i] = shellBuffer.rxBuffer[i + 1];
-		}
-		currentLength--;
-	}
-
-	// Scrub Trailing Whitespace
-	uint8_t lastIndex = currentLength - 1;
-	while (shellBuffer.rxBuffer[lastIndex] == ' ' && currentLength > 0) {
-		currentLength--;
-		lastIndex = currentLength - 1;
-	}
-
-	// Scrub Duplicate Whitespace
-	for (uint8_t i = 0; i < currentLength; i++) {
-		if (shellBuffer.rxBuffer[i] == ' ' && shellBuffer.rxBuffer[i + 1] == ' ') {
-			for (uint8_t j = (i + 1); j < currentLength -2; j++) {
-				shellBuffer.rxBuffer[j] = shellBuffer.rxBuffer[j + 1];
-			}
-			currentLength--;
-		}
-	}
-
-	// Update the received Length
-	shellBuffer.rxLen = currentLength;
-	return status;
-}
-
-/**
-  * @brief  Cleans and prepares the parser output. Basically just sets everything to 0.
+  * @brief  Cleans and prepares the parser output.
+  * @note	Argument contents are slices into the line buffer, so only the counts and tokens need resetting.
   * @param[IN] cmdParseOut Pointer to the parser output structure.
-  * @retval argToken_t Returns an Argument Token
+  * @retval shell_error Error Return Value
   */
 shell_error cleanParserOutput(shellParserOutput_t* cmdParseOut) {
 	shell_error status = SHELL_OK;
 
 	// clean the command
-	memset(cmdParseOut->cmdName, 0, SHELL_CMD_LEN);
+	cmdParseOut->line = NULL;
+	cmdParseOut->cmdOffset = 0;
+	cmdParseOut->cmdLen = 0;
 	cmdParseOut->numArgs = 0;
+	cmdParseOut->rawValues = false;
+	cmdParseOut->validated = false;
+	cmdParseOut->periodic = false;
+	cmdParseOut->argMask = 0;
+	memset(cmdParseOut->argSlot, SHELL_ARG_NONE, sizeof(cmdParseOut->argSlot));
 
 	for (uint8_t i = 0; i < MAX_ARGUMENTS; i++) {
-		memset(cmdParseOut->cmdArgs[i].argContents, 0, SHELL_ARG_LEN);
+		cmdParseOut->cmdArgs[i].argOffset = 0;
+		cmdParseOut->cmdArgs[i].argLen = 0;
 		cmdParseOut->cmdArgs[i].argToken = argTkn_err;
+		cmdParseOut->cmdArgs[i].argType = arg_none;
 	}
 
 	return status;
@@ -145,227 +308,606 @@ argToken_t getTokenFromChar(char chrToken) {
 	}
 }
 
-
 /**
-  * @brief  Extracts the command from the buffer and loads it into the parser output structure
-  * @param [IN] cmdParseOut	Pointer to the parser output structure
+  * @brief  Splits the received line into the command and its arguments in a single pass.
+  * @note	Nothing is copied. Every delimiter is overwritten with a NUL in place, so each
+  * 		slice (offset, length) stored in the parser output is also a terminated string
+  * 		inside the line buffer. Leading, trailing and duplicate whitespace is skipped.
+  * 		Argument lengths are checked by validateArgType(), an array may take most of the line.
+  * @param[IN]  line Pointer to the line buffer (must hold len + 1 bytes)
+  * @param[IN]  len Number of valid characters in the line
+  * @param[OUT] cmdParseOut Pointer to the parser output structure
   * @retval shell_error Error Return Value
   */
-shell_error exctractCommand(shellParserOutput_t* cmdParseOut) {
-	shell_error status = SHELL_OK;
-	uint8_t bufferCopy[SHELL_CMD_LEN] = {0};
+SHELL_RAMFUNC shell_error tokenizeLine(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut) {
+	uint32_t i = 0;
+	uint32_t start;
+	uint32_t tokenLen;
+	bool cmdFound = false;
+
+	cmdParseOut->line = line;
+	line[len] = '\0';
+
+	while (i < len) {
+		// Skip any whitespace ahead of the next token
+		if (line[i] == ' ') {
+			line[i++] = '\0';
+			continue;
+		}
 
-	// Delimeter token for strtok
-	const char delim[2] = " ";
+		// Walk to the end of the token and terminate it
+		start = i;
+		while (i < len && line[i] != ' ') {
+			i++;
+		}
+		line[i] = '\0';
+		tokenLen = i - start;
 
-	// Make a copy of the buffer to preserve.
-	memcpy(bufferCopy, shellBuffer.rxBuffer, shellBuffer.rxLen);
+		if (!cmdFound) {
+			// The first token is always the command name
+			if (tokenLen > SHELL_CMD_LEN) {
+				return SHELL_ERR;
+			}
+			cmdParseOut->cmdOffset = start;
+			cmdParseOut->cmdLen = tokenLen;
+			cmdFound = true;
+		} else if (cmdParseOut->numArgs < MAX_ARGUMENTS) {
+			// The first character of an argument is its token. The contents follow directly after.
+			shellArgument_t* arg = &cmdParseOut->cmdArgs[cmdParseOut->numArgs];
+			arg->argToken = getTokenFromChar(line[start]);
+			arg->argOffset = start + 1;
+			arg->argLen = tokenLen - 1;
+			shellIndexArg(cmdParseOut, cmdParseOut->numArgs);
+			cmdParseOut->numArgs++;
+		}
+		i++;
+	}
 
-	// The command still has the arguments attached.
-	// Split the string using ' ' as a delimiter
-	char* extractCmd = strtok((char*)bufferCopy, delim);
+	return SHELL_OK;
+}
 
-	// Copy the command name to the parser output
-	sprintf((char*)cmdParseOut->cmdName, "%s", extractCmd);
+/*------------------------------------------------------------------------------*/
 
-	return status;
+/**
+  * @brief  Walks the elements of an array argument, checks them and optionally stores them
+  * @note	Text contents are comma separated integers as shellParseUnsigned() takes them
+  * 		("1,0x20,0b11"), each up to SHELL_ARG_LEN characters. Contents of binary frames are
+  * 		the little-endian elements back to back. At most SHELL_ARRAY_MAX elements.
+  * @param[IN]  cmdParserOutput Parser Output Structure
+  * @param[IN]	argIndex Index of the argument within the parser output
+  * @param[IN]  argDataType arg_u8_array, arg_u16_array or arg_u32_array
+  * @param[OUT]  items Elements of the element type, NULL to only check them
+  * @param[IN]  maxItems Room in items, further elements are checked but not stored
+  * @retval int16_t Number of elements, -1 if the contents are no array of the type
+  */
+int16_t walkArgArray(const shellParserOutput_t* cmdParserOutput, uint8_t argIndex, argType_t argDataType,
+		void* items, uint8_t maxItems) {
+	const shellArgument_t* arg = &cmdParserOutput->cmdArgs[argIndex];
+	const uint8_t* contents = shellArgContents(cmdParserOutput, argIndex);
+	uint8_t width = (argDataType == arg_u8_array) ? 1 : (argDataType == arg_u16_array) ? 2 : 4;
+	uint32_t maxValue = (width == 4) ? UINT32_MAX : ((1UL << (8 * width)) - 1);
+	uint8_t element[SHELL_ARG_LEN + 1];
+	uint16_t count = 0;
+	uint8_t pos = 0;
+	uint32_t value;
+
+	while (pos < arg->argLen || (count == 0 && !cmdParserOutput->rawValues)) {
+		if (count == SHELL_ARRAY_MAX) {
+			return -1;
+		}
+
+		if (cmdParserOutput->rawValues) {
+			if ((arg->argLen - pos) < width) {
+				return -1;
+			}
+			value = 0;
+			for (uint8_t i = 0; i < width; i++) {
+				value |= (uint32_t)contents[pos++] << (8 * i);
+			}
+		} else {
+			uint8_t len = 0;
+
+			while (pos < arg->argLen && contents[pos] != ',') {
+				if (len == SHELL_ARG_LEN) {
+					return -1;
+				}
+				element[len++] = contents[pos++];
+			}
+			element[len] = '\0';
+			if (!shellParseUnsigned(element, maxValue, &value)) {
+				return -1;
+			}
+			if (pos < arg->argLen && ++pos == arg->argLen) {
+				// Trailing comma
+				return -1;
+			}
+		}
+
+		if (items != NULL && count < maxItems) {
+			if (width == 1) {
+				((uint8_t*)items)[count] = (uint8_t)value;
+			} else if (width == 2) {
+				((uint16_t*)items)[count] = (uint16_t)value;
+			} else {
+				((uint32_t*)items)[count] = value;
+			}
+		}
+		count++;
+	}
+
+	return (count == 0) ? -1 : (int16_t)count;
 }
 
 /**
-  * @brief  Extracts the arguments from the buffer and loads them into the parser output structure
-  * @param [IN] cmdParseOut	Pointer to the parser output structure
-  * @retval shell_error Error Return Value
+  * @brief  Converts an argument to the data type and stores the converted value.
+  * @note	Always inlined: with a constant argDataType only the branches of that type are left
+  * 		(argConvert_<type>()). Text contents are converted with the CLI_SHELL_CONVERT.c parsers (decimal, 0x hex,
+  * 		0b binary, float). Contents of binary frames (rawValues) are
+  * 		little-endian values and must be exactly the size of the type. Arrays are only
+  * 		checked and counted here, see walkArgArray().
+  * @param[IN]  argDataType Valid Data Type
+  * @param[IN,OUT]	cmdParserOutput Parser Output Structure. argType/argValue of the argument are set.
+  * @param[IN]	argIndex Index of the argument within the parser output
+  * @retval bool Returns true if the argument content string matches the data type
   */
-shell_error extractArguments(shellParserOutput_t* cmdParseOut) {
-	shell_error status = SHELL_OK;
-	uint8_t bufferCopy[SHELL_CMD_LEN] = {0};
-
-	// Delimiter token for strtok
-	const char delim[2] = " ";
+static inline bool convertArg(argType_t argDataType, shellParserOutput_t* cmdParserOutput, uint8_t argIndex) {
+	shellArgument_t* arg = &cmdParserOutput->cmdArgs[argIndex];
+	uint8_t* dataString = shellArgContents(cmdParserOutput, argIndex);
+	argValue_t value;
+	uint32_t number;
+
+	if (argDataType == arg_u8_array || argDataType == arg_u16_array || argDataType == arg_u32_array) {
+		int16_t count = walkArgArray(cmdParserOutput, argIndex, argDataType, NULL, 0);
+		if (count < 0) {
+			return false;
+		}
+		arg->argType = argDataType;
+		arg->argValue.count = (uint8_t)count;
+		return true;
+	}
 
-	// Make a copy of the buffer to preserve
-	memcpy(bufferCopy, shellBuffer.rxBuffer, shellBuffer.rxLen);
+	// Arrays may take most of the line, every other type up to SHELL_ARG_LEN
+	if (arg->argLen > SHELL_ARG_LEN) {
+		return false;
+	}
 
-	// This first one will extract the command. We don't care about this - the next use of strtok will overwrite this.
-	char* extractArg = strtok((char*)bufferCopy, delim);
-	extractArg = strtok(NULL, delim);
+	if (cmdParserOutput->rawValues) {
+		switch (argDataType) {
+			case arg_uint8:
+			case arg_char:
+				if (arg->argLen != 1) {
+					return false;
+				}
+				value.u8 = dataString[0];
+				break;
 
-	uint8_t i = 0;
-	while (i < MAX_ARGUMENTS && extractArg != NULL){
-		// Copy The Argument. The "extractArg + 1" is because we don't need the token as part of the argument anymore.
-		memcpy(cmdParseOut->cmdArgs[i].argContents, extractArg + 1, strlen(extractArg));
+			case arg_uint16:
+				if (arg->argLen != 2) {
+					return false;
+				}
+				value.u16 = (uint16_t)dataString[0] | ((uint16_t)dataString[1] << 8);
+				break;
 
-		// Find and assign the argument token
-		cmdParseOut->cmdArgs[i].argToken = getTokenFromChar(extractArg[0]);
+			case arg_uint32:
+			case arg_float:
+				if (arg->argLen != 4) {
+					return false;
+				}
+				value.u32 = (uint32_t)dataString[0] | ((uint32_t)dataString[1] << 8) |
+						((uint32_t)dataString[2] << 16) | ((uint32_t)dataString[3] << 24);
+				break;
 
-		// Extract each argument individually
-		extractArg = strtok(NULL, delim);
+			case arg_string:
+				value.str = (const char*)dataString;
+				break;
 
-		// Iterate through all possible arguments
-		i++;
-	}
+			case arg_flag:
+				value.flag = true;
+				break;
 
-	// Update the total number of arguments found
-	cmdParseOut->numArgs = i;
+			default:
+				return false;
+		}
 
-	return status;
-}
+		arg->argType = argDataType;
+		arg->argValue = value;
+		return true;
+	}
 
-/*------------------------------------------------------------------------------*/
+	// "$i*4": evaluated in place, the line is not rewritten
+	if (dataString[0] == SHELL_VAR_CHAR && (argDataType == arg_uint8 || argDataType == arg_uint16 ||
+			argDataType == arg_uint32 || argDataType == arg_float)) {
+		int32_t result;
+		uint32_t max = (argDataType == arg_uint8) ? UINT8_MAX : (argDataType == arg_uint16) ? UINT16_MAX : UINT32_MAX;
 
-/**
-  * @brief  Validates the data type using the argument content string.
-  * @param[IN]  argDataType Valid Data Type
-  * @param[IN]	dataString Input argument content string
-  * @retval bool Returns true if the argument content string matches the data type
-  */
-bool validateArgType(argType_t argDataType, uint8_t* dataString) {
-	long ret;
+		if (!shellVarEval(dataString, &result)) {
+			return false;
+		}
+		if (argDataType == arg_float) {
+			value.f = (float)result;
+		} else if (result < 0 || (uint32_t)result > max) {
+			return false;
+		} else if (argDataType == arg_uint8) {
+			value.u8 = (uint8_t)result;
+		} else if (argDataType == arg_uint16) {
+			value.u16 = (uint16_t)result;
+		} else {
+			value.u32 = (uint32_t)result;
+		}
+		arg->argType = argDataType;
+		arg->argValue = value;
+		return true;
+	}
 
 	switch (argDataType) {
 		case arg_uint8:
 			// Valid = 0 to 0xFF
-			// Convert the string to an unsigned integer
-			ret = strtol((const char*)dataString, NULL, 10);
-			if (ret < 0 && ret > 0xFF) {
+			if (!shellParseUnsigned(dataString, UINT8_MAX, &number)) {
 				return false;
 			}
+			value.u8 = (uint8_t)number;
 			break;
 
 		case arg_uint16:
 			// Valid = 0 to 0xFFFF
-			// Convert the string to an unsigned integer
-			ret = strtol((const char*)dataString, NULL, 10);
-			if (ret < 0 && ret > 0xFFFF) {
+			if (!shellParseUnsigned(dataString, UINT16_MAX, &number)) {
 				return false;
 			}
+			value.u16 = (uint16_t)number;
 			break;
 
 		case arg_uint32:
 			// Valid = 0 to 0XFFFFFFFF
-			// Convert the string to an unsigned integer
-			ret = strtol((const char*)dataString, NULL, 10);
-			if (ret < 0 && ret > 0xFFFFFFFF) {
+			if (!shellParseUnsigned(dataString, UINT32_MAX, &number)) {
 				return false;
 			}
+			value.u32 = number;
 			break;
 
 		case arg_char:
-			// Valid = 32 to 127 Ascii Character (space until DEL)
-			ret = (char)*dataString;
-			if (ret < 32 && ret > 127) {
+			// Valid = a single 32 to 126 Ascii Character (space until ~)
+			if (arg->argLen != 1 || dataString[0] < 32 || dataString[0] > 126) {
 				return false;
 			}
+			value.c = (char)dataString[0];
 			break;
 
 		case arg_string:
-
+			value.str = (const char*)dataString;
 			break;
 
 		case arg_float:
-
+			if (!shellParseFloat(dataString, &value.f)) {
+				return false;
+			}
 			break;
 
 		case arg_flag:
-
+			value.flag = true;
 			break;
+
+		default:
+			return false;
 	}
 
+	arg->argType = argDataType;
+	arg->argValue = value;
 	return true;
 }
 
+/**
+  * @brief  Validates the data type of an argument and stores the converted value.
+  * @note	The type is only known at runtime here, used for commands registered at runtime.
+  * @param[IN]  argDataType Valid Data Type
+  * @param[IN,OUT]	cmdParserOutput Parser Output Structure. argType/argValue of the argument are set.
+  * @param[IN]	argIndex Index of the argument within the parser output
+  * @retval bool Returns true if the argument content string matches the data type
+  */
+bool validateArgType(argType_t argDataType, shellParserOutput_t* cmdParserOutput, uint8_t argIndex) {
+	return convertArg(argDataType, cmdParserOutput, argIndex);
+}
+
+/*------------------------------------------------------------------------------*/
+/**
+  * @brief  One converter per data type, called by the generated validators. A type no command
+  * 		uses is dropped by the linker.
+  */
+#define ARG_CONVERTER(TYPE) \
+		__attribute__((unused)) static bool argConvert_##TYPE(shellParserOutput_t* out, uint8_t argIndex) { \
+			return convertArg(TYPE, out, argIndex); \
+		}
+
+ARG_CONVERTER(arg_uint8)
+ARG_CONVERTER(arg_uint16)
+ARG_CONVERTER(arg_uint32)
+ARG_CONVERTER(arg_char)
+ARG_CONVERTER(arg_string)
+ARG_CONVERTER(arg_float)
+ARG_CONVERTER(arg_flag)
+ARG_CONVERTER(arg_u8_array)
+ARG_CONVERTER(arg_u16_array)
+ARG_CONVERTER(arg_u32_array)
+
+/**
+  * @brief  shellValidate_<ID>() of every command in CLI_SHELL_COMMANDS.h and their table
+  */
+SHELL_COMMAND_LIST(SHELL_GEN_VALIDATOR)
+
+static const cmdValidator_t cmdValidators[NUM_OF_COMMANDS] = {
+		SHELL_COMMAND_LIST(SHELL_GEN_VALIDATOR_ENTRY)
+};
+
 /**
   * @brief  Validates the arguments.
-  * @note 	There are a couple of checks that happen during this function:
-  * 		1. Steps through all mandatory arguments and locates within the input arguments based on the token
-  * 		It then validates each mandatory argument based on the required input type
-  * 		2. Steps through all input arguments and tries to find any un-needed or mis-typed arguments based on token
+  * @note 	A Command Table entry runs its generated validator (SHELL_GEN_VALIDATOR): the mandatory
+  * 		tokens against the token mask in one compare, then a converter of the exact type for
+  * 		each argument given. A registered command walks its template: each argument is located
+  * 		through the token index and converted by validateArgType(). Input arguments that are
+  * 		not part of the template are left as arg_none. Replayed macros arrive already converted.
   * @param[IN]  cmdParserOutput Parser Output Structure that holds all command/argument info
-  * @param[IN]	commandIndex Index of the command within the Command Table.
+  * @param[IN]	commandIndex Index of an existing command (shellCommandTemplate()).
   * @retval bool Returns true if all arguments are valid.
   */
-bool validateArgs(shellParserOutput_t* cmdParserOutput, uint8_t commandIndex) {
-	bool tokenFound;
-
-	// Loop through and find all mandatory arguments
-	for (uint8_t i = 0; i < shellCmdTemplateTable[commandIndex].numArgs; i++) {
-		if (shellCmdTemplateTable[commandIndex].cmdArgsTable[i].mandatory == true) {
-			// The argument is mandatory. Try to find the token in the parser output
-			tokenFound = false;
-			for (uint8_t j = 0; j < cmdParserOutput->numArgs; j++) {
-				if (cmdParserOutput->cmdArgs[j].argToken == shellCmdTemplateTable[commandIndex].cmdArgsTable[i].token) {
-					tokenFound = true;
-
-					// Found the token. Now we just need to confirm that the data type works.
-					if (!validateArgType(shellCmdTemplateTable[commandIndex].cmdArgsTable[i].type, cmdParserOutput->cmdArgs[j].argContents)) {
-						// The data type conflicts
-						return false;
-					}
-				}
-			}
+bool validateArgs(shellParserOutput_t* cmdParserOutput, uint16_t commandIndex) {
+	const shellCmdTemplate_t* cmd;
 
-			if (!tokenFound) {
-				// A required token is not present
-				return false;
-			}
+	if (cmdParserOutput->validated) {
+		return true;
+	}
+
+	if (commandIndex < NUM_OF_COMMANDS) {
+		return cmdValidators[commandIndex](cmdParserOutput);
+	}
+
+	// Every mandatory token must be present
+	cmd = shellCommandTemplate(commandIndex);
+	if ((runtimeMandatoryMask[commandIndex - NUM_OF_COMMANDS] & ~cmdParserOutput->argMask) != 0) {
+		return false;
+	}
+
+	// Convert every template argument that was given
+	for (uint8_t i = 0; i < cmd->numArgs; i++) {
+		const shellArgTemplate_t* argTemplate = &cmd->cmdArgsTable[i];
+		uint8_t slot = shellFindArg(cmdParserOutput, argTemplate->token);
+
+		if (slot != SHELL_ARG_NONE && !validateArgType(argTemplate->type, cmdParserOutput, slot)) {
+			// The data type conflicts
+			return false;
 		}
 	}
 	return true;
 }
 
 /**
-  * @brief  Tries to locate and match the command within the Command Table
+  * @brief  Confirms the Command Table is sorted by command name.
+  * @note	matchCommand() walks the table as a trie, so every entry must compare (strcmp)
+  * 		greater than the entry before it. Duplicate names are rejected as well.
+  * @param  NONE
+  * @retval bool Returns true if the table can be searched
+  */
+bool validateCommandTable(void) {
+	for (uint16_t i = 1; i < NUM_OF_COMMANDS; i++) {
+		if (strcmp(shellCmdTemplateTable[i - 1].cmdName, shellCmdTemplateTable[i].cmdName) >= 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  Locates the command by checking every entry of the Command Table in order.
+  * @note	Kept as the reference implementation for matchCommand(), e.g. for benchmarking.
   * @param[IN]  cmdParserOutput Parser Output Structure that holds all command/argument info
   * @param[OUT]	commandIndex Index of the command within the Command Table. If it can't find
   * 			a match, this returns a -1.
   * @retval shell_error Error Return Value
   */
-shell_error matchCommand(shellParserOutput_t* cmdParserOutput, int8_t* commandIndex) {
+shell_error matchCommandLinear(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex) {
 	shell_error status = SHELL_OK;
-	int ret;
-	bool matchFlag = false;
 
 	// Check each command name
-	for (uint8_t i = 0; i < NUM_OF_COMMANDS; i++) {
-		ret = strcmp((const char*)cmdParserOutput->cmdName, shellCmdTemplateTable[i].cmdName);
-		if (ret == 0) {
+	for (uint16_t i = 0; i < NUM_OF_COMMANDS; i++) {
+		if (strcmp((const char*)shellCmdName(cmdParserOutput), shellCmdTemplateTable[i].cmdName) == 0) {
 			// Matched. Set commandIndex to the current command.
-			matchFlag = true;
 			*commandIndex = i;
+			return status;
+		}
+	}
+
+	// We did not find a match
+	*commandIndex = -1;
+	return status;
+}
+
+/**
+  * @brief  Moves a trie node down to the child of one character
+  * @note	The entries of the node share depth characters, so their character at depth is
+  * 		sorted ('\0' first for a name that ends there). Two binary searches bound the child.
+  * @param[IN/OUT]  node Node, unchanged if there is no such child
+  * @param[IN]  c Next character of the name
+  * @retval bool Returns false if no name continues with c
+  */
+SHELL_RAMFUNC bool cmdTrieStep(cmdTrieNode_t* node, uint8_t c) {
+	uint16_t low = node->first;
+	uint16_t high = node->last;
+
+	// First entry with c at depth
+	while (low < high) {
+		uint16_t mid = low + ((high - low) / 2);
+		if (cmdTrieChar(mid, node->depth) < c) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	uint16_t first = low;
+
+	// One past the last entry with c at depth
+	high = node->last;
+	while (low < high) {
+		uint16_t mid = low + ((high - low) / 2);
+		if (cmdTrieChar(mid, node->depth) <= c) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (first == low) {
+		return false;
+	}
+	node->first = first;
+	node->last = low;
+	node->depth++;
+	return true;
+}
+
+/**
+  * @brief  Walks the trie from the root along a name or prefix
+  * @param[OUT]  node Node of the last character
+  * @param[IN]  name Characters to follow
+  * @param[IN]  len Number of characters (stops early at a '\0')
+  * @retval bool Returns false if no command starts with name
+  */
+SHELL_RAMFUNC bool cmdTrieWalk(cmdTrieNode_t* node, const uint8_t* name, uint32_t len) {
+	node->first = 0;
+	node->last = cmdNameCount;
+	node->depth = 0;
+
+	for (uint32_t i = 0; i < len && name[i] != '\0'; i++) {
+		if (!cmdTrieStep(node, name[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  FNV-1a hash of a command name
+  * @param[IN]  name Name, ends with '\0'
+  * @retval uint32_t Hash
+  */
+SHELL_RAMFUNC uint32_t cmdNameHash(const uint8_t* name) {
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash = (hash ^ *name++) * 16777619U;
+	}
+	return hash;
+}
+
+/**
+  * @brief  Adds a name to the hash index at its place, the entries after it move up one
+  * @note	Equal hashes stay in insertion order, a lookup compares the names of all of them.
+  * @param[IN]  name Command name, kept
+  * @param[IN]  command Command index
+  * @retval NONE
+  */
+void cmdHashInsert(const char* name, uint16_t command) {
+	uint32_t hash = cmdNameHash((const uint8_t*)name);
+	uint16_t low = 0;
+	uint16_t high = cmdHashCount;
+
+	while (low < high) {
+		uint16_t mid = low + ((high - low) / 2);
+		if (cmdHashes[mid] <= hash) {
+			low = mid + 1;
+		} else {
+			high = mid;
 		}
 	}
 
-	if (matchFlag == false) {
-		// We did not find a match
+	uint16_t moved = cmdHashCount - low;
+	memmove(&cmdHashes[low + 1], &cmdHashes[low], moved * sizeof(cmdHashes[0]));
+	memmove(&cmdHashNames[low + 1], &cmdHashNames[low], moved * sizeof(cmdHashNames[0]));
+	memmove(&cmdHashCommands[low + 1], &cmdHashCommands[low], moved * sizeof(cmdHashCommands[0]));
+	cmdHashes[low] = hash;
+	cmdHashNames[low] = name;
+	cmdHashCommands[low] = command;
+	cmdHashCount++;
+}
+
+/**
+  * @brief  Tries to locate and match the command within the Command Table
+  * @note	An exact name is a binary search of the hash index and one strcmp(). Otherwise it
+  * 		walks the name trie (see cmdTrieNode_t) once per character, O(length): the table
+  * 		must be sorted by name (see validateCommandTable()). With SHELL_PREFIX_MATCH a prefix
+  * 		that only one command starts with matches that command. Registered commands are
+  * 		part of both indexes.
+  * @param[IN]  cmdParserOutput Parser Output Structure that holds all command/argument info
+  * @param[OUT]	commandIndex Index of the command within the Command Table. If it can't find
+  * 			a match, this returns a -1.
+  * @retval shell_error Error Return Value
+  */
+SHELL_RAMFUNC shell_error matchCommand(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex) {
+	shell_error status = SHELL_OK;
+	cmdTrieNode_t node;
+
+	if (cmdHashCount != 0) {
+		const uint8_t* name = shellCmdName(cmdParserOutput);
+		uint32_t hash = cmdNameHash(name);
+		uint16_t low = 0;
+		uint16_t high = cmdHashCount;
+
+		// First entry with the hash
+		while (low < high) {
+			uint16_t mid = low + ((high - low) / 2);
+			if (cmdHashes[mid] < hash) {
+				low = mid + 1;
+			} else {
+				high = mid;
+			}
+		}
+		for (; low < cmdHashCount && cmdHashes[low] == hash; low++) {
+			if (strcmp(cmdHashNames[low], (const char*)name) == 0) {
+				*commandIndex = cmdHashCommands[low];
+				return status;
+			}
+		}
+#if !SHELL_PREFIX_MATCH
+		// Every name is in the index, only a prefix can still match
 		*commandIndex = -1;
+		return status;
+#endif
+	}
+
+	if (cmdTrieWalk(&node, shellCmdName(cmdParserOutput), UINT32_MAX)) {
+		// A name that ends here sorts first within the node
+		if (cmdTrieChar(node.first, node.depth) == '\0') {
+			*commandIndex = cmdNameCommands[node.first];
+			return status;
+		}
+#if SHELL_PREFIX_MATCH
+		if (node.depth > 0 && (node.last - node.first) == 1) {
+			*commandIndex = cmdNameCommands[node.first];
+			return status;
+		}
+#endif
 	}
 
+	// We did not find a match
+	*commandIndex = -1;
 	return status;
 }
 
 /**
-  * @brief  Matches the command then validates the arguments.
+  * @brief  Matches the command within the Command Table.
+  * @note	Sends a Command Error response if there is no match.
+  * @param[IN]  ctx Shell instance
   * @param[IN]  cmdParserOutput Parser Output Structure that holds all command/argument info
   * @param[OUT]	commandTableIndex Index of the command within the Command Table.
   * @retval shell_error Error Return Value
   */
-shell_error getCommand(shellParserOutput_t* cmdParserOutput, uint8_t* commandTableIndex) {
+shell_error getCommand(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t* commandTableIndex) {
 	shell_error status = SHELL_OK;
 
 	// Find the command within the Command Table
-	int8_t commandIndex;
+	int16_t commandIndex;
 	matchCommand(cmdParserOutput, &commandIndex);
 
 	if (commandIndex < 0) {
 		// Couldn't find the command
-		shellSendResponse(RESPONSE_CMD_ERR);
-		return SHELL_ERR;
-	}
-
-	// A command has been found. Validate the arguments.
-	if (!validateArgs(cmdParserOutput, commandIndex)) {
-		// Could not validate arguments
-		shellSendResponse(RESPONSE_ARG_ERR);
+		shellSendResponse(ctx, RESPONSE_CMD_ERR);
 		return SHELL_ERR;
 	}
 
@@ -377,145 +919,1262 @@ shell_error getCommand(shellParserOutput_t* cmdParserOutput, uint8_t* commandTab
 /*------------------------------------------------------------------------------*/
 
 /**
-  * @brief  Handles the command when received.
-  * @note	Performs all tasks from parsing to command function execution
-  * @param  NONE
-  * @retval shell_error Error Return Value
+  * @brief  Assembles a command line from the receive ring.
+  * @note	Fragments are joined across USB packets and one packet may hold several lines.
+  * 		The characters in SHELL_LINE_TERMINATORS complete a line, and an LF right after a CR
+  * 		is folded into the same terminator. Lines longer than SHELL_BUFFER_LEN are discarded
+  * 		in full and answered with a Line Too Long response. The line is edited at a cursor
+  * 		and echoed by the line editor (CLI_SHELL_EDIT.h).
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns true when ctx->rxBuffer holds a complete, non-empty line
   */
-shell_error shellProcessCommand(void) {
-	shell_error status;
+SHELL_RAMFUNC bool assembleLine(shell_ctx_t* ctx) {
+	uint8_t rxByte;
+	bool isTerminator;
+
+	while (shellRingGet(&ctx->rxRing, &rxByte)) {
+		isTerminator = (((SHELL_LINE_TERMINATORS & SHELL_TERM_CR) && rxByte == '\r') ||
+						((SHELL_LINE_TERMINATORS & SHELL_TERM_LF) && rxByte == '\n'));
+
+		// Ctrl-C throws away the line typed so far (the abort itself was flagged on receive)
+		if (rxByte == SHELL_ABORT_CHAR) {
+			ctx->rxLen = 0;
+			ctx->overflow = false;
+			ctx->lastWasCR = false;
+			ctx->edit.tail = 0;
+			shellEditEcho(ctx, "^C\r\n");
+			continue;
+		}
 
-	shellParserOutput_t parserOutput;
+		// Tab completes the command word, anywhere else it is kept
+		if (rxByte == SHELL_COMPLETE_CHAR && ctx->mode == SHELL_MODE_TEXT && !ctx->overflow &&
+				ctx->edit.tail == 0 && completeCommand(ctx)) {
+			continue;
+		}
 
-	// Step 1. Parse the Command to separate the command from the arguments
-	status = shellParseCommand(&parserOutput);
-	if (status != SHELL_OK){
-		return status;
-	}
+		// Fold CRLF into a single terminator
+		if (rxByte == '\n' && ctx->lastWasCR) {
+			ctx->lastWasCR = false;
+			continue;
+		}
+		ctx->lastWasCR = (isTerminator && rxByte == '\r' && (SHELL_LINE_TERMINATORS & SHELL_TERM_LF));
 
-	// Step 2. Find the correct command and verify the arguments
-	uint8_t commandTableIndex;
-	status = getCommand(&parserOutput, &commandTableIndex);
-	if (status != SHELL_OK){
-		return status;
-	}
+		// Cursor keys, backspace, history recall and the echo (CLI_SHELL_EDIT.h)
+		if (!isTerminator && ctx->mode == SHELL_MODE_TEXT && shellEditKey(ctx, rxByte)) {
+			continue;
+		}
 
-	// Step 3. Fetch and run the associated function
-	status = shellCmdTemplateTable[commandTableIndex].bridge(&parserOutput);
-	if (status != SHELL_OK){
-		shellSendResponse(RESPONSE_FNC_ERR);
-	} else {
-		shellSendResponse(RESPONSE_OK);
+		if (!isTerminator) {
+			if (ctx->rxLen < SHELL_BUFFER_LEN) {
+				ctx->rxBuffer[ctx->rxLen++] = rxByte;
+			} else {
+				ctx->overflow = true;
+			}
+			continue;
+		}
+
+		// A terminator - decide what to do with the line collected so far
+		ctx->edit.tail = 0;
+		shellEditEcho(ctx, "\r\n");
+		if (ctx->overflow) {
+			ctx->overflow = false;
+			ctx->rxLen = 0;
+			shellSendResponse(ctx, RESPONSE_LEN_ERR);
+			continue;
+		}
+
+		if (ctx->rxLen > 0) {
+			return true;
+		}
 	}
 
-	return status;
+	// The ring is drained, the echo of the whole burst goes out at once
+	shellEditFlush(ctx);
+	return false;
 }
 
 /**
-  * @brief  Parses a received command line and outputs to a shellParserOutput structure.
-  * @param[Out]  cmdParseOut Pointer to the parser output structure.
-  * @retval shell_error Error Return Value
+  * @brief  Completes the command word of the line being typed.
+  * @note	The word is extended as long as all commands starting with it agree on the next
+  * 		character, a command that is complete gets a space. The added characters are sent
+  * 		back so the terminal shows them. If nothing could be added the candidates are listed
+  * 		and the line is shown again, a bell is sent if nothing starts with the word.
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns false once the command word is finished (the tab is then kept)
   */
-shell_error shellParseCommand(shellParserOutput_t* cmdParseOut) {
-	shell_error status;
-	// Take care of any extra whitespace
-	scrubWhiteSpace();
+bool completeCommand(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 64);
+	cmdTrieNode_t node;
+	uint32_t start = 0;
+	uint32_t added = 0;
+
+	while (start < ctx->rxLen && ctx->rxBuffer[start] == ' ') {
+		start++;
+	}
+	if (memchr(&ctx->rxBuffer[start], ' ', ctx->rxLen - start) != NULL) {
+		return false;
+	}
 
-	// Prepare/clean the structure
-	cleanParserOutput(cmdParseOut);
+	if (!cmdTrieWalk(&node, &ctx->rxBuffer[start], ctx->rxLen - start)) {
+		shellStrAppendChar(&str, SHELL_COMPLETE_BELL);
+		shellStrSend(ctx, &str);
+		return true;
+	}
 
-	// Extract the command name and length and store into the parser output
-	status = exctractCommand(cmdParseOut);
-	if (status != SHELL_OK) {
-		return status;
+	// Sorted: the first and last entry agree on a character only if all entries do
+	while (ctx->rxLen < SHELL_BUFFER_LEN && cmdTrieChar(node.first, node.depth) != '\0' &&
+			cmdTrieChar(node.first, node.depth) == cmdTrieChar(node.last - 1, node.depth)) {
+		ctx->rxBuffer[ctx->rxLen++] = cmdTrieChar(node.first, node.depth);
+		node.depth++;
+		added++;
+	}
+	if ((node.last - node.first) == 1 && ctx->rxLen < SHELL_BUFFER_LEN) {
+		ctx->rxBuffer[ctx->rxLen++] = ' ';
+		added++;
 	}
 
-	// For each argument, get the token and store the argument content/length
-	status = extractArguments(cmdParseOut);
-	if (status != SHELL_OK) {
-		return status;
+	if (added > 0) {
+		shellOutputReserve(ctx, added);
+		outputStreamChannel(ctx, &ctx->rxBuffer[ctx->rxLen - added], added);
+		return true;
 	}
 
-	return status;
+	// Ambiguous: list the candidates, then the line again
+	shellStrAppend(&str, "\r\n");
+	for (uint16_t i = node.first; i < node.last; i++) {
+		if (str.len + strlen(cmdNames[i]) + 2 > str.size) {
+			shellStrSend(ctx, &str);
+		}
+		shellStrAppend(&str, cmdNames[i]);
+		shellStrAppendChar(&str, ' ');
+	}
+	shellStrAppend(&str, "\r\n");
+	shellOutputReserve(ctx, str.len + ctx->rxLen);
+	shellStrSend(ctx, &str);
+	outputStreamChannel(ctx, ctx->rxBuffer, ctx->rxLen);
+	return true;
 }
 
 /**
-  * @brief  Sends an error response based on the command result
-  * @param[In]  code Result Code to send
+  * @brief  Handles a complete line from the line buffer.
+  * @note	"!!" and "!<n>" run a history entry again (CLI_SHELL_HISTORY.h), every other line is
+  * 		recorded as it runs.
+  * @param[IN]  ctx Shell instance
   * @retval shell_error Error Return Value
   */
-shell_error shellSendResponse(responseCode_t code) {
-	shell_error status = SHELL_OK;
-	char tmpBuffer[30] = {0};
-
-	switch (code) {
-	case RESPONSE_OK:
-		strcpy(tmpBuffer, "-->OK!\r\n");
-		outputStreamChannel((uint8_t*)tmpBuffer, strlen(tmpBuffer));
-		break;
-
-	case RESPONSE_FNC_ERR:
-		strcpy(tmpBuffer, "-->Function Error!\r\n");
-		outputStreamChannel((uint8_t*)tmpBuffer, strlen(tmpBuffer));
-		break;
-
-	case RESPONSE_CMD_ERR:
-		strcpy(tmpBuffer, "Command Error!\r\n");
-		outputStreamChannel((uint8_t*)tmpBuffer, strlen(tmpBuffer));
-		break;
-
-	case RESPONSE_ARG_ERR:
-		strcpy(tmpBuffer, "Argument Error!\r\n");
-		outputStreamChannel((uint8_t*)tmpBuffer, strlen(tmpBuffer));
-		break;
+shell_error shellProcessLine(shell_ctx_t* ctx) {
+	shell_error status;
 
+	if (shellHistoryIsReplay(ctx->rxBuffer, ctx->rxLen)) {
+		return shellHistoryReplay(ctx, ctx->rxBuffer, ctx->rxLen);
 	}
 
+	shellHistoryBegin(ctx, ctx->rxBuffer, ctx->rxLen);
+	status = shellRunLine(ctx, ctx->rxBuffer, ctx->rxLen);
+	shellHistoryEnd(ctx);
 	return status;
 }
 
+/**
+  * @brief  Runs a text line
+  * @note	A line of the form "{ cmd1 ; cmd2 ; ... }" is run as a batch, "every <period> <cmd>" is
+  * 		scheduled (CLI_SHELL_SCHED.h), "@<node> <line>" is sent to a downstream board
+  * 		(CLI_SHELL_GATEWAY.h), anything else is run as a single command. The line is tokenized in
+  * 		place and needs one byte of room after it.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Line without its terminator, the line buffer or an urgent line (CLI_SHELL_URGENT.h)
+  * @param[IN]  len Number of characters
+  * @retval shell_error Error Return Value
+  */
+shell_error shellRunLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	shell_error status;
+
+	// Trim surrounding whitespace to find the tag and the batch braces
+	while (len > 0 && *line == ' ') {
+		line++;
+		len--;
+	}
+	while (len > 0 && line[len - 1] == ' ') {
+		len--;
+	}
+	ctx->tag = takeTag(&line, &len);
+	int16_t node = shellGatewayTakeNode(&line, &len);
+
+	// A period right after the keyword, "every" alone is the list command. The same for the pin of "arm".
+	uint32_t keywordLen = strlen(SHELL_SCHED_KEYWORD);
+	uint32_t regressLen = strlen(SHELL_REGRESS_KEYWORD);
+	uint32_t armLen = strlen(SHELL_ARM_KEYWORD);
+
+	if (node != SHELL_GATEWAY_LOCAL) {
+		status = shellGatewayForward(ctx, node, line, len);
+	} else if (len >= 2 && line[0] == SHELL_BATCH_OPEN && line[len - 1] == SHELL_BATCH_CLOSE) {
+		status = shellProcessBatch(ctx, &line[1], len - 2);
+	} else if (len > keywordLen && memcmp(line, SHELL_SCHED_KEYWORD, keywordLen) == 0 &&
+			line[keywordLen] >= '0' && line[keywordLen] <= '9') {
+		status = shellSchedLine(ctx, &line[keywordLen], len - keywordLen);
+	} else if (len > armLen && memcmp(line, SHELL_ARM_KEYWORD, armLen) == 0 && line[armLen] == 'P') {
+		status = shellArmLine(ctx, &line[armLen], len - armLen);
+	} else if (SHELL_BENCHMARK && len > regressLen && memcmp(line, SHELL_REGRESS_KEYWORD, regressLen) == 0 &&
+			line[regressLen] >= '0' && line[regressLen] <= '9') {
+		status = shellRegressLine(ctx, &line[regressLen], len - regressLen);
+	} else {
+		status = shellProcessCommand(ctx, line, len);
+	}
+
+	// Scheduled runs and job responses later on are not answers to this line
+	ctx->tag = SHELL_NO_TAG;
+	return status;
+}
+
+/**
+  * @brief  Tokenizes and matches a line ahead of its turn, without sending anything
+  * @note	Stage one of the pipeline (CLI_SHELL_PIPE.h), called from the receive interrupt. Only
+  * 		a line shellRunLine() would hand to shellProcessCommand() as it is qualifies: no tag,
+  * 		node address, batch, schedule, armed command, regression case or history replay. The line is trimmed
+  * 		and tokenized in place, a line that fails is left for the normal path to answer.
+  * @param[IN]  line Line without its terminator, one byte of room after it
+  * @param[IN]  len Number of characters
+  * @param[OUT]  cmdParseOut Parser output, tokenized and matched
+  * @param[OUT]  commandIndex Index of the command
+  * @retval bool Returns false if the line has to take the normal path
+  */
+bool shellParseAhead(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut, uint16_t* commandIndex) {
+	uint32_t keywordLen = strlen(SHELL_SCHED_KEYWORD);
+	uint32_t regressLen = strlen(SHELL_REGRESS_KEYWORD);
+	uint32_t armLen = strlen(SHELL_ARM_KEYWORD);
+	int16_t index;
+
+	while (len > 0 && *line == ' ') {
+		line++;
+		len--;
+	}
+	while (len > 0 && line[len - 1] == ' ') {
+		len--;
+	}
+	if (len == 0 || line[0] == SHELL_TAG_CHAR || line[0] == SHELL_NODE_CHAR || line[0] == SHELL_BATCH_OPEN ||
+			line[0] == SHELL_HISTORY_CHAR) {
+		return false;
+	}
+	if (len > keywordLen && memcmp(line, SHELL_SCHED_KEYWORD, keywordLen) == 0 &&
+			line[keywordLen] >= '0' && line[keywordLen] <= '9') {
+		return false;
+	}
+	if (len > armLen && memcmp(line, SHELL_ARM_KEYWORD, armLen) == 0 && line[armLen] == 'P') {
+		return false;
+	}
+	if (SHELL_BENCHMARK && len > regressLen && memcmp(line, SHELL_REGRESS_KEYWORD, regressLen) == 0 &&
+			line[regressLen] >= '0' && line[regressLen] <= '9') {
+		return false;
+	}
+
+	cleanParserOutput(cmdParseOut);
+	if (tokenizeLine(line, len, cmdParseOut) != SHELL_OK) {
+		return false;
+	}
+	matchCommand(cmdParseOut, &index);
+	if (index < 0) {
+		return false;
+	}
+	*commandIndex = (uint16_t)index;
+	return true;
+}
+
+/**
+  * @brief  Takes a request tag ("#<digits> ") off the front of a trimmed line.
+  * @note	Anything else starting with SHELL_TAG_CHAR stays on the line and fails as a command.
+  * @param[IN,OUT]  line Line, moved past the tag and the spaces after it
+  * @param[IN,OUT]  len Length of the line, shortened accordingly
+  * @retval int32_t The tag, SHELL_NO_TAG if the line has none
+  */
+int32_t takeTag(uint8_t** line, uint32_t* len) {
+	const uint8_t* text = *line;
+	int32_t tag = 0;
+	uint32_t i = 1;
+
+	if (*len < 2 || text[0] != SHELL_TAG_CHAR) {
+		return SHELL_NO_TAG;
+	}
+	while (i < *len && i <= SHELL_TAG_DIGITS && text[i] >= '0' && text[i] <= '9') {
+		tag = (tag * 10) + (text[i] - '0');
+		i++;
+	}
+	if (i == 1 || (i < *len && text[i] != ' ')) {
+		return SHELL_NO_TAG;
+	}
+
+	while (i < *len && text[i] == ' ') {
+		i++;
+	}
+	*line += i;
+	*len -= i;
+	return tag;
+}
+
+/**
+  * @brief  Runs every command of a batch and sends one combined response.
+  * @note	Individual responses are held back while the batch runs (bridge output is not).
+  * 		The batch stops at the first failing command, which is reported by position. Empty
+  * 		entries are skipped, and a mode change only happens once the batch is done.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Batch contents between the braces. Separators are overwritten.
+  * @param[IN]  len Length of the batch contents
+  * @retval shell_error Error Return Value
+  */
+shell_error shellProcessBatch(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	shell_error status = SHELL_OK;
+	uint32_t start = 0;
+	uint8_t position = 0;
+	SHELL_STR_DEFINE(str, 48);
+
+	ctx->batchActive = true;
+	ctx->batchStatus = RESPONSE_OK;
+
+	while (start < len && ctx->batchStatus == RESPONSE_OK) {
+		// Find the end of this entry
+		uint32_t end = start;
+		while (end < len && line[end] != SHELL_BATCH_SEPARATOR) {
+			end++;
+		}
+
+		// Skip entries that are only whitespace
+		uint32_t i = start;
+		while (i < end && line[i] == ' ') {
+			i++;
+		}
+		if (i < end) {
+			position++;
+			status = shellProcessCommand(ctx, &line[start], end - start);
+		}
+
+		start = end + 1;
+	}
+
+	ctx->batchActive = false;
+	ctx->mode = ctx->pendingMode;
+
+	if (ctx->batchStatus != RESPONSE_OK) {
+		// The tag leads the line, the response after it goes untagged
+		int32_t tag = ctx->tag;
+
+		if (tag != SHELL_NO_TAG) {
+			shellStrAppendChar(&str, SHELL_TAG_CHAR);
+			shellStrAppendUnsigned(&str, (uint32_t)tag, 0);
+			shellStrAppendChar(&str, ' ');
+		}
+		shellStrAppend(&str, "Batch stopped at ");
+		shellStrAppendUnsigned(&str, position, 0);
+		shellStrAppend(&str, ": ");
+		shellStrSend(ctx, &str);
+
+		ctx->tag = SHELL_NO_TAG;
+		shellSendResponse(ctx, ctx->batchStatus);
+		ctx->tag = tag;
+	} else {
+		shellSendResponse(ctx, ctx->batchStatus);
+	}
+
+	return status;
+}
+
+/**
+  * @brief  Handles the command when received.
+  * @note	Performs all tasks from parsing to command function execution
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Command line. It is tokenized in place.
+  * @param[IN]  len Length of the command line
+  * @retval shell_error Error Return Value
+  */
+shell_error shellProcessCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	shell_error status;
+
+	shellParserOutput_t parserOutput;
+
+	// Step 1. Parse the Command to separate the command from the arguments
+	SHELL_TRACE(traceEvt_cmdStart, ctx->port, len);
+	SHELL_CRASH_NOTE(ctx->port, line, len);
+	ctx->perfStamps[0] = shellPerfCycles();
+	status = shellParseCommand(ctx, line, len, &parserOutput);
+	if (status != SHELL_OK){
+		return status;
+	}
+	ctx->perfStamps[perfStage_parse + 1] = shellPerfCycles();
+
+	// Step 2. Find the correct command
+	uint16_t commandTableIndex;
+	status = getCommand(ctx, &parserOutput, &commandTableIndex);
+	if (status != SHELL_OK){
+		return status;
+	}
+	ctx->perfStamps[perfStage_match + 1] = shellPerfCycles();
+	ctx->perfStamped = true;
+
+	// Step 3. Verify the arguments, then fetch and run the associated function
+	return shellDispatch(ctx, &parserOutput, commandTableIndex);
+}
+
+/**
+  * @brief  Parses a received command line and outputs to a shellParserOutput structure.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Command line
+  * @param[IN]  len Length of the command line
+  * @param[Out]  cmdParseOut Pointer to the parser output structure.
+  * @retval shell_error Error Return Value
+  */
+shell_error shellParseCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut) {
+	shell_error status;
+
+	// Prepare/clean the structure
+	cleanParserOutput(cmdParseOut);
+
+	// Split the command name and every argument (token + contents) out of the line in one pass
+	status = tokenizeLine(line, len, cmdParseOut);
+	if (status != SHELL_OK) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return status;
+	}
+
+	return status;
+}
+
+/**
+  * @brief  Sends an error response based on the command result
+  * @param[IN]  ctx Shell instance
+  * @param[In]  code Result Code to send
+  * @retval shell_error Error Return Value
+  */
+shell_error shellSendResponse(shell_ctx_t* ctx, responseCode_t code) {
+	shell_error status = SHELL_OK;
+	const char* text = NULL;
+
+	// The response of a cacheable command is complete
+	shellCacheEnd(ctx, code);
+
+	// Inside a batch only the first failure is kept. The batch sends one response at the end.
+	if (ctx->batchActive) {
+		if (ctx->batchStatus == RESPONSE_OK) {
+			ctx->batchStatus = code;
+		}
+		return status;
+	}
+
+	// Binary sessions carry the code in the status byte of the closing response frame
+	if (ctx->mode == SHELL_MODE_BINARY) {
+		shellBinaryEndResponse(ctx, code);
+		return status;
+	}
+
+	switch (code) {
+	case RESPONSE_OK:
+		text = "-->OK!\r\n";
+		break;
+
+	case RESPONSE_FNC_ERR:
+		text = "-->Function Error!\r\n";
+		break;
+
+	case RESPONSE_CMD_ERR:
+		text = "Command Error!\r\n";
+		break;
+
+	case RESPONSE_ARG_ERR:
+		text = "Argument Error!\r\n";
+		break;
+
+	case RESPONSE_LEN_ERR:
+		text = "Line Too Long!\r\n";
+		break;
+
+	case RESPONSE_FRAME_ERR:
+		text = "Frame Error!\r\n";
+		break;
+
+	case RESPONSE_CANCELLED:
+		text = "-->Cancelled!\r\n";
+		break;
+
+	}
+
+	if (text != NULL && ctx->tag != SHELL_NO_TAG) {
+		// One write, the tag and its response stay together
+		SHELL_STR_DEFINE(str, 40);
+
+		shellStrAppendChar(&str, SHELL_TAG_CHAR);
+		shellStrAppendUnsigned(&str, (uint32_t)ctx->tag, 0);
+		shellStrAppendChar(&str, ' ');
+		shellStrAppend(&str, text);
+		shellStrSend(ctx, &str);
+	} else if (text != NULL) {
+		shellOutputReserve(ctx, strlen(text));
+		outputStreamChannel(ctx, (const uint8_t*)text, strlen(text));
+	}
+	return status;
+}
+
+/**
+  * @brief  Counts and traces a bridge run past the command's deadline (SHELL_DEADLINE_LIST)
+  * @note	Called by shellDispatch() with the stamps of the run. The deadline is in us, so it
+  * 		holds at every clock profile. Cache hits count as the bridge.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  commandIndex Index of the command within the Command Table
+  * @retval NONE
+  */
+void checkDeadline(shell_ctx_t* ctx, uint16_t commandIndex) {
+	// Registered commands have no deadline
+	if (commandIndex >= NUM_OF_COMMANDS || shellDeadlineTable[commandIndex] == 0) {
+		return;
+	}
+
+	uint32_t deadlineUs = shellDeadlineTable[commandIndex];
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+	uint32_t bridgeCycles = ctx->perfStamps[perfStage_bridge + 1] - ctx->perfStamps[perfStage_bridge];
+
+	if (bridgeCycles > deadlineUs * cyclesPerUs) {
+		uint32_t bridgeUs = bridgeCycles / cyclesPerUs;
+
+		cmdPerfStats[commandIndex].overruns++;
+		SHELL_TRACE(traceEvt_overrun, ctx->port, (bridgeUs > UINT16_MAX) ? UINT16_MAX : bridgeUs);
+	}
+}
+
 
 /********************************************************************************
  * PUBLIC FUNCTIONS
  *******************************************************************************/
-shell_error shellInit(void) {
-	cliShellInitialized = true;
+/**
+  * @brief  Parses, looks up and validates a command line without running it.
+  * @note	For commands that run later (CLI_SHELL_SCHED.c). Failures are answered here. The
+  * 		parser output is marked validated, its slices stay in line.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Command line (len + 1 bytes). It is tokenized in place.
+  * @param[IN]  len Length of the command line
+  * @param[OUT]  cmdParseOut Pointer to the parser output structure.
+  * @param[OUT]	commandIndex Index of the command within the Command Table.
+  * @retval shell_error Error Return Value
+  */
+shell_error shellResolveCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut,
+		uint16_t* commandIndex) {
+	shell_error status;
+
+	status = shellParseCommand(ctx, line, len, cmdParseOut);
+	if (status != SHELL_OK) {
+		return status;
+	}
+
+	status = getCommand(ctx, cmdParseOut, commandIndex);
+	if (status != SHELL_OK) {
+		return status;
+	}
+
+	if (!validateArgs(cmdParseOut, *commandIndex)) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	cmdParseOut->validated = true;
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Validates the arguments of a resolved command, runs its bridge and sends the response.
+  * @note	Shared by the text parser and the binary frame protocol. A pending mode change
+  * 		(see ModeBridge) takes effect once the response has been sent. A bridge returning
+  * 		SHELL_BUSY started a job, which sends the response later (CLI_SHELL_JOB.h).
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  cmdParserOutput Parser Output Structure that holds all command/argument info
+  * @param[IN]	commandIndex Index of the command within the Command Table.
+  * @retval shell_error Error Return Value
+  */
+shell_error shellDispatch(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t commandIndex) {
+	shell_error status;
+
+	if (!ctx->perfStamped) {
+		// Binary frames arrive already resolved, there is nothing to parse or match
+		ctx->perfStamps[0] = shellPerfCycles();
+		ctx->perfStamps[perfStage_parse + 1] = ctx->perfStamps[0];
+		ctx->perfStamps[perfStage_match + 1] = ctx->perfStamps[0];
+	}
+	ctx->perfStamped = false;
+
+	const shellCmdTemplate_t* cmd = shellCommandTemplate(commandIndex);
+
+	if (cmd == NULL) {
+		shellSendResponse(ctx, RESPONSE_CMD_ERR);
+		return SHELL_ERR;
+	}
+
+	if (!validateArgs(cmdParserOutput, commandIndex)) {
+		// Could not validate arguments
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	ctx->perfStamps[perfStage_validate + 1] = shellPerfCycles();
+
+	if (cmd->bridge != MacroBridge && !cmdParserOutput->periodic) {
+		shellMacroCapture(ctx, cmdParserOutput, commandIndex);
+	}
+	shellHistoryCapture(ctx, cmdParserOutput, commandIndex);
+
+	shellBootStamp(bootStage_command);
+	SHELL_TRACE(traceEvt_bridgeStart, ctx->port, commandIndex);
+	if (shellCacheBegin(ctx, cmdParserOutput, commandIndex)) {
+		// Answered with the kept response, nothing it depends on has changed
+		status = SHELL_OK;
+	} else {
+		status = cmd->bridge(ctx, cmdParserOutput);
+		shellCacheHold(ctx);
+	}
+	ctx->perfStamps[perfStage_bridge + 1] = shellPerfCycles();
+	SHELL_TRACE(traceEvt_bridgeEnd, ctx->port, status);
+	shellPerfRecord(&cmdPerfStats[commandIndex], ctx->perfStamps);
+	checkDeadline(ctx, commandIndex);
+
+	if (status == SHELL_BUSY) {
+		if (!ctx->batchActive) {
+			// The job sends the response when it is done
+			ctx->mode = ctx->pendingMode;
+			return SHELL_OK;
+		}
+		// Keep the batch in order
+		status = shellJobRun();
+		return status;
+	}
+
+	if (status != SHELL_OK){
+		SHELL_LOG(SHELL_LOG_DBG, "%s: error %d on port %u", cmd->cmdName, (int)status, ctx->port);
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+	} else {
+		shellSendResponse(ctx, RESPONSE_OK);
+	}
+
+	if (!ctx->batchActive) {
+		ctx->mode = ctx->pendingMode;
+	}
+	return status;
+}
+
+/**
+  * @brief  Sends bridge/response output in the format of the current session mode.
+  * @note	outputStreamChannel() maps here. Text sessions go straight to the transport,
+  * 		binary sessions are wrapped into response frames.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  buffer Data to send
+  * @param[IN]  length Number of bytes
+  * @retval uint16_t Number of bytes accepted
+  */
+uint16_t shellOutputWrite(shell_ctx_t* ctx, const uint8_t* buffer, uint16_t length) {
+	if (ctx->outputMuted) {
+		shellRegressCapture(ctx, buffer, length);
+		return length;
+	}
+	shellCacheRecord(ctx, buffer, length);
+	if (ctx->mode == SHELL_MODE_BINARY) {
+		shellBinaryWrite(ctx, buffer, length);
+		return length;
+	}
+	return transportWrite(ctx, buffer, length);
+}
+
+/**
+  * @brief  Waits until the transport can take length more bytes.
+  * @note	Bridges with a lot of output call this before each piece so it is sent packet by
+  * 		packet instead of being dropped. shellStrSend(), the text responses and the binary
+  * 		response frames call it for every write. The transmit queue drains from the
+  * 		transport's interrupt.
+  * 		After a timeout the instance is stalled: later calls fail at once instead of waiting
+  * 		again, until there is room or the next line or frame comes in. A host that stops
+  * 		reading holds the main loop up for SHELL_TX_WAIT_MS once, not for every write.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  length Number of bytes about to be written
+  * @retval bool Returns false if there was no room within SHELL_TX_WAIT_MS, the transmit path
+  * 		is stalled or an abort is pending
+  */
+bool shellOutputReserve(shell_ctx_t* ctx, uint16_t length) {
+	uint32_t start;
+
+	if (ctx->outputMuted) {
+		return true;
+	}
+
+	// Streaming bridges stop here on Ctrl-C
+	if (ctx->abortRequested) {
+		return false;
+	}
+
+	// Room for a binary frame header/CRC as well
+	length += SHELL_TX_RESERVE_MARGIN;
+
+	// Every response passes here, the clock is only read when there is no room
+	if (transportFree(ctx) >= length) {
+		ctx->txStalled = false;
+		return true;
+	}
+	if (ctx->txStalled) {
+		return false;
+	}
+
+	start = HAL_GetTick();
+	while (transportFree(ctx) < length) {
+		transportFlush(ctx);
+		if ((HAL_GetTick() - start) > SHELL_TX_WAIT_MS) {
+			ctx->txStalled = true;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  Room to format length bytes of output in place, sent by shellOutputCommit()
+  * @note	Never waits (call shellOutputReserve() first to wait for room). In a text session the
+  * 		block lies in the transport's transmit queue, nothing is copied. Otherwise, or if the
+  * 		free space wraps before length bytes, it is the staging buffer, copied once on commit.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  length Most bytes that will be written
+  * @retval uint8_t* Block of length bytes, NULL if there is no room right now
+  */
+uint8_t* shellOutputAcquire(shell_ctx_t* ctx, uint16_t length) {
+	uint8_t* data = NULL;
+
+	ctx->outputSpan = NULL;
+	if (!ctx->outputMuted && ctx->mode == SHELL_MODE_TEXT && transportTxSpan(ctx, &data) >= length) {
+		ctx->outputSpan = data;
+		return data;
+	}
+
+	if (length > SHELL_OUTPUT_STAGE_LEN ||
+			(!ctx->outputMuted && transportFree(ctx) < (uint32_t)length + SHELL_TX_RESERVE_MARGIN)) {
+		return NULL;
+	}
+	return outputStage;
+}
+
+/**
+  * @brief  Sends the first length bytes of the block of shellOutputAcquire()
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  length Bytes written, up to the length acquired
+  * @retval NONE
+  */
+void shellOutputCommit(shell_ctx_t* ctx, uint16_t length) {
+	if (ctx->outputSpan == NULL) {
+		shellOutputWrite(ctx, outputStage, length);
+		return;
+	}
+
+	shellCacheRecord(ctx, ctx->outputSpan, length);
+	transportTxCommit(ctx, length);
+	ctx->outputSpan = NULL;
+}
+
+/**
+  * @brief  Appends length characters of text to a response builder
+  * @note	What does not fit is cut, the builder is marked truncated.
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  text Characters, no terminator needed
+  * @param[IN]  length Number of characters
+  * @retval NONE
+  */
+void shellStrAppendN(shellStr_t* str, const char* text, uint16_t length) {
+	uint16_t room = str->size - str->len;
+
+	if (length > room) {
+		length = room;
+		str->truncated = true;
+	}
+	memcpy(&str->buf[str->len], text, length);
+	str->len += length;
+}
+
+/**
+  * @brief  Appends a NUL-terminated string to a response builder
+  * @note	Only text is scanned for its length, the builder keeps its own.
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  text NUL-terminated text
+  * @retval NONE
+  */
+void shellStrAppend(shellStr_t* str, const char* text) {
+	shellStrAppendN(str, text, strlen(text));
+}
+
+/**
+  * @brief  Appends one character to a response builder
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  c Character
+  * @retval NONE
+  */
+void shellStrAppendChar(shellStr_t* str, char c) {
+	if (str->len < str->size) {
+		str->buf[str->len++] = c;
+	} else {
+		str->truncated = true;
+	}
+}
+
+/**
+  * @brief  Appends a decimal to a response builder
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  value Value
+  * @param[IN]  minDigits Zero padded to this many digits, 0 for none
+  * @retval NONE
+  */
+void shellStrAppendUnsigned(shellStr_t* str, uint32_t value, uint8_t minDigits) {
+	char digits[SHELL_FMT_DEC_LEN];
+	uint8_t len = shellFmtUnsigned(digits, value);
+
+	for (; minDigits > len; minDigits--) {
+		shellStrAppendChar(str, '0');
+	}
+	shellStrAppendN(str, digits, len);
+}
+
+/**
+  * @brief  Appends the low hex digits of a value to a response builder
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  value Value
+  * @param[IN]  digits Number of digits (1 to 8), with leading zeros
+  * @retval NONE
+  */
+void shellStrAppendHex(shellStr_t* str, uint32_t value, uint8_t digits) {
+	char hex[8];
+
+	if (digits == 0 || digits > sizeof(hex)) {
+		digits = sizeof(hex);
+	}
+	shellFmtHex32(hex, value);
+	shellStrAppendN(str, &hex[sizeof(hex) - digits], digits);
+}
+
+/**
+  * @brief  Sends what a response builder holds and empties it
+  * @note	Waits for room first (shellOutputReserve()), the line is only cut if the host has
+  * 		not read for SHELL_TX_WAIT_MS (then without waiting until it reads again) or an
+  * 		abort is pending.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @retval NONE
+  */
+void shellStrSend(shell_ctx_t* ctx, shellStr_t* str) {
+	shellOutputReserve(ctx, str->len);
+	outputStreamChannel(ctx, (const uint8_t*)str->buf, str->len);
+	str->len = 0;
+	str->truncated = false;
+}
+
+/**
+  * @brief  Cycle statistics of a command
+  * @param[IN]	commandIndex Index of the command (Command Table or registered).
+  * @retval const shellPerfStat_t* Statistics, or NULL if the index is out of range
+  */
+const shellPerfStat_t* shellPerfStats(uint16_t commandIndex) {
+	if (shellCommandTemplate(commandIndex) == NULL) {
+		return NULL;
+	}
+	return &cmdPerfStats[commandIndex];
+}
+
+/**
+  * @brief  Clears the cycle statistics of every command
+  * @param  NONE
+  * @retval NONE
+  */
+void shellPerfClear(void) {
+	shellPerfReset(cmdPerfStats, SHELL_MAX_COMMANDS);
+}
+
+/**
+  * @brief  Number of entries in the Command Table
+  * @note	Registered commands take the indices from here on (shellRegisterCommand()), the
+  * 		count also ends the annotation tables (urgent, cacheable).
+  * @param  NONE
+  * @retval uint16_t Command count
+  */
+uint16_t shellCommandCount(void) {
+	return NUM_OF_COMMANDS;
+}
+
+/**
+  * @brief  Name of a command
+  * @param[IN]	commandIndex Index of the command (Command Table or registered).
+  * @retval const char* Command name, or NULL if the index is out of range
+  */
+const char* shellCommandName(uint16_t commandIndex) {
+	const shellCmdTemplate_t* cmd = shellCommandTemplate(commandIndex);
+
+	return (cmd != NULL) ? cmd->cmdName : NULL;
+}
+
+/**
+  * @brief  Template of a command
+  * @param[IN]	commandIndex Index of the command, Command Table entries first, then the
+  * 			registered commands in the order they were registered
+  * @retval const shellCmdTemplate_t* Template, or NULL if the index is out of range
+  */
+const shellCmdTemplate_t* shellCommandTemplate(uint16_t commandIndex) {
+	if (commandIndex < NUM_OF_COMMANDS) {
+		return &shellCmdTemplateTable[commandIndex];
+	}
+	if (commandIndex - NUM_OF_COMMANDS < runtimeCmdCount) {
+		return runtimeCmds[commandIndex - NUM_OF_COMMANDS];
+	}
+	return NULL;
+}
+
+/**
+  * @brief  Identifies the layout of the Command Table
+  * @note	CRC16 over the command names and their argument templates, the registered commands
+  * 		included. Anything stored with command indexes (macros) is only valid while the id
+  * 		matches.
+  * @param  NONE
+  * @retval uint16_t Command Table id
+  */
+uint16_t shellCommandTableId(void) {
+	uint16_t crc = SHELL_BIN_CRC_INIT;
+
+	for (uint16_t i = 0; i < NUM_OF_COMMANDS + runtimeCmdCount; i++) {
+		const shellCmdTemplate_t* cmd = shellCommandTemplate(i);
+
+		crc = shellCrc16(crc, (const uint8_t*)cmd->cmdName, strlen(cmd->cmdName) + 1);
+		crc = shellCrc16(crc, (const uint8_t*)cmd->cmdArgsTable, cmd->numArgs * sizeof(shellArgTemplate_t));
+	}
+	return crc;
+}
+
+/**
+  * @brief  Adds an argument to the token index and mask of the parser output
+  * @note	If a token is given more than once, the first occurrence is used.
+  * @param[IN,OUT]  cmdParserOutput Parser Output Structure
+  * @param[IN]	argIndex Index of the argument within cmdArgs
+  * @retval NONE
+  */
+void shellIndexArg(shellParserOutput_t* cmdParserOutput, uint8_t argIndex) {
+	argToken_t token = cmdParserOutput->cmdArgs[argIndex].argToken;
+
+	if (token >= argTkn_err || shellHasArg(cmdParserOutput, token)) {
+		return;
+	}
+
+	cmdParserOutput->argMask |= shellTokenBit(token);
+	cmdParserOutput->argSlot[token] = argIndex;
+}
+
+/**
+  * @brief  Copies the elements of a validated array argument into a typed array
+  * @note	uint8_t, uint16_t or uint32_t elements by the argument type (arg_u8_array, ...).
+  * 		The elements stay in the line as they were sent, so scheduled and recorded commands
+  * 		read them the same way.
+  * @param[IN]  cmdParserOutput Parser Output Structure
+  * @param[IN]	argIndex Index of the argument (shellFindArg()), SHELL_ARG_NONE gives 0
+  * @param[OUT]  items Elements
+  * @param[IN]  maxItems Room in items
+  * @retval uint8_t Number of elements copied, 0 if the argument is no validated array
+  */
+uint8_t shellArgArray(const shellParserOutput_t* cmdParserOutput, uint8_t argIndex, void* items, uint8_t maxItems) {
+	if (argIndex == SHELL_ARG_NONE) {
+		return 0;
+	}
+
+	argType_t type = cmdParserOutput->cmdArgs[argIndex].argType;
+	if (type != arg_u8_array && type != arg_u16_array && type != arg_u32_array) {
+		return 0;
+	}
+
+	int16_t count = walkArgArray(cmdParserOutput, argIndex, type, items, maxItems);
+	if (count < 0) {
+		return 0;
+	}
+	return (count < maxItems) ? (uint8_t)count : maxItems;
+}
+
+/**
+  * @brief  Initializes a shell instance and attaches it to its transport port.
+  * @note	The Command Table is checked here. If it is not sorted, the instance stays disabled.
+  * 		Everything else about the table is checked at compile time (CLI_SHELL_COMMANDS.h).
+  * 		The command statistics are shared by all instances and cleared by each init. The
+  * 		first init registers the commands of the modules in flash (CLI_SHELL_MODULE.h). The
+  * 		session settings saved before a soft reset come back (CLI_SHELL_SESSION.h).
+  * @param[IN]  ctx Shell instance (SHELL_CTX_DEFINE)
+  * @param[IN]  transport Transport the instance runs over (CDC_Transport_FS, shellUartTransport)
+  * @param[IN]  port Port of the transport the instance serves (CDC_CH_, 0 for the USART)
+  * @retval shell_error Error Return Value
+  */
+shell_error shellInit(shell_ctx_t* ctx, const shellTransport_t* transport, uint8_t port) {
+	ctx->transport = transport;
+	ctx->port = port;
+	ctx->tag = SHELL_NO_TAG;
+	ctx->txStalled = false;
+	ctx->edit.echo = SHELL_EDIT_ECHO;
+	shellPipeAttach(ctx);
+
+	if (transport == NULL || !validateCommandTable()) {
+		ctx->initialized = false;
+		return SHELL_ERR;
+	}
+	shellModuleScan();
+	if (cmdHashCount == 0) {
+		// Commands registered before the first init are in the name index already
+		for (uint16_t i = 0; i < cmdNameCount; i++) {
+			cmdHashInsert(cmdNames[i], cmdNameCommands[i]);
+		}
+	}
+
+	shellPerfInit();
+	shellPerfClear();
+	shellTraceInit();
+	// Mode, compression and echo saved before a soft or watchdog reset
+	shellSessionRestore(ctx);
+
+	ctx->initialized = true;
+	transportAttach(ctx);
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Adds a command at runtime
+  * @note	The name is inserted into the sorted name index at its place (binary search, the
+  * 		entries after it move up one), so the trie of matchCommand() has it right away and
+  * 		nothing is rebuilt. The index must not change while a line is matched: register
+  * 		before the first shellInit(), which scans the modules the same way. The template is
+  * 		kept, not copied. The checks of CLI_SHELL_COMMANDS.h that run at compile time run
+  * 		here: name length and characters, argument count, tokens and types.
+  * @param[IN]  cmd Command template
+  * @param[OUT]  commandIndex Index of the command, shellCommandCount() and up
+  * @retval shell_error SHELL_ERR for a bad template, a name that is taken or no room left
+  */
+shell_error shellRegisterCommand(const shellCmdTemplate_t* cmd, uint16_t* commandIndex) {
+	uint32_t nameLen = 0;
+	uint32_t tokens = 0;
+	uint32_t mandatoryMask = 0;
+
+	if (runtimeCmdCount >= SHELL_MODULE_MAX_COMMANDS || cmd->bridge == NULL || cmd->helpDesc == NULL ||
+			cmd->numArgs > MAX_ARGUMENTS) {
+		return SHELL_ERR;
+	}
+
+	// One printable word that fits the parser
+	while (cmd->cmdName[nameLen] != '\0') {
+		if (nameLen >= SHELL_CMD_LEN || cmd->cmdName[nameLen] <= ' ' || cmd->cmdName[nameLen] > '~') {
+			return SHELL_ERR;
+		}
+		nameLen++;
+	}
+	if (nameLen == 0) {
+		return SHELL_ERR;
+	}
+
+	for (uint8_t i = 0; i < cmd->numArgs; i++) {
+		const shellArgTemplate_t* argTemplate = &cmd->cmdArgsTable[i];
+
+		if (argTemplate->token >= argTkn_err || argTemplate->type > arg_u32_array || argTemplate->type == arg_none ||
+				(tokens & shellTokenBit(argTemplate->token)) != 0) {
+			return SHELL_ERR;
+		}
+		tokens |= shellTokenBit(argTemplate->token);
+		if (argTemplate->mandatory) {
+			mandatoryMask |= shellTokenBit(argTemplate->token);
+		}
+	}
+
+	// Place of the name, names are unique
+	uint16_t low = 0;
+	uint16_t high = cmdNameCount;
+	while (low < high) {
+		uint16_t mid = low + ((high - low) / 2);
+		int order = strcmp(cmdNames[mid], cmd->cmdName);
+
+		if (order == 0) {
+			return SHELL_ERR;
+		}
+		if (order < 0) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	memmove(&cmdNames[low + 1], &cmdNames[low], (cmdNameCount - low) * sizeof(cmdNames[0]));
+	memmove(&cmdNameCommands[low + 1], &cmdNameCommands[low], (cmdNameCount - low) * sizeof(cmdNameCommands[0]));
+	cmdNames[low] = cmd->cmdName;
+	cmdNameCommands[low] = NUM_OF_COMMANDS + runtimeCmdCount;
+	cmdNameCount++;
+	if (cmdHashCount != 0) {
+		cmdHashInsert(cmd->cmdName, NUM_OF_COMMANDS + runtimeCmdCount);
+	}
+
+	runtimeCmds[runtimeCmdCount] = cmd;
+	runtimeMandatoryMask[runtimeCmdCount] = mandatoryMask;
+	*commandIndex = NUM_OF_COMMANDS + runtimeCmdCount;
+	runtimeCmdCount++;
 	return SHELL_OK;
 }
 
 /**
   * @brief  Receive and prepares a CLI string
-  * @note	This is called from the CDC_Receive_FS function. It quickly stores the string into the cliHandler structure.
-  * 		The flag is set so that the main program can address the command when ready.
+  * @note	Called from the receive callback of the instance's port (interrupt context). It only
+  * 		pushes the bytes into the receive ring, so packets arriving back to back are never
+  * 		overwritten. Bytes that do not fit are counted in ctx->rxRing.dropped. Text lines of
+  * 		urgent commands are taken out on the way (CLI_SHELL_URGENT.h). While a line runs the
+  * 		next one is parsed ahead (CLI_SHELL_PIPE.h).
+  * @param  ctx Shell instance attached to the port
   * @param  Buf Pointer to the received CLI string
   * @param  Len Pointer to the length of the received string
   * @retval NONE
   */
-void rxShellInput(uint8_t* Buf, uint32_t *Len) {
-	if (Buf[0] != 13){					// Ignore Return Character
-		shellBuffer.rxFlag = true;		/* Set the flag for the parser					*/
-		shellBuffer.rxLen = Len[0];		/* Store the command length for the parser		*/
-
-		// Copy the Received String to the Buffer in the structure
-		memcpy(shellBuffer.rxBuffer, Buf, shellBuffer.rxLen);
+void rxShellInput(shell_ctx_t* ctx, uint8_t* Buf, uint32_t *Len) {
+	// Binary frames may carry 0x03 as data, only text sessions use Ctrl-C
+	if (ctx->mode == SHELL_MODE_TEXT && memchr(Buf, SHELL_ABORT_CHAR, Len[0]) != NULL) {
+		shellAbort(ctx);
 	}
+	if (ctx->mode == SHELL_MODE_TEXT) {
+		shellUrgentReceive(ctx, Buf, Len[0]);
+		shellPipePrefetch(ctx);
+	} else {
+		shellRingWrite(&ctx->rxRing, Buf, Len[0]);
+	}
+	shellEventSignal(SHELL_EVENT_RX);
+}
+
+/**
+  * @brief  Room left in the receive ring of an instance
+  * @note	Safe from the receive callback, the ring only grows from there. A transport with flow
+  * 		control stops taking data when a packet would not fit (see transportRxResume()).
+  * @param  ctx Shell instance
+  * @retval uint32_t Free bytes
+  */
+uint32_t shellRxFree(shell_ctx_t* ctx) {
+	uint32_t free = shellRingFree(&ctx->rxRing);
+	uint32_t held = shellUrgentHeld(ctx);
+
+	// A held line start goes to the ring unless it turns out urgent
+	return (free > held) ? free - held : 0;
+}
+
+/**
+  * @brief  Requests an abort of the running command of an instance
+  * @note	Called from interrupt context (Ctrl-C in rxShellInput, break in CDC_Control_FS).
+  * 		A running job started from this instance is cancelled by its next checkShellStatus(),
+  * 		bridges that run for a long time check shellAbortRequested() themselves.
+  * @param  ctx Shell instance
+  * @retval NONE
+  */
+void shellAbort(shell_ctx_t* ctx) {
+	ctx->abortRequested = true;
+	shellEventSignal(SHELL_EVENT_RX);
+}
+
+/**
+  * @brief  Whether an abort is pending
+  * @note	Cleared at the start of the next checkShellStatus().
+  * @param  ctx Shell instance
+  * @retval bool Returns true if the running command should stop
+  */
+bool shellAbortRequested(shell_ctx_t* ctx) {
+	return ctx->abortRequested;
 }
 
 /**
   * @brief  Checks the receive status, parses, and executes any received command.
-  * @note	This should be called periodically from the main loop.
-  * @param  NONE
+  * @note	This should be called periodically from the main loop, once for every instance. Up to
+  * 		SHELL_MAX_CMDS_PER_POLL commands are assembled and executed per call so the main loop
+  * 		stays responsive and one busy instance cannot starve another.
+  * @param  ctx Shell instance
   * @retval shell_error Error Return Value
   */
-shell_error checkShellStatus(void) {
-	shell_error status;
+shell_error checkShellStatus(shell_ctx_t* ctx) {
+	shell_error status = SHELL_OK;
 
-	if (shellBuffer.rxFlag) {
-		// We received Something - Process it.
-		status = shellProcessCommand();
+	if (!ctx->initialized) {
+		return SHELL_ERR;
+	}
 
-		// Reset the flag after parsing
-		shellBuffer.rxFlag = false;
+	// An abort since the last poll stops the running job, if this instance started it
+	if (ctx->abortRequested) {
+		ctx->abortRequested = false;
+		if (shellJobCtx() == ctx) {
+			shellJobCancel();
+		}
+		shellSchedStop(ctx);
+		shellArmStop(ctx);
+		shellWatchStop(ctx);
+		shellGatewayAbort(ctx);
+	}
+
+	// A backlog of lines runs at full speed (CLI_SHELL_CLOCK.h)
+	shellClockDemand(shellRingUsed(&ctx->rxRing));
+
+	for (uint8_t i = 0; i < SHELL_MAX_CMDS_PER_POLL; i++) {
+		// Urgent lines first, also between the lines of this pass
+		shellUrgentPoll(ctx);
+
+		if (shellJobOwnsInput(ctx)) {
+			// The running job reads the receive ring (e.g. "tput" OUT test)
+			break;
+		}
+
+		if (ctx->mode == SHELL_MODE_BINARY) {
+			// Binary sessions receive framed commands instead of text lines
+			if (!shellBinaryPoll(ctx)) {
+				break;
+			}
+			continue;
+		}
+
+		// The next line may have been parsed ahead while the last one ran (CLI_SHELL_PIPE.h)
+		if (shellPipeReady(ctx)) {
+			ctx->pipe.open = true;
+			ctx->txStalled = false;
+			status = shellPipeRun(ctx);
+		} else if (assembleLine(ctx)) {
+			// We received a full line - Process it. It may wait for transmit room again.
+			ctx->pipe.open = true;
+			ctx->txStalled = false;
+			status = shellProcessLine(ctx);
+		} else {
+			break;
+		}
+		ctx->pipe.open = false;
+
+		// Start the next line
+		ctx->rxLen = 0;
+	}
+
+	// Completions of queued flash operations, before the job that may wait for them
+	shellFlashPoll();
+
+	// Edge timestamps captured by DMA since the last poll
+	shellCapturePoll();
+
+	// Periodic commands marked due by the timer
+	shellSchedPoll(ctx);
+
+	// The fire of an armed command
+	shellArmPoll(ctx);
+
+	// Watched values due for a sample
+	shellWatchPoll(ctx);
+
+	// Answers of the downstream boards, to the ports their lines came from
+	shellGatewayPoll();
+
+	// I2C requests stuck on the bus, notifications of finished ones
+	shellI2cPoll();
+
+	// Advance the long-running command, if this instance started it
+	shellJobPoll(ctx);
+
+	// Benchmark builds run a requested benchmark or regression run here, outside of any command
+	shellBenchmarkPoll(ctx);
+	shellRegressPoll(ctx);
+
+	// Reset for a firmware update once its response is out
+	shellFwUpdatePoll();
+
+	// The lines and jobs above have made room, reception held back for it goes on
+	transportRxResume(ctx);
+
+	// Send every response queued during this poll together
+	outputStreamFlush(ctx);
+
+	// Lines beyond SHELL_MAX_CMDS_PER_POLL or a running job need the next pass right away
+	if (shellRingUsed(&ctx->rxRing) != 0 || shellJobRunning()) {
+		shellEventSignal(SHELL_EVENT_PENDING);
 	}
 	return status;
 }
@@ -523,27 +2182,165 @@ shell_error checkShellStatus(void) {
 /**
   * @brief  Iterates through each command and prints the help descriptions
   * @note	Commands located within CLI_SHELL_COMMANDS.h
-  * @note   The outputStreamChannel is defined in CLI_SHELL.h
+  * @note   The outputStreamChannel is defined in CLI_SHELL.h. Each description is queued on its
+  * 		own once there is room for it, so the memory used does not grow with the table.
+  * 		"help <prefix>" only lists the commands starting with prefix, the node of the prefix
+  * 		in the name trie (see cmdTrieNode_t).
+  * @param[IN]  ctx Shell instance
   * @param[IN]  parserInput	snapshot input from the command line parser
   * @retval shell_error Error Return Value
   */
-shell_error HelpBridge(shellParserOutput_t* parserInput) {
+shell_error HelpBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
 	shell_error status = SHELL_OK;
-	char tmpBuffer[500] = {0};
+	SHELL_STR_DEFINE(str, 100);
+	cmdTrieNode_t node = { 0, cmdNameCount, 0 };
 
 	// Print the Header
-	sprintf(tmpBuffer, "<-- Shell Debug Kernel -->\r\n" \
-					   "<-- Rev: %02d.%02d.%02d      -->\r\n" \
-					   "Command\t| Description\t\t| Arguments\r\n\r\n", SHELL_MAJOR_VER, SHELL_MINOR_VER, SHELL_REV);
+	shellStrAppend(&str, "<-- Shell Debug Kernel -->\r\n<-- Rev: ");
+	shellStrAppendUnsigned(&str, SHELL_MAJOR_VER, 2);
+	shellStrAppendChar(&str, '.');
+	shellStrAppendUnsigned(&str, SHELL_MINOR_VER, 2);
+	shellStrAppendChar(&str, '.');
+	shellStrAppendUnsigned(&str, SHELL_REV, 2);
+	shellStrAppend(&str, "      -->\r\nCommand\t| Description\t\t| Arguments\r\n\r\n");
+	shellStrSend(ctx, &str);
+
+	if (parserInput->numArgs > 0) {
+		// The filter is the whole first word, including the character the parser took as a token
+		const uint8_t* prefix = &parserInput->line[parserInput->cmdArgs[0].argOffset - 1];
+
+		if (!cmdTrieWalk(&node, prefix, UINT32_MAX)) {
+			return status;
+		}
+	}
+
+	// Stream every matching help line
+	for (uint16_t i = node.first; i < node.last; i++) {
+		const char* helpDesc = shellCommandTemplate(cmdNameCommands[i])->helpDesc;
+		uint16_t descLen = strlen(helpDesc);
+		if (!shellOutputReserve(ctx, descLen)) {
+			// The host stopped reading
+			return SHELL_ERR;
+		}
+		outputStreamChannel(ctx, (const uint8_t*)helpDesc, descLen);
+	}
 
-	// Step through each command, adding help text to the buffer
-	for (uint8_t i = 0; i < NUM_OF_COMMANDS; i++) {
-		strcat((char*)tmpBuffer, shellCmdTemplateTable[i].helpDesc);
+	return status;
+}
+
+/**
+  * @brief  Switches the session between text and binary mode
+  * @note	The switch happens once the "OK" for this command has been sent, so the host
+  * 		receives the reply in the mode it used to send the command. Compression applies to
+  * 		binary sessions only and is off unless z1 comes with the mode (CLI_SHELL_LZ.h).
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (m - 0 text, 1 binary, z - 1 compress)
+  * @retval shell_error Error Return Value
+  */
+shell_error ModeBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint8_t mode = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_m)).u8;
+	bool compress = false;
+
+	if (mode != SHELL_MODE_TEXT && mode != SHELL_MODE_BINARY) {
+		return SHELL_ERR;
+	}
+	if (shellHasArg(parserInput, argTkn_z)) {
+		compress = (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_z)).u8 != 0);
 	}
 
-	// Find the length of the string and send it.
-	uint16_t bufLen = strlen((const char*)tmpBuffer);
-	outputStreamChannel((uint8_t*)tmpBuffer, bufLen);
+	ctx->pendingMode = (shellMode_t)mode;
+	ctx->binary.compress = compress && mode == SHELL_MODE_BINARY;
+	shellSessionSave(ctx);
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Dumps the per-command cycle statistics
+  * @note	One line per command that has run: count, min/max/mean cycles from parse to bridge
+  * 		return, the mean of each stage, then the deadline overruns ("-" without a deadline). The "perf" run itself is still in progress and
+  * 		only shows up in the next dump. The last lines are the static block pool usage, the
+  * 		lines parsed ahead by the pipeline and the USB frame statistics (frames, frames with IN data, packets per busy frame, NAK frames).
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (r - 1 resets after the dump)
+  * @retval shell_error Error Return Value
+  */
+shell_error PerfBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	shell_error status = SHELL_OK;
+	SHELL_STR_DEFINE(str, 120);
+	bool reset = false;
+
+	if (shellHasArg(parserInput, argTkn_r)) {
+		reset = (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0);
+	}
+
+	shellStrAppend(&str, "Cycles @ ");
+	shellStrAppendUnsigned(&str, SystemCoreClock, 0);
+	shellStrAppend(&str, " Hz\r\nCommand\t| Count\t| Min\t| Max\t| Mean\t| Parse\t| Match\t| Valid\t| Bridge\t| Over\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint16_t i = 0; i < NUM_OF_COMMANDS + runtimeCmdCount; i++) {
+		shellPerfStat_t* stat = &cmdPerfStats[i];
+		if (stat->count == 0) {
+			continue;
+		}
+
+		const uint32_t columns[] = {
+			stat->count,
+			stat->minCycles,
+			stat->maxCycles,
+			(uint32_t)(stat->totalCycles / stat->count),
+			(uint32_t)(stat->stageCycles[perfStage_parse] / stat->count),
+			(uint32_t)(stat->stageCycles[perfStage_match] / stat->count),
+			(uint32_t)(stat->stageCycles[perfStage_validate] / stat->count),
+			(uint32_t)(stat->stageCycles[perfStage_bridge] / stat->count)
+		};
+
+		shellStrAppend(&str, shellCommandName(i));
+		for (uint8_t c = 0; c < sizeof(columns) / sizeof(columns[0]); c++) {
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, columns[c], 0);
+		}
+		shellStrAppend(&str, "\t| ");
+		if (i < NUM_OF_COMMANDS && shellDeadlineTable[i] != 0) {
+			shellStrAppendUnsigned(&str, stat->overruns, 0);
+		} else {
+			shellStrAppendChar(&str, '-');
+		}
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	shellStrAppend(&str, "Pool: ");
+	shellStrAppendUnsigned(&str, shellPoolInUse(), 0);
+	shellStrAppendChar(&str, '/');
+	shellStrAppendUnsigned(&str, SHELL_POOL_BLOCKS, 0);
+	shellStrAppend(&str, " blocks of ");
+	shellStrAppendUnsigned(&str, SHELL_POOL_BLOCK_SIZE, 0);
+	shellStrAppend(&str, " bytes, peak ");
+	shellStrAppendUnsigned(&str, shellPoolHighWater(), 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	shellPipeReport(ctx);
+
+	const CDC_FrameStats_t* frames = transportFrameStats();
+	shellStrAppend(&str, "USB: ");
+	shellStrAppendUnsigned(&str, frames->frames, 0);
+	shellStrAppend(&str, " frames, ");
+	shellStrAppendUnsigned(&str, frames->busyFrames, 0);
+	shellStrAppend(&str, " busy, ");
+	shellStrAppendUnsigned(&str, frames->inPackets, 0);
+	shellStrAppend(&str, " packets (max ");
+	shellStrAppendUnsigned(&str, frames->maxPacketsPerFrame, 0);
+	shellStrAppend(&str, "/frame), ");
+	shellStrAppendUnsigned(&str, frames->nakFrames, 0);
+	shellStrAppend(&str, " NAK frames\r\n");
+	shellStrSend(ctx, &str);
+
+	if (reset) {
+		shellPerfClear();
+		shellPipeClear();
+		transportFrameStatsClear();
+	}
 
 	return status;
 }
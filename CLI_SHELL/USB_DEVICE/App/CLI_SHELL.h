@@ -8,6 +8,110 @@
  * - 1.1: 5-19-2020 (Crandell)
  * 		Added an extra response code to handle feedback from the function pointer -- "RESPONSE_FNC_ERR"
  * 		Updated Shell Version to 1.1.0
+ * - 1.2: 10-14-2026 (Crandell)
+ * 		Parser output stores (offset, length) slices into the line buffer. Use shellCmdName() and
+ * 		shellArgContents() to read them. Updated Shell Version to 1.2.0
+ * - 1.3: 10-14-2026 (Crandell) Binary search command lookup. Updated Shell Version to 1.3.0
+ * - 1.4: 10-14-2026 (Crandell) Received data goes through a lock-free ring. Updated Shell Version to 1.4.0
+ * - 1.5: 10-14-2026 (Crandell) Line assembler with configurable terminators. Updated Shell Version to 1.5.0
+ * - 1.6: 10-14-2026 (Crandell) Output is queued (CDC_Write_FS) and flushed once per poll. Updated Shell Version to 1.6.0
+ * - 1.7: 10-14-2026 (Crandell) Binary session mode and the "mode" command. Updated Shell Version to 1.7.0
+ * - 1.8: 10-14-2026 (Crandell) Command batches. Line buffer raised to 200. Updated Shell Version to 1.8.0
+ * - 1.9: 10-14-2026 (Crandell) Per-command cycle profiling and "perf". Updated Shell Version to 1.9.0
+ * - 1.10: 10-14-2026 (Crandell) "bench" command for the Benchmark configuration. Updated Shell Version to 1.10.0
+ * - 1.11: 10-14-2026 (Crandell)
+ * 		Arguments carry their converted value (argType/argValue, read with shellArgValue()).
+ * 		Updated Shell Version to 1.11.0
+ * - 1.12: 10-14-2026 (Crandell) Hex/binary/float arguments, out of range values rejected. Updated Shell Version to 1.12.0
+ * - 1.13: 10-14-2026 (Crandell) Token index and mask (shellFindArg/shellHasArg). Updated Shell Version to 1.13.0
+ * - 1.14: 10-14-2026 (Crandell) Command table generated from X-macro lists. Updated Shell Version to 1.14.0
+ * - 1.15: 10-14-2026 (Crandell) Const command table with per-command argument lists. Updated Shell Version to 1.15.0
+ * - 1.16: 10-14-2026 (Crandell) Streamed help, "help <prefix>", shellOutputReserve(). Updated Shell Version to 1.16.0
+ * - 1.17: 10-14-2026 (Crandell) Static block pool replaces malloc for USBD class data. Updated Shell Version to 1.17.0
+ * - 1.18: 10-14-2026 (Crandell) Long-running commands (SHELL_BUSY jobs), "cancel" and "sleep". Updated Shell Version to 1.18.0
+ * - 1.19: 10-14-2026 (Crandell) Ctrl-C / break abort (shellAbort, shellAbortRequested). Updated Shell Version to 1.19.0
+ * - 1.20: 10-14-2026 (Crandell) "stream" telemetry over the transport stream queue. Updated Shell Version to 1.20.0
+ * - 1.21: 10-14-2026 (Crandell) "clock" profiles (96 MHz performance default). Updated Shell Version to 1.21.0
+ * - 1.22: 10-14-2026 (Crandell) Flash accelerator setup and "art". Updated Shell Version to 1.22.0
+ * - 1.23: 10-14-2026 (Crandell) Line assembly, tokenizer and lookup run from RAM. Updated Shell Version to 1.23.0
+ * - 1.24: 10-14-2026 (Crandell) USB FIFO layout for the CDC endpoints and "tput". Updated Shell Version to 1.24.0
+ * - 1.25: 10-14-2026 (Crandell) USB frame statistics in "perf". Updated Shell Version to 1.25.0
+ * - 1.26: 10-14-2026 (Crandell)
+ * 		One shell per transport port (shellPorts, SHELL_NUM_PORTS). rxShellInput() and shellAbort()
+ * 		take the port, shellBuffer points at the port being served. Updated Shell Version to 1.26.0
+ * - 1.27: 10-14-2026 (Crandell)
+ * 		Shell instances (shell_ctx_t, SHELL_CTX_DEFINE). shellInit, rxShellInput, checkShellStatus,
+ * 		the bridges and outputStreamChannel() take the instance. Updated Shell Version to 1.27.0
+ * - 1.28: 10-14-2026 (Crandell)
+ * 		Pluggable transports (shellTransport_t). shellInit() takes the transport of the instance,
+ * 		CDC_Transport_FS (USB) or shellUartTransport (USART DMA, CLI_SHELL_UART.h). outputStreamFlush()
+ * 		takes the instance. Updated Shell Version to 1.28.0
+ * - 1.29: 10-14-2026 (Crandell) "mrd"/"mwr" memory access (CLI_SHELL_MEM). Updated Shell Version to 1.29.0
+ * - 1.30: 10-14-2026 (Crandell)
+ * 		"macro" recorded command sequences in flash (CLI_SHELL_MACRO). Parser output carries a validated
+ * 		flag, shellCommandTableId(). Updated Shell Version to 1.30.0
+ * - 1.31: 10-14-2026 (Crandell) "get"/"set" persistent settings (CLI_SHELL_KV). Updated Shell Version to 1.31.0
+ * - 1.32: 10-14-2026 (Crandell) Interrupt driven flash queue and "flash". Updated Shell Version to 1.32.0
+ * - 1.33: 10-14-2026 (Crandell)
+ * 		"every" periodic commands (CLI_SHELL_SCHED), shellResolveCommand(). Parser output carries a
+ * 		periodic flag. Updated Shell Version to 1.33.0
+ * - 1.34: 10-14-2026 (Crandell) "capture" TIM5 input capture by DMA (CLI_SHELL_CAPTURE). Updated Shell Version to 1.34.0
+ * - 1.35: 10-14-2026 (Crandell) "pattern" GPIOB pattern output by DMA (CLI_SHELL_PATTERN). Updated Shell Version to 1.35.0
+ * - 1.36: 10-14-2026 (Crandell) shellStr_t bounded response builder. Updated Shell Version to 1.36.0
+ * - 1.37: 10-14-2026 (Crandell) Command name trie: unique prefixes and tab completion. Updated Shell Version to 1.37.0
+ * - 1.38: 10-14-2026 (Crandell) "idle" command, WFI main loop (CLI_SHELL_EVENT). Updated Shell Version to 1.38.0
+ * - 1.39: 10-14-2026 (Crandell) "mem" command, stack painting at startup. Updated Shell Version to 1.39.0
+ * - 1.40: 10-14-2026 (Crandell) "trace" command, binary event trace ring (CLI_SHELL_TRACE). Updated Shell Version to 1.40.0
+ * - 1.41: 10-14-2026 (Crandell) "itm" command, SWO debug output (CLI_SHELL_ITM). Updated Shell Version to 1.41.0
+ * - 1.42: 10-14-2026 (Crandell) "usbstat" command, USB link health counters (transportLinkStats). Updated Shell Version to 1.42.0
+ * - 1.43: 10-14-2026 (Crandell) "isr" command, interrupt latency and duration profiler (CLI_SHELL_ISR). Updated Shell Version to 1.43.0
+ * - 1.44: 10-14-2026 (Crandell) Host build of the core (SHELL_HOST_BUILD, CLI_SHELL_HOST.h). Updated Shell Version to 1.44.0
+ * - 1.45: 10-14-2026 (Crandell) "boot" command, boot stage times and SHELL_FAST_BOOT (CLI_SHELL_BOOT). Updated Shell Version to 1.45.0
+ * - 1.46: 10-14-2026 (Crandell) Receive rings and trace ring in .noinit (SHELL_NOINIT). Updated Shell Version to 1.46.0
+ * - 1.47: 10-14-2026 (Crandell) "crash" command, fault handlers with a post-mortem record (CLI_SHELL_CRASH). Updated Shell Version to 1.47.0
+ * - 1.48: 10-14-2026 (Crandell) Request tags "#<n> <line>" echoed in the response (ctx->tag). Updated Shell Version to 1.48.0
+ * - 1.49: 10-14-2026 (Crandell) CRC32 service on the CRC unit with DMA (CLI_SHELL_CRC), "crc" command. Updated Shell Version to 1.49.0
+ * - 1.50: 10-14-2026 (Crandell) Structured results, text or CBOR by session mode (CLI_SHELL_RESULT). Updated Shell Version to 1.50.0
+ * - 1.51: 10-14-2026 (Crandell) "watch" command, sampled values sent as deltas (CLI_SHELL_WATCH). Updated Shell Version to 1.51.0
+ * - 1.52: 10-15-2026 (Crandell) Compressed binary responses, "mode m1 z1" (CLI_SHELL_LZ). Updated Shell Version to 1.52.0
+ * - 1.53: 10-15-2026 (Crandell) Receive flow control, transportRxResume() and shellRxFree(). Updated Shell Version to 1.53.0
+ * - 1.54: 10-15-2026 (Crandell) Urgent lane for safety commands (CLI_SHELL_URGENT). Updated Shell Version to 1.54.0
+ * - 1.55: 10-15-2026 (Crandell) Response cache for cacheable queries (CLI_SHELL_CACHE). Updated Shell Version to 1.55.0
+ * - 1.56: 10-15-2026 (Crandell) Array arguments (arg_u8_array, ...) read with shellArgArray(). Argument
+ * 		lengths are checked per type by the validation. Updated Shell Version to 1.56.0
+ * - 1.57: 10-15-2026 (Crandell) Line, ring and queue sizes come from a sizing profile (CLI_SHELL_CONFIG.h).
+ * 		SHELL_CMD_LEN bounds the command names only. Updated Shell Version to 1.57.0
+ * - 1.58: 10-15-2026 (Crandell) Optional FreeRTOS shell task (CLI_SHELL_RTOS). Updated Shell Version to 1.58.0
+ * - 1.59: 10-15-2026 (Crandell) Optional PendSV command processing (CLI_SHELL_DEFER). Updated Shell Version to 1.59.0
+ * - 1.60: 10-15-2026 (Crandell) Event notifications on the CDC interrupt endpoint (CLI_SHELL_NOTIFY). Updated Shell Version to 1.60.0
+ * - 1.61: 10-15-2026 (Crandell) "ping" command. Updated Shell Version to 1.61.0
+ * - 1.62: 10-15-2026 (Crandell) Zero-copy output, shellOutputAcquire()/shellOutputCommit(). Updated Shell Version to 1.62.0
+ * - 1.63: 10-15-2026 (Crandell) Gateway to downstream boards (CLI_SHELL_GATEWAY). Updated Shell Version to 1.63.0
+ * - 1.64: 10-15-2026 (Crandell) Firmware update and boot stub (CLI_SHELL_FWUPDATE). Updated Shell Version to 1.64.0
+ * - 1.65: 10-15-2026 (Crandell) ADC acquisition (CLI_SHELL_ADC). Updated Shell Version to 1.65.0
+ * - 1.66: 10-15-2026 (Crandell) SPI transaction engine (CLI_SHELL_SPI). Updated Shell Version to 1.66.0
+ * - 1.67: 10-15-2026 (Crandell) I2C request queue (CLI_SHELL_I2C). Updated Shell Version to 1.67.0
+ * - 1.68: 10-15-2026 (Crandell) Script VM (CLI_SHELL_VM). Updated Shell Version to 1.68.0
+ * - 1.69: 10-15-2026 (Crandell) Shell variables (CLI_SHELL_VAR). Updated Shell Version to 1.69.0
+ * - 1.70: 10-15-2026 (Crandell) MPU stack and buffer guards (CLI_SHELL_MPU). Updated Shell Version to 1.70.0
+ * - 1.71: 10-15-2026 (Crandell) "load" CPU load and main loop timing (CLI_SHELL_LOAD). Updated Shell Version to 1.71.0
+ * - 1.72: 10-15-2026 (Crandell) "gpio" port-wide masks, snapshots and batches (CLI_SHELL_GPIO). Updated Shell Version to 1.72.0
+ * - 1.73: 10-15-2026 (Crandell) "events" EXTI edge logger with timestamped ring (CLI_SHELL_EXTI). Updated Shell Version to 1.73.0
+ * - 1.74: 10-15-2026 (Crandell) "regress" recorded-command regression suite with cycle budgets (CLI_SHELL_REGRESS). Updated Shell Version to 1.74.0
+ * - 1.75: 10-15-2026 (Crandell) Bridge deadlines (SHELL_DEADLINE_LIST), overruns in "perf" and the trace. Updated Shell Version to 1.75.0
+ * - 1.76: 10-15-2026 (Crandell) Command modules from the module flash region, shellRegisterCommand() (CLI_SHELL_MODULE). Updated Shell Version to 1.76.0
+ * - 1.77: 10-15-2026 (Crandell) Command history with resolved replay ("!!", "!n") and arrow recall (CLI_SHELL_HISTORY). Updated Shell Version to 1.77.0
+ * - 1.78: 10-15-2026 (Crandell) Line editor with coalesced local echo, "term" (CLI_SHELL_EDIT). Updated Shell Version to 1.78.0
+ * - 1.79: 10-15-2026 (Crandell) Command pipeline, the next line is parsed ahead in the receive interrupt (CLI_SHELL_PIPE). Updated Shell Version to 1.79.0
+ * - 1.80: 10-15-2026 (Crandell) One generated validator per command (SHELL_GEN_VALIDATOR). Updated Shell Version to 1.80.0
+ * - 1.81: 10-15-2026 (Crandell) "tsync" clock locked to the USB frames (CLI_SHELL_TSYNC). Updated Shell Version to 1.81.0
+ * - 1.82: 10-15-2026 (Crandell) "arm" commands run from the edge of a shared trigger line (CLI_SHELL_ARM). Updated Shell Version to 1.82.0
+ * - 1.83: 10-15-2026 (Crandell) DMA2 copy service for raw dumps and firmware staging (CLI_SHELL_COPY). Updated Shell Version to 1.83.0
+ * - 1.84: 10-15-2026 (Crandell) Session settings restored after a soft reset, "session" command (CLI_SHELL_SESSION). Updated Shell Version to 1.84.0
+ * - 1.85: 10-15-2026 (Crandell) Command names packed into one pool (SHELL_GEN_NAME_FIELD), name and hash index as parallel arrays. Updated Shell Version to 1.85.0
+ * - 1.86: 10-15-2026 (Crandell) "loopback", "sink" and "source" benchmark commands (CLI_SHELL_TPUT). Updated Shell Version to 1.86.0
+ * - 1.87: 10-15-2026 (Crandell) Responses wait for transmit room (shellOutputReserve) before they are written. Updated Shell Version to 1.87.0
+ * - 1.88: 10-15-2026 (Crandell) shellOutputReserve() waits once per stall, not per write (txStalled). Updated Shell Version to 1.88.0
  *
  * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
  */
@@ -22,7 +126,18 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_CONFIG.h"
+#if !SHELL_HOST_BUILD
 #include "usbd_cdc_if.h"
+#endif
+#include "CLI_SHELL_RING.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_URGENT.h"
+#include "CLI_SHELL_HISTORY.h"
+#include "CLI_SHELL_EDIT.h"
+#include "CLI_SHELL_PIPE.h"
 
 /********************************************************************************
  * DEFINES
@@ -32,7 +147,7 @@
   */
 
 #define SHELL_MAJOR_VER			1
-#define SHELL_MINOR_VER			1
+#define SHELL_MINOR_VER			88
 #define SHELL_REV				0
 
 /**
@@ -40,27 +155,160 @@
   */
 
 #define MAX_ARGUMENTS			5
-#define SHELL_BUFFER_LEN		100					/*!< Alloted Buffer Length				*/
+/* Line, name, argument, ring and queue sizes: CLI_SHELL_CONFIG.h */
 
-#define SHELL_CMD_LEN			SHELL_BUFFER_LEN	/*!< Alloted Command Length				*/
-#define SHELL_ARG_LEN			20					/*!< Alloted Argument Length			*/
+/**
+  * @brief  Defines a shell instance with a receive ring of rxRingLen bytes (power of two).
+  * @note	One instance per transport port. With the composite USB device these are the CDC ACM
+  * 		operator port (CDC_CH_OPERATOR) and the vendor bulk automation port (CDC_CH_AUTOMATION),
+  * 		see usbd_composite.h. Pass the instance to shellInit() with its transport and port, then
+  * 		to checkShellStatus() from the main loop. The ring storage is not zeroed at reset
+  * 		(SHELL_NOINIT), only the ring indices are.
+  */
+#define SHELL_CTX_DEFINE(name, rxRingLen) \
+		_Static_assert((rxRingLen) != 0 && ((rxRingLen) & ((rxRingLen) - 1)) == 0, \
+				"Receive ring of " #name " must be a power of two"); \
+		SHELL_NOINIT static uint8_t name##RxStorage[(rxRingLen)]; \
+		static shell_ctx_t name = { .rxRing = SHELL_RING_STATIC_INIT(name##RxStorage) }
+
+/**
+  * @brief  Line Terminators. SHELL_LINE_TERMINATORS selects which characters complete a command.
+  * @note	With both enabled, CRLF counts as a single terminator.
+  */
+#define SHELL_TERM_CR			0x01				/*!< '\r' ends a line					*/
+#define SHELL_TERM_LF			0x02				/*!< '\n' ends a line					*/
+
+#ifndef SHELL_LINE_TERMINATORS
+#define SHELL_LINE_TERMINATORS	(SHELL_TERM_CR | SHELL_TERM_LF)
+#endif
+
+/**
+  * @brief  Batch Syntax. "{ cmd1 ; cmd2 ; ... }" runs every command and returns one response.
+  */
+#define SHELL_BATCH_OPEN		'{'
+#define SHELL_BATCH_CLOSE		'}'
+#define SHELL_BATCH_SEPARATOR	';'
+
+/**
+  * @brief  Request Tags. "#42 setLed l1 s1" is answered "#42 -->OK!". The tag goes in front of the
+  * 		response line only (bridge output is not tagged), a job answers with the tag of the line
+  * 		that started it, so a host can keep several lines in flight and match the answers.
+  */
+#define SHELL_TAG_CHAR			'#'
+#define SHELL_TAG_DIGITS		9					/*!< Longest tag, 0 to 999999999			*/
+#define SHELL_NO_TAG			(-1)				/*!< Line without a tag						*/
+
+/**
+  * @brief  Command name lookup. With SHELL_PREFIX_MATCH a unique prefix runs its command ("cap" is
+  * 		"capture"), an exact name always wins. SHELL_COMPLETE_CHAR completes the command word
+  * 		of a text line as far as it is unique and lists the candidates where it is not.
+  */
+#ifndef SHELL_PREFIX_MATCH
+#define SHELL_PREFIX_MATCH		1
+#endif
+#define SHELL_COMPLETE_CHAR		'\t'
+#define SHELL_COMPLETE_BELL		'\a'				/*!< Sent when nothing matches			*/
+
+/**
+  * @brief  Ctrl-C. In text mode it aborts the running command and discards the partial line.
+  */
+#define SHELL_ABORT_CHAR		0x03
+
+/**
+  * @brief  The transport used by a shell instance (ctx->transport, see shellTransport_t).
+  * 		It must accept writes without blocking.
+  * @note	CDC_Transport_FS (usbd_cdc_if.c) copies into the transmit queue of the instance's USB
+  * 		port, shellUartTransport (CLI_SHELL_UART.c) into the USART DMA queue. transportFlush()
+  * 		starts sending whatever has been queued on the transport. transportAttach() routes the
+  * 		port's input to the instance.
+  */
+#define transportAttach(ctx)						(ctx)->transport->attach((ctx)->port, (ctx))
+#define transportWrite(ctx, buffer, length)			(ctx)->transport->write((ctx)->port, buffer, length)
+#define transportFlush(ctx)							(ctx)->transport->flush()
+#define transportFree(ctx)							(ctx)->transport->txFree((ctx)->port)
+
+/**
+  * @brief  Receive flow control. A transport that can hold the sender back stops taking data while
+  * 		the receive ring has no room for more (the USB OUT endpoints NAK, the host waits), so
+  * 		input is never dropped however fast the host sends. checkShellStatus() calls
+  * 		transportRxResume() after reading the ring, the transport goes on once there is room.
+  * @note	The USART has no handshake lines here, it still drops what does not fit (rxRing.dropped).
+  */
+#define transportRxResume(ctx)						((ctx)->transport->rxResume != NULL ? \
+													 (ctx)->transport->rxResume((ctx)->port) : (void)0)
 
 /**
-  * @brief  When outputStreamChannel() is called within CLI_SHELL.c, it will funnel
+  * @brief  Telemetry path of the transport (CLI_SHELL_STREAM.c). Records are queued whole or not
+  * 		at all and sent in full packets whenever no shell output is waiting. There is one stream
+  * 		queue, transportStreamAttach() moves it to the instance's port once it has drained.
+  * @note	Only the USB transport has a stream queue. transportStreamAttach() fails on the others.
+  */
+#define transportStreamAttach(ctx)					((ctx)->transport->streamAttach != NULL && \
+													 (ctx)->transport->streamAttach((ctx)->port))
+#define transportStreamWrite(buffer, length)		CDC_StreamWrite_FS(buffer, length)
+#define transportStreamFree()						CDC_StreamFree_FS()
+#define transportStreamUsed()						CDC_StreamUsed_FS()
+
+/**
+  * @brief  Notification channel of the transport (CLI_SHELL_NOTIFY.c): a short event record sent
+  * 		apart from the responses. The USB transport uses the CDC interrupt endpoint, the
+  * 		others have none and transportNotify() fails.
+  */
+#define transportNotify(ctx, event, value)			((ctx)->transport->notify != NULL && \
+													 (ctx)->transport->notify((ctx)->port, event, value))
+
+/**
+  * @brief  Zero-copy output (shellOutputAcquire()). A transport whose transmit queue is a byte ring
+  * 		hands out its contiguous free block, the bridge formats straight into it and
+  * 		transportTxCommit() publishes the bytes. transportTxSpan() is 0 on the others.
+  */
+#define transportTxSpan(ctx, data)					((ctx)->transport->txSpan != NULL ? \
+													 (ctx)->transport->txSpan((ctx)->port, data) : 0U)
+#define transportTxCommit(ctx, length)				(ctx)->transport->txCommit((ctx)->port, length)
+
+/**
+  * @brief  Link statistics of the transport, counted per USB frame (see USBD_SOF_TX_FLUSH in usbd_conf.h)
+  */
+#define transportFrameStats()						CDC_FrameStats_FS()
+#define transportFrameStatsClear()					CDC_FrameStatsClear_FS()
+
+/**
+  * @brief  Link health counters of the transport: transfers, drops, bus events, interrupt time
+  */
+#define transportLinkStats(stats)					CDC_LinkStats_FS(stats)
+#define transportLinkStatsClear()					CDC_LinkStatsClear_FS()
+
+/**
+  * @brief  shellOutputReserve() gives up after SHELL_TX_WAIT_MS without room (host not reading).
+  * 		It then fails at once until there is room again or the next command starts.
+  */
+#define SHELL_TX_WAIT_MS				100
+#define SHELL_TX_RESERVE_MARGIN			16
+
+/**
+  * @brief  shellOutputAcquire() falls back to a staging buffer of this size where it cannot hand
+  * 		out the transmit queue itself (binary session, muted output, the free block wraps).
+  */
+#define SHELL_OUTPUT_STAGE_LEN			128
+
+/**
+  * @brief  When outputStreamChannel() is called within CLI_SHELL.c or a bridge, it will funnel
   * 		through whatever is defined here
-  * @note	This is set up as a USB CDC Interface, so CDC_Transmit_FS will be used.
+  * @note	shellOutputWrite() formats the output for the session mode (text or binary frames).
   */
-#define outputStreamChannel(buffer, length)			CDC_Transmit_FS(buffer, length)
+#define outputStreamChannel(ctx, buffer, length)	shellOutputWrite(ctx, buffer, length)
+#define outputStreamFlush(ctx)						transportFlush(ctx)
 
 /********************************************************************************
  * TYPES
  *******************************************************************************/
 // These are only here to accommodate the type references for the below function pointer.
+typedef struct shellCtxTypeDef shell_ctx_t;
 typedef struct shellParserOutputTypeDef	shellParserOutput_t;
 typedef enum shellErrorTypeDef shell_error;
 
-// Function Pointer for the function to run for each command.
-typedef shell_error(*shellBridge_t)(shellParserOutput_t*);
+// Function Pointer for the function to run for each command. It gets the instance the command came from.
+typedef shell_error(*shellBridge_t)(shell_ctx_t*, shellParserOutput_t*);
 
 /**
   * @brief  Argument Tokens. Used to differentiate different arguments within a received command string.
@@ -106,6 +354,10 @@ typedef enum {
 	arg_string,
 	arg_float,
 	arg_flag,
+	arg_none,								/*!< Not converted (no template entry)		*/
+	arg_u8_array,							/*!< "v1,2,3", raw: elements back to back	*/
+	arg_u16_array,
+	arg_u32_array,
 } argType_t;
 
 /**
@@ -115,87 +367,378 @@ typedef enum {
 	RESPONSE_OK,				/*!< Respond OK			*/
 	RESPONSE_FNC_ERR,			/*!< Function Error		*/
 	RESPONSE_CMD_ERR,			/*!< Command Error		*/
-	RESPONSE_ARG_ERR			/*!< Argument Error		*/
+	RESPONSE_ARG_ERR,			/*!< Argument Error		*/
+	RESPONSE_LEN_ERR,			/*!< Line Too Long		*/
+	RESPONSE_FRAME_ERR,			/*!< Bad Binary Frame	*/
+	RESPONSE_CANCELLED			/*!< Job Cancelled		*/
 } responseCode_t;
 
+/**
+  * @brief  Session modes. Switched at runtime with the "mode" command.
+  */
+typedef enum {
+	SHELL_MODE_TEXT = 0,		/*!< ASCII command lines	*/
+	SHELL_MODE_BINARY = 1		/*!< Framed binary commands (CLI_SHELL_BINARY.h)	*/
+} shellMode_t;
+
 /*------------------------------ PARSER STRUCTURES ------------------------------------*/
 
+/**
+  * @brief  Converted argument value. Which member is valid is given by shellArgument_t.argType.
+  */
+typedef union {
+	uint8_t u8;								/*!< arg_uint8								*/
+	uint16_t u16;							/*!< arg_uint16								*/
+	uint32_t u32;							/*!< arg_uint32								*/
+	char c;									/*!< arg_char								*/
+	const char* str;						/*!< arg_string (the NUL-terminated contents)	*/
+	float f;								/*!< arg_float								*/
+	bool flag;								/*!< arg_flag (true when present)			*/
+	uint8_t count;							/*!< arg_*_array, elements (read with shellArgArray())	*/
+} argValue_t;
+
 /**
   * @brief  Stores one argument from the parser.
+  * @note	The contents are a slice of the parser line, NUL-terminated in place. Validation
+  * 		converts every argument listed in the command template once and stores the result
+  * 		in argValue, so bridges never need to parse the contents again.
   */
 typedef struct {
-	uint8_t argContents[SHELL_ARG_LEN];		/*!< Pointer to the argument content string	*/
+	uint8_t argOffset;						/*!< Offset of the contents within the line	*/
+	uint8_t argLen;							/*!< Length of the argument contents		*/
 	argToken_t argToken;					/*!< Argument Token							*/
+
+	argType_t argType;						/*!< Type of argValue (arg_none until validated)	*/
+	argValue_t argValue;					/*!< Converted value						*/
 } shellArgument_t;
 
 /**
   * @brief  Stores the output from the parser. Contains the command name and all arguments.
   */
 typedef struct shellParserOutputTypeDef {
-	uint8_t cmdName[SHELL_CMD_LEN];			/*!< Command Name							*/
+	uint8_t* line;							/*!< Line buffer the slices refer to		*/
+
+	uint8_t cmdOffset;						/*!< Offset of the Command Name				*/
+	uint8_t cmdLen;							/*!< Length of the Command Name				*/
 
 	uint8_t numArgs;						/*!< Number of Arguments					*/
 	shellArgument_t cmdArgs[MAX_ARGUMENTS];
 
+	uint32_t argMask;						/*!< Bit n set when token n is present		*/
+	uint8_t argSlot[argTkn_err];			/*!< Token -> index in cmdArgs (SHELL_ARG_NONE if absent)	*/
+
+	bool rawValues;							/*!< Contents are little-endian binary values (binary frames)	*/
+	bool validated;							/*!< Arguments already converted (macro replay)	*/
+	bool periodic;							/*!< Run by the scheduler, not recorded		*/
+
 } shellParserOutput_t;
 
+/**
+  * @brief  Accessors for the parser output slices. Both return a NUL-terminated string.
+  */
+#define shellCmdName(parserOut)				(&(parserOut)->line[(parserOut)->cmdOffset])
+#define shellArgContents(parserOut, index)	(&(parserOut)->line[(parserOut)->cmdArgs[(index)].argOffset])
+
+/**
+  * @brief  Accessor for the converted value of an argument, e.g. shellArgValue(p, i).u8
+  * @note	Arrays give their element count here, shellArgArray() copies the elements.
+  */
+#define shellArgValue(parserOut, index)		((parserOut)->cmdArgs[(index)].argValue)
+
+/**
+  * @brief  Token lookups. shellFindArg() returns the cmdArgs index of a token or SHELL_ARG_NONE.
+  */
+#define SHELL_ARG_NONE						0xFF
+#define shellTokenBit(token)				(1UL << (token))
+#define shellHasArg(parserOut, token)		(((parserOut)->argMask & shellTokenBit(token)) != 0)
+#define shellFindArg(parserOut, token)		((parserOut)->argSlot[(token)])
+
 
 /*--------------------- COMMAND/ARGUMENT TEMPLATE STRUCTURES --------------------------*/
 
 /**
   * @brief  Template for the Argument Structure. This is used within CLI_SHELL_COMMANDS.h
   * 		and it defines the argument structure.
+  * @note	Packed into bytes (argToken_t/argType_t values) so each argument costs 3 bytes of flash.
   */
 typedef struct {
-	bool mandatory;							/*!< Mandatory Flag							*/
-	argType_t type;							/*!< Argument Data Type						*/
-	argToken_t token;						/*!< Token to Use							*/
+	uint8_t mandatory;						/*!< Mandatory Flag							*/
+	uint8_t type;							/*!< Argument Data Type (argType_t)			*/
+	uint8_t token;							/*!< Token to Use (argToken_t)				*/
 } shellArgTemplate_t;
 
 /**
   * @brief  Template for the Command Structure. This is used within CLI_SHELL_COMMANDS.h
   * 		and it defines the command structure.
+  * @note	The table and the argument lists are const and live in flash. Each command only
+  * 		points at an argument list of its own length. Commands registered at runtime
+  * 		(shellRegisterCommand()) use the same template, in flash of their own.
   */
-typedef struct {
-	char* cmdName;							/*!< Pointer to the Command Name			*/
-	char* helpDesc;							/*!< Pointer to the Help Description		*/
+typedef struct shellCmdTemplateTypeDef {
+	const char* cmdName;					/*!< Pointer to the Command Name			*/
+	const char* helpDesc;					/*!< Pointer to the Help Description		*/
 	shellBridge_t bridge;					/*!< Runner for the associated function		*/
+	const shellArgTemplate_t* cmdArgsTable;	/*!< Argument list (numArgs entries)		*/
 	uint8_t numArgs;						/*!< Number of Arguments					*/
-	shellArgTemplate_t cmdArgsTable[MAX_ARGUMENTS];
 } shellCmdTemplate_t;
 
+/*------------------------- COMMAND TABLE GENERATORS ----------------------------------*/
+
+/**
+  * @brief  Expand the command list in CLI_SHELL_COMMANDS.h. Every list entry is
+  * 		SHELL_CMD(ID, NAME, BRIDGE, DESC, ARGHELP) and its arguments are listed by
+  * 		SHELL_ARGS_<ID>(SHELL_ARG) as SHELL_ARG(TOKEN, TYPE, MANDATORY) entries.
+  * @note	Counts, help text and mandatory masks are all derived from the lists, so
+  * 		nothing has to be kept in step by hand.
+  */
+#define SHELL_GEN_INDEX(ID, NAME, BRIDGE, DESC, ARGHELP)		shellCmdIdx_##ID,
+
+/**
+  * @brief  The names of the Command Table packed back to back in one flash pool
+  * 		(shellCmdNamePool_t): one char array per command, so offsetof() is the offset of a
+  * 		name and no padding falls between them. Name lookups read the pool and nothing else.
+  */
+#define SHELL_GEN_NAME_FIELD(ID, NAME, BRIDGE, DESC, ARGHELP)	char ID[sizeof(NAME)];
+#define SHELL_GEN_NAME_POOL(ID, NAME, BRIDGE, DESC, ARGHELP)	.ID = NAME,
+
+#define SHELL_GEN_ARG_LIST(ID, NAME, BRIDGE, DESC, ARGHELP) \
+		static const shellArgTemplate_t shellArgs_##ID[] = { SHELL_ARGS_##ID(SHELL_GEN_ARG_ENTRY) };
+
+#define SHELL_GEN_ENTRY(ID, NAME, BRIDGE, DESC, ARGHELP) \
+		{ \
+				.cmdName = shellCmdNamePool.ID, \
+				.helpDesc = NAME "\t| " DESC "\t| " ARGHELP "\r\n", \
+				.bridge = BRIDGE, \
+				.cmdArgsTable = shellArgs_##ID, \
+				.numArgs = (SHELL_ARGS_##ID(SHELL_GEN_ARG_COUNT) 0), \
+		},
+
+#define SHELL_GEN_NAME_ENTRY(ID, NAME, BRIDGE, DESC, ARGHELP)	shellCmdNamePool.ID,
+
+#define SHELL_GEN_CHECK(ID, NAME, BRIDGE, DESC, ARGHELP) \
+		_Static_assert((SHELL_ARGS_##ID(SHELL_GEN_ARG_COUNT) 0) <= MAX_ARGUMENTS, \
+				"Too many arguments for command " NAME); \
+		_Static_assert((SHELL_ARGS_##ID(SHELL_GEN_ARG_BIT_SUM) 0ULL) == (SHELL_ARGS_##ID(SHELL_GEN_ARG_BIT_OR) 0ULL), \
+				"Duplicate argument token in command " NAME); \
+		_Static_assert(sizeof(NAME) - 1 <= SHELL_CMD_LEN, "Command name longer than SHELL_CMD_LEN: " NAME);
+
+/**
+  * @brief  Validator of one command: the mandatory mask and every argument with its type are
+  * 		constants, so the checks are straight-line code with one converter call per argument
+  * 		given (argConvert_<type>() in CLI_SHELL.c). No template walk, no type switch.
+  */
+#define SHELL_GEN_VALIDATOR(ID, NAME, BRIDGE, DESC, ARGHELP) \
+		static bool shellValidate_##ID(shellParserOutput_t* out) { \
+			return (((SHELL_ARGS_##ID(SHELL_GEN_ARG_MANDATORY) 0UL) & ~out->argMask) == 0) && \
+					(SHELL_ARGS_##ID(SHELL_GEN_ARG_VALIDATE) true); \
+		}
+
+#define SHELL_GEN_VALIDATOR_ENTRY(ID, NAME, BRIDGE, DESC, ARGHELP)	shellValidate_##ID,
+
+#define SHELL_GEN_ARG_COUNT(TOKEN, TYPE, MANDATORY)			1 +
+#define SHELL_GEN_ARG_ENTRY(TOKEN, TYPE, MANDATORY)			{ .mandatory = MANDATORY, .type = TYPE, .token = TOKEN },
+#define SHELL_GEN_ARG_MANDATORY(TOKEN, TYPE, MANDATORY)		((MANDATORY) ? shellTokenBit(TOKEN) : 0UL) |
+#define SHELL_GEN_ARG_BIT_SUM(TOKEN, TYPE, MANDATORY)		(1ULL << (TOKEN)) +
+#define SHELL_GEN_ARG_BIT_OR(TOKEN, TYPE, MANDATORY)		(1ULL << (TOKEN)) |
+#define SHELL_GEN_ARG_VALIDATE(TOKEN, TYPE, MANDATORY) \
+		(((MANDATORY) ? false : (out->argSlot[TOKEN] == SHELL_ARG_NONE)) || argConvert_##TYPE(out, out->argSlot[TOKEN])) &&
+
+#define SHELL_GEN_URGENT(ID)								shellCmdIdx_##ID,
+#define SHELL_GEN_CACHE(ID)									shellCmdIdx_##ID,
+#define SHELL_GEN_ARM(ID)									shellCmdIdx_##ID,
+#define SHELL_GEN_DEADLINE(ID, US)							[shellCmdIdx_##ID] = (US),
+
 /*------------------------------ GENERAL STRUCTURES ------------------------------------*/
 /**
-  * @brief  Stores the raw received string, length, and global flags
+  * @brief  A transport a shell instance runs over. One const table per backend.
+  * @note	write() and txFree() are called from the main loop, attach() once by shellInit().
+  * 		The backend calls rxShellInput() on the attached instance for everything it receives
+  * 		(and shellAbort() on a line break, if it has one).
+  */
+typedef struct shellTransportTypeDef {
+	void (*attach)(uint8_t port, shell_ctx_t* ctx);		/*!< Route received data of port to ctx (rx callback)	*/
+	uint16_t (*write)(uint8_t port, const uint8_t* buffer, uint16_t length);	/*!< Queue output, never blocks	*/
+	void (*flush)(void);								/*!< Start sending what has been queued		*/
+	uint32_t (*txFree)(uint8_t port);					/*!< Room left in the transmit queue		*/
+	uint8_t (*streamAttach)(uint8_t port);				/*!< Move the stream queue to port (NULL if none)	*/
+	void (*rxResume)(uint8_t port);						/*!< Take data again once the ring has room (NULL if none)	*/
+	uint8_t (*notify)(uint8_t port, uint8_t event, uint32_t value);	/*!< Event on the notification channel (NULL if none)	*/
+	uint32_t (*txSpan)(uint8_t port, uint8_t** data);	/*!< Contiguous room in the transmit queue (NULL if none)	*/
+	void (*txCommit)(uint8_t port, uint16_t length);	/*!< Publish what was written into txSpan		*/
+} shellTransport_t;
+
+/**
+  * @brief  Bounded response builder over a caller's buffer (usually on the stack).
+  * @note	Define with SHELL_STR_DEFINE(). Appends write at len and never past size, text that does
+  * 		not fit is cut and truncated is set. No rescans, no terminator, no printf: shellStrSend()
+  * 		waits for transmit room, hands buf/len to outputStreamChannel() and starts over.
   */
 typedef struct {
-	bool rxFlag;
+	char* buf;								/*!< Storage								*/
+	uint16_t size;							/*!< Capacity of buf						*/
+	uint16_t len;							/*!< Characters written						*/
+	bool truncated;							/*!< An append did not fit					*/
+} shellStr_t;
 
-	uint8_t rxBuffer[SHELL_BUFFER_LEN];
+#define SHELL_STR_DEFINE(name, size) \
+		char name##Storage[(size)]; \
+		shellStr_t name = { name##Storage, (size), 0, false }
+
+/**
+  * @brief  A shell instance. Everything one transport's shell needs: the received byte stream,
+  * 		the line being assembled, the session state and the binary frame state.
+  * @note	Define instances with SHELL_CTX_DEFINE(). Instances share the code, the Command Table,
+  * 		the command statistics and the job slot (CLI_SHELL_JOB.h), nothing else.
+  */
+typedef struct shellCtxTypeDef {
+	const shellTransport_t* transport;		/*!< Set by shellInit()						*/
+	uint8_t port;							/*!< Port of the transport (CDC_CH_)		*/
+	bool initialized;						/*!< Set by shellInit()						*/
+	shellRing_t rxRing;						/*!< Received bytes (interrupt -> main loop)	*/
+
+	uint8_t rxBuffer[SHELL_BUFFER_LEN + 1];		/*!< Extra byte lets the tokenizer terminate a full line	*/
 	uint32_t rxLen;
 
-} shellBufferHandle_t;
+	bool lastWasCR;							/*!< Used to fold CRLF into one terminator	*/
+	bool overflow;							/*!< Current line exceeded the line buffer	*/
+
+	shellMode_t mode;						/*!< Current Session Mode					*/
+	shellMode_t pendingMode;				/*!< Mode to switch to after the response	*/
+
+	bool outputMuted;						/*!< Drop all output (benchmark runs)		*/
+	uint8_t* outputSpan;					/*!< Transmit queue block of shellOutputAcquire(), NULL if staged	*/
+	volatile bool abortRequested;			/*!< Ctrl-C or break seen by the receive interrupt	*/
+	bool txStalled;							/*!< shellOutputReserve() timed out, no more waiting	*/
+
+	bool batchActive;						/*!< A batch is running, hold back responses	*/
+	responseCode_t batchStatus;				/*!< First failure within the batch			*/
+
+	int32_t tag;							/*!< Tag of the line being handled, SHELL_NO_TAG without	*/
+
+	shellBinaryState_t binary;				/*!< Binary frame protocol (CLI_SHELL_BINARY.c)	*/
+	shellUrgent_t urgent;					/*!< Urgent lane (CLI_SHELL_URGENT.c)			*/
+	shellHistory_t history;					/*!< Command history (CLI_SHELL_HISTORY.c)		*/
+	shellEdit_t edit;						/*!< Line editor and echo (CLI_SHELL_EDIT.c)	*/
+	shellPipe_t pipe;						/*!< Command pipeline (CLI_SHELL_PIPE.c)		*/
+
+	uint32_t perfStamps[perfStage_count + 1];	/*!< Stage boundaries of the running command	*/
+	bool perfStamped;						/*!< Parse/match stamps set by the text path	*/
+
+} shell_ctx_t;
 
 /**
   * @brief  Errors
   */
 typedef enum shellErrorTypeDef {
 	SHELL_OK,
-	SHELL_ERR
+	SHELL_ERR,
+	SHELL_BUSY					/*!< Bridge started a job (CLI_SHELL_JOB.h)	*/
 } shell_error;
 
 /********************************************************************************
  * PROTOTYPES
  *******************************************************************************/
-shell_error shellInit(void);
-
-// Receive a string from the CLI. This is called from the CDC_Receive_FS function.
-// It is responsible for loading the structure and
-void rxShellInput(uint8_t* Buf, uint32_t *Len);
-
-shell_error checkShellStatus(void);
-
-shell_error HelpBridge(shellParserOutput_t* package);
+shell_error shellInit(shell_ctx_t* ctx, const shellTransport_t* transport, uint8_t port);
+// Add a command at runtime, before the first shellInit() (or from a module, CLI_SHELL_MODULE.h).
+// The template stays in use, keep it in flash.
+shell_error shellRegisterCommand(const shellCmdTemplate_t* cmd, uint16_t* commandIndex);
+
+// Receive a string from the CLI. This is called from the receive callback of the instance's port.
+// It only queues the bytes - checkShellStatus() assembles and runs the commands.
+void rxShellInput(shell_ctx_t* ctx, uint8_t* Buf, uint32_t *Len);
+// Room left in the receive ring. The receive callback holds the sender back below a packet.
+uint32_t shellRxFree(shell_ctx_t* ctx);
+
+// Abort the running command of an instance (interrupt safe). Long bridges poll shellAbortRequested() and stop early.
+void shellAbort(shell_ctx_t* ctx);
+bool shellAbortRequested(shell_ctx_t* ctx);
+
+shell_error checkShellStatus(shell_ctx_t* ctx);
+
+// Shell internals shared with the shell sub-modules (CLI_SHELL_BINARY.c, ...)
+shell_error shellDispatch(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t commandIndex);
+shell_error shellResolveCommand(shell_ctx_t* ctx, uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut,
+		uint16_t* commandIndex);
+shell_error shellRunLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len);
+bool shellParseAhead(uint8_t* line, uint32_t len, shellParserOutput_t* cmdParseOut, uint16_t* commandIndex);
+int32_t takeTag(uint8_t** line, uint32_t* len);
+shell_error shellSendResponse(shell_ctx_t* ctx, responseCode_t code);
+uint16_t shellOutputWrite(shell_ctx_t* ctx, const uint8_t* buffer, uint16_t length);
+bool shellOutputReserve(shell_ctx_t* ctx, uint16_t length);
+uint8_t* shellOutputAcquire(shell_ctx_t* ctx, uint16_t length);
+void shellOutputCommit(shell_ctx_t* ctx, uint16_t length);
+void shellStrAppend(shellStr_t* str, const char* text);
+void shellStrAppendN(shellStr_t* str, const char* text, uint16_t length);
+void shellStrAppendChar(shellStr_t* str, char c);
+void shellStrAppendUnsigned(shellStr_t* str, uint32_t value, uint8_t minDigits);
+void shellStrAppendHex(shellStr_t* str, uint32_t value, uint8_t digits);
+void shellStrSend(shell_ctx_t* ctx, shellStr_t* str);
+uint16_t shellCommandCount(void);
+const char* shellCommandName(uint16_t commandIndex);
+const shellCmdTemplate_t* shellCommandTemplate(uint16_t commandIndex);
+uint16_t shellCommandTableId(void);
+void shellIndexArg(shellParserOutput_t* cmdParserOutput, uint8_t argIndex);
+uint8_t shellArgArray(const shellParserOutput_t* cmdParserOutput, uint8_t argIndex, void* items, uint8_t maxItems);
+const shellPerfStat_t* shellPerfStats(uint16_t commandIndex);
+void shellPerfClear(void);
+
+// Lookup routines, exported for the benchmark (CLI_SHELL_BENCH.c)
+shell_error matchCommandLinear(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex);
+shell_error matchCommand(shellParserOutput_t* cmdParserOutput, int16_t* commandIndex);
+
+shell_error HelpBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ModeBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error PerfBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ArtBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error BenchBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error RegressBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error CancelBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ClockBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SleepBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error StreamBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error TputBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error PingBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error LoopbackBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SinkBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SourceBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error MrdBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error MwrBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error MacroBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error GetBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SetBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error FlashBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error FwupdateBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error EveryBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error CaptureBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error PatternBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error AdcBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SpiBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error I2cBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error VmBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error LetBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error LoadBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error GpioBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error EventsBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ModulesBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error HistoryBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error TermBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error IdleBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error NotifyBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error MemBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error TraceBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error TsyncBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ArmBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error ItmBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error UsbstatBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error IsrBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error BootBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error CrashBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error CrcBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error WatchBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+shell_error SessionBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
+
+// Application bridge of "setLed", defined outside of the shell
+shell_error LEDBridge(shell_ctx_t* ctx, shellParserOutput_t* package);
 
 #endif // CLI_SHELL_H_
 
@@ -0,0 +1,603 @@
+/** @file CLI_SHELL_ADC.c
+ *
+ * @brief ADC acquisition of the CLI Shell: ADC1 scans, TIM3 trigger, DMA2 double buffering and "adc"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ADC.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_FORMAT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_STREAM.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define ADC_TIMER				TIM3
+#define ADC_DMA_STREAM			DMA2_Stream4		/*!< Stream 0 belongs to the CRC service	*/
+#define ADC_DMA_IRQn			DMA2_Stream4_IRQn
+#define ADC_DMA_CHANNEL			DMA_CHANNEL_0		/*!< ADC1								*/
+
+#define ADC_EXTSEL_TIM3_TRGO	(0x8U << ADC_CR2_EXTSEL_Pos)
+#define ADC_EXTEN_RISING		(0x1U << ADC_CR2_EXTEN_Pos)
+#define ADC_PRESCALER_DIV4		(0x1U << ADC_CCR_ADCPRE_Pos)
+#define ADC_CLOCK_DIVIDER		4U
+#define ADC_CONVERSION_CLOCKS	12U					/*!< Successive approximation, 12 bits	*/
+#define ADC_INTERNAL_SAMPLE_US	10U					/*!< Vrefint and temperature sensor		*/
+#define ADC_CHANNEL_VREFINT		17U
+#define ADC_CHANNEL_TEMP		18U
+
+#define ADC_SCAN_TEXT_LEN		(SHELL_ADC_MAX_CHANNELS * 5 + 2)	/*!< "4095 ...\r\n"		*/
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  Sampling times SMP 0 to 7 in ADC clocks
+  */
+static const uint16_t adcSampleClocks[8] = { 3, 15, 28, 56, 84, 112, 144, 480 };
+
+static TIM_HandleTypeDef adcTimer;
+static DMA_HandleTypeDef adcDma;
+
+/**
+  * @brief  The running acquisition
+  */
+static struct {
+	uint16_t buffer[SHELL_ADC_BUF_LEN];		/*!< Circular DMA buffer, two halves		*/
+	uint32_t half;							/*!< Results per half, whole groups			*/
+	volatile uint32_t halves;				/*!< Halves written (half/full transfer)	*/
+	uint32_t taken;							/*!< Halves processed						*/
+	volatile bool dmaError;
+	bool running;
+
+	uint8_t channels;
+	uint8_t channel[SHELL_ADC_MAX_CHANNELS];
+	uint8_t decimation;
+	uint8_t sampleTime;						/*!< SMP code of every channel				*/
+	uint32_t rate;							/*!< Scans per second						*/
+	uint16_t prescaler;						/*!< TIM3 PSC								*/
+	uint16_t reload;						/*!< TIM3 ARR								*/
+
+	bool binary;
+	bool endless;
+	uint32_t remaining;						/*!< Scans still to send					*/
+	uint32_t sent;							/*!< Scans queued							*/
+	uint32_t dropped;						/*!< Scans lost								*/
+	bool droppedSinceFrame;
+
+	uint8_t frameSeq;
+	uint8_t frameCount;						/*!< Samples in frame						*/
+	uint8_t frameSamples;					/*!< Samples of a full frame, whole scans	*/
+	uint8_t frame[SHELL_STREAM_FRAME_LEN];
+} adc;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t adcTimerClock(void);
+static bool adcDividers(uint32_t rate);
+static bool adcPickSampleTime(uint32_t rate);
+static void adcDmaHalf(DMA_HandleTypeDef* hdma);
+static void adcDmaError(DMA_HandleTypeDef* hdma);
+static bool adcStart(void);
+static bool adcQueueFrame(uint8_t flags);
+static void adcEmitScan(const uint16_t* values);
+static void adcProcessHalf(const uint16_t* results);
+static void adcPoll(void);
+static void reportAdc(shell_ctx_t* ctx);
+static shell_error adcJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Counter clock of TIM3
+  * @note	The APB1 timers run at twice PCLK1 whenever the APB1 prescaler divides.
+  * @param  NONE
+  * @retval uint32_t Frequency (Hz)
+  */
+static uint32_t adcTimerClock(void) {
+	uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		timerClock *= 2;
+	}
+	return timerClock;
+}
+
+/**
+  * @brief  Prescaler and reload of the nearest scan rate the timer clock can divide to
+  * @param[IN]  rate Scans per second
+  * @retval bool Returns false if the rate is out of range
+  */
+static bool adcDividers(uint32_t rate) {
+	uint32_t timerClock = adcTimerClock();
+
+	if (rate == 0 || rate > timerClock) {
+		return false;
+	}
+
+	uint32_t ticks = (timerClock + (rate / 2)) / rate;
+	uint32_t prescaler = (ticks - 1) / 65536U;
+	uint32_t reload = (ticks / (prescaler + 1)) - 1;
+
+	if (prescaler > UINT16_MAX) {
+		return false;
+	}
+	adc.prescaler = prescaler;
+	adc.reload = reload;
+	return true;
+}
+
+/**
+  * @brief  Longest sampling time whose scan fits the scan period
+  * @param[IN]  rate Scans per second
+  * @retval bool Returns false if not even the shortest one fits (or an internal channel's)
+  */
+static bool adcPickSampleTime(uint32_t rate) {
+	uint32_t adcClock = HAL_RCC_GetPCLK2Freq() / ADC_CLOCK_DIVIDER;
+	uint32_t budget = adcClock / rate / adc.channels;
+	uint32_t minimum = 0;
+
+	for (uint8_t i = 0; i < adc.channels; i++) {
+		if (adc.channel[i] >= ADC_CHANNEL_VREFINT) {
+			minimum = (adcClock / 1000000U) * ADC_INTERNAL_SAMPLE_US;
+		}
+	}
+
+	for (int8_t smp = 7; smp >= 0; smp--) {
+		if (adcSampleClocks[smp] + ADC_CONVERSION_CLOCKS <= budget) {
+			adc.sampleTime = (uint8_t)smp;
+			return adcSampleClocks[smp] >= minimum;
+		}
+	}
+	return false;
+}
+
+/**
+  * @brief  Half and full transfer, one more half of the buffer written
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void adcDmaHalf(DMA_HandleTypeDef* hdma) {
+	adc.halves++;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/**
+  * @brief  Transfer error, the HAL has stopped the stream
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void adcDmaError(DMA_HandleTypeDef* hdma) {
+	__HAL_TIM_DISABLE(&adcTimer);
+	adc.dmaError = true;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/**
+  * @brief  Sets up ADC1, its DMA and TIM3 and starts the scans
+  * @param  NONE
+  * @retval bool Returns false if the DMA or the timer could not be started
+  */
+static bool adcStart(void) {
+	GPIO_InitTypeDef gpioInit = {0};
+	TIM_MasterConfigTypeDef masterConfig = {0};
+	uint32_t smpr1 = 0;
+	uint32_t smpr2 = 0;
+	uint32_t sqr3 = 0;
+	uint32_t ccr = ADC_PRESCALER_DIV4;
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	__HAL_RCC_ADC1_CLK_ENABLE();
+	__HAL_RCC_TIM3_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	gpioInit.Mode = GPIO_MODE_ANALOG;
+	gpioInit.Pull = GPIO_NOPULL;
+	for (uint8_t i = 0; i < adc.channels; i++) {
+		uint8_t channel = adc.channel[i];
+
+		if (channel < 8) {
+			gpioInit.Pin = 1U << channel;
+			HAL_GPIO_Init(GPIOA, &gpioInit);
+		} else if (channel >= 10 && channel <= 15) {
+			gpioInit.Pin = 1U << (channel - 10);
+			HAL_GPIO_Init(GPIOC, &gpioInit);
+		}
+
+		// Channels 10 and up in SMPR1, the others in SMPR2, 3 bits each
+		if (channel >= 10) {
+			smpr1 |= (uint32_t)adc.sampleTime << (3 * (channel - 10));
+		} else {
+			smpr2 |= (uint32_t)adc.sampleTime << (3 * channel);
+		}
+		sqr3 |= (uint32_t)channel << (5 * i);
+		if (channel >= ADC_CHANNEL_VREFINT) {
+			ccr |= ADC_CCR_TSVREFE;
+		}
+	}
+
+	ADC1->CR2 = 0;
+	ADC->CCR = ccr;
+	ADC1->SR = 0;
+	ADC1->SMPR1 = smpr1;
+	ADC1->SMPR2 = smpr2;
+	ADC1->SQR1 = (uint32_t)(adc.channels - 1) << ADC_SQR1_L_Pos;
+	ADC1->SQR2 = 0;
+	ADC1->SQR3 = sqr3;
+	ADC1->CR1 = (adc.channels > 1) ? ADC_CR1_SCAN : 0;
+
+	adcDma.Instance = ADC_DMA_STREAM;
+	adcDma.Init.Channel = ADC_DMA_CHANNEL;
+	adcDma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	adcDma.Init.PeriphInc = DMA_PINC_DISABLE;
+	adcDma.Init.MemInc = DMA_MINC_ENABLE;
+	adcDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+	adcDma.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+	adcDma.Init.Mode = DMA_CIRCULAR;
+	adcDma.Init.Priority = DMA_PRIORITY_HIGH;
+	adcDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+	if (HAL_DMA_Init(&adcDma) != HAL_OK) {
+		return false;
+	}
+
+	// HAL_DMA_Init() clears the callbacks
+	adcDma.XferHalfCpltCallback = adcDmaHalf;
+	adcDma.XferCpltCallback = adcDmaHalf;
+	adcDma.XferErrorCallback = adcDmaError;
+
+	adc.halves = 0;
+	adc.taken = 0;
+	adc.dmaError = false;
+
+	HAL_NVIC_SetPriority(ADC_DMA_IRQn, SHELL_ADC_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(ADC_DMA_IRQn);
+	if (HAL_DMA_Start_IT(&adcDma, (uint32_t)&ADC1->DR, (uint32_t)adc.buffer, adc.half * 2) != HAL_OK) {
+		return false;
+	}
+
+	// Every scan on a rising TRGO, a DMA request per result for as long as it runs
+	ADC1->CR2 = ADC_CR2_ADON | ADC_CR2_DMA | ADC_CR2_DDS | ADC_EXTEN_RISING | ADC_EXTSEL_TIM3_TRGO;
+
+	adcTimer.Instance = ADC_TIMER;
+	adcTimer.Init.Prescaler = adc.prescaler;
+	adcTimer.Init.CounterMode = TIM_COUNTERMODE_UP;
+	adcTimer.Init.Period = adc.reload;
+	adcTimer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	adcTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	masterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+	masterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+	if (HAL_TIM_Base_Init(&adcTimer) != HAL_OK ||
+			HAL_TIMEx_MasterConfigSynchronization(&adcTimer, &masterConfig) != HAL_OK) {
+		shellAdcStop();
+		return false;
+	}
+
+	// The ADC is ready 3 us after ADON, the first update is a full period away
+	adc.running = true;
+	__HAL_TIM_ENABLE(&adcTimer);
+	return true;
+}
+
+/**
+  * @brief  Completes the frame being filled and queues it
+  * @note	A frame that does not fit is dropped, the ADC does not wait. The next frame is
+  * 		started either way.
+  * @param[IN]  flags Extra SHELL_STREAM_FLAG_ bits
+  * @retval bool Returns false if the stream queue had no room
+  */
+static bool adcQueueFrame(uint8_t flags) {
+	uint32_t scans = adc.frameCount / adc.channels;
+	bool queued;
+
+	if (adc.droppedSinceFrame) {
+		flags |= SHELL_STREAM_FLAG_DROPPED;
+	}
+
+	adc.frame[0] = SHELL_STREAM_SOF;
+	adc.frame[1] = adc.frameSeq;
+	adc.frame[2] = adc.frameCount;
+	adc.frame[3] = flags;
+
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &adc.frame[1], SHELL_STREAM_FRAME_LEN - 3);
+	adc.frame[SHELL_STREAM_FRAME_LEN - 2] = (uint8_t)crc;
+	adc.frame[SHELL_STREAM_FRAME_LEN - 1] = (uint8_t)(crc >> 8);
+
+	queued = transportStreamWrite(adc.frame, SHELL_STREAM_FRAME_LEN);
+	if (queued) {
+		adc.sent += scans;
+		adc.frameSeq++;
+		adc.droppedSinceFrame = false;
+	} else {
+		adc.dropped += scans;
+		adc.droppedSinceFrame = true;
+	}
+
+	adc.frameCount = 0;
+	memset(&adc.frame[SHELL_STREAM_FRAME_HEADER_LEN], 0, SHELL_STREAM_FRAME_SAMPLES * 2);
+	return queued;
+}
+
+/**
+  * @brief  Sends one (decimated) scan as a text line or into the frame
+  * @param[IN]  values One value per channel
+  * @retval NONE
+  */
+static void adcEmitScan(const uint16_t* values) {
+	if (adc.binary) {
+		uint8_t* sample = &adc.frame[SHELL_STREAM_FRAME_HEADER_LEN + 2 * adc.frameCount];
+
+		for (uint8_t i = 0; i < adc.channels; i++) {
+			*sample++ = (uint8_t)values[i];
+			*sample++ = (uint8_t)(values[i] >> 8);
+		}
+		adc.frameCount += adc.channels;
+		if (adc.frameCount == adc.frameSamples) {
+			adcQueueFrame(0);
+		}
+	} else {
+		char line[ADC_SCAN_TEXT_LEN];
+		uint8_t len = 0;
+
+		for (uint8_t i = 0; i < adc.channels; i++) {
+			len += shellFmtUnsigned(&line[len], values[i]);
+			line[len++] = (i + 1 < adc.channels) ? ' ' : '\r';
+		}
+		line[len++] = '\n';
+
+		if (transportStreamWrite((uint8_t*)line, len)) {
+			adc.sent++;
+		} else {
+			adc.dropped++;
+		}
+	}
+	adc.remaining -= adc.endless ? 0 : 1;
+}
+
+/**
+  * @brief  Averages the groups of one half and sends the scans
+  * @param[IN]  results First result of the half
+  * @retval NONE
+  */
+static void adcProcessHalf(const uint16_t* results) {
+	uint32_t group = (uint32_t)adc.channels * adc.decimation;
+
+	for (uint32_t start = 0; start < adc.half; start += group) {
+		uint32_t sum[SHELL_ADC_MAX_CHANNELS] = {0};
+		uint16_t values[SHELL_ADC_MAX_CHANNELS];
+		const uint16_t* result = &results[start];
+
+		if (!adc.endless && adc.remaining == 0) {
+			return;
+		}
+
+		for (uint8_t d = 0; d < adc.decimation; d++) {
+			for (uint8_t i = 0; i < adc.channels; i++) {
+				sum[i] += *result++;
+			}
+		}
+		for (uint8_t i = 0; i < adc.channels; i++) {
+			values[i] = (uint16_t)((sum[i] + adc.decimation / 2) / adc.decimation);
+		}
+		adcEmitScan(values);
+	}
+}
+
+/**
+  * @brief  Works through the halves the DMA has written since the last poll
+  * @note	The DMA is already back in a half that is two or more behind, it is dropped.
+  * @param  NONE
+  * @retval NONE
+  */
+static void adcPoll(void) {
+	uint32_t halves = adc.halves;
+
+	if (halves - adc.taken > 1) {
+		uint32_t lost = halves - adc.taken - 1;
+
+		adc.dropped += lost * (adc.half / adc.channels / adc.decimation);
+		adc.droppedSinceFrame = true;
+		adc.taken += lost;
+	}
+
+	while (adc.taken != halves && (adc.endless || adc.remaining != 0)) {
+		adcProcessHalf(&adc.buffer[(adc.taken & 1) ? adc.half : 0]);
+		adc.taken++;
+	}
+}
+
+/**
+  * @brief  Sends the scan and drop counts
+  * @param[IN]  ctx Shell instance of the job
+  * @retval NONE
+  */
+static void reportAdc(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 60);
+
+	shellStrAppend(&str, "ADC: ");
+	shellStrAppendUnsigned(&str, adc.sent, 0);
+	shellStrAppend(&str, " scans, ");
+	shellStrAppendUnsigned(&str, adc.dropped, 0);
+	shellStrAppend(&str, " dropped\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Poll function of "adc"
+  * @param[IN]  job The acquisition job
+  * @retval shell_error SHELL_BUSY while sampling, SHELL_ERR on an ADC overrun or a DMA error
+  */
+static shell_error adcJob(shellJob_t* job) {
+	if (job->cancel) {
+		shellAdcStop();
+		reportAdc(job->ctx);
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	while (adc.endless || adc.remaining > 0) {
+		if (adc.dmaError || (ADC1->SR & ADC_SR_OVR)) {
+			shellAdcStop();
+			reportAdc(job->ctx);
+			job->state = 0;
+			return SHELL_ERR;
+		}
+		adcPoll();
+		SHELL_JOB_YIELD(job);
+	}
+	shellAdcStop();
+
+	// Send the rest, then report once the host has everything
+	if (adc.binary) {
+		SHELL_JOB_WAIT_UNTIL(job, transportStreamFree() >= SHELL_STREAM_FRAME_LEN);
+		adcQueueFrame(SHELL_STREAM_FLAG_LAST);
+	}
+	SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+	reportAdc(job->ctx);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stops the scans, the DMA and the timer
+  * @param  NONE
+  * @retval NONE
+  */
+void shellAdcStop(void) {
+	if (!adc.running) {
+		return;
+	}
+
+	__HAL_TIM_DISABLE(&adcTimer);
+	ADC1->CR2 = 0;
+	HAL_DMA_Abort(&adcDma);
+	HAL_NVIC_DisableIRQ(ADC_DMA_IRQn);
+	adc.running = false;
+}
+
+/**
+  * @brief  Keeps the scan rate after a clock profile change
+  * @note	Called by shellClockApply(). The new dividers are loaded at the next update.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellAdcClockChanged(void) {
+	if (adc.running && adcDividers(adc.rate)) {
+		__HAL_TIM_SET_PRESCALER(&adcTimer, adc.prescaler);
+		__HAL_TIM_SET_AUTORELOAD(&adcTimer, adc.reload);
+	}
+}
+
+/**
+  * @brief  DMA2 Stream 4, a half of the ADC buffer written
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream4_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&adcDma);
+	SHELL_ISR_RECORD(isrId_adc, start, SHELL_ISR_NO_LATENCY);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Starts an acquisition
+  * @note	See CLI_SHELL_ADC.h for the arguments and the record formats.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the acquisition is running
+  */
+shell_error AdcBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint8_t channel[SHELL_ADC_MAX_CHANNELS];
+	uint8_t channels = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_c), channel, SHELL_ADC_MAX_CHANNELS);
+	uint32_t rate = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u32;
+	uint8_t decimation = 1;
+	uint32_t count = 0;
+	uint8_t format = 0;
+
+	if (shellHasArg(parserInput, argTkn_d)) {
+		decimation = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+	}
+	if (shellHasArg(parserInput, argTkn_n)) {
+		count = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+	}
+	if (shellHasArg(parserInput, argTkn_f)) {
+		format = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+	}
+
+	if (channels == 0 || decimation == 0 || decimation > SHELL_ADC_MAX_DECIMATION || format > 1 ||
+			rate == 0 || (uint64_t)rate * channels > SHELL_ADC_MAX_CONVERSIONS) {
+		return SHELL_ERR;
+	}
+	for (uint8_t i = 0; i < channels; i++) {
+		if ((channel[i] >= 8 && channel[i] <= 9) || channel[i] > ADC_CHANNEL_TEMP || channel[i] == 16) {
+			return SHELL_ERR;
+		}
+	}
+
+	// The stream queue goes to the port of this command. It only moves once it has drained.
+	if (shellJobRunning() || adc.running || !transportStreamAttach(ctx)) {
+		return SHELL_ERR;
+	}
+
+	memset(&adc, 0, sizeof(adc));
+	memcpy(adc.channel, channel, channels);
+	adc.channels = channels;
+	adc.decimation = decimation;
+	adc.rate = rate;
+	adc.binary = (format == 1);
+	adc.endless = (count == 0);
+	adc.remaining = count;
+	adc.frameSamples = (SHELL_STREAM_FRAME_SAMPLES / channels) * channels;
+
+	if (!adcDividers(rate) || !adcPickSampleTime(rate)) {
+		return SHELL_ERR;
+	}
+
+	// Whole decimation groups per half, about SHELL_ADC_HALF_MS of them, at least one
+	uint32_t group = (uint32_t)channels * decimation;
+	uint32_t half = (uint32_t)(((uint64_t)rate * channels * SHELL_ADC_HALF_MS) / 1000U);
+	if (half > SHELL_ADC_BUF_LEN / 2) {
+		half = SHELL_ADC_BUF_LEN / 2;
+	}
+	adc.half = (half < group) ? group : (half / group) * group;
+
+	if (shellJobStart(ctx, adcJob) == NULL) {
+		return SHELL_ERR;
+	}
+	if (!adcStart()) {
+		shellAdcStop();
+		shellJobCancel();
+		return SHELL_ERR;
+	}
+
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
@@ -0,0 +1,72 @@
+/** @file CLI_SHELL_ADC.h
+ *
+ * @brief ADC acquisition of the CLI Shell: TIM3 paced scans by DMA, decimation, streaming
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "adc c<ch,ch,..> r<rate> d<decimation> n<scans> f<format>" samples up to SHELL_ADC_MAX_CHANNELS
+ *    ADC1 channels in one scan, r scans per second, and streams them through the stream queue
+ *    (transportStreamWrite) until n scans are sent (0 or omitted: until cancelled). It runs as a
+ *    job (CLI_SHELL_JOB.h), "cancel" or Ctrl-C stops it.
+ *    - c: channels 0-7 (PA0-PA7), 10-15 (PC0-PC5), 17 (Vrefint), 18 (temperature sensor). 8 and 9
+ *      are the LEDs on PB0/PB1. PA0 is the capture input (CLI_SHELL_CAPTURE.h), PA2/PA3 the
+ *      ST-LINK virtual COM port of the Nucleo.
+ *    - r: scans per second, all channels of a scan at once. Rate times channels up to
+ *      SHELL_ADC_MAX_CONVERSIONS.
+ *    - d: decimation, 1 (default) to SHELL_ADC_MAX_DECIMATION. Every d scans are averaged into
+ *      one (boxcar filter, rounded), the stream carries r/d scans per second.
+ *    - f: 0 text (default), one line of decimal values per scan, "2048 1502\r\n". 1 binary.
+ *  - Binary frames are the frames of CLI_SHELL_STREAM.h (SOF 0x5B, seq, count, flags, samples,
+ *    CRC16) with whole scans only: count is a multiple of the channels, the samples of a scan in
+ *    the order of c. Values are 12-bit, right aligned.
+ *  - TIM3 update events trigger the scans (TRGO), DMA2 Stream 4 (channel 0) moves the results into
+ *    a circular buffer. Each half holds whole decimation groups and about SHELL_ADC_HALF_MS of
+ *    data, its half/full transfer interrupt only counts. The job averages and frames a half while
+ *    the DMA fills the other. The CPU touches every sample once, in a tight loop.
+ *  - The sampling time of each channel is the longest that fits the scan period (3 to 480 ADC
+ *    clocks of PCLK2/4). The internal channels need 10 us, their rate is limited accordingly.
+ *  - A half the job has not taken before the DMA comes back to it, or a frame the stream queue has
+ *    no room for, is dropped and counted. A binary frame after a loss has
+ *    SHELL_STREAM_FLAG_DROPPED, the last one SHELL_STREAM_FLAG_LAST. The counts follow the data:
+ *      "ADC: <scans> scans, <dropped> dropped"
+ *  - USB full speed carries about 1 MB/s, 2 bytes per sample in binary frames. The ADC itself
+ *    converts up to SHELL_ADC_MAX_CONVERSIONS per second, decimate to stay within the link.
+ *  - The ADC registers are driven directly, the HAL ADC module (stm32f4xx_hal_adc.c) is not part
+ *    of the project and stays disabled in stm32f4xx_hal_conf.h. The rate is recomputed for the new
+ *    APB1 timer clock by shellClockApply() (CLI_SHELL_CLOCK.h).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_ADC_H_
+#define CLI_SHELL_ADC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_ADC_MAX_CHANNELS			4			/*!< Channels of a scan					*/
+#define SHELL_ADC_MAX_DECIMATION		64
+#define SHELL_ADC_MAX_CONVERSIONS		1000000U	/*!< Conversions per second, all channels	*/
+#define SHELL_ADC_BUF_LEN				2048		/*!< Results in the DMA buffer (4 KB)	*/
+#define SHELL_ADC_HALF_MS				10			/*!< Aimed at time to fill a half		*/
+#define SHELL_ADC_IRQ_PRIORITY			2			/*!< Only counts the halves				*/
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellAdcStop(void);
+void shellAdcClockChanged(void);
+
+#endif // CLI_SHELL_ADC_H_
+
+/*** end of file ***/
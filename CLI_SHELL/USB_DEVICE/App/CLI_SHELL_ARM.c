@@ -0,0 +1,349 @@
+/** @file CLI_SHELL_ARM.c
+ *
+ * @brief Armed commands of the CLI Shell: one command run by the edge of a trigger line, "arm"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ARM.h"
+#include "CLI_SHELL_EXTI.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define ARM_EDGE_RISING					1U
+#define ARM_EDGE_FALLING				2U
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The armed command
+  * @note	Everything but the fire stamps is written before armed is set, the interrupt only
+  * 		reads it. The fire stamps belong to the interrupt until fired is set.
+  */
+typedef struct {
+	volatile bool armed;					/*!< Set by the line, cleared by the fire	*/
+	shell_ctx_t* ctx;						/*!< Instance that armed it, gets the report	*/
+	uint8_t line;							/*!< EXTI line, the pin number				*/
+	uint8_t port;							/*!< 0 GPIOA to 2 GPIOC						*/
+	uint8_t edge;							/*!< 1 rising, 2 falling, 3 both			*/
+	uint8_t text[SHELL_ARM_LINE_LEN + 1];	/*!< Tokenized command line					*/
+	shellParserOutput_t parserOutput;		/*!< Resolved and validated once			*/
+	uint16_t commandIndex;
+	shellBridge_t bridge;
+	uint32_t usbPriority;					/*!< OTG_FS priority before arming			*/
+
+	volatile bool fired;					/*!< Set by the fire, cleared by the report	*/
+	uint32_t fires;							/*!< Fires since boot						*/
+	uint16_t firedIndex;					/*!< Command of the last fire				*/
+	shell_error result;
+	uint32_t entryCycles;					/*!< Interrupt entry						*/
+	uint32_t bridgeCycles;					/*!< Bridge called							*/
+	uint32_t doneCycles;					/*!< Bridge returned						*/
+} shellArm_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellArm_t arm;
+
+static const char* const armEdgeNames[] = { "off", "rising", "falling", "both" };
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool armable(uint16_t commandIndex);
+static bool armParseSpec(const uint8_t* text, uint32_t len, uint32_t* used);
+static void armRelease(void);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Whether a command is on SHELL_ARM_LIST
+  * @param[IN]  commandIndex Index of the command within the Command Table
+  * @retval bool Returns true if it may run from the trigger interrupt
+  */
+static bool armable(uint16_t commandIndex) {
+	for (const uint16_t* command = shellArmTable; *command < shellCommandCount(); command++) {
+		if (*command == commandIndex) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+  * @brief  Reads "P<port><pin>[+|-|*]" into arm.port, arm.line and arm.edge
+  * @param[IN]  text Text after the keyword
+  * @param[IN]  len Length of the text
+  * @param[OUT]  used Characters up to the command line
+  * @retval bool Returns false if the pin is malformed or out of range
+  */
+static bool armParseSpec(const uint8_t* text, uint32_t len, uint32_t* used) {
+	uint32_t pos = 2;
+	uint32_t pin = 0;
+
+	if (len < 3 || text[0] != 'P' || text[1] < 'A' || text[1] >= (uint8_t)('A' + SHELL_EXTI_PORTS)) {
+		return false;
+	}
+	while (pos < len && pos < 4 && text[pos] >= '0' && text[pos] <= '9') {
+		pin = (pin * 10U) + (text[pos] - '0');
+		pos++;
+	}
+	if (pos == 2 || pin >= SHELL_EXTI_LINES) {
+		return false;
+	}
+
+	arm.edge = ARM_EDGE_RISING;
+	if (pos < len && text[pos] != ' ') {
+		switch (text[pos]) {
+			case '+':
+				arm.edge = ARM_EDGE_RISING;
+				break;
+			case '-':
+				arm.edge = ARM_EDGE_FALLING;
+				break;
+			case '*':
+				arm.edge = ARM_EDGE_RISING | ARM_EDGE_FALLING;
+				break;
+			default:
+				return false;
+		}
+		pos++;
+	}
+
+	// The command line follows after at least one space
+	if (pos >= len || text[pos] != ' ') {
+		return false;
+	}
+	while (pos < len && text[pos] == ' ') {
+		pos++;
+	}
+	if (pos >= len) {
+		return false;
+	}
+
+	arm.port = (uint8_t)(text[1] - 'A');
+	arm.line = (uint8_t)pin;
+	*used = pos;
+	return true;
+}
+
+/**
+  * @brief  Masks the line and gives OTG_FS its priority back
+  * @note	Called by the fire from the interrupt, and by the main loop with the line armed.
+  * @param  NONE
+  * @retval NONE
+  */
+static void armRelease(void) {
+	arm.armed = false;
+	shellExtiHold(arm.line, arm.port, 0, SHELL_ARM_IRQ_PRIORITY);
+	NVIC_SetPriority(OTG_FS_IRQn, arm.usbPriority);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Arms the command of an "arm P<port><pin>[edge] <command line>" line
+  * @note	Called by shellRunLine(). The command is resolved and validated here, so an unknown
+  * 		command or bad argument is answered right away like any other line.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Text after the keyword
+  * @param[IN]  len Length of the text
+  * @retval shell_error Error Return Value
+  */
+shell_error shellArmLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	uint32_t used;
+
+	if (arm.armed) {
+		// One at a time, "arm d1" first
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+		return SHELL_ERR;
+	}
+	if (!armParseSpec(line, len, &used)) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	line += used;
+	len -= used;
+	if (len > SHELL_ARM_LINE_LEN) {
+		shellSendResponse(ctx, RESPONSE_LEN_ERR);
+		return SHELL_ERR;
+	}
+
+	memcpy(arm.text, line, len);
+	if (shellResolveCommand(ctx, arm.text, len, &arm.parserOutput, &arm.commandIndex) != SHELL_OK) {
+		return SHELL_ERR;
+	}
+	arm.bridge = shellCommandTemplate(arm.commandIndex)->bridge;
+	if (!armable(arm.commandIndex) || (arm.bridge == MwrBridge && !shellHasArg(&arm.parserOutput, argTkn_v))) {
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+		return SHELL_ERR;
+	}
+
+	arm.ctx = ctx;
+	arm.usbPriority = NVIC_GetPriority(OTG_FS_IRQn);
+
+	// Everything above is in place before the interrupt can see the line
+	arm.armed = true;
+	if (!shellExtiHold(arm.line, arm.port, arm.edge, SHELL_ARM_IRQ_PRIORITY)) {
+		// Logged by "events"
+		arm.armed = false;
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+		return SHELL_ERR;
+	}
+	NVIC_SetPriority(OTG_FS_IRQn, SHELL_ARM_USB_PRIORITY);
+
+	shellSendResponse(ctx, RESPONSE_OK);
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Runs the armed command if its line has a pending edge, called first by the EXTI
+  * 		interrupts (CLI_SHELL_EXTI.c)
+  * @note	The bridge gets the stored parser output straight away, with the output of the
+  * 		instance muted. The interrupt runs to completion, so the main loop sees the mute
+  * 		neither set nor restored.
+  * @param[IN]  cycles Cycle counter at the interrupt entry
+  * @param[IN]  lines Line mask of the interrupt
+  * @retval NONE
+  */
+SHELL_RAMFUNC void shellArmFire(uint32_t cycles, uint32_t lines) {
+	uint32_t bit = 1UL << arm.line;
+
+	if (!arm.armed || (lines & bit) == 0 || (EXTI->PR & bit) == 0) {
+		return;
+	}
+	EXTI->PR = bit;
+
+	shell_ctx_t* ctx = arm.ctx;
+	bool muted = ctx->outputMuted;
+
+	ctx->outputMuted = true;
+	arm.bridgeCycles = shellPerfCycles();
+	arm.result = arm.bridge(ctx, &arm.parserOutput);
+	arm.doneCycles = shellPerfCycles();
+	ctx->outputMuted = muted;
+
+	arm.entryCycles = cycles;
+	arm.firedIndex = arm.commandIndex;
+	arm.fires++;
+	armRelease();
+	arm.fired = true;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/**
+  * @brief  Reports a fire to the instance that armed the command
+  * @note	Called by checkShellStatus(). A line without a response, the command was answered
+  * 		when it was armed.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellArmPoll(shell_ctx_t* ctx) {
+	if (!arm.fired || arm.ctx != ctx) {
+		return;
+	}
+	arm.fired = false;
+
+	SHELL_STR_DEFINE(str, 96);
+
+	shellStrAppend(&str, "Fired: ");
+	shellStrAppend(&str, (arm.result == SHELL_OK) ? "OK" : "Function Error");
+	shellStrAppend(&str, ", at ");
+	shellStrAppendUnsigned(&str, shellTsyncAt(arm.entryCycles), 0);
+	shellStrAppend(&str, " us, ");
+	shellStrAppendUnsigned(&str, arm.bridgeCycles - arm.entryCycles, 0);
+	shellStrAppend(&str, " cycles to the bridge\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Disarms the command of an instance (Ctrl-C or break)
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellArmStop(shell_ctx_t* ctx) {
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	if (arm.armed && arm.ctx == ctx) {
+		armRelease();
+	}
+	__set_PRIMASK(primask);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the armed command and the last fire, disarms (d1)
+  * @note	Arm with arm P<port><pin>[edge] <command line>, see CLI_SHELL_ARM.h.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (d - disarm)
+  * @retval shell_error Error Return Value
+  */
+shell_error ArmBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 96);
+
+	if (shellHasArg(parserInput, argTkn_d) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8 != 0) {
+		uint32_t primask = __get_PRIMASK();
+
+		// The edge may come meanwhile, then it has fired and there is nothing left to disarm
+		__disable_irq();
+		if (arm.armed) {
+			armRelease();
+		}
+		__set_PRIMASK(primask);
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, "Arm: ");
+	if (arm.armed) {
+		shellStrAppendChar(&str, 'P');
+		shellStrAppendChar(&str, (char)('A' + arm.port));
+		shellStrAppendUnsigned(&str, arm.line, 0);
+		shellStrAppendChar(&str, ' ');
+		shellStrAppend(&str, armEdgeNames[arm.edge]);
+		shellStrAppend(&str, ", ");
+		shellStrAppend(&str, shellCommandName(arm.commandIndex));
+		shellStrAppend(&str, "\r\n");
+	} else {
+		shellStrAppend(&str, "not armed\r\n");
+	}
+	shellStrSend(ctx, &str);
+
+	if (arm.fires != 0) {
+		shellStrAppend(&str, "Last: ");
+		shellStrAppend(&str, shellCommandName(arm.firedIndex));
+		shellStrAppend(&str, (arm.result == SHELL_OK) ? " OK, at " : " failed, at ");
+		shellStrAppendUnsigned(&str, shellTsyncAt(arm.entryCycles), 0);
+		shellStrAppend(&str, " us, ");
+		shellStrAppendUnsigned(&str, arm.bridgeCycles - arm.entryCycles, 0);
+		shellStrAppend(&str, " cycles to the bridge, ");
+		shellStrAppendUnsigned(&str, arm.doneCycles - arm.bridgeCycles, 0);
+		shellStrAppend(&str, " in it\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
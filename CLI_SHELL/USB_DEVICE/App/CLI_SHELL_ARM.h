@@ -0,0 +1,77 @@
+/** @file CLI_SHELL_ARM.h
+ *
+ * @brief Armed commands of the CLI Shell: one command run by the edge of a trigger line, "arm"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "arm P<port><pin>[+|-|*] <command line>" arms the command line on EXTI line <pin> of port A
+ *    to C, e.g. "arm PB4 gpio p0 s0x20". The edge is + rising (default), - falling or * both.
+ *    The command is parsed, looked up and validated right away and answered like any other
+ *    line, then waits for the edge. Wire the same pin of every board to one sync line, arm
+ *    each board and drive the line: all of them run their command on the same edge.
+ *  - The edge runs the bridge from the EXTI interrupt, nothing else happens between: no line
+ *    is assembled, parsed or matched, no response is sent. Its output is dropped (the main loop
+ *    may be in the middle of its own). Only the commands of SHELL_ARM_LIST (CLI_SHELL_COMMANDS.h)
+ *    can be armed, bridges that finish on the spot and touch nothing the main loop writes
+ *    without masking interrupts. "mwr" needs its values (v), a block write waits for bytes.
+ *  - One shot: the line is released after the run and the main loop of the instance that armed
+ *    it reports "Fired: <response>, at <us> us, <cycles> cycles to the bridge". The time is the
+ *    interrupt entry on the synced clock (CLI_SHELL_TSYNC.h), compare it across boards to
+ *    check the alignment. One command is armed at a time.
+ *  - "arm" shows what is armed and the last fire, "arm d1" disarms. Ctrl-C or a break on the
+ *    instance that armed it disarms too.
+ *  - The line interrupt runs at SHELL_ARM_IRQ_PRIORITY. While armed, OTG_FS is lowered to
+ *    SHELL_ARM_USB_PRIORITY so a USB transfer cannot hold the edge back. A line whose
+ *    interrupt has lines logged by "events" (5-9 and 10-15 share one) cannot be armed, and
+ *    the other way round.
+ *  - The latency from the edge to the bridge is the interrupt entry plus shellArmFire(), which
+ *    runs from RAM (SHELL_RAMFUNC): a fixed number of cycles, "arm" shows the last one. It
+ *    varies with what the core does when the edge comes: sections that mask interrupts
+ *    (__disable_irq(), shellEventSignal()...) delay it by their length, the SysTick handler at
+ *    the same priority by its own, and a bridge in flash adds the wait states of ART misses.
+ *    The GPIO input synchronizer adds up to 2 cycles. Well below a microsecond at 100 MHz
+ *    unless a masked section is open.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_ARM_H_
+#define CLI_SHELL_ARM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_ARM_KEYWORD				"arm "		/*!< Line prefix of an armed command	*/
+#define SHELL_ARM_LINE_LEN				64			/*!< Longest armed command line			*/
+#define SHELL_ARM_IRQ_PRIORITY			0			/*!< Trigger line interrupt				*/
+#define SHELL_ARM_USB_PRIORITY			1			/*!< OTG_FS while armed					*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+extern const uint16_t shellArmTable[];		/*!< Armable command indices, ends with NUM_OF_COMMANDS	*/
+
+shell_error shellArmLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len);
+void shellArmFire(uint32_t cycles, uint32_t lines);
+void shellArmPoll(shell_ctx_t* ctx);
+void shellArmStop(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_ARM_H_
+
+/*** end of file ***/
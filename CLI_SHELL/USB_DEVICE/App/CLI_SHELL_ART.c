@@ -0,0 +1,127 @@
+/** @file CLI_SHELL_ART.c
+ *
+ * @brief Flash accelerator (ART) setup: prefetch, instruction and data cache
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ART.h"
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sets up the flash accelerator for the configured latency
+  * @note	Call after SystemClock_Config(). Without wait states the accelerator has nothing to
+  * 		hide and is left as HAL_Init() set it.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellArtInit(void) {
+	if (__HAL_FLASH_GET_LATENCY() == FLASH_LATENCY_0) {
+		return;
+	}
+
+	// Start from empty caches, they may hold lines fetched at the boot clock
+	shellArtApply(0);
+	shellArtApply(SHELL_ART_ALL);
+}
+
+/**
+  * @brief  Turns the accelerator features on or off
+  * @note	A cache can only be reset while it is off, so a cache being turned on is reset
+  * 		first and never starts with stale lines.
+  * @param[IN]  features SHELL_ART_ bits to leave on, the others are turned off
+  * @retval NONE
+  */
+void shellArtApply(uint8_t features) {
+	uint8_t current = shellArtFeatures();
+
+	if (!(features & SHELL_ART_PREFETCH)) {
+		__HAL_FLASH_PREFETCH_BUFFER_DISABLE();
+	}
+	if (!(features & SHELL_ART_ICACHE)) {
+		__HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+	}
+	if (!(features & SHELL_ART_DCACHE)) {
+		__HAL_FLASH_DATA_CACHE_DISABLE();
+	}
+
+	if ((features & SHELL_ART_ICACHE) && !(current & SHELL_ART_ICACHE)) {
+		__HAL_FLASH_INSTRUCTION_CACHE_RESET();
+		__HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+	}
+	if ((features & SHELL_ART_DCACHE) && !(current & SHELL_ART_DCACHE)) {
+		__HAL_FLASH_DATA_CACHE_RESET();
+		__HAL_FLASH_DATA_CACHE_ENABLE();
+	}
+	if (features & SHELL_ART_PREFETCH) {
+		__HAL_FLASH_PREFETCH_BUFFER_ENABLE();
+	}
+}
+
+/**
+  * @brief  Features that are on
+  * @param  NONE
+  * @retval uint8_t SHELL_ART_ bits
+  */
+uint8_t shellArtFeatures(void) {
+	uint8_t features = 0;
+
+	if (FLASH->ACR & FLASH_ACR_PRFTEN) {
+		features |= SHELL_ART_PREFETCH;
+	}
+	if (FLASH->ACR & FLASH_ACR_ICEN) {
+		features |= SHELL_ART_ICACHE;
+	}
+	if (FLASH->ACR & FLASH_ACR_DCEN) {
+		features |= SHELL_ART_DCACHE;
+	}
+	return features;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Reports and optionally changes the flash accelerator setup
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (f - SHELL_ART_ mask, optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error ArtBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 90);
+
+	if (shellHasArg(parserInput, argTkn_f)) {
+		uint8_t requested = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+		if (requested & ~SHELL_ART_ALL) {
+			return SHELL_ERR;
+		}
+		shellArtApply(requested);
+	}
+
+	uint8_t features = shellArtFeatures();
+	shellStrAppend(&str, "Flash: ");
+	shellStrAppendUnsigned(&str, __HAL_FLASH_GET_LATENCY(), 0);
+	shellStrAppend(&str, (features & SHELL_ART_PREFETCH) ? " wait states, prefetch on" : " wait states, prefetch off");
+	shellStrAppend(&str, (features & SHELL_ART_ICACHE) ? ", I-cache on" : ", I-cache off");
+	shellStrAppend(&str, (features & SHELL_ART_DCACHE) ? ", D-cache on\r\n" : ", D-cache off\r\n");
+	shellStrSend(ctx, &str);
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,46 @@
+/** @file CLI_SHELL_ART.h
+ *
+ * @brief Flash accelerator (ART) setup: prefetch, instruction and data cache
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - shellArtInit() runs after SystemClock_Config(). With wait states configured it resets and
+ *    enables both caches and enables prefetch, whatever stm32f4xx_hal_conf.h asked HAL_Init() for.
+ *  - "art" reports FLASH->ACR. "art f<mask>" turns the features on/off at runtime
+ *    (SHELL_ART_ bits), e.g. "art f0" for a measurement with the accelerator off.
+ *  - The Benchmark configuration times command dispatch with each feature off ("bench").
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_ART_H_
+#define CLI_SHELL_ART_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_ART_PREFETCH			0x01
+#define SHELL_ART_ICACHE			0x02
+#define SHELL_ART_DCACHE			0x04
+#define SHELL_ART_ALL				(SHELL_ART_PREFETCH | SHELL_ART_ICACHE | SHELL_ART_DCACHE)
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellArtInit(void);
+void shellArtApply(uint8_t features);
+uint8_t shellArtFeatures(void);
+
+#endif // CLI_SHELL_ART_H_
+
+/*** end of file ***/
@@ -0,0 +1,316 @@
+/** @file CLI_SHELL_BENCH.c
+ *
+ * @brief On-target benchmark of the CLI Shell pipeline
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Flash accelerator comparison
+ * - 1.2: 10-14-2026 (Crandell) Runs and reports on the shell instance that requested it
+ * - 1.3: 10-14-2026 (Crandell) No flash accelerator case in the host build
+ * - 1.4: 10-15-2026 (Crandell) Name buffer sized by SHELL_CMD_LEN
+ * - 1.5: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_BENCH.h"
+#include "CLI_SHELL_ART.h"
+
+#if SHELL_BENCHMARK
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static bool benchRequested = false;
+static shell_ctx_t* benchCtx = NULL;				/*!< Instance the synthetic lines go to	*/
+static uint16_t benchIterations = SHELL_BENCH_DEFAULT_ITERATIONS;
+
+/**
+  * @brief  Synthetic command lines. Cover the plain, padded, extra-argument and error paths.
+  */
+static const char* const benchLines[] = {
+	"setLed l1 s0\r",
+	"   setLed    l2     s1   \r",
+	"setLed l1 s1 q9 z7 x3\r",
+	"mode m0\r",
+	"?\r",
+	"noSuchCommand a1\r",
+};
+
+#define NUM_OF_BENCH_LINES		(sizeof(benchLines) / sizeof(benchLines[0]))
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void benchPipeline(shell_ctx_t* ctx);
+static void benchLookup(shell_ctx_t* ctx);
+#if !SHELL_HOST_BUILD
+static void benchArt(shell_ctx_t* ctx);
+#endif
+static void benchPrint(shell_ctx_t* ctx, const char* text);
+static void benchSend(shell_ctx_t* ctx, shellStr_t* str);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sends a report line
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  text NUL-terminated text
+  * @retval NONE
+  */
+static void benchPrint(shell_ctx_t* ctx, const char* text) {
+	outputStreamChannel(ctx, (const uint8_t*)text, strlen(text));
+	outputStreamFlush(ctx);
+}
+
+/**
+  * @brief  Sends a built report line
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  str Builder with the line, emptied
+  * @retval NONE
+  */
+static void benchSend(shell_ctx_t* ctx, shellStr_t* str) {
+	shellStrSend(ctx, str);
+	outputStreamFlush(ctx);
+}
+
+/**
+  * @brief  Times every synthetic line from rxShellInput() to the return of checkShellStatus()
+  * @note	The per-stage means come from the command's perf statistics, "Other" is
+  * 		everything outside of them (ring, line assembly, reply formatting).
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void benchPipeline(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 120);
+
+	benchPrint(ctx, "Pipeline (cycles/cmd)\r\nLine\t| Total\t| Cmd/s\t| Other\t| Parse\t| Match\t| Valid\t| Bridge\r\n");
+
+	for (uint8_t i = 0; i < NUM_OF_BENCH_LINES; i++) {
+		uint32_t len = strlen(benchLines[i]);
+		uint64_t stages[perfStage_count] = {0};
+		uint64_t timed = 0;
+		uint32_t timedCount = 0;
+
+		shellPerfClear();
+		ctx->outputMuted = true;
+
+		uint32_t start = shellPerfCycles();
+		for (uint16_t n = 0; n < benchIterations; n++) {
+			// The USB interrupt is the ring's only other producer
+			NVIC_DisableIRQ(OTG_FS_IRQn);
+			rxShellInput(ctx, (uint8_t*)benchLines[i], &len);
+			NVIC_EnableIRQ(OTG_FS_IRQn);
+
+			checkShellStatus(ctx);
+		}
+		uint32_t total = (shellPerfCycles() - start) / benchIterations;
+
+		ctx->outputMuted = false;
+
+		// Only the benchmarked command has statistics since the clear
+		for (uint16_t c = 0; c < shellCommandCount(); c++) {
+			const shellPerfStat_t* stat = shellPerfStats(c);
+			timed += stat->totalCycles;
+			timedCount += stat->count;
+			for (uint8_t s = 0; s < perfStage_count; s++) {
+				stages[s] += stat->stageCycles[s];
+			}
+		}
+		if (timedCount == 0) {
+			timedCount = 1;
+		}
+
+		uint32_t other = total - (uint32_t)(timed / timedCount);
+		uint32_t columns[] = {
+			total,
+			total ? (SystemCoreClock / total) : 0,
+			other,
+			(uint32_t)(stages[perfStage_parse] / timedCount),
+			(uint32_t)(stages[perfStage_match] / timedCount),
+			(uint32_t)(stages[perfStage_validate] / timedCount),
+			(uint32_t)(stages[perfStage_bridge] / timedCount),
+		};
+		shellStrAppendUnsigned(&str, i, 0);
+		for (uint8_t c = 0; c < sizeof(columns) / sizeof(columns[0]); c++) {
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, columns[c], 0);
+		}
+		shellStrAppend(&str, "\r\n");
+		benchSend(ctx, &str);
+	}
+
+	shellPerfClear();
+}
+
+/**
+  * @brief  Times the trie lookup against the linear reference for every command
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void benchLookup(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 80);
+	uint8_t nameBuffer[SHELL_CMD_LEN + 1];
+	shellParserOutput_t parserOutput;
+	int16_t commandIndex;
+
+	benchPrint(ctx, "Lookup (cycles)\r\nCommand\t| Binary\t| Linear\r\n");
+
+	for (uint16_t c = 0; c < shellCommandCount(); c++) {
+		memset(&parserOutput, 0, sizeof(parserOutput));
+		strcpy((char*)nameBuffer, shellCommandName(c));
+		parserOutput.line = nameBuffer;
+		parserOutput.cmdLen = strlen((const char*)nameBuffer);
+
+		uint32_t start = shellPerfCycles();
+		for (uint16_t n = 0; n < benchIterations; n++) {
+			matchCommand(&parserOutput, &commandIndex);
+		}
+		uint32_t binary = (shellPerfCycles() - start) / benchIterations;
+
+		start = shellPerfCycles();
+		for (uint16_t n = 0; n < benchIterations; n++) {
+			matchCommandLinear(&parserOutput, &commandIndex);
+		}
+		uint32_t linear = (shellPerfCycles() - start) / benchIterations;
+
+		shellStrAppend(&str, shellCommandName(c));
+		shellStrAppend(&str, "\t| ");
+		shellStrAppendUnsigned(&str, binary, 0);
+		shellStrAppend(&str, "\t| ");
+		shellStrAppendUnsigned(&str, linear, 0);
+		shellStrAppend(&str, "\r\n");
+		benchSend(ctx, &str);
+	}
+}
+
+#if !SHELL_HOST_BUILD
+/**
+  * @brief  Times the dispatch of the first synthetic line with each flash accelerator feature off
+  * @note	Every run starts with freshly reset caches, so the first iterations show the misses.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void benchArt(shell_ctx_t* ctx) {
+	static const uint8_t artCases[] = {
+		SHELL_ART_ALL,
+		SHELL_ART_ALL & ~SHELL_ART_PREFETCH,
+		SHELL_ART_ALL & ~SHELL_ART_ICACHE,
+		SHELL_ART_ALL & ~SHELL_ART_DCACHE,
+		0,
+	};
+	SHELL_STR_DEFINE(str, 60);
+	uint32_t len = strlen(benchLines[0]);
+	uint8_t features = shellArtFeatures();
+
+	benchPrint(ctx, "Flash accelerator (cycles/cmd)\r\nPrefetch| I-cache| D-cache| Total\r\n");
+
+	for (uint8_t i = 0; i < sizeof(artCases); i++) {
+		shellArtApply(0);
+		shellArtApply(artCases[i]);
+		ctx->outputMuted = true;
+
+		uint32_t start = shellPerfCycles();
+		for (uint16_t n = 0; n < benchIterations; n++) {
+			NVIC_DisableIRQ(OTG_FS_IRQn);
+			rxShellInput(ctx, (uint8_t*)benchLines[0], &len);
+			NVIC_EnableIRQ(OTG_FS_IRQn);
+
+			checkShellStatus(ctx);
+		}
+		uint32_t total = (shellPerfCycles() - start) / benchIterations;
+
+		ctx->outputMuted = false;
+		shellArtApply(features);
+
+		shellStrAppend(&str, (artCases[i] & SHELL_ART_PREFETCH) ? "on\t| " : "off\t| ");
+		shellStrAppend(&str, (artCases[i] & SHELL_ART_ICACHE) ? "on\t| " : "off\t| ");
+		shellStrAppend(&str, (artCases[i] & SHELL_ART_DCACHE) ? "on\t| " : "off\t| ");
+		shellStrAppendUnsigned(&str, total, 0);
+		shellStrAppend(&str, "\r\n");
+		benchSend(ctx, &str);
+	}
+
+	shellPerfClear();
+}
+#endif
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Runs a requested benchmark. Called from checkShellStatus().
+  * @note	The benchmark itself calls checkShellStatus(), so the request is cleared first.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellBenchmarkPoll(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 60);
+
+	if (!benchRequested || benchCtx != ctx) {
+		return;
+	}
+	benchRequested = false;
+
+	shellStrAppend(&str, "Benchmark: ");
+	shellStrAppendUnsigned(&str, benchIterations, 0);
+	shellStrAppend(&str, " iterations @ ");
+	shellStrAppendUnsigned(&str, SystemCoreClock, 0);
+	shellStrAppend(&str, " Hz\r\n");
+	benchSend(ctx, &str);
+
+	benchPipeline(ctx);
+	benchLookup(ctx);
+#if !SHELL_HOST_BUILD
+	benchArt(ctx);
+#endif
+
+	benchPrint(ctx, "Benchmark Done\r\n");
+}
+
+/**
+  * @brief  Requests a benchmark run once the current poll is done
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (n - iterations, optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error BenchBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	benchIterations = SHELL_BENCH_DEFAULT_ITERATIONS;
+
+	if (shellHasArg(parserInput, argTkn_n)) {
+		benchIterations = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u16;
+	}
+
+	if (benchIterations == 0) {
+		return SHELL_ERR;
+	}
+
+	benchCtx = ctx;
+	benchRequested = true;
+	return SHELL_OK;
+}
+
+#else
+
+/**
+  * @brief  Benchmark not built in this configuration
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellBenchmarkPoll(shell_ctx_t* ctx) {
+}
+
+#endif // SHELL_BENCHMARK
+
+/*** end of file ***/
@@ -0,0 +1,51 @@
+/** @file CLI_SHELL_BENCH.h
+ *
+ * @brief On-target benchmark of the CLI Shell pipeline
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Flash accelerator comparison
+ *
+ * Usage Notes:
+ *  - Only built into the "Benchmark" configuration (SHELL_BENCHMARK=1), which adds the
+ *    "bench" command. "bench n500" runs every case 500 times.
+ *  - The synthetic lines go through rxShellInput() and checkShellStatus() just like host
+ *    input, with the replies muted. Keep the host quiet until the report has been sent.
+ *  - The last table repeats the first line with each flash accelerator feature off (CLI_SHELL_ART.h).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_BENCH_H_
+#define CLI_SHELL_BENCH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_BENCHMARK
+#define SHELL_BENCHMARK					0
+#endif
+
+#define SHELL_BENCH_DEFAULT_ITERATIONS	100
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellBenchmarkPoll(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_BENCH_H_
+
+/*** end of file ***/
@@ -0,0 +1,334 @@
+/** @file CLI_SHELL_BINARY.c
+ *
+ * @brief Binary framed command protocol for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Frame state per transport port
+ * - 1.2: 10-14-2026 (Crandell) Frame state lives in the shell instance (shellBinaryState_t)
+ * - 1.3: 10-15-2026 (Crandell) Response data through the LZ encoder ("mode z1")
+ * - 1.4: 10-15-2026 (Crandell) Argument TLVs up to the frame length, validation checks the length per type
+ * - 1.5: 10-15-2026 (Crandell) Frames wait for transmit room (shellOutputReserve)
+ * - 1.6: 10-15-2026 (Crandell) A request frame ends a transmit stall
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_LZ.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define BIN_OFS_SEQ			1
+#define BIN_OFS_CMD			2
+#define BIN_OFS_LEN			4
+
+#define BIN_TLV_HEADER_LEN	2
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  CRC-16/CCITT nibble table. 32 bytes of flash, two lookups per byte.
+  */
+static const uint16_t crcNibbleTable[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void sendFrame(shell_ctx_t* ctx, uint8_t status, const uint8_t* data, uint16_t len);
+static void queueData(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+static bool decodeFrame(shell_ctx_t* ctx, shellParserOutput_t* out, uint16_t* commandIndex);
+static void processFrame(shell_ctx_t* ctx);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sends one response frame
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  status Status byte
+  * @param[IN]  data Frame data
+  * @param[IN]  len Number of data bytes (at most SHELL_BIN_MAX_DATA)
+  * @retval NONE
+  */
+static void sendFrame(shell_ctx_t* ctx, uint8_t status, const uint8_t* data, uint16_t len) {
+	shellBinaryState_t* bin = &ctx->binary;
+	uint8_t header[SHELL_BIN_RSP_HEADER_LEN] = { SHELL_BIN_SOF_RSP, bin->rspSeq, status, (uint8_t)len };
+	uint8_t crcBytes[SHELL_BIN_CRC_LEN];
+
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &header[1], SHELL_BIN_RSP_HEADER_LEN - 1);
+	crc = shellCrc16(crc, data, len);
+	crcBytes[0] = (uint8_t)crc;
+	crcBytes[1] = (uint8_t)(crc >> 8);
+
+	// A frame cut by a full transmit queue would be lost as a whole
+	shellOutputReserve(ctx, len);
+	transportWrite(ctx, header, SHELL_BIN_RSP_HEADER_LEN);
+	if (len > 0) {
+		transportWrite(ctx, data, len);
+	}
+	transportWrite(ctx, crcBytes, SHELL_BIN_CRC_LEN);
+}
+
+/**
+  * @brief  Adds data to the response, sends every full frame
+  * @note	Also the sink of the LZ encoder (CLI_SHELL_LZ.h) for packed responses.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  data Frame data, plain or packed
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+static void queueData(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	shellBinaryState_t* bin = &ctx->binary;
+	uint8_t status = SHELL_BIN_STATUS_MORE | (bin->rspPacked ? SHELL_BIN_STATUS_PACKED : 0);
+
+	while (len > 0) {
+		uint16_t chunk = SHELL_BIN_MAX_DATA - bin->rspLen;
+		if (chunk > len) {
+			chunk = len;
+		}
+
+		memcpy(&bin->rspData[bin->rspLen], data, chunk);
+		bin->rspLen += chunk;
+		data += chunk;
+		len -= chunk;
+
+		if (bin->rspLen == SHELL_BIN_MAX_DATA) {
+			sendFrame(ctx, status, bin->rspData, bin->rspLen);
+			bin->rspLen = 0;
+		}
+	}
+}
+
+/**
+  * @brief  Unpacks a verified request frame into the parser output.
+  * @note	The TLV values are copied into the shell line buffer as NUL-terminated slices. They
+  * 		stay in binary form (rawValues) and are converted without any text parsing.
+  * @param[IN]  ctx Shell instance
+  * @param[OUT] out Parser Output Structure
+  * @param[OUT]	commandIndex Requested Command Table index
+  * @retval bool Returns false if the payload is malformed or does not fit
+  */
+static bool decodeFrame(shell_ctx_t* ctx, shellParserOutput_t* out, uint16_t* commandIndex) {
+	shellBinaryState_t* bin = &ctx->binary;
+	uint8_t* line = ctx->rxBuffer;
+	uint32_t lineLen = 0;
+	uint8_t payloadLen = bin->rxFrame[BIN_OFS_LEN];
+	const uint8_t* payload = &bin->rxFrame[SHELL_BIN_REQ_HEADER_LEN];
+
+	memset(out, 0, sizeof(*out));
+	memset(out->argSlot, SHELL_ARG_NONE, sizeof(out->argSlot));
+	out->line = line;
+	out->rawValues = true;
+
+	*commandIndex = (uint16_t)bin->rxFrame[BIN_OFS_CMD] | ((uint16_t)bin->rxFrame[BIN_OFS_CMD + 1] << 8);
+
+	// Command name first, so bridges can still use shellCmdName()
+	const char* name = shellCommandName(*commandIndex);
+	if (name != NULL) {
+		uint32_t nameLen = strlen(name);
+		if (nameLen > SHELL_CMD_LEN) {
+			return false;
+		}
+		memcpy(line, name, nameLen);
+		line[nameLen] = '\0';
+		out->cmdLen = nameLen;
+		lineLen = nameLen + 1;
+	}
+
+	// Then the argument TLVs
+	uint16_t pos = 0;
+	while (pos < payloadLen) {
+		if ((payloadLen - pos) < BIN_TLV_HEADER_LEN || out->numArgs >= MAX_ARGUMENTS) {
+			return false;
+		}
+
+		uint8_t token = payload[pos];
+		uint8_t valueLen = payload[pos + 1];
+		pos += BIN_TLV_HEADER_LEN;
+
+		if (token >= argTkn_err || valueLen > (payloadLen - pos)
+				|| (lineLen + valueLen + 1) > sizeof(ctx->rxBuffer)) {
+			return false;
+		}
+
+		shellArgument_t* arg = &out->cmdArgs[out->numArgs];
+		arg->argToken = (argToken_t)token;
+		arg->argType = arg_none;
+		arg->argOffset = lineLen;
+		arg->argLen = valueLen;
+		shellIndexArg(out, out->numArgs);
+		out->numArgs++;
+
+		memcpy(&line[lineLen], &payload[pos], valueLen);
+		line[lineLen + valueLen] = '\0';
+		lineLen += valueLen + 1;
+		pos += valueLen;
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Checks and runs a complete request frame
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void processFrame(shell_ctx_t* ctx) {
+	shellBinaryState_t* bin = &ctx->binary;
+	shellParserOutput_t parserOutput;
+	uint16_t commandIndex;
+	uint16_t bodyLen = SHELL_BIN_REQ_HEADER_LEN - 1 + bin->rxFrame[BIN_OFS_LEN];
+
+	bin->rspSeq = bin->rxFrame[BIN_OFS_SEQ];
+	bin->rspLen = 0;
+	// A new request may wait for transmit room again (shellOutputReserve())
+	ctx->txStalled = false;
+
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &bin->rxFrame[1], bodyLen);
+	uint16_t rxCrc = (uint16_t)bin->rxFrame[1 + bodyLen] | ((uint16_t)bin->rxFrame[2 + bodyLen] << 8);
+	if (crc != rxCrc) {
+		shellBinaryEndResponse(ctx, RESPONSE_FRAME_ERR);
+		return;
+	}
+
+	if (!decodeFrame(ctx, &parserOutput, &commandIndex)) {
+		shellBinaryEndResponse(ctx, RESPONSE_ARG_ERR);
+		return;
+	}
+
+	shellDispatch(ctx, &parserOutput, commandIndex);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Assembles at most one request frame from the receive ring and runs it.
+  * @note	Bytes outside a frame are dropped until the next SOF. A partial frame is held
+  * 		between calls until the rest of it arrives.
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns true if a frame was processed
+  */
+bool shellBinaryPoll(shell_ctx_t* ctx) {
+	shellBinaryState_t* bin = &ctx->binary;
+	uint8_t byte;
+
+	while (shellRingGet(&ctx->rxRing, &byte)) {
+		if (bin->rxFrameLen == 0 && byte != SHELL_BIN_SOF_REQ) {
+			// Hunting for the start of a frame
+			continue;
+		}
+
+		bin->rxFrame[bin->rxFrameLen++] = byte;
+
+		if (bin->rxFrameLen >= SHELL_BIN_REQ_HEADER_LEN &&
+				bin->rxFrameLen == (SHELL_BIN_REQ_HEADER_LEN + bin->rxFrame[BIN_OFS_LEN] + SHELL_BIN_CRC_LEN)) {
+			processFrame(ctx);
+			bin->rxFrameLen = 0;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+  * @brief  Collects response output while in binary mode.
+  * @note	Full frames are sent with SHELL_BIN_STATUS_MORE, the remainder goes out with
+  * 		shellBinaryEndResponse(). With compression on, the first data of a response takes
+  * 		the encoder; if another instance holds it, this response is sent plain.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  data Output data
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellBinaryWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	shellBinaryState_t* bin = &ctx->binary;
+
+	if (!bin->rspStarted) {
+		bin->rspStarted = true;
+		bin->rspPacked = bin->compress && shellLzOpen(ctx, queueData);
+	}
+
+	if (bin->rspPacked) {
+		shellLzWrite(ctx, data, len);
+	} else {
+		queueData(ctx, data, len);
+	}
+}
+
+/**
+  * @brief  Sends the final frame of a response, carrying the response code
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  status responseCode_t of the request
+  * @retval NONE
+  */
+void shellBinaryEndResponse(shell_ctx_t* ctx, uint8_t status) {
+	shellBinaryState_t* bin = &ctx->binary;
+
+	if (bin->rspPacked) {
+		shellLzClose(ctx);
+		status |= SHELL_BIN_STATUS_PACKED;
+	}
+
+	sendFrame(ctx, status, bin->rspData, bin->rspLen);
+	bin->rspLen = 0;
+	bin->rspStarted = false;
+	bin->rspPacked = false;
+}
+
+/**
+  * @brief  Sequence number of the request being answered
+  * @param[IN]  ctx Shell instance
+  * @retval uint8_t Sequence number
+  */
+uint8_t shellBinarySeq(shell_ctx_t* ctx) {
+	return ctx->binary.rspSeq;
+}
+
+/**
+  * @brief  Switches the request that output is sent for
+  * @note	Used to answer a job's request after later requests were handled (CLI_SHELL_JOB.c).
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  seq Sequence number
+  * @retval uint8_t Previous sequence number
+  */
+uint8_t shellBinarySetSeq(shell_ctx_t* ctx, uint8_t seq) {
+	shellBinaryState_t* bin = &ctx->binary;
+	uint8_t previous = bin->rspSeq;
+	bin->rspSeq = seq;
+	return previous;
+}
+
+/**
+  * @brief  CRC-16/CCITT-FALSE (poly 0x1021, no reflection)
+  * @param[IN]  crc Running CRC (SHELL_BIN_CRC_INIT to start)
+  * @param[IN]  data Data to add
+  * @param[IN]  len Number of bytes
+  * @retval uint16_t Updated CRC
+  */
+uint16_t shellCrc16(uint16_t crc, const uint8_t* data, uint32_t len) {
+	while (len--) {
+		crc = (crc << 4) ^ crcNibbleTable[((crc >> 12) ^ (*data >> 4)) & 0x0F];
+		crc = (crc << 4) ^ crcNibbleTable[((crc >> 12) ^ (*data & 0x0F)) & 0x0F];
+		data++;
+	}
+	return crc;
+}
+
+/*** end of file ***/
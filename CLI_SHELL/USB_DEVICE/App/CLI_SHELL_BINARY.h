@@ -0,0 +1,106 @@
+/** @file CLI_SHELL_BINARY.h
+ *
+ * @brief Binary framed command protocol for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Frame state per transport port
+ * - 1.2: 10-14-2026 (Crandell) Frame state lives in the shell instance (shellBinaryState_t)
+ * - 1.3: 10-14-2026 (Crandell) Result fields as CBOR
+ * - 1.4: 10-15-2026 (Crandell) Compressed response data (SHELL_BIN_STATUS_PACKED)
+ *
+ * Usage Notes:
+ *  - Enter binary mode with the text command "mode m1". The "OK" for that command is still
+ *    sent as text; everything after it is framed. Leave with command "mode" and TLV m = 0x00.
+ *  - Request frame (host -> device):
+ *      | 0xA5 | seq | cmdIdx (2, LE) | payloadLen | payload | CRC16 (2, LE) |
+ *    payload is a list of TLVs: | token (argToken_t) | len | value |
+ *    Numeric values are little-endian and sized to the argument type (uint8/char 1,
+ *    uint16 2, uint32/float 4). Strings are sent without a NUL, flags with len 0.
+ *  - Response frame (device -> host):
+ *      | 0x5A | seq | status | dataLen | data | CRC16 (2, LE) |
+ *    status is a responseCode_t. SHELL_BIN_STATUS_MORE means more data frames follow; the
+ *    final frame of every request carries the response code. Long-running commands
+ *    (CLI_SHELL_JOB.h) answer later, other requests may be answered in between; match by seq.
+ *  - Commands that build their answer from result fields (CLI_SHELL_RESULT.h) send one CBOR map
+ *    as the response data, spread over as many frames as it takes. The others send their text.
+ *  - "mode m1 z1" also compresses the response data (CLI_SHELL_LZ.h), every frame of a packed
+ *    response has SHELL_BIN_STATUS_PACKED set. The data of all its frames together is one LZ
+ *    stream, frame boundaries fall anywhere within it.
+ *  - cmdIdx is the index into the (sorted) Command Table, see "help" for the order.
+ *  - CRC16 is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over every byte after the SOF.
+ *  - The mode is per port. Each port assembles and answers its own frames, so seq only has
+ *    to be unique per port.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_BINARY_H_
+#define CLI_SHELL_BINARY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_BIN_SOF_REQ					0xA5		/*!< Request Start Of Frame		*/
+#define SHELL_BIN_SOF_RSP					0x5A		/*!< Response Start Of Frame	*/
+#define SHELL_BIN_REQ_HEADER_LEN			5			/*!< SOF, seq, cmdIdx, payloadLen	*/
+#define SHELL_BIN_RSP_HEADER_LEN			4			/*!< SOF, seq, status, dataLen	*/
+#define SHELL_BIN_CRC_LEN					2
+#define SHELL_BIN_MAX_PAYLOAD				255
+#define SHELL_BIN_STATUS_MORE				0x80		/*!< Response continues in the next frame	*/
+#define SHELL_BIN_STATUS_PACKED				0x40		/*!< Response data is compressed		*/
+
+/**
+  * @brief  Response data carried per frame. Larger outputs are split into several frames.
+  */
+#ifndef SHELL_BIN_MAX_DATA
+#define SHELL_BIN_MAX_DATA					128
+#endif
+
+#define SHELL_BIN_CRC_INIT					0xFFFF
+
+#define SHELL_BIN_FRAME_LEN					(SHELL_BIN_REQ_HEADER_LEN + SHELL_BIN_MAX_PAYLOAD + SHELL_BIN_CRC_LEN)
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Frame state of one shell instance (shell_ctx_t.binary)
+  */
+typedef struct {
+	uint8_t rxFrame[SHELL_BIN_FRAME_LEN];	/*!< Request being assembled			*/
+	uint16_t rxFrameLen;					/*!< Bytes of rxFrame received so far	*/
+
+	uint8_t rspSeq;							/*!< Sequence number of the request being answered	*/
+	uint8_t rspData[SHELL_BIN_MAX_DATA];	/*!< Response data not yet framed		*/
+	uint16_t rspLen;
+
+	bool compress;							/*!< Pack response data ("mode z1")		*/
+	bool rspStarted;						/*!< Data of the current response was written	*/
+	bool rspPacked;							/*!< The current response goes through the encoder	*/
+} shellBinaryState_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellBinaryPoll(shell_ctx_t* ctx);
+void shellBinaryWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+void shellBinaryEndResponse(shell_ctx_t* ctx, uint8_t status);
+uint8_t shellBinarySeq(shell_ctx_t* ctx);
+uint8_t shellBinarySetSeq(shell_ctx_t* ctx, uint8_t seq);
+
+uint16_t shellCrc16(uint16_t crc, const uint8_t* data, uint32_t len);
+
+#endif // CLI_SHELL_BINARY_H_
+
+/*** end of file ***/
@@ -0,0 +1,123 @@
+/** @file CLI_SHELL_BOOT.c
+ *
+ * @brief Boot time stamps of the CLI Shell, the "boot" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BOOT.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+shellBootTimes_t shellBootTimes;
+
+/**
+  * @brief  Read by Reset_Handler, 0 skips the RAM paint
+  */
+const uint8_t shellBootPaint = !SHELL_FAST_BOOT;
+
+static const char* const bootStageNames[bootStage_count] = {
+	[bootStage_data]		= "data",
+	[bootStage_bss]			= "bss",
+	[bootStage_paint]		= "paint",
+	[bootStage_main]		= "main",
+	[bootStage_hal]			= "hal",
+	[bootStage_clock]		= "clock",
+	[bootStage_periph]		= "periph",
+	[bootStage_shell]		= "shell",
+	[bootStage_loop]		= "loop",
+	[bootStage_usbReset]	= "usbReset",
+	[bootStage_usbConfig]	= "usbConfig",
+	[bootStage_command]		= "command",
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static int8_t nextStage(uint32_t after, bool first);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Finds the recorded stage that completed next
+  * @param[IN]  after Cycles of the previous stage
+  * @param[IN]  first Looking for the first stage (after is ignored)
+  * @retval int8_t Stage, -1 if none is left
+  */
+static int8_t nextStage(uint32_t after, bool first) {
+	int8_t next = -1;
+
+	for (uint8_t stage = 0; stage < bootStage_count; stage++) {
+		uint32_t cycles = shellBootTimes.cycles[stage];
+
+		if ((shellBootTimes.recorded & (1UL << stage)) == 0 || (!first && cycles <= after)) {
+			continue;
+		}
+		if (next < 0 || cycles < shellBootTimes.cycles[next]) {
+			next = (int8_t)stage;
+		}
+	}
+	return next;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Lists the boot stages with their time and the time since reset
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error BootBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 64);
+	uint32_t prevCycles = 0;
+	uint32_t prevClock = HSI_VALUE;
+	uint64_t totalNs = 0;
+	bool first = true;
+
+	shellStrAppend(&str, SHELL_FAST_BOOT ? "Boot (fast)\r\n" : "Boot\r\n");
+	shellStrAppend(&str, "Stage\t\tus\tSince reset us\r\n");
+	shellStrSend(ctx, &str);
+
+	for (int8_t stage = nextStage(0, true); stage >= 0; stage = nextStage(prevCycles, false)) {
+		uint32_t cycles = shellBootTimes.cycles[stage];
+		uint64_t stageNs = ((uint64_t)(cycles - prevCycles) * 1000000000ULL) / prevClock;
+
+		totalNs += stageNs;
+		shellStrAppend(&str, bootStageNames[stage]);
+		shellStrAppend(&str, (strlen(bootStageNames[stage]) >= 8) ? "\t" : "\t\t");
+		shellStrAppendUnsigned(&str, (uint32_t)(stageNs / 1000U), 0);
+		shellStrAppendChar(&str, '\t');
+		shellStrAppendUnsigned(&str, (uint32_t)(totalNs / 1000U), 0);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+
+		prevCycles = cycles;
+		prevClock = (shellBootTimes.clock[stage] != 0) ? shellBootTimes.clock[stage] : HSI_VALUE;
+		first = false;
+	}
+
+	if (first) {
+		shellStrAppend(&str, "No stamps\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
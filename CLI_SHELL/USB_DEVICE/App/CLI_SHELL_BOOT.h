@@ -0,0 +1,111 @@
+/** @file CLI_SHELL_BOOT.h
+ *
+ * @brief Boot time stamps of the CLI Shell, the "boot" command and the fast boot option
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Reset_Handler (startup_stm32f411retx.s) starts the DWT cycle counter first thing and stamps
+ *    the end of the .data copy, the .bss zero fill and the RAM paint. main() stamps its stages
+ *    with shellBootStamp(), the USB stack the first bus reset and the configuration, the shell
+ *    the first command. Every stage is stamped once per boot.
+ *  - "boot" lists the stages in the order they completed with the time of each and the time
+ *    since reset. The cycles of a stage are converted with the clock it started at (HSI up to
+ *    SystemClock_Config()). The counter wraps after ~44 s at 96 MHz, a first command later than
+ *    that shows a wrong time.
+ *  - SHELL_FAST_BOOT=1 shortens the path to the first command:
+ *      - the startup code skips painting the free RAM (several ms at 16 MHz). "mem" then has no
+ *        stack peak until "mem r1" paints.
+ *      - the HSE crystal is switched on at the top of main(), it starts up while HAL_Init()
+ *        runs. SystemClock_Config() then only waits for the PLL.
+ *      - the shell instances and the USART are ready before MX_USB_DEVICE_Init(), which spends
+ *        50 ms in the forced device mode delay of the USB core. The USB init itself needs the
+ *        48 MHz PLL output, so it cannot overlap the PLL lock.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_BOOT_H_
+#define CLI_SHELL_BOOT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_PERF.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_FAST_BOOT
+#define SHELL_FAST_BOOT				0
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Boot stages, each stamped when it completes
+  */
+typedef enum {
+	bootStage_data = 0,						/*!< .data copied (startup code)			*/
+	bootStage_bss,							/*!< .bss zeroed (startup code)				*/
+	bootStage_paint,						/*!< Free RAM painted (startup code)		*/
+	bootStage_main,							/*!< SystemInit(), constructors, main()		*/
+	bootStage_hal,							/*!< HAL_Init()								*/
+	bootStage_clock,						/*!< SystemClock_Config(): HSE, PLL lock	*/
+	bootStage_periph,						/*!< ART, GPIO, MX_USB_DEVICE_Init()		*/
+	bootStage_shell,						/*!< Shell instances, USART					*/
+	bootStage_loop,							/*!< Main loop reached						*/
+	bootStage_usbReset,						/*!< First bus reset from the host			*/
+	bootStage_usbConfig,					/*!< Configuration set, CDC port open		*/
+	bootStage_command,						/*!< First command dispatched				*/
+	bootStage_count
+} shellBootStage_t;
+
+/**
+  * @brief  Stamps of one boot
+  * @note	Reset_Handler stores recorded and the first three cycles, keep the layout.
+  */
+typedef struct {
+	uint32_t recorded;						/*!< Bit per stamped stage					*/
+	uint32_t cycles[bootStage_count];		/*!< DWT->CYCCNT since reset				*/
+	uint32_t clock[bootStage_count];		/*!< SystemCoreClock at the stamp, 0 = HSI	*/
+} shellBootTimes_t;
+
+extern shellBootTimes_t shellBootTimes;
+extern const uint8_t shellBootPaint;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+/**
+  * @brief  Stamps a stage, the first call per boot counts
+  * @note	Interrupt safe, the USB stages are stamped from the OTG_FS interrupt.
+  * @param[IN]  stage shellBootStage_t
+  * @retval NONE
+  */
+static inline void shellBootStamp(uint8_t stage) {
+	if (shellBootTimes.recorded & (1UL << stage)) {
+		return;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	shellBootTimes.cycles[stage] = shellPerfCycles();
+	shellBootTimes.clock[stage] = SystemCoreClock;
+	shellBootTimes.recorded |= 1UL << stage;
+
+	__set_PRIMASK(primask);
+}
+
+#endif // CLI_SHELL_BOOT_H_
+
+/*** end of file ***/
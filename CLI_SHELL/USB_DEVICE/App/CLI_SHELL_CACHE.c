@@ -0,0 +1,306 @@
+/** @file CLI_SHELL_CACHE.c
+ *
+ * @brief Response cache of the CLI Shell: repeated queries answered without running their bridge
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_CACHE.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A kept response, or the one being recorded (cache.slot)
+  */
+typedef struct {
+	bool valid;
+	uint16_t commandIndex;
+	uint8_t mode;							/*!< Session mode, text and binary data differ	*/
+	uint8_t keyLen;
+	uint8_t key[SHELL_CACHE_KEY_LEN];		/*!< Arguments: token, length, contents		*/
+	uint32_t generation;					/*!< cache.generation when the bridge started	*/
+	uint32_t lastUse;
+	uint16_t dataLen;
+	uint8_t data[SHELL_CACHE_DATA_LEN];
+} shellCacheEntry_t;
+
+/**
+  * @brief  Entries and the recording in progress
+  */
+typedef struct {
+	shellCacheEntry_t entries[SHELL_CACHE_ENTRIES];
+	volatile uint32_t generation;			/*!< Incremented by shellCacheInvalidate()	*/
+	uint32_t useClock;						/*!< Orders the entries by last use			*/
+
+	shell_ctx_t* owner;						/*!< Instance being recorded, NULL if none	*/
+	shellCacheEntry_t* slot;				/*!< Entry being filled, not valid until kept	*/
+	bool recording;							/*!< Output goes into slot right now		*/
+	bool spoiled;							/*!< Too long or skipped, do not keep		*/
+} shellCache_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellCache_t cache;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool cacheable(uint16_t commandIndex);
+static bool cacheKey(const shellParserOutput_t* cmdParserOutput, uint8_t* key, uint8_t* keyLen);
+static shellCacheEntry_t* cacheFind(shell_ctx_t* ctx, uint16_t commandIndex, const uint8_t* key, uint8_t keyLen);
+static shellCacheEntry_t* cacheVictim(void);
+static void cacheDrop(void);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Whether a command is on SHELL_CACHE_LIST
+  * @param[IN]  commandIndex Index of the command within the Command Table
+  * @retval bool Returns true if its responses may be kept
+  */
+static bool cacheable(uint16_t commandIndex) {
+	for (const uint16_t* command = shellCacheTable; *command < shellCommandCount(); command++) {
+		if (*command == commandIndex) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+  * @brief  Builds the key of a request from its arguments
+  * @note	Token order, so "crc a0 n4" and "crc n4 a0" share an entry. The contents are taken as
+  * 		sent, text and raw binary values never meet (the mode is part of the entry).
+  * @param[IN]  cmdParserOutput Parser Output Structure of the request
+  * @param[OUT]  key SHELL_CACHE_KEY_LEN bytes
+  * @param[OUT]  keyLen Length of the key
+  * @retval bool Returns false if the arguments do not fit
+  */
+static bool cacheKey(const shellParserOutput_t* cmdParserOutput, uint8_t* key, uint8_t* keyLen) {
+	uint8_t len = 0;
+
+	for (uint8_t token = 0; token < argTkn_err; token++) {
+		if (!shellHasArg(cmdParserOutput, token)) {
+			continue;
+		}
+		const shellArgument_t* arg = &cmdParserOutput->cmdArgs[shellFindArg(cmdParserOutput, token)];
+
+		if (len + 2 + arg->argLen > SHELL_CACHE_KEY_LEN) {
+			return false;
+		}
+		key[len++] = token;
+		key[len++] = arg->argLen;
+		memcpy(&key[len], &cmdParserOutput->line[arg->argOffset], arg->argLen);
+		len += arg->argLen;
+	}
+
+	*keyLen = len;
+	return true;
+}
+
+/**
+  * @brief  Looks up a kept response that is still current
+  * @param[IN]  ctx Shell instance of the request
+  * @param[IN]  commandIndex Index of the command within the Command Table
+  * @param[IN]  key Key of the request (cacheKey())
+  * @param[IN]  keyLen Length of the key
+  * @retval shellCacheEntry_t* Entry, NULL if none
+  */
+static shellCacheEntry_t* cacheFind(shell_ctx_t* ctx, uint16_t commandIndex, const uint8_t* key, uint8_t keyLen) {
+	for (uint8_t i = 0; i < SHELL_CACHE_ENTRIES; i++) {
+		shellCacheEntry_t* entry = &cache.entries[i];
+
+		if (entry->valid && entry->generation == cache.generation && entry->commandIndex == commandIndex &&
+				entry->mode == ctx->mode && entry->keyLen == keyLen && memcmp(entry->key, key, keyLen) == 0) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/**
+  * @brief  Picks the entry a new response goes into: a free or stale one, else the least recently used
+  * @param  NONE
+  * @retval shellCacheEntry_t* Entry
+  */
+static shellCacheEntry_t* cacheVictim(void) {
+	shellCacheEntry_t* victim = &cache.entries[0];
+
+	for (uint8_t i = 0; i < SHELL_CACHE_ENTRIES; i++) {
+		shellCacheEntry_t* entry = &cache.entries[i];
+
+		if (!entry->valid || entry->generation != cache.generation) {
+			return entry;
+		}
+		if ((int32_t)(entry->lastUse - victim->lastUse) < 0) {
+			victim = entry;
+		}
+	}
+	return victim;
+}
+
+/**
+  * @brief  Ends the recording without keeping it
+  * @param  NONE
+  * @retval NONE
+  */
+static void cacheDrop(void) {
+	cache.owner = NULL;
+	cache.slot = NULL;
+	cache.recording = false;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Answers a request from the cache, or starts recording its response
+  * @note	Called by shellDispatch() once the arguments are validated. On a hit the kept data is
+  * 		sent, the caller sends RESPONSE_OK instead of running the bridge.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  cmdParserOutput Parser Output Structure of the request
+  * @param[IN]  commandIndex Index of the command within the Command Table
+  * @retval bool Returns true if the request was answered from the cache
+  */
+bool shellCacheBegin(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t commandIndex) {
+	uint8_t key[SHELL_CACHE_KEY_LEN];
+	uint8_t keyLen;
+
+	// A new command on the recorded instance, the recorded one has given its output
+	if (cache.owner == ctx) {
+		cacheDrop();
+	}
+
+	if (ctx->outputMuted || !cacheable(commandIndex) || !cacheKey(cmdParserOutput, key, &keyLen)) {
+		return false;
+	}
+
+	shellCacheEntry_t* entry = cacheFind(ctx, commandIndex, key, keyLen);
+	if (entry != NULL) {
+		entry->lastUse = ++cache.useClock;
+		shellOutputReserve(ctx, entry->dataLen);
+		shellOutputWrite(ctx, entry->data, entry->dataLen);
+		return true;
+	}
+
+	if (cache.owner != NULL) {
+		return false;
+	}
+
+	shellCacheEntry_t* slot = cacheVictim();
+	slot->valid = false;
+	slot->commandIndex = commandIndex;
+	slot->mode = ctx->mode;
+	slot->keyLen = keyLen;
+	memcpy(slot->key, key, keyLen);
+	slot->generation = cache.generation;
+	slot->dataLen = 0;
+
+	cache.owner = ctx;
+	cache.slot = slot;
+	cache.recording = true;
+	cache.spoiled = false;
+	return false;
+}
+
+/**
+  * @brief  Records response data on its way to the transport
+  * @note	Called by shellOutputWrite() for every write.
+  * @param[IN]  ctx Shell instance writing
+  * @param[IN]  data Response data
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellCacheRecord(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	if (!cache.recording || cache.owner != ctx || cache.spoiled) {
+		return;
+	}
+
+	shellCacheEntry_t* slot = cache.slot;
+	if (slot->dataLen + len > SHELL_CACHE_DATA_LEN) {
+		cache.spoiled = true;
+		return;
+	}
+	memcpy(&slot->data[slot->dataLen], data, len);
+	slot->dataLen += len;
+}
+
+/**
+  * @brief  Stops recording until the job of the command runs its next step
+  * @note	Called once the bridge has returned and after every job step.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellCacheHold(shell_ctx_t* ctx) {
+	if (cache.owner == ctx) {
+		cache.recording = false;
+	}
+}
+
+/**
+  * @brief  Records again, a step of the job of the command runs
+  * @param[IN]  ctx Shell instance of the job
+  * @retval NONE
+  */
+void shellCacheResume(shell_ctx_t* ctx) {
+	if (cache.owner == ctx) {
+		cache.recording = true;
+	}
+}
+
+/**
+  * @brief  Keeps the recorded response if the command succeeded
+  * @note	Called by shellSendResponse(), for every response of the instance.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  code Response code (responseCode_t)
+  * @retval NONE
+  */
+void shellCacheEnd(shell_ctx_t* ctx, uint8_t code) {
+	if (cache.owner != ctx) {
+		return;
+	}
+
+	if (code == RESPONSE_OK && !cache.spoiled) {
+		cache.slot->valid = true;
+		cache.slot->lastUse = ++cache.useClock;
+	}
+	cacheDrop();
+}
+
+/**
+  * @brief  Keeps the response of the running command out of the cache
+  * @param[IN]  ctx Shell instance of the command
+  * @retval NONE
+  */
+void shellCacheSkip(shell_ctx_t* ctx) {
+	if (cache.owner == ctx) {
+		cache.spoiled = true;
+	}
+}
+
+/**
+  * @brief  Makes every kept response stale, what they report may have changed
+  * @note	Interrupt safe.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellCacheInvalidate(void) {
+	cache.generation++;
+}
+
+/*** end of file ***/
@@ -0,0 +1,70 @@
+/** @file CLI_SHELL_CACHE.h
+ *
+ * @brief Response cache of the CLI Shell: repeated queries answered without running their bridge
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The commands of SHELL_CACHE_LIST (CLI_SHELL_COMMANDS.h) are cacheable: their response only
+ *    depends on the arguments and on state that changes through shellCacheInvalidate(). The
+ *    output of such a command is recorded on its way to the transport. When it ends with
+ *    RESPONSE_OK, it is kept in one of SHELL_CACHE_ENTRIES entries, keyed by the command, the
+ *    session mode and the arguments as they were sent (in token order).
+ *  - The same request later is answered from the entry, the bridge is not run. The response gets
+ *    the tag, binary seq and compression of the new request, only the data is replayed.
+ *  - shellCacheInvalidate() makes every entry stale. Code that changes what a cacheable command
+ *    reports calls it: the flash queue and the blocking flash routines after every erase or
+ *    program (flash contents, settings). It is a counter increment, interrupt safe.
+ *  - Jobs are recorded while their steps run (shellJobPoll()), the response is kept once the job
+ *    answers. Output of other commands, watch samples or periodic commands in between is not
+ *    recorded, a command dispatched on the same instance meanwhile ends the recording.
+ *  - A bridge calls shellCacheSkip() when this one response must not be kept ("crc" of RAM).
+ *    Responses longer than SHELL_CACHE_DATA_LEN or with arguments longer than
+ *    SHELL_CACHE_KEY_LEN are not kept either. The least recently used entry makes room.
+ *  - One recording at a time across instances. A cacheable command that starts while another
+ *    instance's response is recorded runs as usual and is not kept.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CACHE_H_
+#define CLI_SHELL_CACHE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_CACHE_ENTRIES				4			/*!< Responses kept							*/
+#define SHELL_CACHE_DATA_LEN			128			/*!< Longest response data kept				*/
+#define SHELL_CACHE_KEY_LEN				24			/*!< Longest argument key					*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef struct shellParserOutputTypeDef	shellParserOutput_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+extern const uint16_t shellCacheTable[];	/*!< Cacheable command indices, ends with NUM_OF_COMMANDS	*/
+
+bool shellCacheBegin(shell_ctx_t* ctx, shellParserOutput_t* cmdParserOutput, uint16_t commandIndex);
+void shellCacheRecord(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+void shellCacheHold(shell_ctx_t* ctx);
+void shellCacheResume(shell_ctx_t* ctx);
+void shellCacheEnd(shell_ctx_t* ctx, uint8_t code);
+void shellCacheSkip(shell_ctx_t* ctx);
+void shellCacheInvalidate(void);
+
+#endif // CLI_SHELL_CACHE_H_
+
+/*** end of file ***/
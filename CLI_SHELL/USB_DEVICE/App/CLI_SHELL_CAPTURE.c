@@ -0,0 +1,616 @@
+/** @file CLI_SHELL_CAPTURE.c
+ *
+ * @brief Input capture for the CLI Shell: TIM5 capture DMA, background statistics and "capture"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Period dump by CLI_SHELL_FORMAT
+ * - 1.2: 10-14-2026 (Crandell) Buffer halves signal the main loop
+ * - 1.3: 10-14-2026 (Crandell) Handlers profiled (CLI_SHELL_ISR)
+ * - 1.4: 10-15-2026 (Crandell) Synced time of each dumped period (CLI_SHELL_TSYNC)
+ * - 1.5: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_CAPTURE.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define CAPTURE_TIMER			TIM5
+#define CAPTURE_GPIO_PORT		GPIOA
+#define CAPTURE_GPIO_PIN		GPIO_PIN_0
+#define CAPTURE_GPIO_AF			GPIO_AF2_TIM5
+
+#define CAPTURE_RISE_STREAM		DMA1_Stream2
+#define CAPTURE_RISE_IRQn		DMA1_Stream2_IRQn
+#define CAPTURE_FALL_STREAM		DMA1_Stream4
+#define CAPTURE_FALL_IRQn		DMA1_Stream4_IRQn
+#define CAPTURE_DMA_CHANNEL		DMA_CHANNEL_6
+
+#define CAPTURE_HALF			(SHELL_CAPTURE_BUF_LEN / 2)
+#define CAPTURE_GUARD			8			/*!< Entries the DMA may be writing while read	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Timestamps of one edge, filled by its DMA stream
+  */
+typedef struct {
+	DMA_HandleTypeDef dma;
+	uint32_t buffer[SHELL_CAPTURE_BUF_LEN];
+	volatile uint32_t halves;				/*!< Half buffers written (half/full transfer)	*/
+	uint32_t read;							/*!< Timestamps processed					*/
+	uint32_t edges;							/*!< Timestamps captured up to the last poll	*/
+} captureStream_t;
+
+/**
+  * @brief  One measured period
+  */
+typedef struct {
+	uint32_t period;						/*!< Rise to rise (ticks)					*/
+	uint32_t high;							/*!< Rise to fall (ticks), 0 if not seen	*/
+	uint32_t end;							/*!< Counter at the rise that ended it		*/
+} capturePeriod_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static TIM_HandleTypeDef captureTimer;
+static captureStream_t rise;
+static captureStream_t fall;
+
+/**
+  * @brief  Statistics since the start, owned by shellCapturePoll()
+  */
+static struct {
+	bool running;
+	bool dmaError;
+	uint8_t filter;
+	uint32_t timerClock;					/*!< Counter frequency (Hz)					*/
+
+	bool haveRise;							/*!< lastRise starts a period				*/
+	uint32_t lastRise;
+	uint32_t high;							/*!< High time of the open period (0 none)	*/
+
+	uint32_t lost;							/*!< Edges overwritten before processing	*/
+	uint32_t periods;
+	uint64_t periodSum;
+	uint32_t periodMin;
+	uint32_t periodMax;
+	uint64_t dutyPeriodSum;					/*!< Periods with a high time				*/
+	uint64_t highSum;
+	uint32_t histogram[SHELL_CAPTURE_HIST_BINS];
+
+	capturePeriod_t recent[SHELL_CAPTURE_DUMP_LEN];
+	uint8_t recentNext;
+
+	uint32_t refTicks;						/*!< Counter and synced time read together	*/
+	uint32_t refUs;							/*!< at the last poll (CLI_SHELL_TSYNC.h)	*/
+} capture;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t captureTimerClock(void);
+static bool captureDmaInit(captureStream_t* stream, DMA_Stream_TypeDef* instance, volatile uint32_t* ccr);
+static void captureDmaHalf(DMA_HandleTypeDef* hdma);
+static void captureDmaError(DMA_HandleTypeDef* hdma);
+static uint32_t captureWritten(captureStream_t* stream);
+static void captureReset(void);
+static void captureRecord(uint32_t period, uint32_t high, uint32_t end);
+static void capturePrint(shell_ctx_t* ctx, const char* text);
+static void captureSend(shell_ctx_t* ctx, shellStr_t* str);
+static uint32_t captureNs(uint64_t ticks);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Counter clock of TIM5
+  * @note	The APB1 timers run at twice PCLK1 whenever the APB1 prescaler divides.
+  * @param  NONE
+  * @retval uint32_t Frequency (Hz)
+  */
+static uint32_t captureTimerClock(void) {
+	uint32_t timerClock = HAL_RCC_GetPCLK1Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		timerClock *= 2;
+	}
+	return timerClock;
+}
+
+/**
+  * @brief  Sets up and starts the circular DMA of one capture channel
+  * @param[IN]  stream Edge the stream fills
+  * @param[IN]  instance DMA1 stream
+  * @param[IN]  ccr Capture register of the channel
+  * @retval bool Returns false if the stream could not be started
+  */
+static bool captureDmaInit(captureStream_t* stream, DMA_Stream_TypeDef* instance, volatile uint32_t* ccr) {
+	stream->dma.Instance = instance;
+	stream->dma.Init.Channel = CAPTURE_DMA_CHANNEL;
+	stream->dma.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	stream->dma.Init.PeriphInc = DMA_PINC_DISABLE;
+	stream->dma.Init.MemInc = DMA_MINC_ENABLE;
+	stream->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	stream->dma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	stream->dma.Init.Mode = DMA_CIRCULAR;
+	stream->dma.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+	stream->dma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+	if (HAL_DMA_Init(&stream->dma) != HAL_OK) {
+		return false;
+	}
+
+	// HAL_DMA_Init() clears the callbacks
+	stream->dma.XferHalfCpltCallback = captureDmaHalf;
+	stream->dma.XferCpltCallback = captureDmaHalf;
+	stream->dma.XferErrorCallback = captureDmaError;
+
+	stream->halves = 0;
+	stream->read = 0;
+	stream->edges = 0;
+	return HAL_DMA_Start_IT(&stream->dma, (uint32_t)ccr, (uint32_t)stream->buffer, SHELL_CAPTURE_BUF_LEN) == HAL_OK;
+}
+
+/**
+  * @brief  Half and full transfer of a capture stream, one more half of the buffer written
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void captureDmaHalf(DMA_HandleTypeDef* hdma) {
+	captureStream_t* stream = (hdma == &rise.dma) ? &rise : &fall;
+	stream->halves++;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/**
+  * @brief  Transfer error of a capture stream, the HAL has stopped it
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void captureDmaError(DMA_HandleTypeDef* hdma) {
+	capture.dmaError = true;
+}
+
+/**
+  * @brief  Timestamps a stream has written since the start
+  * @note	The half count and the DMA position are read without locking. A position already in
+  * 		the next half while its interrupt is pending only counts up to the end of the half.
+  * @param[IN]  stream Edge
+  * @retval uint32_t Timestamps written
+  */
+static uint32_t captureWritten(captureStream_t* stream) {
+	uint32_t halves = stream->halves;
+	uint32_t position = SHELL_CAPTURE_BUF_LEN - __HAL_DMA_GET_COUNTER(&stream->dma);
+	uint32_t offset = (position - ((halves & 1) ? CAPTURE_HALF : 0)) % SHELL_CAPTURE_BUF_LEN;
+
+	if (offset > CAPTURE_HALF) {
+		offset = CAPTURE_HALF;
+	}
+	return (halves * CAPTURE_HALF) + offset;
+}
+
+/**
+  * @brief  Clears the statistics, the next rising edge starts the first period
+  * @param  NONE
+  * @retval NONE
+  */
+static void captureReset(void) {
+	capture.haveRise = false;
+	capture.high = 0;
+	capture.lost = 0;
+	capture.periods = 0;
+	capture.periodSum = 0;
+	capture.periodMin = UINT32_MAX;
+	capture.periodMax = 0;
+	capture.dutyPeriodSum = 0;
+	capture.highSum = 0;
+	memset(capture.histogram, 0, sizeof(capture.histogram));
+	memset(capture.recent, 0, sizeof(capture.recent));
+	capture.recentNext = 0;
+	capture.timerClock = captureTimerClock();
+}
+
+/**
+  * @brief  Adds a complete period to the statistics
+  * @param[IN]  period Rise to rise (ticks)
+  * @param[IN]  high Rise to fall (ticks), 0 if the fall was not seen
+  * @param[IN]  end Counter at the rise that ended the period
+  * @retval NONE
+  */
+static void captureRecord(uint32_t period, uint32_t high, uint32_t end) {
+	if (period == 0) {
+		return;
+	}
+
+	capture.periods++;
+	capture.periodSum += period;
+	if (period < capture.periodMin) {
+		capture.periodMin = period;
+	}
+	if (period > capture.periodMax) {
+		capture.periodMax = period;
+	}
+	if (high != 0) {
+		capture.dutyPeriodSum += period;
+		capture.highSum += high;
+	}
+	capture.histogram[31 - __builtin_clz(period)]++;
+
+	capture.recent[capture.recentNext].period = period;
+	capture.recent[capture.recentNext].high = high;
+	capture.recent[capture.recentNext].end = end;
+	capture.recentNext = (capture.recentNext + 1) % SHELL_CAPTURE_DUMP_LEN;
+}
+
+/**
+  * @brief  Sends a report line once there is room for it
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  text NUL-terminated text
+  * @retval NONE
+  */
+static void capturePrint(shell_ctx_t* ctx, const char* text) {
+	if (shellOutputReserve(ctx, strlen(text))) {
+		outputStreamChannel(ctx, (const uint8_t*)text, strlen(text));
+	}
+}
+
+/**
+  * @brief  Sends a built report line once there is room for it
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  str Builder with the line, emptied
+  * @retval NONE
+  */
+static void captureSend(shell_ctx_t* ctx, shellStr_t* str) {
+	if (shellOutputReserve(ctx, str->len)) {
+		shellStrSend(ctx, str);
+	} else {
+		str->len = 0;
+		str->truncated = false;
+	}
+}
+
+/**
+  * @brief  Converts timer ticks to nanoseconds
+  * @param[IN]  ticks Ticks of the capture clock
+  * @retval uint32_t Nanoseconds (saturated)
+  */
+static uint32_t captureNs(uint64_t ticks) {
+	uint64_t ns = (ticks * 1000000000ULL) / capture.timerClock;
+	return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts capturing PA0, the statistics start over
+  * @param[IN]  filter Input filter (IC1F/IC2F, 0 to 15)
+  * @retval bool Returns false if the filter is out of range or a DMA stream could not be started
+  */
+bool shellCaptureStart(uint8_t filter) {
+	GPIO_InitTypeDef gpioInit = {0};
+	TIM_IC_InitTypeDef icInit = {0};
+
+	if (filter > 15) {
+		return false;
+	}
+	shellCaptureStop();
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_TIM5_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	gpioInit.Pin = CAPTURE_GPIO_PIN;
+	gpioInit.Mode = GPIO_MODE_AF_PP;
+	gpioInit.Pull = GPIO_NOPULL;
+	gpioInit.Speed = GPIO_SPEED_FREQ_LOW;
+	gpioInit.Alternate = CAPTURE_GPIO_AF;
+	HAL_GPIO_Init(CAPTURE_GPIO_PORT, &gpioInit);
+
+	// Free running 32-bit counter at the timer clock
+	captureTimer.Instance = CAPTURE_TIMER;
+	captureTimer.Init.Prescaler = 0;
+	captureTimer.Init.CounterMode = TIM_COUNTERMODE_UP;
+	captureTimer.Init.Period = 0xFFFFFFFFU;
+	captureTimer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	captureTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+	if (HAL_TIM_IC_Init(&captureTimer) != HAL_OK) {
+		return false;
+	}
+
+	// Channel 1 rising edges of TI1, channel 2 falling edges of the same input
+	icInit.ICPolarity = TIM_ICPOLARITY_RISING;
+	icInit.ICSelection = TIM_ICSELECTION_DIRECTTI;
+	icInit.ICPrescaler = TIM_ICPSC_DIV1;
+	icInit.ICFilter = filter;
+	HAL_TIM_IC_ConfigChannel(&captureTimer, &icInit, TIM_CHANNEL_1);
+	icInit.ICPolarity = TIM_ICPOLARITY_FALLING;
+	icInit.ICSelection = TIM_ICSELECTION_INDIRECTTI;
+	HAL_TIM_IC_ConfigChannel(&captureTimer, &icInit, TIM_CHANNEL_2);
+
+	capture.dmaError = false;
+	if (!captureDmaInit(&rise, CAPTURE_RISE_STREAM, &CAPTURE_TIMER->CCR1) ||
+			!captureDmaInit(&fall, CAPTURE_FALL_STREAM, &CAPTURE_TIMER->CCR2)) {
+		shellCaptureStop();
+		return false;
+	}
+
+	HAL_NVIC_SetPriority(CAPTURE_RISE_IRQn, SHELL_CAPTURE_IRQ_PRIORITY, 0);
+	HAL_NVIC_SetPriority(CAPTURE_FALL_IRQn, SHELL_CAPTURE_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(CAPTURE_RISE_IRQn);
+	HAL_NVIC_EnableIRQ(CAPTURE_FALL_IRQn);
+
+	captureReset();
+	capture.filter = filter;
+	capture.running = true;
+
+	__HAL_TIM_ENABLE_DMA(&captureTimer, TIM_DMA_CC1 | TIM_DMA_CC2);
+	HAL_TIM_IC_Start(&captureTimer, TIM_CHANNEL_1);
+	HAL_TIM_IC_Start(&captureTimer, TIM_CHANNEL_2);
+	return true;
+}
+
+/**
+  * @brief  Stops capturing, the statistics are kept
+  * @param  NONE
+  * @retval NONE
+  */
+void shellCaptureStop(void) {
+	if (!capture.running && captureTimer.Instance == NULL) {
+		return;
+	}
+
+	HAL_TIM_IC_Stop(&captureTimer, TIM_CHANNEL_1);
+	HAL_TIM_IC_Stop(&captureTimer, TIM_CHANNEL_2);
+	__HAL_TIM_DISABLE_DMA(&captureTimer, TIM_DMA_CC1 | TIM_DMA_CC2);
+	HAL_NVIC_DisableIRQ(CAPTURE_RISE_IRQn);
+	HAL_NVIC_DisableIRQ(CAPTURE_FALL_IRQn);
+	HAL_DMA_Abort(&rise.dma);
+	HAL_DMA_Abort(&fall.dma);
+	capture.running = false;
+}
+
+/**
+  * @brief  Works through the new timestamps
+  * @note	Called by checkShellStatus(). Rising and falling edges are merged in time order. An
+  * 		edge is only taken once the other stream has a later one, so a fall still on its way
+  * 		through the DMA can not be missed. Edges overwritten by the DMA are skipped and counted.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellCapturePoll(void) {
+	if (!capture.running) {
+		return;
+	}
+
+	uint32_t riseWritten = captureWritten(&rise);
+	uint32_t fallWritten = captureWritten(&fall);
+	uint32_t primask = __get_PRIMASK();
+
+	// Maps the timestamps onto the synced clock for the dump, good while they are younger than a turn
+	__disable_irq();
+	capture.refTicks = CAPTURE_TIMER->CNT;
+	capture.refUs = shellTsyncNow();
+	__set_PRIMASK(primask);
+
+	rise.edges = riseWritten;
+	fall.edges = fallWritten;
+
+	// Behind by more than the buffer - drop what was overwritten and start a new period
+	if ((riseWritten - rise.read) > (SHELL_CAPTURE_BUF_LEN - CAPTURE_GUARD) ||
+			(fallWritten - fall.read) > (SHELL_CAPTURE_BUF_LEN - CAPTURE_GUARD)) {
+		capture.lost += (riseWritten - rise.read) + (fallWritten - fall.read);
+		rise.read = riseWritten;
+		fall.read = fallWritten;
+		capture.haveRise = false;
+		capture.high = 0;
+		return;
+	}
+
+	for (uint32_t n = 0; n < SHELL_CAPTURE_EDGES_PER_POLL; n++) {
+		if (rise.read == riseWritten || fall.read == fallWritten) {
+			break;
+		}
+
+		uint32_t riseTime = rise.buffer[rise.read % SHELL_CAPTURE_BUF_LEN];
+		uint32_t fallTime = fall.buffer[fall.read % SHELL_CAPTURE_BUF_LEN];
+
+		if ((int32_t)(fallTime - riseTime) < 0) {
+			// Falling edge first - the end of the high phase of the open period
+			if (capture.haveRise) {
+				capture.high = fallTime - capture.lastRise;
+			}
+			fall.read++;
+			continue;
+		}
+
+		if (capture.haveRise) {
+			captureRecord(riseTime - capture.lastRise, capture.high, riseTime);
+		}
+		capture.lastRise = riseTime;
+		capture.haveRise = true;
+		capture.high = 0;
+		rise.read++;
+	}
+}
+
+/**
+  * @brief  Restarts the statistics with the new timer clock
+  * @note	Called by shellClockApply(). Periods across the switch are meaningless.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellCaptureClockChanged(void) {
+	if (capture.running) {
+		rise.read = captureWritten(&rise);
+		fall.read = captureWritten(&fall);
+		captureReset();
+	}
+}
+
+/**
+  * @brief  DMA1 Stream 2, rising edge timestamps
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA1_Stream2_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&rise.dma);
+	SHELL_ISR_RECORD(isrId_captureRise, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  DMA1 Stream 4, falling edge timestamps
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA1_Stream4_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&fall.dma);
+	SHELL_ISR_RECORD(isrId_captureFall, start, SHELL_ISR_NO_LATENCY);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Starts/stops the capture (s, f), prints the statistics or the last periods (d)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error CaptureBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 96);
+
+	if (shellHasArg(parserInput, argTkn_s)) {
+		if (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_s)).u8 == 0) {
+			shellCaptureStop();
+			return SHELL_OK;
+		}
+		uint8_t filter = 0;
+		if (shellHasArg(parserInput, argTkn_f)) {
+			filter = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+		}
+		return shellCaptureStart(filter) ? SHELL_OK : SHELL_ERR;
+	}
+
+	if (capture.timerClock == 0) {
+		// Never started
+		capturePrint(ctx, "Capture: off\r\n");
+		return SHELL_OK;
+	}
+
+	if (shellHasArg(parserInput, argTkn_d)) {
+		uint8_t count = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+		if (count > SHELL_CAPTURE_DUMP_LEN || count > capture.periods) {
+			count = (capture.periods < SHELL_CAPTURE_DUMP_LEN) ? capture.periods : SHELL_CAPTURE_DUMP_LEN;
+		}
+
+		capturePrint(ctx, "Period (ticks)\t| High (ticks)\t| Period (ns)\t| End (synced us)\r\n");
+		for (uint8_t i = 0; i < count; i++) {
+			const capturePeriod_t* entry =
+					&capture.recent[(capture.recentNext + SHELL_CAPTURE_DUMP_LEN - count + i) % SHELL_CAPTURE_DUMP_LEN];
+
+			shellStrAppendUnsigned(&str, entry->period, 0);
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, entry->high, 0);
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, captureNs(entry->period), 0);
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, capture.refUs -
+					(uint32_t)(((uint64_t)(capture.refTicks - entry->end) * 1000000U) / capture.timerClock), 0);
+			shellStrAppend(&str, "\r\n");
+			captureSend(ctx, &str);
+		}
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, capture.running ? "Capture: running" : "Capture: stopped");
+	shellStrAppend(&str, capture.dmaError ? " (DMA error), PA0, timer " : ", PA0, timer ");
+	shellStrAppendUnsigned(&str, capture.timerClock, 0);
+	shellStrAppend(&str, " Hz, filter ");
+	shellStrAppendUnsigned(&str, capture.filter, 0);
+	shellStrAppend(&str, "\r\n");
+	captureSend(ctx, &str);
+
+	shellStrAppend(&str, "Edges: ");
+	shellStrAppendUnsigned(&str, rise.edges, 0);
+	shellStrAppend(&str, " rising, ");
+	shellStrAppendUnsigned(&str, fall.edges, 0);
+	shellStrAppend(&str, " falling, ");
+	shellStrAppendUnsigned(&str, capture.lost, 0);
+	shellStrAppend(&str, " lost\r\n");
+	captureSend(ctx, &str);
+
+	if (capture.periods == 0) {
+		capturePrint(ctx, "Periods: none\r\n");
+		return SHELL_OK;
+	}
+
+	// Mean frequency in mHz from the mean period in 1/1000 ticks
+	uint64_t meanPeriodMilli = (capture.periodSum * 1000ULL) / capture.periods;
+	uint64_t frequencyMilli = ((uint64_t)capture.timerClock * 1000000ULL) / meanPeriodMilli;
+	uint32_t dutyMilli = (capture.dutyPeriodSum == 0) ? 0 : (uint32_t)((capture.highSum * 1000ULL) / capture.dutyPeriodSum);
+
+	shellStrAppend(&str, "Frequency: ");
+	shellStrAppendUnsigned(&str, (uint32_t)(frequencyMilli / 1000U), 0);
+	shellStrAppendChar(&str, '.');
+	shellStrAppendUnsigned(&str, (uint32_t)(frequencyMilli % 1000U), 3);
+	shellStrAppend(&str, " Hz, duty ");
+	shellStrAppendUnsigned(&str, dutyMilli / 10U, 0);
+	shellStrAppendChar(&str, '.');
+	shellStrAppendUnsigned(&str, dutyMilli % 10U, 0);
+	shellStrAppend(&str, " %\r\n");
+	captureSend(ctx, &str);
+
+	shellStrAppend(&str, "Periods: ");
+	shellStrAppendUnsigned(&str, capture.periods, 0);
+	shellStrAppend(&str, ", ");
+	shellStrAppendUnsigned(&str, capture.periodMin, 0);
+	shellStrAppend(&str, "..");
+	shellStrAppendUnsigned(&str, capture.periodMax, 0);
+	shellStrAppend(&str, " ticks (");
+	shellStrAppendUnsigned(&str, captureNs(capture.periodMin), 0);
+	shellStrAppend(&str, "..");
+	shellStrAppendUnsigned(&str, captureNs(capture.periodMax), 0);
+	shellStrAppend(&str, " ns)\r\n");
+	captureSend(ctx, &str);
+
+	capturePrint(ctx, "Histogram\t| From (ns)\t| Periods\r\n");
+	for (uint8_t bin = 0; bin < SHELL_CAPTURE_HIST_BINS; bin++) {
+		if (capture.histogram[bin] != 0) {
+			shellStrAppend(&str, "2^");
+			shellStrAppendUnsigned(&str, bin, 0);
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, captureNs(1ULL << bin), 0);
+			shellStrAppend(&str, "\t| ");
+			shellStrAppendUnsigned(&str, capture.histogram[bin], 0);
+			shellStrAppend(&str, "\r\n");
+			captureSend(ctx, &str);
+		}
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
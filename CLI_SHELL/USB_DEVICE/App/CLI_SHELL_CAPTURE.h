@@ -0,0 +1,67 @@
+/** @file CLI_SHELL_CAPTURE.h
+ *
+ * @brief Input capture for the CLI Shell: edge timestamps by DMA, frequency/duty/histogram
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Synced time in the period dump
+ *
+ * Usage Notes:
+ *  - The signal goes to PA0 (A0 on the Nucleo header). TIM5 counts the timer clock (twice PCLK1,
+ *    96 MHz in the performance profile) in 32 bits. Channel 1 captures the rising edges of TI1,
+ *    channel 2 the falling edges of the same input.
+ *  - Every capture is moved by DMA1 (Stream 2 for channel 1, Stream 4 for channel 2, channel 6)
+ *    into a circular buffer of SHELL_CAPTURE_BUF_LEN timestamps, no interrupt per edge. The half
+ *    and full transfer interrupts only count how far the buffers have been written.
+ *  - checkShellStatus() works through the new timestamps (shellCapturePoll()), at most
+ *    SHELL_CAPTURE_EDGES_PER_POLL per call: period (rise to rise), high time (rise to fall), the
+ *    mean frequency and duty cycle and a histogram of the periods with one bin per power of two.
+ *    Edges the DMA overwrote before they were processed are counted as lost, the statistics go on
+ *    from the next complete period. Nothing is lost while the main loop keeps up.
+ *  - Periods must be shorter than one turn of the counter (about 44 s at 96 MHz). A clock profile
+ *    change restarts the statistics with the new timer clock.
+ *  - "capture s1 [f<filter>]" starts (input filter 0-15, see TIMx_CCMR1 IC1F), "capture s0" stops,
+ *    "capture" prints the statistics, "capture d<n>" the last n periods (SHELL_CAPTURE_DUMP_LEN at most).
+ *  - The dump also shows when each period ended on the synced clock (CLI_SHELL_TSYNC.h), so
+ *    edges seen by several boards line up. The counter is mapped onto it at every poll.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CAPTURE_H_
+#define CLI_SHELL_CAPTURE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_CAPTURE_BUF_LEN			512			/*!< Timestamps per edge, a power of 2		*/
+#define SHELL_CAPTURE_DUMP_LEN			32			/*!< Recent periods kept for "capture d"	*/
+#define SHELL_CAPTURE_HIST_BINS			32			/*!< Bin n: 2^n <= period < 2^(n+1) ticks	*/
+#define SHELL_CAPTURE_IRQ_PRIORITY		1
+
+/**
+  * @brief  Edges processed per shellCapturePoll() at most
+  */
+#ifndef SHELL_CAPTURE_EDGES_PER_POLL
+#define SHELL_CAPTURE_EDGES_PER_POLL	256
+#endif
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellCaptureStart(uint8_t filter);
+void shellCaptureStop(void);
+void shellCapturePoll(void);
+void shellCaptureClockChanged(void);
+
+#endif // CLI_SHELL_CAPTURE_H_
+
+/*** end of file ***/
@@ -0,0 +1,278 @@
+/** @file CLI_SHELL_CLOCK.c
+ *
+ * @brief Runtime clock profiles
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) USART transport baud rate follows PCLK2
+ * - 1.2: 10-14-2026 (Crandell) Scheduler tick follows PCLK2
+ * - 1.3: 10-14-2026 (Crandell) Input capture restarts with the new timer clock
+ * - 1.4: 10-14-2026 (Crandell) Pattern output keeps its rate
+ * - 1.5: 10-15-2026 (Crandell) ADC scans keep their rate
+ * - 1.6: 10-15-2026 (Crandell) Load governor
+ * - 1.7: 10-15-2026 (Crandell) Profile and governor kept over a reset (CLI_SHELL_SESSION)
+ * - 1.8: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_CLOCK.h"
+#include "CLI_SHELL_UART.h"
+#include "CLI_SHELL_SCHED.h"
+#include "CLI_SHELL_CAPTURE.h"
+#include "CLI_SHELL_PATTERN.h"
+#include "CLI_SHELL_ADC.h"
+#include "CLI_SHELL_SESSION.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Bus setup of one profile
+  */
+typedef struct {
+	const char* name;
+	uint32_t ahbDivider;					/*!< RCC_SYSCLK_DIVx						*/
+	uint32_t apb1Divider;					/*!< RCC_HCLK_DIVx, APB1 at most 50 MHz		*/
+	uint32_t apb2Divider;					/*!< RCC_HCLK_DIVx							*/
+	uint32_t flashLatency;					/*!< FLASH_LATENCY_x for HCLK at 2.7-3.6 V	*/
+} shellClockConfig_t;
+
+/**
+  * @brief  Governor state
+  */
+typedef struct {
+	bool enabled;							/*!< "clock g1"								*/
+	uint32_t lowSince;						/*!< HAL tick the busy share went low		*/
+	uint32_t switches;						/*!< Profile switches by the governor		*/
+} shellClockGovernor_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const shellClockConfig_t clockProfiles[clockProfile_count] = {
+	[clockProfile_performance]	= { "performance",	RCC_SYSCLK_DIV1,	RCC_HCLK_DIV2,	RCC_HCLK_DIV1,	FLASH_LATENCY_3 },
+	[clockProfile_balanced]		= { "balanced",		RCC_SYSCLK_DIV2,	RCC_HCLK_DIV1,	RCC_HCLK_DIV1,	FLASH_LATENCY_1 },
+	[clockProfile_lowPower]		= { "low power",	RCC_SYSCLK_DIV4,	RCC_HCLK_DIV1,	RCC_HCLK_DIV1,	FLASH_LATENCY_0 },
+};
+
+static shellClockProfile_t currentProfile = clockProfile_performance;	/*!< SystemClock_Config() setup	*/
+
+static shellClockGovernor_t governor = { .enabled = SHELL_CLOCK_GOVERNOR };
+static int8_t restoreProfile = -1;			/*!< Profile of a restored session, -1 none	*/
+
+extern PCD_HandleTypeDef hpcd_USB_OTG_FS;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void governorSwitch(shellClockProfile_t profile);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Switches for the governor and restarts its hold time
+  * @param[IN]  profile Clock profile
+  * @retval NONE
+  */
+static void governorSwitch(shellClockProfile_t profile) {
+	governor.lowSince = HAL_GetTick();
+	if (profile != currentProfile && shellClockApply(profile)) {
+		governor.switches++;
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Switches to a clock profile
+  * @note	HAL_RCC_ClockConfig() orders the flash latency and prescaler changes for the
+  * 		direction of the switch and restarts the tick. The USB turnaround time is set for
+  * 		the slower of the two clocks while switching, then for the new one. The USART
+  * 		transport gets the baud rate divider for the new PCLK2.
+  * @param[IN]  profile Clock profile
+  * @retval bool Returns false if the profile is unknown or the HAL failed
+  */
+bool shellClockApply(shellClockProfile_t profile) {
+	RCC_ClkInitTypeDef clkInit = {0};
+	uint32_t oldHclk = HAL_RCC_GetHCLKFreq();
+
+	if (profile >= clockProfile_count) {
+		return false;
+	}
+
+	const shellClockConfig_t* config = &clockProfiles[profile];
+	uint32_t newHclk = HAL_RCC_GetSysClockFreq() >> AHBPrescTable[(config->ahbDivider & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+
+	// A larger turnaround time than needed is safe, a smaller one is not
+	USB_SetTurnaroundTime(hpcd_USB_OTG_FS.Instance, (newHclk < oldHclk) ? newHclk : oldHclk,
+						  (uint8_t)hpcd_USB_OTG_FS.Init.speed);
+
+	clkInit.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clkInit.AHBCLKDivider = config->ahbDivider;
+	clkInit.APB1CLKDivider = config->apb1Divider;
+	clkInit.APB2CLKDivider = config->apb2Divider;
+
+	if (HAL_RCC_ClockConfig(&clkInit, config->flashLatency) != HAL_OK) {
+		USB_SetTurnaroundTime(hpcd_USB_OTG_FS.Instance, HAL_RCC_GetHCLKFreq(), (uint8_t)hpcd_USB_OTG_FS.Init.speed);
+		return false;
+	}
+
+	USB_SetTurnaroundTime(hpcd_USB_OTG_FS.Instance, HAL_RCC_GetHCLKFreq(), (uint8_t)hpcd_USB_OTG_FS.Init.speed);
+#if SHELL_UART_ENABLED
+	shellUartClockChanged();
+#endif
+	shellSchedClockChanged();
+	shellCaptureClockChanged();
+	shellPatternClockChanged();
+	shellAdcClockChanged();
+	currentProfile = profile;
+	return true;
+}
+
+/**
+  * @brief  The active clock profile
+  * @param  NONE
+  * @retval shellClockProfile_t Profile
+  */
+shellClockProfile_t shellClockCurrent(void) {
+	return currentProfile;
+}
+
+/**
+  * @brief  Sets the profile and the governor of a restored session (CLI_SHELL_SESSION.h)
+  * @note	The profile is applied by the first shellClockDemand(), from the main loop: the
+  * 		switch sets the USB turnaround time, the USB core is not up during shellInit().
+  * @param[IN]  profile Clock profile, ignored with the governor on
+  * @param[IN]  governed Governor on
+  * @retval NONE
+  */
+void shellClockRestore(shellClockProfile_t profile, bool governed) {
+	governor.enabled = governed;
+	governor.lowSince = HAL_GetTick();
+	if (!governed && profile < clockProfile_count) {
+		restoreProfile = (int8_t)profile;
+	}
+}
+
+/**
+  * @brief  Whether the governor picks the profile
+  * @param  NONE
+  * @retval bool Returns true if it is on
+  */
+bool shellClockGoverned(void) {
+	return governor.enabled;
+}
+
+/**
+  * @brief  Governor step on the busy share of a window, called by the load accounting
+  * @note	A step down needs the share scaled by the HCLK ratio of the two profiles below
+  * 		SHELL_CLOCK_GOV_DOWN, so the slower clock does not climb straight back to
+  * 		SHELL_CLOCK_GOV_UP.
+  * @param[IN]  busy Busy per mille of the last SHELL_CLOCK_GOV_WINDOW_MS
+  * @retval NONE
+  */
+void shellClockGovern(uint32_t busy) {
+	if (!governor.enabled) {
+		return;
+	}
+	if (busy >= SHELL_CLOCK_GOV_UP) {
+		governorSwitch(clockProfile_performance);
+		return;
+	}
+	if (currentProfile == clockProfile_lowPower) {
+		return;
+	}
+
+	shellClockProfile_t slower = (shellClockProfile_t)(currentProfile + 1);
+	uint32_t shift = AHBPrescTable[(clockProfiles[slower].ahbDivider & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos] -
+			AHBPrescTable[(clockProfiles[currentProfile].ahbDivider & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+
+	if ((busy << shift) >= SHELL_CLOCK_GOV_DOWN) {
+		governor.lowSince = HAL_GetTick();
+	} else if ((HAL_GetTick() - governor.lowSince) >= SHELL_CLOCK_GOV_HOLD_MS) {
+		governorSwitch(slower);
+	}
+}
+
+/**
+  * @brief  Governor check of the receive ring, called by checkShellStatus() before a pass
+  * @param[IN]  rxQueued Bytes waiting in the receive ring of the instance
+  * @retval NONE
+  */
+void shellClockDemand(uint32_t rxQueued) {
+	if (restoreProfile >= 0) {
+		shellClockApply((shellClockProfile_t)restoreProfile);
+		restoreProfile = -1;
+	}
+	if (governor.enabled && rxQueued >= SHELL_CLOCK_GOV_RX_BOOST) {
+		governorSwitch(clockProfile_performance);
+	}
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Switches the clock profile or the governor and reports the clocks
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (p - profile, g - governor, optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error ClockBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 100);
+
+	if (shellHasArg(parserInput, argTkn_p)) {
+		uint8_t profile = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).u8;
+		if (!shellClockApply((shellClockProfile_t)profile)) {
+			return SHELL_ERR;
+		}
+		// A profile set by hand stays, unless g1 comes with it
+		governor.enabled = false;
+	}
+
+	if (shellHasArg(parserInput, argTkn_g)) {
+		uint8_t enable = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_g)).u8;
+		if (enable > 1) {
+			return SHELL_ERR;
+		}
+		governor.enabled = (enable == 1);
+		governor.lowSince = HAL_GetTick();
+	}
+	if (shellHasArg(parserInput, argTkn_p) || shellHasArg(parserInput, argTkn_g)) {
+		shellSessionSave(ctx);
+	}
+
+	shellStrAppend(&str, "Clock: ");
+	shellStrAppend(&str, clockProfiles[currentProfile].name);
+	shellStrAppend(&str, ", HCLK ");
+	shellStrAppendUnsigned(&str, HAL_RCC_GetHCLKFreq(), 0);
+	shellStrAppend(&str, " Hz, APB1 ");
+	shellStrAppendUnsigned(&str, HAL_RCC_GetPCLK1Freq(), 0);
+	shellStrAppend(&str, " Hz, APB2 ");
+	shellStrAppendUnsigned(&str, HAL_RCC_GetPCLK2Freq(), 0);
+	shellStrAppend(&str, " Hz, ");
+	shellStrAppendUnsigned(&str, __HAL_FLASH_GET_LATENCY(), 0);
+	shellStrAppend(&str, " wait states\r\n");
+	shellStrSend(ctx, &str);
+
+	shellStrAppend(&str, governor.enabled ? "Governor: on, " : "Governor: off, ");
+	shellStrAppendUnsigned(&str, governor.switches, 0);
+	shellStrAppend(&str, " switches\r\n");
+	shellStrSend(ctx, &str);
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
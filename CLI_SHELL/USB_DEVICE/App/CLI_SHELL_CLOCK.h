@@ -0,0 +1,94 @@
+/** @file CLI_SHELL_CLOCK.h
+ *
+ * @brief Runtime clock profiles
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) USART transport baud rate follows PCLK2
+ * - 1.2: 10-14-2026 (Crandell) Scheduler tick follows PCLK2
+ * - 1.3: 10-14-2026 (Crandell) Input capture restarts with the new timer clock
+ * - 1.4: 10-14-2026 (Crandell) Pattern output keeps its rate
+ * - 1.5: 10-15-2026 (Crandell) Load governor
+ * - 1.6: 10-15-2026 (Crandell) Session restore of the profile and the governor
+ *
+ * Usage Notes:
+ *  - SystemClock_Config() runs the PLL at 192 MHz VCO: SYSCLK 96 MHz (P = 2) and the USB clock
+ *    48 MHz (Q = 4). The profiles only change the AHB/APB prescalers and the flash latency,
+ *    so the PLL and the USB clock never stop and the link stays up across a switch.
+ *      - performance: HCLK 96 MHz, APB1 48 MHz, APB2 96 MHz, 3 wait states
+ *      - balanced:    HCLK 48 MHz, APB1 48 MHz, APB2 48 MHz, 1 wait state
+ *      - low power:   HCLK 24 MHz, APB1 24 MHz, APB2 24 MHz, 0 wait states
+ *  - "clock p<n>" switches, "clock" alone reports the current clocks.
+ *  - The SysTick (HAL_InitTick), SystemCoreClock and the USB turnaround time follow the new HCLK.
+ *    The USART transport (CLI_SHELL_UART.h) keeps its baud rate, the scheduler (CLI_SHELL_SCHED.h)
+ *    its tick. A running input capture (CLI_SHELL_CAPTURE.h) restarts its statistics,
+ *    the pattern output (CLI_SHELL_PATTERN.h) keeps its rate.
+ *    Cycle statistics taken before a switch are in the old clock.
+ *  - Low power keeps voltage scale 1. A lower scale needs the PLL off, which would drop USB.
+ *  - The governor picks the profile from the load (SHELL_CLOCK_GOVERNOR, on after startup):
+ *      - the CPU load accounting (CLI_SHELL_LOAD.h) hands it the busy share of every
+ *        SHELL_CLOCK_GOV_WINDOW_MS. At SHELL_CLOCK_GOV_UP or more it switches to performance
+ *        at once.
+ *      - checkShellStatus() hands it the receive ring depth before each pass. A backlog of
+ *        SHELL_CLOCK_GOV_RX_BOOST bytes or more (a script pasted, a host sending lines back to
+ *        back) switches to performance before the lines run.
+ *      - it steps down one profile once the busy share, scaled to the slower clock, has stayed
+ *        below SHELL_CLOCK_GOV_DOWN for SHELL_CLOCK_GOV_HOLD_MS. Idle ends at low power.
+ *    A switch by the governor is the same as "clock p<n>", with the same effects on the
+ *    peripherals listed above. "clock p<n>" turns the governor off and stays at the profile,
+ *    "clock g1" turns it on again, "clock g0" off. "clock" shows its state and switches.
+ *  - A profile or governor set by "clock" comes back after a soft or watchdog reset
+ *    (CLI_SHELL_SESSION.h). With the governor on, the load picks the profile again.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CLOCK_H_
+#define CLI_SHELL_CLOCK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_CLOCK_GOVERNOR
+#define SHELL_CLOCK_GOVERNOR			1			/*!< Governor on after startup			*/
+#endif
+#define SHELL_CLOCK_GOV_WINDOW_MS		20			/*!< Busy share measured over			*/
+#define SHELL_CLOCK_GOV_UP				600			/*!< Busy per mille: to performance		*/
+#define SHELL_CLOCK_GOV_DOWN			300			/*!< Busy per mille at the slower clock	*/
+#define SHELL_CLOCK_GOV_HOLD_MS			500			/*!< Below it that long: one step down	*/
+#define SHELL_CLOCK_GOV_RX_BOOST		64			/*!< Receive ring bytes: to performance	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Clock profiles
+  */
+typedef enum {
+	clockProfile_performance = 0,
+	clockProfile_balanced,
+	clockProfile_lowPower,
+	clockProfile_count
+} shellClockProfile_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellClockApply(shellClockProfile_t profile);
+shellClockProfile_t shellClockCurrent(void);
+void shellClockRestore(shellClockProfile_t profile, bool governed);
+bool shellClockGoverned(void);
+void shellClockGovern(uint32_t busy);
+void shellClockDemand(uint32_t rxQueued);
+
+#endif // CLI_SHELL_CLOCK_H_
+
+/*** end of file ***/
@@ -5,14 +5,79 @@
  * @author Colton Crandell
  * @revision history:
  * - 1.0: 5-18-2020 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Table must be sorted by name for the binary search lookup
+ * - 1.2: 10-14-2026 (Crandell) Table generated from the SHELL_COMMAND_LIST X-macro
+ * - 1.3: 10-14-2026 (Crandell) Table and argument lists are const (flash resident)
+ * - 1.4: 10-14-2026 (Crandell) "cancel" and "sleep" commands
+ * - 1.5: 10-14-2026 (Crandell) "stream" command
+ * - 1.6: 10-14-2026 (Crandell) "clock" command
+ * - 1.7: 10-14-2026 (Crandell) "art" command
+ * - 1.8: 10-14-2026 (Crandell) "tput" command
+ * - 1.9: 10-14-2026 (Crandell) "mrd" and "mwr" commands
+ * - 1.10: 10-14-2026 (Crandell) "macro" command
+ * - 1.11: 10-14-2026 (Crandell) "get" and "set" commands
+ * - 1.12: 10-14-2026 (Crandell) "flash" command
+ * - 1.13: 10-14-2026 (Crandell) "every" command
+ * - 1.14: 10-14-2026 (Crandell) "capture" command
+ * - 1.15: 10-14-2026 (Crandell) "pattern" command
+ * - 1.16: 10-14-2026 (Crandell) Trie lookup note
+ * - 1.17: 10-14-2026 (Crandell) "idle" command
+ * - 1.18: 10-14-2026 (Crandell) "mem" command
+ * - 1.19: 10-14-2026 (Crandell) "trace" command
+ * - 1.20: 10-14-2026 (Crandell) "itm" command
+ * - 1.21: 10-14-2026 (Crandell) "usbstat" command
+ * - 1.22: 10-14-2026 (Crandell) "isr" command
+ * - 1.23: 10-14-2026 (Crandell) "boot" command
+ * - 1.24: 10-14-2026 (Crandell) "crash" command
+ * - 1.25: 10-14-2026 (Crandell) "crc" command
+ * - 1.26: 10-14-2026 (Crandell) "watch" command
+ * - 1.27: 10-15-2026 (Crandell) "mode" compression argument
+ * - 1.28: 10-15-2026 (Crandell) Urgent command list
+ * - 1.29: 10-15-2026 (Crandell) Cacheable command list
+ * - 1.30: 10-15-2026 (Crandell) "mwr" takes a list of values
+ * - 1.31: 10-15-2026 (Crandell) "notify" command
+ * - 1.32: 10-15-2026 (Crandell) "ping" command, "tput" loopback direction
+ * - 1.33: 10-15-2026 (Crandell) "fwupdate" command
+ * - 1.34: 10-15-2026 (Crandell) "adc" command
+ * - 1.35: 10-15-2026 (Crandell) "spi" command
+ * - 1.36: 10-15-2026 (Crandell) "i2c" command
+ * - 1.37: 10-15-2026 (Crandell) "vm" command
+ * - 1.38: 10-15-2026 (Crandell) "let" command
+ * - 1.39: 10-15-2026 (Crandell) "load" command
+ * - 1.40: 10-15-2026 (Crandell) "gpio" command
+ * - 1.41: 10-15-2026 (Crandell) "events" command
+ * - 1.42: 10-15-2026 (Crandell) "regress" command
+ * - 1.43: 10-15-2026 (Crandell) SHELL_DEADLINE_LIST, bridge deadlines
+ * - 1.44: 10-15-2026 (Crandell) "modules" command
+ * - 1.45: 10-15-2026 (Crandell) "history" command
+ * - 1.46: 10-15-2026 (Crandell) "term" command
+ * - 1.47: 10-15-2026 (Crandell) "clock" governor switch
+ * - 1.48: 10-15-2026 (Crandell) "tsync" command, "stream" stamped frames
+ * - 1.49: 10-15-2026 (Crandell) "arm" command, armable command list
+ * - 1.50: 10-15-2026 (Crandell) "session" command
+ * - 1.51: 10-15-2026 (Crandell) Name pool of the Command Table
+ * - 1.52: 10-15-2026 (Crandell) "loopback", "sink" and "source" commands
  *
  * To Add Commands:
- *  1. Copy the command template below and paste a copy where desired (Must be within the table)
- *  2. Type the desired command
- *  3. Type the Help Description. This description will be listed whenever the help command is received.
- *  4. Input the bridge. This is the function that will be called when the command is received.
- *  5. Input any arguments if necessary and update the number of arguments.
- *  6. Update the global define "NUM_OF_COMMANDS" to the total number of commands within the table.
+ *  1. Add a SHELL_CMD() line to SHELL_COMMAND_LIST (id, name, bridge, description, argument help).
+ *     The table is searched as a trie of the names, so keep it sorted by command name in ASCII order
+ *     (symbols, then uppercase, then lowercase). shellInit() fails if the order is broken.
+ *  2. Add a SHELL_ARGS_<id> list with one SHELL_ARG() line per argument (token, type, mandatory).
+ *     Leave the list empty if the command takes no arguments.
+ *  3. Declare the bridge in CLI_SHELL.h. This is the function that will be called when the command is received.
+ *  4. Commands that must not wait behind other lines (stopping something) also go into SHELL_URGENT_LIST,
+ *     see CLI_SHELL_URGENT.h. Keep them short and quick, they run from the middle of a pass.
+ *  5. Queries whose response only changes with their arguments or through shellCacheInvalidate() may go into
+ *     SHELL_CACHE_LIST, see CLI_SHELL_CACHE.h. Worth it for bridges that take a while to compute.
+ *  6. Commands with a latency contract (run by "every", from the urgent lane) may get a deadline in
+ *     SHELL_DEADLINE_LIST: a bridge that takes longer is counted in "perf" and traced (traceEvt_overrun).
+ *  7. Commands whose bridge may run from an interrupt go into SHELL_ARM_LIST, see CLI_SHELL_ARM.h.
+ *     They must finish on the spot, start no job and touch nothing the main loop writes unmasked.
+ *
+ * The command count, argument counts, help text and mandatory masks are derived from the lists.
+ * Duplicate ids, duplicate argument tokens and too many arguments fail the build.
+ * Commands of a product variant can also come from a module in flash, without touching this file
+ * (CLI_SHELL_MODULE.h). shellRegisterCommand() runs the same checks on them at boot.
  *
  * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
  */
@@ -25,88 +90,431 @@
  * INCLUDES
  *******************************************************************************/
 #include "CLI_SHELL.h"
+#include "CLI_SHELL_BENCH.h"
 
 /********************************************************************************
- * DEFINES
+ * COMMAND LIST
  *******************************************************************************/
-#define NUM_OF_COMMANDS			3
+/**
+  * @brief  SHELL_CMD(id, name, bridge, description, argument help)
+  */
+#define SHELL_COMMAND_LIST(SHELL_CMD) \
+		/*-----------------Help Commands-------------------*/ \
+		SHELL_CMD(help_q,	"?",		HelpBridge,		"Display the Help Menu",	"No Arguments") \
+		/*------------------ADC Acquisition----------------*/ \
+		SHELL_CMD(adc,		"adc",		AdcBridge,		"ADC scans by DMA",			"c - Channels (0-7, 10-15, 17, 18), r - Scans per second, d - Decimation (optional), n - Scans (optional), f - Format (1 binary) (optional)") \
+		/*------------------Armed Commands-----------------*/ \
+		SHELL_CMD(arm,		"arm",		ArmBridge,		"Command armed on a pin",	"d - Disarm (1) (optional, none shows it). Arm with arm P<port><pin>[+|-|*] <command>") \
+		/*------------------Flash Accelerator--------------*/ \
+		SHELL_CMD(art,		"art",		ArtBridge,		"Flash accelerator",		"f - Features (1 prefetch, 2 I-cache, 4 D-cache) (optional)") \
+		SHELL_BENCH_COMMANDS(SHELL_CMD) \
+		/*------------------Boot Timing--------------------*/ \
+		SHELL_CMD(boot,		"boot",		BootBridge,		"Boot stage times",			"No Arguments") \
+		/*------------------Jobs---------------------------*/ \
+		SHELL_CMD(cancel,	"cancel",	CancelBridge,	"Stop the running job",		"No Arguments") \
+		/*------------------Input Capture------------------*/ \
+		SHELL_CMD(capture,	"capture",	CaptureBridge,	"PA0 input capture",		"s - Start (1) or stop (0) f - Filter (0-15) d - Dump last periods (all optional, statistics without)") \
+		/*------------------Clock Profiles-----------------*/ \
+		SHELL_CMD(clock,	"clock",	ClockBridge,	"Clock profile",			"p - Profile (0 performance, 1 balanced, 2 low power) g - Governor (1 on, 0 off) (all optional)") \
+		/*------------------Post-Mortem--------------------*/ \
+		SHELL_CMD(crash,	"crash",	CrashBridge,	"Last fault record",		"c - Clear (1) f - Fault on purpose (1) (all optional)") \
+		/*------------------Memory Access------------------*/ \
+		SHELL_CMD(crc,		"crc",		CrcBridge,		"CRC32 of memory",			"a - Address n - Bytes") \
+		/*------------------Edge Events--------------------*/ \
+		SHELL_CMD(events,	"events",	EventsBridge,	"EXTI edge records",		"l - Line (0-15) p - Port (0-2 A-C) e - Edges (0 off, 1 rise, 2 fall, 3 both) d - Drain (1 once, 2 follow, 0 stop) c - Clear (1) (all optional)") \
+		/*------------------Periodic Commands--------------*/ \
+		SHELL_CMD(every,	"every",	EveryBridge,	"Periodic commands",		"d - Delete entry (optional, lists all). Schedule with every <period> <command>") \
+		/*------------------Flash Storage------------------*/ \
+		SHELL_CMD(flash,	"flash",	FlashBridge,	"Flash queue status",		"No Arguments") \
+		/*------------------Firmware Update----------------*/ \
+		SHELL_CMD(fwupdate,	"fwupdate",	FwupdateBridge,	"Firmware update",			"n - Image bytes c - Image CRC32 (binary session, image follows) a - Apply and reset (1) (none shows the slot)") \
+		/*------------------Settings-----------------------*/ \
+		SHELL_CMD(get,		"get",		GetBridge,		"Read settings",			"k - Key (optional, lists all)") \
+		/*------------------GPIO Ports---------------------*/ \
+		SHELL_CMD(gpio,		"gpio",		GpioBridge,		"Port masks and batches",	"p - Port (0-2 A-C) s/c/t - Set/clear/toggle pins (lines without p) b - Port,BSRR list (all optional, none reads)") \
+		SHELL_CMD(help,		"help",		HelpBridge,		"Display the Help Menu",	"Command prefix (optional)") \
+		/*------------------Command History----------------*/ \
+		SHELL_CMD(history,	"history",	HistoryBridge,	"List the command history",	"c - Clear (1) (optional), !! or !<n> runs an entry again") \
+		/*------------------I2C Requests-------------------*/ \
+		SHELL_CMD(i2c,		"i2c",		I2cBridge,		"Queue I2C register reads",	"a - Address r - Registers n - Bytes each (optional) i - Collect <id> (none lists the queue)") \
+		/*------------------Idle Loop----------------------*/ \
+		SHELL_CMD(idle,		"idle",		IdleBridge,		"Main loop sleep stats",	"w - WFI (1) or polling (0) r - Reset after dump (1) (all optional)") \
+		/*------------------Interrupt Profiler-------------*/ \
+		SHELL_CMD(isr,		"isr",		IsrBridge,		"Interrupt profiler",		"h - Histograms of handler <id> r - Reset after dump (1) (all optional)") \
+		/*------------------SWO Debug Output---------------*/ \
+		SHELL_CMD(itm,		"itm",		ItmBridge,		"SWO output and log level",	"l - Log level (0 off, 1 errors, 2 info, 3 debug) (optional)") \
+		/*------------------Shell Variables----------------*/ \
+		SHELL_CMD(let,		"let",		LetBridge,		"Shell variables",			"n - Name v - Value expression (optional, deletes) (none lists)") \
+		/*------------------CPU Load-----------------------*/ \
+		SHELL_CMD(load,		"load",		LoadBridge,		"CPU load and loop timing",	"r - Reset min/max after dump (1) (optional)") \
+		/*------------------Transport Benchmark------------*/ \
+		SHELL_CMD(loopback,	"loopback",	LoopbackBridge,	"Echo input back",			"n - Bytes") \
+		/*------------------Macros-------------------------*/ \
+		SHELL_CMD(macro,	"macro",	MacroBridge,	"Record/play macros",		"r - Record slot e - End (1 store, 0 discard) p - Play slot d - Delete slot (one of them, none lists)") \
+		/*------------------Memory Access------------------*/ \
+		SHELL_CMD(mem,		"mem",		MemBridge,		"RAM use and stack peak",	"r - Restart the stack peak (1) (optional)") \
+		/*------------------Session Mode-------------------*/ \
+		SHELL_CMD(mode,		"mode",		ModeBridge,		"Text/Binary session",		"m - Mode (0 text, 1 binary) z - Compress binary responses (1) (optional)") \
+		/*------------------Command Modules----------------*/ \
+		SHELL_CMD(modules,	"modules",	ModulesBridge,	"Command modules in flash",	"No Arguments") \
+		/*------------------Memory Access------------------*/ \
+		SHELL_CMD(mrd,		"mrd",		MrdBridge,		"Read memory",				"a - Address n - Bytes w - Width (1, 2, 4) f - Format (0 hex, 1 raw) (n, w, f optional)") \
+		SHELL_CMD(mwr,		"mwr",		MwrBridge,		"Write memory",				"a - Address w - Width (1, 2, 4) v - Value(s) v1,2,.. n - Count, or bytes to follow without v (w, v optional)") \
+		/*------------------Notifications------------------*/ \
+		SHELL_CMD(notify,	"notify",	NotifyBridge,	"Event notifications",		"m - Event mask t - Send test event with value (all optional)") \
+		/*------------------Pattern Output-----------------*/ \
+		SHELL_CMD(pattern,	"pattern",	PatternBridge,	"GPIOB pattern output",		"l - Samples to load m - Pin mask r - Rate (Hz) o - Once s - Stop (0) (all optional)") \
+		/*------------------Profiling----------------------*/ \
+		SHELL_CMD(perf,		"perf",		PerfBridge,		"Command cycle stats",		"r - Reset after dump (1) (optional)") \
+		/*------------------Link Latency-------------------*/ \
+		SHELL_CMD(ping,		"ping",		PingBridge,		"Round trip test",			"p - Payload to echo n - Pad bytes (all optional)") \
+		SHELL_REGRESS_COMMANDS(SHELL_CMD) \
+		/*------------------Session Restore----------------*/ \
+		SHELL_CMD(session,	"session",	SessionBridge,	"Saved session settings",	"c - Clear (1) (optional)") \
+		/*------------------Settings-----------------------*/ \
+		SHELL_CMD(set,		"set",		SetBridge,		"Store a setting",			"k - Key v - Value (optional, deletes)") \
+		/*-----------(Test) LED Change State---------------*/ \
+		SHELL_CMD(setLed,	"setLed",	LEDBridge,		"Sets LED to state",		"l - LED (1 or 2) s - State (1 or 0)") \
+		/*------------------Transport Benchmark------------*/ \
+		SHELL_CMD(sink,		"sink",		SinkBridge,		"Discard and count input",	"n - Bytes") \
+		SHELL_CMD(sleep,	"sleep",	SleepBridge,	"Wait as a job",			"t - Time in ms") \
+		/*------------------Transport Benchmark------------*/ \
+		SHELL_CMD(source,	"source",	SourceBridge,	"Send data at full rate",	"n - Bytes") \
+		/*------------------SPI Transactions---------------*/ \
+		SHELL_CMD(spi,		"spi",		SpiBridge,		"Run SPI operations",		"l - Operation list f - Clock kHz (optional) m - Mode 0-3 (optional)") \
+		/*------------------Telemetry----------------------*/ \
+		SHELL_CMD(stream,	"stream",	StreamBridge,	"Stream samples",			"s - Source (0 count, 1-3 GPIOA-C) r - Rate Hz n - Samples f - Format (0 text, 1 binary, 2 stamped binary) (r, n, f optional)") \
+		/*------------------Terminal Echo------------------*/ \
+		SHELL_CMD(term,		"term",		TermBridge,		"Local echo and editing",	"e - Echo (1 on, 0 off) (optional, none shows it)") \
+		/*------------------Transport Benchmark------------*/ \
+		SHELL_CMD(tput,		"tput",		TputBridge,		"USB throughput test",		"d - Direction (0 IN, 1 OUT, 2 loopback) n - Bytes") \
+		/*------------------Event Trace--------------------*/ \
+		SHELL_CMD(trace,	"trace",	TraceBridge,	"Event trace ring",			"e - Record (1) or stop (0) c - Clear (1) d - Binary export (1) (all optional)") \
+		/*------------------Time Sync----------------------*/ \
+		SHELL_CMD(tsync,	"tsync",	TsyncBridge,	"USB frame synced clock",	"f - Frame number of the epoch (0-2047) (optional, none shows the clock)") \
+		/*------------------USB Link Health----------------*/ \
+		SHELL_CMD(usbstat,	"usbstat",	UsbstatBridge,	"USB link counters",		"f - Format (0 text, 1 binary) r - Reset after dump (1) (all optional)") \
+		/*------------------Script VM----------------------*/ \
+		SHELL_CMD(vm,		"vm",		VmBridge,		"Bytecode scripts",			"l - Code bytes o - Offset r - Run (1) c - Clear (1) (all optional, none shows the code)") \
+		/*------------------Watch List---------------------*/ \
+		SHELL_CMD(watch,	"watch",	WatchBridge,	"Send changed values",		"a - Address w - Width (1, 2, 4) g - Getter d - Delete entry p - Period ms (0 stops) (one of them, none lists)")
+
+/**
+  * @brief  Commands only built into the Benchmark configuration
+  */
+#if SHELL_BENCHMARK
+#define SHELL_BENCH_COMMANDS(SHELL_CMD) \
+		SHELL_CMD(bench,	"bench",	BenchBridge,	"Pipeline benchmark",		"n - Iterations (optional)")
+#define SHELL_REGRESS_COMMANDS(SHELL_CMD) \
+		/*------------------Regression Suite---------------*/ \
+		SHELL_CMD(regress,	"regress",	RegressBridge,	"Run the regression suite",	"c - Case n - Timed runs per case (all optional). Stream a case with regress <budget> \"<text>\" <line>")
+#else
+#define SHELL_BENCH_COMMANDS(SHELL_CMD)
+#define SHELL_REGRESS_COMMANDS(SHELL_CMD)
+#endif
+
+/**
+  * @brief  Commands with the urgent priority, SHELL_URGENT(id) of a command above
+  */
+#define SHELL_URGENT_LIST(SHELL_URGENT) \
+		SHELL_URGENT(cancel)
+
+/**
+  * @brief  Cacheable commands, SHELL_CACHE(id) of a command above
+  */
+#define SHELL_CACHE_LIST(SHELL_CACHE) \
+		SHELL_CACHE(crc) \
+		SHELL_CACHE(get)
+
+/**
+  * @brief  Bridge deadlines, SHELL_DEADLINE(id, µs) of a command above. Commands not listed have none.
+  */
+#define SHELL_DEADLINE_LIST(SHELL_DEADLINE) \
+		SHELL_DEADLINE(cancel,	50) \
+		SHELL_DEADLINE(mrd,		100) \
+		SHELL_DEADLINE(mwr,		100)
+
+/**
+  * @brief  Commands that may be armed on a trigger line, SHELL_ARM(id) of a command above
+  */
+#define SHELL_ARM_LIST(SHELL_ARM) \
+		SHELL_ARM(gpio) \
+		SHELL_ARM(mwr) \
+		SHELL_ARM(setLed)
 
 /********************************************************************************
- * COMMAND LIST
+ * ARGUMENT LISTS
  *******************************************************************************/
+/**
+  * @brief  SHELL_ARG(token, type, mandatory)
+  */
+#define SHELL_ARGS_help_q(SHELL_ARG)
+
+#define SHELL_ARGS_adc(SHELL_ARG) \
+		SHELL_ARG(argTkn_c,	arg_u8_array,	true) \
+		SHELL_ARG(argTkn_r,	arg_uint32,	true) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false)
+
+#define SHELL_ARGS_arm(SHELL_ARG) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false)
+
+#define SHELL_ARGS_art(SHELL_ARG) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false)
+
+#define SHELL_ARGS_bench(SHELL_ARG) \
+		SHELL_ARG(argTkn_n,	arg_uint16,	false)
+
+#define SHELL_ARGS_boot(SHELL_ARG)
+
+#define SHELL_ARGS_cancel(SHELL_ARG)
+
+#define SHELL_ARGS_capture(SHELL_ARG) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_s,	arg_uint8,	false)
+
+#define SHELL_ARGS_clock(SHELL_ARG) \
+		SHELL_ARG(argTkn_g,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_p,	arg_uint8,	false)
+
+#define SHELL_ARGS_crash(SHELL_ARG) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false)
+
+#define SHELL_ARGS_crc(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint32,	true) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	true)
+
+#define SHELL_ARGS_events(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_p,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_e,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false)
+
+#define SHELL_ARGS_every(SHELL_ARG) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false)
+
+#define SHELL_ARGS_flash(SHELL_ARG)
+
+#define SHELL_ARGS_fwupdate(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_c,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	false)
+
+#define SHELL_ARGS_get(SHELL_ARG) \
+		SHELL_ARG(argTkn_k,	arg_string,	false)
+
+#define SHELL_ARGS_gpio(SHELL_ARG) \
+		SHELL_ARG(argTkn_p,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_s,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_c,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_t,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_b,	arg_u32_array,	false)
+
+#define SHELL_ARGS_help(SHELL_ARG)
+
+#define SHELL_ARGS_history(SHELL_ARG) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false)
+
+#define SHELL_ARGS_i2c(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_r,	arg_u8_array,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_i,	arg_uint8,	false)
+
+#define SHELL_ARGS_idle(SHELL_ARG) \
+		SHELL_ARG(argTkn_w,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
+
+#define SHELL_ARGS_isr(SHELL_ARG) \
+		SHELL_ARG(argTkn_h,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
+
+#define SHELL_ARGS_itm(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_uint8,	false)
+
+#define SHELL_ARGS_let(SHELL_ARG) \
+		SHELL_ARG(argTkn_n,	arg_string,	false) \
+		SHELL_ARG(argTkn_v,	arg_string,	false)
+
+#define SHELL_ARGS_load(SHELL_ARG) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
+
+#define SHELL_ARGS_macro(SHELL_ARG) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_e,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_p,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false)
+
+#define SHELL_ARGS_mem(SHELL_ARG) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
+
+#define SHELL_ARGS_mode(SHELL_ARG) \
+		SHELL_ARG(argTkn_m,	arg_uint8,	true) \
+		SHELL_ARG(argTkn_z,	arg_uint8,	false)
+
+#define SHELL_ARGS_modules(SHELL_ARG)
 
-shellCmdTemplate_t shellCmdTemplateTable[NUM_OF_COMMANDS] = {
-
-		/*-------------------------------------------------*/
-		/*-----------------Help Commands-------------------*/
-		/*-------------------------------------------------*/
-		{
-				.cmdName = "help",
-				.helpDesc = "help\t| Display the Help Menu\t| No Arguments\r\n",
-				.bridge = HelpBridge,
-				.numArgs = 0,
-				.cmdArgsTable = {},
-		},
-		{
-				.cmdName = "?",
-				.helpDesc = "?\t| Display the Help Menu\t| No Arguments\r\n",
-				.bridge = HelpBridge,
-				.numArgs = 0,
-				.cmdArgsTable = {},
-		},
-
-		/*-------------------------------------------------*/
-		/*-----------(Test) LED Change State---------------*/
-		/*-------------------------------------------------*/
-		{
-				.cmdName = "setLed",
-				.helpDesc = "setLed\t| Sets LED to state\t| l - LED (1 or 2) s - State (1 or 0)\r\n",
-				.bridge = LEDBridge,
-				.numArgs = 1,
-				.cmdArgsTable = {
-						{
-								.mandatory = true,
-								.type = arg_uint8,
-								.token = argTkn_l,
-						},
-						{
-								.mandatory = true,
-								.type = arg_uint8,
-								.token = argTkn_s,
-						},
-				},
-		},
-
-
-//		/*-------------------------------------------------*/
-//		/*---------------Command Template------------------*/
-//		/*-------------------------------------------------*/
-//		{
-//				.cmdName = "commandName",
-//				.helpDesc = "commandName\t| Input Description\t| List Arguments\r\n",
-//				.runner = <Function to Run>,
-//				.numArgs = 2,
-//				.cmdArgsTable = {
-//						{
-//								.mandatory = true,
-//								.type = arg_uint8,
-//								.token = argTkn_a,
-//						},
-//						{
-//								.mandatory = true,
-//								.type = arg_uint8,
-//								.token = argTkn_b,
-//						},
-//				},
-//		},
+#define SHELL_ARGS_mrd(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint32,	true) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_w,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false)
 
+#define SHELL_ARGS_mwr(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint32,	true) \
+		SHELL_ARG(argTkn_w,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_v,	arg_u32_array,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	false)
 
+#define SHELL_ARGS_notify(SHELL_ARG) \
+		SHELL_ARG(argTkn_m,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_t,	arg_uint32,	false)
 
+#define SHELL_ARGS_pattern(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_uint16,	false) \
+		SHELL_ARG(argTkn_m,	arg_uint16,	false) \
+		SHELL_ARG(argTkn_o,	arg_flag,	false) \
+		SHELL_ARG(argTkn_r,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_s,	arg_uint8,	false)
 
+#define SHELL_ARGS_perf(SHELL_ARG) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
 
+#define SHELL_ARGS_regress(SHELL_ARG) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint16,	false)
+
+#define SHELL_ARGS_session(SHELL_ARG) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false)
+
+#define SHELL_ARGS_set(SHELL_ARG) \
+		SHELL_ARG(argTkn_k,	arg_string,	true) \
+		SHELL_ARG(argTkn_v,	arg_string,	false)
+
+#define SHELL_ARGS_setLed(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_uint8,	true) \
+		SHELL_ARG(argTkn_s,	arg_uint8,	true)
+
+#define SHELL_ARGS_sleep(SHELL_ARG) \
+		SHELL_ARG(argTkn_t,	arg_uint16,	true)
+
+#define SHELL_ARGS_spi(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_u8_array,	true) \
+		SHELL_ARG(argTkn_f,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_m,	arg_uint8,	false)
+
+#define SHELL_ARGS_stream(SHELL_ARG) \
+		SHELL_ARG(argTkn_s,	arg_uint8,	true) \
+		SHELL_ARG(argTkn_r,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false)
+
+#define SHELL_ARGS_ping(SHELL_ARG) \
+		SHELL_ARG(argTkn_p,	arg_string,	false) \
+		SHELL_ARG(argTkn_n,	arg_uint16,	false)
+
+#define SHELL_ARGS_term(SHELL_ARG) \
+		SHELL_ARG(argTkn_e,	arg_uint8,	false)
+
+#define SHELL_ARGS_tput(SHELL_ARG) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	true) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	true)
+
+#define SHELL_ARGS_loopback(SHELL_ARG) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	true)
+
+#define SHELL_ARGS_sink(SHELL_ARG) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	true)
+
+#define SHELL_ARGS_source(SHELL_ARG) \
+		SHELL_ARG(argTkn_n,	arg_uint32,	true)
+
+#define SHELL_ARGS_trace(SHELL_ARG) \
+		SHELL_ARG(argTkn_e,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false)
+
+#define SHELL_ARGS_tsync(SHELL_ARG) \
+		SHELL_ARG(argTkn_f,	arg_uint16,	false)
+
+#define SHELL_ARGS_usbstat(SHELL_ARG) \
+		SHELL_ARG(argTkn_f,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false)
+
+#define SHELL_ARGS_vm(SHELL_ARG) \
+		SHELL_ARG(argTkn_l,	arg_u8_array,	false) \
+		SHELL_ARG(argTkn_o,	arg_uint16,	false) \
+		SHELL_ARG(argTkn_r,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_c,	arg_uint8,	false)
+
+#define SHELL_ARGS_watch(SHELL_ARG) \
+		SHELL_ARG(argTkn_a,	arg_uint32,	false) \
+		SHELL_ARG(argTkn_w,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_g,	arg_string,	false) \
+		SHELL_ARG(argTkn_d,	arg_uint8,	false) \
+		SHELL_ARG(argTkn_p,	arg_uint16,	false)
+
+/*
+ * Template:
+ * SHELL_CMD(commandName,	"commandName",	<Function to Run>,	"Input Description",	"List Arguments")
+ *
+ * #define SHELL_ARGS_commandName(SHELL_ARG) \
+ *		SHELL_ARG(argTkn_a,	arg_uint8,	true) \
+ *		SHELL_ARG(argTkn_b,	arg_uint8,	false)
+ */
+
+/********************************************************************************
+ * GENERATED TABLE
+ *******************************************************************************/
+/**
+  * @brief  Command Table indices (shellCmdIdx_<id>). Also the command index of binary frames.
+  */
+typedef enum {
+	SHELL_COMMAND_LIST(SHELL_GEN_INDEX)
+	NUM_OF_COMMANDS
+} shellCmdIndex_t;
+
+SHELL_COMMAND_LIST(SHELL_GEN_CHECK)
+
+SHELL_COMMAND_LIST(SHELL_GEN_ARG_LIST)
+
+/**
+  * @brief  Command names, packed in table order. The templates and the name index point here.
+  */
+typedef struct {
+	SHELL_COMMAND_LIST(SHELL_GEN_NAME_FIELD)
+} shellCmdNamePool_t;
+
+static const shellCmdNamePool_t shellCmdNamePool = {
+		SHELL_COMMAND_LIST(SHELL_GEN_NAME_POOL)
 };
 
+const shellCmdTemplate_t shellCmdTemplateTable[NUM_OF_COMMANDS] = {
+		SHELL_COMMAND_LIST(SHELL_GEN_ENTRY)
+};
+
+const uint16_t shellUrgentTable[] = {
+		SHELL_URGENT_LIST(SHELL_GEN_URGENT)
+		NUM_OF_COMMANDS
+};
+
+const uint16_t shellCacheTable[] = {
+		SHELL_CACHE_LIST(SHELL_GEN_CACHE)
+		NUM_OF_COMMANDS
+};
+
+const uint16_t shellArmTable[] = {
+		SHELL_ARM_LIST(SHELL_GEN_ARM)
+		NUM_OF_COMMANDS
+};
 
+const uint16_t shellDeadlineTable[NUM_OF_COMMANDS] = {
+		SHELL_DEADLINE_LIST(SHELL_GEN_DEADLINE)
+};
 
 #endif // CLI_SHELL_COMMANDS_H_
 
@@ -0,0 +1,123 @@
+/** @file CLI_SHELL_CONFIG.h
+ *
+ * @brief Buffer geometry of the CLI Shell: one sizing profile for lines, rings and queues
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - SHELL_SIZE_PROFILE picks the sizes below, set it here or with -DSHELL_SIZE_PROFILE=<n> in
+ *    the project settings. Every size can still be set on its own (-DSHELL_TX_QUEUE_LEN=2048),
+ *    the profile only fills in the ones that are not.
+ *
+ *                                  MINIMAL     DEFAULT     THROUGHPUT
+ *      SHELL_BUFFER_LEN            80          200         255         line, per instance
+ *      SHELL_CMD_LEN               12          16          24          longest command name
+ *      SHELL_ARG_LEN               12          20          40          scalar/string contents
+ *      SHELL_ARRAY_MAX             16          64          128         elements of an array
+ *      SHELL_RX_RING_LEN           256         512         2048        receive ring, per instance
+ *      SHELL_TX_QUEUE_LEN          512         1024        4096        transmit queue, per port
+ *      SHELL_STREAM_QUEUE_LEN      1024        4096        8192        USB stream queue
+ *      SHELL_MAX_CMDS_PER_POLL     2           4           8           lines per checkShellStatus()
+ *
+ *    MINIMAL saves about 6 KB of RAM against DEFAULT with the three instances of main.c, at the
+ *    cost of shorter lines and more waiting for room in the queues. THROUGHPUT buys longer
+ *    batches and array writes and keeps the USB endpoints busy through longer main loop stalls.
+ *  - SHELL_CMD_LEN bounds the command names of the table (checked for every entry when
+ *    CLI_SHELL_COMMANDS.h is compiled), SHELL_ARG_LEN every argument but arrays.
+ *  - The checks below fail the build on sizes that do not fit together. Sizes that depend on
+ *    the transport (USB packets, stream transfers) are checked in usbd_cdc_if.c.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CONFIG_H_
+#define CLI_SHELL_CONFIG_H_
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_PROFILE_MINIMAL			0
+#define SHELL_PROFILE_DEFAULT			1
+#define SHELL_PROFILE_THROUGHPUT		2
+
+#ifndef SHELL_SIZE_PROFILE
+#define SHELL_SIZE_PROFILE				SHELL_PROFILE_DEFAULT
+#endif
+
+#if SHELL_SIZE_PROFILE == SHELL_PROFILE_MINIMAL
+#define SHELL_PROFILE_BUFFER_LEN		80
+#define SHELL_PROFILE_CMD_LEN			12
+#define SHELL_PROFILE_ARG_LEN			12
+#define SHELL_PROFILE_ARRAY_MAX			16
+#define SHELL_PROFILE_RX_RING_LEN		256
+#define SHELL_PROFILE_TX_QUEUE_LEN		512
+#define SHELL_PROFILE_STREAM_QUEUE_LEN	1024
+#define SHELL_PROFILE_CMDS_PER_POLL		2
+#elif SHELL_SIZE_PROFILE == SHELL_PROFILE_DEFAULT
+#define SHELL_PROFILE_BUFFER_LEN		200
+#define SHELL_PROFILE_CMD_LEN			16
+#define SHELL_PROFILE_ARG_LEN			20
+#define SHELL_PROFILE_ARRAY_MAX			64
+#define SHELL_PROFILE_RX_RING_LEN		512
+#define SHELL_PROFILE_TX_QUEUE_LEN		1024
+#define SHELL_PROFILE_STREAM_QUEUE_LEN	4096
+#define SHELL_PROFILE_CMDS_PER_POLL		4
+#elif SHELL_SIZE_PROFILE == SHELL_PROFILE_THROUGHPUT
+#define SHELL_PROFILE_BUFFER_LEN		255
+#define SHELL_PROFILE_CMD_LEN			24
+#define SHELL_PROFILE_ARG_LEN			40
+#define SHELL_PROFILE_ARRAY_MAX			128
+#define SHELL_PROFILE_RX_RING_LEN		2048
+#define SHELL_PROFILE_TX_QUEUE_LEN		4096
+#define SHELL_PROFILE_STREAM_QUEUE_LEN	8192
+#define SHELL_PROFILE_CMDS_PER_POLL		8
+#else
+#error "Unknown SHELL_SIZE_PROFILE"
+#endif
+
+#ifndef SHELL_BUFFER_LEN
+#define SHELL_BUFFER_LEN				SHELL_PROFILE_BUFFER_LEN		/*!< Line Buffer Length (255 max, offsets are uint8_t)	*/
+#endif
+#ifndef SHELL_CMD_LEN
+#define SHELL_CMD_LEN					SHELL_PROFILE_CMD_LEN			/*!< Maximum Command Name Length		*/
+#endif
+#ifndef SHELL_ARG_LEN
+#define SHELL_ARG_LEN					SHELL_PROFILE_ARG_LEN			/*!< Maximum Argument Content Length (not arrays)	*/
+#endif
+#ifndef SHELL_ARRAY_MAX
+#define SHELL_ARRAY_MAX					SHELL_PROFILE_ARRAY_MAX			/*!< Maximum Elements of an Array Argument	*/
+#endif
+#ifndef SHELL_RX_RING_LEN
+#define SHELL_RX_RING_LEN				SHELL_PROFILE_RX_RING_LEN		/*!< Default Receive Ring Size (power of two)	*/
+#endif
+#ifndef SHELL_TX_QUEUE_LEN
+#define SHELL_TX_QUEUE_LEN				SHELL_PROFILE_TX_QUEUE_LEN		/*!< Transmit Queue of each Port (power of two)	*/
+#endif
+#ifndef SHELL_STREAM_QUEUE_LEN
+#define SHELL_STREAM_QUEUE_LEN			SHELL_PROFILE_STREAM_QUEUE_LEN	/*!< USB Stream Queue (power of two)	*/
+#endif
+#ifndef SHELL_MAX_CMDS_PER_POLL
+#define SHELL_MAX_CMDS_PER_POLL			SHELL_PROFILE_CMDS_PER_POLL		/*!< Commands run per checkShellStatus()	*/
+#endif
+
+/**
+  * @brief  Consistency of the sizes
+  */
+#define SHELL_IS_POW2(len)				((len) != 0 && ((len) & ((len) - 1)) == 0)
+
+_Static_assert(SHELL_BUFFER_LEN <= 255, "SHELL_BUFFER_LEN above 255, argument offsets are uint8_t");
+_Static_assert(SHELL_CMD_LEN > 0 && SHELL_CMD_LEN < SHELL_BUFFER_LEN, "SHELL_CMD_LEN must leave room for arguments");
+_Static_assert(SHELL_ARG_LEN > 0 && SHELL_ARG_LEN < SHELL_BUFFER_LEN, "SHELL_ARG_LEN longer than a line");
+_Static_assert(SHELL_ARRAY_MAX > 0 && SHELL_ARRAY_MAX <= 255, "SHELL_ARRAY_MAX out of 1..255, counts are uint8_t");
+_Static_assert(SHELL_IS_POW2(SHELL_RX_RING_LEN), "SHELL_RX_RING_LEN must be a power of two");
+_Static_assert(SHELL_IS_POW2(SHELL_TX_QUEUE_LEN), "SHELL_TX_QUEUE_LEN must be a power of two");
+_Static_assert(SHELL_IS_POW2(SHELL_STREAM_QUEUE_LEN), "SHELL_STREAM_QUEUE_LEN must be a power of two");
+_Static_assert(SHELL_TX_QUEUE_LEN > SHELL_BUFFER_LEN, "SHELL_TX_QUEUE_LEN cannot take a line of output");
+_Static_assert(SHELL_MAX_CMDS_PER_POLL > 0 && SHELL_MAX_CMDS_PER_POLL <= 255, "SHELL_MAX_CMDS_PER_POLL out of 1..255");
+
+#endif // CLI_SHELL_CONFIG_H_
+
+/*** end of file ***/
@@ -0,0 +1,229 @@
+/** @file CLI_SHELL_CONVERT.c
+ *
+ * @brief Locale-free number parsers for CLI Shell arguments
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <float.h>
+
+#include "CLI_SHELL_CONVERT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define FLOAT_MAX_DIGITS		9			/*!< Significant digits that fit the uint32_t mantissa	*/
+#define FLOAT_MAX_EXPONENT		38
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  Powers of ten for scaling the float mantissa
+  */
+static const float pow10Table[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+
+#define POW10_TABLE_MAX		((int16_t)(sizeof(pow10Table) / sizeof(pow10Table[0])) - 1)
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static int8_t digitValue(uint8_t c, uint8_t base);
+static float scalePow10(float value, int16_t exponent);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Value of a digit in the given base
+  * @param[IN]  c Character
+  * @param[IN]  base 2, 10 or 16
+  * @retval int8_t Digit value, or -1 if c is not a digit of the base
+  */
+static int8_t digitValue(uint8_t c, uint8_t base) {
+	int8_t digit;
+
+	if (c >= '0' && c <= '9') {
+		digit = c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		digit = c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		digit = c - 'A' + 10;
+	} else {
+		return -1;
+	}
+
+	return (digit < base) ? digit : -1;
+}
+
+/**
+  * @brief  Multiplies by 10^exponent using the power table
+  * @param[IN]  value Value to scale
+  * @param[IN]  exponent Power of ten (may be negative)
+  * @retval float Scaled value
+  */
+static float scalePow10(float value, int16_t exponent) {
+	while (exponent > 0) {
+		int16_t step = (exponent > POW10_TABLE_MAX) ? POW10_TABLE_MAX : exponent;
+		value *= pow10Table[step];
+		exponent -= step;
+	}
+	while (exponent < 0) {
+		int16_t step = (-exponent > POW10_TABLE_MAX) ? POW10_TABLE_MAX : -exponent;
+		value /= pow10Table[step];
+		exponent += step;
+	}
+	return value;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Parses an unsigned decimal, 0x hex or 0b binary integer
+  * @param[IN]  str NUL-terminated string
+  * @param[IN]  maxValue Largest accepted value (e.g. 0xFF for a uint8_t)
+  * @param[OUT] value Parsed value
+  * @retval bool Returns false on an empty string, a stray character or a value above maxValue
+  */
+bool shellParseUnsigned(const uint8_t* str, uint32_t maxValue, uint32_t* value) {
+	uint8_t base = 10;
+	uint32_t result = 0;
+	int8_t digit;
+
+	if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+		base = 16;
+		str += 2;
+	} else if (str[0] == '0' && (str[1] == 'b' || str[1] == 'B')) {
+		base = 2;
+		str += 2;
+	}
+
+	if (*str == '\0') {
+		return false;
+	}
+
+	// Anything above limit would overflow maxValue on the next digit
+	uint32_t limit = maxValue / base;
+	uint8_t lastDigit = maxValue % base;
+
+	while (*str != '\0') {
+		digit = digitValue(*str++, base);
+		if (digit < 0) {
+			return false;
+		}
+		if (result > limit || (result == limit && (uint8_t)digit > lastDigit)) {
+			return false;
+		}
+		result = (result * base) + digit;
+	}
+
+	*value = result;
+	return true;
+}
+
+/**
+  * @brief  Parses a decimal floating point number
+  * @note	Up to FLOAT_MAX_DIGITS significant digits are used, further digits only move the
+  * 		decimal point. Accurate to float precision for typical command values.
+  * @param[IN]  str NUL-terminated string
+  * @param[OUT] value Parsed value
+  * @retval bool Returns false on an empty string, a stray character or an exponent out of range
+  */
+bool shellParseFloat(const uint8_t* str, float* value) {
+	bool negative = false;
+	bool digitsFound = false;
+	uint32_t mantissa = 0;
+	uint8_t mantissaDigits = 0;
+	int16_t exponent = 0;
+
+	if (*str == '-' || *str == '+') {
+		negative = (*str == '-');
+		str++;
+	}
+
+	// Integer part
+	while (*str >= '0' && *str <= '9') {
+		digitsFound = true;
+		if (mantissaDigits < FLOAT_MAX_DIGITS) {
+			mantissa = (mantissa * 10) + (*str - '0');
+			if (mantissa != 0) {
+				mantissaDigits++;
+			}
+		} else {
+			exponent++;
+		}
+		str++;
+	}
+
+	// Fraction part
+	if (*str == '.') {
+		str++;
+		while (*str >= '0' && *str <= '9') {
+			digitsFound = true;
+			if (mantissaDigits < FLOAT_MAX_DIGITS) {
+				mantissa = (mantissa * 10) + (*str - '0');
+				if (mantissa != 0) {
+					mantissaDigits++;
+				}
+				exponent--;
+			}
+			str++;
+		}
+	}
+
+	if (!digitsFound) {
+		return false;
+	}
+
+	// Exponent part
+	if (*str == 'e' || *str == 'E') {
+		bool expNegative = false;
+		int16_t expValue = 0;
+
+		str++;
+		if (*str == '-' || *str == '+') {
+			expNegative = (*str == '-');
+			str++;
+		}
+		if (*str < '0' || *str > '9') {
+			return false;
+		}
+		while (*str >= '0' && *str <= '9') {
+			expValue = (expValue * 10) + (*str++ - '0');
+			if (expValue > (FLOAT_MAX_EXPONENT * 2)) {
+				return false;
+			}
+		}
+		exponent += expNegative ? -expValue : expValue;
+	}
+
+	if (*str != '\0') {
+		return false;
+	}
+
+	if ((exponent + mantissaDigits) > (FLOAT_MAX_EXPONENT + 1)) {
+		// Beyond the float range
+		return false;
+	}
+
+	float result = scalePow10((float)mantissa, exponent);
+	if (result > FLT_MAX) {
+		return false;
+	}
+	*value = negative ? -result : result;
+	return true;
+}
+
+/*** end of file ***/
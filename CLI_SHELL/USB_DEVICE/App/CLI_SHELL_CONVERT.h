@@ -0,0 +1,36 @@
+/** @file CLI_SHELL_CONVERT.h
+ *
+ * @brief Locale-free number parsers for CLI Shell arguments
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Unsigned integers accept decimal ("123"), hex ("0x7B") and binary ("0b1111011").
+ *  - Floats accept an optional sign, a decimal point and an exponent ("-1.5", "2e-3").
+ *  - The whole string must be consumed. Empty strings, stray characters and values out of
+ *    range are rejected.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CONVERT_H_
+#define CLI_SHELL_CONVERT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellParseUnsigned(const uint8_t* str, uint32_t maxValue, uint32_t* value);
+bool shellParseFloat(const uint8_t* str, float* value);
+
+#endif // CLI_SHELL_CONVERT_H_
+
+/*** end of file ***/
@@ -0,0 +1,279 @@
+/** @file CLI_SHELL_COPY.c
+ *
+ * @brief Copy service of the CLI Shell: bulk moves on the DMA2 memory-to-memory streams
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_COPY.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define COPY_FLAG_DONE			0x20U		/*!< TCIF of stream 0, shifted per stream	*/
+#define COPY_FLAG_ERRORS		0x0CU		/*!< TEIF, DMEIF							*/
+#define COPY_FLAG_ALL			0x3DU		/*!< Every flag of a stream					*/
+#define COPY_MAX_ITEMS			0xFFFFU		/*!< NDTR									*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  One stream and the copy it runs
+  * @note	Claimed by shellCopyStart() with interrupts masked, released by the interrupt.
+  */
+typedef struct {
+	DMA_Stream_TypeDef* stream;
+	IRQn_Type irq;
+	uint8_t flagShift;						/*!< Position of the stream in LISR			*/
+	volatile bool busy;
+	bool words;								/*!< Word items, else byte items			*/
+	uint8_t* dst;							/*!< Next byte not handed to the DMA yet	*/
+	const uint8_t* src;
+	uint32_t remaining;						/*!< Bytes from dst on						*/
+	shellCopyDone_t done;
+	void* context;
+} shellCopyChannel_t;
+
+/**
+  * @brief  Copies done by each path ("mem")
+  */
+typedef struct {
+	uint32_t dmaCopies;
+	uint32_t cpuCopies;
+	uint32_t dmaBytes;
+	uint32_t errors;
+} shellCopyStats_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellCopyChannel_t channels[SHELL_COPY_CHANNELS] = {
+	{ .stream = DMA2_Stream1, .irq = DMA2_Stream1_IRQn, .flagShift = 6 },
+	{ .stream = DMA2_Stream3, .irq = DMA2_Stream3_IRQn, .flagShift = 22 },
+};
+static shellCopyStats_t stats;
+static bool clocked;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool copyReachable(const void* dst, const void* src, uint32_t len);
+static shellCopyChannel_t* copyClaim(void);
+static void copyNext(shellCopyChannel_t* channel);
+static void copyInterrupt(shellCopyChannel_t* channel);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Whether the DMA can do a copy
+  * @param[IN]  dst Destination, SRAM
+  * @param[IN]  src Source, flash, system memory or SRAM
+  * @param[IN]  len Number of bytes
+  * @retval bool Returns false for the peripheral and private peripheral regions
+  */
+static bool copyReachable(const void* dst, const void* src, uint32_t len) {
+	uint32_t d = (uint32_t)dst;
+	uint32_t s = (uint32_t)src;
+
+	return d >= SRAM_BASE && d < PERIPH_BASE && (PERIPH_BASE - d) >= len &&
+			s < PERIPH_BASE && (PERIPH_BASE - s) >= len;
+}
+
+/**
+  * @brief  Takes a free stream, also from an interrupt
+  * @note	Turns the DMA2 clock on and sets the stream interrupts up with the first claim.
+  * @param  NONE
+  * @retval shellCopyChannel_t* The stream, NULL if both are busy
+  */
+static shellCopyChannel_t* copyClaim(void) {
+	uint32_t primask = __get_PRIMASK();
+	shellCopyChannel_t* claimed = NULL;
+
+	__disable_irq();
+	if (!clocked) {
+		__HAL_RCC_DMA2_CLK_ENABLE();
+		for (uint8_t i = 0; i < SHELL_COPY_CHANNELS; i++) {
+			HAL_NVIC_SetPriority(channels[i].irq, SHELL_COPY_IRQ_PRIORITY, 0);
+			HAL_NVIC_EnableIRQ(channels[i].irq);
+		}
+		clocked = true;
+	}
+	for (uint8_t i = 0; i < SHELL_COPY_CHANNELS; i++) {
+		if (!channels[i].busy) {
+			channels[i].busy = true;
+			claimed = &channels[i];
+			break;
+		}
+	}
+	__set_PRIMASK(primask);
+
+	return claimed;
+}
+
+/**
+  * @brief  Starts the stream on the next part of its copy
+  * @note	Memory-to-memory: the peripheral port reads (PAR), the memory port writes (M0AR).
+  * 		It needs the FIFO, full threshold, single beats.
+  * @param[IN]  channel The stream
+  * @retval NONE
+  */
+static void copyNext(shellCopyChannel_t* channel) {
+	uint32_t items = channel->words ? (channel->remaining / 4) : channel->remaining;
+	uint32_t size = channel->words ? (DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1) : 0U;
+
+	if (items > COPY_MAX_ITEMS) {
+		items = COPY_MAX_ITEMS;
+	}
+
+	DMA2->LIFCR = COPY_FLAG_ALL << channel->flagShift;
+	channel->stream->PAR = (uint32_t)channel->src;
+	channel->stream->M0AR = (uint32_t)channel->dst;
+	channel->stream->NDTR = items;
+	channel->stream->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+	channel->stream->CR = DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_MINC | size |
+			DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_DMEIE | DMA_SxCR_EN;
+
+	uint32_t bytes = channel->words ? items * 4 : items;
+	channel->dst += bytes;
+	channel->src += bytes;
+	channel->remaining -= bytes;
+}
+
+/**
+  * @brief  End of a part: starts the next one, or completes the copy
+  * @note	The stream is free again before done() runs, so done() may start the next copy.
+  * @param[IN]  channel The stream of the interrupt
+  * @retval NONE
+  */
+static void copyInterrupt(shellCopyChannel_t* channel) {
+	uint32_t flags = (DMA2->LISR >> channel->flagShift) & COPY_FLAG_ALL;
+	bool ok = true;
+
+	DMA2->LIFCR = COPY_FLAG_ALL << channel->flagShift;
+	if ((flags & COPY_FLAG_ERRORS) != 0) {
+		channel->stream->CR &= ~DMA_SxCR_EN;
+		stats.errors++;
+		ok = false;
+	} else if ((flags & COPY_FLAG_DONE) == 0) {
+		return;
+	} else if (channel->words && channel->remaining >= 4) {
+		copyNext(channel);
+		return;
+	} else if (!channel->words && channel->remaining > 0) {
+		copyNext(channel);
+		return;
+	} else {
+		// The bytes after the last word
+		memcpy(channel->dst, channel->src, channel->remaining);
+	}
+
+	shellCopyDone_t done = channel->done;
+	void* context = channel->context;
+
+	channel->busy = false;
+	done(ok, context);
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Copies a block, in the background if it is worth it, see CLI_SHELL_COPY.h
+  * @param[OUT]  dst Destination, SRAM
+  * @param[IN]  src Source, flash, system memory or SRAM
+  * @param[IN]  len Number of bytes
+  * @param[IN]  done Called once the bytes are there
+  * @param[IN]  context Handed to done
+  * @retval bool Returns true if the DMA copies, false if it was copied and done() called already
+  */
+bool shellCopyStart(void* dst, const void* src, uint32_t len, shellCopyDone_t done, void* context) {
+	shellCopyChannel_t* channel = NULL;
+
+	if (len >= SHELL_COPY_DMA_MIN && copyReachable(dst, src, len)) {
+		channel = copyClaim();
+	}
+	if (channel == NULL) {
+		memcpy(dst, src, len);
+		stats.cpuCopies++;
+		done(true, context);
+		return false;
+	}
+
+	channel->words = (((uint32_t)dst | (uint32_t)src) & 3U) == 0;
+	channel->dst = (uint8_t*)dst;
+	channel->src = (const uint8_t*)src;
+	channel->remaining = len;
+	channel->done = done;
+	channel->context = context;
+	stats.dmaCopies++;
+	stats.dmaBytes += len;
+
+	copyNext(channel);
+	return true;
+}
+
+/**
+  * @brief  Adds the copy line to the "mem" dump
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellCopyReport(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 96);
+
+	shellStrAppend(&str, "Copy: ");
+	shellStrAppendUnsigned(&str, stats.dmaCopies, 0);
+	shellStrAppend(&str, " by DMA (");
+	shellStrAppendUnsigned(&str, stats.dmaBytes, 0);
+	shellStrAppend(&str, " bytes), ");
+	shellStrAppendUnsigned(&str, stats.cpuCopies, 0);
+	shellStrAppend(&str, " by the CPU, ");
+	shellStrAppendUnsigned(&str, stats.errors, 0);
+	shellStrAppend(&str, " errors\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/********************************************************************************
+ * INTERRUPT HANDLERS
+ *******************************************************************************/
+/**
+  * @brief  DMA2 Stream 1, copy channel 0
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream1_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	copyInterrupt(&channels[0]);
+	SHELL_ISR_RECORD(isrId_copy, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  DMA2 Stream 3, copy channel 1
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream3_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	copyInterrupt(&channels[1]);
+	SHELL_ISR_RECORD(isrId_copy, start, SHELL_ISR_NO_LATENCY);
+}
+
+/*** end of file ***/
@@ -0,0 +1,72 @@
+/** @file CLI_SHELL_COPY.h
+ *
+ * @brief Copy service of the CLI Shell: bulk moves on the DMA2 memory-to-memory streams
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - shellCopyStart(dst, src, len, done, context) copies len bytes in the background and calls
+ *    done(ok, context) when they are there. The CPU parses and dispatches meanwhile, the copy
+ *    takes the bus matrix cycles the core leaves free.
+ *  - Two copies run at a time, on DMA2 Streams 1 and 3 (the CRC service has Stream 0, the ADC 4,
+ *    the pattern output 5, the USART 2 and 7). Only DMA2 can copy memory to memory.
+ *  - Copies below SHELL_COPY_DMA_MIN, copies while both streams are busy and copies the DMA
+ *    cannot reach are done with memcpy() right away: done() is called before shellCopyStart()
+ *    returns, from the caller. Setting up a stream and taking its interrupt costs about as
+ *    much as copying a hundred bytes.
+ *  - A DMA copy calls done() from the stream interrupt, at SHELL_COPY_IRQ_PRIORITY. It may start
+ *    the next copy. Callers that continue in the main loop note the completion there and signal
+ *    it (shellEventSignal()), the service signals SHELL_EVENT_PERIPH itself.
+ *  - Source and destination are flash (source only), system memory (source only) or SRAM, any
+ *    alignment. Word aligned copies move words, the last 1 to 3 bytes go with the completion.
+ *    Others move bytes. Neither may change until done() is called. The DMA ignores the MPU:
+ *    a copy into the stack guard (CLI_SHELL_MPU.h) does not fault.
+ *  - Used by the raw memory dumps ("mrd f1", CLI_SHELL_MEM.h) and the firmware staging buffers
+ *    (CLI_SHELL_FWUPDATE.h). The transmit and stream queues keep memcpy(): their producers
+ *    publish the bytes when the write returns. "mem" shows the copies done by each path.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_COPY_H_
+#define CLI_SHELL_COPY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_COPY_DMA_MIN
+#define SHELL_COPY_DMA_MIN				128			/*!< Smaller copies are not worth the DMA	*/
+#endif
+#define SHELL_COPY_CHANNELS				2			/*!< DMA2 Streams 1 and 3				*/
+#define SHELL_COPY_IRQ_PRIORITY			2			/*!< Below OTG_FS, done() runs here		*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Completion of a copy
+  * @param  ok false on a DMA transfer error, the destination is incomplete
+  * @param  context As passed to shellCopyStart()
+  */
+typedef void (*shellCopyDone_t)(bool ok, void* context);
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellCopyStart(void* dst, const void* src, uint32_t len, shellCopyDone_t done, void* context);
+void shellCopyReport(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_COPY_H_
+
+/*** end of file ***/
@@ -0,0 +1,344 @@
+/** @file CLI_SHELL_CRASH.c
+ *
+ * @brief Post-mortem record of the CLI Shell: the fault handlers and the "crash" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Handlers turn the MPU off first, the record names a guard hit (CLI_SHELL_MPU)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_CRASH.h"
+#include "CLI_SHELL_TRACE.h"
+#include "CLI_SHELL_MPU.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define CRASH_STR(x)				#x
+#define CRASH_XSTR(x)				CRASH_STR(x)
+
+/**
+  * @brief  Defines a fault handler that hands the stacked frame, EXC_RETURN and the fault class to
+  * 		crashCapture(). Naked, the stack pointer must be read before anything is pushed.
+  * @note	A stack pointer below RAM (overflow) is moved to the top, crashCapture() needs a stack.
+  * 		The MPU goes off first (MPU->CTRL = 0), the stack pointer may sit in the stack guard.
+  */
+#define CRASH_HANDLER(handler, fault) \
+		__attribute__((naked)) void handler(void) { \
+			__asm volatile ( \
+				"ldr r3, =0xE000ED94\n" \
+				"movs r2, #0\n" \
+				"str r2, [r3]\n" \
+				"dsb\n" \
+				"isb\n" \
+				"tst lr, #4\n" \
+				"ite eq\n" \
+				"mrseq r0, msp\n" \
+				"mrsne r0, psp\n" \
+				"mov r1, lr\n" \
+				"movs r2, #" CRASH_XSTR(fault) "\n" \
+				"ldr r3, =_sdata\n" \
+				"cmp sp, r3\n" \
+				"itt lo\n" \
+				"ldrlo r3, =_estack\n" \
+				"movlo sp, r3\n" \
+				"b crashCapture\n"); \
+		}
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+SHELL_NOINIT static shellCrashRecord_t crashRecord;
+
+volatile shellCrashLine_t shellCrashLine;
+
+// Linker script symbols, only their addresses mean something
+extern uint32_t _sdata, _estack;
+
+static const char* const faultNames[] = {
+	[SHELL_CRASH_HARD]		= "HardFault",
+	[SHELL_CRASH_MEMMANAGE]	= "MemManage",
+	[SHELL_CRASH_BUS]		= "BusFault",
+	[SHELL_CRASH_USAGE]		= "UsageFault",
+};
+
+// Set bits of CFSR, MMFSR (0-7), BFSR (8-15), UFSR (16-31)
+static const char* const cfsrNames[32] = {
+	[0] = "IACCVIOL",	[1] = "DACCVIOL",	[3] = "MUNSTKERR",	[4] = "MSTKERR",
+	[5] = "MLSPERR",	[7] = "MMARVALID",	[8] = "IBUSERR",	[9] = "PRECISERR",
+	[10] = "IMPRECISERR", [11] = "UNSTKERR", [12] = "STKERR",	[13] = "LSPERR",
+	[15] = "BFARVALID",	[16] = "UNDEFINSTR", [17] = "INVSTATE",	[18] = "INVPC",
+	[19] = "NOCP",		[24] = "UNALIGNED",	[25] = "DIVBYZERO",
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool inRam(uint32_t address, uint32_t length);
+static bool recordValid(void);
+void crashCapture(uint32_t* frame, uint32_t excReturn, uint32_t fault) __attribute__((used, noreturn));
+static void printRegister(shellStr_t* str, const char* name, uint32_t value);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Whether a range lies in the RAM below the initial stack pointer
+  * @param[IN]  address Start
+  * @param[IN]  length Bytes
+  * @retval bool
+  */
+static bool inRam(uint32_t address, uint32_t length) {
+	return (address >= (uint32_t)&_sdata) && (address <= (uint32_t)&_estack)
+			&& (length <= (uint32_t)&_estack - address);
+}
+
+/**
+  * @brief  Whether the record holds a fault
+  * @param  NONE
+  * @retval bool
+  */
+static bool recordValid(void) {
+	return (crashRecord.magic == SHELL_CRASH_MAGIC) && (crashRecord.check == ~SHELL_CRASH_MAGIC)
+			&& (crashRecord.fault >= SHELL_CRASH_HARD) && (crashRecord.fault <= SHELL_CRASH_USAGE);
+}
+
+/**
+  * @brief  Fills the record and resets, called by the fault handlers only
+  * @note	Runs in handler mode at fault priority. Reads nothing outside the RAM that the fault
+  * 		could have corrupted: the frame and the command line are range checked first.
+  * @param[IN]  frame Stack pointer at the fault, the exception frame if stacking worked
+  * @param[IN]  excReturn EXC_RETURN of the handler
+  * @param[IN]  fault SHELL_CRASH_
+  * @retval NONE
+  */
+void crashCapture(uint32_t* frame, uint32_t excReturn, uint32_t fault) {
+	uint32_t address = (uint32_t)frame;
+	uint32_t count = recordValid() ? crashRecord.count : 0;
+
+	crashRecord.magic = 0;
+	crashRecord.count = count + 1;
+	crashRecord.fault = fault;
+	crashRecord.excReturn = excReturn;
+	crashRecord.cfsr = SCB->CFSR;
+	crashRecord.hfsr = SCB->HFSR;
+	crashRecord.mmfar = SCB->MMFAR;
+	crashRecord.bfar = SCB->BFAR;
+	crashRecord.cycles = shellPerfCycles();
+
+	// Stacking into a guard or a bad address faulted, nothing was stacked
+	crashRecord.frameValid = ((address & 3U) == 0) && inRam(address, sizeof(crashRecord.frame))
+			&& ((crashRecord.cfsr & (SCB_CFSR_MSTKERR_Msk | SCB_CFSR_STKERR_Msk)) == 0);
+	if (crashRecord.frameValid) {
+		// Basic frame 8 words, with the FPU state 26. xPSR bit 9: one word of alignment padding.
+		uint32_t frameLen = ((excReturn & 0x10U) != 0) ? 32U : 104U;
+
+		memcpy(crashRecord.frame, frame, sizeof(crashRecord.frame));
+		crashRecord.sp = address + frameLen + (((crashRecord.frame[7] & (1UL << 9)) != 0) ? 4U : 0U);
+	} else {
+		memset(crashRecord.frame, 0, sizeof(crashRecord.frame));
+		crashRecord.sp = address;
+	}
+
+	// The line is tokenized in place, the NULs between the tokens go back to spaces
+	const uint8_t* line = shellCrashLine.line;
+	uint32_t len = shellCrashLine.len;
+	if (len > SHELL_CRASH_LINE_LEN) {
+		len = SHELL_CRASH_LINE_LEN;
+	}
+	if (line == NULL || !inRam((uint32_t)line, len)) {
+		len = 0;
+	}
+	for (uint32_t i = 0; i < len; i++) {
+		crashRecord.line[i] = (line[i] == '\0') ? ' ' : (char)line[i];
+	}
+	crashRecord.lineLen = (uint8_t)len;
+	crashRecord.linePort = shellCrashLine.port;
+
+	// Newest trace entries, a ring not started since power-up has none
+	uint32_t head = shellTraceRing.head;
+	uint32_t entries = 0;
+	if (shellTraceRing.magic == SHELL_TRACE_RING_MAGIC && shellTraceRing.check == ~SHELL_TRACE_RING_MAGIC) {
+		entries = (head < SHELL_CRASH_TRACE_ENTRIES) ? head : SHELL_CRASH_TRACE_ENTRIES;
+	}
+	for (uint32_t i = 0; i < entries; i++) {
+		crashRecord.trace[i] = shellTraceRing.entries[(head - entries + i) & (SHELL_TRACE_DEPTH - 1)];
+	}
+	crashRecord.traceCount = entries;
+
+	crashRecord.check = ~SHELL_CRASH_MAGIC;
+	crashRecord.magic = SHELL_CRASH_MAGIC;
+
+	NVIC_SystemReset();
+}
+
+/**
+  * @brief  Appends "<name> 0x<value> "
+  * @param[IN]  str Output
+  * @param[IN]  name Register name
+  * @param[IN]  value Register value
+  * @retval NONE
+  */
+static void printRegister(shellStr_t* str, const char* name, uint32_t value) {
+	shellStrAppend(str, name);
+	shellStrAppend(str, " 0x");
+	shellStrAppendHex(str, value, 8);
+	shellStrAppendChar(str, ' ');
+}
+
+/********************************************************************************
+ * HANDLERS
+ *******************************************************************************/
+#if SHELL_CRASH_ENABLE
+CRASH_HANDLER(HardFault_Handler, SHELL_CRASH_HARD)
+CRASH_HANDLER(MemManage_Handler, SHELL_CRASH_MEMMANAGE)
+CRASH_HANDLER(BusFault_Handler, SHELL_CRASH_BUS)
+CRASH_HANDLER(UsageFault_Handler, SHELL_CRASH_USAGE)
+#endif
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Enables the configurable fault exceptions, they escalate to HardFault otherwise
+  * @param  NONE
+  * @retval NONE
+  */
+void shellCrashInit(void) {
+#if SHELL_CRASH_ENABLE
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+#endif
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Prints the record of the last fault, clears it (c1) or faults on purpose (f1)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error CrashBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 96);
+
+	if (shellHasArg(parserInput, argTkn_f) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8 != 0) {
+		// UsageFault UNDEFINSTR, the reset follows
+		__asm volatile ("udf #0");
+	}
+	if (shellHasArg(parserInput, argTkn_c) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 != 0) {
+		crashRecord.magic = 0;
+		return SHELL_OK;
+	}
+
+	if (!recordValid()) {
+		shellStrAppend(&str, "No crash recorded\r\n");
+		shellStrSend(ctx, &str);
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, faultNames[crashRecord.fault]);
+	shellStrAppend(&str, ", fault ");
+	shellStrAppendUnsigned(&str, crashRecord.count, 0);
+	shellStrAppend(&str, " since power-up, ");
+	shellStrAppendUnsigned(&str, crashRecord.cycles, 0);
+	shellStrAppend(&str, " cycles after reset\r\n");
+	shellStrSend(ctx, &str);
+
+	if (crashRecord.frameValid) {
+		static const char* const frameNames[8] = { "R0", "R1", "R2", "R3", "R12", "LR", "PC", "xPSR" };
+
+		for (uint8_t i = 0; i < 8; i++) {
+			printRegister(&str, frameNames[i], crashRecord.frame[i]);
+			if (i == 3 || i == 7) {
+				shellStrAppend(&str, "\r\n");
+				shellStrSend(ctx, &str);
+			}
+		}
+	} else {
+		shellStrAppend(&str, "Stacked registers lost, SP outside RAM or stacking failed\r\n");
+		shellStrSend(ctx, &str);
+	}
+	printRegister(&str, "SP", crashRecord.sp);
+	printRegister(&str, "EXC_RETURN", crashRecord.excReturn);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+
+	printRegister(&str, "CFSR", crashRecord.cfsr);
+	printRegister(&str, "HFSR", crashRecord.hfsr);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	printRegister(&str, "MMFAR", crashRecord.mmfar);
+	printRegister(&str, "BFAR", crashRecord.bfar);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+
+	shellStrAppend(&str, "Cause:");
+	for (uint8_t bit = 0; bit < 32; bit++) {
+		if ((crashRecord.cfsr & (1UL << bit)) != 0 && cfsrNames[bit] != NULL) {
+			shellStrAppendChar(&str, ' ');
+			shellStrAppend(&str, cfsrNames[bit]);
+		}
+	}
+	if ((crashRecord.hfsr & SCB_HFSR_FORCED_Msk) != 0) {
+		shellStrAppend(&str, " FORCED");
+	}
+	if ((crashRecord.hfsr & SCB_HFSR_VECTTBL_Msk) != 0) {
+		shellStrAppend(&str, " VECTTBL");
+	}
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+
+	// A push faults with the address, a failed exception entry only leaves the stack pointer
+	const char* guard = shellMpuGuardName(((crashRecord.cfsr & SCB_CFSR_MMARVALID_Msk) != 0) ? crashRecord.mmfar : crashRecord.sp);
+	if (guard != NULL) {
+		shellStrAppend(&str, "MPU ");
+		shellStrAppend(&str, guard);
+		shellStrAppend(&str, " hit\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	if (crashRecord.lineLen != 0) {
+		shellStrAppend(&str, "Command (port ");
+		shellStrAppendUnsigned(&str, crashRecord.linePort, 0);
+		shellStrAppend(&str, "): ");
+		shellStrAppendN(&str, crashRecord.line, crashRecord.lineLen);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	shellStrAppend(&str, "Trace, newest last\r\nCycles\t\tEvent\tPort\tArg\r\n");
+	shellStrSend(ctx, &str);
+	for (uint32_t i = 0; i < crashRecord.traceCount && i < SHELL_CRASH_TRACE_ENTRIES; i++) {
+		const shellTraceEntry_t* entry = &crashRecord.trace[i];
+
+		shellStrAppendUnsigned(&str, entry->cycles, 10);
+		shellStrAppendChar(&str, '\t');
+		shellStrAppendUnsigned(&str, entry->event, 0);
+		shellStrAppendChar(&str, '\t');
+		if (entry->port == SHELL_TRACE_NO_PORT) {
+			shellStrAppendChar(&str, '-');
+		} else {
+			shellStrAppendUnsigned(&str, entry->port, 0);
+		}
+		shellStrAppendChar(&str, '\t');
+		shellStrAppendUnsigned(&str, entry->arg, 0);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
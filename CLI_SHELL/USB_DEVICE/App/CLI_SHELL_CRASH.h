@@ -0,0 +1,122 @@
+/** @file CLI_SHELL_CRASH.h
+ *
+ * @brief Post-mortem record of the CLI Shell: fault handlers that survive the reset, the "crash" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) MPU guard hits (CLI_SHELL_MPU.h)
+ *
+ * Usage Notes:
+ *  - HardFault_Handler, MemManage_Handler, BusFault_Handler and UsageFault_Handler are defined
+ *    here, CubeMX does not generate them (CLI_SHELL.ioc, NVIC "Generate IRQ handler" off). They
+ *    store the stacked registers (R0-R3, R12, LR, PC, xPSR), SP, EXC_RETURN, CFSR, HFSR, MMFAR,
+ *    BFAR, the command line being processed and the last SHELL_CRASH_TRACE_ENTRIES entries of
+ *    the trace ring in a .noinit record (SHELL_NOINIT), then reset the MCU.
+ *  - shellCrashInit() (top of main()) enables the MemManage, BusFault and UsageFault exceptions,
+ *    so the record names the fault class instead of an escalated HardFault.
+ *  - "crash" prints the record of the last fault after the reboot, "crash c1" clears it.
+ *    "crash f1" faults on purpose (undefined instruction) to check the path.
+ *  - The record survives soft, watchdog and debugger resets, not a power cycle. The count of
+ *    faults goes up with every fault until the record is cleared or the power is lost.
+ *  - A fault in thread mode with a corrupted stack pointer still gets a record, the stacked
+ *    registers are then marked invalid.
+ *  - The handlers turn the MPU off before anything else. A hit of a guard region of
+ *    CLI_SHELL_MPU.h adds "MPU stack guard hit" or "MPU buffer guard hit" to the record.
+ *  - SHELL_CRASH_NOTE(port, line, len) in shellProcessCommand() keeps a pointer to the line, a
+ *    few stores per command. Only the handler copies the line.
+ *  - Define SHELL_CRASH_ENABLE as 0 to drop the handlers, faults then end in the endless loop of
+ *    Default_Handler (startup code).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CRASH_H_
+#define CLI_SHELL_CRASH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_TRACE.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_CRASH_ENABLE
+#define SHELL_CRASH_ENABLE			(!SHELL_HOST_BUILD)
+#endif
+
+#define SHELL_CRASH_LINE_LEN		64			/*!< Characters of the command line kept	*/
+#define SHELL_CRASH_TRACE_ENTRIES	16			/*!< Newest trace entries kept				*/
+#define SHELL_CRASH_MAGIC			0x43525348U	/*!< Record valid							*/
+
+/**
+  * @brief  Fault classes, numbers for the handler stubs
+  */
+#define SHELL_CRASH_HARD			1
+#define SHELL_CRASH_MEMMANAGE		2
+#define SHELL_CRASH_BUS				3
+#define SHELL_CRASH_USAGE			4
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The record, written by the fault handler only
+  */
+typedef struct {
+	uint32_t magic;							/*!< SHELL_CRASH_MAGIC						*/
+	uint32_t check;							/*!< ~magic									*/
+	uint32_t count;							/*!< Faults since power-up or clear			*/
+	uint32_t fault;							/*!< SHELL_CRASH_							*/
+	uint32_t frame[8];						/*!< R0, R1, R2, R3, R12, LR, PC, xPSR		*/
+	bool frameValid;						/*!< The stack pointer pointed into RAM		*/
+	uint32_t sp;							/*!< Stack pointer before the fault			*/
+	uint32_t excReturn;						/*!< EXC_RETURN (LR of the handler)			*/
+	uint32_t cfsr;
+	uint32_t hfsr;
+	uint32_t mmfar;
+	uint32_t bfar;
+	uint32_t cycles;						/*!< DWT->CYCCNT at the fault				*/
+	uint8_t linePort;						/*!< Port of the command line				*/
+	uint8_t lineLen;						/*!< 0 if no command ran					*/
+	char line[SHELL_CRASH_LINE_LEN];
+	uint32_t traceCount;
+	shellTraceEntry_t trace[SHELL_CRASH_TRACE_ENTRIES];	/*!< Oldest first				*/
+} shellCrashRecord_t;
+
+/**
+  * @brief  Command line being processed, kept for the record
+  */
+typedef struct {
+	const uint8_t* line;
+	uint32_t len;
+	uint8_t port;
+} shellCrashLine_t;
+
+extern volatile shellCrashLine_t shellCrashLine;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellCrashInit(void);
+
+#if SHELL_CRASH_ENABLE
+#define SHELL_CRASH_NOTE(port_, line_, len_) \
+		do { \
+			shellCrashLine.line = (line_); \
+			shellCrashLine.len = (len_); \
+			shellCrashLine.port = (port_); \
+		} while (0)
+#else
+#define SHELL_CRASH_NOTE(port_, line_, len_)	((void)0)
+#endif
+
+#endif // CLI_SHELL_CRASH_H_
+
+/*** end of file ***/
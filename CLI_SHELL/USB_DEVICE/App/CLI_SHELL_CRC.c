@@ -0,0 +1,326 @@
+/** @file CLI_SHELL_CRC.c
+ *
+ * @brief CRC32 service of the CLI Shell: the CRC unit of the STM32F4, DMA for large blocks
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_CRC.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define CRC_DMA_STREAM			DMA2_Stream0
+#define CRC_DMA_DONE			DMA_LISR_TCIF0
+#define CRC_DMA_ERRORS			(DMA_LISR_TEIF0 | DMA_LISR_DMEIF0 | DMA_LISR_FEIF0)
+#define CRC_DMA_FLAGS			(DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | \
+								 DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0)
+#define CRC_DMA_MAX_ITEMS		0xFFFCU		/*!< NDTR, a multiple of 4 for byte items	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Background block
+  */
+typedef struct {
+	volatile bool unitBusy;					/*!< The CRC unit holds a running CRC		*/
+	bool clocked;							/*!< CRC and DMA2 clocks on					*/
+	bool active;							/*!< A block was started, not polled yet	*/
+	bool dma;								/*!< The block runs through the DMA			*/
+	const uint8_t* next;					/*!< First byte not handed to the DMA yet	*/
+	uint32_t remaining;						/*!< Bytes from next on						*/
+	uint32_t result;						/*!< CRC of a block done without the DMA	*/
+} shellCrc_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellCrc_t crcState;
+
+static const uint32_t crcNibbleTable[16] = {
+	0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU, 0x1A864DB2U, 0x1E475005U,
+	0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U, 0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU, 0x384FBDBDU,
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t crcWordAt(const uint8_t* data, uint32_t len);
+static uint32_t crcSoftware(uint32_t crc, const uint8_t* data, uint32_t len);
+#if !SHELL_HOST_BUILD
+static bool crcClaim(void);
+static void crcRelease(void);
+static void crcLoad(uint32_t crc);
+static void crcFeed(const uint8_t* data, uint32_t len);
+static void crcDmaNext(void);
+static void crcDmaStop(void);
+#endif
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Loads the next word as stored in memory, a partial word padded with zeros
+  * @param[IN]  data First byte, any alignment
+  * @param[IN]  len Bytes left, 4 or more for a full word
+  * @retval uint32_t The word
+  */
+static uint32_t crcWordAt(const uint8_t* data, uint32_t len) {
+	uint32_t word = 0;
+
+	// Compiles to a single (unaligned) load for a full word
+	memcpy(&word, data, (len < 4) ? len : 4);
+	return word;
+}
+
+/**
+  * @brief  The CRC unit in software, 4 bits per step
+  * @param[IN]  crc Running CRC
+  * @param[IN]  data Data to add
+  * @param[IN]  len Number of bytes
+  * @retval uint32_t Updated CRC
+  */
+static uint32_t crcSoftware(uint32_t crc, const uint8_t* data, uint32_t len) {
+	while (len > 0) {
+		uint32_t chunk = (len < 4) ? len : 4;
+
+		crc ^= crcWordAt(data, len);
+		for (uint8_t nibble = 0; nibble < 8; nibble++) {
+			crc = (crc << 4) ^ crcNibbleTable[crc >> 28];
+		}
+		data += chunk;
+		len -= chunk;
+	}
+	return crc;
+}
+
+#if !SHELL_HOST_BUILD
+/**
+  * @brief  Takes the CRC unit, also from an interrupt
+  * @note	Turns the CRC and DMA2 clocks on with the first claim.
+  * @retval bool Returns false if the unit is in use
+  */
+static bool crcClaim(void) {
+	uint32_t primask = __get_PRIMASK();
+	bool claimed = false;
+
+	__disable_irq();
+	if (!crcState.unitBusy) {
+		crcState.unitBusy = true;
+		claimed = true;
+		if (!crcState.clocked) {
+			__HAL_RCC_CRC_CLK_ENABLE();
+			__HAL_RCC_DMA2_CLK_ENABLE();
+			crcState.clocked = true;
+		}
+	}
+	__set_PRIMASK(primask);
+
+	return claimed;
+}
+
+/**
+  * @brief  Hands the CRC unit back
+  * @retval NONE
+  */
+static void crcRelease(void) {
+	crcState.unitBusy = false;
+}
+
+/**
+  * @brief  Resets the unit to a running CRC
+  * @note	The F4 unit resets to 0xFFFFFFFF and has no initial value register. Writing word w
+  * 		gives (0xFFFFFFFF ^ w) shifted by 32 bits modulo the polynomial, so w is the running
+  * 		CRC shifted back by 32 bits, XOR 0xFFFFFFFF. The polynomial is odd, every step back
+  * 		is unique.
+  * @param[IN]  crc Running CRC
+  * @retval NONE
+  */
+static void crcLoad(uint32_t crc) {
+	CRC->CR = CRC_CR_RESET;
+	if (crc == SHELL_CRC32_INIT) {
+		return;
+	}
+
+	for (uint8_t bit = 0; bit < 32; bit++) {
+		crc = (crc & 1U) ? (((crc ^ SHELL_CRC32_POLY) >> 1) | 0x80000000U) : (crc >> 1);
+	}
+	CRC->DR = crc ^ SHELL_CRC32_INIT;
+}
+
+/**
+  * @brief  Feeds bytes to the unit, a word per store
+  * @param[IN]  data First byte, any alignment
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+static void crcFeed(const uint8_t* data, uint32_t len) {
+	while (len >= 4) {
+		CRC->DR = crcWordAt(data, 4);
+		data += 4;
+		len -= 4;
+	}
+	if (len > 0) {
+		CRC->DR = crcWordAt(data, len);
+	}
+}
+
+/**
+  * @brief  Starts the DMA on the next part of the background block
+  * @note	An aligned block goes in word items, an unaligned one in byte items that the FIFO
+  * 		packs into words (little endian, the same words as a CPU load).
+  * @retval NONE
+  */
+static void crcDmaNext(void) {
+	bool aligned = ((uint32_t)crcState.next & 3U) == 0;
+	uint32_t words = crcState.remaining / 4;
+	uint32_t items = aligned ? words : words * 4;
+
+	if (items > CRC_DMA_MAX_ITEMS) {
+		items = CRC_DMA_MAX_ITEMS;
+	}
+
+	DMA2->LIFCR = CRC_DMA_FLAGS;
+	CRC_DMA_STREAM->PAR = (uint32_t)crcState.next;
+	CRC_DMA_STREAM->M0AR = (uint32_t)&CRC->DR;
+	CRC_DMA_STREAM->NDTR = items;
+	// Memory-to-memory needs the FIFO, full threshold, single beats
+	CRC_DMA_STREAM->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+	CRC_DMA_STREAM->CR = DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_MSIZE_1 |
+			(aligned ? DMA_SxCR_PSIZE_1 : 0U) | DMA_SxCR_EN;
+
+	uint32_t bytes = aligned ? items * 4 : items;
+	crcState.next += bytes;
+	crcState.remaining -= bytes;
+}
+
+/**
+  * @brief  Stops the DMA, waits until the stream is off
+  * @retval NONE
+  */
+static void crcDmaStop(void) {
+	CRC_DMA_STREAM->CR &= ~DMA_SxCR_EN;
+	while ((CRC_DMA_STREAM->CR & DMA_SxCR_EN) != 0) {
+	}
+	DMA2->LIFCR = CRC_DMA_FLAGS;
+}
+#endif
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  CRC32 of a block, see CLI_SHELL_CRC.h for the definition
+  * @param[IN]  crc Running CRC (SHELL_CRC32_INIT to start)
+  * @param[IN]  data Data to add, any alignment
+  * @param[IN]  len Number of bytes
+  * @retval uint32_t Updated CRC
+  */
+uint32_t shellCrc32(uint32_t crc, const void* data, uint32_t len) {
+#if !SHELL_HOST_BUILD
+	if (len >= 4 && crcClaim()) {
+		crcLoad(crc);
+		crcFeed((const uint8_t*)data, len);
+		crc = CRC->DR;
+		crcRelease();
+		return crc;
+	}
+#endif
+	return crcSoftware(crc, (const uint8_t*)data, len);
+}
+
+/**
+  * @brief  Starts the CRC32 of a block in the background, shellCrc32Poll() collects it
+  * @note	The block must stay unchanged until it is collected.
+  * @param[IN]  crc Running CRC (SHELL_CRC32_INIT to start)
+  * @param[IN]  data Data to add, flash or SRAM
+  * @param[IN]  len Number of bytes
+  * @retval bool Returns false if a block is still running
+  */
+bool shellCrc32Start(uint32_t crc, const void* data, uint32_t len) {
+	if (crcState.active) {
+		return false;
+	}
+
+	crcState.active = true;
+	crcState.dma = false;
+#if !SHELL_HOST_BUILD
+	if (len >= SHELL_CRC_DMA_MIN && crcClaim()) {
+		crcState.dma = true;
+		crcState.next = (const uint8_t*)data;
+		crcState.remaining = len;
+		crcLoad(crc);
+		crcDmaNext();
+		return true;
+	}
+#endif
+	crcState.result = shellCrc32(crc, data, len);
+	return true;
+}
+
+/**
+  * @brief  Collects the block of shellCrc32Start()
+  * @param[OUT]  crc The CRC once the block is done
+  * @retval shell_error SHELL_BUSY while the DMA runs, SHELL_ERR on a DMA error or without a block
+  */
+shell_error shellCrc32Poll(uint32_t* crc) {
+	if (!crcState.active) {
+		return SHELL_ERR;
+	}
+
+#if !SHELL_HOST_BUILD
+	if (crcState.dma) {
+		uint32_t flags = DMA2->LISR;
+
+		if ((flags & CRC_DMA_ERRORS) != 0) {
+			shellCrc32Abort();
+			return SHELL_ERR;
+		}
+		if ((flags & CRC_DMA_DONE) == 0) {
+			return SHELL_BUSY;
+		}
+		if (crcState.remaining >= 4) {
+			crcDmaNext();
+			return SHELL_BUSY;
+		}
+
+		DMA2->LIFCR = CRC_DMA_FLAGS;
+		crcFeed(crcState.next, crcState.remaining);
+		crcState.result = CRC->DR;
+		crcRelease();
+	}
+#endif
+
+	crcState.active = false;
+	*crc = crcState.result;
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Drops the block of shellCrc32Start()
+  * @retval NONE
+  */
+void shellCrc32Abort(void) {
+#if !SHELL_HOST_BUILD
+	if (crcState.active && crcState.dma) {
+		crcDmaStop();
+		crcRelease();
+	}
+#endif
+	crcState.active = false;
+}
+
+/*** end of file ***/
@@ -0,0 +1,67 @@
+/** @file CLI_SHELL_CRC.h
+ *
+ * @brief CRC32 service of the CLI Shell: the CRC unit of the STM32F4, DMA for large blocks
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The CRC is the one the CRC unit computes: CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF,
+ *    no reflection, no final XOR) over 32-bit words, each word as stored in memory (little
+ *    endian) and taken most significant bit first. A last partial word is padded with zeros.
+ *    A host computes it by padding to a multiple of 4, swapping the bytes of every word and
+ *    running a plain CRC-32/MPEG-2 over the result (crcmod "crc-32-mpeg", ...).
+ *  - shellCrc32(crc, data, len) continues a running CRC (SHELL_CRC32_INIT to start). Chained
+ *    calls give the CRC of the whole only if every block but the last is a multiple of 4 bytes.
+ *    The CPU feeds the unit one word per store, any alignment.
+ *  - shellCrc32Start() / shellCrc32Poll() compute a block in the background: the words go to
+ *    the unit through DMA2 Stream 0 (memory-to-memory, the only DMA that can), the CPU is free
+ *    meanwhile. Blocks below SHELL_CRC_DMA_MIN are computed right away. One block at a time,
+ *    shellCrc32Abort() stops it. The source must be flash or SRAM, the DMA has no access to
+ *    the Cortex-M4 private peripherals.
+ *  - The unit holds one running CRC. While a DMA block runs, or when an interrupt calls
+ *    shellCrc32() while the main loop uses the unit, the call computes in software with the
+ *    nibble table instead (same result, several times slower).
+ *  - The unit has no initial value register on the F4, a running CRC is loaded by writing the
+ *    word that shifts the reset value into it (crcLoad()).
+ *  - The registers are driven directly, the HAL CRC module (stm32f4xx_hal_crc.c) is not part of
+ *    the project and stays disabled in stm32f4xx_hal_conf.h.
+ *  - The host build (SHELL_HOST_BUILD) always computes in software.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_CRC_H_
+#define CLI_SHELL_CRC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_CRC32_INIT			0xFFFFFFFFU	/*!< Start value of a CRC					*/
+#define SHELL_CRC32_POLY			0x04C11DB7U
+
+#ifndef SHELL_CRC_DMA_MIN
+#define SHELL_CRC_DMA_MIN			256			/*!< Smaller blocks are not worth the DMA	*/
+#endif
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+uint32_t shellCrc32(uint32_t crc, const void* data, uint32_t len);
+bool shellCrc32Start(uint32_t crc, const void* data, uint32_t len);
+shell_error shellCrc32Poll(uint32_t* crc);
+void shellCrc32Abort(void);
+
+#endif // CLI_SHELL_CRC_H_
+
+/*** end of file ***/
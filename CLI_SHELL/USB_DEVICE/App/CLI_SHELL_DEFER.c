@@ -0,0 +1,120 @@
+/** @file CLI_SHELL_DEFER.c
+ *
+ * @brief Deferred command processing of the CLI Shell: the shell runs in the PendSV exception
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_DEFER.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_RTOS.h"
+
+#if SHELL_DEFER_ENABLED
+
+#if SHELL_RTOS_ENABLED
+#error "SHELL_DEFER_ENABLED and SHELL_RTOS_ENABLED both use PendSV"
+#endif
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shell_ctx_t* instances[SHELL_DEFER_MAX_INSTANCES];
+static uint8_t instanceCount;
+static volatile bool started = false;
+static volatile bool tickPoll = false;				/*!< A job runs, SysTick pends the next pass	*/
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Hands the instances to PendSV, the main loop stops calling checkShellStatus()
+  * @note	Call once from main() after shellInit() of every instance.
+  * @param[IN]  shellInstances Instances PendSV runs, in poll order
+  * @param[IN]  count Number of instances (SHELL_DEFER_MAX_INSTANCES max)
+  * @retval bool Returns false if too many instances
+  */
+bool shellDeferStart(shell_ctx_t* const* shellInstances, uint8_t count) {
+	if (count > SHELL_DEFER_MAX_INSTANCES) {
+		return false;
+	}
+	memcpy(instances, shellInstances, count * sizeof(instances[0]));
+	instanceCount = count;
+
+	NVIC_SetPriority(PendSV_IRQn, SHELL_DEFER_PRIORITY);
+	started = true;
+
+	// Whatever arrived during the start up
+	shellDeferNotify();
+	return true;
+}
+
+/**
+  * @brief  Pends the next pass
+  * @note	Called by shellEventSignal(), from any interrupt priority or the main loop.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellDeferNotify(void) {
+	if (started) {
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	}
+}
+
+/**
+  * @brief  Pends a pass for the running job
+  * @note	Called by SysTick_Handler() every millisecond.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellDeferTick(void) {
+	if (tickPoll) {
+		shellDeferNotify();
+	}
+}
+
+/**
+  * @brief  Runs the pass of every instance
+  * @note	Called by PendSV_Handler().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellDeferRun(void) {
+	bool linesLeft = false;
+
+	if (!started) {
+		return;
+	}
+
+	shellEventTake();
+
+	for (uint8_t i = 0; i < instanceCount; i++) {
+		shell_ctx_t* ctx = instances[i];
+
+		checkShellStatus(ctx);
+		if (shellRingUsed(&ctx->rxRing) != 0 && !shellJobOwnsInput(ctx)) {
+			linesLeft = true;
+		}
+	}
+
+	tickPoll = shellJobRunning();
+	if (linesLeft) {
+		shellDeferNotify();
+	}
+}
+
+#endif // SHELL_DEFER_ENABLED
+
+/*** end of file ***/
@@ -0,0 +1,69 @@
+/** @file CLI_SHELL_DEFER.h
+ *
+ * @brief Deferred command processing of the CLI Shell: the shell runs in the PendSV exception
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Only built with SHELL_DEFER_ENABLED=1, not together with SHELL_RTOS_ENABLED (FreeRTOS owns
+ *    PendSV). Without it the main loop runs the shell (CLI_SHELL_EVENT.h).
+ *  - main() initializes the instances as usual and hands them to shellDeferStart(). The main
+ *    loop no longer calls checkShellStatus(), it does the application's work and may sleep
+ *    with shellEventWait():
+ *      static shell_ctx_t* const instances[] = { &operatorShell, &automationShell };
+ *      shellDeferStart(instances, 2);
+ *      while (1) {
+ *          applicationWork();
+ *          shellEventWait();
+ *      }
+ *  - shellEventSignal() pends PendSV. PendSV runs at the lowest priority (SHELL_DEFER_PRIORITY):
+ *    after the interrupt that received a line, ahead of the main loop. A command starts within
+ *    the interrupts running at the time, however long the main loop is busy. Every interrupt
+ *    of the shell (USB, USART, SysTick, flash, timers) still preempts it.
+ *  - Each PendSV runs the pass of every instance, as the main loop did. Lines left in a receive
+ *    ring pend it again right away. A running job is polled once per SysTick (shellDeferTick())
+ *    instead, so a job waiting on time does not keep the main loop from running.
+ *  - Bridges run in handler mode. They must not wait for the main loop, and code in the main
+ *    loop must not call the shell (shellOutputWrite(), checkShellStatus()) while it is enabled.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_DEFER_H_
+#define CLI_SHELL_DEFER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_DEFER_ENABLED
+#define SHELL_DEFER_ENABLED				0
+#endif
+
+#define SHELL_DEFER_MAX_INSTANCES		4			/*!< Instances run in PendSV				*/
+#define SHELL_DEFER_PRIORITY			15			/*!< Lowest, below every shell interrupt	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellDeferStart(shell_ctx_t* const* instances, uint8_t count);
+void shellDeferNotify(void);
+void shellDeferTick(void);
+void shellDeferRun(void);
+
+#endif // CLI_SHELL_DEFER_H_
+
+/*** end of file ***/
@@ -0,0 +1,284 @@
+/** @file CLI_SHELL_EDIT.c
+ *
+ * @brief Line editor of the CLI Shell: cursor keys, backspace and coalesced local echo
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) "term" echo kept over a reset (CLI_SHELL_SESSION)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_EDIT.h"
+#include "CLI_SHELL_SESSION.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define EDIT_ESC_IDLE					0
+#define EDIT_ESC_START					1			/*!< ESC received						*/
+#define EDIT_ESC_CSI					2			/*!< ESC [ or ESC O received			*/
+
+#define EDIT_ERASE_LINE					"\r\x1b[K"
+#define EDIT_INSERT_CHAR				"\x1b[@"
+#define EDIT_DELETE_CHAR				"\x1b[P"
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void echoBytes(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+static void echoMove(shell_ctx_t* ctx, uint16_t count, char direction);
+static void escapeKey(shell_ctx_t* ctx, uint8_t final, uint8_t param);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Writes echo into the transmit queue, flushed later by shellEditFlush()
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  data Bytes
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+static void echoBytes(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	if (!ctx->edit.echo || ctx->outputMuted) {
+		return;
+	}
+	outputStreamChannel(ctx, data, len);
+	ctx->edit.echoPending = true;
+}
+
+/**
+  * @brief  Moves the terminal cursor
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  count Columns, nothing is sent for 0
+  * @param[IN]  direction 'C' right, 'D' left
+  * @retval NONE
+  */
+static void echoMove(shell_ctx_t* ctx, uint16_t count, char direction) {
+	SHELL_STR_DEFINE(str, 12);
+
+	if (count == 0) {
+		return;
+	}
+	shellStrAppend(&str, "\x1b[");
+	if (count > 1) {
+		shellStrAppendUnsigned(&str, count, 0);
+	}
+	shellStrAppendChar(&str, direction);
+	echoBytes(ctx, (const uint8_t*)str.buf, str.len);
+}
+
+/**
+  * @brief  Carries out a complete escape sequence
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  final Final byte of the sequence
+  * @param[IN]  param Numeric parameter, 0 without
+  * @retval NONE
+  */
+static void escapeKey(shell_ctx_t* ctx, uint8_t final, uint8_t param) {
+	shellEdit_t* edit = &ctx->edit;
+	uint32_t cursor = ctx->rxLen - edit->tail;
+
+	if (ctx->overflow) {
+		// The line is discarded at its terminator anyway
+		return;
+	}
+
+	switch (final) {
+	case 'A':
+	case 'B':
+		if (shellHistoryRecall(ctx, final == 'A')) {
+			edit->tail = 0;
+			shellEditRedraw(ctx);
+		}
+		break;
+
+	case 'D':
+		if (cursor > 0) {
+			edit->tail++;
+			echoMove(ctx, 1, 'D');
+		}
+		break;
+
+	case 'C':
+		if (edit->tail > 0) {
+			edit->tail--;
+			echoMove(ctx, 1, 'C');
+		}
+		break;
+
+	case 'H':
+		echoMove(ctx, cursor, 'D');
+		edit->tail = ctx->rxLen;
+		break;
+
+	case 'F':
+		echoMove(ctx, edit->tail, 'C');
+		edit->tail = 0;
+		break;
+
+	case '~':
+		if (param == 1 || param == 7) {
+			escapeKey(ctx, 'H', 0);
+		} else if (param == 4 || param == 8) {
+			escapeKey(ctx, 'F', 0);
+		} else if (param == 3 && edit->tail > 0) {
+			memmove(&ctx->rxBuffer[cursor], &ctx->rxBuffer[cursor + 1], edit->tail - 1);
+			ctx->rxLen--;
+			edit->tail--;
+			shellEditEcho(ctx, EDIT_DELETE_CHAR);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Edits the line being assembled
+  * @note	Called by assembleLine() for the bytes of a text session. Terminators, Tab and other
+  * 		control characters are left to it, and so is a printable character that does not
+  * 		fit (the line overflows).
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  rxByte Received byte
+  * @retval bool Returns true if the byte was taken
+  */
+bool shellEditKey(shell_ctx_t* ctx, uint8_t rxByte) {
+	shellEdit_t* edit = &ctx->edit;
+
+	switch (edit->escape) {
+	case EDIT_ESC_START:
+		edit->escape = (rxByte == '[' || rxByte == 'O') ? EDIT_ESC_CSI : EDIT_ESC_IDLE;
+		edit->param = 0;
+		return true;
+
+	case EDIT_ESC_CSI:
+		if (rxByte >= '0' && rxByte <= '9') {
+			edit->param = (edit->param > 25) ? UINT8_MAX : (uint8_t)((edit->param * 10) + (rxByte - '0'));
+			return true;
+		}
+		// Other parameter bytes until the final byte
+		if (rxByte < 0x40 || rxByte > 0x7E) {
+			return true;
+		}
+		edit->escape = EDIT_ESC_IDLE;
+		escapeKey(ctx, rxByte, edit->param);
+		return true;
+
+	default:
+		break;
+	}
+
+	if (rxByte == SHELL_EDIT_ESC) {
+		edit->escape = EDIT_ESC_START;
+		return true;
+	}
+	if (ctx->overflow) {
+		return false;
+	}
+
+	uint32_t cursor = ctx->rxLen - edit->tail;
+
+	if (rxByte == SHELL_EDIT_BACKSPACE || rxByte == SHELL_EDIT_DELETE) {
+		if (cursor > 0) {
+			memmove(&ctx->rxBuffer[cursor - 1], &ctx->rxBuffer[cursor], edit->tail);
+			ctx->rxLen--;
+			shellEditEcho(ctx, "\b" EDIT_DELETE_CHAR);
+		}
+		return true;
+	}
+	if (rxByte < ' ' || rxByte > '~' || ctx->rxLen >= SHELL_BUFFER_LEN) {
+		return false;
+	}
+
+	memmove(&ctx->rxBuffer[cursor + 1], &ctx->rxBuffer[cursor], edit->tail);
+	ctx->rxBuffer[cursor] = rxByte;
+	ctx->rxLen++;
+	if (edit->tail > 0) {
+		shellEditEcho(ctx, EDIT_INSERT_CHAR);
+	}
+	echoBytes(ctx, &rxByte, 1);
+	return true;
+}
+
+/**
+  * @brief  Echoes text if echo is on
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  text NUL-terminated text
+  * @retval NONE
+  */
+void shellEditEcho(shell_ctx_t* ctx, const char* text) {
+	echoBytes(ctx, (const uint8_t*)text, strlen(text));
+}
+
+/**
+  * @brief  Sends the echo written since the last call, called by assembleLine() once the receive
+  * 		ring is drained
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellEditFlush(shell_ctx_t* ctx) {
+	if (ctx->edit.echoPending) {
+		ctx->edit.echoPending = false;
+		transportFlush(ctx);
+	}
+}
+
+/**
+  * @brief  Draws the whole line in place of the terminal line, the cursor at its end
+  * @note	Sent with or without echo, a recalled line would be invisible otherwise.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellEditRedraw(shell_ctx_t* ctx) {
+	if (ctx->outputMuted) {
+		return;
+	}
+	outputStreamChannel(ctx, (const uint8_t*)EDIT_ERASE_LINE, strlen(EDIT_ERASE_LINE));
+	outputStreamChannel(ctx, ctx->rxBuffer, ctx->rxLen);
+	ctx->edit.echoPending = true;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Turns the local echo of the instance on or off, or shows it
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (e - Echo 1 on, 0 off, optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error TermBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 24);
+
+	if (shellHasArg(parserInput, argTkn_e)) {
+		uint8_t echo = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_e)).u8;
+
+		if (echo > 1) {
+			return SHELL_ERR;
+		}
+		ctx->edit.echo = (echo == 1);
+		shellSessionSave(ctx);
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, ctx->edit.echo ? "Echo: on\r\n" : "Echo: off\r\n");
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
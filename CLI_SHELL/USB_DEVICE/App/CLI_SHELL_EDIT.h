@@ -0,0 +1,81 @@
+/** @file CLI_SHELL_EDIT.h
+ *
+ * @brief Line editor of the CLI Shell: cursor keys, backspace and coalesced local echo
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Echo kept over a reset
+ *
+ * Usage Notes:
+ *  - assembleLine() hands every byte of a text session to shellEditKey(). The line is edited in
+ *    ctx->rxBuffer at a cursor:
+ *      Backspace (0x08, 0x7F)		deletes left of the cursor
+ *      ESC [3~						deletes at the cursor
+ *      ESC [D, ESC [C				cursor left, right
+ *      ESC [H, ESC [F (ESC [1~, ESC [4~)	start, end of the line
+ *      ESC [A, ESC [B				older, newer history entry (CLI_SHELL_HISTORY.h)
+ *    Printable characters are inserted at the cursor. Other escape sequences are dropped.
+ *    Tab completes the command word with the cursor at the end of the line only.
+ *  - Local echo is off by default (SHELL_EDIT_ECHO), a host sending lines sees nothing but the
+ *    responses as before. "term e1" turns it on for a terminal, "term e0" off again, the setting
+ *    comes back after a soft or watchdog reset (CLI_SHELL_SESSION.h). With echo every change is
+ *    sent back: the typed character, the line terminator as "\r\n", Ctrl-C as "^C", edits within
+ *    the line as VT100 sequences (ESC [@ insert, ESC [P delete, cursor moves).
+ *    A recalled history entry is drawn with or without echo ("\r" ESC [K and the line).
+ *  - Echo is written into the transmit queue of the port like any output, but not flushed byte
+ *    by byte: assembleLine() flushes once when the receive ring is drained, and with
+ *    USBD_SOF_TX_FLUSH the next SOF sends it. A typing burst costs one IN packet per poll (per
+ *    frame with SOF flush) instead of one per byte, and the echo queues behind output already
+ *    waiting. Muted runs ("bench", "regress") echo nothing.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_EDIT_H_
+#define CLI_SHELL_EDIT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_EDIT_ECHO
+#define SHELL_EDIT_ECHO					0			/*!< Local echo after shellInit()		*/
+#endif
+#define SHELL_EDIT_ESC					0x1B
+#define SHELL_EDIT_BACKSPACE			0x08
+#define SHELL_EDIT_DELETE				0x7F		/*!< Backspace key of most terminals	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Line editor state of one shell instance (shell_ctx_t.edit)
+  */
+typedef struct {
+	bool echo;								/*!< Send the edits back ("term")			*/
+	bool echoPending;						/*!< Echo written since the last flush		*/
+	uint8_t escape;							/*!< Escape sequence being received			*/
+	uint8_t param;							/*!< Numeric parameter of the sequence		*/
+	uint16_t tail;							/*!< Characters right of the cursor			*/
+} shellEdit_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellEditKey(shell_ctx_t* ctx, uint8_t rxByte);
+void shellEditEcho(shell_ctx_t* ctx, const char* text);
+void shellEditFlush(shell_ctx_t* ctx);
+void shellEditRedraw(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_EDIT_H_
+
+/*** end of file ***/
@@ -0,0 +1,255 @@
+/** @file CLI_SHELL_EVENT.c
+ *
+ * @brief Event flags of the CLI Shell main loop, WFI sleep and the "idle" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Blocks the shell task instead of the WFI with SHELL_RTOS_ENABLED
+ * - 1.2: 10-15-2026 (Crandell) Pends PendSV with SHELL_DEFER_ENABLED, shellEventTake()
+ * - 1.3: 10-15-2026 (Crandell) Sleeps and passes feed the load accounting (CLI_SHELL_LOAD)
+ * - 1.4: 10-15-2026 (Crandell) STOP while the USB port is suspended (CLI_SHELL_SUSPEND)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "stm32f4xx.h"
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_RTOS.h"
+#include "CLI_SHELL_DEFER.h"
+#include "CLI_SHELL_LOAD.h"
+#include "CLI_SHELL_SUSPEND.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static volatile uint32_t eventFlags = 0;			/*!< SHELL_EVENT_ bits since the last pass	*/
+static volatile uint32_t rxEventCycles = 0;			/*!< First receive event since the last pass	*/
+static bool sleepEnabled = SHELL_EVENT_SLEEP;
+
+static shellEventStats_t eventStats = { .latencyMin = UINT32_MAX };
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t cyclesToNs(uint32_t cycles);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Converts core cycles to nanoseconds at the current clock
+  * @param[IN]  cycles Cycles
+  * @retval uint32_t Nanoseconds
+  */
+static uint32_t cyclesToNs(uint32_t cycles) {
+	return (uint32_t)(((uint64_t)cycles * 1000000000ULL) / SystemCoreClock);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Flags work for the main loop
+  * @note	Interrupt safe. Keeps the next shellEventWait() from sleeping, wakes the shell task.
+  * @param[IN]  events SHELL_EVENT_ bits
+  * @retval NONE
+  */
+void shellEventSignal(uint32_t events) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if ((events & SHELL_EVENT_RX) && !(eventFlags & SHELL_EVENT_RX)) {
+		rxEventCycles = shellPerfCycles();
+	}
+	eventFlags |= events;
+
+	__set_PRIMASK(primask);
+
+#if SHELL_RTOS_ENABLED
+	shellRtosNotify();
+#elif SHELL_DEFER_ENABLED
+	// Work left over is polled by PendSV itself (shellDeferRun())
+	if (events & ~SHELL_EVENT_PENDING) {
+		shellDeferNotify();
+	}
+#endif
+}
+
+/**
+  * @brief  Ends a main loop pass: sleeps until the next interrupt if no event is pending
+  * @note	The check and the WFI run with interrupts masked. A pending interrupt ends the WFI
+  * 		anyway, and it is taken as soon as they are unmasked again, before the flags are read.
+  * 		The shell task blocks instead, an event after the check has notified it already. With
+  * 		work left (SHELL_EVENT_PENDING) it only yields. With SHELL_DEFER_ENABLED the main loop
+  * 		only sleeps here, PendSV takes the events. While the USB port is suspended the core
+  * 		stays in STOP first, pending events or not (shellSuspendStop()).
+  * @param  NONE
+  * @retval NONE
+  */
+void shellEventWait(void) {
+	uint32_t sleepStart;
+
+#if SHELL_RTOS_ENABLED
+	if (sleepEnabled && eventFlags == 0) {
+		eventStats.sleeps++;
+		sleepStart = shellPerfCycles();
+		shellRtosWait();
+		shellLoadIdle(shellPerfCycles() - sleepStart);
+	} else {
+		shellRtosYield();
+	}
+#else
+	if (shellSuspended()) {
+		shellSuspendStop();
+	}
+
+	__disable_irq();
+	if (sleepEnabled && eventFlags == 0) {
+		eventStats.sleeps++;
+		sleepStart = shellPerfCycles();
+		__DSB();
+		__WFI();
+		// Still masked: the interrupt that woke the core counts as busy
+		shellLoadIdle(shellPerfCycles() - sleepStart);
+	}
+	__enable_irq();
+	__ISB();
+#endif
+
+#if !SHELL_DEFER_ENABLED
+	// The interrupt that ended the sleep has run, take what it flagged
+	shellEventTake();
+#endif
+}
+
+/**
+  * @brief  Starts a pass: takes the flagged events and times the receive latency
+  * @note	Called by shellEventWait(), or by PendSV (shellDeferRun()) when it runs the passes.
+  * @param  NONE
+  * @retval uint32_t SHELL_EVENT_ bits since the last pass
+  */
+uint32_t shellEventTake(void) {
+	uint32_t events;
+	uint32_t rxCycles;
+	uint32_t latency = 0;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	events = eventFlags;
+	rxCycles = rxEventCycles;
+	eventFlags = 0;
+	__set_PRIMASK(primask);
+
+	eventStats.passes++;
+	if (events & SHELL_EVENT_RX) {
+		latency = shellPerfCycles() - rxCycles;
+
+		eventStats.rxEvents++;
+		eventStats.latencyTotal += latency;
+		if (latency < eventStats.latencyMin) {
+			eventStats.latencyMin = latency;
+		}
+		if (latency > eventStats.latencyMax) {
+			eventStats.latencyMax = latency;
+		}
+	}
+	shellLoadPass(events, latency);
+	return events;
+}
+
+/**
+  * @brief  Selects WFI sleep or busy polling between passes
+  * @param[IN]  sleep True to sleep between events
+  * @retval NONE
+  */
+void shellEventSetSleep(bool sleep) {
+	sleepEnabled = sleep;
+}
+
+/**
+  * @brief  Main loop statistics
+  * @param  NONE
+  * @retval const shellEventStats_t* Statistics
+  */
+const shellEventStats_t* shellEventStats(void) {
+	return &eventStats;
+}
+
+/**
+  * @brief  Clears the main loop statistics
+  * @param  NONE
+  * @retval NONE
+  */
+void shellEventStatsClear(void) {
+	memset(&eventStats, 0, sizeof(eventStats));
+	eventStats.latencyMin = UINT32_MAX;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the main loop statistics, switches between sleep and polling (w) or resets (r1)
+  * @note	The latency is from the interrupt that received the bytes to the start of the next
+  * 		pass, so it includes the rest of a pass that was running. Compare "idle w0" and "idle w1"
+  * 		under the same traffic.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error IdleBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 100);
+	const shellEventStats_t* stats = &eventStats;
+
+	if (shellHasArg(parserInput, argTkn_w)) {
+		uint8_t sleep = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_w)).u8;
+		if (sleep > 1) {
+			return SHELL_ERR;
+		}
+		shellEventSetSleep(sleep == 1);
+	}
+
+	shellStrAppend(&str, "Idle: ");
+	shellStrAppend(&str, sleepEnabled ? "WFI" : "polling");
+	shellStrAppend(&str, ", ");
+	shellStrAppendUnsigned(&str, stats->passes, 0);
+	shellStrAppend(&str, " passes, ");
+	shellStrAppendUnsigned(&str, stats->sleeps, 0);
+	shellStrAppend(&str, " sleeps\r\n");
+	shellStrSend(ctx, &str);
+
+	if (stats->rxEvents != 0) {
+		uint32_t mean = (uint32_t)(stats->latencyTotal / stats->rxEvents);
+
+		shellStrAppend(&str, "RX latency: ");
+		shellStrAppendUnsigned(&str, stats->rxEvents, 0);
+		shellStrAppend(&str, " events, min/mean/max ");
+		shellStrAppendUnsigned(&str, cyclesToNs(stats->latencyMin), 0);
+		shellStrAppendChar(&str, '/');
+		shellStrAppendUnsigned(&str, cyclesToNs(mean), 0);
+		shellStrAppendChar(&str, '/');
+		shellStrAppendUnsigned(&str, cyclesToNs(stats->latencyMax), 0);
+		shellStrAppend(&str, " ns (");
+		shellStrAppendUnsigned(&str, mean, 0);
+		shellStrAppend(&str, " cycles mean)\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+		shellEventStatsClear();
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
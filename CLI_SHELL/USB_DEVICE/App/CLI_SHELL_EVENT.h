@@ -0,0 +1,98 @@
+/** @file CLI_SHELL_EVENT.h
+ *
+ * @brief Event flags of the CLI Shell main loop and WFI sleep between events
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Shell task wait with SHELL_RTOS_ENABLED, SHELL_EVENT_WORKER
+ * - 1.2: 10-15-2026 (Crandell) PendSV passes with SHELL_DEFER_ENABLED, shellEventTake()
+ * - 1.3: 10-15-2026 (Crandell) Load accounting, "load" (CLI_SHELL_LOAD.h)
+ * - 1.4: 10-15-2026 (Crandell) STOP while the USB port is suspended (CLI_SHELL_SUSPEND.h)
+ *
+ * Usage Notes:
+ *  - The main loop calls checkShellStatus() for every instance, then shellEventWait(). It sleeps
+ *    with WFI until the next interrupt unless an event came in since the last pass:
+ *      while (1) {
+ *          checkShellStatus(&operatorShell);
+ *          checkShellStatus(&automationShell);
+ *          shellEventWait();
+ *      }
+ *  - The interrupts that give the main loop work call shellEventSignal(): received bytes and
+ *    Ctrl-C (rxShellInput(), shellAbort()), transmit complete (USB and USART), a periodic command
+ *    due (CLI_SHELL_SCHED.c) and the capture DMA halves and flash completions. checkShellStatus()
+ *    signals SHELL_EVENT_PENDING itself if it left work behind (more lines than
+ *    SHELL_MAX_CMDS_PER_POLL, a running job), so the loop keeps polling until that is done.
+ *  - The SysTick (1 ms) wakes the core as well, so time based jobs and timeouts keep working.
+ *  - While the host has the USB port suspended shellEventWait() enters STOP instead and returns
+ *    after the resume (CLI_SHELL_SUSPEND.h).
+ *  - The flags are checked and the core goes to sleep with interrupts masked. An interrupt that
+ *    became pending after the check still ends the WFI, no event is lost.
+ *  - With SHELL_RTOS_ENABLED=1 the shell task (CLI_SHELL_RTOS.h) runs this loop. shellEventSignal()
+ *    notifies it and shellEventWait() blocks it instead of the WFI, other tasks run meanwhile.
+ *  - With SHELL_DEFER_ENABLED=1 the passes run in PendSV (CLI_SHELL_DEFER.h). shellEventSignal()
+ *    pends it, the main loop only sleeps in shellEventWait() between its own work.
+ *  - "idle" shows the passes, sleeps and the latency from a receive event to the next pass
+ *    (min/mean/max), "idle w0" switches to busy polling to compare, "idle w1" back to WFI,
+ *    "idle r1" resets the statistics.
+ *  - The sleeps and passes also feed the CPU load accounting, "load" shows the busy share over
+ *    1, 10 and 60 s (CLI_SHELL_LOAD.h).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_EVENT_H_
+#define CLI_SHELL_EVENT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_EVENT_RX				0x01		/*!< Bytes received, Ctrl-C or a break		*/
+#define SHELL_EVENT_TX				0x02		/*!< A transmit transfer completed			*/
+#define SHELL_EVENT_TIMER			0x04		/*!< A periodic command is due				*/
+#define SHELL_EVENT_PERIPH			0x08		/*!< Capture buffer half, flash operation	*/
+#define SHELL_EVENT_PENDING			0x10		/*!< Work left over by checkShellStatus()	*/
+#define SHELL_EVENT_WORKER			0x20		/*!< A deferred work item has run (RTOS)	*/
+
+/**
+  * @brief  Sleep between events at startup (1), or poll (0)
+  */
+#ifndef SHELL_EVENT_SLEEP
+#define SHELL_EVENT_SLEEP			1
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Main loop statistics
+  */
+typedef struct {
+	uint32_t passes;						/*!< shellEventWait() calls					*/
+	uint32_t sleeps;						/*!< Passes that ended in a WFI				*/
+	uint32_t rxEvents;						/*!< Receive events timed					*/
+	uint32_t latencyMin;					/*!< Receive event to next pass (cycles)	*/
+	uint32_t latencyMax;
+	uint64_t latencyTotal;
+} shellEventStats_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellEventSignal(uint32_t events);
+void shellEventWait(void);
+uint32_t shellEventTake(void);
+void shellEventSetSleep(bool sleep);
+const shellEventStats_t* shellEventStats(void);
+void shellEventStatsClear(void);
+
+#endif // CLI_SHELL_EVENT_H_
+
+/*** end of file ***/
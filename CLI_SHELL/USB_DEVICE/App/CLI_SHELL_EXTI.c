@@ -0,0 +1,492 @@
+/** @file CLI_SHELL_EXTI.c
+ *
+ * @brief Edge event logger of the CLI Shell: EXTI lines into a timestamped ring, "events"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Lines held by "arm" (shellExtiHold()), fired first by the interrupts
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_EXTI.h"
+#include "CLI_SHELL_ARM.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_JOB.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define EXTI_EDGE_RISING				1U
+#define EXTI_EDGE_FALLING				2U
+
+_Static_assert((SHELL_EXTI_DEPTH & (SHELL_EXTI_DEPTH - 1)) == 0, "SHELL_EXTI_DEPTH must be a power of two");
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The ring, head written by the interrupts only, tail by the drain only
+  */
+typedef struct {
+	volatile uint32_t head;					/*!< Next record to store					*/
+	volatile uint32_t tail;					/*!< Next record to drain					*/
+	volatile uint32_t dropped;				/*!< Edges lost to a full ring				*/
+	uint16_t seq;							/*!< Edge count, interrupt side				*/
+	uint16_t armed;							/*!< Line mask with an edge selected		*/
+	volatile uint16_t held;					/*!< Line mask held by "arm"				*/
+	uint8_t port[SHELL_EXTI_LINES];			/*!< Port of every line						*/
+	uint8_t edge[SHELL_EXTI_LINES];			/*!< Edge selection of every line			*/
+} shellExti_t;
+
+/**
+  * @brief  The running drain
+  */
+typedef struct {
+	bool active;							/*!< "events d1"/"d2" runs					*/
+	bool follow;							/*!< d2, keep draining						*/
+	volatile bool stop;						/*!< "events d0" asked d2 to end			*/
+	uint32_t end;							/*!< d1: ring position to drain up to		*/
+	uint32_t sent;							/*!< Records queued							*/
+	uint16_t crc;							/*!< CRC16 of the bytes queued so far		*/
+	uint16_t chunkLen;						/*!< Bytes in chunk still waiting for room	*/
+	uint8_t chunk[SHELL_EXTI_CHUNK_RECORDS * sizeof(shellExtiRecord_t)];
+} shellExtiDrain_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static SHELL_NOINIT shellExtiRecord_t extiRecords[SHELL_EXTI_DEPTH];
+static shellExti_t exti;
+static shellExtiDrain_t drain;
+
+static GPIO_TypeDef* const extiPorts[SHELL_EXTI_PORTS] = { GPIOA, GPIOB, GPIOC };
+static const char* const extiEdgeNames[] = { "off", "rising", "falling", "both" };
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void extiCapture(uint32_t lines);
+static IRQn_Type lineIrq(uint8_t line);
+static uint32_t lineGroup(uint8_t line);
+static void routeLine(uint8_t line, uint8_t port, uint8_t edge);
+static void armLine(uint8_t line, uint8_t port, uint8_t edge);
+static void putLe32(uint8_t* out, uint32_t value);
+static uint16_t fillEnd(void);
+static bool drainRecords(void);
+static shell_error eventsJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stores the pending edges of the lines of one interrupt, lowest line first
+  * @note	Edges of several lines in the same interrupt get the same cycles.
+  * @param[IN]  lines Line mask of the interrupt
+  * @retval NONE
+  */
+static void extiCapture(uint32_t lines) {
+	uint32_t now = shellPerfCycles();
+	uint32_t pending = EXTI->PR & lines & ~(uint32_t)exti.held;
+
+	EXTI->PR = pending;
+	while (pending != 0) {
+		uint32_t line = __CLZ(__RBIT(pending));
+		uint32_t head = exti.head;
+
+		pending &= pending - 1U;
+		exti.seq++;
+		if (head - exti.tail >= SHELL_EXTI_DEPTH) {
+			exti.dropped++;
+			continue;
+		}
+
+		shellExtiRecord_t* record = &extiRecords[head & (SHELL_EXTI_DEPTH - 1)];
+		record->cycles = now;
+		record->line = (uint8_t)line;
+		record->level = (uint8_t)((extiPorts[exti.port[line]]->IDR >> line) & 1U);
+		record->seq = exti.seq;
+		// The record is complete before the drain can see it
+		__DMB();
+		exti.head = head + 1U;
+	}
+
+	if (drain.active) {
+		shellEventSignal(SHELL_EVENT_PERIPH);
+	}
+}
+
+/**
+  * @brief  Interrupt of an EXTI line
+  * @param[IN]  line Line 0 to 15
+  * @retval IRQn_Type The line's own or shared interrupt
+  */
+static IRQn_Type lineIrq(uint8_t line) {
+	static const IRQn_Type lowIrqs[5] = { EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn };
+
+	if (line < 5) {
+		return lowIrqs[line];
+	}
+	return (line < 10) ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+}
+
+/**
+  * @brief  Lines sharing the interrupt of a line
+  * @param[IN]  line Line 0 to 15
+  * @retval uint32_t Line mask of the interrupt
+  */
+static uint32_t lineGroup(uint8_t line) {
+	if (line < 5) {
+		return 1UL << line;
+	}
+	return (line < 10) ? 0x03E0U : 0xFC00U;
+}
+
+/**
+  * @brief  Routes a line to a port and selects its edges, or masks it
+  * @note	The line is masked while it changes, an edge of the old routing is cleared.
+  * @param[IN]  line Line 0 to 15
+  * @param[IN]  port 0 GPIOA to 2 GPIOC
+  * @param[IN]  edge 0 off, 1 rising, 2 falling, 3 both
+  * @retval NONE
+  */
+static void routeLine(uint8_t line, uint8_t port, uint8_t edge) {
+	uint32_t bit = 1UL << line;
+	uint32_t shift = (line & 3U) * 4U;
+
+	__HAL_RCC_SYSCFG_CLK_ENABLE();
+
+	EXTI->IMR &= ~bit;
+	SYSCFG->EXTICR[line >> 2] = (SYSCFG->EXTICR[line >> 2] & ~(0xFUL << shift)) | ((uint32_t)port << shift);
+	if ((edge & EXTI_EDGE_RISING) != 0) {
+		EXTI->RTSR |= bit;
+	} else {
+		EXTI->RTSR &= ~bit;
+	}
+	if ((edge & EXTI_EDGE_FALLING) != 0) {
+		EXTI->FTSR |= bit;
+	} else {
+		EXTI->FTSR &= ~bit;
+	}
+	EXTI->PR = bit;
+	if (edge != 0) {
+		EXTI->IMR |= bit;
+	}
+}
+
+/**
+  * @brief  Arms a line for the records, or disarms it
+  * @param[IN]  line Line 0 to 15
+  * @param[IN]  port 0 GPIOA to 2 GPIOC
+  * @param[IN]  edge 0 off, 1 rising, 2 falling, 3 both
+  * @retval NONE
+  */
+static void armLine(uint8_t line, uint8_t port, uint8_t edge) {
+	uint32_t bit = 1UL << line;
+
+	routeLine(line, port, edge);
+	exti.port[line] = port;
+	exti.edge[line] = edge;
+	if (edge == 0) {
+		exti.armed &= (uint16_t)~bit;
+		return;
+	}
+	exti.armed |= (uint16_t)bit;
+
+	// Shared interrupts stay enabled, the mask keeps disarmed lines out
+	HAL_NVIC_SetPriority(lineIrq(line), SHELL_EXTI_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(lineIrq(line));
+}
+
+/**
+  * @brief  Stores a word little endian
+  * @param[OUT]  out 4 bytes
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+static void putLe32(uint8_t* out, uint32_t value) {
+	out[0] = (uint8_t)value;
+	out[1] = (uint8_t)(value >> 8);
+	out[2] = (uint8_t)(value >> 16);
+	out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+  * @brief  Builds the end record in the chunk
+  * @param  NONE
+  * @retval uint16_t Record length
+  */
+static uint16_t fillEnd(void) {
+	uint32_t dropped = exti.dropped;
+
+	putLe32(drain.chunk, drain.sent);
+	drain.chunk[4] = SHELL_EXTI_END_LINE;
+	drain.chunk[5] = 0;
+	drain.chunk[6] = (uint8_t)((dropped > UINT16_MAX) ? UINT16_MAX : dropped);
+	drain.chunk[7] = (uint8_t)(((dropped > UINT16_MAX) ? UINT16_MAX : dropped) >> 8);
+	return sizeof(shellExtiRecord_t);
+}
+
+/**
+  * @brief  Queues the stored records, oldest first, while the stream queue has room
+  * @note	A record leaves the ring once copied into the chunk, the interrupts may reuse its slot.
+  * @param  NONE
+  * @retval bool Returns true once all records up to the end (d1) or the head (d2) are queued
+  */
+static bool drainRecords(void) {
+	while (true) {
+		if (drain.chunkLen == 0) {
+			uint32_t tail = exti.tail;
+			uint32_t end = drain.follow ? exti.head : drain.end;
+
+			// The records up to end are complete, see extiCapture()
+			__DMB();
+			if (end == tail) {
+				return true;
+			}
+
+			uint32_t count = ((end - tail) < SHELL_EXTI_CHUNK_RECORDS) ? (end - tail) : SHELL_EXTI_CHUNK_RECORDS;
+			for (uint32_t i = 0; i < count; i++) {
+				const shellExtiRecord_t* record = &extiRecords[(tail + i) & (SHELL_EXTI_DEPTH - 1)];
+				uint8_t* out = &drain.chunk[i * sizeof(shellExtiRecord_t)];
+
+				putLe32(out, record->cycles);
+				out[4] = record->line;
+				out[5] = record->level;
+				out[6] = (uint8_t)record->seq;
+				out[7] = (uint8_t)(record->seq >> 8);
+			}
+			exti.tail = tail + count;
+			drain.sent += count;
+			drain.chunkLen = (uint16_t)(count * sizeof(shellExtiRecord_t));
+			drain.crc = shellCrc16(drain.crc, drain.chunk, drain.chunkLen);
+		}
+
+		if (!transportStreamWrite(drain.chunk, drain.chunkLen)) {
+			// Queue full, the USB interrupt makes room
+			return false;
+		}
+		drain.chunkLen = 0;
+	}
+}
+
+/**
+  * @brief  Poll function of "events d1" and "events d2"
+  * @param[IN]  job The drain job
+  * @retval shell_error SHELL_BUSY while the drain runs
+  */
+static shell_error eventsJob(shellJob_t* job) {
+	if (job->cancel) {
+		drain.active = false;
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	while (true) {
+		SHELL_JOB_WAIT_UNTIL(job, drainRecords());
+		if (!drain.follow || drain.stop) {
+			break;
+		}
+		// Woken by the next edge (SHELL_EVENT_PERIPH)
+		SHELL_JOB_YIELD(job);
+	}
+
+	drain.chunkLen = fillEnd();
+	drain.crc = shellCrc16(drain.crc, drain.chunk, drain.chunkLen);
+	SHELL_JOB_WAIT_UNTIL(job, transportStreamWrite(drain.chunk, drain.chunkLen));
+	// The result line must not overtake the data
+	SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+	drain.active = false;
+	{
+		SHELL_STR_DEFINE(str, 64);
+
+		shellStrAppend(&str, "EVENTS: ");
+		shellStrAppendUnsigned(&str, drain.sent, 0);
+		shellStrAppend(&str, " records, ");
+		shellStrAppendUnsigned(&str, exti.dropped, 0);
+		shellStrAppend(&str, " dropped, CRC 0x");
+		shellStrAppendHex(&str, drain.crc, 4);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(job->ctx, &str);
+	}
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Holds a line for "arm" (CLI_SHELL_ARM.c) at a higher interrupt priority, or releases it
+  * @note	The edges of a held line are left to shellArmFire(), they are not recorded. No line
+  * 		of its interrupt may be armed for the records: one at a higher priority could
+  * 		preempt the other in the middle of a record. Also called from the interrupt.
+  * @param[IN]  line Line 0 to 15
+  * @param[IN]  port 0 GPIOA to 2 GPIOC
+  * @param[IN]  edge 0 releases, 1 rising, 2 falling, 3 both
+  * @param[IN]  priority Interrupt priority while held
+  * @retval bool Returns false if a line of its interrupt is armed for the records ("events")
+  */
+bool shellExtiHold(uint8_t line, uint8_t port, uint8_t edge, uint8_t priority) {
+	uint32_t bit = 1UL << line;
+
+	if (line >= SHELL_EXTI_LINES || port >= SHELL_EXTI_PORTS || (exti.armed & lineGroup(line)) != 0) {
+		return false;
+	}
+	if (edge == 0) {
+		routeLine(line, port, 0);
+		exti.held &= (uint16_t)~bit;
+		if ((exti.held & lineGroup(line)) == 0) {
+			HAL_NVIC_SetPriority(lineIrq(line), SHELL_EXTI_IRQ_PRIORITY, 0);
+		}
+		return true;
+	}
+
+	exti.held |= (uint16_t)bit;
+	HAL_NVIC_SetPriority(lineIrq(line), priority, 0);
+	routeLine(line, port, edge);
+	HAL_NVIC_EnableIRQ(lineIrq(line));
+	return true;
+}
+
+/********************************************************************************
+ * INTERRUPT HANDLERS
+ *******************************************************************************/
+/**
+  * @brief  EXTI interrupts, one per line 0 to 4 and shared by 5 to 9 and 10 to 15
+  * @param  NONE
+  * @retval NONE
+  */
+#define EXTI_HANDLER(name, lines) \
+	void name(void) { \
+		uint32_t start = shellPerfCycles(); \
+		shellArmFire(start, lines); \
+		extiCapture(lines); \
+		SHELL_ISR_RECORD(isrId_exti, start, SHELL_ISR_NO_LATENCY); \
+	}
+
+EXTI_HANDLER(EXTI0_IRQHandler,		0x0001U)
+EXTI_HANDLER(EXTI1_IRQHandler,		0x0002U)
+EXTI_HANDLER(EXTI2_IRQHandler,		0x0004U)
+EXTI_HANDLER(EXTI3_IRQHandler,		0x0008U)
+EXTI_HANDLER(EXTI4_IRQHandler,		0x0010U)
+EXTI_HANDLER(EXTI9_5_IRQHandler,	0x03E0U)
+EXTI_HANDLER(EXTI15_10_IRQHandler,	0xFC00U)
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Arms a line (l, p, e), clears (c1), drains (d1 once, d2 following, d0 stops) or shows the state
+  * @note	See CLI_SHELL_EXTI.h for the drain format.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while the drain runs
+  */
+shell_error EventsBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	if (shellHasArg(parserInput, argTkn_l)) {
+		uint8_t line = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_l)).u8;
+		uint8_t port = shellHasArg(parserInput, argTkn_p) ? shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).u8 : 0;
+
+		if (!shellHasArg(parserInput, argTkn_e)) {
+			return SHELL_ERR;
+		}
+		uint8_t edge = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_e)).u8;
+		if (line >= SHELL_EXTI_LINES || port >= SHELL_EXTI_PORTS || edge > (EXTI_EDGE_RISING | EXTI_EDGE_FALLING) ||
+				(edge != 0 && (exti.held & lineGroup(line)) != 0)) {
+			return SHELL_ERR;
+		}
+		armLine(line, port, edge);
+	}
+
+	if (shellHasArg(parserInput, argTkn_c) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 != 0) {
+		if (drain.active) {
+			return SHELL_ERR;
+		}
+		uint32_t primask = __get_PRIMASK();
+
+		__disable_irq();
+		exti.tail = exti.head;
+		exti.dropped = 0;
+		exti.seq = 0;
+		__set_PRIMASK(primask);
+	}
+
+	if (shellHasArg(parserInput, argTkn_d)) {
+		uint8_t mode = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+
+		if (mode == 0) {
+			// Ends a following drain after the records stored so far
+			if (!drain.active || !drain.follow) {
+				return SHELL_ERR;
+			}
+			drain.stop = true;
+			shellEventSignal(SHELL_EVENT_PERIPH);
+			return SHELL_OK;
+		}
+		if (mode > 2) {
+			return SHELL_ERR;
+		}
+
+		// The drain goes through the stream queue, which goes to the port of this command
+		if (shellJobRunning() || !transportStreamAttach(ctx)) {
+			return SHELL_ERR;
+		}
+		if (shellJobStart(ctx, eventsJob) == NULL) {
+			return SHELL_ERR;
+		}
+
+		memset(&drain, 0, sizeof(drain));
+		drain.follow = (mode == 2);
+		drain.end = exti.head;
+		memcpy(drain.chunk, SHELL_EXTI_MAGIC, 4);
+		putLe32(&drain.chunk[4], SystemCoreClock);
+		drain.chunkLen = 8;
+		drain.crc = shellCrc16(SHELL_BIN_CRC_INIT, drain.chunk, drain.chunkLen);
+		drain.active = true;
+		return SHELL_BUSY;
+	}
+
+	SHELL_STR_DEFINE(str, 80);
+
+	shellStrAppend(&str, "Events: ");
+	shellStrAppendUnsigned(&str, exti.head - exti.tail, 0);
+	shellStrAppendChar(&str, '/');
+	shellStrAppendUnsigned(&str, SHELL_EXTI_DEPTH, 0);
+	shellStrAppend(&str, " records, ");
+	shellStrAppendUnsigned(&str, exti.dropped, 0);
+	shellStrAppend(&str, " dropped");
+	shellStrAppend(&str, drain.active ? ", draining\r\n" : "\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint8_t line = 0; line < SHELL_EXTI_LINES; line++) {
+		if ((exti.armed & (1U << line)) == 0) {
+			continue;
+		}
+		shellStrAppend(&str, "Line ");
+		shellStrAppendUnsigned(&str, line, 0);
+		shellStrAppend(&str, ": P");
+		shellStrAppendChar(&str, (char)('A' + exti.port[line]));
+		shellStrAppendUnsigned(&str, line, 0);
+		shellStrAppendChar(&str, ' ');
+		shellStrAppend(&str, extiEdgeNames[exti.edge[line]]);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
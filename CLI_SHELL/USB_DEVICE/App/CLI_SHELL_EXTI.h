@@ -0,0 +1,84 @@
+/** @file CLI_SHELL_EXTI.h
+ *
+ * @brief Edge event logger of the CLI Shell: EXTI lines into a timestamped ring, "events"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) shellExtiHold(), lines held by "arm"
+ *
+ * Usage Notes:
+ *  - "events l<line> p<port> e<edge>" arms EXTI line 0 to 15 on pin <line> of port p (0 GPIOA,
+ *    1 GPIOB, 2 GPIOC as "gpio", default 0). e is 1 rising, 2 falling, 3 both edges, 0 disarms
+ *    the line. The pin mode is left alone: an input, or an output/peripheral pin to watch it.
+ *    Lines 5 to 9 and 10 to 15 share one interrupt each, one line number is one pin of one port.
+ *  - Every edge stamps DWT CYCCNT (shellPerfCycles()) and the pin level, read in the interrupt,
+ *    in a record of 8 bytes in a ring of SHELL_EXTI_DEPTH records. The interrupt only stores:
+ *    one producer (all EXTI interrupts share SHELL_EXTI_IRQ_PRIORITY, they do not nest) and one
+ *    consumer (the drain), no lock. A full ring drops new edges and counts them, the record seq counts every edge:
+ *    a gap in seq is where edges were dropped.
+ *  - The cycles are the same clock as the trace entries (CLI_SHELL_TRACE.h), so edges line up
+ *    with the command events of "trace d1". The cycles wrap every 2^32 / SystemCoreClock s.
+ *  - "events d1" drains the records stored so far, "events d2" keeps draining new records as
+ *    they come until "events d0" (best from another port, its answer lands between the data
+ *    otherwise) or "cancel". Binary, through the stream queue of the command's port:
+ *      header   "EVT1", SystemCoreClock (u32)
+ *      record   cycles (u32), line (u8), level (u8), seq (u16), little endian
+ *      end      records sent (u32), 0xFF, 0, dropped (u16, saturated)
+ *    then the text line "EVENTS: <records> records, <dropped> dropped, CRC 0x<crc16>" with
+ *    the CRC (shellCrc16(), CLI_SHELL_BINARY.h) over all binary bytes. "cancel" ends without
+ *    the end record and line. Drained records leave the ring.
+ *  - "events c1" empties the ring and the counters, "events" shows the armed lines and counts.
+ *  - At 100 MHz the interrupt takes well under 1 µs, the stream queue moves far more than 8 bytes
+ *    per edge: tens of kHz of edges are lossless while d2 runs. Faster bursts are buffered up to
+ *    the ring depth.
+ *  - A line held by "arm" (CLI_SHELL_ARM.h) runs the armed command instead of being recorded.
+ *    Neither it nor the lines sharing its interrupt (5-9, 10-15) can be armed here meanwhile,
+ *    and "arm" refuses a line whose interrupt has lines armed here.
+ *  - SHELL_EXTI_DEPTH must be a power of two.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_EXTI_H_
+#define CLI_SHELL_EXTI_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_EXTI_DEPTH				1024		/*!< Records in the ring, power of two	*/
+#define SHELL_EXTI_LINES				16
+#define SHELL_EXTI_PORTS				3			/*!< GPIOA to GPIOC						*/
+#define SHELL_EXTI_IRQ_PRIORITY			1
+#define SHELL_EXTI_MAGIC				"EVT1"		/*!< First bytes of the drain			*/
+#define SHELL_EXTI_CHUNK_RECORDS		32			/*!< Records per stream write			*/
+#define SHELL_EXTI_END_LINE				0xFF		/*!< Line of the end record				*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  One edge
+  */
+typedef struct {
+	uint32_t cycles;						/*!< DWT CYCCNT at the interrupt			*/
+	uint8_t line;							/*!< EXTI line, the pin number				*/
+	uint8_t level;							/*!< Pin level after the edge				*/
+	uint16_t seq;							/*!< Edge count of all lines, wraps			*/
+} shellExtiRecord_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellExtiHold(uint8_t line, uint8_t port, uint8_t edge, uint8_t priority);
+
+#endif // CLI_SHELL_EXTI_H_
+
+/*** end of file ***/
@@ -0,0 +1,505 @@
+/** @file CLI_SHELL_FLASH.c
+ *
+ * @brief Internal flash storage for the CLI Shell: sector erase and word programming
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Interrupt driven operation queue, "flash" status
+ * - 1.2: 10-14-2026 (Crandell) Completions signal the main loop
+ * - 1.3: 10-14-2026 (Crandell) Handler profiled (CLI_SHELL_ISR)
+ * - 1.4: 10-15-2026 (Crandell) Every erase or program makes the kept responses stale (CLI_SHELL_CACHE)
+ * - 1.5: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_FLASH.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_CACHE.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define FLASH_ERROR_FLAGS		(FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | \
+								 FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Kind of a queued operation
+  */
+typedef enum {
+	flashOp_erase,
+	flashOp_program
+} flashOpType_t;
+
+/**
+  * @brief  State of a queue entry
+  */
+typedef enum {
+	flashOp_queued,
+	flashOp_running,
+	flashOp_ok,
+	flashOp_failed
+} flashOpState_t;
+
+/**
+  * @brief  One queued operation
+  */
+typedef struct {
+	flashOpType_t type;
+	volatile flashOpState_t state;
+	uint32_t target;						/*!< Sector (erase) or address (program)	*/
+	const uint8_t* data;
+	uint32_t length;
+	shellFlashDone_t done;
+	void* context;
+} flashOp_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  Operation queue. Entries from head to run have ended and wait for shellFlashPoll(),
+  * 		run is the running one, up to tail are waiting.
+  */
+static struct {
+	flashOp_t ops[SHELL_FLASH_QUEUE_LEN];
+	volatile uint8_t head;
+	volatile uint8_t run;
+	volatile uint8_t tail;
+	volatile uint8_t count;					/*!< Entries not yet reported				*/
+	volatile uint8_t pending;				/*!< Entries running or waiting				*/
+
+	volatile uint32_t offset;				/*!< Bytes programmed of the running operation	*/
+	volatile int8_t event;					/*!< 1 end of operation, -1 error, set by the HAL callbacks	*/
+	uint32_t startTick;						/*!< HAL_GetTick() when the running operation started	*/
+	bool irqEnabled;
+
+	uint32_t erases;						/*!< Counters since reset					*/
+	uint32_t programs;
+	uint32_t errors;
+} flashQueue;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool flashEnqueue(flashOpType_t type, uint32_t target, const void* data, uint32_t length,
+		shellFlashDone_t done, void* context);
+static bool flashProgramWord(flashOp_t* op);
+static void flashStart(void);
+static void flashFinish(bool ok);
+static void flashAdvance(void);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Adds an operation to the queue and starts it if the flash is idle
+  * @retval bool Returns false if the queue is full
+  */
+static bool flashEnqueue(flashOpType_t type, uint32_t target, const void* data, uint32_t length,
+		shellFlashDone_t done, void* context) {
+	if (!flashQueue.irqEnabled) {
+		HAL_NVIC_SetPriority(FLASH_IRQn, SHELL_FLASH_IRQ_PRIORITY, 0);
+		HAL_NVIC_EnableIRQ(FLASH_IRQn);
+		flashQueue.irqEnabled = true;
+	}
+
+	// The interrupt advances run, keep it out while the queue changes
+	HAL_NVIC_DisableIRQ(FLASH_IRQn);
+
+	if (flashQueue.count >= SHELL_FLASH_QUEUE_LEN) {
+		HAL_NVIC_EnableIRQ(FLASH_IRQn);
+		return false;
+	}
+
+	flashOp_t* op = &flashQueue.ops[flashQueue.tail];
+	op->type = type;
+	op->state = flashOp_queued;
+	op->target = target;
+	op->data = (const uint8_t*)data;
+	op->length = length;
+	op->done = done;
+	op->context = context;
+
+	bool idle = (flashQueue.pending == 0);
+	flashQueue.tail = (flashQueue.tail + 1) % SHELL_FLASH_QUEUE_LEN;
+	flashQueue.count++;
+	flashQueue.pending++;
+	if (idle) {
+		flashStart();
+	}
+
+	HAL_NVIC_EnableIRQ(FLASH_IRQn);
+	return true;
+}
+
+/**
+  * @brief  Starts programming the next word of the running operation
+  * @note	A partial last word is padded with 0xFF.
+  * @param[IN]  op The running program operation
+  * @retval bool Returns false if the HAL refused
+  */
+static bool flashProgramWord(flashOp_t* op) {
+	uint32_t word = 0xFFFFFFFFU;
+	uint32_t offset = flashQueue.offset;
+	uint32_t len = (op->length - offset < 4) ? (op->length - offset) : 4;
+
+	memcpy(&word, &op->data[offset], len);
+	return HAL_FLASH_Program_IT(FLASH_TYPEPROGRAM_WORD, op->target + offset, word) == HAL_OK;
+}
+
+/**
+  * @brief  Starts the operation at run, if any
+  * @note	Runs with the FLASH interrupt kept out (queue) or from it.
+  * @param  NONE
+  * @retval NONE
+  */
+static void flashStart(void) {
+	if (flashQueue.pending == 0) {
+		return;
+	}
+
+	flashOp_t* op = &flashQueue.ops[flashQueue.run];
+	bool started;
+
+	op->state = flashOp_running;
+	flashQueue.offset = 0;
+	flashQueue.event = 0;
+	flashQueue.startTick = HAL_GetTick();
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_ERROR_FLAGS);
+
+	if (op->type == flashOp_erase) {
+		FLASH_EraseInitTypeDef eraseInit = {0};
+
+		eraseInit.TypeErase = FLASH_TYPEERASE_SECTORS;
+		eraseInit.Sector = op->target;
+		eraseInit.NbSectors = 1;
+		eraseInit.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+		started = (HAL_FLASHEx_Erase_IT(&eraseInit) == HAL_OK);
+	} else if ((op->target & 0x03U) != 0) {
+		started = false;
+	} else if (op->length == 0) {
+		flashFinish(true);
+		return;
+	} else {
+		started = flashProgramWord(op);
+	}
+
+	if (!started) {
+		flashFinish(false);
+	}
+}
+
+/**
+  * @brief  Ends the running operation and starts the next one
+  * @param[IN]  ok Result of the operation
+  * @retval NONE
+  */
+static void flashFinish(bool ok) {
+	flashOp_t* op = &flashQueue.ops[flashQueue.run];
+
+	HAL_FLASH_Lock();
+	shellCacheInvalidate();
+
+	if (op->type == flashOp_program && ok && op->length != 0) {
+		ok = (memcmp((const void*)op->target, op->data, op->length) == 0);
+	}
+
+	if (!ok) {
+		flashQueue.errors++;
+	} else if (op->type == flashOp_erase) {
+		flashQueue.erases++;
+	} else {
+		flashQueue.programs++;
+	}
+
+	op->state = ok ? flashOp_ok : flashOp_failed;
+	flashQueue.run = (flashQueue.run + 1) % SHELL_FLASH_QUEUE_LEN;
+	flashQueue.pending--;
+	flashStart();
+}
+
+/**
+  * @brief  Acts on the event the HAL callbacks noted, from FLASH_IRQHandler()
+  * @param  NONE
+  * @retval NONE
+  */
+static void flashAdvance(void) {
+	int8_t event = flashQueue.event;
+	flashQueue.event = 0;
+
+	if (event == 0 || flashQueue.pending == 0) {
+		return;
+	}
+	shellEventSignal(SHELL_EVENT_PERIPH);
+
+	flashOp_t* op = &flashQueue.ops[flashQueue.run];
+	if (event < 0) {
+		flashFinish(false);
+		return;
+	}
+
+	if (op->type == flashOp_program) {
+		flashQueue.offset += 4;
+		if (flashQueue.offset < op->length) {
+			if (!flashProgramWord(op)) {
+				flashFinish(false);
+			}
+			return;
+		}
+	}
+	flashFinish(true);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Erases one flash sector
+  * @note	Blocks until the erase is done. HAL_FLASHEx_Erase() flushes the flash caches
+  * 		afterwards, so no stale lines of the sector are read back.
+  * @param[IN]  sector Sector number (FLASH_SECTOR_)
+  * @retval bool Returns false if the HAL reported an error
+  */
+bool shellFlashErase(uint32_t sector) {
+	FLASH_EraseInitTypeDef eraseInit = {0};
+	uint32_t sectorError = 0;
+	HAL_StatusTypeDef status;
+
+	while (shellFlashBusy()) {
+		// Queued operations go first
+	}
+
+	eraseInit.TypeErase = FLASH_TYPEERASE_SECTORS;
+	eraseInit.Sector = sector;
+	eraseInit.NbSectors = 1;
+	eraseInit.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_ERROR_FLAGS);
+	status = HAL_FLASHEx_Erase(&eraseInit, &sectorError);
+	HAL_FLASH_Lock();
+	shellCacheInvalidate();
+
+	return (status == HAL_OK && sectorError == 0xFFFFFFFFU);
+}
+
+/**
+  * @brief  Programs data into erased flash, one word at a time
+  * @note	A partial last word is padded with 0xFF, which leaves those bytes erased.
+  * @param[IN]  address Destination, word aligned
+  * @param[IN]  data Data to program
+  * @param[IN]  length Number of bytes
+  * @retval bool Returns false if the HAL reported an error or the flash reads back different
+  */
+bool shellFlashProgram(uint32_t address, const void* data, uint32_t length) {
+	const uint8_t* bytes = (const uint8_t*)data;
+	bool ok = true;
+
+	if ((address & 0x03U) != 0) {
+		return false;
+	}
+
+	while (shellFlashBusy()) {
+		// Queued operations go first
+	}
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_ERROR_FLAGS);
+
+	for (uint32_t done = 0; ok && done < length; done += 4) {
+		uint32_t word = 0xFFFFFFFFU;
+		uint32_t len = (length - done < 4) ? (length - done) : 4;
+
+		memcpy(&word, &bytes[done], len);
+		ok = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + done, word) == HAL_OK);
+	}
+
+	HAL_FLASH_Lock();
+	shellCacheInvalidate();
+
+	return ok && (length == 0 || memcmp((const void*)address, data, length) == 0);
+}
+
+/**
+  * @brief  Checks that a flash range is erased
+  * @param[IN]  address First address
+  * @param[IN]  length Number of bytes
+  * @retval bool Returns true if every byte reads 0xFF
+  */
+bool shellFlashBlank(uint32_t address, uint32_t length) {
+	const uint8_t* bytes = (const uint8_t*)address;
+
+	for (uint32_t i = 0; i < length; i++) {
+		if (bytes[i] != 0xFF) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  Queues the erase of one flash sector
+  * @param[IN]  sector Sector number (FLASH_SECTOR_)
+  * @param[IN]  done Called from shellFlashPoll() once the erase has ended, may be NULL
+  * @param[IN]  context Passed to done
+  * @retval bool Returns false if the queue is full
+  */
+bool shellFlashQueueErase(uint32_t sector, shellFlashDone_t done, void* context) {
+	return flashEnqueue(flashOp_erase, sector, NULL, 0, done, context);
+}
+
+/**
+  * @brief  Queues programming data into erased flash
+  * @note	The data is read while the words are programmed, not copied.
+  * @param[IN]  address Destination, word aligned
+  * @param[IN]  data Data to program, valid until done is called
+  * @param[IN]  length Number of bytes
+  * @param[IN]  done Called from shellFlashPoll() once written and verified, may be NULL
+  * @param[IN]  context Passed to done
+  * @retval bool Returns false if the queue is full
+  */
+bool shellFlashQueueProgram(uint32_t address, const void* data, uint32_t length, shellFlashDone_t done, void* context) {
+	return flashEnqueue(flashOp_program, address, data, length, done, context);
+}
+
+/**
+  * @brief  Checks for a running or waiting operation
+  * @param  NONE
+  * @retval bool Returns true until the queue has drained
+  */
+bool shellFlashBusy(void) {
+	return flashQueue.pending != 0;
+}
+
+/**
+  * @brief  Reports the ended operations to their done callbacks
+  * @note	Called by checkShellStatus().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellFlashPoll(void) {
+	while (flashQueue.count != 0) {
+		flashOp_t* op = &flashQueue.ops[flashQueue.head];
+
+		if (op->state != flashOp_ok && op->state != flashOp_failed) {
+			return;
+		}
+
+		shellFlashDone_t done = op->done;
+		void* context = op->context;
+		bool ok = (op->state == flashOp_ok);
+
+		flashQueue.head = (flashQueue.head + 1) % SHELL_FLASH_QUEUE_LEN;
+		HAL_NVIC_DisableIRQ(FLASH_IRQn);
+		flashQueue.count--;
+		HAL_NVIC_EnableIRQ(FLASH_IRQn);
+
+		if (done != NULL) {
+			done(ok, context);
+		}
+	}
+}
+
+/**
+  * @brief  FLASH interrupt, advances the running operation
+  * @note	The HAL callbacks only note the event. The next word or operation is started after
+  * 		HAL_FLASH_IRQHandler() has released the HAL lock.
+  * @param  NONE
+  * @retval NONE
+  */
+void FLASH_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_FLASH_IRQHandler();
+	flashAdvance();
+	SHELL_ISR_RECORD(isrId_flash, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  HAL end of operation callback
+  * @param[IN]  ReturnValue Programmed address, or 0xFFFFFFFF once the sector is erased
+  * @retval NONE
+  */
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue) {
+	// An error in the same interrupt wins
+	if (flashQueue.event == 0) {
+		flashQueue.event = 1;
+	}
+}
+
+/**
+  * @brief  HAL operation error callback
+  * @param[IN]  ReturnValue Faulty sector or address
+  * @retval NONE
+  */
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue) {
+	flashQueue.event = -1;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the running flash operation, the queue and the counters
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error FlashBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+	uint8_t pending = flashQueue.pending;
+
+	if (pending == 0) {
+		shellStrAppend(&str, "Flash: idle\r\n");
+	} else {
+		const flashOp_t* op = &flashQueue.ops[flashQueue.run];
+		uint8_t waiting = pending - 1;
+
+		if (op->type == flashOp_erase) {
+			shellStrAppend(&str, "Flash: erase sector ");
+			shellStrAppendUnsigned(&str, op->target, 0);
+			shellStrAppend(&str, ", ");
+			shellStrAppendUnsigned(&str, HAL_GetTick() - flashQueue.startTick, 0);
+			shellStrAppend(&str, " ms, ");
+		} else {
+			shellStrAppend(&str, "Flash: program 0x");
+			shellStrAppendHex(&str, op->target, 8);
+			shellStrAppend(&str, ", ");
+			shellStrAppendUnsigned(&str, flashQueue.offset, 0);
+			shellStrAppend(&str, " of ");
+			shellStrAppendUnsigned(&str, op->length, 0);
+			shellStrAppend(&str, " bytes, ");
+		}
+		shellStrAppendUnsigned(&str, waiting, 0);
+		shellStrAppend(&str, " queued\r\n");
+	}
+	shellStrSend(ctx, &str);
+
+	shellStrAppend(&str, "Erases: ");
+	shellStrAppendUnsigned(&str, flashQueue.erases, 0);
+	shellStrAppend(&str, ", Programs: ");
+	shellStrAppendUnsigned(&str, flashQueue.programs, 0);
+	shellStrAppend(&str, ", Errors: ");
+	shellStrAppendUnsigned(&str, flashQueue.errors, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
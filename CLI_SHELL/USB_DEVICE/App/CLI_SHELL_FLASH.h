@@ -0,0 +1,85 @@
+/** @file CLI_SHELL_FLASH.h
+ *
+ * @brief Internal flash storage for the CLI Shell: sector erase and word programming
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Sectors 1 and 2 for the settings store
+ * - 1.2: 10-14-2026 (Crandell) Interrupt driven operation queue, "flash" status
+ * - 1.3: 10-15-2026 (Crandell) Boot stub in sector 0, update slot in sector 6 (CLI_SHELL_FWUPDATE.h)
+ * - 1.4: 10-15-2026 (Crandell) Modules in sectors 3 and 4, program in sector 5
+ * - 1.5: 10-15-2026 (Crandell) Macros in sector 3, program in sectors 4 and 5, update slot in sectors 6 and 7
+ *
+ * Usage Notes:
+ *  - The storage sectors are cut off the FLASH region of STM32F411RETX_FLASH.ld, the program
+ *    never lands there. The 16 KB sectors 1 and 2 (0x08004000) hold the settings (CLI_SHELL_KV.h),
+ *    sector 3 (16 KB at 0x0800C000) the command macros (CLI_SHELL_MACRO.h). Sector 0 keeps the boot
+ *    stub and the command modules (CLI_SHELL_MODULE.h), the program with its vector table is
+ *    sectors 4 and 5 and sectors 6 and 7 the firmware update slot (CLI_SHELL_FWUPDATE.h).
+ *  - Flash the .elf or .hex image. A .bin is contiguous from 0x08000000 and overwrites sectors 0
+ *    to 3, which wipes the modules, the settings and the macros.
+ *  - Erased flash reads 0xFF. Programming can only clear bits, so a location is written once
+ *    between erases. shellFlashProgram() verifies what it wrote.
+ *  - An erase or a program stalls every fetch from flash until it is done, interrupts included.
+ *    A 16 KB sector takes about 250 ms to erase, a 128 KB sector 1 to 2 seconds.
+ *  - shellFlashQueueErase()/shellFlashQueueProgram() queue an operation and return at once. The
+ *    FLASH interrupt (HAL_FLASHEx_Erase_IT, HAL_FLASH_Program_IT) starts each one when the previous
+ *    ends and programs one word per interrupt, so the main loop and USB run between the words.
+ *    An erase still stalls the flash fetches until it ends (one bank, no erase suspend), but
+ *    nothing spins waiting for it and the shell carries on as soon as it is done.
+ *  - The done callback runs from shellFlashPoll() (checkShellStatus()), never from the interrupt.
+ *    Data to program must stay valid until then.
+ *  - The blocking functions wait for the queue to drain first, so both can be mixed.
+ *  - "flash" shows the running operation with its progress, the queue and the counters.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_FLASH_H_
+#define CLI_SHELL_FLASH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_FLASH_MACRO_SECTOR		3U				/*!< FLASH_SECTOR_3					*/
+#define SHELL_FLASH_MACRO_ADDR			0x0800C000U
+#define SHELL_FLASH_MACRO_SIZE			(16U * 1024U)
+
+#define SHELL_FLASH_KV_SECTOR_A			1U				/*!< FLASH_SECTOR_1					*/
+#define SHELL_FLASH_KV_ADDR_A			0x08004000U
+#define SHELL_FLASH_KV_SECTOR_B			2U				/*!< FLASH_SECTOR_2					*/
+#define SHELL_FLASH_KV_ADDR_B			0x08008000U
+#define SHELL_FLASH_KV_SIZE				(16U * 1024U)	/*!< Per sector						*/
+
+#define SHELL_FLASH_QUEUE_LEN			5			/*!< Queued operations at most			*/
+#define SHELL_FLASH_IRQ_PRIORITY		1			/*!< Below OTG_FS						*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+// Called from shellFlashPoll() when a queued operation has ended
+typedef void (*shellFlashDone_t)(bool ok, void* context);
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellFlashErase(uint32_t sector);
+bool shellFlashProgram(uint32_t address, const void* data, uint32_t length);
+bool shellFlashBlank(uint32_t address, uint32_t length);
+
+bool shellFlashQueueErase(uint32_t sector, shellFlashDone_t done, void* context);
+bool shellFlashQueueProgram(uint32_t address, const void* data, uint32_t length, shellFlashDone_t done, void* context);
+bool shellFlashBusy(void);
+void shellFlashPoll(void);
+
+#endif // CLI_SHELL_FLASH_H_
+
+/*** end of file ***/
@@ -0,0 +1,217 @@
+/** @file CLI_SHELL_FORMAT.c
+ *
+ * @brief Fast hex and decimal formatting for CLI Shell responses, dumps and telemetry
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) CLI_SHELL_PORT.h for the host build
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_FORMAT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define FMT_SIMD			1
+#else
+#define FMT_SIMD			0
+#endif
+
+#define FMT_NIBBLES			0x000F000FU		/*!< One nibble per halfword				*/
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const char hexDigits[] = "0123456789ABCDEF";
+
+static const char decPairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static inline uint32_t nibblesToHex(uint32_t nibbles);
+static inline void hexEncode4(uint32_t bytes, uint32_t* first, uint32_t* second);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Converts 4 nibbles, one per byte, to 4 hex characters
+  * @param[IN]  nibbles Values 0 to 15 in every byte
+  * @retval uint32_t The characters, same byte order
+  */
+static inline uint32_t nibblesToHex(uint32_t nibbles) {
+#if FMT_SIMD
+	// UADD8 sets the GE flag of every byte >= 10 (the sum carries), SEL then picks per byte
+	(void)__UADD8(nibbles, 0xF6F6F6F6U);
+	return nibbles + __SEL(0x37373737U, 0x30303030U);
+#else
+	uint32_t letters = ((nibbles + 0x06060606U) >> 4) & 0x01010101U;
+
+	return nibbles + 0x30303030U + (letters * 7U);
+#endif
+}
+
+/**
+  * @brief  Hex encodes 4 bytes in memory order
+  * @note	The bytes are spread to halfwords (0 and 2, 1 and 3), every halfword becomes its
+  * 		high nibble in the low byte and its low nibble in the high byte, and the pairs are
+  * 		packed back in order.
+  * @param[IN]  bytes Byte 0 in the least significant byte
+  * @param[OUT]  first Characters of bytes 0 and 1
+  * @param[OUT]  second Characters of bytes 2 and 3
+  * @retval NONE
+  */
+static inline void hexEncode4(uint32_t bytes, uint32_t* first, uint32_t* second) {
+#if FMT_SIMD
+	uint32_t even = __UXTB16(bytes);
+	uint32_t odd = __UXTB16(__ROR(bytes, 8));
+#else
+	uint32_t even = bytes & 0x00FF00FFU;
+	uint32_t odd = (bytes >> 8) & 0x00FF00FFU;
+#endif
+
+	even = nibblesToHex(((even >> 4) & FMT_NIBBLES) | ((even & FMT_NIBBLES) << 8));
+	odd = nibblesToHex(((odd >> 4) & FMT_NIBBLES) | ((odd & FMT_NIBBLES) << 8));
+
+#if FMT_SIMD
+	*first = __PKHBT(even, odd, 16);
+	*second = __PKHTB(odd, even, 16);
+#else
+	*first = (even & 0x0000FFFFU) | (odd << 16);
+	*second = (odd & 0xFFFF0000U) | (even >> 16);
+#endif
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  2 hex digits
+  * @param[OUT]  out At least 2 characters
+  * @param[IN]  value Value
+  * @retval uint8_t Characters written (2)
+  */
+uint8_t shellFmtHex8(char* out, uint8_t value) {
+	out[0] = hexDigits[value >> 4];
+	out[1] = hexDigits[value & 0x0F];
+	return 2;
+}
+
+/**
+  * @brief  4 hex digits
+  * @param[OUT]  out At least 4 characters
+  * @param[IN]  value Value
+  * @retval uint8_t Characters written (4)
+  */
+uint8_t shellFmtHex16(char* out, uint16_t value) {
+	uint32_t first, second;
+
+	// Most significant byte first
+	hexEncode4(__REV16(value), &first, &second);
+	memcpy(out, &first, sizeof(first));
+	return 4;
+}
+
+/**
+  * @brief  8 hex digits
+  * @param[OUT]  out At least 8 characters
+  * @param[IN]  value Value
+  * @retval uint8_t Characters written (8)
+  */
+uint8_t shellFmtHex32(char* out, uint32_t value) {
+	uint32_t first, second;
+
+	// Most significant byte first
+	hexEncode4(__REV(value), &first, &second);
+	memcpy(out, &first, sizeof(first));
+	memcpy(&out[4], &second, sizeof(second));
+	return 8;
+}
+
+/**
+  * @brief  Hex encodes a block, 2 digits per byte in memory order
+  * @param[OUT]  out At least 2 * len characters
+  * @param[IN]  data Bytes
+  * @param[IN]  len Number of bytes
+  * @retval uint32_t Characters written
+  */
+uint32_t shellFmtHexBytes(char* out, const uint8_t* data, uint32_t len) {
+	uint32_t done = 0;
+
+	for (; done + 4 <= len; done += 4) {
+		uint32_t bytes, first, second;
+
+		memcpy(&bytes, &data[done], sizeof(bytes));
+		hexEncode4(bytes, &first, &second);
+		memcpy(&out[done * 2], &first, sizeof(first));
+		memcpy(&out[done * 2 + 4], &second, sizeof(second));
+	}
+	for (; done < len; done++) {
+		shellFmtHex8(&out[done * 2], data[done]);
+	}
+	return len * 2;
+}
+
+/**
+  * @brief  Decimal without leading zeros
+  * @param[OUT]  out At least SHELL_FMT_DEC_LEN characters
+  * @param[IN]  value Value
+  * @retval uint8_t Characters written
+  */
+uint8_t shellFmtUnsigned(char* out, uint32_t value) {
+	char digits[SHELL_FMT_DEC_LEN];
+	uint8_t pos = SHELL_FMT_DEC_LEN;
+
+	// Built from the end, 2 digits per division
+	while (value >= 100) {
+		uint32_t pair = value % 100;
+
+		value /= 100;
+		pos -= 2;
+		memcpy(&digits[pos], &decPairs[pair * 2], 2);
+	}
+	if (value >= 10) {
+		pos -= 2;
+		memcpy(&digits[pos], &decPairs[value * 2], 2);
+	} else {
+		digits[--pos] = (char)('0' + value);
+	}
+
+	memcpy(out, &digits[pos], SHELL_FMT_DEC_LEN - pos);
+	return SHELL_FMT_DEC_LEN - pos;
+}
+
+/**
+  * @brief  Decimal with a '-' for negative values
+  * @param[OUT]  out At least SHELL_FMT_DEC_LEN + 1 characters
+  * @param[IN]  value Value
+  * @retval uint8_t Characters written
+  */
+uint8_t shellFmtSigned(char* out, int32_t value) {
+	if (value < 0) {
+		out[0] = '-';
+		// Negated as unsigned, INT32_MIN has no positive int32_t
+		return 1 + shellFmtUnsigned(&out[1], 0U - (uint32_t)value);
+	}
+	return shellFmtUnsigned(out, (uint32_t)value);
+}
+
+/*** end of file ***/
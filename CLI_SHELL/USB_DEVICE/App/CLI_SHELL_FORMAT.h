@@ -0,0 +1,51 @@
+/** @file CLI_SHELL_FORMAT.h
+ *
+ * @brief Fast hex and decimal formatting for CLI Shell responses, dumps and telemetry
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The functions write the characters to out and return how many they wrote. They never write
+ *    a terminator, so records and lines are built with "pos += shellFmt...(&line[pos], value)".
+ *  - Hex is upper case without a prefix and always full width: shellFmtHex8() 2, shellFmtHex16() 4
+ *    and shellFmtHex32() 8 characters. shellFmtHexBytes() writes 2 characters per byte in memory order.
+ *  - On the Cortex-M4 the hex encoder converts 4 bytes at a time with the DSP instructions
+ *    (UXTB16 to spread the bytes, UADD8/SEL to pick digit or letter per byte, PKHBT/PKHTB to
+ *    put the characters in order). Cores without the DSP extension use the same steps in plain C.
+ *  - Decimals take 2 digits per division from a table, shellFmtUnsigned() writes at most
+ *    SHELL_FMT_DEC_LEN characters, shellFmtSigned() one more for the sign.
+ *  - No printf machinery and no heap, the decimal scratch is 10 bytes of stack.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_FORMAT_H_
+#define CLI_SHELL_FORMAT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_FMT_DEC_LEN		10			/*!< Digits of UINT32_MAX			*/
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+uint8_t shellFmtHex8(char* out, uint8_t value);
+uint8_t shellFmtHex16(char* out, uint16_t value);
+uint8_t shellFmtHex32(char* out, uint32_t value);
+uint32_t shellFmtHexBytes(char* out, const uint8_t* data, uint32_t len);
+uint8_t shellFmtUnsigned(char* out, uint32_t value);
+uint8_t shellFmtSigned(char* out, int32_t value);
+
+#endif // CLI_SHELL_FORMAT_H_
+
+/*** end of file ***/
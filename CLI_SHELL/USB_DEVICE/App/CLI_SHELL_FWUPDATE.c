@@ -0,0 +1,487 @@
+/** @file CLI_SHELL_FWUPDATE.c
+ *
+ * @brief Firmware update of the CLI Shell: image download into the update slot and the boot stub
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Received bytes go to the staging buffers by the copy service
+ * - 1.2: 10-15-2026 (Crandell) The boot stub erases sector 5 only
+ * - 1.3: 10-15-2026 (Crandell) Program and slot span two sectors each
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_FWUPDATE.h"
+#include "CLI_SHELL_FLASH.h"
+#include "CLI_SHELL_CRC.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_RESULT.h"
+#include "CLI_SHELL_COPY.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  Code of the boot stub, linked into sector 0 (.boot of STM32F411RETX_FLASH.ld). It runs
+  * 		before the .data copy and while the program sectors are rewritten, so it calls nothing
+  * 		outside of .boot: registers only, no HAL, no library calls.
+  */
+#define FW_BOOT							__attribute__((section(".boot")))
+
+#define FW_BOOT_SR_ERRORS				(FLASH_SR_SOP | FLASH_SR_WRPERR | FLASH_SR_PGAERR | \
+										 FLASH_SR_PGPERR | FLASH_SR_PGSERR)
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+extern uint32_t _estack;
+
+/**
+  * @brief  The download running
+  */
+static struct {
+	uint8_t buffer[2][SHELL_FW_BUFFER_LEN];	/*!< Staging buffers, one fills while the other is programmed	*/
+	bool inFlight[2];						/*!< Buffer queued for programming			*/
+	uint8_t fill;							/*!< Buffer filled from the receive ring	*/
+	uint16_t fillLen;
+	volatile bool copying;					/*!< The copy service moves ring bytes		*/
+	uint16_t copyLen;						/*!< Bytes of that copy, still in the ring	*/
+	bool erasing[SHELL_FW_SLOT_SECTORS];	/*!< Slot sector erase queued				*/
+	bool writingHeader;
+	bool failed;							/*!< A flash operation has failed			*/
+
+	uint32_t length;						/*!< Bytes of the image						*/
+	uint32_t crc;							/*!< CRC32 the host sent					*/
+	uint32_t received;
+	uint32_t programmed;					/*!< Slot offset of the next buffer			*/
+	uint32_t slotCrc;
+	shell_error check;						/*!< State of the CRC of the slot			*/
+	shellFwHeader_t header;
+
+	uint32_t startTick;
+	uint32_t lastTick;						/*!< Last data or flash progress			*/
+	uint32_t endTick;
+} fw;
+
+static bool resetArmed = false;
+static uint32_t resetTick;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void fwBootReset(void) FW_BOOT;
+static void fwBootHalt(void) FW_BOOT;
+static void fwBootWait(void) FW_BOOT;
+static bool fwBootCopy(uint32_t length) FW_BOOT;
+static void fwBootMarkApplied(void) FW_BOOT;
+static void fwBootStart(void) FW_BOOT __attribute__((noreturn));
+
+static void fwFlashDone(bool ok, void* context);
+static void fwCopied(bool ok, void* context);
+static bool fwReceive(shell_ctx_t* ctx);
+static bool fwSlotPending(void);
+static shell_error fwJob(shellJob_t* job);
+
+/**
+  * @brief  Vector table at the reset address: the initial stack, the boot stub and the two
+  * 		exceptions it could raise. The program has its own table at SHELL_FW_APP_ADDR.
+  */
+__attribute__((section(".boot_vector"), used))
+static void (* const fwBootVectors[4])(void) = {
+	(void (*)(void))&_estack,
+	fwBootReset,
+	fwBootHalt,								/*!< NMI									*/
+	fwBootHalt								/*!< HardFault								*/
+};
+
+/********************************************************************************
+ * BOOT STUB
+ *******************************************************************************/
+/**
+  * @brief  Reset entry: applies a pending image of the update slot, then starts the program
+  * @param  NONE
+  * @retval NONE
+  */
+static void fwBootReset(void) {
+	const volatile shellFwHeader_t* header = (const volatile shellFwHeader_t*)SHELL_FW_HEADER_ADDR;
+
+	if (header->magic == SHELL_FW_MAGIC && header->applied == 0xFFFFFFFFU &&
+			header->length != 0 && header->length <= SHELL_FW_IMAGE_MAX) {
+		for (uint32_t i = 0; i < SHELL_FW_BOOT_TRIES; i++) {
+			if (fwBootCopy(header->length)) {
+				fwBootMarkApplied();
+				break;
+			}
+		}
+		FLASH->CR |= FLASH_CR_LOCK;
+	}
+	fwBootStart();
+}
+
+/**
+  * @brief  Fault in the boot stub, waits for the watchdog or a reset
+  * @param  NONE
+  * @retval NONE
+  */
+static void fwBootHalt(void) {
+	while (1) {
+	}
+}
+
+/**
+  * @brief  Waits for the running flash operation
+  * @param  NONE
+  * @retval NONE
+  */
+static void fwBootWait(void) {
+	while (FLASH->SR & FLASH_SR_BSY) {
+	}
+}
+
+/**
+  * @brief  Copies the image of the slot over the program and compares the copy
+  * @note	Erases the program sectors only, the modules stay. An interrupted copy leaves the
+  * 		header pending, the next reset starts it over.
+  * @param[IN]  length Bytes of the image
+  * @retval bool Returns true if the program sectors hold the image
+  */
+static bool fwBootCopy(uint32_t length) {
+	const volatile uint32_t* source = (const volatile uint32_t*)SHELL_FW_SLOT_ADDR;
+	volatile uint32_t* target = (volatile uint32_t*)SHELL_FW_APP_ADDR;
+	uint32_t words = (length + 3U) / 4U;
+
+	fwBootWait();
+	if (FLASH->CR & FLASH_CR_LOCK) {
+		FLASH->KEYR = FLASH_KEY1;
+		FLASH->KEYR = FLASH_KEY2;
+	}
+	FLASH->SR = FLASH_SR_EOP | FW_BOOT_SR_ERRORS;
+
+	for (uint32_t sector = SHELL_FW_APP_SECTOR; sector < (SHELL_FW_APP_SECTOR + SHELL_FW_APP_SECTORS); sector++) {
+		FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_SER | (sector << FLASH_CR_SNB_Pos);
+		FLASH->CR |= FLASH_CR_STRT;
+		fwBootWait();
+	}
+
+	// Bytes past the image are erased in the slot too, the last word copies as it is
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+	for (uint32_t i = 0; i < words; i++) {
+		target[i] = source[i];
+		fwBootWait();
+	}
+	FLASH->CR = 0;
+
+	if (FLASH->SR & FW_BOOT_SR_ERRORS) {
+		return false;
+	}
+	for (uint32_t i = 0; i < words; i++) {
+		if (target[i] != source[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  Clears the applied word of the header, the image is not copied again
+  * @param  NONE
+  * @retval NONE
+  */
+static void fwBootMarkApplied(void) {
+	volatile shellFwHeader_t* header = (volatile shellFwHeader_t*)SHELL_FW_HEADER_ADDR;
+
+	FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+	header->applied = 0;
+	fwBootWait();
+	FLASH->CR = 0;
+}
+
+/**
+  * @brief  Starts the program through its vector table
+  * @param  NONE
+  * @retval NONE
+  */
+static void fwBootStart(void) {
+	const volatile uint32_t* vectors = (const volatile uint32_t*)SHELL_FW_APP_ADDR;
+	uint32_t entry = vectors[1];
+
+	SCB->VTOR = SHELL_FW_APP_ADDR;
+	__DSB();
+	__set_MSP(vectors[0]);
+	((void (*)(void))entry)();
+
+	while (1) {
+	}
+}
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Done callback of the erase and program operations of a download
+  * @param[IN]  ok Result of the operation
+  * @param[IN]  context Busy flag of the operation
+  * @retval NONE
+  */
+static void fwFlashDone(bool ok, void* context) {
+	*(bool*)context = false;
+	if (!ok) {
+		fw.failed = true;
+	}
+	fw.lastTick = HAL_GetTick();
+}
+
+/**
+  * @brief  Done callback of a copy from the receive ring into a staging buffer
+  * @param[IN]  ok Result of the copy
+  * @param[IN]  context Unused
+  * @retval NONE
+  */
+static void fwCopied(bool ok, void* context) {
+	(void)context;
+	if (!ok) {
+		fw.failed = true;
+	}
+	fw.copying = false;
+}
+
+/**
+  * @brief  Moves received bytes into the staging buffers and queues every full one
+  * @note	With both buffers queued nothing is read, the receive ring fills and holds the
+  * 		host back until the flash catches up. The bytes are copied straight out of the
+  * 		ring (CLI_SHELL_COPY.h) and only leave it once the copy is done, the USB interrupt
+  * 		cannot overwrite them meanwhile.
+  * @param[IN]  ctx Shell instance of the download
+  * @retval bool Returns true once the whole image is queued
+  */
+static bool fwReceive(shell_ctx_t* ctx) {
+	while (!fw.copying) {
+		uint8_t index = fw.fill;
+
+		if (fw.copyLen != 0) {
+			shellRingSkip(&ctx->rxRing, fw.copyLen);
+			fw.fillLen += fw.copyLen;
+			fw.received += fw.copyLen;
+			fw.copyLen = 0;
+			fw.lastTick = HAL_GetTick();
+
+			if (fw.fillLen == SHELL_FW_BUFFER_LEN || fw.received == fw.length) {
+				fw.inFlight[index] = true;
+				if (!shellFlashQueueProgram(SHELL_FW_SLOT_ADDR + fw.programmed, fw.buffer[index], fw.fillLen,
+						fwFlashDone, &fw.inFlight[index])) {
+					fw.inFlight[index] = false;
+					fw.failed = true;
+					return false;
+				}
+				fw.programmed += fw.fillLen;
+				fw.fill ^= 1;
+				fw.fillLen = 0;
+			}
+			continue;
+		}
+
+		if (fw.received == fw.length) {
+			return true;
+		}
+		if (fw.inFlight[index]) {
+			return false;
+		}
+
+		uint8_t* data;
+		uint32_t got = shellRingPeekContiguous(&ctx->rxRing, &data);
+		uint32_t room = SHELL_FW_BUFFER_LEN - fw.fillLen;
+		uint32_t rest = fw.length - fw.received;
+
+		if (got == 0) {
+			return false;
+		}
+		if (got > room) {
+			got = room;
+		}
+		if (got > rest) {
+			got = rest;
+		}
+		fw.copyLen = (uint16_t)got;
+		fw.copying = true;
+		shellCopyStart(&fw.buffer[index][fw.fillLen], data, got, fwCopied, NULL);
+	}
+	return false;
+}
+
+/**
+  * @brief  Checks for a complete image in the slot that the boot stub has not applied yet
+  * @param  NONE
+  * @retval bool Returns true if the header is pending and the CRC of the image matches it
+  */
+static bool fwSlotPending(void) {
+	const shellFwHeader_t* header = (const shellFwHeader_t*)SHELL_FW_HEADER_ADDR;
+
+	return header->magic == SHELL_FW_MAGIC && header->applied == 0xFFFFFFFFU &&
+			header->length != 0 && header->length <= SHELL_FW_IMAGE_MAX &&
+			shellCrc32(SHELL_CRC32_INIT, (const void*)SHELL_FW_SLOT_ADDR, header->length) == header->crc;
+}
+
+/**
+  * @brief  Poll function of a download
+  * @note	The flash operations still queued after a cancel end on their own. The slot has no
+  * 		header then, nothing is applied.
+  * @param[IN]  job The download job
+  * @retval shell_error SHELL_BUSY while the download runs
+  */
+static shell_error fwJob(shellJob_t* job) {
+	if (job->cancel) {
+		if (fw.check == SHELL_BUSY) {
+			shellCrc32Abort();
+		}
+		// A staging buffer must not change under the next download
+		while (fw.copying) {
+		}
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	SHELL_JOB_WAIT_UNTIL(job, fwReceive(job->ctx) || fw.failed ||
+			(HAL_GetTick() - fw.lastTick) >= SHELL_FW_IDLE_MS);
+	job->ownsInput = false;
+
+	// The queue runs in order, the last erase ends after the others
+	SHELL_JOB_WAIT_UNTIL(job, !fw.copying && !fw.erasing[SHELL_FW_SLOT_SECTORS - 1] && !fw.inFlight[0] && !fw.inFlight[1]);
+	fw.endTick = HAL_GetTick();
+	if (fw.failed || fw.received != fw.length ||
+			!shellCrc32Start(SHELL_CRC32_INIT, (const void*)SHELL_FW_SLOT_ADDR, fw.length)) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	// The CRC unit reads the slot back through the DMA
+	fw.check = SHELL_BUSY;
+	SHELL_JOB_WAIT_UNTIL(job, (fw.check = shellCrc32Poll(&fw.slotCrc)) != SHELL_BUSY);
+	if (fw.check != SHELL_OK || fw.slotCrc != fw.crc) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	// Magic goes first: a header cut short has no length the boot stub accepts
+	fw.header.magic = SHELL_FW_MAGIC;
+	fw.header.length = fw.length;
+	fw.header.crc = fw.crc;
+	fw.writingHeader = true;
+	if (!shellFlashQueueProgram(SHELL_FW_HEADER_ADDR, &fw.header, offsetof(shellFwHeader_t, applied),
+			fwFlashDone, &fw.writingHeader)) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+	SHELL_JOB_WAIT_UNTIL(job, !fw.writingHeader);
+	if (fw.failed) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	SHELL_RESULT_DEFINE(res, job->ctx, 64);
+	uint32_t ms = fw.endTick - fw.startTick;
+
+	shellResultUnsigned(&res, "bytes", fw.length);
+	shellResultUnsigned(&res, "ms", ms);
+	shellResultUnsigned(&res, "Bps", (ms == 0) ? 0 : (uint32_t)(((uint64_t)fw.length * 1000U) / ms));
+	shellResultHex(&res, "crc", fw.crc, 8);
+	shellResultEnd(&res);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Resets once the response of "fwupdate a1" is out, the boot stub applies the image
+  * @note	Called by checkShellStatus().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellFwUpdatePoll(void) {
+	if (resetArmed && (HAL_GetTick() - resetTick) >= SHELL_FW_RESET_DELAY_MS) {
+		NVIC_SystemReset();
+	}
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Downloads an image into the update slot (n, c), applies it (a), shows the slot
+  * @note	See CLI_SHELL_FWUPDATE.h for the download.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while an image is received
+  */
+shell_error FwupdateBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	const shellFwHeader_t* header = (const shellFwHeader_t*)SHELL_FW_HEADER_ADDR;
+
+	if (shellHasArg(parserInput, argTkn_a)) {
+		if (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u8 != 1 || !fwSlotPending()) {
+			return SHELL_ERR;
+		}
+		resetArmed = true;
+		resetTick = HAL_GetTick();
+		return SHELL_OK;
+	}
+
+	if (!shellHasArg(parserInput, argTkn_n)) {
+		SHELL_RESULT_DEFINE(res, ctx, 64);
+
+		if (header->magic != SHELL_FW_MAGIC) {
+			shellResultText(&res, "slot", "empty");
+		} else {
+			shellResultText(&res, "slot", (header->applied == 0xFFFFFFFFU) ? "pending" : "applied");
+			shellResultUnsigned(&res, "bytes", header->length);
+			shellResultHex(&res, "crc", header->crc, 8);
+		}
+		shellResultEnd(&res);
+		return SHELL_OK;
+	}
+
+	uint32_t length = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+
+	// The image is raw bytes, a text session would take 0x03 for Ctrl-C
+	if (!shellHasArg(parserInput, argTkn_c) || length == 0 || length > SHELL_FW_IMAGE_MAX ||
+			ctx->mode != SHELL_MODE_BINARY || shellJobRunning() || shellFlashBusy()) {
+		return SHELL_ERR;
+	}
+
+	memset(&fw, 0, sizeof(fw));
+	fw.length = length;
+	fw.crc = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u32;
+	fw.startTick = HAL_GetTick();
+	fw.lastTick = fw.startTick;
+
+	// The buffers queue behind the erases, the first one fills meanwhile
+	for (uint32_t i = 0; i < SHELL_FW_SLOT_SECTORS; i++) {
+		fw.erasing[i] = true;
+		if (!shellFlashQueueErase(SHELL_FW_SLOT_SECTOR + i, fwFlashDone, &fw.erasing[i])) {
+			return SHELL_ERR;
+		}
+	}
+
+	shellJob_t* job = shellJobStart(ctx, fwJob);
+	if (job == NULL) {
+		return SHELL_ERR;
+	}
+
+	// Bytes after the request frame belong to the image
+	job->ownsInput = true;
+
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
@@ -0,0 +1,102 @@
+/** @file CLI_SHELL_FWUPDATE.h
+ *
+ * @brief Firmware update of the CLI Shell: image download into the update slot and the boot stub
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Staging copies by the copy service
+ * - 1.2: 10-15-2026 (Crandell) Program in sector 5, the update leaves the modules alone
+ * - 1.3: 10-15-2026 (Crandell) Program in sectors 4-5 (192 KB), update slot in sectors 6-7
+ *
+ * Usage Notes:
+ *  - Flash layout (STM32F411RETX_FLASH.ld):
+ *      sector 0       boot stub (vector table with reset only, copy loop) in the first 4 KB, then the
+ *                     command modules (CLI_SHELL_MODULE.h), both flashed by the debugger only
+ *      sectors 1-2    settings (CLI_SHELL_KV.h)
+ *      sector 3       macros (CLI_SHELL_MACRO.h)
+ *      sectors 4-5    the program (192 KB), its vector table at 0x08010000 (VECT_TAB_OFFSET of
+ *                     system_stm32f4xx.c)
+ *      sectors 6-7    update slot (256 KB): the new image from its start, a shellFwHeader_t in the
+ *                     last 16 bytes
+ *    The program is linked to its sectors only, an image is built once and always runs there.
+ *  - The image is the program without the boot stub, from 0x08010000 on:
+ *      arm-none-eabi-objcopy -O binary -R .boot CLI_SHELL.elf CLI_SHELL_app.bin
+ *    Its CRC is the CRC32 of CLI_SHELL_CRC.h over the file.
+ *  - Download in a binary session ("mode m1", CLI_SHELL_BINARY.h), where 0x03 and line ends are
+ *    data: the request frame "fwupdate n<bytes> c<crc>", then the n bytes of the image raw, not
+ *    framed. The slot is erased (2 to 4 s) and the bytes go to two RAM buffers of
+ *    SHELL_FW_BUFFER_LEN in turn: one is programmed by the FLASH interrupt
+ *    (shellFlashQueueProgram()) while the other fills from the receive ring, copied out of it by
+ *    the DMA (CLI_SHELL_COPY.h) while the CPU serves USB. A full ring holds the
+ *    USB OUT endpoint back, the host is paced by the flash, not by the protocol. The CRC unit then
+ *    checks the slot (DMA) and the header is written. The response is the result map of
+ *    "bytes", "ms", "Bps" and "crc", SHELL_ERR for a wrong CRC, a flash error or
+ *    SHELL_FW_IDLE_MS without data.
+ *  - "fwupdate a1" checks the slot again and resets 100 ms after the response. The boot stub copies
+ *    a pending image into sectors 4 and 5, compares the copy and marks the header applied before it
+ *    starts the program. A reset or power loss during the copy starts it over, the slot is only
+ *    given up once the copy matches. Any later reset (debugger, power cycle) applies a pending
+ *    image the same way.
+ *  - "fwupdate" shows the slot: "slot" empty, pending or applied, with the "bytes" and "crc" of
+ *    its image.
+ *  - The image overwrites the running program, the previous one is not kept. The boot stub is
+ *    part of every build but only the one flashed by the debugger runs, so the program and slot
+ *    addresses, the header and SHELL_FW_MAGIC must not change between the versions of a fleet.
+ *    The slot is larger than the program sectors, any image that links (STM32F411RETX_FLASH.ld
+ *    asserts it fits FLASH) fits the slot with its header.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_FWUPDATE_H_
+#define CLI_SHELL_FWUPDATE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_FW_APP_SECTOR				4U				/*!< FLASH_SECTOR_4, first program sector	*/
+#define SHELL_FW_APP_SECTORS			2U				/*!< Sectors 4 and 5, the only ones an update erases	*/
+#define SHELL_FW_APP_ADDR				0x08010000U		/*!< Program and its vector table			*/
+#define SHELL_FW_APP_SIZE				(192U * 1024U)	/*!< FLASH of STM32F411RETX_FLASH.ld		*/
+#define SHELL_FW_SLOT_SECTOR			6U				/*!< FLASH_SECTOR_6, first slot sector		*/
+#define SHELL_FW_SLOT_SECTORS			2U				/*!< Sectors 6 and 7					*/
+#define SHELL_FW_SLOT_ADDR				0x08040000U
+#define SHELL_FW_SLOT_SIZE				(256U * 1024U)
+#define SHELL_FW_HEADER_ADDR			(SHELL_FW_SLOT_ADDR + SHELL_FW_SLOT_SIZE - sizeof(shellFwHeader_t))
+#define SHELL_FW_IMAGE_MAX				SHELL_FW_APP_SIZE
+
+#define SHELL_FW_MAGIC					0x46575550U		/*!< "FWUP", header of a checked image	*/
+#define SHELL_FW_BUFFER_LEN				1024		/*!< Per staging buffer, two of them		*/
+#define SHELL_FW_IDLE_MS				5000		/*!< Download timeout without data			*/
+#define SHELL_FW_RESET_DELAY_MS			100			/*!< From the "fwupdate a1" response to the reset	*/
+#define SHELL_FW_BOOT_TRIES				3			/*!< Copies the boot stub tries per reset	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Header of the update slot, in its last 16 bytes. Erased (all 0xFF) without an image.
+  */
+typedef struct {
+	uint32_t magic;							/*!< SHELL_FW_MAGIC, written once the image is checked	*/
+	uint32_t length;						/*!< Bytes of the image						*/
+	uint32_t crc;							/*!< CRC32 of the image (CLI_SHELL_CRC.h)	*/
+	uint32_t applied;						/*!< Cleared by the boot stub after the copy	*/
+} shellFwHeader_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellFwUpdatePoll(void);
+
+#endif // CLI_SHELL_FWUPDATE_H_
+
+/*** end of file ***/
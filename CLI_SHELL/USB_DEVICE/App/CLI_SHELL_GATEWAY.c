@@ -0,0 +1,373 @@
+/** @file CLI_SHELL_GATEWAY.c
+ *
+ * @brief Gateway of the CLI Shell: forwards addressed lines to downstream boards, relays their answers
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_GATEWAY.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define GATEWAY_MAX_TAG					999999999U	/*!< Largest tag of SHELL_TAG_DIGITS		*/
+#define GATEWAY_PREFIX_LEN				(SHELL_TAG_DIGITS + 2)	/*!< "#<tag> " in front of a node line	*/
+#define GATEWAY_RELAY_LEN				(SHELL_BUFFER_LEN + 2 * SHELL_TAG_DIGITS + 8)	/*!< "@<node> #<tag> " line	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A downstream board
+  */
+typedef struct {
+	shell_ctx_t* link;						/*!< Receive ring, transport and port of the link	*/
+	uint8_t node;
+	uint8_t line[SHELL_BUFFER_LEN];			/*!< Line of the node being assembled		*/
+	uint16_t lineLen;
+	bool overflow;							/*!< Line longer than the buffer, cut		*/
+} gatewayNode_t;
+
+/**
+  * @brief  A line in flight to a node
+  */
+typedef struct {
+	bool used;
+	uint8_t nodeIndex;
+	shell_ctx_t* origin;					/*!< Instance the line came from			*/
+	int32_t hostTag;						/*!< Tag of the line, SHELL_NO_TAG without	*/
+	uint32_t linkTag;						/*!< Tag of the gateway on the link			*/
+	uint32_t startTick;
+} gatewayPending_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static gatewayNode_t nodes[SHELL_GATEWAY_NODES];
+static uint8_t nodeCount = 0;
+static gatewayPending_t pending[SHELL_GATEWAY_PENDING];
+static uint32_t nextLinkTag = 0;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void gatewayRelay(shell_ctx_t* origin, uint8_t node, int32_t tag, const uint8_t* text, uint16_t len);
+static bool gatewaySend(shell_ctx_t* ctx, uint8_t nodeIndex, const uint8_t* line, uint32_t len);
+static gatewayPending_t* gatewayFindPending(uint8_t nodeIndex, int32_t linkTag);
+static void gatewayNodeLine(uint8_t nodeIndex);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sends a line of a node to the port it is meant for, "@<node> [#<tag> ]<text>"
+  * @param[IN]  origin Instance of the port
+  * @param[IN]  node Node number
+  * @param[IN]  tag Tag to put in front of the text, SHELL_NO_TAG for none
+  * @param[IN]  text Line without its terminator
+  * @param[IN]  len Number of characters
+  * @retval NONE
+  */
+static void gatewayRelay(shell_ctx_t* origin, uint8_t node, int32_t tag, const uint8_t* text, uint16_t len) {
+	SHELL_STR_DEFINE(str, GATEWAY_RELAY_LEN);
+
+	shellStrAppendChar(&str, SHELL_NODE_CHAR);
+	shellStrAppendUnsigned(&str, node, 0);
+	shellStrAppendChar(&str, ' ');
+	if (tag != SHELL_NO_TAG) {
+		shellStrAppendChar(&str, SHELL_TAG_CHAR);
+		shellStrAppendUnsigned(&str, (uint32_t)tag, 0);
+		shellStrAppendChar(&str, ' ');
+	}
+	shellStrAppendN(&str, (const char*)text, len);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(origin, &str);
+
+	// The origin may be another port than the one of this pass
+	transportFlush(origin);
+}
+
+/**
+  * @brief  Sends a line to a node with a tag of the gateway and keeps it in flight
+  * @note	Failures are answered to the origin with the node prefix.
+  * @param[IN]  ctx Instance the line came from (ctx->tag is its tag)
+  * @param[IN]  nodeIndex Index of the node
+  * @param[IN]  line Line without address and terminator
+  * @param[IN]  len Number of characters
+  * @retval bool Returns true if the line is on its way
+  */
+static bool gatewaySend(shell_ctx_t* ctx, uint8_t nodeIndex, const uint8_t* line, uint32_t len) {
+	static const char failed[] = "-->Function Error!";
+	gatewayNode_t* node = &nodes[nodeIndex];
+	gatewayPending_t* slot = NULL;
+	SHELL_STR_DEFINE(str, GATEWAY_PREFIX_LEN + SHELL_BUFFER_LEN + 1);
+
+	for (uint8_t i = 0; i < SHELL_GATEWAY_PENDING && slot == NULL; i++) {
+		if (!pending[i].used) {
+			slot = &pending[i];
+		}
+	}
+
+	nextLinkTag = (nextLinkTag >= GATEWAY_MAX_TAG) ? 1 : nextLinkTag + 1;
+	shellStrAppendChar(&str, SHELL_TAG_CHAR);
+	shellStrAppendUnsigned(&str, nextLinkTag, 0);
+	shellStrAppendChar(&str, ' ');
+	shellStrAppendN(&str, (const char*)line, (uint16_t)len);
+	shellStrAppendChar(&str, '\r');
+
+	// Whole lines only, a cut line would run as something else
+	if (slot == NULL || transportFree(node->link) < str.len) {
+		gatewayRelay(ctx, node->node, ctx->tag, (const uint8_t*)failed, sizeof(failed) - 1);
+		return false;
+	}
+	transportWrite(node->link, (const uint8_t*)str.buf, str.len);
+	transportFlush(node->link);
+
+	slot->used = true;
+	slot->nodeIndex = nodeIndex;
+	slot->origin = ctx;
+	slot->hostTag = ctx->tag;
+	slot->linkTag = nextLinkTag;
+	slot->startTick = HAL_GetTick();
+	return true;
+}
+
+/**
+  * @brief  The line in flight a line of a node belongs to
+  * @param[IN]  nodeIndex Index of the node
+  * @param[IN]  linkTag Tag of the line, SHELL_NO_TAG for the oldest line in flight
+  * @retval gatewayPending_t* The line in flight, NULL if there is none
+  */
+static gatewayPending_t* gatewayFindPending(uint8_t nodeIndex, int32_t linkTag) {
+	gatewayPending_t* found = NULL;
+
+	for (uint8_t i = 0; i < SHELL_GATEWAY_PENDING; i++) {
+		gatewayPending_t* entry = &pending[i];
+
+		if (!entry->used || entry->nodeIndex != nodeIndex) {
+			continue;
+		}
+		if (linkTag != SHELL_NO_TAG) {
+			if (entry->linkTag == (uint32_t)linkTag) {
+				return entry;
+			}
+		} else if (found == NULL || (int32_t)(entry->startTick - found->startTick) < 0 ||
+				(entry->startTick == found->startTick && (int32_t)(entry->linkTag - found->linkTag) < 0)) {
+			found = entry;
+		}
+	}
+	return found;
+}
+
+/**
+  * @brief  Relays a whole line received from a node
+  * @note	A tagged line is the response to a line in flight, which ends it. Anything else is
+  * 		output of the oldest line in flight, or dropped if there is none.
+  * @param[IN]  nodeIndex Index of the node
+  * @retval NONE
+  */
+static void gatewayNodeLine(uint8_t nodeIndex) {
+	gatewayNode_t* node = &nodes[nodeIndex];
+	uint8_t* text = node->line;
+	uint32_t len = node->lineLen;
+	int32_t linkTag = takeTag(&text, &len);
+	gatewayPending_t* entry = gatewayFindPending(nodeIndex, linkTag);
+
+	if (entry == NULL) {
+		return;
+	}
+	if (linkTag == SHELL_NO_TAG) {
+		gatewayRelay(entry->origin, node->node, SHELL_NO_TAG, text, (uint16_t)len);
+		return;
+	}
+	gatewayRelay(entry->origin, node->node, entry->hostTag, text, (uint16_t)len);
+	entry->used = false;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Registers a downstream board
+  * @note	Call from main() like shellInit(). The link instance is attached to the port of the
+  * 		transport for its received bytes only.
+  * @param[IN]  node Node number, not SHELL_GATEWAY_NODE_ID
+  * @param[IN]  link Instance for the link (SHELL_CTX_DEFINE), not started with shellInit()
+  * @param[IN]  transport Transport of the link
+  * @param[IN]  port Port of the transport
+  * @retval bool Returns false if the node is taken or SHELL_GATEWAY_NODES are registered
+  */
+bool shellGatewayAddNode(uint8_t node, shell_ctx_t* link, const shellTransport_t* transport, uint8_t port) {
+	if (nodeCount >= SHELL_GATEWAY_NODES || node == SHELL_GATEWAY_NODE_ID || link == NULL || transport == NULL) {
+		return false;
+	}
+	for (uint8_t i = 0; i < nodeCount; i++) {
+		if (nodes[i].node == node || nodes[i].link == link) {
+			return false;
+		}
+	}
+
+	// The responses go to the ring as they are: a binary instance is not scanned for Ctrl-C or urgent lines
+	link->transport = transport;
+	link->port = port;
+	link->mode = SHELL_MODE_BINARY;
+	link->tag = SHELL_NO_TAG;
+	transportAttach(link);
+
+	memset(&nodes[nodeCount], 0, sizeof(nodes[0]));
+	nodes[nodeCount].link = link;
+	nodes[nodeCount].node = node;
+	nodeCount++;
+	return true;
+}
+
+/**
+  * @brief  Takes a node address ("@<node> " or "@* ") off the front of a trimmed line
+  * @note	Anything else starting with SHELL_NODE_CHAR stays on the line and fails as a command.
+  * @param[IN,OUT]  line Line, moved past the address and the spaces after it
+  * @param[IN,OUT]  len Length of the line, shortened accordingly
+  * @retval int16_t Node number, SHELL_GATEWAY_ALL, or SHELL_GATEWAY_LOCAL for this board
+  */
+int16_t shellGatewayTakeNode(uint8_t** line, uint32_t* len) {
+	const uint8_t* text = *line;
+	int16_t node = 0;
+	uint32_t i = 1;
+
+	if (*len < 2 || text[0] != SHELL_NODE_CHAR) {
+		return SHELL_GATEWAY_LOCAL;
+	}
+	if (text[1] == SHELL_NODE_ALL_CHAR) {
+		node = SHELL_GATEWAY_ALL;
+		i = 2;
+	} else {
+		while (i < *len && i <= 3 && text[i] >= '0' && text[i] <= '9') {
+			node = (node * 10) + (text[i] - '0');
+			i++;
+		}
+		if (i == 1 || node > UINT8_MAX) {
+			return SHELL_GATEWAY_LOCAL;
+		}
+	}
+	if (i < *len && text[i] != ' ') {
+		return SHELL_GATEWAY_LOCAL;
+	}
+
+	while (i < *len && text[i] == ' ') {
+		i++;
+	}
+	*line += i;
+	*len -= i;
+	return (node == SHELL_GATEWAY_NODE_ID) ? SHELL_GATEWAY_LOCAL : node;
+}
+
+/**
+  * @brief  Sends an addressed line to its node, or to every node
+  * @note	Called by shellRunLine(). The answers come later through shellGatewayPoll(), a line on
+  * 		its way has no response of its own.
+  * @param[IN]  ctx Instance the line came from
+  * @param[IN]  node Node number or SHELL_GATEWAY_ALL (shellGatewayTakeNode())
+  * @param[IN]  line Line without address and terminator
+  * @param[IN]  len Number of characters
+  * @retval shell_error SHELL_ERR if the line went nowhere
+  */
+shell_error shellGatewayForward(shell_ctx_t* ctx, int16_t node, uint8_t* line, uint32_t len) {
+	bool sent = false;
+	bool known = false;
+
+	if (len == 0) {
+		shellSendResponse(ctx, RESPONSE_CMD_ERR);
+		return SHELL_ERR;
+	}
+	if (len + GATEWAY_PREFIX_LEN > SHELL_BUFFER_LEN) {
+		shellSendResponse(ctx, RESPONSE_LEN_ERR);
+		return SHELL_ERR;
+	}
+
+	for (uint8_t i = 0; i < nodeCount; i++) {
+		if (node == SHELL_GATEWAY_ALL || nodes[i].node == node) {
+			known = true;
+			sent |= gatewaySend(ctx, i, line, len);
+		}
+	}
+
+	if (!known) {
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+	}
+	return sent ? SHELL_OK : SHELL_ERR;
+}
+
+/**
+  * @brief  Relays what the nodes have sent and answers the lines that timed out
+  * @note	Called by checkShellStatus() of every instance, the answers go to the port of their line.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellGatewayPoll(void) {
+	static const char timedOut[] = "-->Timeout!";
+	uint32_t now = HAL_GetTick();
+
+	for (uint8_t n = 0; n < nodeCount; n++) {
+		gatewayNode_t* node = &nodes[n];
+		uint8_t byte;
+
+		while (shellRingGet(&node->link->rxRing, &byte)) {
+			if (byte == '\r' || byte == '\n') {
+				if (node->lineLen != 0) {
+					gatewayNodeLine(n);
+				}
+				node->lineLen = 0;
+				node->overflow = false;
+			} else if (node->lineLen < sizeof(node->line)) {
+				node->line[node->lineLen++] = byte;
+			} else {
+				node->overflow = true;
+			}
+		}
+		transportRxResume(node->link);
+	}
+
+	for (uint8_t i = 0; i < SHELL_GATEWAY_PENDING; i++) {
+		gatewayPending_t* entry = &pending[i];
+
+		if (entry->used && (now - entry->startTick) >= SHELL_GATEWAY_TIMEOUT_MS) {
+			gatewayRelay(entry->origin, nodes[entry->nodeIndex].node, entry->hostTag,
+					(const uint8_t*)timedOut, sizeof(timedOut) - 1);
+			entry->used = false;
+		}
+	}
+}
+
+/**
+  * @brief  Passes Ctrl-C on to the nodes with lines in flight from an instance
+  * @note	Called by checkShellStatus() when an abort of the instance is seen. The lines stay in
+  * 		flight, the nodes answer them (e.g. "-->Cancelled!").
+  * @param[IN]  ctx Instance that was aborted
+  * @retval NONE
+  */
+void shellGatewayAbort(shell_ctx_t* ctx) {
+	static const uint8_t abortChar = SHELL_ABORT_CHAR;
+
+	for (uint8_t n = 0; n < nodeCount; n++) {
+		for (uint8_t i = 0; i < SHELL_GATEWAY_PENDING; i++) {
+			if (pending[i].used && pending[i].nodeIndex == n && pending[i].origin == ctx) {
+				transportWrite(nodes[n].link, &abortChar, 1);
+				transportFlush(nodes[n].link);
+				break;
+			}
+		}
+	}
+}
+
+/*** end of file ***/
@@ -0,0 +1,81 @@
+/** @file CLI_SHELL_GATEWAY.h
+ *
+ * @brief Gateway of the CLI Shell: command lines addressed to downstream boards ("@<node> <line>")
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Each downstream board runs the CLI Shell in a text session on a link of this board (the
+ *    USART today, any shellTransport_t). main() registers it with a node number:
+ *      SHELL_CTX_DEFINE(node1Link, SHELL_RX_RING_LEN);
+ *      shellGatewayAddNode(1, &node1Link, &shellUartTransport, 0);
+ *    The link instance only holds the received bytes. It is not started with shellInit(), and
+ *    checkShellStatus() does nothing on it.
+ *  - "@3 setLed l1 s1" sends the line to node 3 and has no response of its own. The output
+ *    lines and the response of node 3 come back on the port of the line, each prefixed with the node:
+ *      @3 <output line>
+ *      @3 -->OK!
+ *    A tag stays with the line: "#42 @3 setLed l1 s1" is answered "@3 #42 -->OK!". Lines to
+ *    several nodes run at the same time, the host matches the answers by node and tag.
+ *  - "@* <line>" goes to every node, each answers with its own prefix. "@<SHELL_GATEWAY_NODE_ID>"
+ *    runs the line here, like a line without an address. An unknown node is answered
+ *    "-->Function Error!", a full link or SHELL_GATEWAY_PENDING lines in flight "@<n> -->Function Error!".
+ *  - On the link every line carries a tag of the gateway ("#<n> <line>"), the response line of
+ *    the node is matched by it. Output lines have no tag, they belong to the oldest line in
+ *    flight to the node (a board runs its lines in order). A node that has not answered after
+ *    SHELL_GATEWAY_TIMEOUT_MS is answered "@<n> -->Timeout!".
+ *  - Ctrl-C on a port is passed on to every node with a line in flight from that port.
+ *  - A node line must fit the line buffer of the node with the gateway tag in front,
+ *    SHELL_BUFFER_LEN on both sides. Longer lines are answered "Line Too Long!" here.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_GATEWAY_H_
+#define CLI_SHELL_GATEWAY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_NODE_CHAR					'@'			/*!< Starts the node address of a line		*/
+#define SHELL_NODE_ALL_CHAR				'*'			/*!< "@*" addresses every node				*/
+
+#ifndef SHELL_GATEWAY_NODE_ID
+#define SHELL_GATEWAY_NODE_ID			0			/*!< Node number of this board				*/
+#endif
+#define SHELL_GATEWAY_NODES				4			/*!< Downstream boards						*/
+#define SHELL_GATEWAY_PENDING			8			/*!< Lines in flight on all links			*/
+#define SHELL_GATEWAY_TIMEOUT_MS		10000		/*!< Longest wait for a response (jobs too)	*/
+
+#define SHELL_GATEWAY_LOCAL				(-1)		/*!< Line for this board					*/
+#define SHELL_GATEWAY_ALL				(-2)		/*!< Line for every node					*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef struct shellTransportTypeDef shellTransport_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellGatewayAddNode(uint8_t node, shell_ctx_t* link, const shellTransport_t* transport, uint8_t port);
+
+int16_t shellGatewayTakeNode(uint8_t** line, uint32_t* len);
+shell_error shellGatewayForward(shell_ctx_t* ctx, int16_t node, uint8_t* line, uint32_t len);
+void shellGatewayPoll(void);
+void shellGatewayAbort(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_GATEWAY_H_
+
+/*** end of file ***/
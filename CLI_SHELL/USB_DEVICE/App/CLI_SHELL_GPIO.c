@@ -0,0 +1,211 @@
+/** @file CLI_SHELL_GPIO.c
+ *
+ * @brief Port-wide GPIO access of the CLI Shell: BSRR mask writes, snapshots and batches, "gpio"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stm32f4xx.h"
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_GPIO.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define GPIO_PORT_INDEX(base)			(((base) - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE))
+#define GPIO_LINE_ENTRY(base, pin)		{ GPIO_PORT_INDEX(base), (pin) },
+#define GPIO_LINE_COUNT(base, pin)		+ 1
+
+#define GPIO_LINES						(0 SHELL_GPIO_LINES(GPIO_LINE_COUNT))
+
+_Static_assert(GPIO_LINES <= 32, "SHELL_GPIO_LINES has more lines than a mask can select");
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A logical line, resolved at build time
+  */
+typedef struct {
+	uint8_t port;							/*!< Index into gpioPorts					*/
+	uint16_t pin;							/*!< Pin mask, the BSRR set bit				*/
+} shellGpioLine_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static GPIO_TypeDef* const gpioPorts[SHELL_GPIO_PORTS] = { GPIOA, GPIOB, GPIOC };
+static const char* const gpioPortNames[SHELL_GPIO_PORTS] = { "A", "B", "C" };
+
+static const shellGpioLine_t gpioLines[] = {
+	SHELL_GPIO_LINES(GPIO_LINE_ENTRY)
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool argMask(shellParserOutput_t* parserInput, argToken_t token, uint32_t* value);
+static bool linesToPorts(uint32_t lines, uint32_t* masks);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Reads an optional mask argument
+  * @param[IN]  parserInput Parser output
+  * @param[IN]  token Argument token
+  * @param[OUT]  value Mask, 0 if absent
+  * @retval bool Returns true if the argument is present
+  */
+static bool argMask(shellParserOutput_t* parserInput, argToken_t token, uint32_t* value) {
+	*value = 0;
+	if (!shellHasArg(parserInput, token)) {
+		return false;
+	}
+	*value = shellArgValue(parserInput, shellFindArg(parserInput, token)).u32;
+	return true;
+}
+
+/**
+  * @brief  Adds the pins of logical lines to per-port masks
+  * @param[IN]  lines Bit n selects line n of SHELL_GPIO_LINES
+  * @param[IN,OUT]  masks Pin mask per port
+  * @retval bool Returns false for a line that does not exist
+  */
+static bool linesToPorts(uint32_t lines, uint32_t* masks) {
+	if (GPIO_LINES < 32 && (lines >> GPIO_LINES) != 0) {
+		return false;
+	}
+	for (uint8_t line = 0; line < GPIO_LINES; line++) {
+		if ((lines & (1UL << line)) != 0) {
+			masks[gpioLines[line].port] |= gpioLines[line].pin;
+		}
+	}
+	return true;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Writes port masks, logical lines and BSRR batches, or answers a port snapshot
+  * @note	See CLI_SHELL_GPIO.h. Everything is checked before the first write.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_ERR for a bad port, line or batch, or a toggle overlapping s or c
+  */
+shell_error GpioBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint32_t setMask[SHELL_GPIO_PORTS] = { 0 };
+	uint32_t resetMask[SHELL_GPIO_PORTS] = { 0 };
+	uint32_t toggleMask[SHELL_GPIO_PORTS] = { 0 };
+	uint32_t batch[SHELL_ARRAY_MAX];
+	uint8_t batchCount = 0;
+	bool write = false;
+	uint8_t port = 0;
+	bool hasPort = shellHasArg(parserInput, argTkn_p);
+
+	if (hasPort) {
+		port = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).u8;
+		if (port >= SHELL_GPIO_PORTS) {
+			return SHELL_ERR;
+		}
+	}
+
+	// s/c/t: pins of port p, or logical lines collected per port
+	uint32_t set, reset, toggle;
+	bool hasSet = argMask(parserInput, argTkn_s, &set);
+	bool hasReset = argMask(parserInput, argTkn_c, &reset);
+	bool hasToggle = argMask(parserInput, argTkn_t, &toggle);
+
+	if (hasSet || hasReset || hasToggle) {
+		if ((toggle & (set | reset)) != 0) {
+			return SHELL_ERR;
+		}
+		if (hasPort) {
+			if (((set | reset | toggle) >> 16) != 0) {
+				return SHELL_ERR;
+			}
+			setMask[port] = set;
+			resetMask[port] = reset;
+			toggleMask[port] = toggle;
+		} else if (!linesToPorts(set, setMask) || !linesToPorts(reset, resetMask) || !linesToPorts(toggle, toggleMask)) {
+			return SHELL_ERR;
+		}
+		write = true;
+	}
+
+	// b: raw BSRR words in list order
+	if (shellHasArg(parserInput, argTkn_b)) {
+		batchCount = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_b), batch, SHELL_ARRAY_MAX);
+		if (batchCount == 0 || (batchCount & 1U) != 0) {
+			return SHELL_ERR;
+		}
+		for (uint8_t i = 0; i < batchCount; i += 2) {
+			if (batch[i] >= SHELL_GPIO_PORTS) {
+				return SHELL_ERR;
+			}
+		}
+		write = true;
+	}
+
+	if (write) {
+		uint32_t primask = __get_PRIMASK();
+		__disable_irq();
+
+		for (uint8_t i = 0; i < batchCount; i += 2) {
+			gpioPorts[batch[i]]->BSRR = batch[i + 1];
+		}
+		for (uint8_t i = 0; i < SHELL_GPIO_PORTS; i++) {
+			if (toggleMask[i] != 0) {
+				uint32_t odr = gpioPorts[i]->ODR;
+
+				setMask[i] |= toggleMask[i] & ~odr;
+				resetMask[i] |= toggleMask[i] & odr;
+			}
+			if ((setMask[i] | resetMask[i]) != 0) {
+				gpioPorts[i]->BSRR = (resetMask[i] << 16) | setMask[i];
+			}
+		}
+
+		__set_PRIMASK(primask);
+		return SHELL_OK;
+	}
+
+	// Snapshot, the registers read back to back
+	uint16_t idr[SHELL_GPIO_PORTS];
+	uint16_t odr[SHELL_GPIO_PORTS];
+	uint8_t first = hasPort ? port : 0;
+	uint8_t last = hasPort ? port : (SHELL_GPIO_PORTS - 1);
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	for (uint8_t i = first; i <= last; i++) {
+		idr[i] = (uint16_t)gpioPorts[i]->IDR;
+		odr[i] = (uint16_t)gpioPorts[i]->ODR;
+	}
+	__set_PRIMASK(primask);
+
+	SHELL_RESULT_DEFINE(res, ctx, 64);
+	for (uint8_t i = first; i <= last; i++) {
+		shellResultGroup(&res, gpioPortNames[i]);
+		shellResultHex(&res, "idr", idr[i], 4);
+		shellResultHex(&res, "odr", odr[i], 4);
+		shellResultClose(&res);
+	}
+	shellResultEnd(&res);
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
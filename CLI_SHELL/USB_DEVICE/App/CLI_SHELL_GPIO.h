@@ -0,0 +1,62 @@
+/** @file CLI_SHELL_GPIO.h
+ *
+ * @brief Port-wide GPIO access of the CLI Shell: BSRR mask writes, snapshots and batches, "gpio"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Ports are numbered 0 GPIOA, 1 GPIOB, 2 GPIOC (as "stream"). Every write is one BSRR store,
+ *    all pins of the port change in the same cycle and no other pin of the port is touched, so
+ *    there is no read-modify-write to race with interrupts or the "pattern" DMA.
+ *  - "gpio p<port> s<mask> c<mask> t<mask>": sets the pins of s, clears the pins of c and toggles
+ *    the pins of t in one write (pin masks up to 0xFFFF, all optional). t must not overlap s or c.
+ *  - Without p the masks select logical lines of SHELL_GPIO_LINES instead, bit n is line n:
+ *    "gpio s3" sets LED1 and LED2. The table holds the port and pin of every line, the lines
+ *    are collected per port and each port gets one write: 16 lines of a port are one command
+ *    and one store instead of 16 "setLed" round trips.
+ *  - "gpio b<port>,<bsrr>,<port>,<bsrr>..." writes raw BSRR words (high half clears, low half
+ *    sets) to several ports in list order, back to back with interrupts masked: a multi-port
+ *    change or a short pulse in one command. Up to SHELL_ARRAY_MAX / 2 writes.
+ *  - One command may combine them: the b list goes first, then one write per port of what s/c/t
+ *    asked for.
+ *  - "gpio" answers a snapshot of all ports, "gpio p<port>" of that port: input (idr) and output
+ *    (odr) registers, read back to back with interrupts masked. Result fields (CLI_SHELL_RESULT.h).
+ *    A command that writes answers OK only.
+ *  - Only pins in output mode follow the output register. Pins of peripherals (USB PA11/PA12, SWD
+ *    PA13/PA14, USART1 PB6/PB7, SPI3, I2C1) ignore it, but keep them out of the masks anyway.
+ *  - SHELL_GPIO_LINES may be defined by the project with its own lines, LINE(port base, pin mask)
+ *    per line, ports A to C, up to 32 lines.
+ *  - MAX_ARGUMENTS (5) is why lines and pins share s/c/t.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_GPIO_H_
+#define CLI_SHELL_GPIO_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_GPIO_PORTS				3			/*!< GPIOA to GPIOC						*/
+
+/**
+  * @brief  Logical lines of "gpio" without a port, LINE(port base, pin mask). Line 0 first.
+  */
+#ifndef SHELL_GPIO_LINES
+#define SHELL_GPIO_LINES(LINE) \
+		LINE(GPIOB_BASE,	GPIO_PIN_0)		/* LED1 */ \
+		LINE(GPIOB_BASE,	GPIO_PIN_1)		/* LED2 */
+#endif
+
+#endif // CLI_SHELL_GPIO_H_
+
+/*** end of file ***/
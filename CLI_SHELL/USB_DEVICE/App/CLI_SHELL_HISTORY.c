@@ -0,0 +1,379 @@
+/** @file CLI_SHELL_HISTORY.c
+ *
+ * @brief Command history of the CLI Shell: lines kept with their resolved form, "!!", "!n" and arrow recall
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Escape sequences moved to the line editor (CLI_SHELL_EDIT), shellHistoryRecall()
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_HISTORY.h"
+#include "CLI_SHELL_VAR.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define HISTORY_LINE_ONLY				0xFFFF		/*!< commandIndex of an entry without resolved form	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  One converted argument of a resolved entry
+  */
+typedef struct {
+	uint8_t token;							/*!< argToken_t								*/
+	uint8_t type;							/*!< argType_t of value						*/
+	uint8_t offset;							/*!< Contents within the line				*/
+	uint8_t len;
+	argValue_t value;
+} shellHistoryArg_t;
+
+/**
+  * @brief  One history entry
+  */
+typedef struct {
+	shell_ctx_t* ctx;						/*!< Instance, NULL for a free entry		*/
+	uint16_t number;						/*!< Number of "!n", counts from 1			*/
+	uint16_t commandIndex;					/*!< HISTORY_LINE_ONLY without resolved form	*/
+	uint8_t cmdOffset;
+	uint8_t cmdLen;
+	uint8_t numArgs;
+	uint8_t lineLen;
+	shellHistoryArg_t args[MAX_ARGUMENTS];
+	uint8_t line[SHELL_HISTORY_LINE_LEN];	/*!< The line as received					*/
+} shellHistoryEntry_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellHistoryEntry_t entries[SHELL_HISTORY_DEPTH];
+static uint8_t head;						/*!< Next entry to write					*/
+static uint16_t nextNumber = 1;
+
+static shellHistoryEntry_t pending;			/*!< Line being run, committed by shellHistoryEnd()	*/
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void commitEntry(const shellHistoryEntry_t* entry);
+static const shellHistoryEntry_t* findRecent(shell_ctx_t* ctx, uint8_t back);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stores an entry as the newest, over the oldest
+  * @param[IN]  entry Entry, its number is assigned here
+  * @retval NONE
+  */
+static void commitEntry(const shellHistoryEntry_t* entry) {
+	shellHistoryEntry_t* slot = &entries[head];
+
+	memmove(slot, entry, sizeof(*slot));
+	slot->number = nextNumber;
+	nextNumber = (nextNumber == UINT16_MAX) ? 1 : (nextNumber + 1);
+	head = (head + 1) % SHELL_HISTORY_DEPTH;
+}
+
+/**
+  * @brief  Finds an entry of an instance by age
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  back 1 for the newest entry of ctx, 2 for the one before, ...
+  * @retval const shellHistoryEntry_t* Entry, NULL if ctx has fewer entries
+  */
+static const shellHistoryEntry_t* findRecent(shell_ctx_t* ctx, uint8_t back) {
+	for (uint8_t i = 1; i <= SHELL_HISTORY_DEPTH; i++) {
+		const shellHistoryEntry_t* entry = &entries[(head + SHELL_HISTORY_DEPTH - i) % SHELL_HISTORY_DEPTH];
+
+		if (entry->ctx == ctx && --back == 0) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts the entry of a text line about to run, called by shellProcessLine()
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line The line as received
+  * @param[IN]  len Number of characters
+  * @retval NONE
+  */
+void shellHistoryBegin(shell_ctx_t* ctx, const uint8_t* line, uint32_t len) {
+	ctx->history.recall = 0;
+
+	if (ctx->outputMuted || len > SHELL_HISTORY_LINE_LEN) {
+		return;
+	}
+
+	pending.ctx = ctx;
+	pending.commandIndex = HISTORY_LINE_ONLY;
+	pending.lineLen = (uint8_t)len;
+	memcpy(pending.line, line, len);
+}
+
+/**
+  * @brief  Keeps the resolved form of the line being recorded
+  * @note	Called by shellDispatch() once the arguments are validated. Only the single command
+  * 		of an untagged text line is kept, its slices are kept as offsets into ctx->rxBuffer
+  * 		where the recorded line was received.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserOutput Validated parser output
+  * @param[IN]	commandIndex Index of the command
+  * @retval NONE
+  */
+void shellHistoryCapture(shell_ctx_t* ctx, const shellParserOutput_t* parserOutput, uint16_t commandIndex) {
+	if (pending.ctx != ctx || ctx->outputMuted || ctx->batchActive || ctx->tag != SHELL_NO_TAG ||
+			parserOutput->periodic || parserOutput->rawValues) {
+		return;
+	}
+
+	// Past the leading spaces of the line buffer
+	uint32_t delta = (uint32_t)(parserOutput->line - ctx->rxBuffer);
+
+	if (parserOutput->line < ctx->rxBuffer || delta >= pending.lineLen) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < parserOutput->numArgs; i++) {
+		const shellArgument_t* arg = &parserOutput->cmdArgs[i];
+
+		// Expressions are evaluated on every run
+		if (arg->argLen > 0 && shellArgContents(parserOutput, i)[0] == SHELL_VAR_CHAR) {
+			return;
+		}
+		if (delta + arg->argOffset + arg->argLen > pending.lineLen) {
+			return;
+		}
+	}
+
+	pending.commandIndex = commandIndex;
+	pending.cmdOffset = (uint8_t)(delta + parserOutput->cmdOffset);
+	pending.cmdLen = parserOutput->cmdLen;
+	pending.numArgs = parserOutput->numArgs;
+	for (uint8_t i = 0; i < parserOutput->numArgs; i++) {
+		const shellArgument_t* arg = &parserOutput->cmdArgs[i];
+
+		pending.args[i].token = (uint8_t)arg->argToken;
+		pending.args[i].type = (uint8_t)arg->argType;
+		pending.args[i].offset = (uint8_t)(delta + arg->argOffset);
+		pending.args[i].len = arg->argLen;
+		pending.args[i].value = arg->argValue;
+	}
+}
+
+/**
+  * @brief  Commits the entry of the line that just ran, called by shellProcessLine()
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellHistoryEnd(shell_ctx_t* ctx) {
+	if (pending.ctx != ctx) {
+		return;
+	}
+	commitEntry(&pending);
+	pending.ctx = NULL;
+}
+
+/**
+  * @brief  Tells a replay line ("!!", "!<n>") from others
+  * @param[IN]  line Line
+  * @param[IN]  len Number of characters
+  * @retval bool Returns true for a replay line
+  */
+bool shellHistoryIsReplay(const uint8_t* line, uint32_t len) {
+	while (len > 0 && line[len - 1] == ' ') {
+		len--;
+	}
+	while (len > 0 && *line == ' ') {
+		line++;
+		len--;
+	}
+	if (len < 2 || line[0] != SHELL_HISTORY_CHAR) {
+		return false;
+	}
+	if (line[1] == SHELL_HISTORY_CHAR) {
+		return len == 2;
+	}
+	for (uint32_t i = 1; i < len; i++) {
+		if (line[i] < '0' || line[i] > '9') {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+  * @brief  Runs a history entry again
+  * @note	A resolved entry is rebuilt into a validated parser output over its line, the
+  * 		delimiters NUL-terminated as the tokenizer left them, and goes to shellDispatch().
+  * 		Sends the response itself.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Replay line (shellHistoryIsReplay())
+  * @param[IN]  len Number of characters
+  * @retval shell_error Error Return Value
+  */
+shell_error shellHistoryReplay(shell_ctx_t* ctx, const uint8_t* line, uint32_t len) {
+	const shellHistoryEntry_t* found = NULL;
+	shellHistoryEntry_t entry;
+
+	while (*line == ' ') {
+		line++;
+		len--;
+	}
+
+	if (line[1] == SHELL_HISTORY_CHAR) {
+		found = findRecent(ctx, 1);
+	} else {
+		uint32_t number = 0;
+
+		for (uint32_t i = 1; i < len && line[i] >= '0' && line[i] <= '9'; i++) {
+			number = (number * 10U) + (line[i] - '0');
+		}
+		for (uint8_t i = 0; i < SHELL_HISTORY_DEPTH; i++) {
+			if (entries[i].ctx == ctx && entries[i].number == number) {
+				found = &entries[i];
+			}
+		}
+	}
+
+	ctx->history.recall = 0;
+	if (found == NULL) {
+		shellSendResponse(ctx, RESPONSE_CMD_ERR);
+		return SHELL_ERR;
+	}
+
+	// The entry moves up to the newest, work on a copy
+	entry = *found;
+	memcpy(ctx->rxBuffer, entry.line, entry.lineLen);
+	ctx->rxLen = entry.lineLen;
+
+	if (entry.commandIndex == HISTORY_LINE_ONLY) {
+		shellHistoryBegin(ctx, ctx->rxBuffer, ctx->rxLen);
+		shell_error status = shellRunLine(ctx, ctx->rxBuffer, ctx->rxLen);
+		shellHistoryEnd(ctx);
+		return status;
+	}
+	commitEntry(&entry);
+
+	shellParserOutput_t parserOutput;
+
+	memset(&parserOutput, 0, sizeof(parserOutput));
+	memset(parserOutput.argSlot, SHELL_ARG_NONE, sizeof(parserOutput.argSlot));
+	parserOutput.line = ctx->rxBuffer;
+	parserOutput.cmdOffset = entry.cmdOffset;
+	parserOutput.cmdLen = entry.cmdLen;
+	parserOutput.validated = true;
+	ctx->rxBuffer[entry.cmdOffset + entry.cmdLen] = '\0';
+
+	for (uint8_t i = 0; i < entry.numArgs; i++) {
+		shellArgument_t* arg = &parserOutput.cmdArgs[i];
+
+		arg->argToken = (argToken_t)entry.args[i].token;
+		arg->argType = (argType_t)entry.args[i].type;
+		arg->argOffset = entry.args[i].offset;
+		arg->argLen = entry.args[i].len;
+		arg->argValue = entry.args[i].value;
+		ctx->rxBuffer[arg->argOffset + arg->argLen] = '\0';
+		if (arg->argType == arg_string) {
+			arg->argValue.str = (const char*)&ctx->rxBuffer[arg->argOffset];
+		}
+		shellIndexArg(&parserOutput, i);
+		parserOutput.numArgs++;
+	}
+
+	ctx->tag = SHELL_NO_TAG;
+	return shellDispatch(ctx, &parserOutput, entry.commandIndex);
+}
+
+/**
+  * @brief  Puts an older or newer entry of the instance into the line buffer
+  * @note	Called by the line editor for the up and down arrow (CLI_SHELL_EDIT.c), which draws
+  * 		the line. Newer than the newest entry is an empty line.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  older true for the entry before the one shown, false for the one after
+  * @retval bool Returns true if the line buffer changed
+  */
+bool shellHistoryRecall(shell_ctx_t* ctx, bool older) {
+	uint8_t back = ctx->history.recall;
+	const shellHistoryEntry_t* entry = NULL;
+
+	if (older) {
+		if (back >= SHELL_HISTORY_DEPTH || (entry = findRecent(ctx, back + 1)) == NULL) {
+			// Nothing older
+			return false;
+		}
+		back++;
+	} else {
+		if (back == 0) {
+			return false;
+		}
+		back--;
+		entry = (back == 0) ? NULL : findRecent(ctx, back);
+	}
+
+	ctx->history.recall = back;
+	ctx->overflow = false;
+	ctx->rxLen = 0;
+	if (entry != NULL) {
+		memcpy(ctx->rxBuffer, entry->line, entry->lineLen);
+		ctx->rxLen = entry->lineLen;
+	}
+	return true;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Lists or clears the history of the instance
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (c - 1 clears, optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error HistoryBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, SHELL_HISTORY_LINE_LEN + 16);
+
+	if (shellHasArg(parserInput, argTkn_c)) {
+		if (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 != 1) {
+			return SHELL_ERR;
+		}
+		for (uint8_t i = 0; i < SHELL_HISTORY_DEPTH; i++) {
+			if (entries[i].ctx == ctx) {
+				entries[i].ctx = NULL;
+			}
+		}
+		return SHELL_OK;
+	}
+
+	for (uint8_t back = SHELL_HISTORY_DEPTH; back > 0; back--) {
+		const shellHistoryEntry_t* entry = findRecent(ctx, back);
+
+		if (entry == NULL) {
+			continue;
+		}
+		shellStrAppendUnsigned(&str, entry->number, 0);
+		shellStrAppend(&str, (entry->commandIndex != HISTORY_LINE_ONLY) ? "\t* " : "\t  ");
+		shellStrAppendN(&str, (const char*)entry->line, entry->lineLen);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,73 @@
+/** @file CLI_SHELL_HISTORY.h
+ *
+ * @brief Command history of the CLI Shell: lines kept with their resolved form, "!!", "!n" and arrow recall
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Escape sequences moved to the line editor (CLI_SHELL_EDIT), shellHistoryRecall()
+ *
+ * Usage Notes:
+ *  - Every text line an instance runs goes into a RAM ring of SHELL_HISTORY_DEPTH entries shared
+ *    by the instances, each entry belongs to its instance. Lines longer than
+ *    SHELL_HISTORY_LINE_LEN are not kept. Muted runs ("bench", "regress") are not recorded.
+ *  - A single command that passed validation is also kept resolved: its command index and the
+ *    converted argument values. Batches, gateway, "every" and tagged lines, lines that failed
+ *    and arguments with '$' expressions (evaluated anew on every run) only keep the line.
+ *  - "!!" runs the last line of the instance again, "!<n>" the line numbered n ("history" lists
+ *    the numbers). A resolved entry goes straight to shellDispatch(): no tokenizing, matching or
+ *    validation, "perf" shows 0 cycles for those stages. Other entries run as the line. The
+ *    response is that of the command, nothing is echoed. A number that is not in the history
+ *    is a Command Error. The replayed line becomes the newest entry.
+ *  - Up and down arrow (ESC [ A, ESC [ B) in a text session recall the lines of the instance
+ *    into the line buffer through shellHistoryRecall(). The line editor (CLI_SHELL_EDIT.h)
+ *    takes the keys and shows the line again after erasing the terminal line ("\r" ESC [K).
+ *  - "history" lists the entries of the instance, oldest first, "history c1" clears them.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_HISTORY_H_
+#define CLI_SHELL_HISTORY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_HISTORY_DEPTH				8			/*!< Entries of all instances			*/
+#define SHELL_HISTORY_LINE_LEN			80			/*!< Longest line kept					*/
+#define SHELL_HISTORY_CHAR				'!'			/*!< Starts a replay line				*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef struct shellParserOutputTypeDef shellParserOutput_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/**
+  * @brief  History state of one shell instance (shell_ctx_t.history)
+  */
+typedef struct {
+	uint8_t recall;							/*!< Entries back shown by the arrows, 0 none	*/
+} shellHistory_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellHistoryBegin(shell_ctx_t* ctx, const uint8_t* line, uint32_t len);
+void shellHistoryCapture(shell_ctx_t* ctx, const shellParserOutput_t* parserOutput, uint16_t commandIndex);
+void shellHistoryEnd(shell_ctx_t* ctx);
+bool shellHistoryIsReplay(const uint8_t* line, uint32_t len);
+shell_error shellHistoryReplay(shell_ctx_t* ctx, const uint8_t* line, uint32_t len);
+bool shellHistoryRecall(shell_ctx_t* ctx, bool older);
+
+#endif // CLI_SHELL_HISTORY_H_
+
+/*** end of file ***/
@@ -0,0 +1,368 @@
+/** @file CLI_SHELL_HOST.c
+ *
+ * @brief Host build of the CLI Shell core: transport, time base and stubs of the hardware modules
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) shellHostFeed() sizes its pieces with shellRxFree()
+ * - 1.2: 10-15-2026 (Crandell) No notification channel
+ * - 1.3: 10-15-2026 (Crandell) PingBridge stub
+ * - 1.4: 10-15-2026 (Crandell) No zero-copy output, shellOutputAcquire() stages
+ * - 1.5: 10-15-2026 (Crandell) Firmware update stubs
+ * - 1.6: 10-15-2026 (Crandell) ADC stub
+ * - 1.7: 10-15-2026 (Crandell) SPI stub
+ * - 1.8: 10-15-2026 (Crandell) I2C stubs
+ * - 1.9: 10-15-2026 (Crandell) Load stub
+ * - 1.10: 10-15-2026 (Crandell) GPIO stub
+ * - 1.11: 10-15-2026 (Crandell) Events stub
+ * - 1.12: 10-15-2026 (Crandell) Module stubs, no module region
+ * - 1.13: 10-15-2026 (Crandell) Clock governor stub
+ * - 1.14: 10-15-2026 (Crandell) Time sync stubs, no SOF
+ * - 1.15: 10-15-2026 (Crandell) Arm stubs, no trigger line
+ * - 1.16: 10-15-2026 (Crandell) Session stubs, no backup registers
+ * - 1.17: 10-15-2026 (Crandell) Loopback, sink and source stubs
+ *
+ * Usage Notes:
+ *  - Compiled to nothing unless SHELL_HOST_BUILD is set, see CLI_SHELL_HOST.h.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "CLI_SHELL.h"
+
+#if SHELL_HOST_BUILD
+
+#include <time.h>
+
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_HOST.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define HOST_BRIDGE_STUB(bridge) \
+		__attribute__((weak)) shell_error bridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) { \
+			(void)ctx; \
+			(void)parserInput; \
+			return SHELL_ERR; \
+		}
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+uint32_t SystemCoreClock = 1000000000U;		/*!< shellHostCycles() counts nanoseconds	*/
+FILE* shellHostOutput;
+
+uint8_t shellLogLevel;
+
+static const CDC_FrameStats_t hostFrameStats;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint64_t hostNanoseconds(void);
+static void hostAttach(uint8_t port, shell_ctx_t* ctx);
+static uint16_t hostWrite(uint8_t port, const uint8_t* buffer, uint16_t length);
+static void hostFlush(void);
+static uint32_t hostTxFree(uint8_t port);
+
+const shellTransport_t shellHostTransport = {
+	.attach = hostAttach,
+	.write = hostWrite,
+	.flush = hostFlush,
+	.txFree = hostTxFree,
+	.streamAttach = NULL,
+	.rxResume = NULL,
+	.notify = NULL,
+	.txSpan = NULL,
+	.txCommit = NULL,
+};
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Monotonic time
+  * @param  NONE
+  * @retval uint64_t Nanoseconds since an arbitrary start
+  */
+static uint64_t hostNanoseconds(void) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+  * @brief  Transport attach, the driver feeds the instance with shellHostFeed()
+  * @param[IN]  port Port
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void hostAttach(uint8_t port, shell_ctx_t* ctx) {
+	(void)port;
+	(void)ctx;
+}
+
+/**
+  * @brief  Transport write, to shellHostOutput
+  * @param[IN]  port Port
+  * @param[IN]  buffer Bytes
+  * @param[IN]  length Number of bytes
+  * @retval uint16_t Bytes taken (all of them)
+  */
+static uint16_t hostWrite(uint8_t port, const uint8_t* buffer, uint16_t length) {
+	(void)port;
+
+	if (shellHostOutput != NULL) {
+		fwrite(buffer, 1, length, shellHostOutput);
+	}
+	return length;
+}
+
+/**
+  * @brief  Transport flush
+  * @param  NONE
+  * @retval NONE
+  */
+static void hostFlush(void) {
+	if (shellHostOutput != NULL) {
+		fflush(shellHostOutput);
+	}
+}
+
+/**
+  * @brief  Transport room, the host never runs out
+  * @param[IN]  port Port
+  * @retval uint32_t Free bytes
+  */
+static uint32_t hostTxFree(uint8_t port) {
+	(void)port;
+	return UINT16_MAX;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  HAL time base
+  * @param  NONE
+  * @retval uint32_t Milliseconds
+  */
+uint32_t HAL_GetTick(void) {
+	return (uint32_t)(hostNanoseconds() / 1000000ULL);
+}
+
+/**
+  * @brief  Cycle counter of shellPerfCycles()
+  * @param  NONE
+  * @retval uint32_t Nanoseconds, wraps like DWT->CYCCNT
+  */
+uint32_t shellHostCycles(void) {
+	return (uint32_t)hostNanoseconds();
+}
+
+/**
+  * @brief  Hands input to an instance and runs it until all of it has been processed
+  * @note	The input goes in pieces that fit the receive ring, so nothing is dropped. A job
+  * 		still running at the end is cancelled, every call returns with an idle instance.
+  * @param[IN]  ctx Shell instance (shellInit() with shellHostTransport)
+  * @param[IN]  data Input bytes
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellHostFeed(shell_ctx_t* ctx, const uint8_t* data, uint32_t len) {
+	while (len > 0) {
+		uint32_t piece = shellRxFree(ctx);
+
+		if (piece == 0) {
+			checkShellStatus(ctx);
+			continue;
+		}
+		if (piece > len) {
+			piece = len;
+		}
+		rxShellInput(ctx, (uint8_t*)data, &piece);
+		data += piece;
+		len -= piece;
+	}
+
+	while (shellRingUsed(&ctx->rxRing) > 0) {
+		checkShellStatus(ctx);
+	}
+	if (shellJobRunning()) {
+		shellAbort(ctx);
+		checkShellStatus(ctx);
+	}
+}
+
+/**
+  * @brief  Stream queue of usbd_cdc_if.c, the host transport has none
+  */
+uint8_t CDC_StreamWrite_FS(const uint8_t* Buf, uint16_t Len) {
+	(void)Buf;
+	(void)Len;
+	return 0;
+}
+
+uint32_t CDC_StreamFree_FS(void) {
+	return 0;
+}
+
+uint32_t CDC_StreamUsed_FS(void) {
+	return 0;
+}
+
+/**
+  * @brief  Frame statistics of usbd_cdc_if.c
+  */
+const CDC_FrameStats_t* CDC_FrameStats_FS(void) {
+	return &hostFrameStats;
+}
+
+void CDC_FrameStatsClear_FS(void) {
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Hardware modules left out of the host build. Weak, so a driver can link its own
+  * 		model of a module instead.
+  */
+__attribute__((weak)) void shellEventSignal(uint32_t events) {
+	(void)events;
+}
+
+__attribute__((weak)) void shellCapturePoll(void) {
+}
+
+__attribute__((weak)) void shellFlashPoll(void) {
+}
+
+__attribute__((weak)) void shellFwUpdatePoll(void) {
+}
+
+__attribute__((weak)) void shellI2cPoll(void) {
+}
+
+__attribute__((weak)) void shellClockDemand(uint32_t rxQueued) {
+	(void)rxQueued;
+}
+
+__attribute__((weak)) void shellModuleScan(void) {
+}
+
+__attribute__((weak)) bool shellTsyncRef(shellTsyncRef_t* ref) {
+	memset(ref, 0, sizeof(*ref));
+	return false;
+}
+
+__attribute__((weak)) void shellSchedPoll(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellSchedStop(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellArmPoll(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellArmStop(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellSessionRestore(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellSessionSave(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellWatchPoll(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) void shellWatchStop(shell_ctx_t* ctx) {
+	(void)ctx;
+}
+
+__attribute__((weak)) shell_error shellSchedLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	(void)ctx;
+	(void)line;
+	(void)len;
+	return SHELL_ERR;
+}
+
+__attribute__((weak)) shell_error shellArmLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	(void)ctx;
+	(void)line;
+	(void)len;
+	return SHELL_ERR;
+}
+
+__attribute__((weak)) void shellMacroCapture(shell_ctx_t* ctx, const shellParserOutput_t* parserOutput, uint16_t commandIndex) {
+	(void)ctx;
+	(void)parserOutput;
+	(void)commandIndex;
+}
+
+__attribute__((weak)) void shellLogPrintf(uint8_t level, const char* format, ...) {
+	(void)level;
+	(void)format;
+}
+
+HOST_BRIDGE_STUB(AdcBridge)
+HOST_BRIDGE_STUB(ArmBridge)
+HOST_BRIDGE_STUB(ArtBridge)
+HOST_BRIDGE_STUB(CaptureBridge)
+HOST_BRIDGE_STUB(ClockBridge)
+HOST_BRIDGE_STUB(CrashBridge)
+HOST_BRIDGE_STUB(CrcBridge)
+HOST_BRIDGE_STUB(EventsBridge)
+HOST_BRIDGE_STUB(EveryBridge)
+HOST_BRIDGE_STUB(FlashBridge)
+HOST_BRIDGE_STUB(FwupdateBridge)
+HOST_BRIDGE_STUB(GetBridge)
+HOST_BRIDGE_STUB(GpioBridge)
+HOST_BRIDGE_STUB(I2cBridge)
+HOST_BRIDGE_STUB(IdleBridge)
+HOST_BRIDGE_STUB(IsrBridge)
+HOST_BRIDGE_STUB(ItmBridge)
+HOST_BRIDGE_STUB(LEDBridge)
+HOST_BRIDGE_STUB(LoadBridge)
+HOST_BRIDGE_STUB(MacroBridge)
+HOST_BRIDGE_STUB(MemBridge)
+HOST_BRIDGE_STUB(ModulesBridge)
+HOST_BRIDGE_STUB(MrdBridge)
+HOST_BRIDGE_STUB(MwrBridge)
+HOST_BRIDGE_STUB(PatternBridge)
+HOST_BRIDGE_STUB(PingBridge)
+HOST_BRIDGE_STUB(LoopbackBridge)
+HOST_BRIDGE_STUB(SinkBridge)
+HOST_BRIDGE_STUB(SourceBridge)
+HOST_BRIDGE_STUB(SessionBridge)
+HOST_BRIDGE_STUB(SetBridge)
+HOST_BRIDGE_STUB(SpiBridge)
+HOST_BRIDGE_STUB(StreamBridge)
+HOST_BRIDGE_STUB(TputBridge)
+HOST_BRIDGE_STUB(TsyncBridge)
+HOST_BRIDGE_STUB(UsbstatBridge)
+HOST_BRIDGE_STUB(WatchBridge)
+
+#endif // SHELL_HOST_BUILD
+
+/*** end of file ***/
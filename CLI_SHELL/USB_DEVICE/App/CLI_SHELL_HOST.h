@@ -0,0 +1,123 @@
+/** @file CLI_SHELL_HOST.h
+ *
+ * @brief Host build of the CLI Shell core: stand-ins for the HAL, CMSIS and USB pieces it uses
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) CLI_SHELL_BOOT.c, HSI_VALUE
+ * - 1.2: 10-14-2026 (Crandell) CLI_SHELL_CRC.c
+ * - 1.3: 10-14-2026 (Crandell) CLI_SHELL_RESULT.c
+ * - 1.4: 10-15-2026 (Crandell) CLI_SHELL_LZ.c
+ * - 1.5: 10-15-2026 (Crandell) CLI_SHELL_URGENT.c
+ * - 1.6: 10-15-2026 (Crandell) CLI_SHELL_CACHE.c
+ * - 1.7: 10-15-2026 (Crandell) CLI_SHELL_NOTIFY.c
+ * - 1.8: 10-15-2026 (Crandell) CLI_SHELL_GATEWAY.c
+ * - 1.9: 10-15-2026 (Crandell) CLI_SHELL_VM.c
+ * - 1.10: 10-15-2026 (Crandell) CLI_SHELL_VAR.c
+ * - 1.11: 10-15-2026 (Crandell) CLI_SHELL_REGRESS.c
+ * - 1.12: 10-15-2026 (Crandell) CLI_SHELL_HISTORY.c
+ * - 1.13: 10-15-2026 (Crandell) CLI_SHELL_EDIT.c
+ * - 1.14: 10-15-2026 (Crandell) CLI_SHELL_PIPE.c
+ * - 1.15: 10-15-2026 (Crandell) Fuzz harness and parser microbenchmark in Tools/
+ *
+ * Usage Notes:
+ *  - Builds the parser and dispatch core with a PC compiler (gcc, clang), e.g.
+ *      cc -DSHELL_HOST_BUILD=1 -IUSB_DEVICE/App <driver>.c CLI_SHELL.c CLI_SHELL_BINARY.c
+ *         CLI_SHELL_BENCH.c CLI_SHELL_BOOT.c CLI_SHELL_CACHE.c CLI_SHELL_CONVERT.c CLI_SHELL_CRC.c
+ *         CLI_SHELL_EDIT.c CLI_SHELL_FORMAT.c CLI_SHELL_GATEWAY.c CLI_SHELL_HISTORY.c
+ *         CLI_SHELL_HOST.c CLI_SHELL_JOB.c CLI_SHELL_LZ.c CLI_SHELL_NOTIFY.c CLI_SHELL_PERF.c
+ *         CLI_SHELL_PIPE.c CLI_SHELL_POOL.c CLI_SHELL_RESULT.c CLI_SHELL_REGRESS.c CLI_SHELL_RING.c
+ *         CLI_SHELL_TRACE.c CLI_SHELL_URGENT.c CLI_SHELL_VAR.c CLI_SHELL_VM.c
+ *    Nothing of the driver depends on the CubeIDE project. Two drivers come with it, both with
+ *    their build lines in the file header:
+ *      Tools/shell_fuzz.c - libFuzzer LLVMFuzzerTestOneInput() over shellHostFeed() (text lines,
+ *        binary frames with valid CRCs, raw binary input) and the parser stages directly
+ *        (clang -fsanitize=fuzzer,address,undefined)
+ *      Tools/shell_microbench.c - nanoseconds per call of tokenizeLine(), matchCommand() and
+ *        validateArgs() on a set of lines (cc -O2)
+ *  - The commands of the hardware modules (USB, UART, timers, flash, ...) are weak stubs in
+ *    CLI_SHELL_HOST.c that answer SHELL_ERR, the table, the parser, the argument validation, the
+ *    response formatting and "help", "mode", "perf", "bench", "regress", "trace", "vm" run as on
+ *    the target.
+ *  - shellHostTransport is the transport of the host instances. Output goes to shellHostOutput
+ *    (stdout, a file, or NULL to discard it). shellHostFeed() hands input to an instance in
+ *    ring sized pieces and polls it until everything has been processed.
+ *  - shellPerfCycles() counts nanoseconds on the host and SystemCoreClock is 1 GHz, so "perf"
+ *    and "bench" report nanoseconds and real commands per second.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_HOST_H_
+#define CLI_SHELL_HOST_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  CMSIS core functions, a host program has no interrupts to mask
+  */
+#define __get_PRIMASK()				(0U)
+#define __set_PRIMASK(primask)		((void)(primask))
+#define __disable_irq()				((void)0)
+#define __enable_irq()				((void)0)
+#define __REV(value)				__builtin_bswap32(value)
+#define __REV16(value)				((((value) >> 8) & 0x00FF00FFU) | (((value) << 8) & 0xFF00FF00U))
+#define NVIC_DisableIRQ(irq)		((void)(irq))
+#define NVIC_EnableIRQ(irq)			((void)(irq))
+#define OTG_FS_IRQn					0
+#define HSI_VALUE					16000000U
+
+/**
+  * @brief  Ports of usbd_cdc_if.h
+  */
+#define CDC_CH_OPERATOR				0U
+#define CDC_CH_AUTOMATION			1U
+#define CDC_CH_COUNT				2U
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Frame statistics of usbd_cdc_if.h, always zero on the host
+  */
+typedef struct {
+	uint32_t frames;
+	uint32_t busyFrames;
+	uint32_t inPackets;
+	uint32_t maxPacketsPerFrame;
+	uint32_t nakFrames;
+} CDC_FrameStats_t;
+
+struct shellCtxTypeDef;
+struct shellTransportTypeDef;
+
+extern uint32_t SystemCoreClock;
+extern FILE* shellHostOutput;
+extern const struct shellTransportTypeDef shellHostTransport;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+uint32_t HAL_GetTick(void);
+uint32_t shellHostCycles(void);
+void shellHostFeed(struct shellCtxTypeDef* ctx, const uint8_t* data, uint32_t len);
+
+uint8_t CDC_StreamWrite_FS(const uint8_t* Buf, uint16_t Len);
+uint32_t CDC_StreamFree_FS(void);
+uint32_t CDC_StreamUsed_FS(void);
+const CDC_FrameStats_t* CDC_FrameStats_FS(void);
+void CDC_FrameStatsClear_FS(void);
+
+#endif // CLI_SHELL_HOST_H_
+
+/*** end of file ***/
@@ -0,0 +1,511 @@
+/** @file CLI_SHELL_I2C.c
+ *
+ * @brief I2C request queue of the CLI Shell: interrupt-driven register reads on I2C1, "i2c"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_I2C.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_NOTIFY.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define I2C_PINS				(GPIO_PIN_8 | GPIO_PIN_9)	/*!< GPIOB, SCL SDA					*/
+#define I2C_ERRORS				(I2C_SR1_AF | I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_OVR)
+#define I2C_STOP_SPINS			1000U		/*!< Waits for the stop before the next start	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Where the interrupt is within the read of a register
+  */
+typedef enum {
+	i2cPhase_idle = 0,
+	i2cPhase_startWrite,					/*!< START sent, address + W next			*/
+	i2cPhase_addrWrite,						/*!< Address sent, register next			*/
+	i2cPhase_reg,							/*!< Register sent, repeated START next		*/
+	i2cPhase_startRead,						/*!< Repeated START sent, address + R next	*/
+	i2cPhase_addrRead,						/*!< Address sent, receive set up next		*/
+	i2cPhase_receive
+} i2cPhase_t;
+
+/**
+  * @brief  A request
+  */
+typedef struct {
+	volatile shellI2cStatus_t status;
+	uint8_t id;
+	bool notified;							/*!< Finished and notifyEvt_i2cDone sent	*/
+	uint8_t addr;							/*!< 7-bit								*/
+	uint8_t reads;
+	uint8_t len;							/*!< Bytes per register					*/
+	uint8_t reg[SHELL_I2C_READS_MAX];
+	uint8_t data[SHELL_I2C_DATA_MAX];
+	uint32_t order;							/*!< Queued at, the oldest runs first		*/
+	shell_ctx_t* ctx;						/*!< Instance that queued it				*/
+} i2cRequest_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static i2cRequest_t i2cQueue[SHELL_I2C_QUEUE_LEN];
+
+/**
+  * @brief  The bus
+  */
+static struct {
+	bool ready;								/*!< Clocks, pins and timing set up			*/
+	i2cRequest_t* current;					/*!< NULL while the bus is idle				*/
+	volatile i2cPhase_t phase;
+	uint8_t read;							/*!< Register of current					*/
+	uint8_t* buffer;						/*!< Next byte of the register				*/
+	uint8_t remaining;						/*!< Bytes of the register still to come	*/
+	volatile uint32_t progressTick;			/*!< Last start of a register				*/
+	uint32_t order;
+	uint8_t nextId;
+} i2c;
+
+static const char* const i2cStatusNames[] = {
+	[i2cStatus_free]	= "free",
+	[i2cStatus_queued]	= "queued",
+	[i2cStatus_running]	= "running",
+	[i2cStatus_done]	= "done",
+	[i2cStatus_nack]	= "nack",
+	[i2cStatus_error]	= "error",
+	[i2cStatus_timeout]	= "timeout",
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void i2cSetup(void);
+static void i2cStartRegister(void);
+static void i2cStartNext(void);
+static void i2cFinish(shellI2cStatus_t status);
+static void i2cRegisterDone(void);
+static void i2cReceive(uint32_t sr1);
+static i2cRequest_t* i2cFind(uint8_t id);
+static void resultRequest(shellResult_t* res, const i2cRequest_t* request);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Clocks, pins and I2C1 timing from PCLK1, both interrupts enabled in the NVIC
+  * @note	Also brings the peripheral back after a timeout, through its software reset.
+  * @param  NONE
+  * @retval NONE
+  */
+static void i2cSetup(void) {
+	GPIO_InitTypeDef gpioInit = {0};
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+	uint32_t mhz = pclk / 1000000U;
+	uint32_t ccr;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_I2C1_CLK_ENABLE();
+
+	gpioInit.Pin = I2C_PINS;
+	gpioInit.Mode = GPIO_MODE_AF_OD;
+	gpioInit.Pull = GPIO_PULLUP;
+	gpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	gpioInit.Alternate = GPIO_AF4_I2C1;
+	HAL_GPIO_Init(GPIOB, &gpioInit);
+
+	I2C1->CR1 = I2C_CR1_SWRST;
+	I2C1->CR1 = 0;
+	I2C1->CR2 = mhz;
+	if (SHELL_I2C_SPEED_HZ > 100000U) {
+		ccr = pclk / (3 * SHELL_I2C_SPEED_HZ);
+		I2C1->CCR = I2C_CCR_FS | ((ccr < 1) ? 1 : ccr);
+		I2C1->TRISE = (mhz * 300U) / 1000U + 1;
+	} else {
+		ccr = pclk / (2 * SHELL_I2C_SPEED_HZ);
+		I2C1->CCR = (ccr < 4) ? 4 : ccr;
+		I2C1->TRISE = mhz + 1;
+	}
+	I2C1->CR1 = I2C_CR1_PE;
+
+	HAL_NVIC_SetPriority(I2C1_EV_IRQn, SHELL_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_SetPriority(I2C1_ER_IRQn, SHELL_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+	HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+	i2c.ready = true;
+}
+
+/**
+  * @brief  Sends the START of the current register
+  * @note	A STOP still going out is waited for, it takes a bit time at most.
+  * @param  NONE
+  * @retval NONE
+  */
+static void i2cStartRegister(void) {
+	uint32_t spins = I2C_STOP_SPINS;
+
+	while ((I2C1->CR1 & I2C_CR1_STOP) != 0 && --spins != 0) {
+	}
+
+	i2c.buffer = &i2c.current->data[i2c.read * i2c.current->len];
+	i2c.remaining = i2c.current->len;
+	i2c.progressTick = HAL_GetTick();
+	i2c.phase = i2cPhase_startWrite;
+
+	I2C1->CR1 &= ~I2C_CR1_POS;
+	I2C1->CR1 |= I2C_CR1_ACK | I2C_CR1_START;
+	I2C1->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN;
+}
+
+/**
+  * @brief  Starts the oldest queued request, if the bus is idle
+  * @note	Called by the bridge and by the interrupts. Runs with interrupts disabled when
+  * 		called from thread mode.
+  * @param  NONE
+  * @retval NONE
+  */
+static void i2cStartNext(void) {
+	i2cRequest_t* next = NULL;
+
+	if (i2c.current != NULL) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < SHELL_I2C_QUEUE_LEN; i++) {
+		if (i2cQueue[i].status == i2cStatus_queued && (next == NULL || (int32_t)(i2cQueue[i].order - next->order) < 0)) {
+			next = &i2cQueue[i];
+		}
+	}
+	if (next == NULL) {
+		return;
+	}
+
+	next->status = i2cStatus_running;
+	i2c.current = next;
+	i2c.read = 0;
+	i2cStartRegister();
+}
+
+/**
+  * @brief  Ends the current request and starts the next one
+  * @param[IN]  status How it ended
+  * @retval NONE
+  */
+static void i2cFinish(shellI2cStatus_t status) {
+	I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN);
+	i2c.phase = i2cPhase_idle;
+	i2c.current->status = status;
+	i2c.current = NULL;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+	i2cStartNext();
+}
+
+/**
+  * @brief  One register read in full, the next register or the end of the request
+  * @param  NONE
+  * @retval NONE
+  */
+static void i2cRegisterDone(void) {
+	if (++i2c.read < i2c.current->reads) {
+		i2cStartRegister();
+	} else {
+		i2cFinish(i2cStatus_done);
+	}
+}
+
+/**
+  * @brief  Receive events: RXNE byte by byte while more than 3 are due, BTF for the last ones
+  * @note	The ACK and STOP timing of the reference manual: ACK off with 2 bytes to come (their
+  * 		first in DR, the second in the shift register), STOP before reading them.
+  * @param[IN]  sr1 Status register 1
+  * @retval NONE
+  */
+static void i2cReceive(uint32_t sr1) {
+	if ((sr1 & I2C_SR1_BTF) != 0) {
+		if (i2c.remaining == 3) {
+			I2C1->CR1 &= ~I2C_CR1_ACK;
+			*i2c.buffer++ = (uint8_t)I2C1->DR;
+			i2c.remaining--;
+		} else if (i2c.remaining == 2) {
+			I2C1->CR1 |= I2C_CR1_STOP;
+			*i2c.buffer++ = (uint8_t)I2C1->DR;
+			*i2c.buffer++ = (uint8_t)I2C1->DR;
+			i2c.remaining = 0;
+			i2cRegisterDone();
+		}
+		return;
+	}
+
+	if ((sr1 & I2C_SR1_RXNE) != 0) {
+		if (i2c.remaining > 3) {
+			*i2c.buffer++ = (uint8_t)I2C1->DR;
+			i2c.remaining--;
+		}
+		if (i2c.remaining == 1) {
+			// N = 1: ACK off and STOP were set at the address
+			*i2c.buffer++ = (uint8_t)I2C1->DR;
+			i2c.remaining = 0;
+			i2cRegisterDone();
+		} else if (i2c.remaining <= 3) {
+			// The last bytes go by BTF
+			I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
+		}
+	}
+}
+
+/**
+  * @brief  Request of an id
+  * @param[IN]  id Request id
+  * @retval i2cRequest_t* NULL if there is none
+  */
+static i2cRequest_t* i2cFind(uint8_t id) {
+	for (uint8_t i = 0; i < SHELL_I2C_QUEUE_LEN; i++) {
+		if (i2cQueue[i].status != i2cStatus_free && i2cQueue[i].id == id) {
+			return &i2cQueue[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+  * @brief  Fields of a request: id, status and the data once it is done
+  * @param[IN]  res Result
+  * @param[IN]  request The request
+  * @retval NONE
+  */
+static void resultRequest(shellResult_t* res, const i2cRequest_t* request) {
+	shellI2cStatus_t status = request->status;
+
+	shellResultUnsigned(res, "id", request->id);
+	shellResultText(res, "status", i2cStatusNames[status]);
+	if (status == i2cStatus_done) {
+		shellResultBytes(res, "data", request->data, (uint16_t)request->reads * request->len);
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Timeouts and notifications of finished requests
+  * @note	Called by checkShellStatus().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellI2cPoll(void) {
+	if (i2c.current != NULL && (HAL_GetTick() - i2c.progressTick) > SHELL_I2C_TIMEOUT_MS) {
+		uint32_t primask = __get_PRIMASK();
+
+		// A device holding SDA or a lost interrupt, the peripheral starts over
+		__disable_irq();
+		if (i2c.current != NULL && (HAL_GetTick() - i2c.progressTick) > SHELL_I2C_TIMEOUT_MS) {
+			I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN);
+			i2cSetup();
+			i2cFinish(i2cStatus_timeout);
+		}
+		__set_PRIMASK(primask);
+	}
+
+	for (uint8_t i = 0; i < SHELL_I2C_QUEUE_LEN; i++) {
+		i2cRequest_t* request = &i2cQueue[i];
+		shellI2cStatus_t status = request->status;
+
+		if (status >= i2cStatus_done && !request->notified) {
+			request->notified = true;
+			shellNotify(request->ctx, notifyEvt_i2cDone, request->id | ((uint32_t)status << 8));
+		}
+	}
+}
+
+/**
+  * @brief  I2C1 events: start, address, byte transfer
+  * @param  NONE
+  * @retval NONE
+  */
+void I2C1_EV_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+	uint32_t sr1 = I2C1->SR1;
+
+	switch (i2c.phase) {
+	case i2cPhase_startWrite:
+		if ((sr1 & I2C_SR1_SB) != 0) {
+			I2C1->DR = (uint32_t)i2c.current->addr << 1;
+			i2c.phase = i2cPhase_addrWrite;
+		}
+		break;
+	case i2cPhase_addrWrite:
+		if ((sr1 & I2C_SR1_ADDR) != 0) {
+			(void)I2C1->SR2;
+			I2C1->DR = i2c.current->reg[i2c.read];
+			I2C1->CR2 &= ~I2C_CR2_ITBUFEN;
+			i2c.phase = i2cPhase_reg;
+		}
+		break;
+	case i2cPhase_reg:
+		if ((sr1 & I2C_SR1_BTF) != 0) {
+			I2C1->CR1 |= I2C_CR1_START;
+			i2c.phase = i2cPhase_startRead;
+		}
+		break;
+	case i2cPhase_startRead:
+		if ((sr1 & I2C_SR1_SB) != 0) {
+			I2C1->DR = ((uint32_t)i2c.current->addr << 1) | 1U;
+			i2c.phase = i2cPhase_addrRead;
+		}
+		break;
+	case i2cPhase_addrRead:
+		if ((sr1 & I2C_SR1_ADDR) != 0) {
+			if (i2c.remaining == 1) {
+				I2C1->CR1 &= ~I2C_CR1_ACK;
+				(void)I2C1->SR2;
+				I2C1->CR1 |= I2C_CR1_STOP;
+				I2C1->CR2 |= I2C_CR2_ITBUFEN;
+			} else if (i2c.remaining == 2) {
+				I2C1->CR1 &= ~I2C_CR1_ACK;
+				I2C1->CR1 |= I2C_CR1_POS;
+				(void)I2C1->SR2;
+			} else {
+				(void)I2C1->SR2;
+				I2C1->CR2 |= I2C_CR2_ITBUFEN;
+			}
+			i2c.phase = i2cPhase_receive;
+		}
+		break;
+	case i2cPhase_receive:
+		i2cReceive(sr1);
+		break;
+	default:
+		// Nothing running, a late event
+		I2C1->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN);
+		break;
+	}
+	SHELL_ISR_RECORD(isrId_i2cEvent, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  I2C1 errors: no acknowledge, bus error, arbitration lost
+  * @param  NONE
+  * @retval NONE
+  */
+void I2C1_ER_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+	uint32_t sr1 = I2C1->SR1;
+
+	I2C1->SR1 = sr1 & ~I2C_ERRORS;
+	if (i2c.current != NULL && (sr1 & I2C_ERRORS) != 0) {
+		if ((sr1 & I2C_SR1_ARLO) == 0) {
+			I2C1->CR1 |= I2C_CR1_STOP;
+		}
+		i2cFinish(((sr1 & I2C_SR1_AF) != 0) ? i2cStatus_nack : i2cStatus_error);
+	}
+	SHELL_ISR_RECORD(isrId_i2cError, start, SHELL_ISR_NO_LATENCY);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Queues a request, collects one or lists the queue
+  * @note	See CLI_SHELL_I2C.h for the arguments.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_ERR for a full queue, bad arguments or an unknown id
+  */
+shell_error I2cBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_RESULT_DEFINE(res, ctx, SHELL_I2C_DATA_MAX * 2 + 16);
+
+	if (shellHasArg(parserInput, argTkn_i)) {
+		i2cRequest_t* request = i2cFind(shellArgValue(parserInput, shellFindArg(parserInput, argTkn_i)).u8);
+
+		if (request == NULL) {
+			return SHELL_ERR;
+		}
+		resultRequest(&res, request);
+		shellResultEnd(&res);
+		if (request->status >= i2cStatus_done) {
+			request->status = i2cStatus_free;
+		}
+		return SHELL_OK;
+	}
+
+	if (!shellHasArg(parserInput, argTkn_a)) {
+		shellResultList(&res, "requests");
+		for (uint8_t i = 0; i < SHELL_I2C_QUEUE_LEN; i++) {
+			if (i2cQueue[i].status != i2cStatus_free) {
+				shellResultGroup(&res, NULL);
+				shellResultUnsigned(&res, "id", i2cQueue[i].id);
+				shellResultText(&res, "status", i2cStatusNames[i2cQueue[i].status]);
+				shellResultClose(&res);
+			}
+		}
+		shellResultEnd(&res);
+		return SHELL_OK;
+	}
+
+	uint8_t reg[SHELL_I2C_READS_MAX];
+	uint8_t reads = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_r), reg, SHELL_I2C_READS_MAX);
+	uint8_t addr = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u8;
+	uint8_t len = 1;
+	i2cRequest_t* request = NULL;
+
+	if (shellHasArg(parserInput, argTkn_n)) {
+		len = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u8;
+	}
+	if (addr > 0x7F || reads == 0 || len == 0 || (uint16_t)reads * len > SHELL_I2C_DATA_MAX) {
+		return SHELL_ERR;
+	}
+
+	for (uint8_t i = 0; i < SHELL_I2C_QUEUE_LEN && request == NULL; i++) {
+		if (i2cQueue[i].status == i2cStatus_free) {
+			request = &i2cQueue[i];
+		}
+	}
+	if (request == NULL) {
+		return SHELL_ERR;
+	}
+
+	if (!i2c.ready) {
+		i2cSetup();
+	}
+
+	// Ids count up from 1, skipping those still in the queue
+	do {
+		i2c.nextId = (i2c.nextId == UINT8_MAX) ? 1 : (uint8_t)(i2c.nextId + 1);
+	} while (i2cFind(i2c.nextId) != NULL);
+
+	request->id = i2c.nextId;
+	request->notified = false;
+	request->addr = addr;
+	request->reads = reads;
+	request->len = len;
+	request->ctx = ctx;
+	request->order = i2c.order++;
+	memcpy(request->reg, reg, reads);
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	request->status = i2cStatus_queued;
+	i2cStartNext();
+	__set_PRIMASK(primask);
+
+	shellResultUnsigned(&res, "id", request->id);
+	shellResultEnd(&res);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
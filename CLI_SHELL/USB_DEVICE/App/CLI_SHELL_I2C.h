@@ -0,0 +1,76 @@
+/** @file CLI_SHELL_I2C.h
+ *
+ * @brief I2C request queue of the CLI Shell: interrupt-driven register reads on I2C1, "i2c"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "i2c a<addr> r<reg,reg,..> n<bytes>" queues a request: n bytes from each listed register of
+ *    the device at 7-bit address a, one register write and repeated start read per register. The
+ *    response is immediate, the result field "id" of the request. Up to SHELL_I2C_QUEUE_LEN
+ *    requests wait or finish at a time, a full queue is SHELL_ERR.
+ *  - "i2c i<id>" collects a request: "id", "status" and, once it is done, "data" (the n bytes of
+ *    every register in the order of r). A finished request is freed by collecting it, a waiting
+ *    or running one stays. "i2c" lists the requests in the queue, "id" and "status" each.
+ *  - status: "queued", "running", "done", "nack" (no acknowledge from the device or a register),
+ *    "error" (bus error, arbitration lost) or "timeout" (no progress for SHELL_I2C_TIMEOUT_MS,
+ *    the peripheral is reset).
+ *  - A finished request sends notifyEvt_i2cDone (CLI_SHELL_NOTIFY.h) to the instance that queued
+ *    it, value id | status << 8 (shellI2cStatus_t), so the host collects without polling.
+ *  - The event and error interrupts of I2C1 run the requests: every register and every request
+ *    starts from the interrupt of the one before, the bus stays busy while the main loop and the
+ *    USB go on. The main loop only looks for timeouts and finished requests (shellI2cPoll()).
+ *  - Pins: PB8 SCL, PB9 SDA (AF4, open drain, internal pull-ups enabled, use external ones for
+ *    anything but short wires). SHELL_I2C_SPEED_HZ, standard mode by default.
+ *  - The HAL I2C module is not part of the project, I2C1 is driven through its registers along
+ *    the receive sequences of the reference manual (N = 1, 2 and more).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_I2C_H_
+#define CLI_SHELL_I2C_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_I2C_QUEUE_LEN				8			/*!< Requests waiting or finished		*/
+#define SHELL_I2C_READS_MAX				8			/*!< Registers per request				*/
+#define SHELL_I2C_DATA_MAX				32			/*!< Bytes per request, all registers	*/
+#define SHELL_I2C_SPEED_HZ				100000U
+#define SHELL_I2C_TIMEOUT_MS			20			/*!< Per register						*/
+#define SHELL_I2C_IRQ_PRIORITY			1
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  State of a request, in the notification value and the "status" field
+  */
+typedef enum {
+	i2cStatus_free = 0,
+	i2cStatus_queued,
+	i2cStatus_running,
+	i2cStatus_done,
+	i2cStatus_nack,
+	i2cStatus_error,
+	i2cStatus_timeout
+} shellI2cStatus_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellI2cPoll(void);
+
+#endif // CLI_SHELL_I2C_H_
+
+/*** end of file ***/
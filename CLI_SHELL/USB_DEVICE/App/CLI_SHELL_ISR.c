@@ -0,0 +1,192 @@
+/** @file CLI_SHELL_ISR.c
+ *
+ * @brief Interrupt latency and duration profiler of the CLI Shell, the "isr" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ISR.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+shellIsrProfile_t shellIsrProfiles[isrId_count];
+
+static uint32_t clearTick;					/*!< HAL_GetTick() at the last reset		*/
+
+static const char* const isrNames[isrId_count] = {
+	[isrId_otgFs]		= "OTG_FS",
+	[isrId_sysTick]		= "SysTick",
+	[isrId_tim11]		= "TIM11",
+	[isrId_usart1]		= "USART1",
+	[isrId_uartRxDma]	= "DMA2_S2",
+	[isrId_uartTxDma]	= "DMA2_S7",
+	[isrId_captureRise]	= "DMA1_S2",
+	[isrId_captureFall]	= "DMA1_S4",
+	[isrId_pattern]		= "DMA2_S5",
+	[isrId_flash]		= "FLASH",
+	[isrId_adc]			= "DMA2_S4",
+	[isrId_spi]			= "DMA1_S0",
+	[isrId_i2cEvent]	= "I2C1_EV",
+	[isrId_i2cError]	= "I2C1_ER",
+	[isrId_exti]		= "EXTI",
+	[isrId_copy]		= "DMA2_S1/3",
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void printHistogram(shell_ctx_t* ctx, const char* title, const uint32_t* bins);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Prints the non empty bins of a histogram, one line each
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  title Histogram name
+  * @param[IN]  bins SHELL_ISR_BINS counts
+  * @retval NONE
+  */
+static void printHistogram(shell_ctx_t* ctx, const char* title, const uint32_t* bins) {
+	SHELL_STR_DEFINE(str, 64);
+
+	shellStrAppend(&str, title);
+	shellStrAppend(&str, " (cycles):\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint32_t bin = 0; bin < SHELL_ISR_BINS; bin++) {
+		if (bins[bin] == 0) {
+			continue;
+		}
+		shellStrAppend(&str, "  ");
+		if (bin == 0) {
+			shellStrAppend(&str, "0");
+		} else if (bin == SHELL_ISR_BINS - 1) {
+			shellStrAppend(&str, ">= ");
+			shellStrAppendUnsigned(&str, 1UL << (bin - 1), 0);
+		} else {
+			shellStrAppendUnsigned(&str, 1UL << (bin - 1), 0);
+			shellStrAppendChar(&str, '-');
+			shellStrAppendUnsigned(&str, (1UL << bin) - 1, 0);
+		}
+		shellStrAppend(&str, ": ");
+		shellStrAppendUnsigned(&str, bins[bin], 0);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Resets every handler's statistics
+  * @note	Masks the interrupts, a handler finishing halfway through would leave a mixed entry.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellIsrClear(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	memset(shellIsrProfiles, 0, sizeof(shellIsrProfiles));
+	clearTick = HAL_GetTick();
+	__set_PRIMASK(primask);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Lists the handler statistics, the histograms of one handler (h), resets (r1)
+  * @note	The load is the share of the core cycles since the reset, it assumes the clock
+  * 		profile did not change in between.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error IsrBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	shellIsrProfile_t profile;
+	SHELL_STR_DEFINE(str, 80);
+
+	if (shellHasArg(parserInput, argTkn_h)) {
+		uint8_t id = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_h)).u8;
+		if (id >= isrId_count) {
+			return SHELL_ERR;
+		}
+
+		__disable_irq();
+		profile = shellIsrProfiles[id];
+		__enable_irq();
+
+		shellStrAppend(&str, isrNames[id]);
+		shellStrAppend(&str, ": ");
+		shellStrAppendUnsigned(&str, profile.count, 0);
+		shellStrAppend(&str, " calls\r\n");
+		shellStrSend(ctx, &str);
+		printHistogram(ctx, "Duration", profile.duration);
+		if (profile.latencyCount != 0) {
+			printHistogram(ctx, "Entry latency", profile.latency);
+		}
+	} else {
+		uint64_t elapsed = (uint64_t)(HAL_GetTick() - clearTick) * (SystemCoreClock / 1000U);
+
+		shellStrAppend(&str, "ID\tHandler\tCalls\tMean\tMax\tMax lat\tLoad %\r\n");
+		shellStrSend(ctx, &str);
+
+		for (uint8_t id = 0; id < isrId_count; id++) {
+			__disable_irq();
+			profile = shellIsrProfiles[id];
+			__enable_irq();
+
+			shellStrAppendUnsigned(&str, id, 0);
+			shellStrAppendChar(&str, '\t');
+			shellStrAppend(&str, isrNames[id]);
+			shellStrAppendChar(&str, '\t');
+			shellStrAppendUnsigned(&str, profile.count, 0);
+			shellStrAppendChar(&str, '\t');
+			shellStrAppendUnsigned(&str, (profile.count != 0) ? (uint32_t)(profile.totalCycles / profile.count) : 0, 0);
+			shellStrAppendChar(&str, '\t');
+			shellStrAppendUnsigned(&str, profile.maxCycles, 0);
+			shellStrAppendChar(&str, '\t');
+			if (profile.latencyCount != 0) {
+				shellStrAppendUnsigned(&str, profile.maxLatency, 0);
+			} else {
+				shellStrAppendChar(&str, '-');
+			}
+			shellStrAppendChar(&str, '\t');
+
+			// Hundredths of a percent
+			uint32_t load = (elapsed != 0) ? (uint32_t)((profile.totalCycles * 10000U) / elapsed) : 0;
+			shellStrAppendUnsigned(&str, load / 100U, 0);
+			shellStrAppendChar(&str, '.');
+			shellStrAppendUnsigned(&str, load % 100U, 2);
+			shellStrAppend(&str, "\r\n");
+			shellStrSend(ctx, &str);
+		}
+		shellStrAppend(&str, "Cycles at ");
+		shellStrAppendUnsigned(&str, SystemCoreClock, 0);
+		shellStrAppend(&str, " Hz\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+		shellIsrClear();
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
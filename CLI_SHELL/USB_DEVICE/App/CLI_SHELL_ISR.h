@@ -0,0 +1,146 @@
+/** @file CLI_SHELL_ISR.h
+ *
+ * @brief Interrupt latency and duration profiler of the CLI Shell, the "isr" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Every profiled handler takes start = shellPerfCycles() first and ends with
+ *    SHELL_ISR_RECORD(id, start, latency). Per handler (shellIsrId_t) it keeps the number of
+ *    calls, the total and longest duration and a histogram of the durations, all in DWT core
+ *    cycles. Durations include the higher priority handlers that preempted it.
+ *  - Entry latency (pending to first instruction of the handler) needs a hardware timestamp of
+ *    the request. It is taken where one exists, elsewhere pass SHELL_ISR_NO_LATENCY:
+ *      SysTick		SysTick->LOAD - SysTick->VAL, the counter runs on the core clock
+ *      TIM11		TIM11->CNT * (PSC + 1), APB2 is never divided so the timer clock is HCLK.
+ *      			Resolution is one scheduler tick count (1 us).
+ *  - The histograms have SHELL_ISR_BINS power of two bins: bin n counts values from
+ *    2^(n-1) up to 2^n - 1 cycles (bin 0 is 0), the last bin everything longer.
+ *  - "isr" lists every handler with calls, mean/max duration, max latency and the share of the
+ *    core time since the last reset. "isr h<id>" prints the histograms of one handler,
+ *    "isr r1" resets after the dump.
+ *  - Define SHELL_ISR_PROFILE_ENABLE as 0 to compile the recording out.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_ISR_H_
+#define CLI_SHELL_ISR_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "stm32f4xx.h"
+#include "CLI_SHELL_PERF.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_ISR_PROFILE_ENABLE
+#define SHELL_ISR_PROFILE_ENABLE	SHELL_PERF_ENABLE
+#endif
+
+#define SHELL_ISR_BINS				16			/*!< Histogram bins, the last one >= 16384 cycles	*/
+#define SHELL_ISR_NO_LATENCY		UINT32_MAX	/*!< Handler without a request timestamp	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Profiled handlers
+  */
+typedef enum {
+	isrId_otgFs = 0,						/*!< OTG_FS_IRQHandler, HAL_PCD_IRQHandler	*/
+	isrId_sysTick,							/*!< SysTick_Handler, HAL tick				*/
+	isrId_tim11,							/*!< TIM11, "every" timing wheel			*/
+	isrId_usart1,							/*!< USART1 idle line and errors			*/
+	isrId_uartRxDma,						/*!< DMA2 Stream 2, USART1 receive			*/
+	isrId_uartTxDma,						/*!< DMA2 Stream 7, USART1 transmit			*/
+	isrId_captureRise,						/*!< DMA1 Stream 2, capture rising edges	*/
+	isrId_captureFall,						/*!< DMA1 Stream 4, capture falling edges	*/
+	isrId_pattern,							/*!< DMA2 Stream 5, pattern output			*/
+	isrId_flash,							/*!< FLASH, operation queue					*/
+	isrId_adc,								/*!< DMA2 Stream 4, ADC scans				*/
+	isrId_spi,								/*!< DMA1 Stream 0, SPI3 receive			*/
+	isrId_i2cEvent,							/*!< I2C1 events, request queue				*/
+	isrId_i2cError,							/*!< I2C1 errors							*/
+	isrId_exti,								/*!< EXTI lines 0 to 15, edge events		*/
+	isrId_copy,								/*!< DMA2 Streams 1 and 3, copy service		*/
+	isrId_count
+} shellIsrId_t;
+
+/**
+  * @brief  Statistics of one handler. Written by shellIsrRecord() only.
+  */
+typedef struct {
+	uint32_t count;							/*!< Calls									*/
+	uint32_t maxCycles;						/*!< Longest run							*/
+	uint64_t totalCycles;					/*!< Sum of all runs (mean, load)			*/
+	uint32_t latencyCount;					/*!< Calls with a latency					*/
+	uint32_t maxLatency;					/*!< Longest entry latency					*/
+	uint32_t duration[SHELL_ISR_BINS];		/*!< Duration histogram						*/
+	uint32_t latency[SHELL_ISR_BINS];		/*!< Entry latency histogram				*/
+} shellIsrProfile_t;
+
+extern shellIsrProfile_t shellIsrProfiles[isrId_count];
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellIsrClear(void);
+
+/**
+  * @brief  Histogram bin of a cycle count
+  * @param[IN]  cycles Cycles
+  * @retval uint32_t Bin, 0 to SHELL_ISR_BINS - 1
+  */
+static inline uint32_t shellIsrBin(uint32_t cycles) {
+	uint32_t bin = 32U - __CLZ(cycles);
+
+	return (bin < SHELL_ISR_BINS) ? bin : (SHELL_ISR_BINS - 1);
+}
+
+/**
+  * @brief  Records one run of a handler, called last in the handler
+  * @note	A handler never preempts itself, so its own entry needs no masking.
+  * @param[IN]  id shellIsrId_t
+  * @param[IN]  start shellPerfCycles() at entry
+  * @param[IN]  latency Entry latency in cycles or SHELL_ISR_NO_LATENCY
+  * @retval uint32_t Cycles since start
+  */
+static inline uint32_t shellIsrRecord(uint8_t id, uint32_t start, uint32_t latency) {
+	uint32_t cycles = shellPerfCycles() - start;
+	shellIsrProfile_t* profile = &shellIsrProfiles[id];
+
+	profile->count++;
+	profile->totalCycles += cycles;
+	if (cycles > profile->maxCycles) {
+		profile->maxCycles = cycles;
+	}
+	profile->duration[shellIsrBin(cycles)]++;
+
+	if (latency != SHELL_ISR_NO_LATENCY) {
+		profile->latencyCount++;
+		if (latency > profile->maxLatency) {
+			profile->maxLatency = latency;
+		}
+		profile->latency[shellIsrBin(latency)]++;
+	}
+	return cycles;
+}
+
+#if SHELL_ISR_PROFILE_ENABLE
+#define SHELL_ISR_RECORD(id, start, latency)	shellIsrRecord((uint8_t)(id), (start), (latency))
+#else
+#define SHELL_ISR_RECORD(id, start, latency)	((void)(latency), shellPerfCycles() - (start))
+#endif
+
+#endif // CLI_SHELL_ISR_H_
+
+/*** end of file ***/
@@ -0,0 +1,200 @@
+/** @file CLI_SHELL_ITM.c
+ *
+ * @brief Debug output of the CLI Shell over the ITM stimulus ports (SWO), _write() and "itm"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) shellLogPrintf() only with SHELL_LOG_LEVEL above 0
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#include "stm32f4xx.h"
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ITM.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define ITM_PORT_COUNT				2			/*!< Ports with statistics					*/
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+uint8_t shellLogLevel = SHELL_LOG_LEVEL;
+
+static shellItmStats_t itmStats[ITM_PORT_COUNT];
+
+#if SHELL_LOG_LEVEL > SHELL_LOG_OFF
+static const char* const logPrefix[] = { "", "E: ", "I: ", "D: " };
+#endif
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Checks if a stimulus port takes a write right now
+  * @note	False without a probe: the ITM and the port are enabled by the SWV setup only.
+  * @param[IN]  port Stimulus port (0-31)
+  * @retval bool Returns true if the ITM, the port and a FIFO slot are available
+  */
+bool shellItmReady(uint8_t port) {
+	if ((ITM->TCR & ITM_TCR_ITMENA_Msk) == 0 || (ITM->TER & (1UL << port)) == 0) {
+		return false;
+	}
+	return (ITM->PORT[port].u32 & 1UL) != 0;
+}
+
+/**
+  * @brief  Writes to a stimulus port without waiting
+  * @note	Four bytes per write where possible, one SWO packet instead of four. Whatever does not
+  * 		fit into the FIFO is dropped, the USB and command paths are never held up.
+  * @param[IN]  port Stimulus port (0-31)
+  * @param[IN]  data Bytes to send
+  * @param[IN]  len Number of bytes
+  * @retval uint32_t Bytes written
+  */
+uint32_t shellItmWrite(uint8_t port, const char* data, uint32_t len) {
+	uint32_t done = 0;
+
+	while (done < len && shellItmReady(port)) {
+		if (len - done >= 4) {
+			uint32_t word;
+
+			memcpy(&word, &data[done], sizeof(word));
+			ITM->PORT[port].u32 = word;
+			done += 4;
+		} else {
+			ITM->PORT[port].u8 = (uint8_t)data[done];
+			done++;
+		}
+	}
+
+	if (port < ITM_PORT_COUNT) {
+		itmStats[port].sent += done;
+		itmStats[port].dropped += len - done;
+	}
+	return done;
+}
+
+#if SHELL_LOG_LEVEL > SHELL_LOG_OFF
+/**
+  * @brief  Formats a log message to SHELL_ITM_PORT_LOG
+  * @note	Use SHELL_LOG(), it filters the level first.
+  * @param[IN]  level SHELL_LOG_ERR, SHELL_LOG_INFO or SHELL_LOG_DBG
+  * @param[IN]  format printf format
+  * @retval NONE
+  */
+void shellLogPrintf(uint8_t level, const char* format, ...) {
+	char line[SHELL_LOG_LINE_LEN + 2];
+	va_list args;
+	int len;
+	int formatted;
+
+	// Without a probe the formatting would be wasted as well
+	if (!shellItmReady(SHELL_ITM_PORT_LOG)) {
+		itmStats[SHELL_ITM_PORT_LOG].skipped++;
+		return;
+	}
+
+	strcpy(line, logPrefix[(level <= SHELL_LOG_DBG) ? level : SHELL_LOG_DBG]);
+	len = (int)strlen(line);
+
+	va_start(args, format);
+	formatted = vsnprintf(&line[len], SHELL_LOG_LINE_LEN - len, format, args);
+	va_end(args);
+	if (formatted > 0) {
+		len += formatted;
+	}
+	if (len > SHELL_LOG_LINE_LEN - 1) {
+		len = SHELL_LOG_LINE_LEN - 1;
+	}
+
+	line[len++] = '\r';
+	line[len++] = '\n';
+	shellItmWrite(SHELL_ITM_PORT_LOG, line, (uint32_t)len);
+}
+#endif
+
+/**
+  * @brief  Output counts of a port
+  * @param[IN]  port SHELL_ITM_PORT_STDIO or SHELL_ITM_PORT_LOG
+  * @retval const shellItmStats_t* Statistics, NULL for other ports
+  */
+const shellItmStats_t* shellItmStats(uint8_t port) {
+	return (port < ITM_PORT_COUNT) ? &itmStats[port] : NULL;
+}
+
+/**
+  * @brief  stdout/stderr backend of newlib, replaces the weak one in syscalls.c
+  * @param[IN]  file File descriptor
+  * @param[IN]  ptr Bytes to write
+  * @param[IN]  len Number of bytes
+  * @retval int Bytes consumed, dropped bytes included so printf() never retries
+  */
+int _write(int file, char* ptr, int len) {
+	(void)file;
+
+	shellItmWrite(SHELL_ITM_PORT_STDIO, ptr, (uint32_t)len);
+	return len;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the SWO output state and counts, sets the run time log level (l)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error ItmBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+
+	if (shellHasArg(parserInput, argTkn_l)) {
+		uint8_t level = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_l)).u8;
+		if (level > SHELL_LOG_LEVEL) {
+			return SHELL_ERR;
+		}
+		shellLogLevel = level;
+	}
+
+	shellStrAppend(&str, "ITM: ");
+	shellStrAppend(&str, (ITM->TCR & ITM_TCR_ITMENA_Msk) ? "enabled, ports 0x" : "disabled (no SWV), ports 0x");
+	shellStrAppendHex(&str, ITM->TER, 8);
+	shellStrAppend(&str, ", log level ");
+	shellStrAppendUnsigned(&str, shellLogLevel, 0);
+	shellStrAppend(&str, " of ");
+	shellStrAppendUnsigned(&str, SHELL_LOG_LEVEL, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint8_t port = 0; port < ITM_PORT_COUNT; port++) {
+		shellStrAppend(&str, (port == SHELL_ITM_PORT_STDIO) ? "Port 0 (stdio): " : "Port 1 (log): ");
+		shellStrAppendUnsigned(&str, itmStats[port].sent, 0);
+		shellStrAppend(&str, " bytes, ");
+		shellStrAppendUnsigned(&str, itmStats[port].dropped, 0);
+		shellStrAppend(&str, " dropped");
+		if (port == SHELL_ITM_PORT_LOG) {
+			shellStrAppend(&str, ", ");
+			shellStrAppendUnsigned(&str, itmStats[port].skipped, 0);
+			shellStrAppend(&str, " messages skipped");
+		}
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,98 @@
+/** @file CLI_SHELL_ITM.h
+ *
+ * @brief Debug output of the CLI Shell over the ITM stimulus ports (SWO)
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) SHELL_LOG_LEVEL 0 leaves the printf machinery out
+ *
+ * Usage Notes:
+ *  - printf() and everything else on stdout/stderr goes to stimulus port SHELL_ITM_PORT_STDIO,
+ *    this module replaces the weak _write() of syscalls.c. SHELL_LOG() messages and the USB
+ *    library logs (USBD_UsrLog/ErrLog/DbgLog, usbd_conf.h) go to SHELL_ITM_PORT_LOG. None of
+ *    it uses the CDC ports.
+ *  - The debug probe sets up the SWO pin, the TPIU and the ITM (e.g. the SWV console of
+ *    STM32CubeIDE with the core clock of the active profile). The firmware only checks that the
+ *    ITM and the port are enabled and that the port can take a write, it never waits. Output
+ *    without a probe, or faster than the SWO clock drains the FIFO, is dropped and counted.
+ *  - SHELL_LOG(level, format, ...) formats with vsnprintf() and adds the level prefix and
+ *    "\r\n". Levels above SHELL_LOG_LEVEL are compiled out, field builds keep e.g. the errors
+ *    with -DSHELL_LOG_LEVEL=1. "itm l<level>" lowers or raises the level at run time, up to
+ *    SHELL_LOG_LEVEL. "itm" shows the state and the byte counts.
+ *  - The log is the only user of the printf machinery in the shell, every response and report
+ *    line is built with shellStr_t (CLI_SHELL.h). -DSHELL_LOG_LEVEL=0 compiles SHELL_LOG() and
+ *    shellLogPrintf() out, then newlib's vfprintf is not linked at all.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_ITM_H_
+#define CLI_SHELL_ITM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_ITM_PORT_STDIO		0			/*!< _write(), printf()						*/
+#define SHELL_ITM_PORT_LOG			1			/*!< SHELL_LOG(), USB library logs			*/
+
+#define SHELL_LOG_OFF				0
+#define SHELL_LOG_ERR				1
+#define SHELL_LOG_INFO				2
+#define SHELL_LOG_DBG				3
+
+/**
+  * @brief  Highest level compiled in
+  */
+#ifndef SHELL_LOG_LEVEL
+#define SHELL_LOG_LEVEL				SHELL_LOG_DBG
+#endif
+
+#define SHELL_LOG_LINE_LEN			96			/*!< Longest message, longer ones are cut	*/
+
+/**
+  * @brief  Formats a message to SHELL_ITM_PORT_LOG if level is enabled
+  */
+#if SHELL_LOG_LEVEL > SHELL_LOG_OFF
+#define SHELL_LOG(level, ...) \
+		do { \
+			if ((level) <= SHELL_LOG_LEVEL && (level) <= shellLogLevel) { \
+				shellLogPrintf((level), __VA_ARGS__); \
+			} \
+		} while (0)
+#else
+#define SHELL_LOG(level, ...)		do { } while (0)
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Output counts per port
+  */
+typedef struct {
+	uint32_t sent;							/*!< Bytes written to the stimulus port		*/
+	uint32_t dropped;						/*!< Bytes lost: ITM off or FIFO full		*/
+	uint32_t skipped;						/*!< Log messages not even formatted (no probe)	*/
+} shellItmStats_t;
+
+extern uint8_t shellLogLevel;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellItmReady(uint8_t port);
+uint32_t shellItmWrite(uint8_t port, const char* data, uint32_t len);
+void shellLogPrintf(uint8_t level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+const shellItmStats_t* shellItmStats(uint8_t port);
+
+#endif // CLI_SHELL_ITM_H_
+
+/*** end of file ***/
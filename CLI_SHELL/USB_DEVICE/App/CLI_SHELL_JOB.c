@@ -0,0 +1,232 @@
+/** @file CLI_SHELL_JOB.c
+ *
+ * @brief Long-running (asynchronous) commands of the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Jobs may own the receive ring (ownsInput)
+ * - 1.2: 10-14-2026 (Crandell) Jobs belong to the port that started them
+ * - 1.3: 10-14-2026 (Crandell) Jobs keep their shell instance (job->ctx)
+ * - 1.4: 10-14-2026 (Crandell) Jobs answer with the request tag of their line (job->tag)
+ * - 1.5: 10-15-2026 (Crandell) Job steps are recorded for the response cache (CLI_SHELL_CACHE)
+ * - 1.6: 10-15-2026 (Crandell) Finished jobs send notifyEvt_jobDone (CLI_SHELL_NOTIFY)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_CACHE.h"
+#include "CLI_SHELL_NOTIFY.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellJob_t activeJob;
+static bool jobRunning = false;
+static bool cancelRequested = false;				/*!< Set by "cancel", handled by the next poll	*/
+static shell_error jobStatus = SHELL_OK;			/*!< Result of the last finished job		*/
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void finishJob(responseCode_t code);
+static shell_error sleepJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Ends the running job and sends the response of its command
+  * @param[IN]  code Response code
+  * @retval NONE
+  */
+static void finishJob(responseCode_t code) {
+	shell_ctx_t* ctx = activeJob.ctx;
+
+	jobRunning = false;
+	cancelRequested = false;
+
+	uint8_t seq = shellBinarySetSeq(ctx, activeJob.binarySeq);
+	int32_t tag = ctx->tag;
+
+	ctx->tag = activeJob.tag;
+	shellSendResponse(ctx, code);
+	ctx->tag = tag;
+	shellBinarySetSeq(ctx, seq);
+
+	shellNotify(ctx, notifyEvt_jobDone, (uint32_t)code | ((uint32_t)activeJob.tag << 8));
+}
+
+/**
+  * @brief  Poll function of "sleep"
+  * @param[IN]  job data[0] holds the duration in ms
+  * @retval shell_error SHELL_BUSY until the time is up
+  */
+static shell_error sleepJob(shellJob_t* job) {
+	SHELL_JOB_BEGIN(job);
+	SHELL_JOB_WAIT_UNTIL(job, (HAL_GetTick() - job->startTick) >= job->data[0]);
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts a job for the command being dispatched
+  * @note	Call from a bridge, fill in job->data and return SHELL_BUSY.
+  * @param[IN]  ctx Shell instance of the command
+  * @param[IN]  poll Poll function of the job
+  * @retval shellJob_t* The job, or NULL if a job is already running
+  */
+shellJob_t* shellJobStart(shell_ctx_t* ctx, shellJobPoll_t poll) {
+	if (jobRunning || poll == NULL) {
+		return NULL;
+	}
+
+	memset(&activeJob, 0, sizeof(activeJob));
+	activeJob.poll = poll;
+	activeJob.ctx = ctx;
+	activeJob.startTick = HAL_GetTick();
+	activeJob.binarySeq = shellBinarySeq(ctx);
+	activeJob.tag = ctx->tag;
+
+	jobRunning = true;
+	cancelRequested = false;
+	return &activeJob;
+}
+
+/**
+  * @brief  Cancels the running job
+  * @note	The job gets its final poll and the Cancelled response in the next shellJobPoll().
+  * @param  NONE
+  * @retval bool Returns false if no job is running
+  */
+bool shellJobCancel(void) {
+	if (!jobRunning) {
+		return false;
+	}
+
+	cancelRequested = true;
+	return true;
+}
+
+/**
+  * @brief  Whether a job is running
+  * @param  NONE
+  * @retval bool Returns true while a job is running
+  */
+bool shellJobRunning(void) {
+	return jobRunning;
+}
+
+/**
+  * @brief  Whether the running job consumes the received data of an instance
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns true if command lines must not be read
+  */
+bool shellJobOwnsInput(shell_ctx_t* ctx) {
+	return jobRunning && activeJob.ownsInput && activeJob.ctx == ctx;
+}
+
+/**
+  * @brief  Shell instance of the running job
+  * @param  NONE
+  * @retval shell_ctx_t* The instance that started the job, NULL if none is running
+  */
+shell_ctx_t* shellJobCtx(void) {
+	return jobRunning ? activeJob.ctx : NULL;
+}
+
+/**
+  * @brief  Runs one slice of the job and sends its response once it is done.
+  * @note	Called from checkShellStatus() after the received commands have been handled.
+  * 		Only the instance that started the job advances it.
+  * @param[IN]  ctx Shell instance being polled
+  * @retval NONE
+  */
+void shellJobPoll(shell_ctx_t* ctx) {
+	if (!jobRunning || activeJob.ctx != ctx) {
+		return;
+	}
+
+	uint8_t seq = shellBinarySetSeq(ctx, activeJob.binarySeq);
+
+	if (cancelRequested) {
+		// One last call to clean up, the result does not matter
+		activeJob.cancel = true;
+		activeJob.poll(&activeJob);
+		shellBinarySetSeq(ctx, seq);
+		jobStatus = SHELL_ERR;
+		finishJob(RESPONSE_CANCELLED);
+		return;
+	}
+
+	shellCacheResume(ctx);
+	shell_error status = activeJob.poll(&activeJob);
+	shellCacheHold(ctx);
+	shellBinarySetSeq(ctx, seq);
+
+	if (status == SHELL_BUSY) {
+		return;
+	}
+
+	jobStatus = status;
+	finishJob((status == SHELL_OK) ? RESPONSE_OK : RESPONSE_FNC_ERR);
+}
+
+/**
+  * @brief  Polls the running job until it is done
+  * @note	Used for jobs started inside a batch. Input is not handled meanwhile.
+  * @param  NONE
+  * @retval shell_error Result of the job
+  */
+shell_error shellJobRun(void) {
+	while (jobRunning) {
+		shellJobPoll(activeJob.ctx);
+		transportFlush(activeJob.ctx);
+	}
+	return jobStatus;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Stops the running job
+  * @note	The job's command is answered with a Cancelled response right after this one.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Returns SHELL_ERR if no job is running
+  */
+shell_error CancelBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	return shellJobCancel() ? SHELL_OK : SHELL_ERR;
+}
+
+/**
+  * @brief  Waits without blocking the shell (job example)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (t - time in ms)
+  * @retval shell_error SHELL_BUSY once the job is started
+  */
+shell_error SleepBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	shellJob_t* job = shellJobStart(ctx, sleepJob);
+
+	if (job == NULL) {
+		return SHELL_ERR;
+	}
+
+	job->data[0] = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_t)).u16;
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
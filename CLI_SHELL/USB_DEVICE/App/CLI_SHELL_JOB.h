@@ -0,0 +1,113 @@
+/** @file CLI_SHELL_JOB.h
+ *
+ * @brief Long-running (asynchronous) commands of the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Jobs may own the receive ring (ownsInput)
+ * - 1.2: 10-14-2026 (Crandell) Jobs belong to the port that started them
+ * - 1.3: 10-14-2026 (Crandell) Jobs keep their shell instance (job->ctx)
+ * - 1.4: 10-14-2026 (Crandell) Jobs answer with the request tag of their line (job->tag)
+ *
+ * Usage Notes:
+ *  - A bridge that cannot finish right away starts a job with shellJobStart() and returns
+ *    SHELL_BUSY. No response is sent yet. checkShellStatus() calls the job's poll function
+ *    once per poll until it returns something other than SHELL_BUSY, then sends the response
+ *    (OK or Function Error) for the command.
+ *  - New command lines keep being accepted while the job runs. Only one job runs at a time,
+ *    starting a second one fails with a Function Error, also from the other port.
+ *  - The job's response comes after the responses of the lines accepted meanwhile. A tagged line
+ *    ("#7 trace d1") gets its tag back on that late response (job->tag), so a host pipelining
+ *    tagged lines matches the answers out of order.
+ *  - The job belongs to the shell instance whose command started it (job->ctx). It is polled by
+ *    that instance's checkShellStatus(), and its output and response go back there. Ctrl-C or a
+ *    break only stops it from that instance, "cancel" works from any.
+ *  - "cancel", Ctrl-C or a CDC break stops the job. Its poll function is called one last time with job->cancel set
+ *    so it can clean up, then the command gets a Cancelled response.
+ *  - A poll function should do a bounded slice of work and return. It may stream partial
+ *    results through outputStreamChannel() (use shellOutputReserve() first).
+ *  - State that has to survive between polls belongs in job->data, locals do not.
+ *    SHELL_JOB_BEGIN/YIELD/WAIT_UNTIL/END turn the poll function into a protothread style
+ *    coroutine that resumes where it returned:
+ *
+ *      static shell_error blinkJob(shellJob_t* job) {
+ *          SHELL_JOB_BEGIN(job);
+ *          for (job->data[0] = 0; job->data[0] < 10; job->data[0]++) {
+ *              toggleLed();
+ *              job->data[1] = HAL_GetTick();
+ *              SHELL_JOB_WAIT_UNTIL(job, (HAL_GetTick() - job->data[1]) >= 100);
+ *          }
+ *          SHELL_JOB_END(job);
+ *      }
+ *
+ *  - Inside a batch a job is run to completion before the next entry, so the batch stays in order.
+ *  - A job that sets job->ownsInput consumes the receive ring of its port itself. Commands are
+ *    not read there until it ends, only a CDC break, "cancel" from another instance or a timeout
+ *    of the job's own stops it.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_JOB_H_
+#define CLI_SHELL_JOB_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_JOB_DATA_WORDS			4		/*!< Words of job->data				*/
+
+/**
+  * @brief  Coroutine helpers for job poll functions. Do not use switch statements between BEGIN and END.
+  */
+#define SHELL_JOB_BEGIN(job)				switch ((job)->state) { case 0:
+#define SHELL_JOB_YIELD(job)				do { (job)->state = __LINE__; return SHELL_BUSY; case __LINE__:; } while (0)
+#define SHELL_JOB_WAIT_UNTIL(job, cond)		do { (job)->state = __LINE__; case __LINE__: if (!(cond)) { return SHELL_BUSY; } } while (0)
+#define SHELL_JOB_END(job)					} (job)->state = 0; return SHELL_OK
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellJobTypeDef shellJob_t;
+
+// Poll function of a job. Returns SHELL_BUSY while the job is still running.
+typedef shell_error(*shellJobPoll_t)(shellJob_t*);
+
+/**
+  * @brief  The running job
+  */
+struct shellJobTypeDef {
+	shellJobPoll_t poll;					/*!< Called once per checkShellStatus()		*/
+	uint16_t state;							/*!< Resume point (SHELL_JOB_ macros), 0 at start	*/
+	bool cancel;							/*!< Set for the final poll after "cancel"	*/
+	bool ownsInput;							/*!< Job reads the receive ring itself, no command lines meanwhile	*/
+	shell_ctx_t* ctx;						/*!< Shell instance the job was started from	*/
+	uint8_t binarySeq;						/*!< Binary request the job answers			*/
+	int32_t tag;							/*!< Request tag the job answers, SHELL_NO_TAG without	*/
+	uint32_t startTick;						/*!< HAL_GetTick() when the job started		*/
+	uint32_t data[SHELL_JOB_DATA_WORDS];	/*!< Job state kept between polls			*/
+};
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+shellJob_t* shellJobStart(shell_ctx_t* ctx, shellJobPoll_t poll);
+bool shellJobCancel(void);
+bool shellJobRunning(void);
+bool shellJobOwnsInput(shell_ctx_t* ctx);
+shell_ctx_t* shellJobCtx(void);
+void shellJobPoll(shell_ctx_t* ctx);
+shell_error shellJobRun(void);
+
+#endif // CLI_SHELL_JOB_H_
+
+/*** end of file ***/
@@ -0,0 +1,668 @@
+/** @file CLI_SHELL_KV.c
+ *
+ * @brief Persistent key/value settings of the CLI Shell, a log in two flash sectors
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Compaction erase through the flash queue
+ * - 1.2: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_FLASH.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_KV.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define KV_ALIGN(len)			(((len) + 3U) & ~3U)
+#define KV_LIVE					0xFF		/*!< flags of a setting			*/
+#define KV_DELETED				0x00		/*!< flags of a deleted key		*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Header at the start of a log sector. Written last when a sector is compacted into.
+  */
+typedef struct {
+	uint32_t magic;							/*!< SHELL_KV_SECTOR_MAGIC					*/
+	uint32_t sequence;						/*!< The valid sector with the highest one is active	*/
+} kvSectorHeader_t;
+
+/**
+  * @brief  Record of the log, followed by the key and the value, padded to a word
+  */
+typedef struct {
+	uint16_t magic;							/*!< SHELL_KV_RECORD_MAGIC, 0xFFFF ends the log	*/
+	uint8_t keyLen;
+	uint8_t valueLen;
+	uint16_t crc;							/*!< CRC16 of lengths, flags, key and value	*/
+	uint8_t flags;							/*!< KV_LIVE or KV_DELETED					*/
+	uint8_t reserved;
+} kvRecord_t;
+
+/**
+  * @brief  RAM index entry, the newest record of a key
+  */
+typedef struct {
+	uint16_t hash;
+	const kvRecord_t* record;				/*!< NULL if the slot is free				*/
+} kvIndex_t;
+
+/**
+  * @brief  Compaction steps
+  */
+typedef enum {
+	kvCompact_idle,
+	kvCompact_erase,
+	kvCompact_eraseWait,
+	kvCompact_copy,
+	kvCompact_seal
+} kvCompactState_t;
+
+/**
+  * @brief  One log sector
+  */
+typedef struct {
+	uint32_t sector;						/*!< FLASH_SECTOR_ number					*/
+	uint32_t address;
+} kvSector_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const kvSector_t kvSectors[2] = {
+	{ SHELL_FLASH_KV_SECTOR_A, SHELL_FLASH_KV_ADDR_A },
+	{ SHELL_FLASH_KV_SECTOR_B, SHELL_FLASH_KV_ADDR_B },
+};
+
+static struct {
+	bool mounted;
+	uint8_t active;							/*!< kvSectors index of the active sector	*/
+	uint32_t sequence;						/*!< Sequence number of the active sector	*/
+	uint32_t logEnd;						/*!< First free byte of the active sector	*/
+	uint8_t keys;							/*!< Used index slots						*/
+	kvIndex_t index[SHELL_KV_INDEX_SIZE];
+
+	kvCompactState_t compact;
+	bool compactFailed;
+	uint8_t copyIndex;						/*!< Next index slot to copy				*/
+	uint32_t writePos;						/*!< Next free byte of the target sector	*/
+} kv;
+
+// Setting of a "set" waiting for its compaction, the command line is reused meanwhile
+static struct {
+	char key[SHELL_KV_KEY_LEN + 1];
+	uint8_t value[SHELL_KV_VALUE_LEN];
+	uint8_t valueLen;
+	bool remove;
+} kvPending;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint16_t kvHash(const char* key, uint8_t keyLen);
+static uint16_t kvRecordCrc(const kvRecord_t* record, const uint8_t* data);
+static uint32_t kvRecordSize(const kvRecord_t* record);
+static kvIndex_t* kvFind(const char* key, uint8_t keyLen, bool insert);
+static void kvScan(void);
+static void kvMount(void);
+static bool kvUnchanged(const char* key, uint8_t keyLen, const void* value, uint8_t length);
+static bool kvNeedsCompaction(const char* key, uint8_t keyLen, uint8_t valueLen);
+static void kvCompactStart(void);
+static void kvEraseDone(bool ok, void* context);
+static bool kvCompactStep(void);
+static bool kvWrite(const char* key, const void* value, uint8_t length, uint8_t flags);
+static void kvPrint(shell_ctx_t* ctx, const kvRecord_t* record);
+static shell_error kvSetJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  FNV-1a hash of a key, folded to 16 bits
+  * @param[IN]  key Key characters
+  * @param[IN]  keyLen Number of characters
+  * @retval uint16_t Hash
+  */
+static uint16_t kvHash(const char* key, uint8_t keyLen) {
+	uint32_t hash = 2166136261U;
+
+	for (uint8_t i = 0; i < keyLen; i++) {
+		hash = (hash ^ (uint8_t)key[i]) * 16777619U;
+	}
+	return (uint16_t)(hash ^ (hash >> 16));
+}
+
+/**
+  * @brief  CRC of a record
+  * @param[IN]  record Record header
+  * @param[IN]  data Key followed by the value
+  * @retval uint16_t CRC16 of the lengths, the flags and the data
+  */
+static uint16_t kvRecordCrc(const kvRecord_t* record, const uint8_t* data) {
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &record->keyLen, 2);
+
+	crc = shellCrc16(crc, &record->flags, 1);
+	return shellCrc16(crc, data, record->keyLen + record->valueLen);
+}
+
+/**
+  * @brief  Bytes a record takes in the log
+  * @param[IN]  record Record header
+  * @retval uint32_t Size including the padding
+  */
+static uint32_t kvRecordSize(const kvRecord_t* record) {
+	return sizeof(kvRecord_t) + KV_ALIGN(record->keyLen + record->valueLen);
+}
+
+/**
+  * @brief  Looks a key up in the RAM index
+  * @note	Open addressing with linear probing. Slots are only freed by a rescan, so a probe
+  * 		ends at the first free slot.
+  * @param[IN]  key Key characters
+  * @param[IN]  keyLen Number of characters
+  * @param[IN]  insert Return a free slot if the key is not indexed yet
+  * @retval kvIndex_t* Slot of the key (record NULL if free), NULL if not found
+  */
+static kvIndex_t* kvFind(const char* key, uint8_t keyLen, bool insert) {
+	uint16_t hash = kvHash(key, keyLen);
+
+	for (uint16_t probe = 0; probe < SHELL_KV_INDEX_SIZE; probe++) {
+		kvIndex_t* entry = &kv.index[(hash + probe) & (SHELL_KV_INDEX_SIZE - 1)];
+
+		if (entry->record == NULL) {
+			if (!insert || kv.keys >= SHELL_KV_MAX_KEYS) {
+				return NULL;
+			}
+			entry->hash = hash;
+			return entry;
+		}
+		if (entry->hash == hash && entry->record->keyLen == keyLen
+				&& memcmp((const uint8_t*)(entry->record + 1), key, keyLen) == 0) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/**
+  * @brief  Rebuilds the RAM index and finds the end of the active sector
+  * @note	Records with a bad CRC (interrupted writes) are skipped. Anything that is not a
+  * 		record header ends the log. Keys past SHELL_KV_MAX_KEYS are not indexed, the next
+  * 		write compacts them away.
+  * @param  NONE
+  * @retval NONE
+  */
+static void kvScan(void) {
+	uint32_t end = kvSectors[kv.active].address + SHELL_FLASH_KV_SIZE;
+	uint32_t pos = kvSectors[kv.active].address + sizeof(kvSectorHeader_t);
+
+	memset(kv.index, 0, sizeof(kv.index));
+	kv.keys = 0;
+
+	while ((end - pos) >= sizeof(kvRecord_t)) {
+		const kvRecord_t* record = (const kvRecord_t*)pos;
+		const uint8_t* data = (const uint8_t*)(record + 1);
+
+		if (record->magic != SHELL_KV_RECORD_MAGIC || record->keyLen == 0 || record->keyLen > SHELL_KV_KEY_LEN
+				|| record->valueLen > SHELL_KV_VALUE_LEN || kvRecordSize(record) > (end - pos)) {
+			break;
+		}
+
+		if (kvRecordCrc(record, data) == record->crc) {
+			kvIndex_t* entry = kvFind((const char*)data, record->keyLen, true);
+
+			if (entry != NULL) {
+				if (entry->record == NULL) {
+					kv.keys++;
+				}
+				entry->record = record;
+			}
+		}
+		pos += kvRecordSize(record);
+	}
+
+	kv.logEnd = pos;
+}
+
+/**
+  * @brief  Picks the active sector and builds the index
+  * @note	Without a valid sector (first start) sector A is erased and sealed.
+  * @param  NONE
+  * @retval NONE
+  */
+static void kvMount(void) {
+	uint32_t sequence[2] = {0, 0};
+
+	for (uint8_t i = 0; i < 2; i++) {
+		const kvSectorHeader_t* header = (const kvSectorHeader_t*)kvSectors[i].address;
+
+		if (header->magic == SHELL_KV_SECTOR_MAGIC && header->sequence != 0xFFFFFFFFU) {
+			sequence[i] = header->sequence;
+		}
+	}
+
+	kv.active = (sequence[1] > sequence[0]) ? 1 : 0;
+	kv.sequence = sequence[kv.active];
+
+	if (kv.sequence == 0) {
+		kvSectorHeader_t header = { SHELL_KV_SECTOR_MAGIC, 1 };
+
+		if (!shellFlashBlank(kvSectors[0].address, SHELL_FLASH_KV_SIZE)) {
+			shellFlashErase(kvSectors[0].sector);
+		}
+		shellFlashProgram(kvSectors[0].address, &header, sizeof(header));
+		kv.sequence = 1;
+	}
+
+	kvScan();
+	kv.mounted = true;
+}
+
+/**
+  * @brief  Checks whether a key already has a value
+  * @param[IN]  key Key characters
+  * @param[IN]  keyLen Number of characters
+  * @param[IN]  value Value bytes
+  * @param[IN]  length Bytes of the value
+  * @retval bool Returns true if storing the value would change nothing
+  */
+static bool kvUnchanged(const char* key, uint8_t keyLen, const void* value, uint8_t length) {
+	kvIndex_t* entry = kvFind(key, keyLen, false);
+
+	return entry != NULL && entry->record != NULL && entry->record->flags == KV_LIVE && entry->record->valueLen == length
+			&& memcmp((const uint8_t*)(entry->record + 1) + keyLen, value, length) == 0;
+}
+
+/**
+  * @brief  Checks whether a write has to wait for a compaction
+  * @param[IN]  key Key characters
+  * @param[IN]  keyLen Number of characters
+  * @param[IN]  valueLen Bytes of the value
+  * @retval bool Returns true if the log or the index is full, or a compaction is running
+  */
+static bool kvNeedsCompaction(const char* key, uint8_t keyLen, uint8_t valueLen) {
+	uint32_t end = kvSectors[kv.active].address + SHELL_FLASH_KV_SIZE;
+	uint32_t size = sizeof(kvRecord_t) + KV_ALIGN(keyLen + valueLen);
+	kvIndex_t* entry = kvFind(key, keyLen, true);
+
+	return (kv.compact != kvCompact_idle) || entry == NULL || size > (end - kv.logEnd)
+			|| !shellFlashBlank(kv.logEnd, size);
+}
+
+/**
+  * @brief  Starts compacting the active sector into the other one
+  * @param  NONE
+  * @retval NONE
+  */
+static void kvCompactStart(void) {
+	if (kv.compact == kvCompact_idle) {
+		kv.compact = kvCompact_erase;
+		kv.compactFailed = false;
+	}
+}
+
+/**
+  * @brief  End of the target sector erase, starts copying
+  * @param[IN]  ok Result of the erase
+  * @param[IN]  context Unused
+  * @retval NONE
+  */
+static void kvEraseDone(bool ok, void* context) {
+	if (!ok) {
+		kv.compactFailed = true;
+		kv.compact = kvCompact_idle;
+		return;
+	}
+	kv.copyIndex = 0;
+	kv.writePos = kvSectors[kv.active ^ 1].address + sizeof(kvSectorHeader_t);
+	kv.compact = kvCompact_copy;
+}
+
+/**
+  * @brief  Runs one step of the compaction
+  * @note	A step either queues the erase of the target sector (CLI_SHELL_FLASH.h) and waits for
+  * 		it, or copies up to SHELL_KV_COPY_PER_POLL records. The index keeps pointing at the old
+  * 		sector until the seal.
+  * @param  NONE
+  * @retval bool Returns true once no compaction is running (check kv.compactFailed)
+  */
+static bool kvCompactStep(void) {
+	const kvSector_t* target = &kvSectors[kv.active ^ 1];
+
+	switch (kv.compact) {
+	case kvCompact_erase:
+		if (shellFlashBlank(target->address, SHELL_FLASH_KV_SIZE)) {
+			kvEraseDone(true, NULL);
+		} else if (shellFlashQueueErase(target->sector, kvEraseDone, NULL)) {
+			kv.compact = kvCompact_eraseWait;
+		} else {
+			kvEraseDone(shellFlashErase(target->sector), NULL);
+		}
+		return (kv.compact == kvCompact_idle);
+
+	case kvCompact_eraseWait:
+		// kvEraseDone() moves on
+		shellFlashPoll();
+		return (kv.compact == kvCompact_idle);
+
+	case kvCompact_copy:
+		for (uint8_t copied = 0; copied < SHELL_KV_COPY_PER_POLL && kv.copyIndex < SHELL_KV_INDEX_SIZE; kv.copyIndex++) {
+			const kvRecord_t* record = kv.index[kv.copyIndex].record;
+
+			if (record == NULL || record->flags != KV_LIVE) {
+				continue;
+			}
+			if (!shellFlashProgram(kv.writePos, record, kvRecordSize(record))) {
+				kv.compactFailed = true;
+				kv.compact = kvCompact_idle;
+				return true;
+			}
+			kv.writePos += kvRecordSize(record);
+			copied++;
+		}
+		if (kv.copyIndex >= SHELL_KV_INDEX_SIZE) {
+			kv.compact = kvCompact_seal;
+		}
+		return false;
+
+	case kvCompact_seal: {
+		kvSectorHeader_t header = { SHELL_KV_SECTOR_MAGIC, kv.sequence + 1 };
+
+		kv.compact = kvCompact_idle;
+		if (!shellFlashProgram(target->address, &header, sizeof(header))) {
+			kv.compactFailed = true;
+			return true;
+		}
+		kv.active ^= 1;
+		kv.sequence++;
+		kvScan();
+		return true;
+	}
+
+	default:
+		return true;
+	}
+}
+
+/**
+  * @brief  Appends a record, compacting first if needed
+  * @param[IN]  key NUL-terminated key
+  * @param[IN]  value Value bytes
+  * @param[IN]  length Bytes of the value
+  * @param[IN]  flags KV_LIVE or KV_DELETED
+  * @retval bool Returns false if the record could not be written
+  */
+static bool kvWrite(const char* key, const void* value, uint8_t length, uint8_t flags) {
+	uint32_t buffer[(sizeof(kvRecord_t) + SHELL_KV_KEY_LEN + SHELL_KV_VALUE_LEN + 3) / 4];
+	kvRecord_t* record = (kvRecord_t*)buffer;
+	uint8_t* data = (uint8_t*)(record + 1);
+	size_t keyLen = strlen(key);
+
+	if (keyLen == 0 || keyLen > SHELL_KV_KEY_LEN || length > SHELL_KV_VALUE_LEN) {
+		return false;
+	}
+
+	if (kvNeedsCompaction(key, keyLen, length)) {
+		kvCompactStart();
+		while (!kvCompactStep()) {
+		}
+		if (kv.compactFailed || kvNeedsCompaction(key, keyLen, length)) {
+			return false;
+		}
+	}
+
+	memset(buffer, 0xFF, sizeof(buffer));
+	record->magic = SHELL_KV_RECORD_MAGIC;
+	record->keyLen = keyLen;
+	record->valueLen = length;
+	record->flags = flags;
+	record->reserved = 0xFF;
+	memcpy(data, key, keyLen);
+	if (length != 0) {
+		memcpy(&data[keyLen], value, length);
+	}
+	record->crc = kvRecordCrc(record, data);
+
+	uint32_t size = kvRecordSize(record);
+	if (!shellFlashProgram(kv.logEnd, record, size)) {
+		// Whatever was written ends the log, the next write compacts
+		kvScan();
+		return false;
+	}
+
+	kvIndex_t* entry = kvFind(key, keyLen, true);
+	if (entry->record == NULL) {
+		kv.keys++;
+	}
+	entry->record = (const kvRecord_t*)kv.logEnd;
+	kv.logEnd += size;
+	return true;
+}
+
+/**
+  * @brief  Prints one setting, "<key> = <value>"
+  * @note	Printable values are shown as text, others as hex bytes.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  record Record of the setting
+  * @retval NONE
+  */
+static void kvPrint(shell_ctx_t* ctx, const kvRecord_t* record) {
+	const char* data = (const char*)(record + 1);
+	SHELL_STR_DEFINE(str, SHELL_KV_KEY_LEN + 6 + SHELL_KV_VALUE_LEN * 2 + 3);
+	bool text = true;
+
+	for (uint8_t i = 0; i < record->valueLen; i++) {
+		text = text && isprint((unsigned char)data[record->keyLen + i]);
+	}
+
+	shellStrAppendN(&str, data, record->keyLen);
+	shellStrAppend(&str, " = ");
+	if (text) {
+		shellStrAppendN(&str, &data[record->keyLen], record->valueLen);
+	} else {
+		shellStrAppend(&str, "0x");
+		for (uint8_t i = 0; i < record->valueLen; i++) {
+			shellStrAppendHex(&str, (uint8_t)data[record->keyLen + i], 2);
+		}
+	}
+	shellStrAppend(&str, "\r\n");
+
+	if (shellOutputReserve(ctx, str.len)) {
+		shellStrSend(ctx, &str);
+	}
+}
+
+/**
+  * @brief  Poll function of a "set" that waits for a compaction
+  * @param[IN]  job The set job
+  * @retval shell_error SHELL_BUSY while compacting
+  */
+static shell_error kvSetJob(shellJob_t* job) {
+	if (job->cancel) {
+		// The compaction goes on with the next write
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	SHELL_JOB_WAIT_UNTIL(job, kvCompactStep());
+	bool ok = kvPending.remove ? shellKvDelete(kvPending.key)
+			: shellKvSet(kvPending.key, kvPending.value, kvPending.valueLen);
+	if (!ok) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stores a setting
+  * @note	Blocks for a whole compaction (one sector erase) if the log is full.
+  * @param[IN]  key NUL-terminated key, up to SHELL_KV_KEY_LEN characters
+  * @param[IN]  value Value bytes
+  * @param[IN]  length Bytes of the value, up to SHELL_KV_VALUE_LEN
+  * @retval bool Returns false if the setting could not be stored
+  */
+bool shellKvSet(const char* key, const void* value, uint8_t length) {
+	if (!kv.mounted) {
+		kvMount();
+	}
+
+	// Nothing to write if the value does not change
+	if (kvUnchanged(key, strlen(key), value, length)) {
+		return true;
+	}
+
+	return kvWrite(key, value, length, KV_LIVE);
+}
+
+/**
+  * @brief  Reads a setting
+  * @param[IN]  key NUL-terminated key
+  * @param[OUT]  value Receives the value
+  * @param[IN]  size Size of the value buffer
+  * @retval int16_t Length of the value, -1 if the key is not set or the value does not fit
+  */
+int16_t shellKvGet(const char* key, void* value, uint8_t size) {
+	if (!kv.mounted) {
+		kvMount();
+	}
+
+	kvIndex_t* entry = kvFind(key, strlen(key), false);
+	if (entry == NULL || entry->record == NULL || entry->record->flags != KV_LIVE || entry->record->valueLen > size) {
+		return -1;
+	}
+
+	memcpy(value, (const uint8_t*)(entry->record + 1) + entry->record->keyLen, entry->record->valueLen);
+	return entry->record->valueLen;
+}
+
+/**
+  * @brief  Deletes a setting
+  * @param[IN]  key NUL-terminated key
+  * @retval bool Returns false if the deletion could not be stored
+  */
+bool shellKvDelete(const char* key) {
+	if (!kv.mounted) {
+		kvMount();
+	}
+
+	kvIndex_t* entry = kvFind(key, strlen(key), false);
+	if (entry == NULL || entry->record == NULL || entry->record->flags != KV_LIVE) {
+		return true;
+	}
+
+	return kvWrite(key, NULL, 0, KV_DELETED);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Prints one setting, or lists all of them with the log usage
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error GetBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+
+	if (!kv.mounted) {
+		kvMount();
+	}
+
+	if (shellHasArg(parserInput, argTkn_k)) {
+		const char* key = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_k)).str;
+		kvIndex_t* entry = kvFind(key, strlen(key), false);
+
+		if (entry == NULL || entry->record == NULL || entry->record->flags != KV_LIVE) {
+			return SHELL_ERR;
+		}
+		kvPrint(ctx, entry->record);
+		return SHELL_OK;
+	}
+
+	for (uint8_t i = 0; i < SHELL_KV_INDEX_SIZE; i++) {
+		const kvRecord_t* record = kv.index[i].record;
+
+		if (record != NULL && record->flags == KV_LIVE) {
+			kvPrint(ctx, record);
+		}
+	}
+
+	shellStrAppend(&str, "KV: ");
+	shellStrAppendUnsigned(&str, kv.logEnd - kvSectors[kv.active].address, 0);
+	shellStrAppend(&str, " of ");
+	shellStrAppendUnsigned(&str, SHELL_FLASH_KV_SIZE, 0);
+	shellStrAppend(&str, " bytes, sector ");
+	shellStrAppendUnsigned(&str, kvSectors[kv.active].sector, 0);
+	shellStrAppend(&str, ", sequence ");
+	shellStrAppendUnsigned(&str, kv.sequence, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Stores or deletes a setting
+  * @note	A write that needs a compaction runs it as a job, so USB keeps being served between
+  * 		the steps.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while compacting
+  */
+shell_error SetBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	const char* key = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_k)).str;
+	bool remove = !shellHasArg(parserInput, argTkn_v);
+	const char* value = remove ? "" : shellArgValue(parserInput, shellFindArg(parserInput, argTkn_v)).str;
+	size_t keyLen = strlen(key);
+	size_t valueLen = strlen(value);
+
+	if (keyLen == 0 || keyLen > SHELL_KV_KEY_LEN || valueLen > SHELL_KV_VALUE_LEN) {
+		return SHELL_ERR;
+	}
+
+	if (!kv.mounted) {
+		kvMount();
+	}
+
+	if (shellJobRunning() || (!remove && kvUnchanged(key, keyLen, value, valueLen))
+			|| !kvNeedsCompaction(key, keyLen, valueLen)) {
+		bool ok = remove ? shellKvDelete(key) : shellKvSet(key, value, valueLen);
+		return ok ? SHELL_OK : SHELL_ERR;
+	}
+
+	if (shellJobStart(ctx, kvSetJob) == NULL) {
+		return SHELL_ERR;
+	}
+
+	memcpy(kvPending.key, key, keyLen + 1);
+	memcpy(kvPending.value, value, valueLen);
+	kvPending.valueLen = valueLen;
+	kvPending.remove = remove;
+	kvCompactStart();
+
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
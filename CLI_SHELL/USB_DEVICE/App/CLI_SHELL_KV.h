@@ -0,0 +1,66 @@
+/** @file CLI_SHELL_KV.h
+ *
+ * @brief Persistent key/value settings of the CLI Shell, a log in two flash sectors
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Compaction erase through the flash queue
+ *
+ * Usage Notes:
+ *  - "set k<key> v<value>" stores a setting, "set k<key>" without v deletes it. "get k<key>"
+ *    prints one setting, "get" alone lists them with the log usage. Values from the command line
+ *    are text, shellKvSet() takes any bytes (listed as hex).
+ *  - Settings are appended to a log in one of the 16 KB flash sectors 1 and 2 (CLI_SHELL_FLASH.h),
+ *    the newest record of a key wins. Changing a setting writes a few words, no erase. Setting
+ *    the value a key already has writes nothing.
+ *  - A RAM index (hash of the key -> newest record) makes shellKvGet() a single lookup, the log
+ *    is only scanned when the store is mounted or after a compaction.
+ *  - A full log is compacted into the other sector: erase it, copy the live settings, then seal
+ *    it with a higher sequence number. The old sector stays valid until the seal, a reset in
+ *    between loses nothing. The sectors take turns, so they wear evenly.
+ *  - "set" runs the compaction as a job (CLI_SHELL_JOB.h), one step per poll: queueing the erase
+ *    of one 16 KB sector (about 250 ms, the longest flash stall) and waiting for it, or copying
+ *    SHELL_KV_COPY_PER_POLL records. shellKvSet() from C code compacts in one go.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_KV_H_
+#define CLI_SHELL_KV_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_KV_KEY_LEN				15			/*!< Longest key						*/
+#define SHELL_KV_VALUE_LEN				32			/*!< Longest value						*/
+#define SHELL_KV_MAX_KEYS				32			/*!< Keys in the RAM index				*/
+#define SHELL_KV_INDEX_SIZE				64			/*!< Hash slots, a power of 2			*/
+
+#define SHELL_KV_RECORD_MAGIC			0x4B56		/*!< Record header of the log			*/
+#define SHELL_KV_SECTOR_MAGIC			0x31564B53U	/*!< Sector header of the log ("SKV1")		*/
+
+/**
+  * @brief  Records copied per compaction step at most
+  */
+#ifndef SHELL_KV_COPY_PER_POLL
+#define SHELL_KV_COPY_PER_POLL			4
+#endif
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellKvSet(const char* key, const void* value, uint8_t length);
+int16_t shellKvGet(const char* key, void* value, uint8_t size);
+bool shellKvDelete(const char* key);
+
+#endif // CLI_SHELL_KV_H_
+
+/*** end of file ***/
@@ -0,0 +1,239 @@
+/** @file CLI_SHELL_LOAD.c
+ *
+ * @brief CPU load of the CLI Shell main loop: idle cycle accounting and pass timing, "load"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Short windows for the clock governor (CLI_SHELL_CLOCK)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "stm32f4xx.h"
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_LOAD.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_RESULT.h"
+#include "CLI_SHELL_CLOCK.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct {
+	uint32_t windowTick;					/*!< HAL tick of the window start			*/
+	uint32_t windowCycles;					/*!< Cycle count of the window start		*/
+	uint32_t idleCycles;					/*!< Idle in the current window				*/
+	uint32_t sleepCycles;					/*!< Slept since the last pass start		*/
+	uint32_t passCycles;					/*!< Cycle count of the last pass start		*/
+	uint32_t passEvents;					/*!< Events the last pass took				*/
+	bool started;							/*!< A pass has been seen					*/
+	uint16_t samples[SHELL_LOAD_SAMPLES];	/*!< Busy per mille, ring					*/
+	uint8_t head;							/*!< Next sample							*/
+	uint8_t count;							/*!< Samples collected, up to SHELL_LOAD_SAMPLES	*/
+	uint32_t periodMin;						/*!< Cycles between pass starts				*/
+	uint32_t periodMax;
+	uint32_t rxMax;							/*!< Receive event to pass, cycles			*/
+	uint32_t govTick;						/*!< Governor window: HAL tick of the start	*/
+	uint32_t govCycles;						/*!< Cycle count of the start				*/
+	uint32_t govIdle;						/*!< Idle in the governor window			*/
+} shellLoad_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellLoad_t load = { .periodMin = UINT32_MAX };
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void closeWindow(uint32_t now, uint32_t tick);
+static uint32_t average(uint8_t samples);
+static uint16_t busyShare(uint32_t idle, uint32_t total);
+static uint32_t cyclesToUs(uint32_t cycles);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stores the busy share of the window that ends now, once per window it spanned
+  * @param[IN]  now Cycle count
+  * @param[IN]  tick HAL tick
+  * @retval NONE
+  */
+static void closeWindow(uint32_t now, uint32_t tick) {
+	uint32_t total = now - load.windowCycles;
+	uint32_t windows = (tick - load.windowTick) / SHELL_LOAD_WINDOW_MS;
+	uint16_t busy = busyShare(load.idleCycles, total);
+
+	if (windows > SHELL_LOAD_SAMPLES) {
+		windows = SHELL_LOAD_SAMPLES;
+	}
+	for (uint32_t i = 0; i < windows; i++) {
+		load.samples[load.head] = busy;
+		load.head = (uint8_t)((load.head + 1U) % SHELL_LOAD_SAMPLES);
+		if (load.count < SHELL_LOAD_SAMPLES) {
+			load.count++;
+		}
+	}
+
+	load.windowTick = tick;
+	load.windowCycles = now;
+	load.idleCycles = 0;
+}
+
+/**
+  * @brief  Busy share of a span
+  * @param[IN]  idle Idle cycles within the span
+  * @param[IN]  total Cycles of the span
+  * @retval uint16_t Busy per mille
+  */
+static uint16_t busyShare(uint32_t idle, uint32_t total) {
+	if (total == 0) {
+		return 0;
+	}
+	if (idle > total) {
+		idle = total;
+	}
+	return (uint16_t)(1000U - (uint32_t)(((uint64_t)idle * 1000U) / total));
+}
+
+/**
+  * @brief  Mean of the newest samples
+  * @param[IN]  samples Samples to average, fewer if not collected yet
+  * @retval uint32_t Busy per mille
+  */
+static uint32_t average(uint8_t samples) {
+	uint32_t sum = 0;
+
+	if (samples > load.count) {
+		samples = load.count;
+	}
+	if (samples == 0) {
+		return 0;
+	}
+	for (uint8_t i = 1; i <= samples; i++) {
+		sum += load.samples[(load.head + SHELL_LOAD_SAMPLES - i) % SHELL_LOAD_SAMPLES];
+	}
+	return sum / samples;
+}
+
+/**
+  * @brief  Converts core cycles to microseconds at the current clock
+  * @param[IN]  cycles Cycles
+  * @retval uint32_t Microseconds
+  */
+static uint32_t cyclesToUs(uint32_t cycles) {
+	return (uint32_t)(((uint64_t)cycles * 1000000ULL) / SystemCoreClock);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Adds sleep time, called by shellEventWait() after the WFI or the task wait
+  * @param[IN]  cycles Cycles slept
+  * @retval NONE
+  */
+void shellLoadIdle(uint32_t cycles) {
+	load.sleepCycles += cycles;
+}
+
+/**
+  * @brief  Accounts the pass that ended and starts the next, called by shellEventTake()
+  * @note	A pass that took no event was idle as a whole, otherwise only its sleep was. Every
+  * 		SHELL_CLOCK_GOV_WINDOW_MS the busy share goes to the clock governor as well.
+  * @param[IN]  events SHELL_EVENT_ bits the new pass takes
+  * @param[IN]  rxLatency Cycles from the receive event to now, 0 without one
+  * @retval NONE
+  */
+void shellLoadPass(uint32_t events, uint32_t rxLatency) {
+	uint32_t now = shellPerfCycles();
+	uint32_t tick = HAL_GetTick();
+
+	if (!load.started) {
+		load.started = true;
+		load.windowTick = tick;
+		load.windowCycles = now;
+		load.govTick = tick;
+		load.govCycles = now;
+	} else {
+		uint32_t period = now - load.passCycles;
+		uint32_t idle = (load.passEvents == 0) ? period : load.sleepCycles;
+
+		load.idleCycles += idle;
+		load.govIdle += idle;
+		if (period < load.periodMin) {
+			load.periodMin = period;
+		}
+		if (period > load.periodMax) {
+			load.periodMax = period;
+		}
+	}
+	if (rxLatency > load.rxMax) {
+		load.rxMax = rxLatency;
+	}
+
+	load.passCycles = now;
+	load.passEvents = events;
+	load.sleepCycles = 0;
+
+	if (tick - load.govTick >= SHELL_CLOCK_GOV_WINDOW_MS) {
+		uint16_t busy = busyShare(load.govIdle, now - load.govCycles);
+
+		load.govTick = tick;
+		load.govCycles = now;
+		load.govIdle = 0;
+		shellClockGovern(busy);
+	}
+	if (tick - load.windowTick >= SHELL_LOAD_WINDOW_MS) {
+		closeWindow(now, tick);
+	}
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the busy share over 1, 10 and 60 s, the pass period and receive latency (r1 resets)
+  * @note	The reset keeps the samples, only the minimum and maximum values start over.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error LoadBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_RESULT_DEFINE(res, ctx, 64);
+
+	shellResultGroup(&res, "busy");
+	shellResultUnsigned(&res, "1s", average(1));
+	shellResultUnsigned(&res, "10s", average(10));
+	shellResultUnsigned(&res, "60s", average(60));
+	shellResultClose(&res);
+	shellResultUnsigned(&res, "samples", load.count);
+
+	shellResultGroup(&res, "period");
+	shellResultUnsigned(&res, "min", (load.periodMin == UINT32_MAX) ? 0 : cyclesToUs(load.periodMin));
+	shellResultUnsigned(&res, "max", cyclesToUs(load.periodMax));
+	shellResultClose(&res);
+
+	shellResultGroup(&res, "rx");
+	shellResultUnsigned(&res, "max", cyclesToUs(load.rxMax));
+	shellResultEnd(&res);
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+		load.periodMin = UINT32_MAX;
+		load.periodMax = 0;
+		load.rxMax = 0;
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
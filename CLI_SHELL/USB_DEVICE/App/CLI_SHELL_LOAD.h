@@ -0,0 +1,64 @@
+/** @file CLI_SHELL_LOAD.h
+ *
+ * @brief CPU load of the CLI Shell main loop: idle cycle accounting and pass timing, "load"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Short windows for the clock governor (CLI_SHELL_CLOCK.h)
+ *
+ * Usage Notes:
+ *  - shellEventWait() and shellEventTake() (CLI_SHELL_EVENT.c) feed the accounting, DWT CYCCNT
+ *    (shellPerfCycles()) measures. Idle is:
+ *      - the cycles in the WFI (or blocked in shellRtosWait() with SHELL_RTOS_ENABLED),
+ *      - a whole pass that took no event ("idle w0" polling, a SysTick wake-up). It only
+ *        polled, its cycles would have been a sleep.
+ *    Everything else is busy: passes with work, interrupts, the application around the loop.
+ *  - Every SHELL_LOAD_WINDOW_MS the busy share of the window goes into a ring of
+ *    SHELL_LOAD_SAMPLES samples. "load" averages the newest 1, 10 and 60 of them, so the 10 and
+ *    60 s values are exact moving windows, no exponential decay. Shares are in per mille.
+ *  - It also shows the shortest and longest period between pass starts and the longest latency
+ *    from a receive interrupt to the next pass, in µs, since startup or "load r1". A busy share
+ *    near 1000 or a period max above the receive ring time are the signs of saturation before
+ *    lines are dropped.
+ *  - Result fields (CLI_SHELL_RESULT.h):
+ *      busy: 1s, 10s, 60s    per mille
+ *      samples               windows collected so far (the averages use what there is)
+ *      period: min, max      µs between pass starts
+ *      rx: max               µs from a receive event to the next pass
+ *  - With SHELL_RTOS_ENABLED the idle time is the time the shell task is blocked, other tasks
+ *    may run then: the load of the shell task, not of the CPU.
+ *  - The clock governor gets the busy share of every SHELL_CLOCK_GOV_WINDOW_MS as well
+ *    (CLI_SHELL_CLOCK.h). Cycles are core cycles, a window across a profile switch weighs the
+ *    faster part more.
+ *  - A window closes in the first pass after it is due. A loop stuck longer than a window fills
+ *    the samples it missed with its share.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_LOAD_H_
+#define CLI_SHELL_LOAD_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_LOAD_WINDOW_MS			1000
+#define SHELL_LOAD_SAMPLES				60			/*!< Windows kept, the longest average	*/
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellLoadIdle(uint32_t cycles);
+void shellLoadPass(uint32_t events, uint32_t rxLatency);
+
+#endif // CLI_SHELL_LOAD_H_
+
+/*** end of file ***/
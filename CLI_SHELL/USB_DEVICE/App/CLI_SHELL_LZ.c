@@ -0,0 +1,242 @@
+/** @file CLI_SHELL_LZ.c
+ *
+ * @brief Output compression of the CLI Shell: streaming LZSS with a 256 byte window
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_LZ.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define LZ_RING(position)		((uint8_t)(position))
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Encoder, one response at a time
+  * @note	The window holds every byte written so far, the last pending of them are not encoded
+  * 		yet. While a match runs, pending is 0 and the match covers the bytes before pos.
+  */
+typedef struct {
+	shell_ctx_t* owner;						/*!< Instance packing a response, NULL if free	*/
+	shellLzSink_t sink;
+	uint8_t window[SHELL_LZ_WINDOW];		/*!< Same contents as the host's window		*/
+	uint8_t head[SHELL_LZ_HASH_SIZE];		/*!< Last window position of each prefix hash	*/
+	uint8_t pos;							/*!< Window position of the next byte		*/
+	uint8_t pending;						/*!< Bytes before pos without a token yet	*/
+	uint8_t matchDistance;					/*!< Match being extended, 0 if none		*/
+	uint16_t matchLen;
+	uint8_t group[SHELL_LZ_GROUP_LEN];		/*!< Flag byte and the tokens of the group	*/
+	uint8_t groupLen;
+	uint8_t groupTokens;
+} shellLz_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellLz_t lz;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint8_t lzHash(uint8_t position);
+static void lzToken(bool match, uint8_t first, uint8_t second);
+static void lzGroupOut(void);
+static void lzMatchOut(void);
+static void lzSearch(void);
+static void lzPut(uint8_t byte);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Hash of the 3 byte prefix at a window position
+  * @param[IN]  position Window position of the first byte
+  * @retval uint8_t Index into the hash table
+  */
+static uint8_t lzHash(uint8_t position) {
+	uint32_t prefix = lz.window[position] |
+			((uint32_t)lz.window[LZ_RING(position + 1)] << 8) |
+			((uint32_t)lz.window[LZ_RING(position + 2)] << 16);
+
+	return (uint8_t)((prefix * 2654435761U) >> 24) & (SHELL_LZ_HASH_SIZE - 1);
+}
+
+/**
+  * @brief  Adds a token to the group, sends the group once it has 8
+  * @param[IN]  match Match (two bytes) instead of a literal (first only)
+  * @param[IN]  first Literal or distance
+  * @param[IN]  second Length - SHELL_LZ_MIN_MATCH of a match
+  * @retval NONE
+  */
+static void lzToken(bool match, uint8_t first, uint8_t second) {
+	if (match) {
+		lz.group[0] |= (uint8_t)(1U << lz.groupTokens);
+	}
+	lz.group[lz.groupLen++] = first;
+	if (match) {
+		lz.group[lz.groupLen++] = second;
+	}
+
+	if (++lz.groupTokens == 8) {
+		lzGroupOut();
+	}
+}
+
+/**
+  * @brief  Hands the group to the sink and starts the next one
+  * @retval NONE
+  */
+static void lzGroupOut(void) {
+	if (lz.groupTokens > 0) {
+		lz.sink(lz.owner, lz.group, lz.groupLen);
+	}
+	lz.group[0] = 0;
+	lz.groupLen = 1;
+	lz.groupTokens = 0;
+}
+
+/**
+  * @brief  Ends the running match with its token
+  * @retval NONE
+  */
+static void lzMatchOut(void) {
+	lzToken(true, lz.matchDistance, (uint8_t)(lz.matchLen - SHELL_LZ_MIN_MATCH));
+	lz.matchDistance = 0;
+}
+
+/**
+  * @brief  Looks up the 3 pending bytes, starts a match or gives the oldest one a literal
+  * @note	The candidate is only a hint, it may be from an older lap of the window or another
+  * 		prefix with the same hash. It is taken only if the window really repeats there.
+  * 		Distances stay within SHELL_LZ_MAX_DISTANCE, so the bytes compared have not been
+  * 		overwritten by the pending ones.
+  * @retval NONE
+  */
+static void lzSearch(void) {
+	uint8_t start = LZ_RING(lz.pos - (SHELL_LZ_MIN_MATCH - 1));
+	uint8_t hash = lzHash(start);
+	uint8_t candidate = lz.head[hash];
+	uint8_t distance = LZ_RING(start - candidate);
+
+	lz.head[hash] = start;
+
+	if (distance != 0 && distance <= SHELL_LZ_MAX_DISTANCE) {
+		uint8_t i = 0;
+		while (i < SHELL_LZ_MIN_MATCH &&
+				lz.window[LZ_RING(candidate + i)] == lz.window[LZ_RING(start + i)]) {
+			i++;
+		}
+		if (i == SHELL_LZ_MIN_MATCH) {
+			lz.matchDistance = distance;
+			lz.matchLen = SHELL_LZ_MIN_MATCH;
+			lz.pending = 0;
+			return;
+		}
+	}
+
+	lzToken(false, lz.window[start], 0);
+	lz.pending--;
+}
+
+/**
+  * @brief  Encodes one byte
+  * @param[IN]  byte Next byte of the response
+  * @retval NONE
+  */
+static void lzPut(uint8_t byte) {
+	lz.window[lz.pos] = byte;
+
+	if (lz.matchDistance != 0) {
+		if (lz.matchLen < SHELL_LZ_MAX_MATCH && lz.window[LZ_RING(lz.pos - lz.matchDistance)] == byte) {
+			// The prefixes within a match are candidates for later ones
+			lz.matchLen++;
+			lz.head[lzHash(LZ_RING(lz.pos - 2))] = LZ_RING(lz.pos - 2);
+			lz.pos++;
+			return;
+		}
+		lzMatchOut();
+	}
+
+	if (++lz.pending == SHELL_LZ_MIN_MATCH) {
+		lzSearch();
+	}
+	lz.pos++;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Takes the encoder for a response and starts a new stream
+  * @param[IN]  ctx Shell instance sending the response
+  * @param[IN]  sink Takes the packed bytes, called from shellLzWrite() and shellLzClose()
+  * @retval bool Returns false if another instance holds the encoder
+  */
+bool shellLzOpen(shell_ctx_t* ctx, shellLzSink_t sink) {
+	if (lz.owner != NULL && lz.owner != ctx) {
+		return false;
+	}
+
+	memset(&lz, 0, sizeof(lz));
+	lz.owner = ctx;
+	lz.sink = sink;
+	lz.groupLen = 1;
+	return true;
+}
+
+/**
+  * @brief  Packs response data, complete groups go to the sink
+  * @param[IN]  ctx Shell instance holding the encoder
+  * @param[IN]  data Response data
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellLzWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	if (lz.owner != ctx) {
+		return;
+	}
+
+	while (len--) {
+		lzPut(*data++);
+	}
+}
+
+/**
+  * @brief  Encodes what is left, sends the last group and frees the encoder
+  * @param[IN]  ctx Shell instance holding the encoder
+  * @retval NONE
+  */
+void shellLzClose(shell_ctx_t* ctx) {
+	if (lz.owner != ctx) {
+		return;
+	}
+
+	if (lz.matchDistance != 0) {
+		lzMatchOut();
+	}
+	while (lz.pending > 0) {
+		lzToken(false, lz.window[LZ_RING(lz.pos - lz.pending)], 0);
+		lz.pending--;
+	}
+	lzGroupOut();
+
+	lz.owner = NULL;
+}
+
+/*** end of file ***/
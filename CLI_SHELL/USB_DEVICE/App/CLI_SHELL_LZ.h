@@ -0,0 +1,72 @@
+/** @file CLI_SHELL_LZ.h
+ *
+ * @brief Output compression of the CLI Shell: streaming LZSS with a 256 byte window
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Turned on per binary session with "mode m1 z1" (z0 turns it off again). The response data
+ *    of every later request is compressed, frames carrying compressed data have
+ *    SHELL_BIN_STATUS_PACKED set in their status (CLI_SHELL_BINARY.h). The host joins the data of
+ *    all frames of a response and unpacks it in one go, Tools/shell_lz.py does both.
+ *    Text sessions stay plain, a terminal could not read them.
+ *  - Format: groups of up to 8 tokens, each group starts with a flag byte, bit 0 for the first
+ *    token. A clear bit is a literal, one byte as is. A set bit is a match, two bytes:
+ *      | distance (1..255) | length - SHELL_LZ_MIN_MATCH |
+ *    which repeats length bytes from distance bytes back, a byte at a time (distance < length
+ *    repeats a pattern). The window starts as 256 zero bytes, a match may reach into it. The last
+ *    group of a response may have fewer tokens than flag bits, the data ends after its last token.
+ *  - Every response is packed on its own, window and group start over. A lost frame only spoils
+ *    its own response.
+ *  - One encoder serves all instances (about 420 bytes of RAM). A response that starts while
+ *    another instance's response holds it (a job answering over several polls) is sent plain.
+ *  - Greedy matching with a hash of 3 byte prefixes, one candidate per hash: constant time per
+ *    byte, so packing never holds up the transport. Hex dumps of RAM come out 5 to 7 times
+ *    smaller, of code about 3 times; help text hardly shrinks, its repeats are further apart
+ *    than the window. Data that does not compress grows by at most one byte in 8.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_LZ_H_
+#define CLI_SHELL_LZ_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_LZ_WINDOW					256			/*!< Ring of the last bytes, power of two	*/
+#define SHELL_LZ_HASH_SIZE				128			/*!< Prefix hash entries, power of two		*/
+#define SHELL_LZ_MIN_MATCH				3
+#define SHELL_LZ_MAX_MATCH				(SHELL_LZ_MIN_MATCH + 255)
+#define SHELL_LZ_MAX_DISTANCE			(SHELL_LZ_WINDOW - SHELL_LZ_MIN_MATCH)
+#define SHELL_LZ_GROUP_LEN				(1 + 8 * 2)	/*!< Flag byte, 8 matches					*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Takes the packed bytes of the instance that holds the encoder
+  */
+typedef void (*shellLzSink_t)(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellLzOpen(shell_ctx_t* ctx, shellLzSink_t sink);
+void shellLzWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+void shellLzClose(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_LZ_H_
+
+/*** end of file ***/
@@ -0,0 +1,471 @@
+/** @file CLI_SHELL_MACRO.c
+ *
+ * @brief Recorded command sequences (macros) of the CLI Shell, kept in flash
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Steps of binary sessions keep their raw contents marked (array arguments)
+ * - 1.2: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_FLASH.h"
+#include "CLI_SHELL_MACRO.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define MACRO_ALIGN(len)		(((len) + 3U) & ~3U)
+#define MACRO_LOG_END			(SHELL_FLASH_MACRO_ADDR + SHELL_FLASH_MACRO_SIZE)
+#define MACRO_ARG_RAW			0x80		/*!< shellMacroArg_t.type: contents from a binary frame	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Header of a macro record in the flash log, followed by the step data
+  */
+typedef struct {
+	uint16_t magic;							/*!< SHELL_MACRO_MAGIC, 0xFFFF ends the log	*/
+	uint8_t slot;
+	uint8_t steps;							/*!< 0 deletes the slot						*/
+	uint16_t length;						/*!< Bytes of step data after the header	*/
+	uint16_t crc;							/*!< CRC16 of the step data					*/
+	uint16_t tableId;						/*!< shellCommandTableId() when recorded	*/
+	uint16_t reserved;
+} shellMacroHeader_t;
+
+/**
+  * @brief  One recorded step. Followed by numArgs shellMacroArg_t and lineLen bytes of line,
+  * 		padded to a word.
+  */
+typedef struct {
+	uint16_t commandIndex;					/*!< Command Table index					*/
+	uint8_t numArgs;
+	uint8_t lineLen;						/*!< Command name and argument contents, NUL-separated	*/
+} shellMacroStep_t;
+
+/**
+  * @brief  One recorded argument
+  */
+typedef struct {
+	uint8_t token;							/*!< argToken_t								*/
+	uint8_t type;							/*!< argType_t of value, MACRO_ARG_RAW		*/
+	uint8_t offset;							/*!< Contents within the step line			*/
+	uint8_t len;
+	uint32_t value;							/*!< Converted value (argValue_t)			*/
+} shellMacroArg_t;
+
+/**
+  * @brief  The recording in progress
+  */
+typedef struct {
+	shell_ctx_t* ctx;						/*!< Instance being recorded, NULL if none	*/
+	uint8_t slot;
+	uint8_t steps;
+	bool overflow;							/*!< A step did not fit						*/
+	uint16_t length;
+	uint32_t data[SHELL_MACRO_MAX_LEN / 4];
+} shellMacroRecording_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellMacroRecording_t recording;
+
+static bool logScanned = false;
+static uint32_t logEnd;										/*!< First free byte of the log	*/
+static const shellMacroHeader_t* slotRecord[SHELL_MACRO_SLOTS];	/*!< Newest record per slot	*/
+static uint16_t tableId;
+
+// Live macros while the log is compacted
+SHELL_NOINIT static uint32_t compactBuffer[(SHELL_MACRO_SLOTS * (sizeof(shellMacroHeader_t) + SHELL_MACRO_MAX_LEN)) / 4];
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t stepSize(const shellMacroStep_t* step);
+static void scanLog(void);
+static bool compactLog(uint8_t skipSlot);
+static bool appendRecord(uint8_t slot, uint8_t steps, const void* data, uint16_t length);
+static shell_error playMacro(shell_ctx_t* ctx, const shellMacroHeader_t* header);
+static void listMacros(shell_ctx_t* ctx);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Bytes taken by a recorded step
+  * @param[IN]  step Recorded step
+  * @retval uint32_t Size including its arguments and the padded line
+  */
+static uint32_t stepSize(const shellMacroStep_t* step) {
+	return sizeof(shellMacroStep_t) + step->numArgs * sizeof(shellMacroArg_t) + MACRO_ALIGN(step->lineLen);
+}
+
+/**
+  * @brief  Finds the newest record of every slot and the end of the log
+  * @note	Records with a bad CRC (interrupted writes) are skipped. Anything that is not a
+  * 		record header ends the log.
+  * @param  NONE
+  * @retval NONE
+  */
+static void scanLog(void) {
+	uint32_t pos = SHELL_FLASH_MACRO_ADDR;
+
+	memset(slotRecord, 0, sizeof(slotRecord));
+	tableId = shellCommandTableId();
+
+	while ((MACRO_LOG_END - pos) >= sizeof(shellMacroHeader_t)) {
+		const shellMacroHeader_t* header = (const shellMacroHeader_t*)pos;
+		uint32_t recordLen = sizeof(shellMacroHeader_t) + MACRO_ALIGN(header->length);
+
+		if (header->magic != SHELL_MACRO_MAGIC || header->length > SHELL_MACRO_MAX_LEN
+				|| recordLen > (MACRO_LOG_END - pos)) {
+			break;
+		}
+
+		if (header->slot < SHELL_MACRO_SLOTS
+				&& shellCrc16(SHELL_BIN_CRC_INIT, (const uint8_t*)(header + 1), header->length) == header->crc) {
+			slotRecord[header->slot] = (header->steps == 0) ? NULL : header;
+		}
+		pos += recordLen;
+	}
+
+	logEnd = pos;
+	logScanned = true;
+}
+
+/**
+  * @brief  Rewrites the log with only the newest record of each slot
+  * @param[IN]  skipSlot Slot about to be replaced, not copied
+  * @retval bool Returns false if the sector could not be erased or written
+  */
+static bool compactLog(uint8_t skipSlot) {
+	uint32_t length = 0;
+
+	for (uint8_t slot = 0; slot < SHELL_MACRO_SLOTS; slot++) {
+		const shellMacroHeader_t* header = slotRecord[slot];
+
+		if (header == NULL || slot == skipSlot) {
+			continue;
+		}
+		uint32_t recordLen = sizeof(shellMacroHeader_t) + MACRO_ALIGN(header->length);
+		memcpy((uint8_t*)compactBuffer + length, header, recordLen);
+		length += recordLen;
+	}
+
+	bool ok = shellFlashErase(SHELL_FLASH_MACRO_SECTOR)
+			&& shellFlashProgram(SHELL_FLASH_MACRO_ADDR, compactBuffer, length);
+
+	scanLog();
+	return ok;
+}
+
+/**
+  * @brief  Appends a record to the log, compacting it first if there is no room
+  * @param[IN]  slot Macro slot
+  * @param[IN]  steps Number of steps, 0 deletes the slot
+  * @param[IN]  data Step data
+  * @param[IN]  length Bytes of step data
+  * @retval bool Returns false if the record could not be written
+  */
+static bool appendRecord(uint8_t slot, uint8_t steps, const void* data, uint16_t length) {
+	shellMacroHeader_t header;
+	uint32_t recordLen = sizeof(header) + MACRO_ALIGN(length);
+
+	header.magic = SHELL_MACRO_MAGIC;
+	header.slot = slot;
+	header.steps = steps;
+	header.length = length;
+	header.crc = shellCrc16(SHELL_BIN_CRC_INIT, (const uint8_t*)data, length);
+	header.tableId = tableId;
+	header.reserved = 0xFFFF;
+
+	if (recordLen > (MACRO_LOG_END - logEnd) || !shellFlashBlank(logEnd, recordLen)) {
+		if (!compactLog(slot)) {
+			return false;
+		}
+		if (steps == 0) {
+			// Compacting already dropped the slot
+			return true;
+		}
+	}
+
+	uint32_t address = logEnd;
+	bool ok = shellFlashProgram(address, &header, sizeof(header))
+			&& shellFlashProgram(address + sizeof(header), data, length);
+
+	scanLog();
+	return ok;
+}
+
+/**
+  * @brief  Replays a stored macro
+  * @note	Runs every step through shellDispatch() with the recorded, already converted
+  * 		arguments. Responses are collected like those of a batch.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  header Record of the macro
+  * @retval shell_error SHELL_ERR if a step failed
+  */
+static shell_error playMacro(shell_ctx_t* ctx, const shellMacroHeader_t* header) {
+	const uint8_t* data = (const uint8_t*)(header + 1);
+	uint8_t lineBuffer[SHELL_BUFFER_LEN + 1];
+	shellParserOutput_t parserOutput;
+	uint32_t savedStamps[perfStage_count + 1];
+	bool wasBatch = ctx->batchActive;
+	responseCode_t savedStatus = ctx->batchStatus;
+	uint32_t pos = 0;
+	uint8_t position = 0;
+	SHELL_STR_DEFINE(str, 30);
+
+	// The steps stamp their own stages, the macro command keeps its own
+	memcpy(savedStamps, ctx->perfStamps, sizeof(savedStamps));
+
+	ctx->batchActive = true;
+	ctx->batchStatus = RESPONSE_OK;
+
+	while (position < header->steps && ctx->batchStatus == RESPONSE_OK) {
+		const shellMacroStep_t* step = (const shellMacroStep_t*)&data[pos];
+		const shellMacroArg_t* args = (const shellMacroArg_t*)(step + 1);
+
+		position++;
+		if (step->numArgs > MAX_ARGUMENTS || step->lineLen > sizeof(lineBuffer)) {
+			ctx->batchStatus = RESPONSE_ARG_ERR;
+			break;
+		}
+
+		memcpy(lineBuffer, &args[step->numArgs], step->lineLen);
+		memset(&parserOutput, 0, sizeof(parserOutput));
+		memset(parserOutput.argSlot, SHELL_ARG_NONE, sizeof(parserOutput.argSlot));
+		parserOutput.line = lineBuffer;
+		parserOutput.cmdLen = strlen((const char*)lineBuffer);
+		parserOutput.validated = true;
+
+		for (uint8_t i = 0; i < step->numArgs; i++) {
+			shellArgument_t* arg = &parserOutput.cmdArgs[i];
+
+			arg->argToken = (argToken_t)args[i].token;
+			arg->argType = (argType_t)(args[i].type & ~MACRO_ARG_RAW);
+			arg->argOffset = args[i].offset;
+			arg->argLen = args[i].len;
+			memcpy(&arg->argValue, &args[i].value, sizeof(args[i].value));
+			if (arg->argType == arg_string) {
+				arg->argValue.str = (const char*)&lineBuffer[arg->argOffset];
+			}
+			if (args[i].type & MACRO_ARG_RAW) {
+				// Array elements are read from the contents again
+				parserOutput.rawValues = true;
+			}
+			shellIndexArg(&parserOutput, i);
+			parserOutput.numArgs++;
+		}
+
+		shellDispatch(ctx, &parserOutput, step->commandIndex);
+		pos += stepSize(step);
+	}
+
+	responseCode_t result = ctx->batchStatus;
+	ctx->batchActive = wasBatch;
+	ctx->batchStatus = savedStatus;
+	memcpy(ctx->perfStamps, savedStamps, sizeof(savedStamps));
+
+	if (result != RESPONSE_OK) {
+		shellStrAppend(&str, "Macro stopped at ");
+		shellStrAppendUnsigned(&str, position, 0);
+		shellStrAppend(&str, ": ");
+		shellStrSend(ctx, &str);
+		return SHELL_ERR;
+	}
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Lists the stored macros, the recording and the log usage
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void listMacros(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 60);
+
+	for (uint8_t slot = 0; slot < SHELL_MACRO_SLOTS; slot++) {
+		const shellMacroHeader_t* header = slotRecord[slot];
+
+		if (header == NULL) {
+			continue;
+		}
+		shellStrAppend(&str, "Macro ");
+		shellStrAppendUnsigned(&str, slot, 0);
+		shellStrAppend(&str, ": ");
+		shellStrAppendUnsigned(&str, header->steps, 0);
+		shellStrAppend(&str, " steps, ");
+		shellStrAppendUnsigned(&str, header->length, 0);
+		shellStrAppend(&str, (header->tableId != tableId) ? " bytes (stale)\r\n" : " bytes\r\n");
+		if (!shellOutputReserve(ctx, str.len)) {
+			return;
+		}
+		shellStrSend(ctx, &str);
+	}
+
+	if (recording.ctx != NULL) {
+		shellStrAppend(&str, "Recording ");
+		shellStrAppendUnsigned(&str, recording.slot, 0);
+		shellStrAppend(&str, ": ");
+		shellStrAppendUnsigned(&str, recording.steps, 0);
+		shellStrAppend(&str, " steps, ");
+		shellStrAppendUnsigned(&str, recording.length, 0);
+		shellStrAppend(&str, " bytes\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	shellStrAppend(&str, "Log: ");
+	shellStrAppendUnsigned(&str, logEnd - SHELL_FLASH_MACRO_ADDR, 0);
+	shellStrAppend(&str, " of ");
+	shellStrAppendUnsigned(&str, SHELL_FLASH_MACRO_SIZE, 0);
+	shellStrAppend(&str, " bytes\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Records a dispatched command if its instance is recording
+  * @note	Called by shellDispatch() once the arguments are validated, for every command but
+  * 		"macro". The command name and the argument contents are packed NUL-separated.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserOutput Validated parser output
+  * @param[IN]	commandIndex Index of the command within the Command Table.
+  * @retval NONE
+  */
+void shellMacroCapture(shell_ctx_t* ctx, const shellParserOutput_t* parserOutput, uint16_t commandIndex) {
+	if (recording.ctx != ctx || recording.overflow) {
+		return;
+	}
+
+	uint32_t lineLen = parserOutput->cmdLen + 1;
+	for (uint8_t i = 0; i < parserOutput->numArgs; i++) {
+		lineLen += parserOutput->cmdArgs[i].argLen + 1;
+	}
+
+	uint32_t size = sizeof(shellMacroStep_t) + parserOutput->numArgs * sizeof(shellMacroArg_t) + MACRO_ALIGN(lineLen);
+	if (lineLen > UINT8_MAX || recording.steps == UINT8_MAX || size > (SHELL_MACRO_MAX_LEN - recording.length)) {
+		recording.overflow = true;
+		return;
+	}
+
+	uint8_t* dst = (uint8_t*)recording.data + recording.length;
+	shellMacroStep_t* step = (shellMacroStep_t*)dst;
+	shellMacroArg_t* args = (shellMacroArg_t*)(step + 1);
+	uint8_t* line = (uint8_t*)&args[parserOutput->numArgs];
+
+	memset(dst, 0, size);
+	step->commandIndex = commandIndex;
+	step->numArgs = parserOutput->numArgs;
+	step->lineLen = (uint8_t)lineLen;
+
+	memcpy(line, shellCmdName(parserOutput), parserOutput->cmdLen);
+	uint8_t pos = parserOutput->cmdLen + 1;
+
+	for (uint8_t i = 0; i < parserOutput->numArgs; i++) {
+		const shellArgument_t* arg = &parserOutput->cmdArgs[i];
+
+		args[i].token = (uint8_t)arg->argToken;
+		args[i].type = (uint8_t)arg->argType | (parserOutput->rawValues ? MACRO_ARG_RAW : 0);
+		args[i].offset = pos;
+		args[i].len = arg->argLen;
+		memcpy(&args[i].value, &arg->argValue, sizeof(args[i].value));
+
+		memcpy(&line[pos], shellArgContents(parserOutput, i), arg->argLen);
+		pos += arg->argLen + 1;
+	}
+
+	recording.length += size;
+	recording.steps++;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Records, stores, plays, deletes or lists macros
+  * @note	See CLI_SHELL_MACRO.h. Exactly one of r, e, p and d, or none to list.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error MacroBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint8_t given = shellHasArg(parserInput, argTkn_r) + shellHasArg(parserInput, argTkn_e)
+			+ shellHasArg(parserInput, argTkn_p) + shellHasArg(parserInput, argTkn_d);
+
+	if (!logScanned) {
+		scanLog();
+	}
+
+	if (given == 0) {
+		listMacros(ctx);
+		return SHELL_OK;
+	}
+	if (given > 1) {
+		return SHELL_ERR;
+	}
+
+	if (shellHasArg(parserInput, argTkn_r)) {
+		uint8_t slot = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8;
+
+		if (slot >= SHELL_MACRO_SLOTS || (recording.ctx != NULL && recording.ctx != ctx)) {
+			return SHELL_ERR;
+		}
+		memset(&recording, 0, sizeof(recording));
+		recording.ctx = ctx;
+		recording.slot = slot;
+		return SHELL_OK;
+	}
+
+	if (shellHasArg(parserInput, argTkn_e)) {
+		bool store = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_e)).u8 != 0;
+
+		if (recording.ctx != ctx) {
+			return SHELL_ERR;
+		}
+		recording.ctx = NULL;
+		if (!store) {
+			return SHELL_OK;
+		}
+		if (recording.overflow || recording.steps == 0) {
+			return SHELL_ERR;
+		}
+		return appendRecord(recording.slot, recording.steps, recording.data, recording.length) ? SHELL_OK : SHELL_ERR;
+	}
+
+	if (shellHasArg(parserInput, argTkn_p)) {
+		uint8_t slot = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).u8;
+
+		if (slot >= SHELL_MACRO_SLOTS || slotRecord[slot] == NULL || slotRecord[slot]->tableId != tableId) {
+			return SHELL_ERR;
+		}
+		return playMacro(ctx, slotRecord[slot]);
+	}
+
+	uint8_t slot = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+	if (slot >= SHELL_MACRO_SLOTS) {
+		return SHELL_ERR;
+	}
+	if (slotRecord[slot] == NULL) {
+		return SHELL_OK;
+	}
+	return appendRecord(slot, 0, NULL, 0) ? SHELL_OK : SHELL_ERR;
+}
+
+/*** end of file ***/
@@ -0,0 +1,59 @@
+/** @file CLI_SHELL_MACRO.h
+ *
+ * @brief Recorded command sequences (macros) of the CLI Shell, kept in flash
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Log in sector 3
+ *
+ * Usage Notes:
+ *  - "macro r<slot>" starts recording on this instance. Every command that follows still runs
+ *    as usual and is also recorded the way it was dispatched: resolved Command Table index,
+ *    argument tokens, converted values and contents. "macro" commands themselves are not recorded.
+ *  - "macro e1" ends the recording and stores it in flash, "macro e0" discards it.
+ *  - "macro p<slot>" replays a macro like a batch: one response, stopping at the first failure
+ *    ("Macro stopped at <n>: "). Replay skips tokenizing, lookup and argument conversion, each
+ *    step goes straight to the bridge.
+ *  - "macro d<slot>" deletes a macro, "macro" alone lists the slots.
+ *  - Macros are appended to a log in flash sector 3 (16 KB, CLI_SHELL_FLASH.h), the newest record
+ *    of a slot wins. A full log is compacted: the live macros are staged in RAM, the sector is
+ *    erased (about 250 ms without USB service) and they are written back.
+ *  - Each record carries the Command Table id (shellCommandTableId()). Firmware with a different
+ *    command set lists the macro as stale and refuses to play it.
+ *  - One recording at a time, whichever instance started it.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_MACRO_H_
+#define CLI_SHELL_MACRO_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_MACRO_SLOTS				8
+#define SHELL_MACRO_MAX_LEN				256			/*!< Bytes of recorded steps per macro	*/
+#define SHELL_MACRO_MAGIC				0x4D41		/*!< Record header of the flash log		*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef struct shellParserOutputTypeDef	shellParserOutput_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellMacroCapture(shell_ctx_t* ctx, const shellParserOutput_t* parserOutput, uint16_t commandIndex);
+
+#endif // CLI_SHELL_MACRO_H_
+
+/*** end of file ***/
@@ -0,0 +1,682 @@
+/** @file CLI_SHELL_MEM.c
+ *
+ * @brief Memory and register read/write commands of the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Hex lines by CLI_SHELL_FORMAT
+ * - 1.2: 10-14-2026 (Crandell) "mem" RAM usage and stack high-water mark
+ * - 1.3: 10-14-2026 (Crandell) No stack peak before the first paint with SHELL_FAST_BOOT
+ * - 1.4: 10-14-2026 (Crandell) .noinit size
+ * - 1.5: 10-14-2026 (Crandell) "crc" command
+ * - 1.6: 10-14-2026 (Crandell) "crc" answers with result fields (CLI_SHELL_RESULT)
+ * - 1.7: 10-14-2026 (Crandell) shellMemReadable()
+ * - 1.8: 10-15-2026 (Crandell) "crc" of RAM stays out of the response cache
+ * - 1.9: 10-15-2026 (Crandell) Stack scan and repaint start above the MPU stack guard
+ * - 1.9: 10-15-2026 (Crandell) "mwr" writes a list of values (v1,2,3)
+ * - 1.10: 10-15-2026 (Crandell) Hex lines are formatted in the transmit queue (shellOutputAcquire)
+ * - 1.11: 10-15-2026 (Crandell) Raw dumps of memory are read by the copy service (CLI_SHELL_COPY)
+ * - 1.12: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_FORMAT.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_MEM.h"
+#include "CLI_SHELL_BOOT.h"
+#include "CLI_SHELL_CRC.h"
+#include "CLI_SHELL_RESULT.h"
+#include "CLI_SHELL_CACHE.h"
+#include "CLI_SHELL_MPU.h"
+#include "CLI_SHELL_COPY.h"
+
+// Binary sessions format the hex lines in the staging buffer of shellOutputAcquire()
+_Static_assert(SHELL_MEM_HEX_LINE_LEN <= SHELL_OUTPUT_STAGE_LEN, "SHELL_MEM_HEX_LINE_LEN exceeds SHELL_OUTPUT_STAGE_LEN");
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A range of the memory map the commands may access
+  */
+typedef struct {
+	uint32_t start;
+	uint32_t end;							/*!< First address past the region			*/
+	bool writable;
+} shellMemRegion_t;
+
+/**
+  * @brief  The running dump or block write
+  */
+typedef struct {
+	uint32_t address;						/*!< Next access							*/
+	uint32_t remaining;						/*!< Bytes left								*/
+	uint32_t total;							/*!< Bytes requested						*/
+	uint8_t width;							/*!< Bytes per access (1, 2, 4)				*/
+	bool binary;							/*!< Raw bytes over the stream queue		*/
+	volatile bool copying;					/*!< The copy service fills chunk			*/
+	bool checked;							/*!< chunk is in crc						*/
+	uint16_t crc;							/*!< CRC16 of the raw bytes queued so far	*/
+	uint16_t chunkLen;						/*!< Bytes in chunk still waiting for room	*/
+	uint8_t chunk[SHELL_MEM_CHUNK_LEN];
+	uint8_t pending[4];						/*!< Block write: bytes of the next access	*/
+	uint8_t pendingLen;
+	uint32_t lastTick;						/*!< Block write: last byte received		*/
+} shellMem_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const shellMemRegion_t shellMemRegions[] = {
+	{ FLASH_BASE,		FLASH_END + 1U,						false },	// Main flash
+	{ 0x1FFF0000U,		FLASHSIZE_BASE + 2U,				false },	// System memory, OTP, unique ID, flash size
+	{ 0x1FFFC000U,		0x1FFFC010U,						false },	// Option bytes
+	{ SRAM1_BASE,		SRAM1_BASE + SHELL_MEM_SRAM_SIZE,	true },
+	{ PERIPH_BASE,		0x50040000U,						true },		// APB1, APB2, AHB1, AHB2 (USB OTG FS)
+	{ 0xE0000000U,		0xE0100000U,						true },		// Cortex-M4 private peripherals
+};
+
+static shellMem_t mem;
+
+// Set by "mem r1", the startup code paints unless SHELL_FAST_BOOT (shellBootPaint)
+static bool stackPainted = false;
+
+// Linker script symbols, only their addresses mean something
+extern uint32_t _sdata, _edata, _snoinit, _enoinit, _sbss, _ebss, _estack;
+extern uint8_t _Min_Heap_Size, _Min_Stack_Size;
+extern uint8_t end;
+extern void* _sbrk(int incr);
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool memRangeAllowed(uint32_t address, uint32_t length, uint8_t width, bool write);
+static uint32_t memRead(uint32_t address, uint8_t width);
+static void memWrite(uint32_t address, uint8_t width, uint32_t value);
+static uint8_t memWidthArg(shellParserOutput_t* parserInput);
+static uint16_t formatHexLine(char* line);
+static bool dumpHex(shell_ctx_t* ctx);
+static void dumpCopied(bool ok, void* context);
+static bool dumpRaw(void);
+static bool receiveBlock(shell_ctx_t* ctx);
+static void reportMem(shell_ctx_t* ctx, bool read);
+static shell_error mrdJob(shellJob_t* job);
+static shell_error mwrJob(shellJob_t* job);
+static shell_error crcJob(shellJob_t* job);
+static uint32_t stackLowWater(uint32_t floor);
+static void stackRepaint(uint32_t floor);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Checks an access range against the memory map
+  * @param[IN]  address First address
+  * @param[IN]  length Number of bytes
+  * @param[IN]  width Bytes per access, address and length must be multiples of it
+  * @param[IN]  write The range is written
+  * @retval bool Returns true if the whole range lies within one allowed region
+  */
+static bool memRangeAllowed(uint32_t address, uint32_t length, uint8_t width, bool write) {
+	if (length == 0 || (address % width) != 0 || (length % width) != 0) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < sizeof(shellMemRegions) / sizeof(shellMemRegions[0]); i++) {
+		const shellMemRegion_t* region = &shellMemRegions[i];
+
+		if (address >= region->start && address < region->end) {
+			return (length <= region->end - address) && (region->writable || !write);
+		}
+	}
+	return false;
+}
+
+/**
+  * @brief  One read access of the given width
+  * @param[IN]  address Aligned address
+  * @param[IN]  width Bytes per access (1, 2, 4)
+  * @retval uint32_t Value read
+  */
+static uint32_t memRead(uint32_t address, uint8_t width) {
+	if (width == 1) {
+		return *(volatile uint8_t*)address;
+	}
+	if (width == 2) {
+		return *(volatile uint16_t*)address;
+	}
+	return *(volatile uint32_t*)address;
+}
+
+/**
+  * @brief  One write access of the given width
+  * @param[IN]  address Aligned address
+  * @param[IN]  width Bytes per access (1, 2, 4)
+  * @param[IN]  value Value to write, truncated to the width
+  * @retval NONE
+  */
+static void memWrite(uint32_t address, uint8_t width, uint32_t value) {
+	if (width == 1) {
+		*(volatile uint8_t*)address = (uint8_t)value;
+	} else if (width == 2) {
+		*(volatile uint16_t*)address = (uint16_t)value;
+	} else {
+		*(volatile uint32_t*)address = value;
+	}
+}
+
+/**
+  * @brief  Access width argument (w), 4 if omitted
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval uint8_t Width in bytes, 0 if invalid
+  */
+static uint8_t memWidthArg(shellParserOutput_t* parserInput) {
+	uint8_t width = 4;
+
+	if (shellHasArg(parserInput, argTkn_w)) {
+		width = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_w)).u8;
+	}
+	return (width == 1 || width == 2 || width == 4) ? width : 0;
+}
+
+/**
+  * @brief  Formats the next hex line of the dump and advances it
+  * @param[OUT]  line At least SHELL_MEM_HEX_LINE_LEN characters
+  * @retval uint16_t Line length
+  */
+static uint16_t formatHexLine(char* line) {
+	uint32_t len = (mem.remaining < SHELL_MEM_HEX_BYTES) ? mem.remaining : SHELL_MEM_HEX_BYTES;
+	uint16_t pos = 0;
+
+	pos += shellFmtHex32(&line[pos], mem.address);
+	line[pos++] = ':';
+
+	for (uint32_t done = 0; done < len; done += mem.width) {
+		uint32_t value = memRead(mem.address, mem.width);
+
+		line[pos++] = ' ';
+		if (mem.width == 1) {
+			pos += shellFmtHex8(&line[pos], (uint8_t)value);
+		} else if (mem.width == 2) {
+			pos += shellFmtHex16(&line[pos], (uint16_t)value);
+		} else {
+			pos += shellFmtHex32(&line[pos], value);
+		}
+		mem.address += mem.width;
+	}
+	mem.remaining -= len;
+
+	line[pos++] = '\r';
+	line[pos++] = '\n';
+	return pos;
+}
+
+/**
+  * @brief  Sends hex lines while the transmit queue has room
+  * @param[IN]  ctx Shell instance of the job
+  * @retval bool Returns true once the whole range is queued
+  */
+static bool dumpHex(shell_ctx_t* ctx) {
+	for (uint8_t i = 0; i < SHELL_MEM_BLOCKS_PER_POLL && mem.remaining != 0; i++) {
+		uint8_t* line = shellOutputAcquire(ctx, SHELL_MEM_HEX_LINE_LEN);
+		if (line == NULL) {
+			// The transmit interrupt makes room, try again next poll
+			return false;
+		}
+		shellOutputCommit(ctx, formatHexLine((char*)line));
+	}
+	return mem.remaining == 0;
+}
+
+/**
+  * @brief  Completion of a chunk copy, from the stream interrupt or the caller
+  * @param[IN]  ok Always true, flash and SRAM do not fail a transfer
+  * @param[IN]  context Unused
+  * @retval NONE
+  */
+static void dumpCopied(bool ok, void* context) {
+	(void)ok;
+	(void)context;
+	mem.copying = false;
+}
+
+/**
+  * @brief  Queues raw chunks while the stream queue has room
+  * @note	A chunk is read once. If the queue is full it waits in mem.chunk, so registers
+  * 		with read side effects are never read twice. Below the peripherals the width makes
+  * 		no difference to the bytes: the copy service reads the chunk in the background
+  * 		and the next poll takes it from there.
+  * @param  NONE
+  * @retval bool Returns true once the whole range is queued
+  */
+static bool dumpRaw(void) {
+	for (uint8_t i = 0; i < SHELL_MEM_BLOCKS_PER_POLL; i++) {
+		if (mem.chunkLen == 0) {
+			if (mem.remaining == 0) {
+				return true;
+			}
+
+			uint32_t len = (mem.remaining < SHELL_MEM_CHUNK_LEN) ? mem.remaining : SHELL_MEM_CHUNK_LEN;
+			mem.chunkLen = (uint16_t)len;
+			mem.checked = false;
+			if (mem.address < PERIPH_BASE) {
+				mem.copying = true;
+				shellCopyStart(mem.chunk, (const void*)mem.address, len, dumpCopied, NULL);
+				mem.address += len;
+			} else {
+				for (uint32_t done = 0; done < len; done += mem.width) {
+					uint32_t value = memRead(mem.address, mem.width);
+
+					for (uint8_t b = 0; b < mem.width; b++) {
+						mem.chunk[done + b] = (uint8_t)(value >> (8 * b));
+					}
+					mem.address += mem.width;
+				}
+			}
+			mem.remaining -= len;
+		}
+
+		if (mem.copying) {
+			// SHELL_EVENT_PERIPH polls again
+			return false;
+		}
+		if (!mem.checked) {
+			mem.crc = shellCrc16(mem.crc, mem.chunk, mem.chunkLen);
+			mem.checked = true;
+		}
+
+		if (!transportStreamWrite(mem.chunk, mem.chunkLen)) {
+			// Queue full, the USB interrupt makes room
+			return false;
+		}
+		mem.chunkLen = 0;
+	}
+	return (mem.remaining == 0 && mem.chunkLen == 0);
+}
+
+/**
+  * @brief  Writes the received bytes of a block write, one access per width bytes
+  * @param[IN]  ctx Shell instance of the job
+  * @retval bool Returns true once all bytes are written
+  */
+static bool receiveBlock(shell_ctx_t* ctx) {
+	uint8_t byte;
+
+	while (mem.remaining != 0 && shellRingGet(&ctx->rxRing, &byte)) {
+		mem.pending[mem.pendingLen++] = byte;
+		mem.lastTick = HAL_GetTick();
+
+		if (mem.pendingLen == mem.width) {
+			uint32_t value = 0;
+			for (uint8_t b = 0; b < mem.width; b++) {
+				value |= (uint32_t)mem.pending[b] << (8 * b);
+			}
+			memWrite(mem.address, mem.width, value);
+			mem.address += mem.width;
+			mem.remaining -= mem.width;
+			mem.pendingLen = 0;
+		}
+	}
+	return mem.remaining == 0;
+}
+
+/**
+  * @brief  Sends the result line of a raw dump or a block write
+  * @param[IN]  ctx Shell instance of the job
+  * @param[IN]  read Raw dump (mrd) instead of block write (mwr)
+  * @retval NONE
+  */
+static void reportMem(shell_ctx_t* ctx, bool read) {
+	SHELL_STR_DEFINE(str, 50);
+	uint32_t done = mem.total - mem.remaining;
+
+	shellStrAppend(&str, read ? "MRD: " : "MWR: ");
+	shellStrAppendUnsigned(&str, done, 0);
+	if (read) {
+		shellStrAppend(&str, " bytes, CRC 0x");
+		shellStrAppendHex(&str, mem.crc, 4);
+		shellStrAppend(&str, "\r\n");
+	} else {
+		shellStrAppend(&str, " bytes\r\n");
+	}
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Poll function of "mrd"
+  * @param[IN]  job The dump job
+  * @retval shell_error SHELL_BUSY while the dump runs
+  */
+static shell_error mrdJob(shellJob_t* job) {
+	if (job->cancel) {
+		// The stream must be done with mem.chunk before the next command reuses it
+		while (mem.copying) {
+		}
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	if (mem.binary) {
+		SHELL_JOB_WAIT_UNTIL(job, dumpRaw());
+		// The result line must not overtake the data
+		SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+		reportMem(job->ctx, true);
+	} else {
+		SHELL_JOB_WAIT_UNTIL(job, dumpHex(job->ctx));
+	}
+
+	SHELL_JOB_END(job);
+}
+
+/**
+  * @brief  Poll function of a block "mwr"
+  * @param[IN]  job The write job
+  * @retval shell_error SHELL_BUSY while bytes are expected, SHELL_ERR on a timeout
+  */
+static shell_error mwrJob(shellJob_t* job) {
+	if (job->cancel) {
+		reportMem(job->ctx, false);
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	SHELL_JOB_WAIT_UNTIL(job, receiveBlock(job->ctx) || (HAL_GetTick() - mem.lastTick) >= SHELL_MEM_IDLE_MS);
+	job->ownsInput = false;
+	reportMem(job->ctx, false);
+	if (mem.remaining != 0) {
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	SHELL_JOB_END(job);
+}
+
+/**
+  * @brief  Poll function of "crc", waits for the DMA block of the CRC service
+  * @param[IN]  job The CRC job
+  * @retval shell_error SHELL_BUSY while the DMA runs, SHELL_ERR on a DMA error
+  */
+static shell_error crcJob(shellJob_t* job) {
+	SHELL_RESULT_DEFINE(res, job->ctx, 40);
+	uint32_t crc = 0;
+
+	if (job->cancel) {
+		shellCrc32Abort();
+		return SHELL_OK;
+	}
+
+	shell_error status = shellCrc32Poll(&crc);
+	if (status == SHELL_OK) {
+		shellResultHex(&res, "crc", crc, 8);
+		shellResultUnsigned(&res, "bytes", mem.total);
+		shellResultEnd(&res);
+	}
+	return status;
+}
+
+/**
+  * @brief  Lowest stack address ever written
+  * @note	Startup paints the RAM between the bss and the initial stack pointer with
+  * 		SHELL_MEM_PAINT. The stack grows down into it, the first word above the heap that
+  * 		still holds the paint marks how far it got.
+  * @param[IN]  floor Current end of the heap, or of the MPU stack guard above it
+  * @retval uint32_t Address of the first overwritten word
+  */
+static uint32_t stackLowWater(uint32_t floor) {
+	const uint32_t* word = (const uint32_t*)((floor + 3U) & ~3U);
+	const uint32_t* top = &_estack;
+
+	while (word < top && *word == SHELL_MEM_PAINT) {
+		word++;
+	}
+	return (uint32_t)word;
+}
+
+/**
+  * @brief  Paints the unused stack again, the next "mem" shows the peak from now on
+  * @note	Stops SHELL_MEM_PAINT_MARGIN bytes below the stack pointer, the words right below
+  * 		it belong to the calls and interrupts running now.
+  * @param[IN]  floor Current end of the heap, or of the MPU stack guard above it
+  * @retval NONE
+  */
+static void stackRepaint(uint32_t floor) {
+	uint32_t* word = (uint32_t*)((floor + 3U) & ~3U);
+	uint32_t* limit = (uint32_t*)((__get_MSP() - SHELL_MEM_PAINT_MARGIN) & ~3U);
+
+	while (word < limit) {
+		*word++ = SHELL_MEM_PAINT;
+	}
+	stackPainted = true;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Checks a read range against the memory map, for the other modules
+  * @param[IN]  address First address
+  * @param[IN]  length Number of bytes
+  * @param[IN]  width Bytes per access, address and length must be multiples of it
+  * @retval bool Returns true if the whole range may be read
+  */
+bool shellMemReadable(uint32_t address, uint32_t length, uint8_t width) {
+	return memRangeAllowed(address, length, width, false);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Dumps a memory range
+  * @note	See CLI_SHELL_MEM.h for the arguments and the formats.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the dump is running
+  */
+shell_error MrdBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint32_t address = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u32;
+	uint8_t width = memWidthArg(parserInput);
+	uint32_t length = width;
+	uint8_t format = 0;
+
+	if (shellHasArg(parserInput, argTkn_n)) {
+		length = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+	}
+	if (shellHasArg(parserInput, argTkn_f)) {
+		format = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+	}
+
+	if (width == 0 || format > 1 || !memRangeAllowed(address, length, width, false)) {
+		return SHELL_ERR;
+	}
+
+	// Raw dumps go through the stream queue, which goes to the port of this command
+	if (shellJobRunning() || (format == 1 && !transportStreamAttach(ctx))) {
+		return SHELL_ERR;
+	}
+
+	if (shellJobStart(ctx, mrdJob) == NULL) {
+		return SHELL_ERR;
+	}
+
+	memset(&mem, 0, sizeof(mem));
+	mem.address = address;
+	mem.remaining = length;
+	mem.total = length;
+	mem.width = width;
+	mem.binary = (format == 1);
+	mem.crc = SHELL_BIN_CRC_INIT;
+
+	return SHELL_BUSY;
+}
+
+/**
+  * @brief  Fills a memory range with a value, or writes a block sent after the command line
+  * @note	See CLI_SHELL_MEM.h for the arguments.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while a block is received
+  */
+shell_error MwrBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint32_t address = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u32;
+	uint8_t width = memWidthArg(parserInput);
+	bool fill = shellHasArg(parserInput, argTkn_v);
+	uint32_t count = fill ? 1 : 0;
+	uint32_t values[SHELL_ARRAY_MAX];
+	uint8_t valueCount = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_v), values, SHELL_ARRAY_MAX);
+
+	if (shellHasArg(parserInput, argTkn_n)) {
+		count = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+	}
+
+	// A fill counts repeats of the value list, a block counts bytes
+	uint64_t length = fill ? (uint64_t)count * valueCount * width : count;
+	if (width == 0 || length > UINT32_MAX || !memRangeAllowed(address, (uint32_t)length, width, true)) {
+		return SHELL_ERR;
+	}
+
+	if (fill) {
+		for (uint32_t i = 0; i < count * valueCount; i++) {
+			memWrite(address + i * width, width, values[i % valueCount]);
+		}
+		return SHELL_OK;
+	}
+
+	if (shellJobRunning()) {
+		return SHELL_ERR;
+	}
+
+	shellJob_t* job = shellJobStart(ctx, mwrJob);
+	if (job == NULL) {
+		return SHELL_ERR;
+	}
+
+	memset(&mem, 0, sizeof(mem));
+	mem.address = address;
+	mem.remaining = count;
+	mem.total = count;
+	mem.width = width;
+	mem.lastTick = HAL_GetTick();
+
+	// Bytes after the command line belong to the block
+	job->ownsInput = true;
+
+	return SHELL_BUSY;
+}
+
+/**
+  * @brief  CRC32 of a memory range through the CRC unit and the DMA
+  * @note	See CLI_SHELL_MEM.h for the arguments, CLI_SHELL_CRC.h for the CRC.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the CRC runs
+  */
+shell_error CrcBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint32_t address = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u32;
+	uint32_t length = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+
+	// The DMA reads flash and SRAM only, not the peripheral regions
+	if (!memRangeAllowed(address, length, 1, false) || address >= PERIPH_BASE) {
+		return SHELL_ERR;
+	}
+
+	// Only the read-only regions change through the flash routines alone (shellCacheInvalidate())
+	if (memRangeAllowed(address, length, 1, true)) {
+		shellCacheSkip(ctx);
+	}
+
+	if (shellJobRunning() || !shellCrc32Start(SHELL_CRC32_INIT, (const void*)address, length)) {
+		return SHELL_ERR;
+	}
+	if (shellJobStart(ctx, crcJob) == NULL) {
+		shellCrc32Abort();
+		return SHELL_ERR;
+	}
+
+	memset(&mem, 0, sizeof(mem));
+	mem.total = length;
+
+	return SHELL_BUSY;
+}
+
+/**
+  * @brief  Reports the RAM use: .data, .bss, heap and the stack high-water mark (r1 restarts it)
+  * @note	The reserves are _Min_Heap_Size and _Min_Stack_Size of the linker script. A peak
+  * 		above the stack reserve is flagged, the heap and anything above it may be corrupted.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error MemBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+	uint32_t stackTop = (uint32_t)&_estack;
+	uint32_t heapStart = (uint32_t)&end;
+	uint32_t heapTop = (uint32_t)_sbrk(0);
+	// The stack guard faults on any access, the scan starts above it
+	uint32_t stackFloor = (shellMpuStackFloor() > heapTop) ? shellMpuStackFloor() : heapTop;
+	uint32_t lowWater = stackLowWater(stackFloor);
+	uint32_t stackPeak = stackTop - lowWater;
+	uint32_t stackReserve = (uint32_t)&_Min_Stack_Size;
+
+	shellStrAppend(&str, "Data: ");
+	shellStrAppendUnsigned(&str, (uint32_t)&_edata - (uint32_t)&_sdata, 0);
+	shellStrAppend(&str, " bytes, BSS: ");
+	shellStrAppendUnsigned(&str, (uint32_t)&_ebss - (uint32_t)&_sbss, 0);
+	shellStrAppend(&str, " bytes, No-init: ");
+	shellStrAppendUnsigned(&str, (uint32_t)&_enoinit - (uint32_t)&_snoinit, 0);
+	shellStrAppend(&str, " bytes\r\n");
+	shellStrSend(ctx, &str);
+
+	shellStrAppend(&str, "Heap: ");
+	shellStrAppendUnsigned(&str, heapTop - heapStart, 0);
+	shellStrAppend(&str, " bytes (reserve ");
+	shellStrAppendUnsigned(&str, (uint32_t)&_Min_Heap_Size, 0);
+	shellStrAppend(&str, ")\r\n");
+	shellStrSend(ctx, &str);
+	shellCopyReport(ctx);
+
+	if (!shellBootPaint && !stackPainted) {
+		// Fast boot, the startup code did not paint
+		shellStrAppend(&str, "Stack: not painted (fast boot), \"mem r1\" starts the peak\r\n");
+		shellStrSend(ctx, &str);
+		if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+			stackRepaint(stackFloor);
+		}
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, "Stack: ");
+	shellStrAppendUnsigned(&str, stackPeak, 0);
+	shellStrAppend(&str, " bytes peak, ");
+	shellStrAppendUnsigned(&str, stackTop - __get_MSP(), 0);
+	shellStrAppend(&str, " now (reserve ");
+	shellStrAppendUnsigned(&str, stackReserve, 0);
+	shellStrAppend(&str, stackPeak > stackReserve ? ") OVER RESERVE\r\n" : ")\r\n");
+	shellStrSend(ctx, &str);
+
+	shellStrAppend(&str, "Free: ");
+	shellStrAppendUnsigned(&str, lowWater - stackFloor, 0);
+	shellStrAppend(&str, " bytes never touched\r\n");
+	shellStrSend(ctx, &str);
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+		stackRepaint(stackFloor);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
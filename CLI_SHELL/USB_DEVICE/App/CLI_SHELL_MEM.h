@@ -0,0 +1,97 @@
+/** @file CLI_SHELL_MEM.h
+ *
+ * @brief Memory and register read/write commands of the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) "mem" RAM usage and stack high-water mark
+ * - 1.2: 10-14-2026 (Crandell) No paint at reset with SHELL_FAST_BOOT
+ * - 1.3: 10-14-2026 (Crandell) "crc" command
+ * - 1.4: 10-14-2026 (Crandell) "crc" result fields
+ * - 1.5: 10-14-2026 (Crandell) shellMemReadable() for "watch"
+ * - 1.6: 10-15-2026 (Crandell) Stack scan above the MPU stack guard
+ * - 1.7: 10-15-2026 (Crandell) Raw dumps of memory by the copy service
+ *
+ * Usage Notes:
+ *  - "mrd a<address> n<bytes> w<width> f<format>" reads n bytes (default one access) starting at
+ *    address with accesses of w bytes (1, 2 or 4, default 4). Address and length must be multiples
+ *    of the width. Registers are read exactly once per access, in ascending order.
+ *    - f0 (default): hex lines of SHELL_MEM_HEX_BYTES through the transmit queue, one group per access
+ *        "20000000: 12345678 9ABCDEF0 ..."
+ *    - f1: the n bytes raw (little endian, as stored) through the stream queue, then
+ *        "MRD: <bytes> bytes, CRC 0x<crc>"
+ *      The host reads exactly n bytes before that line. The CRC is CRC16 as CLI_SHELL_BINARY.h
+ *      over the n bytes. Only transports with a stream queue (USB) support it, a dump of the
+ *      128 KB SRAM takes about a second there. Chunks of flash, system memory and SRAM are read by
+      the copy service (CLI_SHELL_COPY.h) while the CPU serves the stream queue, registers keep
+      their accesses of w bytes.
+ *  - "mwr a<address> w<width> v<value> n<count>" writes value count times (default once) to
+ *    consecutive accesses, a fill. v may list up to SHELL_ARRAY_MAX values, "v1,2,0x30": they go
+ *    to consecutive accesses in one command, n repeats the list.
+ *  - "mwr a<address> w<width> n<bytes>" without v: the host sends n raw bytes right after the
+ *    command line, they are written in accesses of w bytes as they arrive. The response follows
+ *    the last byte, "MWR: <bytes> bytes". The command gives up after SHELL_MEM_IDLE_MS without data.
+ *  - "crc a<address> n<bytes>" answers the CRC32 of the range as result fields (CLI_SHELL_RESULT.h),
+ *    "crc: 0x<crc>" and "bytes: <bytes>" lines, a CBOR map in binary mode. The CRC unit computes
+ *    it, fed by the DMA (CLI_SHELL_CRC.h for the CRC and its host side). Any alignment and length
+ *    within flash, system memory and SRAM, the 512 KB flash takes about 10 ms.
+ *  - All three check the whole range against the memory map of the STM32F411 (shellMemRegions in
+ *    CLI_SHELL_MEM.c). Flash, system memory and OTP are read only. Reserved addresses inside the
+ *    peripheral regions still fault the same as they would from a debugger.
+ *  - Dumps and block writes run as a job (CLI_SHELL_JOB.h), "cancel" or Ctrl-C stops them.
+ *  - "mem" reports the .data and .bss sizes, the heap in use (_sbrk() of sysmem.c) and the stack
+ *    high-water mark against the reserves of the linker script. Reset_Handler paints the free RAM
+ *    with SHELL_MEM_PAINT before main(), the mark is the lowest word the stack overwrote since.
+ *    "mem r1" paints the unused stack again to measure a single command or phase:
+ *      mem r1
+ *      help
+ *      mem
+ *    Interrupts run on the same stack, their frames count towards the peak.
+ *  - With the MPU stack guard (CLI_SHELL_MPU.h) the scan starts above the guard, "Free" is the
+ *    untouched RAM between the guard and the peak. A stack that reaches the guard faults.
+ *  - SHELL_FAST_BOOT (CLI_SHELL_BOOT.h) skips the paint at reset, "mem" has no peak until the
+ *    first "mem r1".
+ *  - "mem" also shows the copies of the copy service (CLI_SHELL_COPY.h), by DMA and by the CPU.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_MEM_H_
+#define CLI_SHELL_MEM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_MEM_SRAM_SIZE				(128U * 1024U)	/*!< SRAM1 of the STM32F411			*/
+
+#define SHELL_MEM_HEX_BYTES				32			/*!< Bytes per hex line					*/
+#define SHELL_MEM_HEX_LINE_LEN			(10 + SHELL_MEM_HEX_BYTES * 3 + 2)	/*!< Longest line (byte accesses)	*/
+#define SHELL_MEM_CHUNK_LEN				256			/*!< Raw bytes per stream write			*/
+#define SHELL_MEM_IDLE_MS				2000		/*!< Block write timeout without data	*/
+
+#define SHELL_MEM_PAINT					0xC5C5C5C5U	/*!< Unused stack, same in the startup	*/
+#define SHELL_MEM_PAINT_MARGIN			64			/*!< Kept below the stack pointer (r1)	*/
+
+/**
+  * @brief  Lines or chunks per checkShellStatus() at most, keeps the main loop responsive
+  */
+#ifndef SHELL_MEM_BLOCKS_PER_POLL
+#define SHELL_MEM_BLOCKS_PER_POLL		16
+#endif
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellMemReadable(uint32_t address, uint32_t length, uint8_t width);
+
+#endif // CLI_SHELL_MEM_H_
+
+/*** end of file ***/
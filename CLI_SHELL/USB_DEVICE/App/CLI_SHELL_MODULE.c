@@ -0,0 +1,201 @@
+/** @file CLI_SHELL_MODULE.c
+ *
+ * @brief Command modules of the CLI Shell: separately linked command sets in a reserved flash region
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_ITM.h"
+#include "CLI_SHELL_MODULE.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define MODULE_ERASED					0xFFFFFFFFU
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A module found by the walk
+  */
+typedef struct {
+	const shellModuleHeader_t* header;
+	uint16_t registered;					/*!< Commands taken							*/
+} shellModuleEntry_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+extern uint32_t _smodules, _emodules;
+
+static shellModuleEntry_t modules[SHELL_MODULE_MAX];
+static uint8_t moduleCount;
+static uint16_t skippedCommands;			/*!< Commands of the modules not registered	*/
+static bool scanned = false;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool within(const shellModuleHeader_t* header, const void* pointer, uint32_t length);
+static bool moduleValid(const shellModuleHeader_t* header, uint32_t room);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Checks that an object lies within a module
+  * @param[IN]  header Module
+  * @param[IN]  pointer Start of the object
+  * @param[IN]  length Bytes of the object
+  * @retval bool Returns true if it does
+  */
+static bool within(const shellModuleHeader_t* header, const void* pointer, uint32_t length) {
+	uint32_t start = (uint32_t)header;
+	uint32_t address = (uint32_t)pointer;
+
+	return address >= start && length <= header->size && address - start <= header->size - length;
+}
+
+/**
+  * @brief  Checks a module header and every pointer of its commands
+  * @note	Names and help text are checked up to their terminator, bridges by their Thumb
+  * 		address. A module that fails is not used at all.
+  * @param[IN]  header Module
+  * @param[IN]  room Bytes left in the region from header on
+  * @retval bool Returns true if the module can be registered
+  */
+static bool moduleValid(const shellModuleHeader_t* header, uint32_t room) {
+	if (header->magic != SHELL_MODULE_MAGIC || header->apiVersion != SHELL_MODULE_API_VERSION) {
+		return false;
+	}
+	if (header->size < sizeof(shellModuleHeader_t) || header->size > room || (header->size & 3U) != 0) {
+		return false;
+	}
+	if (!within(header, header->commands, header->numCommands * sizeof(shellCmdTemplate_t))) {
+		return false;
+	}
+
+	uint32_t end = (uint32_t)header + header->size;
+
+	if (header->name != NULL && (!within(header, header->name, 1) ||
+			memchr(header->name, '\0', end - (uint32_t)header->name) == NULL)) {
+		return false;
+	}
+	for (uint16_t i = 0; i < header->numCommands; i++) {
+		const shellCmdTemplate_t* cmd = &header->commands[i];
+
+		if (!within(header, cmd->cmdName, 1) || memchr(cmd->cmdName, '\0', end - (uint32_t)cmd->cmdName) == NULL) {
+			return false;
+		}
+		if (!within(header, cmd->helpDesc, 1) || memchr(cmd->helpDesc, '\0', end - (uint32_t)cmd->helpDesc) == NULL) {
+			return false;
+		}
+		if (!within(header, (const void*)((uint32_t)cmd->bridge & ~1U), 2)) {
+			return false;
+		}
+		if (cmd->numArgs > 0 && !within(header, cmd->cmdArgsTable, cmd->numArgs * sizeof(shellArgTemplate_t))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Registers the commands of every module in the module region, once
+  * @note	Called by shellInit(). Commands the application registered before are already in
+  * 		the index, a module command of the same name is skipped.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellModuleScan(void) {
+	uint32_t address = (uint32_t)&_smodules;
+	uint32_t end = (uint32_t)&_emodules;
+
+	if (scanned) {
+		return;
+	}
+	scanned = true;
+
+	while (end - address >= sizeof(shellModuleHeader_t)) {
+		const shellModuleHeader_t* header = (const shellModuleHeader_t*)address;
+
+		if (header->magic == MODULE_ERASED) {
+			break;
+		}
+		if (!moduleValid(header, end - address)) {
+			SHELL_LOG(SHELL_LOG_ERR, "module at 0x%08lx rejected", (unsigned long)address);
+			break;
+		}
+
+		uint16_t registered = 0;
+		for (uint16_t i = 0; i < header->numCommands; i++) {
+			uint16_t commandIndex;
+
+			if (shellRegisterCommand(&header->commands[i], &commandIndex) == SHELL_OK) {
+				registered++;
+			}
+		}
+		skippedCommands += header->numCommands - registered;
+
+		if (moduleCount < SHELL_MODULE_MAX) {
+			modules[moduleCount].header = header;
+			modules[moduleCount].registered = registered;
+			moduleCount++;
+		}
+		address += header->size;
+	}
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Lists the modules found at boot
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (No Arguments)
+  * @retval shell_error Error Return Value
+  */
+shell_error ModulesBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+
+	shellStrAppend(&str, "Module\t| Address\t| Commands\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint8_t i = 0; i < moduleCount; i++) {
+		const shellModuleHeader_t* header = modules[i].header;
+
+		shellStrAppend(&str, (header->name != NULL) ? header->name : "-");
+		shellStrAppend(&str, "\t| 0x");
+		shellStrAppendHex(&str, (uint32_t)header, 8);
+		shellStrAppend(&str, "\t| ");
+		shellStrAppendUnsigned(&str, modules[i].registered, 0);
+		shellStrAppendChar(&str, '/');
+		shellStrAppendUnsigned(&str, header->numCommands, 0);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	shellStrAppend(&str, "Skipped: ");
+	shellStrAppendUnsigned(&str, skippedCommands, 0);
+	shellStrAppend(&str, " commands\r\n");
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,98 @@
+/** @file CLI_SHELL_MODULE.h
+ *
+ * @brief Command modules of the CLI Shell: separately linked command sets in a reserved flash region
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Module region in sectors 3 and 4, out of reach of the update
+ * - 1.2: 10-15-2026 (Crandell) Module region in sector 0 behind the boot stub
+ *
+ * Usage Notes:
+ *  - A module is a set of commands linked on its own and programmed into the module region,
+ *    sector 0 behind the boot stub (12 KB at 0x08001000, _smodules to _emodules of the linker
+ *    script). The image does not change: a product variant adds its commands by programming its
+ *    module next to it.
+ *  - The first shellInit() walks the region once: a module starts with a shellModuleHeader_t,
+ *    the next one follows at the first word after it (size). The walk ends at erased flash or
+ *    at a header that does not check out (magic, apiVersion, size, pointers outside the module).
+ *  - Every command of the module goes through shellRegisterCommand() (CLI_SHELL.h), the same
+ *    call the application can make for commands of its own before the first shellInit().
+ *    Each command is inserted into the sorted name index of the trie, nothing is rebuilt.
+ *    A name that is taken or does not fit SHELL_MODULE_MAX_COMMANDS is skipped and counted.
+ *  - Module commands are matched, completed, listed by "help" and measured by "perf" like the
+ *    commands of CLI_SHELL_COMMANDS.h. Their indices follow the Command Table
+ *    (shellCommandCount() on, in registration order) and binary frames address them the same
+ *    way. They have no deadline and are neither urgent nor cacheable. shellCommandTableId()
+ *    covers them, macros recorded with another set of modules are refused.
+ *  - A module calls into the image directly, so it is linked against the image it runs with:
+ *      arm-none-eabi-gcc <cpu flags> -nostartfiles -T module.ld -Wl,--just-symbols=CLI_SHELL.elf
+ *    module.ld places .shell_module (the header) at the module address, then .text and .rodata.
+ *    A module has no RAM of its own (no .data or .bss), its bridges keep state in shell
+ *    variables (CLI_SHELL_VAR.h) or settings (CLI_SHELL_KV.h). apiVersion is
+ *    SHELL_MODULE_API_VERSION of the image, a module built for another shell version is
+ *    ignored. Rebuild the modules with every image, the addresses they call move.
+ *  - "modules" lists the modules found with their address and commands registered.
+ *  - The region stays out of the program sectors: a sector is erased as a whole, and one shared
+ *    with the program would lose the modules to every firmware update (CLI_SHELL_FWUPDATE.h),
+ *    which erases sectors 4 and 5. Sector 0 is never erased by the firmware, the boot stub in it
+ *    is written by the debugger only, and so are the modules.
+ *  - Erasing sector 0 takes the boot stub with it: program the modules together with the image
+ *    they were linked against (its .elf carries the boot stub), never on their own.
+ *  - The RAM build (STM32F411RETX_RAM.ld) has no module region.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_MODULE_H_
+#define CLI_SHELL_MODULE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_MODULE_MAGIC				0x31444D53U	/*!< First word of a module ("SMD1")		*/
+#define SHELL_MODULE_API_VERSION		((SHELL_MAJOR_VER << 8) | SHELL_MINOR_VER)
+#define SHELL_MODULE_MAX				8			/*!< Modules listed by "modules"		*/
+#ifndef SHELL_MODULE_MAX_COMMANDS
+#define SHELL_MODULE_MAX_COMMANDS		32			/*!< Commands registered at runtime		*/
+#endif
+
+/**
+  * @brief  Places the header of a module, the first thing module.ld puts into the module
+  */
+#define SHELL_MODULE_HEADER				__attribute__((section(".shell_module"), used))
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCmdTemplateTypeDef shellCmdTemplate_t;
+
+/**
+  * @brief  Header at the start of a module
+  * @note	Everything it points at (the commands, their names, help text, argument lists and
+  * 		bridges) lies within the size bytes of the module.
+  */
+typedef struct {
+	uint32_t magic;							/*!< SHELL_MODULE_MAGIC						*/
+	uint16_t apiVersion;					/*!< SHELL_MODULE_API_VERSION linked against	*/
+	uint16_t numCommands;					/*!< Entries of commands					*/
+	uint32_t size;							/*!< Bytes of the module, a multiple of 4	*/
+	const char* name;						/*!< Module name for "modules"				*/
+	const shellCmdTemplate_t* commands;		/*!< Command templates, any order			*/
+} shellModuleHeader_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellModuleScan(void);
+
+#endif // CLI_SHELL_MODULE_H_
+
+/*** end of file ***/
@@ -0,0 +1,128 @@
+/** @file CLI_SHELL_MPU.c
+ *
+ * @brief MPU guard regions of the CLI Shell: stack overflow and buffer overrun trapping
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_MPU.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+_Static_assert((SHELL_MPU_STACK_GUARD_LEN & (SHELL_MPU_STACK_GUARD_LEN - 1)) == 0 && SHELL_MPU_STACK_GUARD_LEN >= 32,
+		"SHELL_MPU_STACK_GUARD_LEN must be a power of two, 32 or more");
+_Static_assert((SHELL_MPU_BUFFER_GUARD_LEN & (SHELL_MPU_BUFFER_GUARD_LEN - 1)) == 0 && SHELL_MPU_BUFFER_GUARD_LEN >= 32,
+		"SHELL_MPU_BUFFER_GUARD_LEN must be a power of two, 32 or more");
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+// Linker script symbols, only their addresses mean something
+extern uint32_t _estack, _snoinit_guard;
+extern uint8_t _Min_Stack_Size;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t stackGuardBase(void);
+static void guardRegion(uint32_t region, uint32_t base, uint32_t length);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Start of the stack guard, below the stack reserve and aligned to its size
+  * @param  NONE
+  * @retval uint32_t Address
+  */
+static uint32_t stackGuardBase(void) {
+	uint32_t reserveEnd = (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size;
+
+	return (reserveEnd - SHELL_MPU_STACK_GUARD_LEN) & ~(SHELL_MPU_STACK_GUARD_LEN - 1U);
+}
+
+/**
+  * @brief  Programs a no-access, never-execute region
+  * @param[IN]  region Region number
+  * @param[IN]  base Start, aligned to length
+  * @param[IN]  length Power of two, 32 or more
+  * @retval NONE
+  */
+static void guardRegion(uint32_t region, uint32_t base, uint32_t length) {
+	// RASR SIZE: the region is 2^(SIZE + 1) bytes. ARM_MPU_RASR() of this CMSIS release drops
+	// Size and the enable bit, both are added here.
+	uint32_t size = 30U - __CLZ(length);
+	uint32_t rasr = ARM_MPU_RASR(1U, ARM_MPU_AP_NONE, 0U, 0U, 1U, 1U, 0U, size)
+			| ((size << MPU_RASR_SIZE_Pos) & MPU_RASR_SIZE_Msk) | MPU_RASR_ENABLE_Msk;
+
+	ARM_MPU_SetRegion(ARM_MPU_RBAR(region, base), rasr);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sets up the guard regions and enables the MPU over the default memory map
+  * @note	Also enables the MemManage exception (ARM_MPU_Enable()), see shellCrashInit().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellMpuInit(void) {
+#if SHELL_MPU_ENABLE
+	ARM_MPU_Disable();
+	guardRegion(SHELL_MPU_REGION_STACK, stackGuardBase(), SHELL_MPU_STACK_GUARD_LEN);
+	guardRegion(SHELL_MPU_REGION_BUFFERS, (uint32_t)&_snoinit_guard, SHELL_MPU_BUFFER_GUARD_LEN);
+	ARM_MPU_Enable(MPU_CTRL_PRIVDEFENA_Msk);
+#endif
+}
+
+/**
+  * @brief  Lowest address the stack may use, the end of the stack guard
+  * @note	Scans of the unused stack ("mem") start here, the guard itself faults.
+  * @param  NONE
+  * @retval uint32_t Address, 0 without the MPU
+  */
+uint32_t shellMpuStackFloor(void) {
+#if SHELL_MPU_ENABLE
+	return stackGuardBase() + SHELL_MPU_STACK_GUARD_LEN;
+#else
+	return 0;
+#endif
+}
+
+/**
+  * @brief  Name of the guard an address falls into, for the post-mortem record
+  * @param[IN]  address Fault address or stack pointer
+  * @retval const char* "stack guard", "buffer guard" or NULL
+  */
+const char* shellMpuGuardName(uint32_t address) {
+#if SHELL_MPU_ENABLE
+	uint32_t stackGuard = stackGuardBase();
+	uint32_t bufferGuard = (uint32_t)&_snoinit_guard;
+
+	if (address >= stackGuard && address - stackGuard < SHELL_MPU_STACK_GUARD_LEN) {
+		return "stack guard";
+	}
+	if (address >= bufferGuard && address - bufferGuard < SHELL_MPU_BUFFER_GUARD_LEN) {
+		return "buffer guard";
+	}
+#else
+	(void)address;
+#endif
+	return NULL;
+}
+
+/*** end of file ***/
@@ -0,0 +1,66 @@
+/** @file CLI_SHELL_MPU.h
+ *
+ * @brief MPU guard regions of the CLI Shell: stack overflow and buffer overrun trapping
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - shellMpuInit() (top of main(), after shellCrashInit()) sets up two no-access regions and
+ *    enables the MPU with the default memory map underneath (PRIVDEFENA), so nothing else
+ *    changes and there is no cost per access:
+ *      - Stack guard: SHELL_MPU_STACK_GUARD_LEN bytes right below the stack reserve of the
+ *        linker script (_estack - _Min_Stack_Size). A stack that outgrows its reserve faults on
+ *        the first word it writes there instead of running into the heap.
+ *      - Buffer guard: SHELL_MPU_BUFFER_GUARD_LEN bytes at _snoinit_guard, the end of .noinit
+ *        where the receive rings, DMA and transmit buffers live (SHELL_NOINIT). A write running
+ *        off the last of them faults. Overruns between the buffers are not caught, only the one
+ *        off the end of the section, past the padding to the 32 byte alignment.
+ *  - Both linker scripts reserve the guards: SHELL_MPU_STACK_GUARD_LEN in ._user_heap_stack,
+ *    _snoinit_guard inside .noinit. Keep them in step with the defines.
+ *  - A hit is a MemManage fault, the post-mortem record (CLI_SHELL_CRASH.h) names the guard.
+ *    The fault handlers turn the MPU off first, they run on the stack that just overflowed.
+ *    A guard hit while stacking an exception (MSTKERR) leaves no stacked registers.
+ *  - _sbrk() hands out heap up to the stack pointer: a heap that grows into the stack guard
+ *    faults as well. "mem" starts the stack scan above the guard.
+ *  - Only the main stack is guarded. FreeRTOS task stacks (SHELL_RTOS_ENABLED) are checked by
+ *    configCHECK_FOR_STACK_OVERFLOW. DMA transfers bypass the MPU.
+ *  - Define SHELL_MPU_ENABLE as 0 to leave the MPU off.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_MPU_H_
+#define CLI_SHELL_MPU_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_MPU_ENABLE
+#define SHELL_MPU_ENABLE				(!SHELL_HOST_BUILD)
+#endif
+
+#define SHELL_MPU_STACK_GUARD_LEN		256			/*!< Power of two, 32 or more			*/
+#define SHELL_MPU_BUFFER_GUARD_LEN		32			/*!< Power of two, 32 or more			*/
+
+#define SHELL_MPU_REGION_STACK			0
+#define SHELL_MPU_REGION_BUFFERS		1
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellMpuInit(void);
+uint32_t shellMpuStackFloor(void);
+const char* shellMpuGuardName(uint32_t address);
+
+#endif // CLI_SHELL_MPU_H_
+
+/*** end of file ***/
@@ -0,0 +1,85 @@
+/** @file CLI_SHELL_NOTIFY.c
+ *
+ * @brief Event notifications of the CLI Shell and the "notify" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_NOTIFY.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static volatile uint32_t notifyMask = 0;			/*!< Enabled event codes, off at startup	*/
+static volatile uint32_t notifySent = 0;
+static volatile uint32_t notifyDropped = 0;		/*!< Enabled but no room or no channel		*/
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sends an event record to the host, if the host has enabled the event
+  * @note	Interrupt safe.
+  * @param[IN]  ctx Shell instance the event belongs to (its port)
+  * @param[IN]  event Event code (shellNotifyEvent_t)
+  * @param[IN]  value Event value
+  * @retval bool Returns true if the record was queued
+  */
+bool shellNotify(shell_ctx_t* ctx, uint8_t event, uint32_t value) {
+	if (event >= notifyEvt_count || !(notifyMask & (1UL << event)) || ctx == NULL || !ctx->initialized) {
+		return false;
+	}
+	if (!transportNotify(ctx, event, value)) {
+		notifyDropped++;
+		return false;
+	}
+	notifySent++;
+	return true;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Sets the enabled events (m), sends a test event (t), shows the counts
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error NotifyBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 80);
+
+	if (shellHasArg(parserInput, argTkn_m)) {
+		notifyMask = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_m)).u32;
+	}
+
+	if (shellHasArg(parserInput, argTkn_t) &&
+			!shellNotify(ctx, notifyEvt_test, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_t)).u32)) {
+		// Not enabled, no room or no notification channel on this port
+		return SHELL_ERR;
+	}
+
+	shellStrAppend(&str, "Notify: mask 0x");
+	shellStrAppendHex(&str, notifyMask, 8);
+	shellStrAppend(&str, ", ");
+	shellStrAppendUnsigned(&str, notifySent, 0);
+	shellStrAppend(&str, " sent, ");
+	shellStrAppendUnsigned(&str, notifyDropped, 0);
+	shellStrAppend(&str, " dropped\r\n");
+	shellStrSend(ctx, &str);
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,68 @@
+/** @file CLI_SHELL_NOTIFY.h
+ *
+ * @brief Event notifications of the CLI Shell: small event records on the USB interrupt endpoint
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) notifyEvt_i2cDone
+ *
+ * Usage Notes:
+ *  - shellNotify() sends an event record (code, value) outside of the data channel. On USB it
+ *    goes over the CDC notification endpoint EP 0x82 (CDC_Notify_FS(), usbd_cdc_if.c), polled
+ *    every frame, so the host learns of it within about 1 ms without reading or parsing the
+ *    responses. The record tells the port it belongs to. Transports without such a channel
+ *    (USART, host build) drop the events.
+ *  - The host enables the events it wants with "notify m<mask>", bit n for event code n. All are
+ *    off at startup: an OS driver bound to the CDC ACM port (cdc_acm, usbser) reads the endpoint
+ *    too and ignores or logs records it does not know. "notify" shows the mask and the counts,
+ *    "notify t<value>" sends a notifyEvt_test record to check the path.
+ *  - Events of the shell, value in brackets:
+ *      notifyEvt_test (value of "t"), notifyEvt_jobDone (response code in bits 0-7, request tag
+ *      in bits 8-31, 0xFFFFFF without), notifyEvt_rxHeld (bytes free in the receive ring when
+ *      the USB OUT endpoint was held back), notifyEvt_i2cDone (request id in bits 0-7, its
+ *      shellI2cStatus_t in bits 8-15).
+ *    Application events (a threshold crossed, a buffer at its high-water mark) use codes from
+ *    notifyEvt_user up, e.g. shellNotify(&operatorShell, notifyEvt_user + 0, adcValue).
+ *  - Interrupt safe. Up to 8 records wait for the endpoint, shellNotify() fails and counts the
+ *    event as dropped while they do. The host sees the gap in the sequence number.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_NOTIFY_H_
+#define CLI_SHELL_NOTIFY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Event codes, bit n of the "notify m" mask enables code n
+  */
+typedef enum {
+	notifyEvt_test = 0,						/*!< "notify t<value>"						*/
+	notifyEvt_jobDone,						/*!< A job has answered						*/
+	notifyEvt_rxHeld,						/*!< Receive ring full, input held back		*/
+	notifyEvt_i2cDone,						/*!< An I2C request has finished (CLI_SHELL_I2C.h)	*/
+
+	notifyEvt_user = 16,					/*!< First application event				*/
+	notifyEvt_count = 32
+} shellNotifyEvent_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellNotify(shell_ctx_t* ctx, uint8_t event, uint32_t value);
+
+#endif // CLI_SHELL_NOTIFY_H_
+
+/*** end of file ***/
@@ -0,0 +1,416 @@
+/** @file CLI_SHELL_PATTERN.c
+ *
+ * @brief GPIO pattern generator of the CLI Shell: pattern load, TIM1/DMA2 output and "pattern"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Handler profiled (CLI_SHELL_ISR)
+ * - 1.2: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_PATTERN.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_ISR.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define PATTERN_TIMER			TIM1
+#define PATTERN_GPIO_PORT		GPIOB
+#define PATTERN_DMA_STREAM		DMA2_Stream5
+#define PATTERN_DMA_IRQn		DMA2_Stream5_IRQn
+#define PATTERN_DMA_CHANNEL		DMA_CHANNEL_6		/*!< TIM1_UP							*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Pattern buffer and output state
+  */
+typedef struct {
+	uint32_t words[SHELL_PATTERN_MAX_SAMPLES];	/*!< BSRR word of every sample			*/
+	uint16_t samples;						/*!< Samples loaded							*/
+	uint16_t mask;							/*!< Pins driven by the pattern				*/
+
+	uint32_t rate;							/*!< Requested samples per second			*/
+	uint16_t prescaler;						/*!< TIM1 PSC								*/
+	uint16_t reload;						/*!< TIM1 ARR								*/
+	bool once;
+	volatile bool running;
+	volatile bool dmaError;
+	volatile uint32_t passes;				/*!< Complete passes through the pattern	*/
+
+	uint16_t loadRemaining;					/*!< Load: samples still expected			*/
+	uint16_t loadMask;
+	uint8_t pending[2];						/*!< Load: bytes of the next sample			*/
+	uint8_t pendingLen;
+	uint32_t lastTick;						/*!< Load: last byte received				*/
+} shellPattern_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellPattern_t pattern = { .mask = SHELL_PATTERN_DEFAULT_MASK };
+static TIM_HandleTypeDef patternTimer;
+static DMA_HandleTypeDef patternDma;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t patternTimerClock(void);
+static bool patternDividers(uint32_t rate);
+static void patternDmaDone(DMA_HandleTypeDef* hdma);
+static void patternDmaError(DMA_HandleTypeDef* hdma);
+static bool receivePattern(shell_ctx_t* ctx);
+static void reportPattern(shell_ctx_t* ctx);
+static shell_error patternJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Counter clock of TIM1
+  * @note	The APB2 timers run at twice PCLK2 whenever the APB2 prescaler divides.
+  * @param  NONE
+  * @retval uint32_t Frequency (Hz)
+  */
+static uint32_t patternTimerClock(void) {
+	uint32_t timerClock = HAL_RCC_GetPCLK2Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+		timerClock *= 2;
+	}
+	return timerClock;
+}
+
+/**
+  * @brief  Prescaler and reload of the nearest rate the timer clock can divide to
+  * @param[IN]  rate Samples per second
+  * @retval bool Returns false if the rate is out of range
+  */
+static bool patternDividers(uint32_t rate) {
+	uint32_t timerClock = patternTimerClock();
+
+	if (rate == 0 || rate > SHELL_PATTERN_MAX_RATE || rate > timerClock) {
+		return false;
+	}
+
+	uint32_t ticks = (timerClock + (rate / 2)) / rate;
+	uint32_t prescaler = (ticks - 1) / 65536U;
+	uint32_t reload = (ticks / (prescaler + 1)) - 1;
+
+	if (prescaler > UINT16_MAX) {
+		return false;
+	}
+	pattern.prescaler = prescaler;
+	pattern.reload = reload;
+	return true;
+}
+
+/**
+  * @brief  Transfer complete: one pass through the pattern
+  * @note	A single pass stops the timer here, the DMA has already stopped itself.
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void patternDmaDone(DMA_HandleTypeDef* hdma) {
+	pattern.passes++;
+	if (pattern.once) {
+		__HAL_TIM_DISABLE(&patternTimer);
+		pattern.running = false;
+	}
+}
+
+/**
+  * @brief  Transfer error, the HAL has stopped the stream
+  * @param[IN]  hdma Stream
+  * @retval NONE
+  */
+static void patternDmaError(DMA_HandleTypeDef* hdma) {
+	__HAL_TIM_DISABLE(&patternTimer);
+	pattern.dmaError = true;
+	pattern.running = false;
+}
+
+/**
+  * @brief  Converts the received bytes of a load into BSRR words
+  * @param[IN]  ctx Shell instance of the job
+  * @retval bool Returns true once all samples are stored
+  */
+static bool receivePattern(shell_ctx_t* ctx) {
+	uint8_t byte;
+
+	while (pattern.loadRemaining != 0 && shellRingGet(&ctx->rxRing, &byte)) {
+		pattern.pending[pattern.pendingLen++] = byte;
+		pattern.lastTick = HAL_GetTick();
+
+		if (pattern.pendingLen == sizeof(pattern.pending)) {
+			uint16_t level = (uint16_t)pattern.pending[0] | ((uint16_t)pattern.pending[1] << 8);
+
+			// Set the high pins, reset the low pins of the mask
+			pattern.words[pattern.samples++] = (uint32_t)(level & pattern.loadMask) |
+					((uint32_t)(~level & pattern.loadMask) << 16);
+			pattern.loadRemaining--;
+			pattern.pendingLen = 0;
+		}
+	}
+	return pattern.loadRemaining == 0;
+}
+
+/**
+  * @brief  Sends the result line of a load
+  * @param[IN]  ctx Shell instance of the job
+  * @retval NONE
+  */
+static void reportPattern(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 40);
+
+	shellStrAppend(&str, "PATTERN: ");
+	shellStrAppendUnsigned(&str, pattern.samples, 0);
+	shellStrAppend(&str, " samples\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Poll function of a pattern load
+  * @note	A load that is cancelled or times out leaves no pattern.
+  * @param[IN]  job The load job
+  * @retval shell_error SHELL_BUSY while samples are expected, SHELL_ERR on a timeout
+  */
+static shell_error patternJob(shellJob_t* job) {
+	if (job->cancel) {
+		pattern.samples = 0;
+		reportPattern(job->ctx);
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	SHELL_JOB_WAIT_UNTIL(job, receivePattern(job->ctx) || (HAL_GetTick() - pattern.lastTick) >= SHELL_PATTERN_IDLE_MS);
+	job->ownsInput = false;
+	if (pattern.loadRemaining != 0) {
+		pattern.samples = 0;
+		reportPattern(job->ctx);
+		job->state = 0;
+		return SHELL_ERR;
+	}
+	pattern.mask = pattern.loadMask;
+	reportPattern(job->ctx);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts the output of the loaded pattern
+  * @param[IN]  rate Samples per second, up to SHELL_PATTERN_MAX_RATE
+  * @param[IN]  once One pass instead of repeating
+  * @retval bool Returns false if there is no pattern, the rate is out of range or the DMA failed
+  */
+bool shellPatternStart(uint32_t rate, bool once) {
+	GPIO_InitTypeDef gpioInit = {0};
+
+	shellPatternStop();
+	if (pattern.samples == 0 || !patternDividers(rate)) {
+		return false;
+	}
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_TIM1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	gpioInit.Pin = pattern.mask;
+	gpioInit.Mode = GPIO_MODE_OUTPUT_PP;
+	gpioInit.Pull = GPIO_NOPULL;
+	gpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(PATTERN_GPIO_PORT, &gpioInit);
+
+	patternDma.Instance = PATTERN_DMA_STREAM;
+	patternDma.Init.Channel = PATTERN_DMA_CHANNEL;
+	patternDma.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	patternDma.Init.PeriphInc = DMA_PINC_DISABLE;
+	patternDma.Init.MemInc = DMA_MINC_ENABLE;
+	patternDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+	patternDma.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+	patternDma.Init.Mode = once ? DMA_NORMAL : DMA_CIRCULAR;
+	patternDma.Init.Priority = DMA_PRIORITY_VERY_HIGH;
+	patternDma.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+	if (HAL_DMA_Init(&patternDma) != HAL_OK) {
+		return false;
+	}
+
+	// HAL_DMA_Init() clears the callbacks
+	patternDma.XferCpltCallback = patternDmaDone;
+	patternDma.XferErrorCallback = patternDmaError;
+
+	pattern.rate = rate;
+	pattern.once = once;
+	pattern.passes = 0;
+	pattern.dmaError = false;
+
+	HAL_NVIC_SetPriority(PATTERN_DMA_IRQn, SHELL_PATTERN_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(PATTERN_DMA_IRQn);
+	if (HAL_DMA_Start_IT(&patternDma, (uint32_t)pattern.words, (uint32_t)&PATTERN_GPIO_PORT->BSRR, pattern.samples) != HAL_OK) {
+		return false;
+	}
+
+	// The update event of HAL_TIM_Base_Init() comes before the DMA request is enabled
+	patternTimer.Instance = PATTERN_TIMER;
+	patternTimer.Init.Prescaler = pattern.prescaler;
+	patternTimer.Init.CounterMode = TIM_COUNTERMODE_UP;
+	patternTimer.Init.Period = pattern.reload;
+	patternTimer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	patternTimer.Init.RepetitionCounter = 0;
+	patternTimer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	if (HAL_TIM_Base_Init(&patternTimer) != HAL_OK) {
+		HAL_DMA_Abort(&patternDma);
+		return false;
+	}
+
+	pattern.running = true;
+	__HAL_TIM_ENABLE_DMA(&patternTimer, TIM_DMA_UPDATE);
+	__HAL_TIM_ENABLE(&patternTimer);
+	return true;
+}
+
+/**
+  * @brief  Stops the output, the pins keep the last sample
+  * @param  NONE
+  * @retval NONE
+  */
+void shellPatternStop(void) {
+	if (patternTimer.Instance == NULL) {
+		return;
+	}
+
+	__HAL_TIM_DISABLE(&patternTimer);
+	__HAL_TIM_DISABLE_DMA(&patternTimer, TIM_DMA_UPDATE);
+	HAL_DMA_Abort(&patternDma);
+	HAL_NVIC_DisableIRQ(PATTERN_DMA_IRQn);
+	pattern.running = false;
+}
+
+/**
+  * @brief  Keeps the rate after a clock profile change
+  * @note	Called by shellClockApply(). The new dividers are loaded at the next update.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellPatternClockChanged(void) {
+	if (pattern.running && patternDividers(pattern.rate)) {
+		__HAL_TIM_SET_PRESCALER(&patternTimer, pattern.prescaler);
+		__HAL_TIM_SET_AUTORELOAD(&patternTimer, pattern.reload);
+	}
+}
+
+/**
+  * @brief  DMA2 Stream 5, end of a pass
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream5_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&patternDma);
+	SHELL_ISR_RECORD(isrId_pattern, start, SHELL_ISR_NO_LATENCY);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Loads (l, m), starts (r, o), stops (s0) or shows the pattern output
+  * @note	See CLI_SHELL_PATTERN.h for the arguments and the load format.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while a pattern is received
+  */
+shell_error PatternBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 100);
+
+	if (shellHasArg(parserInput, argTkn_s)) {
+		if (shellArgValue(parserInput, shellFindArg(parserInput, argTkn_s)).u8 != 0) {
+			return SHELL_ERR;
+		}
+		shellPatternStop();
+		return SHELL_OK;
+	}
+
+	if (shellHasArg(parserInput, argTkn_l)) {
+		uint16_t samples = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_l)).u16;
+		uint16_t mask = SHELL_PATTERN_DEFAULT_MASK;
+
+		if (shellHasArg(parserInput, argTkn_m)) {
+			mask = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_m)).u16;
+		}
+		if (samples == 0 || samples > SHELL_PATTERN_MAX_SAMPLES || mask == 0 || pattern.running || shellJobRunning()) {
+			return SHELL_ERR;
+		}
+
+		shellJob_t* job = shellJobStart(ctx, patternJob);
+		if (job == NULL) {
+			return SHELL_ERR;
+		}
+
+		pattern.samples = 0;
+		pattern.loadRemaining = samples;
+		pattern.loadMask = mask;
+		pattern.pendingLen = 0;
+		pattern.lastTick = HAL_GetTick();
+
+		// Bytes after the command line belong to the pattern
+		job->ownsInput = true;
+		return SHELL_BUSY;
+	}
+
+	if (shellHasArg(parserInput, argTkn_r)) {
+		uint32_t rate = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u32;
+		return shellPatternStart(rate, shellHasArg(parserInput, argTkn_o)) ? SHELL_OK : SHELL_ERR;
+	}
+
+	const char* state = pattern.running ? "running" : "stopped";
+	if (pattern.dmaError) {
+		state = "DMA error";
+	}
+	shellStrAppend(&str, "Pattern: ");
+	shellStrAppend(&str, state);
+	shellStrAppend(&str, ", ");
+	shellStrAppendUnsigned(&str, pattern.samples, 0);
+	shellStrAppend(&str, " samples, mask 0x");
+	shellStrAppendHex(&str, pattern.mask, 4);
+	shellStrAppend(&str, ", ");
+	shellStrAppendUnsigned(&str, pattern.passes, 0);
+	shellStrAppend(&str, " passes\r\n");
+	shellStrSend(ctx, &str);
+
+	if (pattern.rate != 0) {
+		uint32_t divider = ((uint32_t)pattern.prescaler + 1) * ((uint32_t)pattern.reload + 1);
+		shellStrAppend(&str, "Rate: ");
+		shellStrAppendUnsigned(&str, pattern.rate, 0);
+		shellStrAppend(&str, " Hz requested, ");
+		shellStrAppendUnsigned(&str, patternTimerClock() / divider, 0);
+		shellStrAppend(&str, " Hz actual (PSC ");
+		shellStrAppendUnsigned(&str, pattern.prescaler, 0);
+		shellStrAppend(&str, ", ARR ");
+		shellStrAppendUnsigned(&str, pattern.reload, 0);
+		shellStrAppend(&str, pattern.once ? "), once\r\n" : ")\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,59 @@
+/** @file CLI_SHELL_PATTERN.h
+ *
+ * @brief GPIO pattern generator of the CLI Shell: TIM1 paced DMA from RAM to GPIOB BSRR
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "pattern l<samples> m<mask>" loads a pattern: the host sends samples * 2 raw bytes right after
+ *    the command line, one 16-bit GPIOB level per sample (little endian). Only the pins in mask are
+ *    driven (default SHELL_PATTERN_DEFAULT_MASK), the others keep their state. The response follows
+ *    the last byte, "PATTERN: <samples> samples". The load gives up after SHELL_PATTERN_IDLE_MS
+ *    without data. A pattern can only be loaded while the output is stopped.
+ *    In a text session a 0x03 byte is Ctrl-C and aborts the load, use the binary mode for such data.
+ *  - Every sample is stored as the BSRR word that sets the high and resets the low pins of the
+ *    mask, so one DMA write per sample changes all pins at the same time.
+ *  - "pattern r<rate>" outputs the pattern at rate samples per second over and over, "pattern r<rate> o"
+ *    once. TIM1 update events request DMA2 Stream 5 (channel 6), which writes the next word to
+ *    GPIOB->BSRR. No CPU is involved after the start, the timing is exact to the timer clock.
+ *    The rate is rounded to a divider of the APB2 timer clock, "pattern" shows the actual rate.
+ *  - Rates up to SHELL_PATTERN_MAX_RATE. Above about 8 MHz the DMA requests start to come faster
+ *    than DMA2 can serve them next to the USB and flash traffic.
+ *  - "pattern s0" stops the output. The pins keep the last sample. "pattern" shows the state.
+ *  - The rate is recomputed for the new APB2 timer clock by shellClockApply() (CLI_SHELL_CLOCK.h).
+ *  - Leave GPIOB pins of other functions (USART1 on PB6/PB7, the LEDs on PB0/PB1) out of the mask.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_PATTERN_H_
+#define CLI_SHELL_PATTERN_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_PATTERN_MAX_SAMPLES		2048		/*!< BSRR words in RAM (8 KB)			*/
+#define SHELL_PATTERN_DEFAULT_MASK		0xFF00		/*!< PB8 to PB15						*/
+#define SHELL_PATTERN_MAX_RATE			8000000U	/*!< Samples per second					*/
+#define SHELL_PATTERN_IDLE_MS			2000		/*!< Load timeout without data			*/
+#define SHELL_PATTERN_IRQ_PRIORITY		3			/*!< Only counts the passes				*/
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellPatternStart(uint32_t rate, bool once);
+void shellPatternStop(void);
+void shellPatternClockChanged(void);
+
+#endif // CLI_SHELL_PATTERN_H_
+
+/*** end of file ***/
@@ -0,0 +1,75 @@
+/** @file CLI_SHELL_PERF.c
+ *
+ * @brief Cycle counter profiling of the CLI Shell command pipeline
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) No DWT in the host build
+ * - 1.2: 10-14-2026 (Crandell) Keeps the count, it runs from reset (CLI_SHELL_BOOT)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL_PERF.h"
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts the DWT cycle counter
+  * @note	Reset_Handler has started it already, the count since reset is kept for the boot stamps.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellPerfInit(void) {
+#if SHELL_PERF_ENABLE && !SHELL_HOST_BUILD
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+/**
+  * @brief  Clears a table of statistics
+  * @param[OUT] stats Statistics table
+  * @param[IN]  count Number of entries
+  * @retval NONE
+  */
+void shellPerfReset(shellPerfStat_t* stats, uint16_t count) {
+	memset(stats, 0, count * sizeof(shellPerfStat_t));
+	for (uint16_t i = 0; i < count; i++) {
+		stats[i].minCycles = UINT32_MAX;
+	}
+}
+
+/**
+  * @brief  Adds one run to a command's statistics
+  * @param[OUT] stat Statistics of the command
+  * @param[IN]  stamps perfStage_count + 1 cycle stamps: the start, then the end of each stage
+  * @retval NONE
+  */
+void shellPerfRecord(shellPerfStat_t* stat, const uint32_t* stamps) {
+	uint32_t total = stamps[perfStage_count] - stamps[0];
+
+	stat->count++;
+	stat->totalCycles += total;
+	if (total < stat->minCycles) {
+		stat->minCycles = total;
+	}
+	if (total > stat->maxCycles) {
+		stat->maxCycles = total;
+	}
+
+	for (uint8_t i = 0; i < perfStage_count; i++) {
+		stat->stageCycles[i] += stamps[i + 1] - stamps[i];
+	}
+}
+
+/*** end of file ***/
@@ -0,0 +1,102 @@
+/** @file CLI_SHELL_PERF.h
+ *
+ * @brief Cycle counter profiling of the CLI Shell command pipeline
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) SHELL_RAMFUNC placement
+ * - 1.2: 10-14-2026 (Crandell) Host build counts nanoseconds
+ * - 1.3: 10-15-2026 (Crandell) Deadline overruns
+ *
+ * Usage Notes:
+ *  - Uses the Cortex-M4 DWT cycle counter. It runs from reset (Reset_Handler) and keeps running
+ *    with or without a debugger attached. The host build (SHELL_HOST_BUILD) counts nanoseconds.
+ *  - Define SHELL_PERF_ENABLE as 0 to compile the profiling out.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_PERF_H_
+#define CLI_SHELL_PERF_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_PORT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_PERF_ENABLE
+#define SHELL_PERF_ENABLE			1
+#endif
+
+/**
+  * @brief  Current cycle count. Wraps every 2^32 cycles (~45 s at 96 MHz), differences stay valid.
+  */
+#if SHELL_PERF_ENABLE && SHELL_HOST_BUILD
+#define shellPerfCycles()			shellHostCycles()
+#elif SHELL_PERF_ENABLE
+#define shellPerfCycles()			(DWT->CYCCNT)
+#else
+#define shellPerfCycles()			(0U)
+#endif
+
+/**
+  * @brief  Places a hot path function in RAM. At 3 wait states every taken branch that misses the
+  * 		flash accelerator stalls, RAM runs at zero wait states.
+  * @note	The .RamFunc section is part of .data in STM32F411RETX_FLASH.ld, so the startup code
+  * 		copies it together with the initialized data. Set SHELL_RAMFUNC_ENABLE to 0 to keep
+  * 		everything in flash, e.g. to compare "perf"/"bench" results.
+  */
+#ifndef SHELL_RAMFUNC_ENABLE
+#define SHELL_RAMFUNC_ENABLE		(!SHELL_HOST_BUILD)
+#endif
+
+#if SHELL_RAMFUNC_ENABLE
+#define SHELL_RAMFUNC				__attribute__((section(".RamFunc"), noinline))
+#else
+#define SHELL_RAMFUNC
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Pipeline stages timed for every command
+  */
+typedef enum {
+	perfStage_parse = 0,					/*!< Tokenize (0 for binary frames)		*/
+	perfStage_match,						/*!< Command Table lookup (0 for binary frames)	*/
+	perfStage_validate,						/*!< Argument validation					*/
+	perfStage_bridge,						/*!< Bridge function						*/
+	perfStage_count
+} shellPerfStage_t;
+
+/**
+  * @brief  Statistics of one command
+  */
+typedef struct {
+	uint32_t count;							/*!< Number of timed runs					*/
+	uint32_t minCycles;						/*!< Fastest run, parse to bridge return	*/
+	uint32_t maxCycles;						/*!< Slowest run, parse to bridge return	*/
+	uint64_t totalCycles;					/*!< Sum of all runs (for the mean)			*/
+	uint64_t stageCycles[perfStage_count];	/*!< Sum of each stage (for the stage means)	*/
+	uint32_t overruns;						/*!< Bridge runs past the deadline			*/
+} shellPerfStat_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellPerfInit(void);
+void shellPerfReset(shellPerfStat_t* stats, uint16_t count);
+void shellPerfRecord(shellPerfStat_t* stat, const uint32_t* stamps);
+
+#endif // CLI_SHELL_PERF_H_
+
+/*** end of file ***/
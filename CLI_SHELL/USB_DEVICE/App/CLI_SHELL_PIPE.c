@@ -0,0 +1,225 @@
+/** @file CLI_SHELL_PIPE.c
+ *
+ * @brief Command pipeline of the CLI Shell: the next line is tokenized and matched while a bridge runs
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_PIPE.h"
+#include "CLI_SHELL_TRACE.h"
+#include "CLI_SHELL_CRASH.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define PIPE_IS_TERMINATOR(c)			((((SHELL_LINE_TERMINATORS) & SHELL_TERM_CR) && (c) == '\r') || \
+										 (((SHELL_LINE_TERMINATORS) & SHELL_TERM_LF) && (c) == '\n'))
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The second parser output of an instance and the line it refers to
+  * @note	Written by the receive interrupt while shellPipe_t.state is SHELL_PIPE_EMPTY, read by
+  * 		checkShellStatus() once it is SHELL_PIPE_READY.
+  */
+typedef struct {
+	shell_ctx_t* ctx;						/*!< Instance the slot belongs to			*/
+	uint8_t line[SHELL_BUFFER_LEN + 2];		/*!< Peeked bytes, tokenized from skip on	*/
+	uint8_t skip;							/*!< LF folded into the line before			*/
+	uint8_t lineLen;						/*!< Characters before the terminator		*/
+	bool lastWasCR;							/*!< Terminator was a CR (LF may follow)	*/
+	uint16_t commandIndex;
+	shellParserOutput_t parserOutput;		/*!< Slices of line[skip]					*/
+} shellPipeSlot_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellPipeSlot_t slots[SHELL_PIPE_MAX_INSTANCES];
+static uint8_t slotCount;
+
+static volatile uint32_t aheadLines;		/*!< Lines parsed ahead						*/
+static volatile uint32_t aheadCycles;		/*!< Their stage one cycles					*/
+static volatile uint32_t declinedLines;		/*!< Lines left to the normal path			*/
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Gives the instance a slot, called by shellInit()
+  * @note	Instances past SHELL_PIPE_MAX_INSTANCES run without the pipeline.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellPipeAttach(shell_ctx_t* ctx) {
+	ctx->pipe.state = SHELL_PIPE_EMPTY;
+	ctx->pipe.open = false;
+
+	for (uint8_t i = 0; i < slotCount; i++) {
+		if (slots[i].ctx == ctx) {
+			ctx->pipe.slot = i;
+			return;
+		}
+	}
+	if (!SHELL_PIPE_ENABLED || slotCount >= SHELL_PIPE_MAX_INSTANCES) {
+		ctx->pipe.slot = SHELL_PIPE_NO_SLOT;
+		return;
+	}
+	slots[slotCount].ctx = ctx;
+	ctx->pipe.slot = slotCount++;
+}
+
+/**
+  * @brief  Tokenizes and matches the next line of the ring (stage one)
+  * @note	Called by rxShellInput() in the receive interrupt after the packet went into the
+  * 		ring. Does nothing unless a line of this instance is running and the slot is empty.
+  * 		A line not complete yet is tried again with the next packet.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellPipePrefetch(shell_ctx_t* ctx) {
+	shellPipe_t* pipe = &ctx->pipe;
+
+	if (!pipe->open || pipe->state != SHELL_PIPE_EMPTY || pipe->slot == SHELL_PIPE_NO_SLOT ||
+			ctx->mode != SHELL_MODE_TEXT || ctx->edit.echo || ctx->outputMuted) {
+		return;
+	}
+
+	shellPipeSlot_t* slot = &slots[pipe->slot];
+	uint32_t count = shellRingPeek(&ctx->rxRing, slot->line, sizeof(slot->line));
+	uint32_t skip = (count > 0 && ctx->lastWasCR && slot->line[0] == '\n') ? 1 : 0;
+	uint32_t end = skip;
+
+	while (end < count && !PIPE_IS_TERMINATOR(slot->line[end])) {
+		end++;
+	}
+	if (end == count) {
+		// Longer than a line, the normal path answers it
+		if (count == sizeof(slot->line)) {
+			pipe->state = SHELL_PIPE_DECLINED;
+			declinedLines++;
+		}
+		return;
+	}
+	for (uint32_t i = skip; i < end; i++) {
+		if (slot->line[i] < ' ' || slot->line[i] > '~') {
+			// Editing keys, Ctrl-C, Tab
+			end = skip;
+			break;
+		}
+	}
+
+	uint8_t terminator = slot->line[end];
+	uint32_t start = shellPerfCycles();
+
+	if (end == skip || !shellParseAhead(&slot->line[skip], end - skip, &slot->parserOutput, &slot->commandIndex)) {
+		pipe->state = SHELL_PIPE_DECLINED;
+		declinedLines++;
+		return;
+	}
+	aheadCycles += shellPerfCycles() - start;
+	aheadLines++;
+
+	slot->skip = (uint8_t)skip;
+	slot->lineLen = (uint8_t)(end - skip);
+	slot->lastWasCR = (terminator == '\r' && (SHELL_LINE_TERMINATORS & SHELL_TERM_LF));
+	pipe->state = SHELL_PIPE_READY;
+}
+
+/**
+  * @brief  Whether checkShellStatus() can take the next line from the slot
+  * @note	Drops a slot that is declined or stale (the session left text mode, echo was
+  * 		turned on). Called between lines, the interrupt does not touch the slot then.
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns true if shellPipeRun() runs the next line
+  */
+bool shellPipeReady(shell_ctx_t* ctx) {
+	if (ctx->pipe.state == SHELL_PIPE_EMPTY) {
+		return false;
+	}
+	if (ctx->pipe.state == SHELL_PIPE_READY && ctx->mode == SHELL_MODE_TEXT && ctx->rxLen == 0 &&
+			!ctx->edit.echo) {
+		return true;
+	}
+	ctx->pipe.state = SHELL_PIPE_EMPTY;
+	return false;
+}
+
+/**
+  * @brief  Runs the line parsed ahead from validation on (stage two)
+  * @note	The line is read out of the ring into the line buffer as received and recorded by
+  * 		the history, then the tokenized copy goes over it and the parser output is moved
+  * 		onto the line buffer. The slot is free for the line after it before the bridge runs.
+  * @param[IN]  ctx Shell instance
+  * @retval shell_error Error Return Value
+  */
+shell_error shellPipeRun(shell_ctx_t* ctx) {
+	shellPipeSlot_t* slot = &slots[ctx->pipe.slot];
+	shellParserOutput_t parserOutput = slot->parserOutput;
+	uint16_t commandIndex = slot->commandIndex;
+	uint32_t len = slot->lineLen;
+	shell_error status;
+
+	shellRingSkip(&ctx->rxRing, slot->skip);
+	shellRingRead(&ctx->rxRing, ctx->rxBuffer, len);
+	shellRingSkip(&ctx->rxRing, 1);
+	ctx->rxLen = len;
+	ctx->lastWasCR = slot->lastWasCR;
+
+	SHELL_TRACE(traceEvt_cmdStart, ctx->port, len);
+	SHELL_CRASH_NOTE(ctx->port, ctx->rxBuffer, len);
+	shellHistoryBegin(ctx, ctx->rxBuffer, len);
+
+	memcpy(ctx->rxBuffer, &slot->line[slot->skip], len + 1);
+	parserOutput.line = &ctx->rxBuffer[parserOutput.line - &slot->line[slot->skip]];
+	ctx->pipe.state = SHELL_PIPE_EMPTY;
+
+	status = shellDispatch(ctx, &parserOutput, commandIndex);
+	shellHistoryEnd(ctx);
+	return status;
+}
+
+/**
+  * @brief  Adds the pipeline line to the "perf" dump
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellPipeReport(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 80);
+	uint32_t lines = aheadLines;
+
+	shellStrAppend(&str, "Pipeline: ");
+	shellStrAppendUnsigned(&str, lines, 0);
+	shellStrAppend(&str, " lines parsed ahead (mean ");
+	shellStrAppendUnsigned(&str, (lines != 0) ? (aheadCycles / lines) : 0, 0);
+	shellStrAppend(&str, " cycles), ");
+	shellStrAppendUnsigned(&str, declinedLines, 0);
+	shellStrAppend(&str, " declined\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Clears the pipeline counters ("perf r1")
+  * @param  NONE
+  * @retval NONE
+  */
+void shellPipeClear(void) {
+	aheadLines = 0;
+	aheadCycles = 0;
+	declinedLines = 0;
+}
+
+/*** end of file ***/
@@ -0,0 +1,86 @@
+/** @file CLI_SHELL_PIPE.h
+ *
+ * @brief Command pipeline of the CLI Shell: the next line is tokenized and matched while a bridge runs
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Lines queued in the receive ring used to run strictly one after the other: assemble,
+ *    tokenize, match, validate, bridge, then the next line. With the pipeline the receive
+ *    interrupt does the first stage of the next line while the current one runs: when a packet
+ *    arrives during shellProcessLine(), the next complete line in the ring is copied into the
+ *    instance's slot, tokenized and matched (shellParseAhead()). checkShellStatus() takes the
+ *    slot instead of assembling the line and goes straight to validation and the bridge.
+ *  - The slot is the second parser output next to the one of the running line, one per instance
+ *    (SHELL_PIPE_MAX_INSTANCES, given out by shellInit()). Lines are taken in ring order, the
+ *    slot only ever holds the line right after the running one.
+ *  - Only plain command lines of printable characters are parsed ahead. Tags, node addresses,
+ *    batches, "every" and "regress" lines, history replays, lines with editing keys, lines
+ *    that fail to tokenize or match and every line while echo is on (CLI_SHELL_EDIT.h) are
+ *    declined and take the normal path, which sends their responses as before. A slot parsed
+ *    for a text session is dropped if the session changed mode meanwhile.
+ *  - The ring is peeked, not read, from the interrupt: the main loop is parked in the bridge and
+ *    reads the line itself when it takes the slot. The history records the line as received.
+ *  - Stage one costs the receive interrupt a few thousand cycles for a line and is done once per
+ *    line. "perf" shows 0 cycles for parse and match of lines parsed ahead, their lines and
+ *    cycles are counted on the "Pipeline:" line ("perf r1" clears them).
+ *  - SHELL_PIPE_ENABLED 0 leaves every line to the main loop.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_PIPE_H_
+#define CLI_SHELL_PIPE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_PIPE_ENABLED
+#define SHELL_PIPE_ENABLED				1
+#endif
+#define SHELL_PIPE_MAX_INSTANCES		4			/*!< Instances with a slot				*/
+#define SHELL_PIPE_NO_SLOT				0xFF
+
+#define SHELL_PIPE_EMPTY				0			/*!< Nothing parsed ahead				*/
+#define SHELL_PIPE_READY				1			/*!< Next line tokenized and matched	*/
+#define SHELL_PIPE_DECLINED				2			/*!< Next line takes the normal path	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/**
+  * @brief  Pipeline state of one shell instance (shell_ctx_t.pipe)
+  * @note	open is set by checkShellStatus() while a line of the ring runs, the interrupt fills
+  * 		the slot only then and only while state is SHELL_PIPE_EMPTY.
+  */
+typedef struct {
+	volatile uint8_t state;					/*!< SHELL_PIPE_EMPTY, _READY or _DECLINED	*/
+	volatile bool open;						/*!< The ring is at the start of the next line	*/
+	uint8_t slot;							/*!< Slot of the instance, SHELL_PIPE_NO_SLOT	*/
+} shellPipe_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellPipeAttach(shell_ctx_t* ctx);
+void shellPipePrefetch(shell_ctx_t* ctx);
+bool shellPipeReady(shell_ctx_t* ctx);
+shell_error shellPipeRun(shell_ctx_t* ctx);
+void shellPipeReport(shell_ctx_t* ctx);
+void shellPipeClear(void);
+
+#endif // CLI_SHELL_PIPE_H_
+
+/*** end of file ***/
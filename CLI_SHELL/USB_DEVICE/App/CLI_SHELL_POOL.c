@@ -0,0 +1,126 @@
+/** @file CLI_SHELL_POOL.c
+ *
+ * @brief Static fixed-block memory pool for the USB class data and the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) CLI_SHELL_PORT.h for the host build
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_POOL.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+_Static_assert((SHELL_POOL_BLOCK_SIZE % 4) == 0, "SHELL_POOL_BLOCK_SIZE must be a multiple of 4");
+_Static_assert((SHELL_POOL_BLOCKS >= 1) && (SHELL_POOL_BLOCKS <= 32), "SHELL_POOL_BLOCKS must be 1 to 32");
+
+#define POOL_ALL_BLOCKS				((uint32_t)(0xFFFFFFFFULL >> (32 - SHELL_POOL_BLOCKS)))
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+SHELL_NOINIT static uint32_t poolStorage[SHELL_POOL_BLOCKS][SHELL_POOL_BLOCK_SIZE / 4];	/*!< Word aligned blocks	*/
+static uint32_t poolUsed = 0;						/*!< Bit n set: block n is allocated		*/
+static uint8_t poolHighWater = 0;					/*!< Most blocks ever allocated at once	*/
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Number of set bits
+  * @param[IN] mask Bit mask
+  * @retval Set bits
+  */
+static uint8_t countBits(uint32_t mask) {
+	uint8_t bits = 0;
+	while (mask) {
+		mask &= mask - 1;
+		bits++;
+	}
+	return bits;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Takes one block from the pool
+  * @note	Safe from thread and interrupt context (USBD_CDC_Init runs inside the USB interrupt).
+  * @param[IN] size Requested bytes
+  * @retval Block, or NULL if size is above SHELL_POOL_BLOCK_SIZE or the pool is empty
+  */
+void* shellPoolAlloc(size_t size) {
+	void* block = NULL;
+
+	if (size > SHELL_POOL_BLOCK_SIZE) {
+		return NULL;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	uint32_t freeBlocks = ~poolUsed & POOL_ALL_BLOCKS;
+	if (freeBlocks != 0) {
+		uint8_t index = (uint8_t)__builtin_ctz(freeBlocks);
+		poolUsed |= (1UL << index);
+		block = poolStorage[index];
+
+		uint8_t inUse = countBits(poolUsed);
+		if (inUse > poolHighWater) {
+			poolHighWater = inUse;
+		}
+	}
+
+	__set_PRIMASK(primask);
+	return block;
+}
+
+/**
+  * @brief  Returns a block to the pool
+  * @note	NULL and pointers that are not the start of a pool block are ignored.
+  * @param[IN] ptr Block from shellPoolAlloc
+  * @retval NONE
+  */
+void shellPoolFree(void* ptr) {
+	uintptr_t offset = (uintptr_t)ptr - (uintptr_t)poolStorage;
+
+	if ((ptr == NULL) || (offset >= sizeof(poolStorage)) || ((offset % SHELL_POOL_BLOCK_SIZE) != 0)) {
+		return;
+	}
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	poolUsed &= ~(1UL << (offset / SHELL_POOL_BLOCK_SIZE));
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Number of blocks allocated now
+  * @param  NONE
+  * @retval Blocks in use
+  */
+uint8_t shellPoolInUse(void) {
+	return countBits(poolUsed);
+}
+
+/**
+  * @brief  Most blocks ever allocated at the same time
+  * @param  NONE
+  * @retval High water mark in blocks
+  */
+uint8_t shellPoolHighWater(void) {
+	return poolHighWater;
+}
+
+/*** end of file ***/
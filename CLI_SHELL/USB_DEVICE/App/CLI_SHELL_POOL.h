@@ -0,0 +1,50 @@
+/** @file CLI_SHELL_POOL.h
+ *
+ * @brief Static fixed-block memory pool for the USB class data and the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Replaces malloc/free for USBD_malloc/USBD_free (see usbd_conf.h). The pool is a static array,
+ *    so its RAM is reserved at link time and allocation never calls _sbrk.
+ *  - Every allocation takes one whole block. Alloc and free are a couple of bit operations with
+ *    interrupts masked, so the latency is the same for every call.
+ *  - SHELL_POOL_BLOCK_SIZE must hold the USBD_CDC_HandleTypeDef (checked in usbd_cdc_if.c).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_POOL_H_
+#define CLI_SHELL_POOL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_POOL_BLOCK_SIZE
+#define SHELL_POOL_BLOCK_SIZE		544		/*!< Bytes per block, multiple of 4		*/
+#endif
+
+#ifndef SHELL_POOL_BLOCKS
+#define SHELL_POOL_BLOCKS			2		/*!< Number of blocks (1 to 32)			*/
+#endif
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void* shellPoolAlloc(size_t size);
+void shellPoolFree(void* ptr);
+uint8_t shellPoolInUse(void);
+uint8_t shellPoolHighWater(void);
+
+#endif // CLI_SHELL_POOL_H_
+
+/*** end of file ***/
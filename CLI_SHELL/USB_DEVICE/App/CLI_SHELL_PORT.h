@@ -0,0 +1,50 @@
+/** @file CLI_SHELL_PORT.h
+ *
+ * @brief Target selection of the CLI Shell core: the STM32F4 device header or the host stand-ins
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) SHELL_NOINIT
+ *
+ * Usage Notes:
+ *  - The core modules include this header instead of stm32f4xx.h. On the target it is just the
+ *    device header. With -DSHELL_HOST_BUILD=1 it is CLI_SHELL_HOST.h, so the parser and dispatch
+ *    core builds with a PC compiler, see CLI_SHELL_HOST.h for the file list.
+ *  - SHELL_NOINIT places a buffer in the .noinit section of the linker script. The startup code
+ *    does not zero it, so only storage that is written before it is read belongs there (ring
+ *    storage, DMA and scratch buffers), or data that is meant to survive a reset. Its content
+ *    after power-up is random. The host build ignores it.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_PORT_H_
+#define CLI_SHELL_PORT_H_
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_HOST_BUILD
+#define SHELL_HOST_BUILD			0
+#endif
+
+#if SHELL_HOST_BUILD
+#define SHELL_NOINIT
+#else
+#define SHELL_NOINIT				__attribute__((section(".noinit")))
+#endif
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#if SHELL_HOST_BUILD
+#include "CLI_SHELL_HOST.h"
+#else
+#include "stm32f4xx.h"
+#endif
+
+#endif // CLI_SHELL_PORT_H_
+
+/*** end of file ***/
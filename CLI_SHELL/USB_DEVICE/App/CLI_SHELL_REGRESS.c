@@ -0,0 +1,329 @@
+/** @file CLI_SHELL_REGRESS.c
+ *
+ * @brief Regression suite of the CLI Shell: recorded command lines with expected output and cycle budgets
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_REGRESS.h"
+
+#if SHELL_BENCHMARK
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define REGRESS_CASE_ENTRY(line, expect, budget)	{ line, expect, budget },
+#define REGRESS_ALL						0xFFFF		/*!< Request: the whole corpus			*/
+#define REGRESS_STREAMED				0xFFFE		/*!< Request: the case from the host	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  One case of the corpus
+  */
+typedef struct {
+	const char* line;						/*!< Command line without terminator		*/
+	const char* expect;						/*!< Text the output must contain			*/
+	uint32_t budget;						/*!< Mean cycles allowed, 0 untimed			*/
+} shellRegressCase_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const shellRegressCase_t regressCases[] = {
+	SHELL_REGRESS_CASES(REGRESS_CASE_ENTRY)
+};
+
+#define NUM_OF_REGRESS_CASES		(sizeof(regressCases) / sizeof(regressCases[0]))
+
+static shell_ctx_t* regressCtx = NULL;				/*!< Instance a run is requested for	*/
+static uint16_t regressRequest;						/*!< Case index, REGRESS_ALL or REGRESS_STREAMED	*/
+static uint16_t regressIterations = SHELL_REGRESS_ITERATIONS;
+
+static bool capturing = false;
+static uint16_t captureLen;
+static char capture[SHELL_REGRESS_CAPTURE_LEN + 1];
+
+static char streamedLine[SHELL_REGRESS_LINE_LEN + 1];
+static char streamedExpect[SHELL_REGRESS_EXPECT_LEN + 1];
+static uint32_t streamedBudget;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool regressCase(shell_ctx_t* ctx, const char* line, const char* expect, uint32_t budget);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Runs one case: a captured warm-up, then the timed runs, and reports it
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Command line without terminator
+  * @param[IN]  expect Text the output must contain
+  * @param[IN]  budget Mean cycles allowed, 0 untimed
+  * @retval bool Returns true if the case passed
+  */
+static bool regressCase(shell_ctx_t* ctx, const char* line, const char* expect, uint32_t budget) {
+	uint8_t input[SHELL_REGRESS_LINE_LEN + 2];
+	uint32_t len = strlen(line);
+
+	if (len > SHELL_REGRESS_LINE_LEN) {
+		len = SHELL_REGRESS_LINE_LEN;
+	}
+	memcpy(input, line, len);
+	input[len++] = '\r';
+
+	ctx->outputMuted = true;
+	captureLen = 0;
+	capturing = true;
+
+	uint32_t start = 0;
+	for (uint16_t n = 0; n <= regressIterations; n++) {
+		uint32_t accepted = len;
+
+		// The USB interrupt is the ring's only other producer
+		NVIC_DisableIRQ(OTG_FS_IRQn);
+		rxShellInput(ctx, input, &accepted);
+		NVIC_EnableIRQ(OTG_FS_IRQn);
+
+		checkShellStatus(ctx);
+
+		// The warm-up run is the captured one, the timing starts after it
+		if (n == 0) {
+			capturing = false;
+			start = shellPerfCycles();
+		}
+	}
+	uint32_t mean = (shellPerfCycles() - start) / regressIterations;
+
+	ctx->outputMuted = false;
+	capture[captureLen] = '\0';
+
+	bool outputOk = (strstr(capture, expect) != NULL);
+	bool timeOk = (budget == 0 || mean <= budget);
+
+	SHELL_STR_DEFINE(str, SHELL_REGRESS_LINE_LEN + 48);
+
+	shellStrAppend(&str, (outputOk && timeOk) ? "PASS " : "FAIL ");
+	shellStrAppendUnsigned(&str, mean, 0);
+	shellStrAppendChar(&str, '/');
+	shellStrAppendUnsigned(&str, budget, 0);
+	shellStrAppend(&str, outputOk ? " " : " output ");
+	shellStrAppendN(&str, line, len - 1);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	outputStreamFlush(ctx);
+
+	return outputOk && timeOk;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Runs a requested regression run. Called from checkShellStatus().
+  * @note	The cases call checkShellStatus() themselves, so the request is cleared first. Lines
+  * 		still in the receive ring go first, they would land in the first case otherwise.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellRegressPoll(shell_ctx_t* ctx) {
+	if (regressCtx != ctx || shellRingUsed(&ctx->rxRing) != 0) {
+		return;
+	}
+	regressCtx = NULL;
+
+	uint16_t failed = 0;
+	uint16_t total = 0;
+
+	if (regressRequest == REGRESS_STREAMED) {
+		total = 1;
+		failed += regressCase(ctx, streamedLine, streamedExpect, streamedBudget) ? 0 : 1;
+	} else {
+		for (uint16_t i = 0; i < NUM_OF_REGRESS_CASES; i++) {
+			if (regressRequest != REGRESS_ALL && regressRequest != i) {
+				continue;
+			}
+			total++;
+			failed += regressCase(ctx, regressCases[i].line, regressCases[i].expect, regressCases[i].budget) ? 0 : 1;
+		}
+	}
+	shellPerfClear();
+
+	SHELL_STR_DEFINE(str, 48);
+
+	if (failed == 0) {
+		shellStrAppend(&str, "REGRESS PASSED: ");
+	} else {
+		shellStrAppend(&str, "REGRESS FAILED: ");
+		shellStrAppendUnsigned(&str, failed, 0);
+		shellStrAppend(&str, " of ");
+	}
+	shellStrAppendUnsigned(&str, total, 0);
+	shellStrAppend(&str, " cases\r\n");
+	shellStrSend(ctx, &str);
+	outputStreamFlush(ctx);
+}
+
+/**
+  * @brief  Keeps muted output of the captured run, called by shellOutputWrite()
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  data Output bytes
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellRegressCapture(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	(void)ctx;
+
+	if (!capturing) {
+		return;
+	}
+	if (len > SHELL_REGRESS_CAPTURE_LEN - captureLen) {
+		len = SHELL_REGRESS_CAPTURE_LEN - captureLen;
+	}
+	memcpy(&capture[captureLen], data, len);
+	captureLen += len;
+}
+
+/**
+  * @brief  Takes a streamed case, regress <budget> "<expected text>" <command line>
+  * @note	Called by shellRunLine() with the line after SHELL_REGRESS_KEYWORD. The case runs
+  * 		from shellRegressPoll() once this line has been answered. Sends the response itself:
+  * 		Argument Error for a malformed case, Line Too Long for a text or line too long and
+  * 		Function Error while a run is pending.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Rest of the line, starts with the budget
+  * @param[IN]  len Number of characters
+  * @retval shell_error Error Return Value
+  */
+shell_error shellRegressLine(shell_ctx_t* ctx, const uint8_t* line, uint32_t len) {
+	uint32_t budget = 0;
+	uint32_t i = 0;
+
+	if (regressCtx != NULL) {
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+		return SHELL_ERR;
+	}
+
+	while (i < len && line[i] >= '0' && line[i] <= '9') {
+		budget = (budget * 10U) + (line[i] - '0');
+		i++;
+	}
+	while (i < len && line[i] == ' ') {
+		i++;
+	}
+	if (i >= len || line[i] != '"') {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+
+	uint32_t expectStart = ++i;
+	while (i < len && line[i] != '"') {
+		i++;
+	}
+	uint32_t expectLen = i - expectStart;
+	if (i >= len) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	i++;
+	while (i < len && line[i] == ' ') {
+		i++;
+	}
+	if (i >= len) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	if (expectLen > SHELL_REGRESS_EXPECT_LEN || len - i > SHELL_REGRESS_LINE_LEN) {
+		shellSendResponse(ctx, RESPONSE_LEN_ERR);
+		return SHELL_ERR;
+	}
+
+	memcpy(streamedExpect, &line[expectStart], expectLen);
+	streamedExpect[expectLen] = '\0';
+	memcpy(streamedLine, &line[i], len - i);
+	streamedLine[len - i] = '\0';
+	streamedBudget = budget;
+
+	regressIterations = SHELL_REGRESS_ITERATIONS;
+	regressRequest = REGRESS_STREAMED;
+	regressCtx = ctx;
+	shellSendResponse(ctx, RESPONSE_OK);
+	return SHELL_OK;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Requests a run of the corpus once the current poll is done
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (c - case, n - timed runs, optional)
+  * @retval shell_error SHELL_ERR for a case that does not exist, no runs or a run pending
+  */
+shell_error RegressBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint16_t request = REGRESS_ALL;
+	uint16_t iterations = SHELL_REGRESS_ITERATIONS;
+
+	if (shellHasArg(parserInput, argTkn_c)) {
+		request = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8;
+		if (request >= NUM_OF_REGRESS_CASES) {
+			return SHELL_ERR;
+		}
+	}
+	if (shellHasArg(parserInput, argTkn_n)) {
+		iterations = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u16;
+	}
+	if (iterations == 0 || regressCtx != NULL) {
+		return SHELL_ERR;
+	}
+
+	regressIterations = iterations;
+	regressRequest = request;
+	regressCtx = ctx;
+	return SHELL_OK;
+}
+
+#else
+
+/**
+  * @brief  Regression suite not built in this configuration
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellRegressPoll(shell_ctx_t* ctx) {
+}
+
+/**
+  * @brief  Regression suite not built in this configuration
+  * @retval NONE
+  */
+void shellRegressCapture(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+}
+
+/**
+  * @brief  Regression suite not built in this configuration, shellRunLine() does not call it
+  * @retval shell_error SHELL_ERR
+  */
+shell_error shellRegressLine(shell_ctx_t* ctx, const uint8_t* line, uint32_t len) {
+	return SHELL_ERR;
+}
+
+#endif // SHELL_BENCHMARK
+
+/*** end of file ***/
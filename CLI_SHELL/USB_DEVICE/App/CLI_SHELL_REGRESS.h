@@ -0,0 +1,88 @@
+/** @file CLI_SHELL_REGRESS.h
+ *
+ * @brief Regression suite of the CLI Shell: recorded command lines with expected output and cycle budgets
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Only built into the "Benchmark" configuration (SHELL_BENCHMARK=1), like "bench".
+ *  - A case is a command line, a text its output must contain and a cycle budget. It runs like
+ *    a "bench" line: through rxShellInput() and checkShellStatus(), with the output muted. One
+ *    untimed run captures the output (up to SHELL_REGRESS_CAPTURE_LEN bytes, response included)
+ *    and warms the caches, then n timed runs give the mean cycles (DWT, shellPerfCycles()) from
+ *    the line going in to checkShellStatus() returning.
+ *  - A case passes if the output contains the expected text and the mean is within the budget.
+ *    Every case reports "PASS <mean>/<budget> <line>" or "FAIL ...", with "output" when the text
+ *    was missing. The run ends with "REGRESS PASSED: <n> cases" or
+ *    "REGRESS FAILED: <failed> of <n> cases", the line a test station checks for.
+ *  - The corpus in flash is SHELL_REGRESS_CASES, CASE(line, expected text, budget cycles).
+ *    "regress" runs all of it, "regress c<case>" one case, "regress n<runs>" sets the timed
+ *    runs per case (default SHELL_REGRESS_ITERATIONS). The project may define its own corpus.
+ *  - The host streams its own cases with the line form
+ *      regress <budget> "<expected text>" <command line>
+ *    e.g. regress 20000 "-->OK!" setLed l1 s0. The line is answered OK right away, the case runs
+ *    after it and reports like the corpus. Budget 0 skips the timing check, "" any output.
+ *  - The budgets of the default corpus are starting points at 100 MHz with room to spare.
+ *    Tighten them to the means of a known good build: a change of CLI_SHELL.c that makes a line
+ *    slower than its budget then fails the suite.
+ *  - Cases must answer within one poll, no jobs ("trace d1", "sleep"). Keep the host quiet
+ *    until the summary line, lines it sends meanwhile run muted between the cases.
+ *  - The timing covers the shell pipeline with the transport muted. "tput" and "usbstat"
+ *    measure the USB path.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_REGRESS_H_
+#define CLI_SHELL_REGRESS_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_BENCH.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_REGRESS_KEYWORD			"regress "	/*!< Line prefix of a streamed case		*/
+#define SHELL_REGRESS_ITERATIONS		10			/*!< Timed runs per case				*/
+#define SHELL_REGRESS_CAPTURE_LEN		256			/*!< Output kept for the text check		*/
+#define SHELL_REGRESS_LINE_LEN			64			/*!< Longest streamed command line		*/
+#define SHELL_REGRESS_EXPECT_LEN		32			/*!< Longest streamed expected text		*/
+
+/**
+  * @brief  Corpus in flash, CASE(command line, expected text, budget in cycles)
+  */
+#ifndef SHELL_REGRESS_CASES
+#define SHELL_REGRESS_CASES(CASE) \
+		CASE("setLed l1 s0",					"-->OK!",				20000) \
+		CASE("   setLed    l2     s1   ",		"-->OK!",				20000) \
+		CASE("setLed lx s1",					"Argument Error!",		20000) \
+		CASE("mode m0",							"-->OK!",				20000) \
+		CASE("help setLed",						"Sets LED to state",	40000) \
+		CASE("{ setLed l1 s1 ; setLed l2 s0 }",	"-->OK!",				40000) \
+		CASE("noSuchCommand a1",				"Command Error!",		20000)
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellRegressPoll(shell_ctx_t* ctx);
+void shellRegressCapture(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+shell_error shellRegressLine(shell_ctx_t* ctx, const uint8_t* line, uint32_t len);
+
+#endif // CLI_SHELL_REGRESS_H_
+
+/*** end of file ***/
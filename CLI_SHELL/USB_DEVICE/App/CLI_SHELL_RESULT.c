@@ -0,0 +1,404 @@
+/** @file CLI_SHELL_RESULT.c
+ *
+ * @brief Structured results of the CLI Shell: typed fields sent as text or as CBOR
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_FORMAT.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  CBOR major types (RFC 8949) and simple values
+  */
+#define CBOR_UINT				0
+#define CBOR_NEGINT				1
+#define CBOR_BYTES				2
+#define CBOR_TEXT				3
+#define CBOR_FALSE				0xF4
+#define CBOR_TRUE				0xF5
+#define CBOR_MAP_START			0xBF		/*!< Map of indefinite length				*/
+#define CBOR_ARRAY_START		0x9F		/*!< Array of indefinite length				*/
+#define CBOR_BREAK				0xFF		/*!< Ends an indefinite length container	*/
+
+#define CBOR_HEAD_MAX			5			/*!< Head with a 32-bit argument			*/
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool resultInList(const shellResult_t* res);
+static void resultRoom(shellResult_t* res, uint16_t length);
+static uint16_t resultField(shellResult_t* res, const char* key, uint16_t valueLen);
+static void resultLineEnd(shellResult_t* res);
+static void resultOpen(shellResult_t* res, const char* key, bool list);
+static void cborHead(shellStr_t* str, uint8_t major, uint32_t argument);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  The innermost open container is a list
+  * @param[IN]  res Result
+  * @retval bool Returns true if fields go without a key
+  */
+static bool resultInList(const shellResult_t* res) {
+	return res->depth > 0 && (res->lists & (1U << (res->depth - 1))) != 0;
+}
+
+/**
+  * @brief  Sends what has been built if the next length does not fit behind it
+  * @note	The truncated flag survives the send.
+  * @param[IN]  res Result
+  * @param[IN]  length Bytes about to be appended
+  * @retval NONE
+  */
+static void resultRoom(shellResult_t* res, uint16_t length) {
+	if (res->str.len > 0 && (uint16_t)(res->str.size - res->str.len) < length) {
+		bool truncated = res->str.truncated;
+
+		shellStrSend(res->ctx, &res->str);
+		res->str.truncated = truncated;
+	}
+}
+
+/**
+  * @brief  Starts a field: makes room for it and writes the key
+  * @note	Text: indent, then "key:" or "-" in a list. CBOR: the outer map once, then the key
+  * 		unless in a list. The value is clamped so the whole field fits an empty buffer.
+  * @param[IN]  res Result
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  valueLen Characters or bytes of the value, without the CBOR head
+  * @retval uint16_t Value length that fits
+  */
+static uint16_t resultField(shellResult_t* res, const char* key, uint16_t valueLen) {
+	bool inList = resultInList(res);
+	uint16_t keyLen = (key != NULL && !inList) ? (uint16_t)strlen(key) : 0;
+	uint16_t overhead = res->cbor ? (uint16_t)(1 + CBOR_HEAD_MAX + CBOR_HEAD_MAX) : (uint16_t)(res->depth * 2 + 2 + 2);
+
+	// Keys are names, one that does not fit is cut like a value
+	if (overhead + keyLen > res->str.size) {
+		keyLen = res->str.size - overhead;
+		res->str.truncated = true;
+	}
+	overhead += keyLen;
+	if (valueLen > res->str.size - overhead) {
+		valueLen = res->str.size - overhead;
+		res->str.truncated = true;
+	}
+	resultRoom(res, overhead + valueLen);
+
+	if (res->cbor) {
+		if (!res->opened) {
+			shellStrAppendChar(&res->str, (char)CBOR_MAP_START);
+			res->opened = true;
+		}
+		if (!inList) {
+			cborHead(&res->str, CBOR_TEXT, keyLen);
+			shellStrAppendN(&res->str, (key != NULL) ? key : "", keyLen);
+		}
+		return valueLen;
+	}
+
+	for (uint8_t level = 0; level < res->depth; level++) {
+		shellStrAppendN(&res->str, "  ", 2);
+	}
+	if (inList) {
+		shellStrAppendChar(&res->str, '-');
+	} else {
+		shellStrAppendN(&res->str, (key != NULL) ? key : "", keyLen);
+		shellStrAppendChar(&res->str, ':');
+	}
+	return valueLen;
+}
+
+/**
+  * @brief  Ends a text line
+  * @param[IN]  res Result
+  * @retval NONE
+  */
+static void resultLineEnd(shellResult_t* res) {
+	shellStrAppendN(&res->str, "\r\n", 2);
+}
+
+/**
+  * @brief  Opens a group or a list
+  * @note	Past SHELL_RESULT_DEPTH the container is left out, its fields go to the enclosing one.
+  * @param[IN]  res Result
+  * @param[IN]  key Name of the container, NULL in a list
+  * @param[IN]  list Open a list instead of a group
+  * @retval NONE
+  */
+static void resultOpen(shellResult_t* res, const char* key, bool list) {
+	if (res->depth >= SHELL_RESULT_DEPTH) {
+		res->excess++;
+		res->str.truncated = true;
+		return;
+	}
+
+	resultField(res, key, 1);
+	if (res->cbor) {
+		shellStrAppendChar(&res->str, (char)(list ? CBOR_ARRAY_START : CBOR_MAP_START));
+	} else {
+		resultLineEnd(res);
+	}
+
+	if (list) {
+		res->lists |= (uint8_t)(1U << res->depth);
+	} else {
+		res->lists &= (uint8_t)~(1U << res->depth);
+	}
+	res->depth++;
+}
+
+/**
+  * @brief  Appends a CBOR head, the argument in the shortest form
+  * @param[IN]  str Builder
+  * @param[IN]  major Major type
+  * @param[IN]  argument Value, length or count
+  * @retval NONE
+  */
+static void cborHead(shellStr_t* str, uint8_t major, uint32_t argument) {
+	char head[CBOR_HEAD_MAX];
+	uint8_t len;
+
+	major = (uint8_t)(major << 5);
+	if (argument < 24) {
+		head[0] = (char)(major | argument);
+		len = 1;
+	} else if (argument <= 0xFF) {
+		head[0] = (char)(major | 24);
+		head[1] = (char)argument;
+		len = 2;
+	} else if (argument <= 0xFFFF) {
+		head[0] = (char)(major | 25);
+		head[1] = (char)(argument >> 8);
+		head[2] = (char)argument;
+		len = 3;
+	} else {
+		head[0] = (char)(major | 26);
+		head[1] = (char)(argument >> 24);
+		head[2] = (char)(argument >> 16);
+		head[3] = (char)(argument >> 8);
+		head[4] = (char)argument;
+		len = 5;
+	}
+	shellStrAppendN(str, head, len);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Adds an unsigned field
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+void shellResultUnsigned(shellResult_t* res, const char* key, uint32_t value) {
+	char digits[SHELL_FMT_DEC_LEN];
+	uint8_t len = res->cbor ? 0 : shellFmtUnsigned(digits, value);
+
+	resultField(res, key, len + 1);
+	if (res->cbor) {
+		cborHead(&res->str, CBOR_UINT, value);
+		return;
+	}
+	shellStrAppendChar(&res->str, ' ');
+	shellStrAppendN(&res->str, digits, len);
+	resultLineEnd(res);
+}
+
+/**
+  * @brief  Adds a signed field
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+void shellResultSigned(shellResult_t* res, const char* key, int32_t value) {
+	char digits[SHELL_FMT_DEC_LEN + 1];
+	uint8_t len = res->cbor ? 0 : shellFmtSigned(digits, value);
+
+	resultField(res, key, len + 1);
+	if (res->cbor) {
+		// A negative integer carries -1 - value, the one's complement
+		cborHead(&res->str, (value < 0) ? CBOR_NEGINT : CBOR_UINT, (value < 0) ? ~(uint32_t)value : (uint32_t)value);
+		return;
+	}
+	shellStrAppendChar(&res->str, ' ');
+	shellStrAppendN(&res->str, digits, len);
+	resultLineEnd(res);
+}
+
+/**
+  * @brief  Adds an unsigned field shown in hex, "0x" and digits in text mode
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  value Value
+  * @param[IN]  digits Text mode digits (1 to 8), with leading zeros
+  * @retval NONE
+  */
+void shellResultHex(shellResult_t* res, const char* key, uint32_t value, uint8_t digits) {
+	if (digits == 0 || digits > 8) {
+		digits = 8;
+	}
+
+	resultField(res, key, digits + 3);
+	if (res->cbor) {
+		cborHead(&res->str, CBOR_UINT, value);
+		return;
+	}
+	shellStrAppendN(&res->str, " 0x", 3);
+	shellStrAppendHex(&res->str, value, digits);
+	resultLineEnd(res);
+}
+
+/**
+  * @brief  Adds a bool field, "true"/"false" in text mode
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+void shellResultBool(shellResult_t* res, const char* key, bool value) {
+	resultField(res, key, 6);
+	if (res->cbor) {
+		shellStrAppendChar(&res->str, (char)(value ? CBOR_TRUE : CBOR_FALSE));
+		return;
+	}
+	shellStrAppend(&res->str, value ? " true" : " false");
+	resultLineEnd(res);
+}
+
+/**
+  * @brief  Adds a text field
+  * @note	Text longer than the storage allows is cut.
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  text NUL-terminated text
+  * @retval NONE
+  */
+void shellResultText(shellResult_t* res, const char* key, const char* text) {
+	size_t textLen = strlen(text);
+	uint16_t fit = resultField(res, key, (textLen > UINT16_MAX - 1) ? UINT16_MAX : (uint16_t)(textLen + 1));
+	uint16_t len = (fit > 0) ? fit - 1 : 0;
+
+	if (res->cbor) {
+		cborHead(&res->str, CBOR_TEXT, len);
+	} else {
+		shellStrAppendChar(&res->str, ' ');
+	}
+	shellStrAppendN(&res->str, text, len);
+	if (!res->cbor) {
+		resultLineEnd(res);
+	}
+}
+
+/**
+  * @brief  Adds a byte field, hex digits in text mode
+  * @note	Bytes beyond what the storage allows are cut.
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the field, NULL in a list
+  * @param[IN]  data Bytes
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellResultBytes(shellResult_t* res, const char* key, const uint8_t* data, uint16_t len) {
+	if (res->cbor) {
+		len = resultField(res, key, len);
+		cborHead(&res->str, CBOR_BYTES, len);
+		shellStrAppendN(&res->str, (const char*)data, len);
+		return;
+	}
+
+	uint32_t textLen = (uint32_t)len * 2 + 1;
+	uint16_t fit = resultField(res, key, (textLen > UINT16_MAX) ? UINT16_MAX : (uint16_t)textLen);
+	len = (fit > 0) ? (fit - 1) / 2 : 0;
+	shellStrAppendChar(&res->str, ' ');
+	res->str.len += shellFmtHexBytes(&res->str.buf[res->str.len], data, len);
+	resultLineEnd(res);
+}
+
+/**
+  * @brief  Opens a group of fields, a nested map in binary mode
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the group, NULL in a list
+  * @retval NONE
+  */
+void shellResultGroup(shellResult_t* res, const char* key) {
+	resultOpen(res, key, false);
+}
+
+/**
+  * @brief  Opens a list, an array in binary mode. Its fields and groups have no key.
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @param[IN]  key Name of the list, NULL in a list
+  * @retval NONE
+  */
+void shellResultList(shellResult_t* res, const char* key) {
+	resultOpen(res, key, true);
+}
+
+/**
+  * @brief  Closes the innermost group or list
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @retval NONE
+  */
+void shellResultClose(shellResult_t* res) {
+	if (res->excess > 0) {
+		res->excess--;
+		return;
+	}
+	if (res->depth == 0) {
+		return;
+	}
+
+	res->depth--;
+	if (res->cbor) {
+		resultRoom(res, 1);
+		shellStrAppendChar(&res->str, (char)CBOR_BREAK);
+	}
+}
+
+/**
+  * @brief  Closes everything still open and sends the rest of the result
+  * @param[IN]  res Result (SHELL_RESULT_DEFINE)
+  * @retval NONE
+  */
+void shellResultEnd(shellResult_t* res) {
+	res->excess = 0;
+	while (res->depth > 0) {
+		shellResultClose(res);
+	}
+
+	if (res->cbor) {
+		resultRoom(res, 2);
+		if (!res->opened) {
+			shellStrAppendChar(&res->str, (char)CBOR_MAP_START);
+			res->opened = true;
+		}
+		shellStrAppendChar(&res->str, (char)CBOR_BREAK);
+	}
+
+	if (res->str.len > 0) {
+		shellStrSend(res->ctx, &res->str);
+	}
+}
+
+/*** end of file ***/
@@ -0,0 +1,92 @@
+/** @file CLI_SHELL_RESULT.h
+ *
+ * @brief Structured results of the CLI Shell: typed fields sent as text or as CBOR
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - A bridge names its values instead of formatting them:
+ *      SHELL_RESULT_DEFINE(res, ctx, 64);
+ *      shellResultHex(&res, "crc", crc, 8);
+ *      shellResultUnsigned(&res, "bytes", length);
+ *      shellResultEnd(&res);
+ *    The session mode of the instance picks the encoding:
+ *    - text mode: one "key: value" line per field, "crc: 0x1A2B3C4D". Groups and lists indent
+ *      their fields by two spaces under a "key:" line, list items start with "- ".
+ *    - binary mode (CLI_SHELL_BINARY.h): the response data is one CBOR (RFC 8949) map of the
+ *      fields, keys are text strings. Unsigned and hex values are unsigned integers, signed values
+ *      integers, text a text string, bytes a byte string, bools true/false. Groups are nested
+ *      maps, lists arrays. The map and its containers have indefinite length (0xBF/0x9F ... 0xFF),
+ *      so the result streams out without knowing the field count.
+ *  - The storage is the send buffer, full buffers go out through outputStreamChannel() like
+ *    shellStrSend(), shellResultEnd() closes the map and sends the rest. A result may be as large
+ *    as the transport takes, the buffer only bounds one field: a text or byte string longer than
+ *    the buffer is cut (truncated set), the CBOR stays well formed.
+ *  - Groups and lists nest SHELL_RESULT_DEPTH deep, close each with shellResultClose(). Fields
+ *    inside a list have no key, pass NULL.
+ *  - shellResultEnd() closes what is still open. A result without fields is an empty map in
+ *    binary mode and nothing in text mode.
+ *  - Free-form text through outputStreamChannel() still works in both modes, a bridge uses one
+ *    or the other per command.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_RESULT_H_
+#define CLI_SHELL_RESULT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_RESULT_DEPTH			4			/*!< Nested groups and lists				*/
+#define SHELL_RESULT_MIN_SIZE		24			/*!< Smallest storage, a key and a number	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Result being built, define with SHELL_RESULT_DEFINE()
+  */
+typedef struct {
+	shell_ctx_t* ctx;
+	shellStr_t str;							/*!< Encoded fields not sent yet			*/
+	bool cbor;								/*!< Binary session, CBOR encoding			*/
+	bool opened;							/*!< CBOR: the outer map has been started	*/
+	uint8_t depth;							/*!< Open groups and lists					*/
+	uint8_t lists;							/*!< Bit per depth, the container is a list	*/
+	uint8_t excess;							/*!< Containers left out past the depth		*/
+} shellResult_t;
+
+#define SHELL_RESULT_DEFINE(name, ctx, size) \
+		char name##Storage[((size) < SHELL_RESULT_MIN_SIZE) ? SHELL_RESULT_MIN_SIZE : (size)]; \
+		shellResult_t name = { (ctx), { name##Storage, sizeof(name##Storage), 0, false }, \
+				(ctx)->mode == SHELL_MODE_BINARY, false, 0, 0, 0 }
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellResultUnsigned(shellResult_t* res, const char* key, uint32_t value);
+void shellResultSigned(shellResult_t* res, const char* key, int32_t value);
+void shellResultHex(shellResult_t* res, const char* key, uint32_t value, uint8_t digits);
+void shellResultBool(shellResult_t* res, const char* key, bool value);
+void shellResultText(shellResult_t* res, const char* key, const char* text);
+void shellResultBytes(shellResult_t* res, const char* key, const uint8_t* data, uint16_t len);
+void shellResultGroup(shellResult_t* res, const char* key);
+void shellResultList(shellResult_t* res, const char* key);
+void shellResultClose(shellResult_t* res);
+void shellResultEnd(shellResult_t* res);
+
+#endif // CLI_SHELL_RESULT_H_
+
+/*** end of file ***/
@@ -0,0 +1,232 @@
+/** @file CLI_SHELL_RING.c
+ *
+ * @brief Lock-free single-producer/single-consumer byte ring for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) shellRingGet runs from RAM (SHELL_RAMFUNC)
+ * - 1.2: 10-15-2026 (Crandell) shellRingReserveContiguous()/shellRingCommit()
+ * - 1.3: 10-15-2026 (Crandell) shellRingPeek()
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL_RING.h"
+#include "CLI_SHELL_PERF.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  Orders the data accesses ahead of the index update that publishes them.
+  * @note	A compiler barrier is enough on the single-core Cortex-M4 (no data cache).
+  */
+#define RING_BARRIER()						__asm volatile ("" ::: "memory")
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Initializes a ring over the given storage
+  * @param[OUT] ring Ring handle
+  * @param[IN]  storage Backing storage
+  * @param[IN]  size Storage size in bytes. Must be a power of two.
+  * @retval bool Returns false if the size is not a power of two
+  */
+bool shellRingInit(shellRing_t* ring, uint8_t* storage, uint32_t size) {
+	if (size == 0 || (size & (size - 1)) != 0) {
+		return false;
+	}
+
+	ring->buffer = storage;
+	ring->mask = size - 1;
+	ring->head = 0;
+	ring->tail = 0;
+	ring->dropped = 0;
+	return true;
+}
+
+/**
+  * @brief  Number of bytes waiting to be read
+  * @param[IN]  ring Ring handle
+  * @retval uint32_t Bytes used
+  */
+uint32_t shellRingUsed(const shellRing_t* ring) {
+	return ring->head - ring->tail;
+}
+
+/**
+  * @brief  Number of bytes that can still be written
+  * @param[IN]  ring Ring handle
+  * @retval uint32_t Bytes free
+  */
+uint32_t shellRingFree(const shellRing_t* ring) {
+	return (ring->mask + 1) - (ring->head - ring->tail);
+}
+
+/**
+  * @brief  Copies data into the ring (producer side)
+  * @note	Bytes that do not fit are counted in ring->dropped.
+  * @param[IN]  ring Ring handle
+  * @param[IN]  data Data to store
+  * @param[IN]  len Number of bytes to store
+  * @retval uint32_t Number of bytes actually stored
+  */
+uint32_t shellRingWrite(shellRing_t* ring, const uint8_t* data, uint32_t len) {
+	uint32_t head = ring->head;
+	uint32_t space = (ring->mask + 1) - (head - ring->tail);
+	uint32_t count = (len > space) ? space : len;
+
+	// Copy in at most two chunks - up to the end of the storage, then from the start
+	uint32_t index = head & ring->mask;
+	uint32_t first = (ring->mask + 1) - index;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(&ring->buffer[index], data, first);
+	memcpy(&ring->buffer[0], &data[first], count - first);
+
+	// Publish the data
+	RING_BARRIER();
+	ring->head = head + count;
+
+	if (count < len) {
+		ring->dropped += len - count;
+	}
+	return count;
+}
+
+/**
+  * @brief  Returns the largest block of free space that is contiguous in storage (producer side)
+  * @note	Lets a producer format straight into the ring. Call shellRingCommit() with what it wrote.
+  * @param[IN]  ring Ring handle
+  * @param[OUT] data Pointer to the start of the block
+  * @retval uint32_t Length of the block
+  */
+uint32_t shellRingReserveContiguous(const shellRing_t* ring, uint8_t** data) {
+	uint32_t head = ring->head;
+	uint32_t space = (ring->mask + 1) - (head - ring->tail);
+	uint32_t index = head & ring->mask;
+	uint32_t toEnd = (ring->mask + 1) - index;
+
+	*data = &ring->buffer[index];
+	return (space > toEnd) ? toEnd : space;
+}
+
+/**
+  * @brief  Publishes bytes written into a reserved block (producer side)
+  * @param[IN]  ring Ring handle
+  * @param[IN]  len Number of bytes written. Must not exceed shellRingReserveContiguous().
+  * @retval NONE
+  */
+void shellRingCommit(shellRing_t* ring, uint32_t len) {
+	RING_BARRIER();
+	ring->head += len;
+}
+
+/**
+  * @brief  Reads a single byte (consumer side)
+  * @param[IN]  ring Ring handle
+  * @param[OUT] byte Received byte
+  * @retval bool Returns false if the ring is empty
+  */
+SHELL_RAMFUNC bool shellRingGet(shellRing_t* ring, uint8_t* byte) {
+	uint32_t tail = ring->tail;
+
+	if (tail == ring->head) {
+		return false;
+	}
+
+	*byte = ring->buffer[tail & ring->mask];
+
+	RING_BARRIER();
+	ring->tail = tail + 1;
+	return true;
+}
+
+/**
+  * @brief  Reads up to len bytes (consumer side)
+  * @param[IN]  ring Ring handle
+  * @param[OUT] data Destination
+  * @param[IN]  len Maximum number of bytes to read
+  * @retval uint32_t Number of bytes read
+  */
+uint32_t shellRingRead(shellRing_t* ring, uint8_t* data, uint32_t len) {
+	uint32_t tail = ring->tail;
+	uint32_t used = ring->head - tail;
+	uint32_t count = (len > used) ? used : len;
+
+	uint32_t index = tail & ring->mask;
+	uint32_t first = (ring->mask + 1) - index;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(data, &ring->buffer[index], first);
+	memcpy(&data[first], &ring->buffer[0], count - first);
+
+	RING_BARRIER();
+	ring->tail = tail + count;
+	return count;
+}
+
+/**
+  * @brief  Copies unread bytes without taking them (consumer side)
+  * @note	The pipeline (CLI_SHELL_PIPE.c) peeks from the producer's interrupt while the consumer
+  * 		is parked in a bridge, the tail does not move meanwhile.
+  * @param[IN]  ring Ring handle
+  * @param[OUT] data Destination
+  * @param[IN]  len Maximum number of bytes to copy
+  * @retval uint32_t Number of bytes copied
+  */
+uint32_t shellRingPeek(const shellRing_t* ring, uint8_t* data, uint32_t len) {
+	uint32_t tail = ring->tail;
+	uint32_t used = ring->head - tail;
+	uint32_t count = (len > used) ? used : len;
+
+	uint32_t index = tail & ring->mask;
+	uint32_t first = (ring->mask + 1) - index;
+	if (first > count) {
+		first = count;
+	}
+	memcpy(data, &ring->buffer[index], first);
+	memcpy(&data[first], &ring->buffer[0], count - first);
+	return count;
+}
+
+/**
+  * @brief  Returns the largest block of unread data that is contiguous in storage
+  * @note	Lets a DMA/USB transfer run straight out of the ring. Call shellRingSkip() once done.
+  * @param[IN]  ring Ring handle
+  * @param[OUT] data Pointer to the start of the block
+  * @retval uint32_t Length of the block
+  */
+uint32_t shellRingPeekContiguous(const shellRing_t* ring, uint8_t** data) {
+	uint32_t tail = ring->tail;
+	uint32_t used = ring->head - tail;
+	uint32_t index = tail & ring->mask;
+	uint32_t toEnd = (ring->mask + 1) - index;
+
+	*data = &ring->buffer[index];
+	return (used > toEnd) ? toEnd : used;
+}
+
+/**
+  * @brief  Discards bytes from the read side (consumer side)
+  * @param[IN]  ring Ring handle
+  * @param[IN]  len Number of bytes to discard. Must not exceed shellRingUsed().
+  * @retval NONE
+  */
+void shellRingSkip(shellRing_t* ring, uint32_t len) {
+	RING_BARRIER();
+	ring->tail += len;
+}
+
+/*** end of file ***/
@@ -0,0 +1,73 @@
+/** @file CLI_SHELL_RING.h
+ *
+ * @brief Lock-free single-producer/single-consumer byte ring for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Producer side reserve/commit (shellRingReserveContiguous)
+ * - 1.2: 10-15-2026 (Crandell) shellRingPeek()
+ *
+ * Usage Notes:
+ *  - Exactly one context may write (e.g. the OTG_FS interrupt) and exactly one context may
+ *    read (e.g. the main loop). No locks or interrupt masking are needed in that case.
+ *  - The storage size must be a power of two. head and tail run freely and are masked on access.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_RING_H_
+#define CLI_SHELL_RING_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  Static initializer for a ring over a fixed array. sizeof(storage) must be a power of two.
+  */
+#define SHELL_RING_STATIC_INIT(storage)		{ .buffer = (storage), .mask = sizeof(storage) - 1, .head = 0, .tail = 0, .dropped = 0 }
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Byte ring handle
+  */
+typedef struct {
+	uint8_t* buffer;						/*!< Ring Storage							*/
+	uint32_t mask;							/*!< Storage Size - 1						*/
+	volatile uint32_t head;					/*!< Write Index (producer only)			*/
+	volatile uint32_t tail;					/*!< Read Index (consumer only)				*/
+	volatile uint32_t dropped;				/*!< Bytes rejected because the ring was full	*/
+} shellRing_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellRingInit(shellRing_t* ring, uint8_t* storage, uint32_t size);
+
+uint32_t shellRingUsed(const shellRing_t* ring);
+uint32_t shellRingFree(const shellRing_t* ring);
+
+// Producer Side
+uint32_t shellRingWrite(shellRing_t* ring, const uint8_t* data, uint32_t len);
+uint32_t shellRingReserveContiguous(const shellRing_t* ring, uint8_t** data);
+void shellRingCommit(shellRing_t* ring, uint32_t len);
+
+// Consumer Side
+bool shellRingGet(shellRing_t* ring, uint8_t* byte);
+uint32_t shellRingRead(shellRing_t* ring, uint8_t* data, uint32_t len);
+uint32_t shellRingPeek(const shellRing_t* ring, uint8_t* data, uint32_t len);
+uint32_t shellRingPeekContiguous(const shellRing_t* ring, uint8_t** data);
+void shellRingSkip(shellRing_t* ring, uint32_t len);
+
+#endif // CLI_SHELL_RING_H_
+
+/*** end of file ***/
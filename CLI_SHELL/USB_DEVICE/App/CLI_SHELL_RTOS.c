@@ -0,0 +1,257 @@
+/** @file CLI_SHELL_RTOS.c
+ *
+ * @brief FreeRTOS port of the CLI Shell: shell task, output lock and worker tasks
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_RTOS.h"
+#include "CLI_SHELL_EVENT.h"
+
+#if SHELL_RTOS_ENABLED
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Work item waiting for a worker task
+  */
+typedef struct {
+	shellRtosWork_t work;
+	void* arg;
+} shellRtosItem_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shell_ctx_t* instances[SHELL_RTOS_MAX_INSTANCES];
+static uint8_t instanceCount;
+
+static StaticTask_t shellTaskTcb;
+static StackType_t shellTaskStack[SHELL_RTOS_STACK_WORDS];
+static TaskHandle_t shellTask = NULL;				/*!< Set once started, the doorbell checks it	*/
+
+static StaticSemaphore_t outputLockStorage;
+static SemaphoreHandle_t outputLock = NULL;
+
+#if SHELL_RTOS_WORKERS > 0
+static StaticTask_t workerTcb[SHELL_RTOS_WORKERS];
+static StackType_t workerStack[SHELL_RTOS_WORKERS][SHELL_RTOS_WORKER_STACK_WORDS];
+
+static StaticQueue_t workQueueStorage;
+static uint8_t workQueueItems[SHELL_RTOS_WORK_QUEUE * sizeof(shellRtosItem_t)];
+static QueueHandle_t workQueue = NULL;
+#endif
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void shellTaskMain(void* param);
+#if SHELL_RTOS_WORKERS > 0
+static void workerTaskMain(void* param);
+#endif
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  The shell task: the main loop of CLI_SHELL_EVENT.h, one pass per event
+  * @param[IN]  param Unused
+  * @retval NONE
+  */
+static void shellTaskMain(void* param) {
+	(void)param;
+
+	for (;;) {
+		xSemaphoreTakeRecursive(outputLock, portMAX_DELAY);
+		for (uint8_t i = 0; i < instanceCount; i++) {
+			checkShellStatus(instances[i]);
+		}
+		xSemaphoreGiveRecursive(outputLock);
+
+		shellEventWait();
+	}
+}
+
+#if SHELL_RTOS_WORKERS > 0
+/**
+  * @brief  A worker task: runs the deferred work items in order
+  * @param[IN]  param Unused
+  * @retval NONE
+  */
+static void workerTaskMain(void* param) {
+	shellRtosItem_t item;
+	(void)param;
+
+	for (;;) {
+		if (xQueueReceive(workQueue, &item, portMAX_DELAY) == pdTRUE) {
+			item.work(item.arg);
+			shellEventSignal(SHELL_EVENT_WORKER);
+		}
+	}
+}
+#endif
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Creates the shell task, the output lock and the worker tasks
+  * @note	Call once from main() after shellInit() of every instance, before vTaskStartScheduler().
+  * @param[IN]  shellInstances Instances the shell task runs, in poll order
+  * @param[IN]  count Number of instances (SHELL_RTOS_MAX_INSTANCES max)
+  * @retval bool Returns false if too many instances
+  */
+bool shellRtosStart(shell_ctx_t* const* shellInstances, uint8_t count) {
+	if (count > SHELL_RTOS_MAX_INSTANCES) {
+		return false;
+	}
+	memcpy(instances, shellInstances, count * sizeof(instances[0]));
+	instanceCount = count;
+
+	outputLock = xSemaphoreCreateRecursiveMutexStatic(&outputLockStorage);
+
+#if SHELL_RTOS_WORKERS > 0
+	workQueue = xQueueCreateStatic(SHELL_RTOS_WORK_QUEUE, sizeof(shellRtosItem_t), workQueueItems, &workQueueStorage);
+	for (uint8_t i = 0; i < SHELL_RTOS_WORKERS; i++) {
+		xTaskCreateStatic(workerTaskMain, "shellWrk", SHELL_RTOS_WORKER_STACK_WORDS, NULL,
+				SHELL_RTOS_WORKER_PRIORITY, workerStack[i], &workerTcb[i]);
+	}
+#endif
+
+	shellTask = xTaskCreateStatic(shellTaskMain, "shell", SHELL_RTOS_STACK_WORDS, NULL,
+			SHELL_RTOS_PRIORITY, shellTaskStack, &shellTaskTcb);
+
+	// The doorbell may call FreeRTOS, the lowest priority is below configMAX_SYSCALL_INTERRUPT_PRIORITY
+	HAL_NVIC_SetPriority(SHELL_RTOS_DOORBELL_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL, 0);
+	HAL_NVIC_EnableIRQ(SHELL_RTOS_DOORBELL_IRQn);
+	return true;
+}
+
+/**
+  * @brief  Wakes the shell task
+  * @note	Called by shellEventSignal(), from any interrupt priority or task. Only pends the
+  * 		doorbell, its handler notifies the task.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellRtosNotify(void) {
+	NVIC_SetPendingIRQ(SHELL_RTOS_DOORBELL_IRQn);
+}
+
+/**
+  * @brief  Blocks the shell task until it is notified, or SHELL_RTOS_WAIT_MS at most
+  * @note	A notification given since the last wait ends it right away, no event is lost.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellRtosWait(void) {
+	ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SHELL_RTOS_WAIT_MS));
+}
+
+/**
+  * @brief  Lets tasks of the same priority run, the shell task has work left
+  * @param  NONE
+  * @retval NONE
+  */
+void shellRtosYield(void) {
+	taskYIELD();
+}
+
+/**
+  * @brief  Takes the output lock, held by the shell task during each pass
+  * @note	Recursive, may be taken again by the same task. Not from interrupts.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellRtosLock(void) {
+	xSemaphoreTakeRecursive(outputLock, portMAX_DELAY);
+}
+
+/**
+  * @brief  Gives the output lock back
+  * @param  NONE
+  * @retval NONE
+  */
+void shellRtosUnlock(void) {
+	xSemaphoreGiveRecursive(outputLock);
+}
+
+/**
+  * @brief  Writes text to a shell port from another task
+  * @note	Waits for the output lock, then for room in the transmit queue (shellOutputReserve()).
+  * 		The shell task sends it on its next pass. Binary sessions take no unframed output.
+  * @param[IN]  ctx Shell instance of the port
+  * @param[IN]  data Text
+  * @param[IN]  len Number of bytes
+  * @retval uint16_t Bytes queued, 0 if there was no room or the session is binary
+  */
+uint16_t shellRtosWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len) {
+	uint16_t written = 0;
+
+	shellRtosLock();
+	if (ctx->mode == SHELL_MODE_TEXT && shellOutputReserve(ctx, len)) {
+		written = shellOutputWrite(ctx, data, len);
+	}
+	shellRtosUnlock();
+
+	shellEventSignal(SHELL_EVENT_PENDING);
+	return written;
+}
+
+/**
+  * @brief  Hands a function to the worker tasks
+  * @note	Task context only. SHELL_EVENT_WORKER is signalled once it has run.
+  * @param[IN]  work Function to run
+  * @param[IN]  arg Its argument
+  * @retval bool Returns false if SHELL_RTOS_WORK_QUEUE items wait already, or there are no workers
+  */
+bool shellRtosDefer(shellRtosWork_t work, void* arg) {
+#if SHELL_RTOS_WORKERS > 0
+	shellRtosItem_t item = { .work = work, .arg = arg };
+
+	return xQueueSend(workQueue, &item, 0) == pdTRUE;
+#else
+	(void)work;
+	(void)arg;
+	return false;
+#endif
+}
+
+/********************************************************************************
+ * INTERRUPT HANDLERS
+ *******************************************************************************/
+/**
+  * @brief  Doorbell of the shell task, pended by shellRtosNotify()
+  * @param  NONE
+  * @retval NONE
+  */
+void SHELL_RTOS_DOORBELL_HANDLER(void) {
+	BaseType_t woken = pdFALSE;
+
+	if (shellTask != NULL) {
+		vTaskNotifyGiveFromISR(shellTask, &woken);
+	}
+	portYIELD_FROM_ISR(woken);
+}
+
+#endif // SHELL_RTOS_ENABLED
+
+/*** end of file ***/
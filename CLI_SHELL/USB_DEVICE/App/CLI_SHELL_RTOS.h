@@ -0,0 +1,109 @@
+/** @file CLI_SHELL_RTOS.h
+ *
+ * @brief FreeRTOS port of the CLI Shell: shell task, output lock and worker tasks
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Only built with SHELL_RTOS_ENABLED=1, the project then needs FreeRTOS with
+ *    configSUPPORT_STATIC_ALLOCATION and configUSE_RECURSIVE_MUTEXES. Without it the main loop
+ *    runs the shell as before (CLI_SHELL_EVENT.h).
+ *  - main() initializes the instances as usual, then hands them to the shell task and starts
+ *    the scheduler instead of entering the main loop:
+ *      static shell_ctx_t* const instances[] = { &operatorShell, &automationShell };
+ *      shellRtosStart(instances, 2);
+ *      vTaskStartScheduler();
+ *  - The shell task runs the main loop pass of every instance, then blocks in shellEventWait()
+ *    until an event comes in. Reception stays as it is: the USB and USART interrupts put the
+ *    bytes into the lock-free receive ring of the instance, shellEventSignal() wakes the task.
+ *  - The interrupts of the shell run above configMAX_SYSCALL_INTERRUPT_PRIORITY (OTG_FS at 0)
+ *    and must not call FreeRTOS. shellEventSignal() pends the doorbell interrupt instead
+ *    (SHELL_RTOS_DOORBELL_IRQn, SPI5 is unused on this board), which runs at the lowest priority
+ *    and notifies the task. The interrupt priorities of the shell do not change.
+ *  - Give the shell task a low priority. It runs SHELL_MAX_CMDS_PER_POLL lines and one job step
+ *    per pass and only yields while work is left (a running job), so application tasks above it
+ *    preempt it and tasks below it wait until the shell is idle.
+ *  - Other tasks write to a shell port with shellRtosWrite(), text sessions only. The shell task
+ *    holds the output lock for a whole pass, so their text lands between responses, never inside
+ *    one. The next pass sends it. shellRtosLock()/shellRtosUnlock() serialize longer sequences.
+ *  - shellRtosDefer() runs a function on one of SHELL_RTOS_WORKERS worker tasks. A bridge that
+ *    would block for long starts a job that defers the work and waits for it, the shell task
+ *    keeps serving the other lines and instances meanwhile:
+ *
+ *      static volatile uint32_t eraseDone;
+ *      static void eraseWork(void* arg) { eraseExternalFlash(); eraseDone = 1; }
+ *
+ *      static shell_error eraseJob(shellJob_t* job) {
+ *          SHELL_JOB_BEGIN(job);
+ *          eraseDone = 0;
+ *          if (!shellRtosDefer(eraseWork, NULL)) {
+ *              return SHELL_ERR;
+ *          }
+ *          SHELL_JOB_WAIT_UNTIL(job, eraseDone != 0 || job->cancel);
+ *          SHELL_JOB_END(job);
+ *      }
+ *
+ *    A finished work item signals SHELL_EVENT_WORKER, the job is polled right away. Work items
+ *    do not touch the job (it may be cancelled and reused) and write output through
+ *    shellRtosWrite() only.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_RTOS_H_
+#define CLI_SHELL_RTOS_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_RTOS_ENABLED
+#define SHELL_RTOS_ENABLED				0
+#endif
+
+#define SHELL_RTOS_MAX_INSTANCES		4			/*!< Instances run by the shell task		*/
+#define SHELL_RTOS_STACK_WORDS			768			/*!< Shell task stack, bridges run on it	*/
+#define SHELL_RTOS_PRIORITY				1			/*!< Shell task, just above idle			*/
+#define SHELL_RTOS_WAIT_MS				10			/*!< Longest block without an event			*/
+
+#define SHELL_RTOS_WORKERS				1			/*!< Worker tasks, 0 for none				*/
+#define SHELL_RTOS_WORKER_STACK_WORDS	512
+#define SHELL_RTOS_WORKER_PRIORITY		1
+#define SHELL_RTOS_WORK_QUEUE			4			/*!< Work items waiting for a worker		*/
+
+#ifndef SHELL_RTOS_DOORBELL_IRQn
+#define SHELL_RTOS_DOORBELL_IRQn		SPI5_IRQn
+#define SHELL_RTOS_DOORBELL_HANDLER		SPI5_IRQHandler
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+// Function run by a worker task
+typedef void(*shellRtosWork_t)(void* arg);
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellRtosStart(shell_ctx_t* const* instances, uint8_t count);
+void shellRtosNotify(void);
+void shellRtosWait(void);
+void shellRtosYield(void);
+void shellRtosLock(void);
+void shellRtosUnlock(void);
+uint16_t shellRtosWrite(shell_ctx_t* ctx, const uint8_t* data, uint16_t len);
+bool shellRtosDefer(shellRtosWork_t work, void* arg);
+
+#endif // CLI_SHELL_RTOS_H_
+
+/*** end of file ***/
@@ -0,0 +1,586 @@
+/** @file CLI_SHELL_SCHED.c
+ *
+ * @brief Periodic commands of the CLI Shell: TIM11 timing wheel and the "every" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Due entries signal the main loop
+ * - 1.2: 10-14-2026 (Crandell) Handler profiled with the entry latency (CLI_SHELL_ISR)
+ * - 1.3: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_SCHED.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_ISR.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SCHED_NONE				0xFF		/*!< End of a wheel slot list				*/
+#define SCHED_TIMER				TIM11
+#define SCHED_TIMER_IRQn		TIM1_TRG_COM_TIM11_IRQn
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  One scheduled command
+  * @note	The wheel members and the due stamps belong to the timer interrupt once the entry
+  * 		is linked, the statistics to the main loop.
+  */
+typedef struct {
+	bool used;
+	shell_ctx_t* ctx;						/*!< Instance that scheduled it, gets the output	*/
+	uint8_t line[SHELL_SCHED_LINE_LEN + 1];	/*!< Tokenized command line					*/
+	uint8_t lineLen;
+	shellParserOutput_t parserOutput;		/*!< Resolved and validated once			*/
+	uint16_t commandIndex;
+	uint32_t periodTicks;
+
+	uint8_t slot;							/*!< Wheel slot the entry is linked in		*/
+	uint8_t next;							/*!< Next entry of the slot (SCHED_NONE)	*/
+	uint32_t rounds;						/*!< Wheel turns left before it is due		*/
+	volatile bool due;						/*!< Set by the interrupt, cleared by the run	*/
+	volatile uint32_t dueTick;				/*!< Tick count when it became due			*/
+	volatile uint32_t dueCycles;			/*!< Cycle counter when it became due		*/
+	volatile uint32_t missed;				/*!< Still due when the next period came	*/
+
+	uint32_t runs;
+	uint32_t lastTick;						/*!< dueTick of the previous run			*/
+	uint32_t lastLateUs;					/*!< Lateness of the previous run			*/
+	uint32_t lateMaxUs;
+	uint64_t lateSumUs;
+	uint32_t intervalMinUs;
+	uint32_t intervalMaxUs;
+} schedEntry_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static struct {
+	schedEntry_t entries[SHELL_SCHED_ENTRIES];
+	uint8_t wheel[SHELL_SCHED_WHEEL_SLOTS];	/*!< First entry of every slot				*/
+	volatile uint32_t ticks;				/*!< Timer ticks since the first start		*/
+	uint8_t active;							/*!< Linked entries							*/
+	bool running;
+	bool initialized;
+	TIM_HandleTypeDef timer;
+} sched;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void schedInit(void);
+static uint32_t schedPrescaler(void);
+static void schedStart(void);
+static void schedLink(uint8_t id, uint32_t delay);
+static void schedUnlink(uint8_t id);
+static void schedRemove(uint8_t id);
+static bool schedParsePeriod(const uint8_t* text, uint32_t len, uint32_t* periodUs, uint32_t* used);
+static void schedRun(uint8_t id);
+static void schedAppendPeriod(shellStr_t* str, uint32_t periodUs);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Prepares the wheel and TIM11 (not started)
+  * @param  NONE
+  * @retval NONE
+  */
+static void schedInit(void) {
+	memset(sched.wheel, SCHED_NONE, sizeof(sched.wheel));
+
+	__HAL_RCC_TIM11_CLK_ENABLE();
+	sched.timer.Instance = SCHED_TIMER;
+	sched.timer.Init.Prescaler = schedPrescaler();
+	sched.timer.Init.CounterMode = TIM_COUNTERMODE_UP;
+	sched.timer.Init.Period = SHELL_SCHED_TICK_US - 1;
+	sched.timer.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+	sched.timer.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	HAL_TIM_Base_Init(&sched.timer);
+
+	HAL_NVIC_SetPriority(SCHED_TIMER_IRQn, SHELL_SCHED_IRQ_PRIORITY, 0);
+	sched.initialized = true;
+}
+
+/**
+  * @brief  Prescaler for a 1 MHz timer count
+  * @note	The APB2 timers run at twice PCLK2 whenever the APB2 prescaler divides.
+  * @param  NONE
+  * @retval uint32_t Prescaler register value
+  */
+static uint32_t schedPrescaler(void) {
+	uint32_t timerClock = HAL_RCC_GetPCLK2Freq();
+
+	if ((RCC->CFGR & RCC_CFGR_PPRE2) != RCC_CFGR_PPRE2_DIV1) {
+		timerClock *= 2;
+	}
+	return (timerClock / 1000000U) - 1;
+}
+
+/**
+  * @brief  Starts the timer for the first linked entry
+  * @param  NONE
+  * @retval NONE
+  */
+static void schedStart(void) {
+	if (!sched.initialized) {
+		schedInit();
+	}
+	if (!sched.running) {
+		__HAL_TIM_SET_COUNTER(&sched.timer, 0);
+		__HAL_TIM_CLEAR_FLAG(&sched.timer, TIM_FLAG_UPDATE);
+		HAL_NVIC_EnableIRQ(SCHED_TIMER_IRQn);
+		HAL_TIM_Base_Start_IT(&sched.timer);
+		sched.running = true;
+	}
+}
+
+/**
+  * @brief  Links an entry into the slot delay ticks ahead of the current one
+  * @note	Called from the interrupt, or from the main loop with the interrupt disabled. A delay
+  * 		of a whole number of turns lands in the current slot, which is only looked at again
+  * 		after a full turn.
+  * @param[IN]  id Entry
+  * @param[IN]  delay Ticks until it is due (at least 1)
+  * @retval NONE
+  */
+static void schedLink(uint8_t id, uint32_t delay) {
+	schedEntry_t* entry = &sched.entries[id];
+	uint32_t step = ((delay - 1) % SHELL_SCHED_WHEEL_SLOTS) + 1;
+
+	entry->rounds = (delay - step) / SHELL_SCHED_WHEEL_SLOTS;
+	entry->slot = (sched.ticks + step) % SHELL_SCHED_WHEEL_SLOTS;
+	entry->next = sched.wheel[entry->slot];
+	sched.wheel[entry->slot] = id;
+}
+
+/**
+  * @brief  Takes an entry out of its slot list
+  * @param[IN]  id Entry
+  * @retval NONE
+  */
+static void schedUnlink(uint8_t id) {
+	uint8_t* link = &sched.wheel[sched.entries[id].slot];
+
+	while (*link != SCHED_NONE) {
+		if (*link == id) {
+			*link = sched.entries[id].next;
+			return;
+		}
+		link = &sched.entries[*link].next;
+	}
+}
+
+/**
+  * @brief  Deletes an entry, the timer stops with the last one
+  * @param[IN]  id Entry
+  * @retval NONE
+  */
+static void schedRemove(uint8_t id) {
+	HAL_NVIC_DisableIRQ(SCHED_TIMER_IRQn);
+	schedUnlink(id);
+	sched.entries[id].used = false;
+	sched.active--;
+
+	if (sched.active == 0) {
+		HAL_TIM_Base_Stop_IT(&sched.timer);
+		sched.running = false;
+		return;
+	}
+	HAL_NVIC_EnableIRQ(SCHED_TIMER_IRQn);
+}
+
+/**
+  * @brief  Reads the period of a schedule, "<number>[us|ms|s]" followed by a space
+  * @param[IN]  text Text after the keyword
+  * @param[IN]  len Length of the text
+  * @param[OUT]  periodUs Period in microseconds
+  * @param[OUT]  used Characters taken, including the space
+  * @retval bool Returns false if there is no valid period
+  */
+static bool schedParsePeriod(const uint8_t* text, uint32_t len, uint32_t* periodUs, uint32_t* used) {
+	uint64_t value = 0;
+	uint32_t scale = 1000;
+	uint32_t i = 0;
+
+	while (i < len && text[i] >= '0' && text[i] <= '9') {
+		value = (value * 10) + (text[i++] - '0');
+		if (value > SHELL_SCHED_MAX_PERIOD_US) {
+			return false;
+		}
+	}
+	if (i == 0) {
+		return false;
+	}
+
+	if (i + 1 < len && text[i] == 'u' && text[i + 1] == 's') {
+		scale = 1;
+		i += 2;
+	} else if (i + 1 < len && text[i] == 'm' && text[i + 1] == 's') {
+		i += 2;
+	} else if (i < len && text[i] == 's') {
+		scale = 1000000;
+		i++;
+	}
+	if (i >= len || text[i] != ' ') {
+		return false;
+	}
+
+	value *= scale;
+	if (value < SHELL_SCHED_TICK_US || value > SHELL_SCHED_MAX_PERIOD_US || (value % SHELL_SCHED_TICK_US) != 0) {
+		return false;
+	}
+	*periodUs = (uint32_t)value;
+	*used = i + 1;
+	return true;
+}
+
+/**
+  * @brief  Runs a due entry and updates its statistics
+  * @note	The bridge gets copies of the line and the parser output, so an entry deleted by its
+  * 		own command is not pulled from under it. The response is held back like within a
+  * 		batch, only a failure is reported (and stops the entry).
+  * @param[IN]  id Entry
+  * @retval NONE
+  */
+static void schedRun(uint8_t id) {
+	schedEntry_t* entry = &sched.entries[id];
+	shell_ctx_t* ctx = entry->ctx;
+	uint8_t lineBuffer[SHELL_SCHED_LINE_LEN + 1];
+	shellParserOutput_t parserOutput;
+	uint32_t savedStamps[perfStage_count + 1];
+	SHELL_STR_DEFINE(str, 40);
+
+	HAL_NVIC_DisableIRQ(SCHED_TIMER_IRQn);
+	uint32_t dueTick = entry->dueTick;
+	uint32_t dueCycles = entry->dueCycles;
+	entry->due = false;
+	HAL_NVIC_EnableIRQ(SCHED_TIMER_IRQn);
+
+	// Lateness behind the tick, and the interval since the previous run
+	uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+	uint32_t lateUs = (shellPerfCycles() - dueCycles) / cyclesPerUs;
+
+	entry->lateSumUs += lateUs;
+	if (lateUs > entry->lateMaxUs) {
+		entry->lateMaxUs = lateUs;
+	}
+	if (entry->runs > 0) {
+		uint32_t intervalUs = ((dueTick - entry->lastTick) * SHELL_SCHED_TICK_US) + lateUs - entry->lastLateUs;
+		if (intervalUs < entry->intervalMinUs) {
+			entry->intervalMinUs = intervalUs;
+		}
+		if (intervalUs > entry->intervalMaxUs) {
+			entry->intervalMaxUs = intervalUs;
+		}
+	}
+	entry->lastTick = dueTick;
+	entry->lastLateUs = lateUs;
+	entry->runs++;
+
+	memcpy(lineBuffer, entry->line, sizeof(lineBuffer));
+	memcpy(&parserOutput, &entry->parserOutput, sizeof(parserOutput));
+	parserOutput.line = lineBuffer;
+	parserOutput.periodic = true;
+	for (uint8_t i = 0; i < parserOutput.numArgs; i++) {
+		if (parserOutput.cmdArgs[i].argType == arg_string) {
+			parserOutput.cmdArgs[i].argValue.str = (const char*)shellArgContents(&parserOutput, i);
+		}
+	}
+
+	// Run it like one command of a batch, whatever the instance is doing
+	bool savedBatch = ctx->batchActive;
+	responseCode_t savedStatus = ctx->batchStatus;
+	memcpy(savedStamps, ctx->perfStamps, sizeof(savedStamps));
+
+	ctx->batchActive = true;
+	ctx->batchStatus = RESPONSE_OK;
+	shellDispatch(ctx, &parserOutput, entry->commandIndex);
+	responseCode_t result = ctx->batchStatus;
+
+	ctx->batchActive = savedBatch;
+	ctx->batchStatus = savedStatus;
+	memcpy(ctx->perfStamps, savedStamps, sizeof(savedStamps));
+
+	if (result != RESPONSE_OK) {
+		if (entry->used) {
+			schedRemove(id);
+		}
+		shellStrAppend(&str, "Every ");
+		shellStrAppendUnsigned(&str, id, 0);
+		shellStrAppend(&str, " stopped: ");
+		shellStrSend(ctx, &str);
+		shellSendResponse(ctx, result);
+	}
+}
+
+/**
+  * @brief  Appends a period with the largest unit that divides it
+  * @param[IN]  str Builder (SHELL_STR_DEFINE)
+  * @param[IN]  periodUs Period in microseconds
+  * @retval NONE
+  */
+static void schedAppendPeriod(shellStr_t* str, uint32_t periodUs) {
+	if ((periodUs % 1000000U) == 0) {
+		shellStrAppendUnsigned(str, periodUs / 1000000U, 0);
+		shellStrAppend(str, "s");
+	} else if ((periodUs % 1000U) == 0) {
+		shellStrAppendUnsigned(str, periodUs / 1000U, 0);
+		shellStrAppend(str, "ms");
+	} else {
+		shellStrAppendUnsigned(str, periodUs, 0);
+		shellStrAppend(str, "us");
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Schedules the command of an "every <period> <command line>" line
+  * @note	Called by shellProcessLine(). The command is resolved and validated here, so an
+  * 		unknown command or bad argument is answered right away like any other line.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  line Text after the keyword
+  * @param[IN]  len Length of the text
+  * @retval shell_error Error Return Value
+  */
+shell_error shellSchedLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len) {
+	uint32_t periodUs;
+	uint32_t used;
+	SHELL_STR_DEFINE(str, 30);
+
+	if (!schedParsePeriod(line, len, &periodUs, &used)) {
+		shellSendResponse(ctx, RESPONSE_ARG_ERR);
+		return SHELL_ERR;
+	}
+	line += used;
+	len -= used;
+	if (len > SHELL_SCHED_LINE_LEN) {
+		shellSendResponse(ctx, RESPONSE_LEN_ERR);
+		return SHELL_ERR;
+	}
+
+	uint8_t id = 0;
+	while (id < SHELL_SCHED_ENTRIES && sched.entries[id].used) {
+		id++;
+	}
+	if (id >= SHELL_SCHED_ENTRIES) {
+		shellSendResponse(ctx, RESPONSE_FNC_ERR);
+		return SHELL_ERR;
+	}
+
+	schedEntry_t* entry = &sched.entries[id];
+	memcpy(entry->line, line, len);
+	entry->lineLen = len;
+	if (shellResolveCommand(ctx, entry->line, len, &entry->parserOutput, &entry->commandIndex) != SHELL_OK) {
+		return SHELL_ERR;
+	}
+
+	entry->ctx = ctx;
+	entry->periodTicks = periodUs / SHELL_SCHED_TICK_US;
+	entry->due = false;
+	entry->missed = 0;
+	entry->runs = 0;
+	entry->lateMaxUs = 0;
+	entry->lateSumUs = 0;
+	entry->intervalMinUs = UINT32_MAX;
+	entry->intervalMaxUs = 0;
+	entry->used = true;
+
+	schedStart();
+	HAL_NVIC_DisableIRQ(SCHED_TIMER_IRQn);
+	schedLink(id, entry->periodTicks);
+	sched.active++;
+	HAL_NVIC_EnableIRQ(SCHED_TIMER_IRQn);
+
+	shellStrAppend(&str, "Scheduled as ");
+	shellStrAppendUnsigned(&str, id, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	shellSendResponse(ctx, RESPONSE_OK);
+	return SHELL_OK;
+}
+
+/**
+  * @brief  Runs the due entries of an instance
+  * @note	Called by checkShellStatus(), so the commands run in the main loop with everything a
+  * 		command may use. The timer only decides when.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellSchedPoll(shell_ctx_t* ctx) {
+	for (uint8_t id = 0; id < SHELL_SCHED_ENTRIES; id++) {
+		if (sched.entries[id].used && sched.entries[id].ctx == ctx && sched.entries[id].due) {
+			schedRun(id);
+		}
+	}
+}
+
+/**
+  * @brief  Deletes every entry of an instance (Ctrl-C or break)
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellSchedStop(shell_ctx_t* ctx) {
+	for (uint8_t id = 0; id < SHELL_SCHED_ENTRIES; id++) {
+		if (sched.entries[id].used && sched.entries[id].ctx == ctx) {
+			schedRemove(id);
+		}
+	}
+}
+
+/**
+  * @brief  Keeps the tick at SHELL_SCHED_TICK_US after a clock profile change
+  * @note	Called by shellClockApply(). The new prescaler is loaded at the next update.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellSchedClockChanged(void) {
+	if (!sched.initialized) {
+		return;
+	}
+	sched.timer.Init.Prescaler = schedPrescaler();
+	__HAL_TIM_SET_PRESCALER(&sched.timer, sched.timer.Init.Prescaler);
+}
+
+/**
+  * @brief  TIM11 update interrupt, one wheel slot per tick
+  * @note	Due entries are only stamped and marked, then linked again one period ahead. An entry
+  * 		still marked from the previous period counts as missed.
+  * @param  NONE
+  * @retval NONE
+  */
+void TIM1_TRG_COM_TIM11_IRQHandler(void) {
+	uint32_t now = shellPerfCycles();
+	// Timer clock cycles since the update, the timer clock is HCLK (APB2 undivided)
+	uint32_t latency = __HAL_TIM_GET_COUNTER(&sched.timer) * (sched.timer.Init.Prescaler + 1);
+
+	if (__HAL_TIM_GET_FLAG(&sched.timer, TIM_FLAG_UPDATE) == RESET) {
+		return;
+	}
+	__HAL_TIM_CLEAR_FLAG(&sched.timer, TIM_FLAG_UPDATE);
+
+	uint8_t fired = SCHED_NONE;
+
+	sched.ticks++;
+	uint8_t* link = &sched.wheel[sched.ticks % SHELL_SCHED_WHEEL_SLOTS];
+
+	while (*link != SCHED_NONE) {
+		uint8_t id = *link;
+		schedEntry_t* entry = &sched.entries[id];
+
+		if (entry->rounds > 0) {
+			entry->rounds--;
+			link = &entry->next;
+			continue;
+		}
+
+		// Due - move it to the fired list, relinked once the slot has been walked
+		*link = entry->next;
+		entry->next = fired;
+		fired = id;
+
+		if (entry->due) {
+			entry->missed++;
+		} else {
+			entry->dueTick = sched.ticks;
+			entry->dueCycles = now;
+			entry->due = true;
+			shellEventSignal(SHELL_EVENT_TIMER);
+		}
+	}
+
+	while (fired != SCHED_NONE) {
+		uint8_t id = fired;
+		fired = sched.entries[id].next;
+		schedLink(id, sched.entries[id].periodTicks);
+	}
+	SHELL_ISR_RECORD(isrId_tim11, now, latency);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Lists the scheduled commands with their statistics, "d<id>" deletes one
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error EveryBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 224);
+
+	if (shellHasArg(parserInput, argTkn_d)) {
+		uint8_t id = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+
+		if (id >= SHELL_SCHED_ENTRIES || !sched.entries[id].used) {
+			return SHELL_ERR;
+		}
+		schedRemove(id);
+		return SHELL_OK;
+	}
+
+	shellStrAppend(&str, "Every: ");
+	shellStrAppendUnsigned(&str, sched.active, 0);
+	shellStrAppend(&str, " of ");
+	shellStrAppendUnsigned(&str, SHELL_SCHED_ENTRIES, 0);
+	shellStrAppend(&str, ", tick ");
+	shellStrAppendUnsigned(&str, SHELL_SCHED_TICK_US, 0);
+	shellStrAppend(&str, " us\r\n");
+	shellStrSend(ctx, &str);
+
+	for (uint8_t id = 0; id < SHELL_SCHED_ENTRIES; id++) {
+		const schedEntry_t* entry = &sched.entries[id];
+		if (!entry->used) {
+			continue;
+		}
+
+		uint32_t lateMean = (entry->runs == 0) ? 0 : (uint32_t)(entry->lateSumUs / entry->runs);
+		uint32_t intervalMin = (entry->runs < 2) ? 0 : entry->intervalMinUs;
+
+		shellStrAppendUnsigned(&str, id, 0);
+		shellStrAppend(&str, ": ");
+		schedAppendPeriod(&str, entry->periodTicks * SHELL_SCHED_TICK_US);
+		shellStrAppendChar(&str, ' ');
+		// The tokenizer left NULs between the words
+		for (uint8_t i = 0; i < entry->lineLen; i++) {
+			shellStrAppendChar(&str, (entry->line[i] == '\0') ? ' ' : (char)entry->line[i]);
+		}
+		shellStrAppend(&str, "\r\n   runs ");
+		shellStrAppendUnsigned(&str, entry->runs, 0);
+		shellStrAppend(&str, ", missed ");
+		shellStrAppendUnsigned(&str, entry->missed, 0);
+		shellStrAppend(&str, ", late ");
+		shellStrAppendUnsigned(&str, lateMean, 0);
+		shellStrAppendChar(&str, '/');
+		shellStrAppendUnsigned(&str, entry->lateMaxUs, 0);
+		shellStrAppend(&str, " us, interval ");
+		shellStrAppendUnsigned(&str, intervalMin, 0);
+		shellStrAppend(&str, "..");
+		shellStrAppendUnsigned(&str, entry->intervalMaxUs, 0);
+		shellStrAppend(&str, " us\r\n");
+		if (!shellOutputReserve(ctx, str.len)) {
+			return SHELL_ERR;
+		}
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
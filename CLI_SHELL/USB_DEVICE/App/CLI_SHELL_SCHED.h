@@ -0,0 +1,65 @@
+/** @file CLI_SHELL_SCHED.h
+ *
+ * @brief Periodic commands of the CLI Shell ("every"), paced by a hardware timer
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "every <period> <command line>" runs the command line every period, e.g. "every 10ms mrd
+ *    a0x40020010". The period is a number with us, ms (default) or s, a multiple of
+ *    SHELL_SCHED_TICK_US. The command is parsed, looked up and validated once, when it is
+ *    scheduled. Each run goes straight to the bridge with the stored arguments.
+ *  - The output of every run goes to the instance that scheduled it, without a response. A run
+ *    that fails stops its entry: "Every <id> stopped: " and the response.
+ *  - "every" lists the entries with their statistics, "every d<id>" stops one. Ctrl-C or a
+ *    break stops all entries of the instance.
+ *  - TIM11 interrupts every SHELL_SCHED_TICK_US while entries exist. The entries sit on a timing
+ *    wheel of SHELL_SCHED_WHEEL_SLOTS slots, a tick only looks at the entries of its own slot.
+ *    A due entry is marked in the interrupt with its cycle stamp and run by checkShellStatus().
+ *  - Statistics: runs, missed runs (still due when the next period came), lateness of a run
+ *    behind its tick (mean/max) and the spread of the actual intervals (min/max).
+ *  - The timer clock follows PCLK2, shellClockApply() (CLI_SHELL_CLOCK.h) recomputes the prescaler.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_SCHED_H_
+#define CLI_SHELL_SCHED_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_SCHED_KEYWORD				"every "	/*!< Line prefix of a schedule				*/
+#define SHELL_SCHED_ENTRIES				8
+#define SHELL_SCHED_LINE_LEN			64			/*!< Longest scheduled command line		*/
+#define SHELL_SCHED_TICK_US				100			/*!< Timer tick, shortest period		*/
+#define SHELL_SCHED_WHEEL_SLOTS			64
+#define SHELL_SCHED_MAX_PERIOD_US		3600000000U	/*!< One hour							*/
+#define SHELL_SCHED_IRQ_PRIORITY		2			/*!< Below OTG_FS						*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+typedef enum shellErrorTypeDef shell_error;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+shell_error shellSchedLine(shell_ctx_t* ctx, uint8_t* line, uint32_t len);
+void shellSchedPoll(shell_ctx_t* ctx);
+void shellSchedStop(shell_ctx_t* ctx);
+void shellSchedClockChanged(void);
+
+#endif // CLI_SHELL_SCHED_H_
+
+/*** end of file ***/
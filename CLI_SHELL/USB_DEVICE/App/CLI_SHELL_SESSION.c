@@ -0,0 +1,255 @@
+/** @file CLI_SHELL_SESSION.c
+ *
+ * @brief Session restore of the CLI Shell: the session settings kept in the RTC backup registers
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_SESSION.h"
+#include "CLI_SHELL_CRC.h"
+#include "CLI_SHELL_CLOCK.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SESSION_WORDS					(SHELL_SESSION_SLOTS + 2)		/*!< Magic, clock, slots, then the CRC	*/
+#define SESSION_WORD_CLOCK				1
+#define SESSION_WORD_SLOT(slot)			(2 + (slot))
+
+// Slot word: the settings of one instance
+#define SESSION_SLOT_MODE_MASK			0x03U
+#define SESSION_SLOT_COMPRESS			0x04U
+#define SESSION_SLOT_ECHO				0x08U
+#define SESSION_SLOT_VALID				0x80U
+#define SESSION_SLOT_PORT_POS			8
+
+// Clock word: profile and governor
+#define SESSION_CLOCK_PROFILE_MASK		0xFFU
+#define SESSION_CLOCK_GOVERNOR			0x100U
+#define SESSION_CLOCK_VALID				0x8000U
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  The descriptor as read at startup and as last written
+  */
+static struct {
+	uint32_t words[SESSION_WORDS];
+	bool loaded;							/*!< First shellSessionRestore() done		*/
+	shell_ctx_t* slots[SHELL_SESSION_SLOTS];	/*!< Instances in the order of shellInit()	*/
+	bool restored[SHELL_SESSION_SLOTS];		/*!< The slot came back from the registers	*/
+	uint8_t used;
+} session;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static volatile uint32_t* sessionRegister(uint32_t index);
+static void sessionLoad(void);
+static void sessionWrite(void);
+static int8_t sessionSlot(const shell_ctx_t* ctx);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  A backup register of the descriptor
+  * @param[IN]  index Word of the descriptor, SESSION_WORDS is the CRC
+  * @retval volatile uint32_t* RTC_BKPxR
+  */
+static volatile uint32_t* sessionRegister(uint32_t index) {
+	return &RTC->BKP0R + SHELL_SESSION_BKP_FIRST + index;
+}
+
+/**
+  * @brief  Reads the descriptor once, unless the reset came from the power supply
+  * @note	Clears the reset flags, so a later soft reset is not taken for a power-on.
+  * @param  NONE
+  * @retval NONE
+  */
+static void sessionLoad(void) {
+	bool powerOn = (RCC->CSR & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)) != 0;
+
+	RCC->CSR |= RCC_CSR_RMVF;
+	session.loaded = true;
+
+	for (uint32_t i = 0; i < SESSION_WORDS; i++) {
+		session.words[i] = *sessionRegister(i);
+	}
+	if (powerOn || session.words[0] != SHELL_SESSION_MAGIC ||
+			shellCrc32(SHELL_CRC32_INIT, session.words, sizeof(session.words)) != *sessionRegister(SESSION_WORDS)) {
+		memset(session.words, 0, sizeof(session.words));
+	}
+}
+
+/**
+  * @brief  Writes the descriptor and its CRC to the backup registers
+  * @param  NONE
+  * @retval NONE
+  */
+static void sessionWrite(void) {
+	uint32_t crc;
+
+	session.words[0] = SHELL_SESSION_MAGIC;
+	crc = shellCrc32(SHELL_CRC32_INIT, session.words, sizeof(session.words));
+
+	__HAL_RCC_PWR_CLK_ENABLE();
+	HAL_PWR_EnableBkUpAccess();
+	for (uint32_t i = 0; i < SESSION_WORDS; i++) {
+		*sessionRegister(i) = session.words[i];
+	}
+	*sessionRegister(SESSION_WORDS) = crc;
+	HAL_PWR_DisableBkUpAccess();
+}
+
+/**
+  * @brief  The slot of an instance
+  * @param[IN]  ctx Shell instance
+  * @retval int8_t Slot, -1 for an instance without one
+  */
+static int8_t sessionSlot(const shell_ctx_t* ctx) {
+	for (uint8_t i = 0; i < session.used; i++) {
+		if (session.slots[i] == ctx) {
+			return (int8_t)i;
+		}
+	}
+	return -1;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Gives the instance its slot and restores the settings saved there, called by shellInit()
+  * @note	The first call also restores the clock profile and the governor. An instance that
+  * 		is initialized again keeps its slot.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellSessionRestore(shell_ctx_t* ctx) {
+	int8_t slot = sessionSlot(ctx);
+
+	if (!session.loaded) {
+		sessionLoad();
+
+		uint32_t clock = session.words[SESSION_WORD_CLOCK];
+		if ((clock & SESSION_CLOCK_VALID) != 0) {
+			shellClockRestore((shellClockProfile_t)(clock & SESSION_CLOCK_PROFILE_MASK),
+					(clock & SESSION_CLOCK_GOVERNOR) != 0);
+		}
+	}
+
+	if (slot < 0) {
+		if (session.used >= SHELL_SESSION_SLOTS) {
+			return;
+		}
+		slot = (int8_t)session.used++;
+		session.slots[slot] = ctx;
+	}
+
+	uint32_t word = session.words[SESSION_WORD_SLOT(slot)];
+	if ((word & SESSION_SLOT_VALID) == 0 || (uint8_t)(word >> SESSION_SLOT_PORT_POS) != ctx->port ||
+			(word & SESSION_SLOT_MODE_MASK) > SHELL_MODE_BINARY) {
+		return;
+	}
+
+	ctx->mode = (shellMode_t)(word & SESSION_SLOT_MODE_MASK);
+	ctx->pendingMode = ctx->mode;
+	ctx->binary.compress = (word & SESSION_SLOT_COMPRESS) != 0;
+	ctx->edit.echo = (word & SESSION_SLOT_ECHO) != 0;
+	session.restored[slot] = true;
+}
+
+/**
+  * @brief  Saves the session settings of the instance and the clock, after a command changed them
+  * @note	Takes the mode the instance switches to after the response (pendingMode).
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellSessionSave(shell_ctx_t* ctx) {
+	int8_t slot = sessionSlot(ctx);
+
+	if (slot >= 0) {
+		uint32_t word = SESSION_SLOT_VALID | ((uint32_t)ctx->port << SESSION_SLOT_PORT_POS) |
+				((uint32_t)ctx->pendingMode & SESSION_SLOT_MODE_MASK);
+
+		if (ctx->binary.compress) {
+			word |= SESSION_SLOT_COMPRESS;
+		}
+		if (ctx->edit.echo) {
+			word |= SESSION_SLOT_ECHO;
+		}
+		session.words[SESSION_WORD_SLOT(slot)] = word;
+	}
+
+	session.words[SESSION_WORD_CLOCK] = SESSION_CLOCK_VALID | (uint32_t)shellClockCurrent() |
+			(shellClockGoverned() ? SESSION_CLOCK_GOVERNOR : 0U);
+	sessionWrite();
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the saved session settings of the instance, or clears them all (c)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (c - Clear (1), optional)
+  * @retval shell_error Error Return Value
+  */
+shell_error SessionBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 96);
+	int8_t slot = sessionSlot(ctx);
+
+	if (shellHasArg(parserInput, argTkn_c) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 != 0) {
+		memset(session.words, 0, sizeof(session.words));
+		sessionWrite();
+		return SHELL_OK;
+	}
+
+	if (slot < 0) {
+		shellStrAppend(&str, "Session: no slot, starts with the defaults\r\n");
+		shellStrSend(ctx, &str);
+		return SHELL_OK;
+	}
+
+	uint32_t word = session.words[SESSION_WORD_SLOT(slot)];
+	uint32_t clock = session.words[SESSION_WORD_CLOCK];
+
+	shellStrAppend(&str, "Session: slot ");
+	shellStrAppendUnsigned(&str, (uint32_t)slot, 0);
+	shellStrAppend(&str, session.restored[slot] ? ", restored at startup\r\n" : ", started with the defaults\r\n");
+	shellStrSend(ctx, &str);
+
+	if ((word & SESSION_SLOT_VALID) == 0) {
+		shellStrAppend(&str, "Saved: nothing\r\n");
+	} else {
+		shellStrAppend(&str, "Saved: mode ");
+		shellStrAppendUnsigned(&str, word & SESSION_SLOT_MODE_MASK, 0);
+		shellStrAppend(&str, (word & SESSION_SLOT_COMPRESS) ? ", compress on" : ", compress off");
+		shellStrAppend(&str, (word & SESSION_SLOT_ECHO) ? ", echo on" : ", echo off");
+		if ((clock & SESSION_CLOCK_GOVERNOR) != 0) {
+			shellStrAppend(&str, ", clock governor");
+		} else {
+			shellStrAppend(&str, ", clock p");
+			shellStrAppendUnsigned(&str, clock & SESSION_CLOCK_PROFILE_MASK, 0);
+		}
+		shellStrAppend(&str, "\r\n");
+	}
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
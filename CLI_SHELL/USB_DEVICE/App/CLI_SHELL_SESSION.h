@@ -0,0 +1,66 @@
+/** @file CLI_SHELL_SESSION.h
+ *
+ * @brief Session restore of the CLI Shell: the session settings kept in the RTC backup registers
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - Every instance keeps its session settings in one backup register: the mode ("mode m<n>"),
+ *    compression of binary responses (z) and the local echo ("term e<n>"). One more register
+ *    keeps the clock profile and the governor ("clock"). They are written when a command
+ *    changes them and read back by shellInit(), so the instance comes back in the same mode
+ *    after a soft reset, a watchdog reset, a fault (CLI_SHELL_CRASH.h) or a firmware update
+ *    ("fwupdate a1"). A host that had switched to binary frames goes on sending them after it
+ *    reopens the port, without "mode m1" and the setup round trips.
+ *  - The instances take the slots in the order of their shellInit() calls (main.c). A slot only
+ *    restores the instance with the port it was saved by. SHELL_SESSION_SLOTS instances at most,
+ *    the others start with the defaults.
+ *  - A power-on or brown-out reset starts every instance with the defaults, whatever the
+ *    backup domain holds (with VBAT it outlives a power cycle). The reset flags of RCC_CSR are
+ *    cleared by the first shellInit() to tell the next reset apart.
+ *  - The registers are checked with a CRC32 (CLI_SHELL_CRC.h) and SHELL_SESSION_MAGIC, which
+ *    carries the layout version. A mismatch starts with the defaults.
+ *  - The sequence numbers of binary frames and the response cache start over. Jobs, streams,
+ *    "every" commands and armed commands do not survive a reset: the host starts them again.
+ *  - "session" shows the settings saved for the instance and whether it was restored,
+ *    "session c1" clears the saved settings of every instance: the next reset starts in text
+ *    mode with the default clock.
+ *  - SHELL_SESSION_BKP_FIRST is the first of the registers used, SHELL_SESSION_SLOTS + 3 of them.
+ *    The writes enable backup domain access (PWR_CR DBP) for their duration only.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_SESSION_H_
+#define CLI_SHELL_SESSION_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_SESSION_SLOTS				3			/*!< Operator, automation, USART		*/
+#define SHELL_SESSION_BKP_FIRST			0			/*!< RTC_BKP0R							*/
+#define SHELL_SESSION_MAGIC				0x53534E01U	/*!< "SSN", layout version 1			*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellSessionRestore(shell_ctx_t* ctx);
+void shellSessionSave(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_SESSION_H_
+
+/*** end of file ***/
@@ -0,0 +1,403 @@
+/** @file CLI_SHELL_SPI.c
+ *
+ * @brief SPI transaction engine of the CLI Shell: batched transfers on SPI3 by DMA, "spi"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_SPI.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SPI_RX_STREAM			DMA1_Stream0		/*!< SPI3_RX, channel 0					*/
+#define SPI_TX_STREAM			DMA1_Stream5		/*!< SPI3_TX, channel 0					*/
+#define SPI_RX_IRQn				DMA1_Stream0_IRQn
+#define SPI_RX_DONE				DMA_LISR_TCIF0
+#define SPI_RX_ERRORS			(DMA_LISR_TEIF0 | DMA_LISR_DMEIF0)
+#define SPI_RX_FLAGS			(DMA_LIFCR_CTCIF0 | DMA_LIFCR_CHTIF0 | DMA_LIFCR_CTEIF0 | \
+								 DMA_LIFCR_CDMEIF0 | DMA_LIFCR_CFEIF0)
+#define SPI_TX_FLAGS			(DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | \
+								 DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+
+#define SPI_CS_PORT				GPIOA
+#define SPI_CS_PIN				GPIO_PIN_15
+#define SPI_BUS_PINS			(GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12)	/*!< GPIOC, SCK MISO MOSI	*/
+
+#define SPI_FILL				0xFF				/*!< Sent by reads						*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef enum {
+	spiState_idle = 0,
+	spiState_transfer,						/*!< DMA running, the interrupt goes on		*/
+	spiState_wait,							/*!< A delay, the job goes on				*/
+	spiState_done,
+	spiState_failed							/*!< DMA error								*/
+} spiState_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  The list being run
+  */
+static struct {
+	uint8_t list[SHELL_ARRAY_MAX];
+	uint8_t len;
+	uint8_t pc;								/*!< Next operation							*/
+	uint8_t rx[SHELL_SPI_RX_MAX];
+	uint16_t rxLen;
+	volatile spiState_t state;
+	uint32_t waitCycles;
+	uint32_t waitStart;
+	uint32_t startCycles;
+} spi;
+
+static const uint8_t spiFill = SPI_FILL;
+static uint8_t spiSink;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool spiCheckList(const uint8_t* list, uint8_t len);
+static uint32_t spiBaudDivider(uint32_t kHz);
+static void spiSetup(uint32_t kHz, uint8_t mode);
+static void spiSelect(bool select);
+static void spiTransfer(const uint8_t* tx, bool txInc, uint8_t* rx, bool rxInc, uint8_t n);
+static void spiStep(void);
+static void spiStop(void);
+static shell_error spiJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Checks the operations and the bytes they read
+  * @param[IN]  list Operations
+  * @param[IN]  len Bytes of the list
+  * @retval bool Returns false for an unknown or cut operation, an empty transfer or too many reads
+  */
+static bool spiCheckList(const uint8_t* list, uint8_t len) {
+	uint16_t reads = 0;
+	uint16_t pc = 0;
+
+	while (pc < len) {
+		switch (list[pc]) {
+		case SHELL_SPI_OP_SELECT:
+		case SHELL_SPI_OP_DESELECT:
+			pc += 1;
+			break;
+		case SHELL_SPI_OP_WRITE:
+		case SHELL_SPI_OP_EXCHANGE:
+			if (pc + 1 >= len || list[pc + 1] == 0 || pc + 2 + list[pc + 1] > len) {
+				return false;
+			}
+			if (list[pc] == SHELL_SPI_OP_EXCHANGE) {
+				reads += list[pc + 1];
+			}
+			pc += 2 + list[pc + 1];
+			break;
+		case SHELL_SPI_OP_READ:
+			if (pc + 1 >= len || list[pc + 1] == 0) {
+				return false;
+			}
+			reads += list[pc + 1];
+			pc += 2;
+			break;
+		case SHELL_SPI_OP_DELAY:
+			if (pc + 2 >= len) {
+				return false;
+			}
+			pc += 3;
+			break;
+		default:
+			return false;
+		}
+	}
+	return reads <= SHELL_SPI_RX_MAX;
+}
+
+/**
+  * @brief  Baud rate control of the fastest clock up to kHz
+  * @param[IN]  kHz Clock asked for
+  * @retval uint32_t BR bits of CR1, PCLK1/256 if even that is too fast
+  */
+static uint32_t spiBaudDivider(uint32_t kHz) {
+	uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+	uint32_t br = 0;
+
+	while (br < 7 && (pclk >> (br + 1)) > kHz * 1000U) {
+		br++;
+	}
+	return br << SPI_CR1_BR_Pos;
+}
+
+/**
+  * @brief  Clocks and pins, SPI3 as master with software CS and both DMA requests
+  * @param[IN]  kHz Clock
+  * @param[IN]  mode SPI mode 0 to 3
+  * @retval NONE
+  */
+static void spiSetup(uint32_t kHz, uint8_t mode) {
+	GPIO_InitTypeDef gpioInit = {0};
+
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+	__HAL_RCC_SPI3_CLK_ENABLE();
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	HAL_GPIO_WritePin(SPI_CS_PORT, SPI_CS_PIN, GPIO_PIN_SET);
+	gpioInit.Pin = SPI_CS_PIN;
+	gpioInit.Mode = GPIO_MODE_OUTPUT_PP;
+	gpioInit.Pull = GPIO_NOPULL;
+	gpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	HAL_GPIO_Init(SPI_CS_PORT, &gpioInit);
+
+	gpioInit.Pin = SPI_BUS_PINS;
+	gpioInit.Mode = GPIO_MODE_AF_PP;
+	gpioInit.Alternate = GPIO_AF6_SPI3;
+	HAL_GPIO_Init(GPIOC, &gpioInit);
+
+	SPI3->CR1 = 0;
+	SPI3->CR2 = SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN;
+	SPI3->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | spiBaudDivider(kHz) |
+			((mode & 0x02) ? SPI_CR1_CPOL : 0) | ((mode & 0x01) ? SPI_CR1_CPHA : 0) | SPI_CR1_SPE;
+
+	HAL_NVIC_SetPriority(SPI_RX_IRQn, SHELL_SPI_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(SPI_RX_IRQn);
+}
+
+/**
+  * @brief  Drives CS
+  * @note	Deselecting waits for the last clock first.
+  * @param[IN]  select true for CS low
+  * @retval NONE
+  */
+static void spiSelect(bool select) {
+	if (!select) {
+		while ((SPI3->SR & SPI_SR_BSY) != 0) {
+		}
+	}
+	HAL_GPIO_WritePin(SPI_CS_PORT, SPI_CS_PIN, select ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+/**
+  * @brief  Starts both streams on n bytes, the receive stream interrupts when it is done
+  * @param[IN]  tx Bytes to send
+  * @param[IN]  txInc tx is an array (false: one byte sent n times)
+  * @param[OUT]  rx Received bytes
+  * @param[IN]  rxInc rx is an array (false: one byte written n times)
+  * @param[IN]  n Bytes
+  * @retval NONE
+  */
+static void spiTransfer(const uint8_t* tx, bool txInc, uint8_t* rx, bool rxInc, uint8_t n) {
+	DMA1->LIFCR = SPI_RX_FLAGS;
+	DMA1->HIFCR = SPI_TX_FLAGS;
+
+	SPI_RX_STREAM->PAR = (uint32_t)&SPI3->DR;
+	SPI_RX_STREAM->M0AR = (uint32_t)rx;
+	SPI_RX_STREAM->NDTR = n;
+	SPI_RX_STREAM->FCR = 0;
+	SPI_RX_STREAM->CR = (rxInc ? DMA_SxCR_MINC : 0U) | DMA_SxCR_TCIE | DMA_SxCR_TEIE | DMA_SxCR_EN;
+
+	SPI_TX_STREAM->PAR = (uint32_t)&SPI3->DR;
+	SPI_TX_STREAM->M0AR = (uint32_t)tx;
+	SPI_TX_STREAM->NDTR = n;
+	SPI_TX_STREAM->FCR = 0;
+	SPI_TX_STREAM->CR = DMA_SxCR_DIR_0 | (txInc ? DMA_SxCR_MINC : 0U) | DMA_SxCR_EN;
+}
+
+/**
+  * @brief  Runs the list up to the next transfer, wait or its end
+  * @note	Called by the job to start and after a wait, and by the interrupt after a transfer.
+  * @param  NONE
+  * @retval NONE
+  */
+static void spiStep(void) {
+	while (spi.pc < spi.len) {
+		uint8_t op = spi.list[spi.pc];
+		uint8_t n = (op == SHELL_SPI_OP_SELECT || op == SHELL_SPI_OP_DESELECT) ? 0 : spi.list[spi.pc + 1];
+
+		switch (op) {
+		case SHELL_SPI_OP_SELECT:
+		case SHELL_SPI_OP_DESELECT:
+			spiSelect(op == SHELL_SPI_OP_SELECT);
+			spi.pc += 1;
+			break;
+		case SHELL_SPI_OP_WRITE:
+			spi.state = spiState_transfer;
+			spiTransfer(&spi.list[spi.pc + 2], true, &spiSink, false, n);
+			spi.pc += 2 + n;
+			return;
+		case SHELL_SPI_OP_READ:
+			spi.state = spiState_transfer;
+			spiTransfer(&spiFill, false, &spi.rx[spi.rxLen], true, n);
+			spi.rxLen += n;
+			spi.pc += 2;
+			return;
+		case SHELL_SPI_OP_EXCHANGE:
+			spi.state = spiState_transfer;
+			spiTransfer(&spi.list[spi.pc + 2], true, &spi.rx[spi.rxLen], true, n);
+			spi.rxLen += n;
+			spi.pc += 2 + n;
+			return;
+		default:
+			spi.waitCycles = (SystemCoreClock / 1000000U) * (n | ((uint32_t)spi.list[spi.pc + 2] << 8));
+			spi.waitStart = DWT->CYCCNT;
+			spi.pc += 3;
+			spi.state = spiState_wait;
+			shellEventSignal(SHELL_EVENT_PERIPH);
+			return;
+		}
+	}
+
+	spi.state = spiState_done;
+	shellEventSignal(SHELL_EVENT_PERIPH);
+}
+
+/**
+  * @brief  Stops both streams and the SPI, CS high
+  * @param  NONE
+  * @retval NONE
+  */
+static void spiStop(void) {
+	HAL_NVIC_DisableIRQ(SPI_RX_IRQn);
+	SPI_TX_STREAM->CR &= ~DMA_SxCR_EN;
+	SPI_RX_STREAM->CR &= ~DMA_SxCR_EN;
+	while ((SPI_TX_STREAM->CR & DMA_SxCR_EN) != 0 || (SPI_RX_STREAM->CR & DMA_SxCR_EN) != 0) {
+	}
+	DMA1->LIFCR = SPI_RX_FLAGS;
+	DMA1->HIFCR = SPI_TX_FLAGS;
+
+	SPI3->CR1 &= ~SPI_CR1_SPE;
+	HAL_GPIO_WritePin(SPI_CS_PORT, SPI_CS_PIN, GPIO_PIN_SET);
+	spi.state = spiState_idle;
+}
+
+/**
+  * @brief  Poll function of "spi"
+  * @param[IN]  job The list
+  * @retval shell_error SHELL_BUSY while the list runs, SHELL_ERR on a DMA error
+  */
+static shell_error spiJob(shellJob_t* job) {
+	if (job->cancel) {
+		spiStop();
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	spi.startCycles = DWT->CYCCNT;
+	spiStep();
+
+	while (true) {
+		SHELL_JOB_WAIT_UNTIL(job, spi.state != spiState_transfer);
+		if (spi.state == spiState_failed) {
+			spiStop();
+			job->state = 0;
+			return SHELL_ERR;
+		}
+		if (spi.state == spiState_done) {
+			break;
+		}
+
+		SHELL_JOB_WAIT_UNTIL(job, (DWT->CYCCNT - spi.waitStart) >= spi.waitCycles);
+		spiStep();
+	}
+
+	uint32_t us = (DWT->CYCCNT - spi.startCycles) / (SystemCoreClock / 1000000U);
+	spiStop();
+
+	SHELL_RESULT_DEFINE(res, job->ctx, SHELL_SPI_RX_MAX * 2 + 8);
+	shellResultBytes(&res, "rx", spi.rx, spi.rxLen);
+	shellResultUnsigned(&res, "us", us);
+	shellResultEnd(&res);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  DMA1 Stream 0, a transfer received in full
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA1_Stream0_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+	uint32_t flags = DMA1->LISR;
+
+	DMA1->LIFCR = SPI_RX_FLAGS;
+	if ((flags & SPI_RX_ERRORS) != 0) {
+		SPI_TX_STREAM->CR &= ~DMA_SxCR_EN;
+		HAL_GPIO_WritePin(SPI_CS_PORT, SPI_CS_PIN, GPIO_PIN_SET);
+		spi.state = spiState_failed;
+		shellEventSignal(SHELL_EVENT_PERIPH);
+	} else if ((flags & SPI_RX_DONE) != 0 && spi.state == spiState_transfer) {
+		spiStep();
+	}
+	SHELL_ISR_RECORD(isrId_spi, start, SHELL_ISR_NO_LATENCY);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Runs a list of SPI operations
+  * @note	See CLI_SHELL_SPI.h for the operations.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the list runs, SHELL_ERR for a malformed list
+  */
+shell_error SpiBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint8_t list[SHELL_ARRAY_MAX];
+	uint8_t len = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_l), list, SHELL_ARRAY_MAX);
+	uint32_t kHz = SHELL_SPI_DEFAULT_KHZ;
+	uint8_t mode = 0;
+
+	if (shellHasArg(parserInput, argTkn_f)) {
+		kHz = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u32;
+	}
+	if (shellHasArg(parserInput, argTkn_m)) {
+		mode = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_m)).u8;
+	}
+
+	if (len == 0 || kHz == 0 || mode > 3 || !spiCheckList(list, len)) {
+		return SHELL_ERR;
+	}
+	if (shellJobRunning() || shellJobStart(ctx, spiJob) == NULL) {
+		return SHELL_ERR;
+	}
+
+	// Waits and the elapsed time use the cycle counter, which is not running if profiling is compiled out
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	memset(&spi, 0, sizeof(spi));
+	memcpy(spi.list, list, len);
+	spi.len = len;
+	spiSetup(kHz, mode);
+
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
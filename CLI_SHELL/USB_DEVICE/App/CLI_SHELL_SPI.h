@@ -0,0 +1,65 @@
+/** @file CLI_SHELL_SPI.h
+ *
+ * @brief SPI transaction engine of the CLI Shell: batched transfers on SPI3 by DMA, "spi"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "spi l<list> f<kHz> m<mode>" runs a list of operations on SPI3 as master and answers once,
+ *    with everything read: result fields "rx" (bytes) and "us" (list start to end). In a binary
+ *    session (CLI_SHELL_BINARY.h) the list is the raw bytes of TLV l, the whole batch is one
+ *    request frame and one response frame.
+ *    - l: the operations back to back, at most SHELL_ARRAY_MAX bytes in all:
+ *        0x01                select, CS low
+ *        0x02                deselect, CS high
+ *        0x03 n b1..bn       write n bytes, what comes back is dropped
+ *        0x04 n              read n bytes, 0xFF is sent
+ *        0x05 n b1..bn       write n bytes and keep what comes back
+ *        0x06 lo hi          wait (hi << 8 | lo) microseconds
+ *      e.g. reading the JEDEC ID of a SPI flash: "spi l1,5,4,0x9F,0,0,0,2".
+ *    - f: clock in kHz, the fastest PCLK1/2^k that does not exceed it (default
+ *      SHELL_SPI_DEFAULT_KHZ). m: SPI mode 0 to 3 (CPOL, CPHA), default 0.
+ *  - Pins: PC10 SCK, PC11 MISO, PC12 MOSI (AF6), PA15 CS (push-pull). CS ends high after every
+ *    list, also on an error or a cancel.
+ *  - DMA1 Stream 0 (SPI3_RX) and Stream 5 (SPI3_TX) move every write and read. The transfer
+ *    complete interrupt of the receive stream runs the list on: selects and the next transfer
+ *    start right there, so a list of transfers goes at the speed of the bus, not of the main
+ *    loop or the USB. Only waits hand back to the job (CLI_SHELL_JOB.h), which resumes the list
+ *    once the time is up.
+ *  - Reads keep at most SHELL_SPI_RX_MAX bytes per list. The list is checked before it starts,
+ *    a malformed one or one that reads more is SHELL_ERR without touching the bus.
+ *  - The HAL SPI module is not part of the project, SPI3 and its streams are driven through their
+ *    registers like the CRC unit (CLI_SHELL_CRC.h).
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_SPI_H_
+#define CLI_SHELL_SPI_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_SPI_RX_MAX				256			/*!< Bytes read per list				*/
+#define SHELL_SPI_DEFAULT_KHZ			1000
+#define SHELL_SPI_IRQ_PRIORITY			1			/*!< Runs the list between transfers	*/
+
+#define SHELL_SPI_OP_SELECT				0x01
+#define SHELL_SPI_OP_DESELECT			0x02
+#define SHELL_SPI_OP_WRITE				0x03
+#define SHELL_SPI_OP_READ				0x04
+#define SHELL_SPI_OP_EXCHANGE			0x05
+#define SHELL_SPI_OP_DELAY				0x06
+
+#endif // CLI_SHELL_SPI_H_
+
+/*** end of file ***/
@@ -0,0 +1,358 @@
+/** @file CLI_SHELL_STREAM.c
+ *
+ * @brief High-rate telemetry streaming for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Stream queue attached to the port of the command
+ * - 1.2: 10-14-2026 (Crandell) Report goes to the shell instance of the job
+ * - 1.3: 10-14-2026 (Crandell) Text records by CLI_SHELL_FORMAT
+ * - 1.4: 10-15-2026 (Crandell) Stamped binary frames (CLI_SHELL_TSYNC)
+ * - 1.5: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_FORMAT.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_STREAM.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+_Static_assert(SHELL_STREAM_FRAME_SAMPLES <= 0xFF, "Frame sample count must fit the count byte");
+
+/**
+  * @brief  A paced stream more than this many periods behind skips the missed samples
+  */
+#define STREAM_MAX_LAG_PERIODS		16
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The running stream
+  */
+typedef struct {
+	shellStreamSource_t source;
+	bool binary;							/*!< Binary frames instead of text records	*/
+	bool stamped;							/*!< Frames carry the synced time			*/
+	uint8_t dataOffset;						/*!< First sample byte of a frame			*/
+	uint8_t frameSamples;					/*!< Samples of a full frame				*/
+	bool endless;							/*!< Runs until cancelled					*/
+	uint32_t remaining;						/*!< Samples still to take					*/
+	uint32_t period;						/*!< Cycles between samples, 0 = unpaced	*/
+	uint32_t nextDue;						/*!< Cycle count of the next sample			*/
+	uint16_t counter;						/*!< Test pattern value						*/
+	uint32_t sent;							/*!< Samples queued							*/
+	uint32_t dropped;						/*!< Samples lost							*/
+	bool droppedSinceFrame;					/*!< Loss to report in the next frame		*/
+	bool framePending;						/*!< Full frame waiting for room			*/
+	uint8_t frameSeq;
+	uint8_t frameCount;						/*!< Samples in frame						*/
+	uint8_t frame[SHELL_STREAM_FRAME_LEN];
+} shellStream_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellStream_t stream;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint16_t readSample(void);
+static bool queueText(uint16_t sample);
+static bool queueFrame(uint8_t flags);
+static void produceSamples(void);
+static bool queueLastFrame(void);
+static void reportStream(shell_ctx_t* ctx);
+static shell_error streamJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Takes one sample of the selected source
+  * @param  NONE
+  * @retval uint16_t Sample
+  */
+static uint16_t readSample(void) {
+	switch (stream.source) {
+	case streamSrc_gpioA:
+		return (uint16_t)GPIOA->IDR;
+
+	case streamSrc_gpioB:
+		return (uint16_t)GPIOB->IDR;
+
+	case streamSrc_gpioC:
+		return (uint16_t)GPIOC->IDR;
+
+	default:
+		return stream.counter++;
+	}
+}
+
+/**
+  * @brief  Queues one text record
+  * @param[IN]  sample Sample
+  * @retval bool Returns false if the stream queue had no room
+  */
+static bool queueText(uint16_t sample) {
+	char record[SHELL_STREAM_TEXT_LEN] = { '0', 'x', 0, 0, 0, 0, '\r', '\n' };
+
+	shellFmtHex16(&record[2], sample);
+	return transportStreamWrite((uint8_t*)record, sizeof(record));
+}
+
+/**
+  * @brief  Completes the frame being filled and queues it
+  * @note	On success the next frame is started.
+  * @param[IN]  flags Extra SHELL_STREAM_FLAG_ bits
+  * @retval bool Returns false if the stream queue had no room
+  */
+static bool queueFrame(uint8_t flags) {
+	if (stream.droppedSinceFrame) {
+		flags |= SHELL_STREAM_FLAG_DROPPED;
+	}
+	if (stream.stamped) {
+		flags |= SHELL_STREAM_FLAG_STAMPED;
+	}
+
+	stream.frame[0] = SHELL_STREAM_SOF;
+	stream.frame[1] = stream.frameSeq;
+	stream.frame[2] = stream.frameCount;
+	stream.frame[3] = flags;
+
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &stream.frame[1], SHELL_STREAM_FRAME_LEN - 3);
+	stream.frame[SHELL_STREAM_FRAME_LEN - 2] = (uint8_t)crc;
+	stream.frame[SHELL_STREAM_FRAME_LEN - 1] = (uint8_t)(crc >> 8);
+
+	if (!transportStreamWrite(stream.frame, SHELL_STREAM_FRAME_LEN)) {
+		return false;
+	}
+
+	stream.sent += stream.frameCount;
+	stream.frameSeq++;
+	stream.frameCount = 0;
+	stream.framePending = false;
+	stream.droppedSinceFrame = false;
+	memset(&stream.frame[stream.dataOffset], 0, stream.frameSamples * 2);
+	return true;
+}
+
+/**
+  * @brief  Takes the samples that are due, at most SHELL_STREAM_SAMPLES_PER_POLL
+  * @param  NONE
+  * @retval NONE
+  */
+static void produceSamples(void) {
+	// A frame that did not fit last time goes first (unpaced streams only)
+	if (stream.framePending && !queueFrame(0)) {
+		return;
+	}
+
+	for (uint16_t i = 0; i < SHELL_STREAM_SAMPLES_PER_POLL; i++) {
+		if (!stream.endless && stream.remaining == 0) {
+			return;
+		}
+
+		if (stream.period != 0) {
+			uint32_t late = DWT->CYCCNT - stream.nextDue;
+			if ((int32_t)late < 0) {
+				// Not due yet
+				return;
+			}
+
+			if (late >= (stream.period * STREAM_MAX_LAG_PERIODS)) {
+				// The main loop was held up, skip what could not be sampled in time
+				uint32_t missed = late / stream.period;
+				if (!stream.endless && missed > stream.remaining) {
+					missed = stream.remaining;
+				}
+				stream.dropped += missed;
+				stream.droppedSinceFrame = true;
+				stream.remaining -= stream.endless ? 0 : missed;
+				stream.nextDue += missed * stream.period;
+				continue;
+			}
+			stream.nextDue += stream.period;
+		}
+
+		if (!stream.binary && stream.period == 0 && transportStreamFree() < SHELL_STREAM_TEXT_LEN) {
+			// Wait for room, nothing is lost
+			return;
+		}
+
+		uint16_t sample = readSample();
+
+		if (stream.binary) {
+			if (stream.stamped && stream.frameCount == 0) {
+				uint32_t stamp = shellTsyncNow();
+				uint8_t* out = &stream.frame[SHELL_STREAM_FRAME_HEADER_LEN];
+
+				out[0] = (uint8_t)stamp;
+				out[1] = (uint8_t)(stamp >> 8);
+				out[2] = (uint8_t)(stamp >> 16);
+				out[3] = (uint8_t)(stamp >> 24);
+			}
+			stream.frame[stream.dataOffset + 2 * stream.frameCount] = (uint8_t)sample;
+			stream.frame[stream.dataOffset + 2 * stream.frameCount + 1] = (uint8_t)(sample >> 8);
+			stream.frameCount++;
+
+			if (stream.frameCount == stream.frameSamples && !queueFrame(0)) {
+				if (stream.period == 0) {
+					// Wait for room, nothing is lost
+					stream.framePending = true;
+					stream.remaining -= stream.endless ? 0 : 1;
+					return;
+				}
+				stream.dropped += stream.frameCount;
+				stream.droppedSinceFrame = true;
+				stream.frameCount = 0;
+			}
+		} else if (queueText(sample)) {
+			stream.sent++;
+		} else {
+			stream.dropped++;
+			stream.droppedSinceFrame = true;
+		}
+
+		stream.remaining -= stream.endless ? 0 : 1;
+	}
+}
+
+/**
+  * @brief  Queues the last, possibly short, binary frame
+  * @param  NONE
+  * @retval bool Returns true once it is queued (or there is nothing to send)
+  */
+static bool queueLastFrame(void) {
+	if (!stream.binary) {
+		return true;
+	}
+	if (stream.framePending && !queueFrame(0)) {
+		return false;
+	}
+	return queueFrame(SHELL_STREAM_FLAG_LAST);
+}
+
+/**
+  * @brief  Sends the sample and drop counts
+  * @param[IN]  ctx Shell instance of the job
+  * @retval NONE
+  */
+static void reportStream(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 60);
+
+	shellStrAppend(&str, "Stream: ");
+	shellStrAppendUnsigned(&str, stream.sent, 0);
+	shellStrAppend(&str, " samples, ");
+	shellStrAppendUnsigned(&str, stream.dropped, 0);
+	shellStrAppend(&str, " dropped\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Poll function of "stream"
+  * @param[IN]  job The stream job
+  * @retval shell_error SHELL_BUSY while streaming
+  */
+static shell_error streamJob(shellJob_t* job) {
+	if (job->cancel) {
+		reportStream(job->ctx);
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	while (stream.endless || stream.remaining > 0 || stream.framePending) {
+		produceSamples();
+		SHELL_JOB_YIELD(job);
+	}
+
+	// Send the rest, then report once the host has everything
+	SHELL_JOB_WAIT_UNTIL(job, queueLastFrame());
+	SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+	reportStream(job->ctx);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Starts a telemetry stream
+  * @note	See CLI_SHELL_STREAM.h for the arguments and the record formats.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the stream is running
+  */
+shell_error StreamBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	uint8_t source = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_s)).u8;
+	uint32_t rate = 0;
+	uint32_t count = 0;
+	uint8_t format = 0;
+
+	if (shellHasArg(parserInput, argTkn_r)) {
+		rate = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u32;
+	}
+	if (shellHasArg(parserInput, argTkn_n)) {
+		count = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32;
+	}
+	if (shellHasArg(parserInput, argTkn_f)) {
+		format = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+	}
+
+	if (source >= streamSrc_count || format > 2) {
+		return SHELL_ERR;
+	}
+
+	// The stream queue goes to the port of this command. It only moves once it has drained.
+	if (shellJobRunning() || !transportStreamAttach(ctx)) {
+		return SHELL_ERR;
+	}
+
+	if (shellJobStart(ctx, streamJob) == NULL) {
+		return SHELL_ERR;
+	}
+
+	// GPIOC is not used by the board setup and may still be unclocked
+	if (source == streamSrc_gpioC) {
+		__HAL_RCC_GPIOC_CLK_ENABLE();
+	}
+
+	// Pacing uses the cycle counter, which is not running if profiling is compiled out
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	memset(&stream, 0, sizeof(stream));
+	stream.source = (shellStreamSource_t)source;
+	stream.binary = (format != 0);
+	stream.stamped = (format == 2);
+	stream.dataOffset = SHELL_STREAM_FRAME_HEADER_LEN + (stream.stamped ? SHELL_STREAM_STAMP_LEN : 0);
+	stream.frameSamples = stream.stamped ? SHELL_STREAM_STAMPED_SAMPLES : SHELL_STREAM_FRAME_SAMPLES;
+	stream.endless = (count == 0);
+	stream.remaining = count;
+	stream.period = (rate == 0) ? 0 : (SystemCoreClock / rate);
+	if (rate != 0 && stream.period == 0) {
+		stream.period = 1;
+	}
+	stream.nextDue = DWT->CYCCNT;
+
+	return SHELL_BUSY;
+}
+
+/*** end of file ***/
@@ -0,0 +1,86 @@
+/** @file CLI_SHELL_STREAM.h
+ *
+ * @brief High-rate telemetry streaming for the CLI Shell
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Stamped binary frames (f2)
+ *
+ * Usage Notes:
+ *  - "stream s<source> r<rate> n<count> f<format>" samples a 16-bit source and sends every
+ *    sample through the transport's stream queue (transportStreamWrite). It runs as a job
+ *    (CLI_SHELL_JOB.h), so the shell stays responsive and "cancel" or Ctrl-C stops it.
+ *    - s: 0 counter (test pattern, +1 per sample), 1 GPIOA, 2 GPIOB, 3 GPIOC input register
+ *    - r: samples per second, 0 or omitted sends as fast as the queue drains
+ *    - n: number of samples, 0 or omitted streams until cancelled
+ *    - f: 0 text (default), 1 binary, 2 binary stamped with the synced time
+ *  - Text records are 8 characters: "0x1A2B\r\n".
+ *  - Binary records are SHELL_STREAM_FRAME_LEN byte frames, exactly one USB packet:
+ *      | 0x5B | seq | count | flags | SHELL_STREAM_FRAME_SAMPLES x sample (2, LE) | CRC16 (2, LE) |
+ *    count is the number of valid samples (the last frame may be short, the rest is zero).
+ *    flags has SHELL_STREAM_FLAG_DROPPED if samples were lost since the previous frame and
+ *    SHELL_STREAM_FLAG_LAST on the final frame. CRC16 as CLI_SHELL_BINARY.h, over every byte after the SOF.
+ *  - Stamped frames (f2) have SHELL_STREAM_FLAG_STAMPED set and the time of their first sample
+ *    on the synced clock (CLI_SHELL_TSYNC.h) in front of the samples, SHELL_STREAM_STAMPED_SAMPLES
+ *    of them:
+ *      | 0x5B | seq | count | flags | stamp (4, LE, us) | samples (2, LE) | CRC16 (2, LE) |
+ *    Streams of several boards on one host controller line up on the stamps.
+ *  - With a rate, a sample that finds the queue full is dropped and counted. Without a rate
+ *    the sampling waits for room instead. The count is reported when the stream ends:
+ *      "Stream: <samples> samples, <dropped> dropped"
+ *  - Shell output has priority over the stream and is sent between whole records. After a
+ *    cancel, samples still queued follow the response.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_STREAM_H_
+#define CLI_SHELL_STREAM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_STREAM_SOF					0x5B		/*!< Binary stream frame start			*/
+#define SHELL_STREAM_FRAME_LEN				64			/*!< One full speed packet				*/
+#define SHELL_STREAM_FRAME_HEADER_LEN		4			/*!< SOF, seq, count, flags				*/
+#define SHELL_STREAM_FRAME_SAMPLES			((SHELL_STREAM_FRAME_LEN - SHELL_STREAM_FRAME_HEADER_LEN - 2) / 2)
+#define SHELL_STREAM_STAMP_LEN				4			/*!< Synced time of the first sample	*/
+#define SHELL_STREAM_STAMPED_SAMPLES		((SHELL_STREAM_FRAME_LEN - SHELL_STREAM_FRAME_HEADER_LEN - SHELL_STREAM_STAMP_LEN - 2) / 2)
+#define SHELL_STREAM_TEXT_LEN				8			/*!< "0x1A2B\r\n"						*/
+
+#define SHELL_STREAM_FLAG_DROPPED			0x01
+#define SHELL_STREAM_FLAG_LAST				0x02
+#define SHELL_STREAM_FLAG_STAMPED			0x04
+
+/**
+  * @brief  Samples taken per checkShellStatus() at most, keeps the main loop responsive
+  */
+#ifndef SHELL_STREAM_SAMPLES_PER_POLL
+#define SHELL_STREAM_SAMPLES_PER_POLL		256
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Sources
+  */
+typedef enum {
+	streamSrc_counter = 0,
+	streamSrc_gpioA,
+	streamSrc_gpioB,
+	streamSrc_gpioC,
+	streamSrc_count
+} shellStreamSource_t;
+
+#endif // CLI_SHELL_STREAM_H_
+
+/*** end of file ***/
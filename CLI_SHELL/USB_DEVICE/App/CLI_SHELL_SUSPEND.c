@@ -0,0 +1,187 @@
+/** @file CLI_SHELL_SUSPEND.c
+ *
+ * @brief USB suspend of the CLI Shell: STOP mode while the host has the port suspended
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_SUSPEND.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_CLOCK.h"
+#include "CLI_SHELL_UART.h"
+#include "CLI_SHELL_RTOS.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SUSPEND_USE_STOP				(SHELL_SUSPEND_STOP && !SHELL_UART_ENABLED && !SHELL_RTOS_ENABLED)
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Suspend statistics ("usbstat")
+  */
+typedef struct {
+	uint32_t suspends;						/*!< Suspends signalled by the host			*/
+	uint32_t stops;							/*!< STOP entries (several per suspend if woken)	*/
+	uint32_t wakeups;						/*!< Clock restores after STOP				*/
+	uint32_t wakeCyclesSum;					/*!< HSI cycles to restore the clocks		*/
+	uint32_t wakeCyclesMax;
+} shellSuspendStats_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static volatile bool suspended;				/*!< Set by the suspend, cleared by the wake	*/
+static shellSuspendStats_t stats;
+
+extern PCD_HandleTypeDef hpcd_USB_OTG_FS;
+extern void SystemClock_Config(void);
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void restoreClocks(void);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Brings back the clocks after STOP, the core runs on the HSI until then
+  * @note	Called with interrupts masked. A WFI that did not enter STOP (an interrupt was already
+  * 		pending) left the PLL running and nothing is done.
+  * @param  NONE
+  * @retval NONE
+  */
+static void restoreClocks(void) {
+	uint32_t start = shellPerfCycles();
+	uint32_t cycles;
+
+	if (__HAL_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK) {
+		return;
+	}
+
+	SystemClock_Config();
+	if (shellClockCurrent() != clockProfile_performance) {
+		shellClockApply(shellClockCurrent());
+	}
+
+	cycles = shellPerfCycles() - start;
+	stats.wakeups++;
+	stats.wakeCyclesSum += cycles;
+	if (cycles > stats.wakeCyclesMax) {
+		stats.wakeCyclesMax = cycles;
+	}
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  The host suspended the port, called by the suspend callback (USB interrupt)
+  * @note	The PHY clock is gated by the callback. The interrupt ends a WFI, the main loop
+  * 		enters STOP on its next shellEventWait().
+  * @param  NONE
+  * @retval NONE
+  */
+void shellSuspendEnter(void) {
+	stats.suspends++;
+	suspended = true;
+}
+
+/**
+  * @brief  The bus is active again, called by OTG_FS_WKUP_IRQHandler() and the resume and reset
+  * 		callbacks
+  * @note	Ungates the PHY clock. The clocks are back already, shellSuspendStop() restores them
+  * 		before interrupts are taken. The next pass flushes the output queued meanwhile.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellSuspendWake(void) {
+	__HAL_PCD_UNGATE_PHYCLOCK(&hpcd_USB_OTG_FS);
+	if (suspended) {
+		suspended = false;
+		shellEventSignal(SHELL_EVENT_TX);
+	}
+}
+
+/**
+  * @brief  Whether the port is suspended
+  * @param  NONE
+  * @retval bool Returns true between shellSuspendEnter() and shellSuspendWake()
+  */
+bool shellSuspended(void) {
+	return suspended;
+}
+
+/**
+  * @brief  Stays in STOP until the port is resumed, called by shellEventWait()
+  * @note	Each round enters STOP with interrupts masked and restores the clocks on wake before
+  * 		unmasking them, the interrupt that woke the core runs after that. Returns at once
+  * 		if STOP is not used in this build (SHELL_SUSPEND_STOP).
+  * @param  NONE
+  * @retval NONE
+  */
+void shellSuspendStop(void) {
+#if SUSPEND_USE_STOP
+	while (suspended) {
+		__disable_irq();
+		if (suspended) {
+			stats.stops++;
+			// Restarted with the clocks (HAL_InitTick())
+			HAL_SuspendTick();
+			HAL_PWR_EnterSTOPMode(PWR_MAINREGULATOR_ON, PWR_STOPENTRY_WFI);
+			restoreClocks();
+			HAL_ResumeTick();
+		}
+		__enable_irq();
+		__ISB();
+	}
+#endif
+}
+
+/**
+  * @brief  Adds the suspend line to the "usbstat" dump
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellSuspendReport(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 96);
+	uint32_t hsiMHz = HSI_VALUE / 1000000U;
+	uint32_t wakeups = stats.wakeups;
+
+	shellStrAppend(&str, "Suspend: ");
+	shellStrAppendUnsigned(&str, stats.suspends, 0);
+	shellStrAppend(&str, " suspends, ");
+	shellStrAppendUnsigned(&str, stats.stops, 0);
+	shellStrAppend(&str, " stops, wake mean ");
+	shellStrAppendUnsigned(&str, (wakeups != 0) ? (stats.wakeCyclesSum / wakeups / hsiMHz) : 0, 0);
+	shellStrAppend(&str, " us, max ");
+	shellStrAppendUnsigned(&str, stats.wakeCyclesMax / hsiMHz, 0);
+	shellStrAppend(&str, SUSPEND_USE_STOP ? " us\r\n" : " us (STOP off)\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Clears the suspend statistics ("usbstat r1")
+  * @param  NONE
+  * @retval NONE
+  */
+void shellSuspendClear(void) {
+	memset(&stats, 0, sizeof(stats));
+}
+
+/*** end of file ***/
@@ -0,0 +1,72 @@
+/** @file CLI_SHELL_SUSPEND.h
+ *
+ * @brief USB suspend of the CLI Shell: STOP mode while the host has the port suspended
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The suspend callback (usbd_conf.c) gates the PHY clock and calls shellSuspendEnter(). The
+ *    main loop enters STOP from shellEventWait() (CLI_SHELL_EVENT.h) with the main regulator on
+ *    and the flash powered, even with work pending: a running job or a periodic command simply
+ *    holds until the resume. SRAM and every peripheral register are kept, so the shell
+ *    instances are left as they are: receive rings and partial lines, the transmit queues,
+ *    jobs, the session modes, history and settings. The SysTick is stopped meanwhile,
+ *    HAL_GetTick() does not count the suspended time.
+ *  - Resume or reset signalling on the bus wakes the core through EXTI line 18. The main loop
+ *    restarts the HSE and the PLL (SystemClock_Config()) and goes back to the clock profile
+ *    that was active (CLI_SHELL_CLOCK.h) before interrupts are taken again, so the USB
+ *    interrupts never run on the HSI. OTG_FS_WKUP_IRQHandler() then ungates the PHY clock
+ *    (shellSuspendWake()). The crystal startup makes up most of the wake time, about 1-2 ms,
+ *    well within the 10 ms the host allows after resume signalling. The device keeps its
+ *    address and configuration and the host sees a plain resume: output queued before the
+ *    suspend goes out with the next pass, nothing is enumerated again.
+ *  - Interrupts that wake the core while the port is still suspended (a GPIO EXTI) are served
+ *    and the core goes back to STOP.
+ *  - STOP is only used without the USART transport and without the RTOS port
+ *    (SHELL_UART_ENABLED, SHELL_RTOS_ENABLED) and with SHELL_SUSPEND_STOP set: the USART cannot
+ *    receive in STOP and the RTOS owns the idle sleep. Otherwise only the PHY clock is gated
+ *    while suspended and the core runs on.
+ *  - A debugger loses the core in STOP unless HAL_DBGMCU_EnableDBGStopMode() was called.
+ *  - "usbstat" shows the suspends, the STOP entries and the wake time (mean and max),
+ *    "usbstat r1" clears them with the other link counters.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_SUSPEND_H_
+#define CLI_SHELL_SUSPEND_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_SUSPEND_STOP
+#define SHELL_SUSPEND_STOP				1			/*!< STOP mode while suspended			*/
+#endif
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellSuspendEnter(void);
+void shellSuspendWake(void);
+bool shellSuspended(void);
+void shellSuspendStop(void);
+void shellSuspendReport(shell_ctx_t* ctx);
+void shellSuspendClear(void);
+
+#endif // CLI_SHELL_SUSPEND_H_
+
+/*** end of file ***/
@@ -0,0 +1,367 @@
+/** @file CLI_SHELL_TPUT.c
+ *
+ * @brief USB throughput benchmark of the CLI Shell transport
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Stream queue attached to the port of the command
+ * - 1.2: 10-14-2026 (Crandell) Runs on the shell instance of the job
+ * - 1.3: 10-15-2026 (Crandell) Loopback test (d2) and "ping" command
+ * - 1.4: 10-15-2026 (Crandell) "loopback", "sink" and "source" start the directions by name
+ * - 1.5: 10-15-2026 (Crandell) Report lines with shellStr_t, no sprintf
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_PERF.h"
+#include "CLI_SHELL_TPUT.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Test directions, the d argument of "tput"
+  */
+typedef enum {
+	tputDir_in = 0,							/*!< Device to host (source)					*/
+	tputDir_out,							/*!< Host to device (sink)						*/
+	tputDir_loop,							/*!< Host to device and back (loopback)			*/
+	tputDir_count
+} shellTputDir_t;
+
+/**
+  * @brief  The running test
+  */
+typedef struct {
+	uint8_t direction;						/*!< shellTputDir_t								*/
+	uint32_t total;							/*!< Bytes to move								*/
+	uint32_t done;							/*!< Bytes moved								*/
+	uint32_t startTick;						/*!< First byte (OUT) or start (IN)				*/
+	uint32_t lastTick;						/*!< Last byte									*/
+	uint32_t droppedAtStart;				/*!< Receive ring drop count before the test	*/
+	uint8_t chunk[SHELL_TPUT_CHUNK_LEN];
+} shellTput_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellTput_t tput;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool sendChunks(void);
+static bool drainInput(shell_ctx_t* ctx);
+static bool echoInput(shell_ctx_t* ctx);
+static void reportTput(shell_ctx_t* ctx);
+static shell_error tputJob(shellJob_t* job);
+static shell_error tputStart(shell_ctx_t* ctx, uint8_t direction, uint32_t total);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Queues pattern chunks while the stream queue has room
+  * @param  NONE
+  * @retval bool Returns true once all bytes are queued
+  */
+static bool sendChunks(void) {
+	while (tput.done < tput.total) {
+		uint32_t len = tput.total - tput.done;
+		if (len > SHELL_TPUT_CHUNK_LEN) {
+			len = SHELL_TPUT_CHUNK_LEN;
+		}
+
+		if (!transportStreamWrite(tput.chunk, len)) {
+			// Queue full, the USB interrupt makes room
+			return false;
+		}
+		tput.done += len;
+	}
+	return true;
+}
+
+/**
+  * @brief  Discards the received bytes
+  * @param[IN]  ctx Shell instance of the job
+  * @retval bool Returns true once all bytes arrived or the host went quiet
+  */
+static bool drainInput(shell_ctx_t* ctx) {
+	uint8_t* data;
+	uint32_t len;
+	uint32_t now = HAL_GetTick();
+
+	while ((len = shellRingPeekContiguous(&ctx->rxRing, &data)) != 0) {
+		if (tput.done == 0) {
+			tput.startTick = now;
+		}
+		if (len > tput.total - tput.done) {
+			len = tput.total - tput.done;
+		}
+
+		shellRingSkip(&ctx->rxRing, len);
+		tput.done += len;
+		tput.lastTick = now;
+
+		if (tput.done == tput.total) {
+			return true;
+		}
+	}
+
+	// Time out from the last byte, or from the start if nothing came
+	return (now - tput.lastTick) >= SHELL_TPUT_IDLE_MS;
+}
+
+/**
+  * @brief  Sends the received bytes back through the stream queue
+  * @note	Takes from the receive ring only what the stream queue has room for, the host
+  * 		must keep reading while it sends or both sides stall until the timeout.
+  * @param[IN]  ctx Shell instance of the job
+  * @retval bool Returns true once all bytes are echoed or the host went quiet
+  */
+static bool echoInput(shell_ctx_t* ctx) {
+	uint8_t* data;
+	uint32_t len;
+	uint32_t now = HAL_GetTick();
+
+	while (tput.done < tput.total && (len = shellRingPeekContiguous(&ctx->rxRing, &data)) != 0) {
+		if (tput.done == 0) {
+			tput.startTick = now;
+		}
+		if (len > tput.total - tput.done) {
+			len = tput.total - tput.done;
+		}
+		if (len > transportStreamFree()) {
+			len = transportStreamFree();
+		}
+
+		if (len == 0 || !transportStreamWrite(data, (uint16_t)len)) {
+			// Queue full, the USB interrupt makes room
+			return false;
+		}
+		shellRingSkip(&ctx->rxRing, len);
+		tput.done += len;
+		tput.lastTick = now;
+	}
+
+	if (tput.done == tput.total) {
+		return true;
+	}
+	return (now - tput.lastTick) >= SHELL_TPUT_IDLE_MS;
+}
+
+/**
+  * @brief  Sends the result line
+  * @param[IN]  ctx Shell instance of the job
+  * @retval NONE
+  */
+static void reportTput(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 80);
+	uint32_t ms = tput.lastTick - tput.startTick;
+	uint32_t rate = (ms == 0) ? 0 : (uint32_t)(((uint64_t)tput.done * 1000U) / ms);
+
+	if (tput.direction == tputDir_out) {
+		shellStrAppend(&str, "OUT: ");
+	} else if (tput.direction == tputDir_loop) {
+		shellStrAppend(&str, "LOOP: ");
+	} else {
+		shellStrAppend(&str, "IN: ");
+	}
+	shellStrAppendUnsigned(&str, tput.done, 0);
+	shellStrAppend(&str, " bytes in ");
+	shellStrAppendUnsigned(&str, ms, 0);
+	shellStrAppend(&str, " ms, ");
+	shellStrAppendUnsigned(&str, rate, 0);
+	shellStrAppend(&str, " B/s");
+	if (tput.direction == tputDir_out) {
+		shellStrAppend(&str, ", ");
+		shellStrAppendUnsigned(&str, ctx->rxRing.dropped - tput.droppedAtStart, 0);
+		shellStrAppend(&str, " dropped");
+	}
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Poll function of "tput"
+  * @param[IN]  job The test job
+  * @retval shell_error SHELL_BUSY while the test runs
+  */
+static shell_error tputJob(shellJob_t* job) {
+	if (job->cancel) {
+		tput.lastTick = HAL_GetTick();
+		reportTput(job->ctx);
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	if (tput.direction == tputDir_out) {
+		SHELL_JOB_WAIT_UNTIL(job, drainInput(job->ctx));
+		job->ownsInput = false;
+	} else if (tput.direction == tputDir_loop) {
+		SHELL_JOB_WAIT_UNTIL(job, echoInput(job->ctx));
+		job->ownsInput = false;
+		// Time until the host has read the last echoed byte
+		SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+		if (tput.done != 0) {
+			tput.lastTick = HAL_GetTick();
+		}
+	} else {
+		SHELL_JOB_WAIT_UNTIL(job, sendChunks());
+		// Time until the host has read the last byte
+		SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+		tput.lastTick = HAL_GetTick();
+	}
+	reportTput(job->ctx);
+
+	SHELL_JOB_END(job);
+}
+
+/**
+  * @brief  Starts a throughput test as a job
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  direction shellTputDir_t
+  * @param[IN]  total Bytes to move
+  * @retval shell_error SHELL_BUSY once the test is running
+  */
+static shell_error tputStart(shell_ctx_t* ctx, uint8_t direction, uint32_t total) {
+	if (direction >= tputDir_count || total == 0) {
+		return SHELL_ERR;
+	}
+
+	// IN and loopback send through the stream queue, which goes to the port of this command
+	if (direction != tputDir_out && (shellJobRunning() || !transportStreamAttach(ctx))) {
+		return SHELL_ERR;
+	}
+
+	shellJob_t* job = shellJobStart(ctx, tputJob);
+	if (job == NULL) {
+		return SHELL_ERR;
+	}
+
+	memset(&tput, 0, sizeof(tput));
+	tput.direction = direction;
+	tput.total = total;
+	tput.startTick = HAL_GetTick();
+	tput.lastTick = tput.startTick;
+	tput.droppedAtStart = ctx->rxRing.dropped;
+	for (uint8_t i = 0; i < SHELL_TPUT_CHUNK_LEN; i++) {
+		tput.chunk[i] = i;
+	}
+
+	// Bytes after the command line belong to the test
+	job->ownsInput = (direction != tputDir_in);
+
+	return SHELL_BUSY;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Starts a throughput test
+  * @note	See CLI_SHELL_TPUT.h for the host side of the test.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the test is running
+  */
+shell_error TputBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	return tputStart(ctx, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8,
+			shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32);
+}
+
+/**
+  * @brief  Loopback test, "tput d2"
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the test is running
+  */
+shell_error LoopbackBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	return tputStart(ctx, tputDir_loop, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32);
+}
+
+/**
+  * @brief  OUT test, "tput d1": counts and discards the bytes of the host
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the test is running
+  */
+shell_error SinkBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	return tputStart(ctx, tputDir_out, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32);
+}
+
+/**
+  * @brief  IN test, "tput d0": sends the pattern as fast as the host reads it
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY once the test is running
+  */
+shell_error SourceBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	return tputStart(ctx, tputDir_in, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u32);
+}
+
+/**
+  * @brief  Answers at once with the device time and the payload, for round trip measurements
+  * @note	See CLI_SHELL_TPUT.h for the response line.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error PingBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 32 + SHELL_ARG_LEN);
+	uint32_t cycles = shellPerfCycles();
+	uint16_t pad = 0;
+	uint8_t letter = 0;
+
+	if (shellHasArg(parserInput, argTkn_n)) {
+		pad = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).u16;
+	}
+	if (pad > SHELL_PING_MAX_PAD) {
+		return SHELL_ERR;
+	}
+
+	shellStrAppend(&str, "PONG ");
+	shellStrAppendUnsigned(&str, HAL_GetTick(), 0);
+	shellStrAppendChar(&str, ' ');
+	shellStrAppendUnsigned(&str, cycles, 0);
+	if (shellHasArg(parserInput, argTkn_p)) {
+		shellStrAppendChar(&str, ' ');
+		shellStrAppend(&str, shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).str);
+	}
+	if (pad != 0) {
+		shellStrAppendChar(&str, ' ');
+	}
+	shellStrSend(ctx, &str);
+
+	// Pad in pieces the transmit queue can take
+	while (pad != 0) {
+		uint16_t len = (pad > str.size) ? str.size : pad;
+
+		if (!shellOutputReserve(ctx, len)) {
+			return SHELL_ERR;
+		}
+		for (uint16_t i = 0; i < len; i++) {
+			shellStrAppendChar(&str, (char)('a' + letter));
+			letter = (letter + 1) % 26;
+		}
+		shellStrSend(ctx, &str);
+		pad -= len;
+	}
+
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
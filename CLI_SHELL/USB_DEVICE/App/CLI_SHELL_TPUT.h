@@ -0,0 +1,61 @@
+/** @file CLI_SHELL_TPUT.h
+ *
+ * @brief USB throughput benchmark of the CLI Shell transport
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Loopback test (d2) and "ping" command
+ * - 1.2: 10-15-2026 (Crandell) "loopback", "sink" and "source", host tool Tools/shell_bench.py
+ *
+ * Usage Notes:
+ *  - "tput d0 n<bytes>" (IN): the device sends n bytes of a counting pattern through the
+ *    stream queue as fast as the host reads them, then reports
+ *      "IN: <bytes> bytes in <ms> ms, <bytes/s> B/s"
+ *    The host should read and discard everything up to that line.
+ *  - "tput d1 n<bytes>" (OUT): right after the command line the host sends n bytes of anything
+ *    but 0x03. The device counts and discards them, then reports
+ *      "OUT: <bytes> bytes in <ms> ms, <bytes/s> B/s, <dropped> dropped"
+ *    The time runs from the first to the last byte. dropped counts bytes that did not fit the
+ *    receive ring. The test gives up after SHELL_TPUT_IDLE_MS without data.
+ *  - "tput d2 n<bytes>" (loopback): right after the command line the host sends n bytes of
+ *    anything but 0x03 and reads them back while it sends. The device echoes them through the
+ *    stream queue, then reports
+ *      "LOOP: <bytes> bytes in <ms> ms, <bytes/s> B/s"
+ *    The time runs from the first byte received to the last byte read by the host. A host that
+ *    does not read while it sends stalls the test (the receive ring fills and is held back).
+ *  - "ping p<payload> n<pad>" answers right away, without a job:
+ *      "PONG <tick ms> <cycles> <payload> <pad bytes>"
+ *    tick and cycles are HAL_GetTick() and the DWT cycle counter when the bridge ran, so the host
+ *    can tell its round trip time from the time spent in the device between two pings. n (up to
+ *    SHELL_PING_MAX_PAD) sizes the response with n pattern characters. A host takes latency
+ *    percentiles from a series of pings of one size, throughput from "tput".
+ *  - "source n<bytes>", "sink n<bytes>" and "loopback n<bytes>" are "tput d0", "d1" and "d2".
+ *  - "tput" and its three names run as a job (CLI_SHELL_JOB.h): the OK... response line comes
+ *    after the result line. The results depend on the FIFO layout in usbd_conf.h.
+ *  - Tools/shell_bench.py runs the series: round trip percentiles of "ping" per response size,
+ *    then MB/s of each direction, as the host and as the device measured it.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_TPUT_H_
+#define CLI_SHELL_TPUT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_TPUT_CHUNK_LEN			64			/*!< IN pattern bytes per stream write	*/
+#define SHELL_TPUT_IDLE_MS				2000		/*!< OUT test timeout without data		*/
+#define SHELL_PING_MAX_PAD				1024		/*!< Largest pad of a "ping" response	*/
+
+#endif // CLI_SHELL_TPUT_H_
+
+/*** end of file ***/
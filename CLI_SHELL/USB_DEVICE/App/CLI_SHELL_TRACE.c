@@ -0,0 +1,283 @@
+/** @file CLI_SHELL_TRACE.c
+ *
+ * @brief Binary event trace of the CLI Shell, the ring and the "trace" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Ring kept over a soft reset
+ * - 1.2: 10-15-2026 (Crandell) Synced time of the last SOF in the export header
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_TRACE.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  The running export
+  */
+typedef struct {
+	uint32_t first;							/*!< Next entry to send (ring position)		*/
+	uint32_t remaining;						/*!< Entries left							*/
+	uint32_t total;							/*!< Entries exported						*/
+	uint16_t crc;							/*!< CRC16 of the bytes queued so far		*/
+	uint16_t chunkLen;						/*!< Bytes in chunk still waiting for room	*/
+	bool wasEnabled;						/*!< Recording state before the export		*/
+	uint8_t chunk[SHELL_TRACE_CHUNK_ENTRIES * sizeof(shellTraceEntry_t)];
+} shellTraceDump_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+SHELL_NOINIT shellTraceRing_t shellTraceRing;
+
+static shellTraceDump_t dump;
+static bool traceStarted = false;						/*!< shellTraceInit() ran since reset	*/
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void putLe32(uint8_t* out, uint32_t value);
+static uint16_t fillHeader(void);
+static bool dumpEntries(void);
+static shell_error traceJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stores a word little endian
+  * @param[OUT]  out 4 bytes
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+static void putLe32(uint8_t* out, uint32_t value) {
+	out[0] = (uint8_t)value;
+	out[1] = (uint8_t)(value >> 8);
+	out[2] = (uint8_t)(value >> 16);
+	out[3] = (uint8_t)(value >> 24);
+}
+
+/**
+  * @brief  Builds the export header in the chunk
+  * @param  NONE
+  * @retval uint16_t Header length
+  */
+static uint16_t fillHeader(void) {
+	uint32_t lost = shellTraceRing.head - dump.total;
+	shellTsyncRef_t sync;
+
+	// Unlocked, the tool shows no synced time
+	if (!shellTsyncRef(&sync)) {
+		sync.cyclesPerMs = 0;
+	}
+
+	memcpy(dump.chunk, SHELL_TRACE_MAGIC, 4);
+	putLe32(&dump.chunk[4], dump.total);
+	putLe32(&dump.chunk[8], SystemCoreClock);
+	putLe32(&dump.chunk[12], lost);
+	putLe32(&dump.chunk[16], sync.cycles);
+	putLe32(&dump.chunk[20], sync.us);
+	putLe32(&dump.chunk[24], sync.cyclesPerMs);
+	return SHELL_TRACE_HEADER_LEN;
+}
+
+/**
+  * @brief  Queues the entries, oldest first, while the stream queue has room
+  * @param  NONE
+  * @retval bool Returns true once all entries are queued
+  */
+static bool dumpEntries(void) {
+	while (true) {
+		if (dump.chunkLen == 0) {
+			if (dump.remaining == 0) {
+				return true;
+			}
+
+			uint32_t count = (dump.remaining < SHELL_TRACE_CHUNK_ENTRIES) ? dump.remaining : SHELL_TRACE_CHUNK_ENTRIES;
+			for (uint32_t i = 0; i < count; i++) {
+				const shellTraceEntry_t* entry = &shellTraceRing.entries[(dump.first + i) & (SHELL_TRACE_DEPTH - 1)];
+				uint8_t* out = &dump.chunk[i * sizeof(shellTraceEntry_t)];
+
+				putLe32(out, entry->cycles);
+				out[4] = entry->event;
+				out[5] = entry->port;
+				out[6] = (uint8_t)entry->arg;
+				out[7] = (uint8_t)(entry->arg >> 8);
+			}
+			dump.first += count;
+			dump.remaining -= count;
+			dump.chunkLen = (uint16_t)(count * sizeof(shellTraceEntry_t));
+			dump.crc = shellCrc16(dump.crc, dump.chunk, dump.chunkLen);
+		}
+
+		if (!transportStreamWrite(dump.chunk, dump.chunkLen)) {
+			// Queue full, the USB interrupt makes room
+			return false;
+		}
+		dump.chunkLen = 0;
+	}
+}
+
+/**
+  * @brief  Poll function of "trace d1"
+  * @param[IN]  job The export job
+  * @retval shell_error SHELL_BUSY while the export runs
+  */
+static shell_error traceJob(shellJob_t* job) {
+	if (job->cancel) {
+		shellTraceRing.enabled = dump.wasEnabled;
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	SHELL_JOB_WAIT_UNTIL(job, dumpEntries());
+	// The result line must not overtake the data
+	SHELL_JOB_WAIT_UNTIL(job, transportStreamUsed() == 0);
+	shellTraceRing.enabled = dump.wasEnabled;
+	{
+		SHELL_STR_DEFINE(str, 48);
+
+		shellStrAppend(&str, "TRACE: ");
+		shellStrAppendUnsigned(&str, dump.total, 0);
+		shellStrAppend(&str, " entries, CRC 0x");
+		shellStrAppendHex(&str, dump.crc, 4);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(job->ctx, &str);
+	}
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Starts recording after a reset, keeps the entries of an intact ring
+  * @note	Called by shellInit(), only the first call after a reset does something.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellTraceInit(void) {
+	if (traceStarted) {
+		return;
+	}
+	traceStarted = true;
+
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (shellTraceRing.magic == SHELL_TRACE_RING_MAGIC && shellTraceRing.check == ~SHELL_TRACE_RING_MAGIC) {
+		shellTraceRing.resetHead = shellTraceRing.head;
+	} else {
+		// Power-up, the RAM is random
+		shellTraceRing.head = 0;
+		shellTraceRing.resetHead = 0;
+		shellTraceRing.magic = SHELL_TRACE_RING_MAGIC;
+		shellTraceRing.check = ~SHELL_TRACE_RING_MAGIC;
+	}
+	shellTraceRing.enabled = true;
+
+	__set_PRIMASK(primask);
+
+	if (shellTraceRing.head != 0) {
+		SHELL_TRACE(traceEvt_reset, SHELL_TRACE_NO_PORT, 0);
+	}
+}
+
+/**
+  * @brief  Drops every recorded entry
+  * @param  NONE
+  * @retval NONE
+  */
+void shellTraceClear(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	shellTraceRing.head = 0;
+	shellTraceRing.resetHead = 0;
+	__set_PRIMASK(primask);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Trace state, recording on/off (e), clear (c1) or the binary export (d1)
+  * @note	See CLI_SHELL_TRACE.h for the export format.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value, SHELL_BUSY while the export runs
+  */
+shell_error TraceBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	if (shellHasArg(parserInput, argTkn_e)) {
+		uint8_t enable = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_e)).u8;
+		if (enable > 1) {
+			return SHELL_ERR;
+		}
+		shellTraceRing.enabled = (enable == 1);
+	}
+	if (shellHasArg(parserInput, argTkn_c) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 != 0) {
+		shellTraceClear();
+	}
+
+	if (shellHasArg(parserInput, argTkn_d) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8 != 0) {
+		// The export goes through the stream queue, which goes to the port of this command
+		if (shellJobRunning() || !transportStreamAttach(ctx)) {
+			return SHELL_ERR;
+		}
+		if (shellJobStart(ctx, traceJob) == NULL) {
+			return SHELL_ERR;
+		}
+
+		// Freeze the ring, the entries of this command would land in the middle of the export
+		memset(&dump, 0, sizeof(dump));
+		dump.wasEnabled = shellTraceRing.enabled;
+		shellTraceRing.enabled = false;
+		dump.total = (shellTraceRing.head < SHELL_TRACE_DEPTH) ? shellTraceRing.head : SHELL_TRACE_DEPTH;
+		dump.first = shellTraceRing.head - dump.total;
+		dump.remaining = dump.total;
+		dump.chunkLen = fillHeader();
+		dump.crc = shellCrc16(SHELL_BIN_CRC_INIT, dump.chunk, dump.chunkLen);
+		return SHELL_BUSY;
+	}
+
+	SHELL_STR_DEFINE(str, 80);
+	uint32_t stored = (shellTraceRing.head < SHELL_TRACE_DEPTH) ? shellTraceRing.head : SHELL_TRACE_DEPTH;
+	uint32_t sinceReset = shellTraceRing.head - shellTraceRing.resetHead;
+
+	shellStrAppend(&str, "Trace: ");
+	shellStrAppend(&str, shellTraceRing.enabled ? "recording, " : "stopped, ");
+	shellStrAppendUnsigned(&str, stored, 0);
+	shellStrAppendChar(&str, '/');
+	shellStrAppendUnsigned(&str, SHELL_TRACE_DEPTH, 0);
+	shellStrAppend(&str, " entries, ");
+	shellStrAppendUnsigned(&str, shellTraceRing.head - stored, 0);
+	shellStrAppend(&str, " overwritten\r\n");
+	shellStrSend(ctx, &str);
+
+	if (shellTraceRing.resetHead != 0 && sinceReset < stored) {
+		shellStrAppend(&str, "Kept over the last reset: ");
+		shellStrAppendUnsigned(&str, stored - sinceReset, 0);
+		shellStrAppend(&str, " entries\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,168 @@
+/** @file CLI_SHELL_TRACE.h
+ *
+ * @brief Binary event trace of the CLI Shell, from the USB interrupts through the main loop
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) CLI_SHELL_PORT.h for the host build
+ * - 1.2: 10-14-2026 (Crandell) Ring in .noinit, kept over a soft reset
+ * - 1.3: 10-15-2026 (Crandell) traceEvt_overrun
+ * - 1.4: 10-15-2026 (Crandell) Export header "TRC2" with the synced time (CLI_SHELL_TSYNC.h)
+ *
+ * Usage Notes:
+ *  - SHELL_TRACE(event, port, arg) stores the DWT cycle counter with an event id, the port and a
+ *    16 bit argument in a ring of SHELL_TRACE_DEPTH entries. It is inline, takes about a dozen
+ *    cycles and is safe from interrupts. The oldest entries are overwritten.
+ *  - Built in events (shellTraceEvent_t):
+ *      traceEvt_rx			CDC/vendor OUT packet received (CDC_Receive_FS), arg = bytes
+ *      traceEvt_cmdStart		Text line handed to the parser (shellProcessCommand), arg = length
+ *      traceEvt_bridgeStart	Arguments valid, bridge called (shellDispatch), arg = table index
+ *      traceEvt_bridgeEnd		Bridge returned, arg = shell_error
+ *      traceEvt_txStart		IN transfer started (CDC_StartNextTransfer_FS, CDC_Transmit_FS), arg = bytes
+ *      traceEvt_txDone		IN transfer completed (DataIn stage), arg = bytes
+ *      traceEvt_reset		First entry after a reset that kept the ring, the cycles restart
+ *      traceEvt_overrun		Bridge took longer than its deadline (SHELL_DEADLINE_LIST), after
+ *      						traceEvt_bridgeEnd, arg = bridge time in µs (0xFFFF and up saturate)
+ *    Ids from traceEvt_user up are free for temporary instrumentation.
+ *  - "trace" shows the state, "trace e0"/"trace e1" stops/starts recording, "trace c1" clears.
+ *  - The ring is in .noinit (SHELL_NOINIT), the startup code does not zero it. shellTraceInit()
+ *    (from shellInit()) keeps the entries when the ring is intact, a soft reset, the watchdog or
+ *    a debugger reset, and starts over after power-up. "trace" then counts the entries from
+ *    before the reset, the export has them in front of traceEvt_reset. Recording is on after
+ *    every reset.
+ *  - "trace d1" exports the ring raw through the stream queue (USB only), oldest entry first:
+ *      header  "TRC2", uint32 entries, uint32 core clock (Hz), uint32 entries lost to overwrites,
+ *              uint32 cycles at the last SOF, uint32 synced time then (us), uint32 cycles per ms
+ *              measured against the SOFs (0 while the time sync is not locked)
+ *      entries uint32 cycles, uint8 event, uint8 port (0xFF none), uint16 arg
+ *    all little endian, then the line "TRACE: <entries> entries, CRC 0x<crc>" (CRC16 as
+ *    CLI_SHELL_BINARY.h over header and entries). Recording pauses for the dump.
+ *  - Tools/shell_trace.py reads the export from the port or a file and prints a timeline with the
+ *    time between the events of each command. With the synced time in the header it also shows
+ *    when each entry since the last reset happened on the clock shared by the boards of a host
+ *    controller (CLI_SHELL_TSYNC.h), exports of several boards can be merged on it.
+ *  - Define SHELL_TRACE_ENABLE as 0 to compile every hook out.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_TRACE_H_
+#define CLI_SHELL_TRACE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_PORT.h"
+#include "CLI_SHELL_PERF.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_TRACE_ENABLE
+#define SHELL_TRACE_ENABLE			1
+#endif
+
+/**
+  * @brief  Entries in the ring, a power of two (8 bytes each)
+  */
+#ifndef SHELL_TRACE_DEPTH
+#define SHELL_TRACE_DEPTH			256
+#endif
+
+#if (SHELL_TRACE_DEPTH & (SHELL_TRACE_DEPTH - 1)) != 0
+#error "SHELL_TRACE_DEPTH must be a power of two"
+#endif
+
+#define SHELL_TRACE_NO_PORT			0xFF		/*!< Event of no particular port			*/
+#define SHELL_TRACE_MAGIC			"TRC2"		/*!< First bytes of the export				*/
+#define SHELL_TRACE_HEADER_LEN		28
+#define SHELL_TRACE_CHUNK_ENTRIES	32			/*!< Entries per stream write				*/
+#define SHELL_TRACE_RING_MAGIC		0x54524331U	/*!< Ring intact, survives a reset			*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Event ids
+  */
+typedef enum {
+	traceEvt_rx = 1,
+	traceEvt_cmdStart,
+	traceEvt_bridgeStart,
+	traceEvt_bridgeEnd,
+	traceEvt_txStart,
+	traceEvt_txDone,
+	traceEvt_reset,
+	traceEvt_overrun,
+	traceEvt_user = 0x80
+} shellTraceEvent_t;
+
+/**
+  * @brief  One entry, the export layout
+  */
+typedef struct {
+	uint32_t cycles;						/*!< DWT->CYCCNT							*/
+	uint8_t event;							/*!< shellTraceEvent_t						*/
+	uint8_t port;							/*!< Port or SHELL_TRACE_NO_PORT			*/
+	uint16_t arg;
+} shellTraceEntry_t;
+
+/**
+  * @brief  The ring. Written by shellTraceRecord() only.
+  * @note	Not zeroed at reset, shellTraceInit() checks magic and check.
+  */
+typedef struct {
+	shellTraceEntry_t entries[SHELL_TRACE_DEPTH];
+	uint32_t head;							/*!< Entries recorded, next slot = head % depth	*/
+	uint32_t resetHead;						/*!< head at the last reset, older entries came before it	*/
+	uint32_t magic;							/*!< SHELL_TRACE_RING_MAGIC once initialized	*/
+	uint32_t check;							/*!< ~magic									*/
+	bool enabled;
+} shellTraceRing_t;
+
+extern shellTraceRing_t shellTraceRing;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellTraceInit(void);
+void shellTraceClear(void);
+
+/**
+  * @brief  Records one event
+  * @note	Interrupt safe, the slot is claimed and filled with interrupts masked.
+  * @param[IN]  event shellTraceEvent_t
+  * @param[IN]  port Port or SHELL_TRACE_NO_PORT
+  * @param[IN]  arg Event argument
+  * @retval NONE
+  */
+static inline void shellTraceRecord(uint8_t event, uint8_t port, uint16_t arg) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+
+	if (shellTraceRing.enabled) {
+		shellTraceEntry_t* entry = &shellTraceRing.entries[shellTraceRing.head++ & (SHELL_TRACE_DEPTH - 1)];
+
+		entry->cycles = shellPerfCycles();
+		entry->event = event;
+		entry->port = port;
+		entry->arg = arg;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+#if SHELL_TRACE_ENABLE
+#define SHELL_TRACE(event, port, arg)		shellTraceRecord((uint8_t)(event), (uint8_t)(port), (uint16_t)(arg))
+#else
+#define SHELL_TRACE(event, port, arg)		((void)0)
+#endif
+
+#endif // CLI_SHELL_TRACE_H_
+
+/*** end of file ***/
@@ -0,0 +1,264 @@
+/** @file CLI_SHELL_TSYNC.c
+ *
+ * @brief Time sync of the CLI Shell: a microsecond clock locked to the USB frames of the host
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_TSYNC.h"
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Clock state, written by the SOF interrupt
+  * @note	Read with interrupts masked (syncSnapshot()), the fields belong together.
+  */
+typedef struct {
+	bool started;							/*!< First SOF seen, DWT counting			*/
+	uint32_t frames;						/*!< Frames since the epoch					*/
+	uint32_t lastFrame;						/*!< Number of the last SOF (11 bits)		*/
+	uint32_t sofCycles;						/*!< DWT->CYCCNT at the last SOF			*/
+	uint32_t cyclesPerFrame;				/*!< Filtered, << SHELL_TSYNC_FILTER_SHIFT	*/
+	uint32_t steady;						/*!< Steady frames in a row, up to lock		*/
+	uint32_t jitterMax;						/*!< Worst deviation while locked (cycles)	*/
+	uint32_t sofs;
+	uint32_t missed;						/*!< Frames without an SOF interrupt		*/
+	uint32_t restarts;						/*!< Filter restarts (clock changes)		*/
+} shellTsync_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellTsync_t sync;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void syncSnapshot(shellTsync_t* copy);
+static uint32_t syncTime(const shellTsync_t* s, uint32_t cycles, bool now);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Copies the clock state consistently
+  * @param[OUT]  copy State
+  * @retval NONE
+  */
+static void syncSnapshot(shellTsync_t* copy) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	*copy = sync;
+	__set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Synced time of a cycle stamp
+  * @note	Stamps before the last SOF give times before it. A stamp taken now past the end of
+  * 		the frame while the SOF is only due (interrupt latency) is held at 999 us, so the
+  * 		time does not step back when it comes. Without SOFs the local clock runs on.
+  * @param[IN]  s Clock state
+  * @param[IN]  cycles DWT->CYCCNT within about 20 s of the last SOF
+  * @param[IN]  now The stamp is the current cycle count
+  * @retval uint32_t Microseconds since the epoch
+  */
+static uint32_t syncTime(const shellTsync_t* s, uint32_t cycles, bool now) {
+	uint32_t cpf = s->cyclesPerFrame >> SHELL_TSYNC_FILTER_SHIFT;
+	int64_t sub;
+
+	if (cpf == 0) {
+		return s->frames * 1000U;
+	}
+
+	sub = ((int64_t)(int32_t)(cycles - s->sofCycles) * 1000) / cpf;
+	if (now && sub >= 1000 && sub < 2000) {
+		sub = 999;
+	}
+	return s->frames * 1000U + (uint32_t)(int32_t)sub;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Start of a USB frame, called by the SOF callback (usbd_conf.c)
+  * @note	Runs at the USB interrupt priority, first thing in the callback. The cycles between
+  * 		two SOFs are averaged, an interval off by more than 1/8 (clock profile change) restarts
+  * 		the average. Gaps of several frames only advance the frame count.
+  * @param[IN]  frame Frame number (OTG_FS DSTS.FNSOF)
+  * @retval NONE
+  */
+void shellTsyncSof(uint32_t frame) {
+	uint32_t now = DWT->CYCCNT;
+	uint32_t step;
+	uint32_t interval;
+	uint32_t cpf;
+	uint32_t deviation;
+
+	frame &= SHELL_TSYNC_FRAME_MASK;
+	if (!sync.started) {
+		// Interpolation needs the cycle counter, also when profiling is compiled out
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+		sync.started = true;
+		sync.lastFrame = frame;
+		sync.sofCycles = DWT->CYCCNT;
+		return;
+	}
+
+	step = (frame - sync.lastFrame) & SHELL_TSYNC_FRAME_MASK;
+	if (step == 0) {
+		return;
+	}
+	interval = now - sync.sofCycles;
+	sync.frames += step;
+	sync.lastFrame = frame;
+	sync.sofCycles = now;
+	sync.sofs++;
+
+	if (step != 1) {
+		// Suspended or SOFs lost, the cycles of the gap say nothing about one frame
+		sync.missed += step - 1;
+		sync.steady = 0;
+		return;
+	}
+
+	cpf = sync.cyclesPerFrame >> SHELL_TSYNC_FILTER_SHIFT;
+	deviation = (interval > cpf) ? (interval - cpf) : (cpf - interval);
+	if (cpf == 0 || deviation > (cpf >> 3)) {
+		sync.restarts += (cpf != 0) ? 1 : 0;
+		sync.cyclesPerFrame = interval << SHELL_TSYNC_FILTER_SHIFT;
+		sync.steady = 0;
+		return;
+	}
+
+	// cyclesPerFrame += interval - cyclesPerFrame / 16
+	sync.cyclesPerFrame += interval - cpf;
+	if (sync.steady < SHELL_TSYNC_LOCK_FRAMES) {
+		sync.steady++;
+	} else if (deviation > sync.jitterMax) {
+		sync.jitterMax = deviation;
+	}
+}
+
+/**
+  * @brief  The time at the last SOF, to convert cycle stamps elsewhere (trace export)
+  * @param[OUT]  ref Cycles and time at the last SOF, measured cycles per frame
+  * @retval bool Returns true if the clock is locked, ref is zeroed before the first SOF
+  */
+bool shellTsyncRef(shellTsyncRef_t* ref) {
+	shellTsync_t s;
+
+	syncSnapshot(&s);
+	ref->cycles = s.sofCycles;
+	ref->us = s.frames * 1000U;
+	ref->cyclesPerMs = s.cyclesPerFrame >> SHELL_TSYNC_FILTER_SHIFT;
+	return (s.steady >= SHELL_TSYNC_LOCK_FRAMES);
+}
+
+/**
+  * @brief  The synced time now
+  * @param  NONE
+  * @retval uint32_t Microseconds since the epoch ("tsync f")
+  */
+uint32_t shellTsyncNow(void) {
+	shellTsync_t s;
+
+	syncSnapshot(&s);
+	return syncTime(&s, DWT->CYCCNT, true);
+}
+
+/**
+  * @brief  The synced time of a DWT cycle stamp taken earlier
+  * @param[IN]  cycles DWT->CYCCNT within about 20 s of now
+  * @retval uint32_t Microseconds since the epoch
+  */
+uint32_t shellTsyncAt(uint32_t cycles) {
+	shellTsync_t s;
+
+	syncSnapshot(&s);
+	return syncTime(&s, cycles, false);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Shows the synced clock, sets the epoch (f)
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser (f - frame number of the epoch)
+  * @retval shell_error Error Return Value
+  */
+shell_error TsyncBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 96);
+	shellTsync_t s;
+	uint32_t now;
+
+	if (shellHasArg(parserInput, argTkn_f)) {
+		uint32_t frame = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u16;
+		uint32_t primask = __get_PRIMASK();
+
+		if (!sync.started || frame > SHELL_TSYNC_FRAME_MASK) {
+			return SHELL_ERR;
+		}
+		// The epoch is the last frame with that number, up to 2047 frames ago
+		__disable_irq();
+		sync.frames = (sync.lastFrame - frame) & SHELL_TSYNC_FRAME_MASK;
+		__set_PRIMASK(primask);
+		return SHELL_OK;
+	}
+
+	syncSnapshot(&s);
+	now = syncTime(&s, DWT->CYCCNT, true);
+
+	shellStrAppend(&str, "Sync: ");
+	shellStrAppend(&str, !s.started ? "no SOF" : (s.steady >= SHELL_TSYNC_LOCK_FRAMES) ? "locked" : "not locked");
+	shellStrAppend(&str, ", frame ");
+	shellStrAppendUnsigned(&str, s.lastFrame, 0);
+	shellStrAppend(&str, ", time ");
+	shellStrAppendUnsigned(&str, now, 0);
+	shellStrAppend(&str, " us\r\n");
+	shellStrSend(ctx, &str);
+
+	if (s.cyclesPerFrame != 0) {
+		// Core clock as the host sees it, against the nominal one
+		uint32_t measured = (uint32_t)(((uint64_t)s.cyclesPerFrame * 1000U) >> SHELL_TSYNC_FILTER_SHIFT);
+		int32_t ppm = (int32_t)(((int64_t)measured - SystemCoreClock) * 1000000 / SystemCoreClock);
+
+		shellStrAppend(&str, "Clock: ");
+		shellStrAppendUnsigned(&str, measured, 0);
+		shellStrAppend(&str, " Hz (");
+		shellStrAppendChar(&str, (ppm < 0) ? '-' : '+');
+		shellStrAppendUnsigned(&str, (uint32_t)((ppm < 0) ? -ppm : ppm), 0);
+		shellStrAppend(&str, " ppm), jitter max ");
+		shellStrAppendUnsigned(&str, s.jitterMax, 0);
+		shellStrAppend(&str, " cycles\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	shellStrAppend(&str, "SOF: ");
+	shellStrAppendUnsigned(&str, s.sofs, 0);
+	shellStrAppend(&str, " frames, ");
+	shellStrAppendUnsigned(&str, s.missed, 0);
+	shellStrAppend(&str, " missed, ");
+	shellStrAppendUnsigned(&str, s.restarts, 0);
+	shellStrAppend(&str, " restarts\r\n");
+	shellStrSend(ctx, &str);
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,72 @@
+/** @file CLI_SHELL_TSYNC.h
+ *
+ * @brief Time sync of the CLI Shell: a microsecond clock locked to the USB frames of the host
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The host starts a USB frame every millisecond and numbers it (SOF, 11 bits). Every device on
+ *    the same host controller sees the same numbers at the same time, give or take the hub
+ *    delays of well below a microsecond. The SOF interrupt (usbd_conf.c) hands the frame number
+ *    to shellTsyncSof(), which extends it to 32 bits and notes the DWT cycle count.
+ *  - shellTsyncNow() is frames * 1000 plus the microseconds since the last SOF, interpolated with
+ *    the measured cycles per frame. That measurement follows the host: the drift of the local
+ *    crystal and a clock profile change (CLI_SHELL_CLOCK.h) are taken out. The time is a
+ *    uint32 in microseconds and wraps after about 71 minutes, compare stamps by difference.
+ *  - "tsync f<frame>" sets the epoch: time 0 is the start of the last frame with that number.
+ *    Send the same frame number to every board within 2 s (the 11 bits wrap after 2048 frames)
+ *    and their clocks agree, e.g. the frame "tsync" just showed on one of them.
+ *    Tools/shell_client.py does that for a fleet (Fleet.sync()).
+ *  - The clock is locked after SHELL_TSYNC_LOCK_FRAMES steady frames. Without SOFs (suspended,
+ *    unplugged) it runs on from the local clock until they come back, the frame numbers then
+ *    account for the frames missed. Boards on different host controllers are not aligned.
+ *  - Stamped with it: the trace export header (CLI_SHELL_TRACE.h, the tool converts every entry),
+ *    the capture period dump (CLI_SHELL_CAPTURE.h) and the frames of "stream f2" (CLI_SHELL_STREAM.h).
+ *  - The error is the SOF interrupt latency jitter, a few cycles unless a higher priority
+ *    interrupt or a masked section delays it. "tsync" shows the worst deviation seen.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_TSYNC_H_
+#define CLI_SHELL_TSYNC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_TSYNC_FRAME_MASK			0x7FFU		/*!< SOF frame numbers, 11 bits			*/
+#define SHELL_TSYNC_LOCK_FRAMES			16			/*!< Steady frames before it is locked	*/
+#define SHELL_TSYNC_FILTER_SHIFT		4			/*!< Cycles per frame averaged over 16	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Time at the last SOF, to convert cycle stamps taken around it
+  */
+typedef struct {
+	uint32_t cycles;						/*!< DWT->CYCCNT at the SOF					*/
+	uint32_t us;							/*!< Synced time at the SOF					*/
+	uint32_t cyclesPerMs;					/*!< Measured cycles per frame, 0 until locked	*/
+} shellTsyncRef_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellTsyncSof(uint32_t frame);
+bool shellTsyncRef(shellTsyncRef_t* ref);
+uint32_t shellTsyncNow(void);
+uint32_t shellTsyncAt(uint32_t cycles);
+
+#endif // CLI_SHELL_TSYNC_H_
+
+/*** end of file ***/
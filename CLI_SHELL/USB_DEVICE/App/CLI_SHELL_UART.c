@@ -0,0 +1,381 @@
+/** @file CLI_SHELL_UART.c
+ *
+ * @brief USART transport for the CLI Shell: circular DMA receive, DMA transmit
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-14-2026 (Crandell) Transmit complete signals the main loop
+ * - 1.2: 10-14-2026 (Crandell) Handlers profiled (CLI_SHELL_ISR)
+ * - 1.3: 10-15-2026 (Crandell) No notification channel
+ * - 1.4: 10-15-2026 (Crandell) Zero-copy output (txSpan/txCommit)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_UART.h"
+#include "CLI_SHELL_RING.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_ISR.h"
+
+#if SHELL_UART_ENABLED
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define UART_INSTANCE			USART1
+#define UART_IRQn				USART1_IRQn
+#define UART_GPIO_PORT			GPIOB
+#define UART_GPIO_PINS			(GPIO_PIN_6 | GPIO_PIN_7)
+#define UART_GPIO_AF			GPIO_AF7_USART1
+
+#define UART_RX_DMA_STREAM		DMA2_Stream2
+#define UART_RX_DMA_IRQn		DMA2_Stream2_IRQn
+#define UART_TX_DMA_STREAM		DMA2_Stream7
+#define UART_TX_DMA_IRQn		DMA2_Stream7_IRQn
+#define UART_DMA_CHANNEL		DMA_CHANNEL_4
+
+_Static_assert((SHELL_UART_TX_LEN & (SHELL_UART_TX_LEN - 1)) == 0, "SHELL_UART_TX_LEN must be a power of two");
+_Static_assert(SHELL_UART_RX_DMA_LEN <= 0xFFFF, "SHELL_UART_RX_DMA_LEN exceeds the DMA transfer count");
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void uartAttach(uint8_t port, shell_ctx_t* ctx);
+static uint16_t uartWrite(uint8_t port, const uint8_t* buffer, uint16_t length);
+static void uartFlush(void);
+static uint32_t uartTxFree(uint8_t port);
+static uint32_t uartTxSpan(uint8_t port, uint8_t** data);
+static void uartTxCommit(uint8_t port, uint16_t length);
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static DMA_HandleTypeDef hdmaRx;
+static DMA_HandleTypeDef hdmaTx;
+
+static uint32_t baudRate;							/*!< Requested rate, kept for clock changes	*/
+static shell_ctx_t* attachedShell = NULL;			/*!< Instance fed with the received data	*/
+
+SHELL_NOINIT static uint8_t rxDma[SHELL_UART_RX_DMA_LEN];		/*!< Written by the DMA only				*/
+static uint32_t rxTail;								/*!< Next byte to hand to the shell			*/
+
+SHELL_NOINIT static uint8_t txStorage[SHELL_UART_TX_LEN];
+static shellRing_t txQueue = SHELL_RING_STATIC_INIT(txStorage);
+static volatile uint32_t txInFlightLen;				/*!< Bytes in the running DMA transfer, 0 if idle	*/
+
+const shellTransport_t shellUartTransport = {
+	.attach = uartAttach,
+	.write = uartWrite,
+	.flush = uartFlush,
+	.txFree = uartTxFree,
+	.streamAttach = NULL,
+	.rxResume = NULL,
+	.notify = NULL,
+	.txSpan = uartTxSpan,
+	.txCommit = uartTxCommit,
+};
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Baud rate register value for 8x oversampling
+  * @note	USARTDIV = PCLK2 / (8 * baud). In sixteenths that is 2 * PCLK2 / baud, of which
+  * 		BRR takes the mantissa and three fraction bits.
+  * @param[IN]  baud Baud rate
+  * @retval uint32_t USART_BRR value
+  */
+static uint32_t uartBrr(uint32_t baud) {
+	uint32_t div = (2U * HAL_RCC_GetPCLK2Freq() + baud / 2U) / baud;
+
+	return (div & 0xFFF0U) | ((div & 0x000FU) >> 1);
+}
+
+/**
+  * @brief  Hands everything the DMA wrote since the last call to the attached shell
+  * @note	Called from the receive DMA and USART interrupts. Both run at SHELL_UART_IRQ_PRIORITY,
+  * 		so they never preempt each other.
+  * @param  NONE
+  * @retval NONE
+  */
+static void uartDeliver(void) {
+	uint32_t head = (SHELL_UART_RX_DMA_LEN - __HAL_DMA_GET_COUNTER(&hdmaRx)) % SHELL_UART_RX_DMA_LEN;
+	uint32_t len;
+
+	if (head == rxTail) {
+		return;
+	}
+
+	if (attachedShell != NULL) {
+		if (head > rxTail) {
+			len = head - rxTail;
+			rxShellInput(attachedShell, &rxDma[rxTail], &len);
+		} else {
+			// Wrapped: the end of the buffer, then its start
+			len = SHELL_UART_RX_DMA_LEN - rxTail;
+			rxShellInput(attachedShell, &rxDma[rxTail], &len);
+			if (head > 0) {
+				len = head;
+				rxShellInput(attachedShell, rxDma, &len);
+			}
+		}
+	}
+	rxTail = head;
+}
+
+/**
+  * @brief  Half and full transfer of the circular receive DMA
+  * @param[IN]  hdma Receive DMA handle
+  * @retval NONE
+  */
+static void uartRxDmaEvent(DMA_HandleTypeDef* hdma) {
+	uartDeliver();
+}
+
+/**
+  * @brief  Receive DMA error. The HAL has stopped the stream, start over with an empty buffer.
+  * @param[IN]  hdma Receive DMA handle
+  * @retval NONE
+  */
+static void uartRxDmaError(DMA_HandleTypeDef* hdma) {
+	rxTail = 0;
+	HAL_DMA_Start_IT(&hdmaRx, (uint32_t)&UART_INSTANCE->DR, (uint32_t)rxDma, SHELL_UART_RX_DMA_LEN);
+}
+
+/**
+  * @brief  Starts a DMA transfer of the contiguous part of the transmit queue
+  * @note	Runs from uartFlush() only while nothing is in flight, else from the transfer complete
+  * 		interrupt. txInFlightLen is cleared last, so the two never start a transfer at once.
+  * @param  NONE
+  * @retval NONE
+  */
+static void uartStartTransfer(void) {
+	uint8_t* data;
+	uint32_t len = shellRingPeekContiguous(&txQueue, &data);
+
+	if (len == 0) {
+		txInFlightLen = 0;
+		return;
+	}
+
+	txInFlightLen = len;
+	if (HAL_DMA_Start_IT(&hdmaTx, (uint32_t)data, (uint32_t)&UART_INSTANCE->DR, len) != HAL_OK) {
+		txInFlightLen = 0;
+	}
+}
+
+/**
+  * @brief  Transmit DMA complete: release the bytes sent and chain the next transfer
+  * @param[IN]  hdma Transmit DMA handle
+  * @retval NONE
+  */
+static void uartTxDmaDone(DMA_HandleTypeDef* hdma) {
+	shellRingSkip(&txQueue, txInFlightLen);
+	uartStartTransfer();
+	shellEventSignal(SHELL_EVENT_TX);
+}
+
+/**
+  * @brief  Transport: routes the received data to a shell instance (shellInit())
+  * @param[IN]  port Ignored, there is one USART
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void uartAttach(uint8_t port, shell_ctx_t* ctx) {
+	attachedShell = ctx;
+}
+
+/**
+  * @brief  Transport: queues output. Never blocks, anything that does not fit is dropped.
+  * @param[IN]  port Ignored, there is one USART
+  * @param[IN]  buffer Data to send
+  * @param[IN]  length Number of bytes
+  * @retval uint16_t Number of bytes queued
+  */
+static uint16_t uartWrite(uint8_t port, const uint8_t* buffer, uint16_t length) {
+	return (uint16_t)shellRingWrite(&txQueue, buffer, length);
+}
+
+/**
+  * @brief  Transport: starts sending the queued output unless a transfer is running
+  * @param  NONE
+  * @retval NONE
+  */
+static void uartFlush(void) {
+	if (txInFlightLen == 0) {
+		uartStartTransfer();
+	}
+}
+
+/**
+  * @brief  Transport: room left in the transmit queue
+  * @param[IN]  port Ignored, there is one USART
+  * @retval uint32_t Free bytes
+  */
+static uint32_t uartTxFree(uint8_t port) {
+	return shellRingFree(&txQueue);
+}
+
+/**
+  * @brief  Transport: contiguous free block of the transmit queue
+  * @param[IN]  port Ignored, there is one USART
+  * @param[OUT] data Start of the block
+  * @retval uint32_t Length of the block
+  */
+static uint32_t uartTxSpan(uint8_t port, uint8_t** data) {
+	return shellRingReserveContiguous(&txQueue, data);
+}
+
+/**
+  * @brief  Transport: queues the bytes written into the block of uartTxSpan()
+  * @param[IN]  port Ignored, there is one USART
+  * @param[IN]  length Number of bytes written
+  * @retval NONE
+  */
+static void uartTxCommit(uint8_t port, uint16_t length) {
+	shellRingCommit(&txQueue, length);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Sets up the USART, its pins and both DMA streams and starts receiving
+  * @note	Call once after SystemClock_Config(), before shellInit() attaches an instance.
+  * 		Data received before that is discarded.
+  * @param[IN]  baud Baud rate, up to PCLK2 / 8
+  * @retval bool Returns false if the rate is out of range or a DMA stream could not be set up
+  */
+bool shellUartInit(uint32_t baud) {
+	GPIO_InitTypeDef gpioInit = {0};
+
+	if (baud == 0 || baud > HAL_RCC_GetPCLK2Freq() / 8U) {
+		return false;
+	}
+	baudRate = baud;
+
+	__HAL_RCC_GPIOB_CLK_ENABLE();
+	__HAL_RCC_USART1_CLK_ENABLE();
+	__HAL_RCC_DMA2_CLK_ENABLE();
+
+	gpioInit.Pin = UART_GPIO_PINS;
+	gpioInit.Mode = GPIO_MODE_AF_PP;
+	gpioInit.Pull = GPIO_PULLUP;
+	gpioInit.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+	gpioInit.Alternate = UART_GPIO_AF;
+	HAL_GPIO_Init(UART_GPIO_PORT, &gpioInit);
+
+	hdmaRx.Instance = UART_RX_DMA_STREAM;
+	hdmaRx.Init.Channel = UART_DMA_CHANNEL;
+	hdmaRx.Init.Direction = DMA_PERIPH_TO_MEMORY;
+	hdmaRx.Init.PeriphInc = DMA_PINC_DISABLE;
+	hdmaRx.Init.MemInc = DMA_MINC_ENABLE;
+	hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	hdmaRx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	hdmaRx.Init.Mode = DMA_CIRCULAR;
+	hdmaRx.Init.Priority = DMA_PRIORITY_HIGH;
+	hdmaRx.Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+
+	hdmaTx.Instance = UART_TX_DMA_STREAM;
+	hdmaTx.Init = hdmaRx.Init;
+	hdmaTx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+	hdmaTx.Init.Mode = DMA_NORMAL;
+	hdmaTx.Init.Priority = DMA_PRIORITY_MEDIUM;
+
+	if (HAL_DMA_Init(&hdmaRx) != HAL_OK || HAL_DMA_Init(&hdmaTx) != HAL_OK) {
+		return false;
+	}
+
+	// HAL_DMA_Init() clears the callbacks
+	hdmaRx.XferHalfCpltCallback = uartRxDmaEvent;
+	hdmaRx.XferCpltCallback = uartRxDmaEvent;
+	hdmaRx.XferErrorCallback = uartRxDmaError;
+	hdmaTx.XferCpltCallback = uartTxDmaDone;
+
+	// 8N1, 8x oversampling for rates up to PCLK2 / 8. Idle line closes a burst early.
+	UART_INSTANCE->CR1 = 0;
+	UART_INSTANCE->BRR = uartBrr(baud);
+	UART_INSTANCE->CR2 = 0;
+	UART_INSTANCE->CR3 = USART_CR3_DMAR | USART_CR3_DMAT | USART_CR3_EIE;
+	UART_INSTANCE->CR1 = USART_CR1_OVER8 | USART_CR1_TE | USART_CR1_RE | USART_CR1_IDLEIE | USART_CR1_UE;
+
+	rxTail = 0;
+	txInFlightLen = 0;
+	if (HAL_DMA_Start_IT(&hdmaRx, (uint32_t)&UART_INSTANCE->DR, (uint32_t)rxDma, SHELL_UART_RX_DMA_LEN) != HAL_OK) {
+		return false;
+	}
+
+	HAL_NVIC_SetPriority(UART_RX_DMA_IRQn, SHELL_UART_IRQ_PRIORITY, 0);
+	HAL_NVIC_SetPriority(UART_TX_DMA_IRQn, SHELL_UART_IRQ_PRIORITY, 0);
+	HAL_NVIC_SetPriority(UART_IRQn, SHELL_UART_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(UART_RX_DMA_IRQn);
+	HAL_NVIC_EnableIRQ(UART_TX_DMA_IRQn);
+	HAL_NVIC_EnableIRQ(UART_IRQn);
+	return true;
+}
+
+/**
+  * @brief  Recomputes the baud rate divider for the current PCLK2
+  * @note	Called by shellClockApply(). A byte on the line during the switch is lost.
+  * @param  NONE
+  * @retval NONE
+  */
+void shellUartClockChanged(void) {
+	if (baudRate != 0) {
+		UART_INSTANCE->BRR = uartBrr(baudRate);
+	}
+}
+
+/**
+  * @brief  Idle line and receive errors. Reading SR then DR clears them.
+  * @param  NONE
+  * @retval NONE
+  */
+void USART1_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+	uint32_t sr = UART_INSTANCE->SR;
+
+	if (sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_NE | USART_SR_FE)) {
+		(void)UART_INSTANCE->DR;
+	}
+	if (sr & USART_SR_IDLE) {
+		uartDeliver();
+	}
+	SHELL_ISR_RECORD(isrId_usart1, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  Receive DMA: half and full transfer
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream2_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&hdmaRx);
+	SHELL_ISR_RECORD(isrId_uartRxDma, start, SHELL_ISR_NO_LATENCY);
+}
+
+/**
+  * @brief  Transmit DMA: transfer complete
+  * @param  NONE
+  * @retval NONE
+  */
+void DMA2_Stream7_IRQHandler(void) {
+	uint32_t start = shellPerfCycles();
+
+	HAL_DMA_IRQHandler(&hdmaTx);
+	SHELL_ISR_RECORD(isrId_uartTxDma, start, SHELL_ISR_NO_LATENCY);
+}
+
+#endif // SHELL_UART_ENABLED
+
+/*** end of file ***/
@@ -0,0 +1,71 @@
+/** @file CLI_SHELL_UART.h
+ *
+ * @brief USART transport for the CLI Shell: circular DMA receive, DMA transmit
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) Transmit queue sized by the shell sizing profile
+ *
+ * Usage Notes:
+ *  - Only built with SHELL_UART_ENABLED=1. Boards without USB can run a shell over it alone.
+ *  - USART1 on PB6 (TX) / PB7 (RX), AF7, 8N1, 8x oversampling. Receive on DMA2 Stream2,
+ *    transmit on DMA2 Stream7 (both channel 4). The interrupt handlers are in CLI_SHELL_UART.c,
+ *    leave USART1 and these streams unassigned in CubeMX.
+ *  - Call shellUartInit(baud) once, then "shellInit(&ctx, &shellUartTransport, 0)". There is one
+ *    port, the port number is ignored.
+ *  - Receive runs without the CPU per byte: the DMA fills a circular buffer and rxShellInput() gets
+ *    whatever arrived at half transfer, transfer complete and line idle.
+ *    SHELL_UART_RX_DMA_LEN must be able to hold what arrives within one interrupt latency.
+ *  - Output is copied to a transmit queue. transportFlush() sends its contiguous part as one DMA
+ *    transfer, the transfer complete interrupt chains the rest.
+ *  - The baud rate divider comes from PCLK2. shellClockApply() (CLI_SHELL_CLOCK.h) recomputes it.
+ *  - There is no stream queue, "stream" and "tput d0" fail on this transport.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_UART_H_
+#define CLI_SHELL_UART_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "CLI_SHELL_CONFIG.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#ifndef SHELL_UART_ENABLED
+#define SHELL_UART_ENABLED				0
+#endif
+
+#define SHELL_UART_BAUD					3000000		/*!< Default rate, PCLK2 / 32 at 96 MHz		*/
+#define SHELL_UART_RX_DMA_LEN			256			/*!< Circular receive buffer			*/
+#ifndef SHELL_UART_TX_LEN
+#define SHELL_UART_TX_LEN				SHELL_TX_QUEUE_LEN	/*!< Transmit queue (power of two)		*/
+#endif
+#define SHELL_UART_IRQ_PRIORITY			0			/*!< Same as OTG_FS, rxShellInput() callers never nest	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellTransportTypeDef shellTransport_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+#if SHELL_UART_ENABLED
+extern const shellTransport_t shellUartTransport;
+
+bool shellUartInit(uint32_t baud);
+void shellUartClockChanged(void);
+#endif
+
+#endif // CLI_SHELL_UART_H_
+
+/*** end of file ***/
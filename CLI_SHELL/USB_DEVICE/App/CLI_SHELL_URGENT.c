@@ -0,0 +1,219 @@
+/** @file CLI_SHELL_URGENT.c
+ *
+ * @brief Urgent lane of the CLI Shell: safety commands picked out on receive and run first
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_URGENT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+/**
+  * @brief  Orders the line copy ahead of the index update that publishes it (see CLI_SHELL_RING.c)
+  */
+#define URGENT_BARRIER()		__asm volatile ("" ::: "memory")
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool urgentLineEnd(uint8_t byte);
+static bool urgentMatch(const shellUrgent_t* urgent, bool complete);
+static bool urgentQueue(shellUrgent_t* urgent);
+static void urgentRelease(shell_ctx_t* ctx);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Bytes that end a line for the line assembler, Ctrl-C included
+  * @param[IN]  byte Received byte
+  * @retval bool Returns true at the end of a line
+  */
+static bool urgentLineEnd(uint8_t byte) {
+	return ((SHELL_LINE_TERMINATORS & SHELL_TERM_CR) && byte == '\r') ||
+			((SHELL_LINE_TERMINATORS & SHELL_TERM_LF) && byte == '\n') ||
+			byte == SHELL_ABORT_CHAR;
+}
+
+/**
+  * @brief  Checks the held line start against the urgent commands
+  * @note	An optional tag ("#42 ") comes first, then the exact command name, then the end of the
+  * 		line or a space and the arguments.
+  * @param[IN]  urgent Urgent lane of the instance
+  * @param[IN]  complete The line is complete, a part of a name is no longer enough
+  * @retval bool Returns true if the line is (complete) or may still become (not complete) urgent
+  */
+static bool urgentMatch(const shellUrgent_t* urgent, bool complete) {
+	const uint8_t* line = urgent->held;
+	uint8_t len = urgent->heldLen;
+	uint8_t i = 0;
+
+	if (len > 0 && line[0] == SHELL_TAG_CHAR) {
+		i = 1;
+		while (i < len && i <= SHELL_TAG_DIGITS && line[i] >= '0' && line[i] <= '9') {
+			i++;
+		}
+		if (i == len) {
+			return !complete;
+		}
+		if (i == 1 || line[i] != ' ') {
+			return false;
+		}
+		i++;
+	}
+
+	for (const uint16_t* command = shellUrgentTable; *command < shellCommandCount(); command++) {
+		const char* name = shellCommandName(*command);
+		uint8_t nameLen = (uint8_t)strlen(name);
+		uint8_t rest = len - i;
+
+		if (rest <= nameLen) {
+			if (memcmp(&line[i], name, rest) == 0 && (!complete || rest == nameLen)) {
+				return true;
+			}
+		} else if (memcmp(&line[i], name, nameLen) == 0 && line[i + nameLen] == ' ') {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+  * @brief  Moves the held line into the queue of urgent lines
+  * @param[IN]  urgent Urgent lane of the instance
+  * @retval bool Returns false if the queue is full
+  */
+static bool urgentQueue(shellUrgent_t* urgent) {
+	uint8_t head = urgent->head;
+
+	if ((uint8_t)(head - urgent->tail) >= SHELL_URGENT_QUEUE) {
+		return false;
+	}
+
+	memcpy(urgent->lines[head % SHELL_URGENT_QUEUE], urgent->held, urgent->heldLen);
+	urgent->lineLen[head % SHELL_URGENT_QUEUE] = urgent->heldLen;
+	URGENT_BARRIER();
+	urgent->head = head + 1;
+	urgent->heldLen = 0;
+	return true;
+}
+
+/**
+  * @brief  Hands the held line start to the receive ring, it is a normal line after all
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void urgentRelease(shell_ctx_t* ctx) {
+	shellRingWrite(&ctx->rxRing, ctx->urgent.held, ctx->urgent.heldLen);
+	ctx->urgent.heldLen = 0;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Line assembler of the receive interrupt: urgent lines to their queue, the rest to the ring
+  * @note	Called by rxShellInput() for text sessions. Bytes pass to the ring in runs, only the start
+  * 		of each line is looked at. An urgent line and its terminator never reach the ring.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  data Received bytes
+  * @param[IN]  len Number of bytes
+  * @retval NONE
+  */
+void shellUrgentReceive(shell_ctx_t* ctx, const uint8_t* data, uint32_t len) {
+	shellUrgent_t* urgent = &ctx->urgent;
+	uint32_t run = 0;
+
+	for (uint32_t i = 0; i < len; i++) {
+		uint8_t byte = data[i];
+		bool lineEnd = urgentLineEnd(byte);
+
+		if (urgent->passing) {
+			urgent->passing = !lineEnd;
+			continue;
+		}
+
+		if (urgent->heldLen == 0) {
+			if (lineEnd) {
+				// Empty line or the LF of a CRLF, the line assembler skips it
+				continue;
+			}
+			// A line starts, what came before goes to the ring first
+			shellRingWrite(&ctx->rxRing, &data[run], i - run);
+		}
+		run = i + 1;
+
+		if (!lineEnd && urgent->heldLen < SHELL_URGENT_LINE_LEN) {
+			urgent->held[urgent->heldLen++] = byte;
+			if (!urgentMatch(urgent, false)) {
+				urgentRelease(ctx);
+				urgent->passing = true;
+			}
+			continue;
+		}
+
+		if (lineEnd && byte != SHELL_ABORT_CHAR && urgentMatch(urgent, true) && urgentQueue(urgent)) {
+			continue;
+		}
+
+		// A normal line after all (too long, not a whole name, queue full): this byte follows it
+		urgentRelease(ctx);
+		urgent->passing = !lineEnd;
+		run = i;
+	}
+
+	shellRingWrite(&ctx->rxRing, &data[run], len - run);
+}
+
+/**
+  * @brief  Bytes of a line start held back by the receive interrupt
+  * @note	They still go to the ring unless the line turns out urgent, shellRxFree() counts them
+  * 		as taken.
+  * @param[IN]  ctx Shell instance
+  * @retval uint32_t Held bytes
+  */
+uint32_t shellUrgentHeld(shell_ctx_t* ctx) {
+	return ctx->urgent.heldLen;
+}
+
+/**
+  * @brief  Runs the urgent lines received so far
+  * @note	Called by checkShellStatus() ahead of everything else. Each line is copied out of the
+  * 		queue first, the tokenizer works in place.
+  * @param[IN]  ctx Shell instance
+  * @retval bool Returns true if a line was run
+  */
+bool shellUrgentPoll(shell_ctx_t* ctx) {
+	shellUrgent_t* urgent = &ctx->urgent;
+	bool ran = false;
+
+	while (urgent->tail != urgent->head) {
+		uint8_t slot = urgent->tail % SHELL_URGENT_QUEUE;
+		uint8_t line[SHELL_URGENT_LINE_LEN + 1];
+		uint8_t len = urgent->lineLen[slot];
+
+		memcpy(line, urgent->lines[slot], len);
+		URGENT_BARRIER();
+		urgent->tail++;
+
+		shellRunLine(ctx, line, len);
+		ran = true;
+	}
+	return ran;
+}
+
+/*** end of file ***/
@@ -0,0 +1,75 @@
+/** @file CLI_SHELL_URGENT.h
+ *
+ * @brief Urgent lane of the CLI Shell: safety commands picked out on receive and run first
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - The commands of SHELL_URGENT_LIST (CLI_SHELL_COMMANDS.h) have the urgent priority, all others
+ *    the normal one. A text line that is exactly such a command, with or without a tag and
+ *    arguments ("cancel", "#7 cancel"), is taken out of the input by the receive interrupt. It
+ *    never enters the receive ring, so it does not wait behind the lines before it.
+ *  - checkShellStatus() runs urgent lines before any other line, job step or periodic command,
+ *    and between the lines of a pass. The worst case wait is the bridge or job step running when
+ *    the line arrives. Their responses go into the transmit queue right away, behind at most one
+ *    queue of output (1 KB on USB) and ahead of the stream queue.
+ *  - The receive interrupt holds back the start of every line while it could still be an urgent
+ *    one (up to SHELL_URGENT_LINE_LEN bytes), then passes it on. Leading spaces, batches, unique
+ *    prefixes and longer lines take the normal lane. So do urgent lines while
+ *    SHELL_URGENT_QUEUE of them wait already.
+ *  - Binary sessions have no urgent lane, their frames go to the ring as they are.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_URGENT_H_
+#define CLI_SHELL_URGENT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_URGENT_LINE_LEN			32			/*!< Longest urgent line, tag and arguments	*/
+#define SHELL_URGENT_QUEUE				2			/*!< Urgent lines waiting per instance		*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/**
+  * @brief  Urgent lane of one shell instance (shell_ctx_t.urgent)
+  * @note	held, heldLen and passing belong to the receive interrupt. The queue is filled by the
+  * 		interrupt (head) and emptied by checkShellStatus() (tail).
+  */
+typedef struct {
+	uint8_t held[SHELL_URGENT_LINE_LEN];	/*!< Start of the line being received		*/
+	uint8_t heldLen;
+	bool passing;							/*!< The rest of this line goes to the ring	*/
+
+	uint8_t lines[SHELL_URGENT_QUEUE][SHELL_URGENT_LINE_LEN];
+	uint8_t lineLen[SHELL_URGENT_QUEUE];
+	volatile uint8_t head;					/*!< Lines queued (free running)			*/
+	volatile uint8_t tail;					/*!< Lines run (free running)				*/
+} shellUrgent_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+extern const uint16_t shellUrgentTable[];	/*!< Urgent command indices, ends with NUM_OF_COMMANDS	*/
+
+void shellUrgentReceive(shell_ctx_t* ctx, const uint8_t* data, uint32_t len);
+uint32_t shellUrgentHeld(shell_ctx_t* ctx);
+bool shellUrgentPoll(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_URGENT_H_
+
+/*** end of file ***/
@@ -0,0 +1,144 @@
+/** @file CLI_SHELL_USBSTAT.c
+ *
+ * @brief USB link health counters of the CLI Shell, the "usbstat" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) OUT endpoints held back for a full receive ring
+ * - 1.2: 10-15-2026 (Crandell) Suspend line (CLI_SHELL_SUSPEND)
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_USBSTAT.h"
+#include "CLI_SHELL_SUSPEND.h"
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static const char* const linkEventNames[CDC_LINK_EVENTS] = {
+	"reset", "suspend", "resume", "connect", "disconnect"
+};
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static void appendPair(shellStr_t* str, uint32_t count, uint32_t bytes);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Appends "<count>/<bytes>"
+  * @param[IN]  str Line
+  * @param[IN]  count Transfers
+  * @param[IN]  bytes Bytes
+  * @retval NONE
+  */
+static void appendPair(shellStr_t* str, uint32_t count, uint32_t bytes) {
+	shellStrAppendUnsigned(str, count, 0);
+	shellStrAppendChar(str, '/');
+	shellStrAppendUnsigned(str, bytes, 0);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Dumps the USB link counters as text or as a binary snapshot (f1), clears them (r1)
+  * @note	See CLI_SHELL_USBSTAT.h for the snapshot layout.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error UsbstatBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	CDC_LinkStats_t stats;
+	uint8_t format = 0;
+
+	if (shellHasArg(parserInput, argTkn_f)) {
+		format = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_f)).u8;
+	}
+	if (format > 1) {
+		return SHELL_ERR;
+	}
+
+	transportLinkStats(&stats);
+
+	if (format == 1) {
+		uint8_t record[SHELL_USBSTAT_RECORD_LEN];
+		uint32_t tick = HAL_GetTick();
+
+		// Little endian like the core, the struct is uint32_t only
+		memcpy(record, &tick, sizeof(tick));
+		memcpy(&record[sizeof(tick)], &stats, sizeof(stats));
+		outputStreamChannel(ctx, record, sizeof(record));
+	} else {
+		SHELL_STR_DEFINE(str, 96);
+
+		shellStrAppend(&str, "EP\tIN xfers/bytes\tOUT xfers/bytes\r\n");
+		shellStrSend(ctx, &str);
+		for (uint8_t ep = 0; ep < CDC_LINK_EP_COUNT; ep++) {
+			shellStrAppendUnsigned(&str, ep, 0);
+			shellStrAppendChar(&str, '\t');
+			appendPair(&str, stats.inTransfers[ep], stats.inBytes[ep]);
+			shellStrAppend(&str, "\t\t");
+			appendPair(&str, stats.outTransfers[ep], stats.outBytes[ep]);
+			shellStrAppend(&str, "\r\n");
+			shellStrSend(ctx, &str);
+		}
+
+		for (uint8_t ch = 0; ch < CDC_CH_COUNT; ch++) {
+			shellStrAppend(&str, "Port ");
+			shellStrAppendUnsigned(&str, ch, 0);
+			shellStrAppend(&str, ": ");
+			shellStrAppendUnsigned(&str, stats.txBusy[ch], 0);
+			shellStrAppend(&str, " busy, ");
+			shellStrAppendUnsigned(&str, stats.txDropped[ch], 0);
+			shellStrAppend(&str, " TX dropped, ");
+			shellStrAppendUnsigned(&str, stats.rxDropped[ch], 0);
+			shellStrAppend(&str, " RX dropped, ");
+			shellStrAppendUnsigned(&str, stats.rxHeld[ch], 0);
+			shellStrAppend(&str, " RX held\r\n");
+			shellStrSend(ctx, &str);
+		}
+
+		shellStrAppend(&str, "Events:");
+		for (uint8_t e = 0; e < CDC_LINK_EVENTS; e++) {
+			shellStrAppendChar(&str, ' ');
+			shellStrAppend(&str, linkEventNames[e]);
+			shellStrAppendChar(&str, ' ');
+			shellStrAppendUnsigned(&str, stats.events[e], 0);
+		}
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+
+		shellStrAppend(&str, "ISR: ");
+		shellStrAppendUnsigned(&str, stats.isrCount, 0);
+		shellStrAppend(&str, " calls, max ");
+		shellStrAppendUnsigned(&str, stats.isrMaxCycles, 0);
+		shellStrAppend(&str, " cycles (");
+		shellStrAppendUnsigned(&str, (uint32_t)(((uint64_t)stats.isrMaxCycles * 1000000ULL) / SystemCoreClock), 0);
+		shellStrAppend(&str, " us)\r\n");
+		shellStrSend(ctx, &str);
+
+		shellSuspendReport(ctx);
+	}
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 != 0) {
+		transportLinkStatsClear();
+		shellSuspendClear();
+	}
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
@@ -0,0 +1,49 @@
+/** @file CLI_SHELL_USBSTAT.h
+ *
+ * @brief USB link health counters of the CLI Shell, the "usbstat" command
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ * - 1.1: 10-15-2026 (Crandell) OUT endpoints held back for a full receive ring
+ * - 1.2: 10-15-2026 (Crandell) Suspend line (CLI_SHELL_SUSPEND)
+ *
+ * Usage Notes:
+ *  - The counters live in usbd_cdc_if.c (CDC_LinkStats_t), fed by the PCD callbacks of
+ *    usbd_conf.c and OTG_FS_IRQHandler in stm32f4xx_it.c:
+ *    - transfers and bytes per endpoint and direction (a transfer may span several packets)
+ *    - transfers the class refused (TxState busy, TransmitPacket failed) per port
+ *    - bytes dropped by the transmit queue and by the shell receive ring per port
+ *    - times the OUT endpoint of a port was held back (NAK) until its receive ring had room
+ *    - reset, suspend, resume, connect and disconnect events
+ *    - number of OTG_FS interrupts and the longest one in core cycles
+ *    - suspends, STOP entries and the wake time (CLI_SHELL_SUSPEND.h)
+ *  - "usbstat" prints them, "usbstat r1" clears them after the dump.
+ *  - "usbstat f1" sends a binary snapshot instead, meant for polling from a binary session
+ *    (mode m1) where it arrives as the data of one response frame: SHELL_USBSTAT_RECORD_LEN
+ *    bytes, uint32_t little endian each, HAL_GetTick() first, then the CDC_LinkStats_t fields
+ *    in declaration order.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_USBSTAT_H_
+#define CLI_SHELL_USBSTAT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "usbd_cdc_if.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_USBSTAT_RECORD_LEN		(sizeof(uint32_t) + sizeof(CDC_LinkStats_t))	/*!< Binary snapshot	*/
+
+#endif // CLI_SHELL_USBSTAT_H_
+
+/*** end of file ***/
@@ -0,0 +1,273 @@
+/** @file CLI_SHELL_VAR.c
+ *
+ * @brief Shell variables of the CLI Shell: "$name" expressions as argument values, "let"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_VAR.h"
+#include "CLI_SHELL_CONVERT.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define VAR_LITERAL_LEN			34			/*!< "0b" and 32 digits					*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct {
+	char name[SHELL_VAR_NAME_LEN + 1];		/*!< Empty if the entry is free				*/
+	int32_t value;
+} shellVar_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellVar_t vars[SHELL_VAR_COUNT];
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool isNameChar(uint8_t c);
+static shellVar_t* findVar(const char* name, uint8_t len);
+static bool evalTerm(const uint8_t** expr, int32_t* value);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Letters, digits and '_'
+  * @param[IN]  c Character
+  * @retval bool Returns true if c may be part of a name
+  */
+static bool isNameChar(uint8_t c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/**
+  * @brief  Entry of a name
+  * @param[IN]  name Name, not terminated
+  * @param[IN]  len Characters of name
+  * @retval shellVar_t* NULL if there is none
+  */
+static shellVar_t* findVar(const char* name, uint8_t len) {
+	if (len == 0 || len > SHELL_VAR_NAME_LEN) {
+		return NULL;
+	}
+	for (uint8_t i = 0; i < SHELL_VAR_COUNT; i++) {
+		if (strncmp(vars[i].name, name, len) == 0 && vars[i].name[len] == '\0') {
+			return &vars[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+  * @brief  One term: $name or an unsigned literal
+  * @param[IN,OUT]  expr Position in the expression, moved past the term
+  * @param[OUT]  value Value of the term
+  * @retval bool Returns false for an unknown variable or a malformed literal
+  */
+static bool evalTerm(const uint8_t** expr, int32_t* value) {
+	const uint8_t* start = *expr;
+	uint8_t len = 0;
+
+	if (*start == SHELL_VAR_CHAR) {
+		start++;
+		while (isNameChar(start[len]) && len <= SHELL_VAR_NAME_LEN) {
+			len++;
+		}
+
+		shellVar_t* var = findVar((const char*)start, len);
+		if (var == NULL) {
+			return false;
+		}
+		*value = var->value;
+		*expr = start + len;
+		return true;
+	}
+
+	// shellParseUnsigned() takes a whole string, the literal is copied out
+	uint8_t literal[VAR_LITERAL_LEN + 1];
+	uint32_t number;
+
+	while (isNameChar(start[len])) {
+		if (len == VAR_LITERAL_LEN) {
+			return false;
+		}
+		literal[len] = start[len];
+		len++;
+	}
+	literal[len] = '\0';
+
+	if (!shellParseUnsigned(literal, UINT32_MAX, &number)) {
+		return false;
+	}
+	*value = (int32_t)number;
+	*expr = start + len;
+	return true;
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Evaluates an expression of terms and + - * / %, left to right
+  * @note	Arithmetic wraps at 32 bits, division by 0 fails.
+  * @param[IN]  expr Expression, NUL terminated
+  * @param[OUT]  value Result
+  * @retval bool Returns false if the expression is malformed or names an unknown variable
+  */
+bool shellVarEval(const uint8_t* expr, int32_t* value) {
+	int32_t result;
+	int32_t term;
+
+	if (!evalTerm(&expr, &result)) {
+		return false;
+	}
+
+	while (*expr != '\0') {
+		uint8_t op = *expr++;
+
+		if (!evalTerm(&expr, &term)) {
+			return false;
+		}
+
+		switch (op) {
+		case '+':
+			result = (int32_t)((uint32_t)result + (uint32_t)term);
+			break;
+		case '-':
+			result = (int32_t)((uint32_t)result - (uint32_t)term);
+			break;
+		case '*':
+			result = (int32_t)((uint32_t)result * (uint32_t)term);
+			break;
+		case '/':
+		case '%':
+			if (term == 0) {
+				return false;
+			}
+			if (term == -1) {
+				// INT32_MIN / -1 does not fit, wrap like the others
+				result = (op == '/') ? (int32_t)(0U - (uint32_t)result) : 0;
+			} else {
+				result = (op == '/') ? (result / term) : (result % term);
+			}
+			break;
+		default:
+			return false;
+		}
+	}
+
+	*value = result;
+	return true;
+}
+
+/**
+  * @brief  Value of a variable
+  * @param[IN]  name Name, NUL terminated
+  * @param[OUT]  value Value
+  * @retval bool Returns false if there is no such variable
+  */
+bool shellVarGet(const char* name, int32_t* value) {
+	shellVar_t* var = findVar(name, (uint8_t)strnlen(name, SHELL_VAR_NAME_LEN + 1));
+
+	if (var == NULL) {
+		return false;
+	}
+	*value = var->value;
+	return true;
+}
+
+/**
+  * @brief  Sets a variable, creating it if needed
+  * @param[IN]  name Name, NUL terminated
+  * @param[IN]  value Value
+  * @retval bool Returns false for a bad name or a full table
+  */
+bool shellVarSet(const char* name, int32_t value) {
+	uint8_t len = (uint8_t)strnlen(name, SHELL_VAR_NAME_LEN + 1);
+	shellVar_t* var = findVar(name, len);
+
+	if (len == 0 || len > SHELL_VAR_NAME_LEN) {
+		return false;
+	}
+	for (uint8_t i = 0; i < len; i++) {
+		if (!isNameChar((uint8_t)name[i])) {
+			return false;
+		}
+	}
+
+	for (uint8_t i = 0; i < SHELL_VAR_COUNT && var == NULL; i++) {
+		if (vars[i].name[0] == '\0') {
+			var = &vars[i];
+			memcpy(var->name, name, len + 1);
+		}
+	}
+	if (var == NULL) {
+		return false;
+	}
+	var->value = value;
+	return true;
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Sets, deletes or lists variables
+  * @note	See CLI_SHELL_VAR.h for the expressions.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_ERR for a bad name or expression, an unknown variable or a full table
+  */
+shell_error LetBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_RESULT_DEFINE(res, ctx, 32);
+
+	if (!shellHasArg(parserInput, argTkn_n)) {
+		for (uint8_t i = 0; i < SHELL_VAR_COUNT; i++) {
+			if (vars[i].name[0] != '\0') {
+				shellResultSigned(&res, vars[i].name, vars[i].value);
+			}
+		}
+		shellResultEnd(&res);
+		return SHELL_OK;
+	}
+
+	const char* name = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_n)).str;
+
+	if (!shellHasArg(parserInput, argTkn_v)) {
+		shellVar_t* var = findVar(name, (uint8_t)strnlen(name, SHELL_VAR_NAME_LEN + 1));
+
+		if (var == NULL) {
+			return SHELL_ERR;
+		}
+		var->name[0] = '\0';
+		return SHELL_OK;
+	}
+
+	const uint8_t* expr = (const uint8_t*)shellArgValue(parserInput, shellFindArg(parserInput, argTkn_v)).str;
+	int32_t value;
+
+	if (!shellVarEval(expr, &value) || !shellVarSet(name, value)) {
+		return SHELL_ERR;
+	}
+	return SHELL_OK;
+}
+
+/*** end of file ***/
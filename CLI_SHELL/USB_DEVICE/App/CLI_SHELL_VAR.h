@@ -0,0 +1,56 @@
+/** @file CLI_SHELL_VAR.h
+ *
+ * @brief Shell variables of the CLI Shell: "$name" expressions as argument values, "let"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "let n<name> v<expr>" sets a variable, "let n<name>" deletes it, "let" lists them. Names are
+ *    up to SHELL_VAR_NAME_LEN letters, digits or '_', values int32. Up to SHELL_VAR_COUNT
+ *    variables, shared by all instances.
+ *  - A numeric argument (uint8, uint16, uint32, float) whose contents start with '$' is an
+ *    expression: "setLed l$i s1", "mrd a$base+0x14 n$n*4". Terms are $variables and unsigned
+ *    literals (decimal, 0x, 0b), joined by + - * / % and evaluated left to right, without
+ *    precedence or brackets. The result must fit the argument type, negative values do not fit
+ *    the unsigned ones.
+ *  - The expression is evaluated where the literal would be converted (validateArgType()) and the
+ *    value goes straight into the argument: the line is not rewritten or tokenized again, so a
+ *    parameterized command costs a lookup per variable over a literal one.
+ *  - The value of "let v" is an expression as well, with or without a leading '$':
+ *    "let ni v0", "let ni v$i+1".
+ *  - Evaluated when the line is validated: a macro (CLI_SHELL_MACRO.h) records the value, a
+ *    command of "every" (CLI_SHELL_SCHED.h) keeps the value of its first validation.
+ *  - Binary sessions carry their values ready converted, '$' has no meaning there.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_VAR_H_
+#define CLI_SHELL_VAR_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_VAR_CHAR					'$'			/*!< Starts a variable, and an expression	*/
+#define SHELL_VAR_COUNT					16
+#define SHELL_VAR_NAME_LEN				8
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+bool shellVarEval(const uint8_t* expr, int32_t* value);
+bool shellVarGet(const char* name, int32_t* value);
+bool shellVarSet(const char* name, int32_t value);
+
+#endif // CLI_SHELL_VAR_H_
+
+/*** end of file ***/
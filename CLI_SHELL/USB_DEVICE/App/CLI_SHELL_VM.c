@@ -0,0 +1,561 @@
+/** @file CLI_SHELL_VM.c
+ *
+ * @brief Script VM of the CLI Shell: stack bytecode with variables, jumps and command calls, "vm"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_VM.h"
+#include "CLI_SHELL_JOB.h"
+#include "CLI_SHELL_RESULT.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define VM_TLV_HEADER_LEN		2			/*!< token, len								*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Why vmRun() returned
+  */
+typedef enum {
+	vmState_running = 0,					/*!< Step budget used up					*/
+	vmState_waiting,						/*!< WAIT								*/
+	vmState_halted,
+	vmState_faulted
+} vmState_t;
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+/**
+  * @brief  Code and machine state
+  */
+static struct {
+	uint8_t code[SHELL_VM_CODE_LEN];
+	uint16_t len;							/*!< Bytes of code stored					*/
+
+	int32_t stack[SHELL_VM_STACK_DEPTH];
+	uint8_t sp;								/*!< Values on the stack					*/
+	int32_t var[SHELL_VM_VARS];
+	uint16_t pc;
+	uint16_t faultPc;						/*!< Opcode of the faulting instruction		*/
+	shellVmFault_t fault;
+	vmState_t state;
+	bool mute;
+	uint32_t steps;
+	uint32_t waitMs;
+	uint32_t waitStart;
+} vm;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static bool vmFault(shellVmFault_t fault);
+static bool vmPush(int32_t value);
+static bool vmPop(int32_t* value);
+static bool vmOperand(uint16_t len);
+static uint16_t vmRead16(uint16_t pos);
+static bool vmCall(shell_ctx_t* ctx);
+static void vmPrint(shell_ctx_t* ctx, int32_t value);
+static vmState_t vmRun(shell_ctx_t* ctx, uint32_t budget);
+static shell_error vmJob(shellJob_t* job);
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Stops the script with a fault
+  * @param[IN]  fault What went wrong
+  * @retval bool Always false, to return it
+  */
+static bool vmFault(shellVmFault_t fault) {
+	vm.fault = fault;
+	return false;
+}
+
+/**
+  * @brief  Pushes a value
+  * @param[IN]  value Value
+  * @retval bool Returns false (fault set) if the stack is full
+  */
+static bool vmPush(int32_t value) {
+	if (vm.sp == SHELL_VM_STACK_DEPTH) {
+		return vmFault(vmFault_stackOver);
+	}
+	vm.stack[vm.sp++] = value;
+	return true;
+}
+
+/**
+  * @brief  Pops a value
+  * @param[OUT]  value Value
+  * @retval bool Returns false (fault set) if the stack is empty
+  */
+static bool vmPop(int32_t* value) {
+	if (vm.sp == 0) {
+		return vmFault(vmFault_stackUnder);
+	}
+	*value = vm.stack[--vm.sp];
+	return true;
+}
+
+/**
+  * @brief  Checks that len operand bytes follow the opcode
+  * @param[IN]  len Operand bytes
+  * @retval bool Returns false (fault set) if they run past the code
+  */
+static bool vmOperand(uint16_t len) {
+	if ((uint32_t)vm.pc + 1 + len > vm.len) {
+		return vmFault(vmFault_code);
+	}
+	return true;
+}
+
+/**
+  * @brief  Little-endian 16-bit operand
+  * @param[IN]  pos Code offset
+  * @retval uint16_t Value
+  */
+static uint16_t vmRead16(uint16_t pos) {
+	return (uint16_t)vm.code[pos] | ((uint16_t)vm.code[pos + 1] << 8);
+}
+
+/**
+  * @brief  CALL: builds the request of the binary protocol and dispatches it like a batch entry
+  * @note	Stack arguments are popped last argument first, as the script pushed them in order.
+  * @param[IN]  ctx Shell instance of the script
+  * @retval bool Returns false (fault set) for malformed arguments or a stack underflow
+  */
+static bool vmCall(shell_ctx_t* ctx) {
+	uint8_t line[SHELL_BUFFER_LEN + 1];
+	uint16_t tlvPos[MAX_ARGUMENTS];
+	int32_t popped[MAX_ARGUMENTS];
+	shellParserOutput_t parserOutput;
+
+	if (!vmOperand(3)) {
+		return false;
+	}
+
+	uint16_t commandIndex = vmRead16(vm.pc + 1);
+	uint8_t numArgs = vm.code[vm.pc + 3];
+	uint16_t pos = vm.pc + 4;
+
+	if (numArgs > MAX_ARGUMENTS) {
+		return vmFault(vmFault_call);
+	}
+
+	// Where the arguments are, and how far the instruction goes
+	for (uint8_t i = 0; i < numArgs; i++) {
+		if ((uint32_t)pos + VM_TLV_HEADER_LEN > vm.len) {
+			return vmFault(vmFault_code);
+		}
+		uint8_t len = vm.code[pos + 1];
+		tlvPos[i] = pos;
+		pos += VM_TLV_HEADER_LEN + ((len & SHELL_VM_ARG_FROM_STACK) ? 0 : len);
+		if (pos > vm.len) {
+			return vmFault(vmFault_code);
+		}
+	}
+	for (int8_t i = (int8_t)numArgs - 1; i >= 0; i--) {
+		uint8_t len = vm.code[tlvPos[i] + 1];
+
+		if ((len & SHELL_VM_ARG_FROM_STACK) && !vmPop(&popped[i])) {
+			return false;
+		}
+	}
+
+	memset(&parserOutput, 0, sizeof(parserOutput));
+	memset(parserOutput.argSlot, SHELL_ARG_NONE, sizeof(parserOutput.argSlot));
+	parserOutput.line = line;
+	parserOutput.rawValues = true;
+
+	// Command name first, so bridges can still use shellCmdName()
+	const char* name = shellCommandName(commandIndex);
+	uint32_t lineLen = 0;
+	if (name != NULL) {
+		parserOutput.cmdLen = strlen(name);
+		memcpy(line, name, parserOutput.cmdLen + 1);
+		lineLen = parserOutput.cmdLen + 1;
+	}
+
+	for (uint8_t i = 0; i < numArgs; i++) {
+		uint8_t token = vm.code[tlvPos[i]];
+		uint8_t len = vm.code[tlvPos[i] + 1];
+		const uint8_t* value = &vm.code[tlvPos[i] + VM_TLV_HEADER_LEN];
+		uint8_t stackValue[4];
+
+		if (len & SHELL_VM_ARG_FROM_STACK) {
+			len &= (uint8_t)~SHELL_VM_ARG_FROM_STACK;
+			if (len != 1 && len != 2 && len != 4) {
+				return vmFault(vmFault_call);
+			}
+			for (uint8_t b = 0; b < 4; b++) {
+				stackValue[b] = (uint8_t)((uint32_t)popped[i] >> (8 * b));
+			}
+			value = stackValue;
+		}
+		if (token >= argTkn_err || (lineLen + len + 1) > sizeof(line)) {
+			return vmFault(vmFault_call);
+		}
+
+		shellArgument_t* arg = &parserOutput.cmdArgs[parserOutput.numArgs];
+		arg->argToken = (argToken_t)token;
+		arg->argType = arg_none;
+		arg->argOffset = lineLen;
+		arg->argLen = len;
+		shellIndexArg(&parserOutput, parserOutput.numArgs);
+		parserOutput.numArgs++;
+
+		memcpy(&line[lineLen], value, len);
+		line[lineLen + len] = '\0';
+		lineLen += len + 1;
+	}
+
+	// Like an entry of a batch: output goes out, the response code is kept
+	bool wasBatch = ctx->batchActive;
+	responseCode_t savedStatus = ctx->batchStatus;
+	bool wasMuted = ctx->outputMuted;
+
+	ctx->batchActive = true;
+	ctx->batchStatus = RESPONSE_OK;
+	ctx->outputMuted = wasMuted || vm.mute;
+	shellDispatch(ctx, &parserOutput, commandIndex);
+	responseCode_t code = ctx->batchStatus;
+	ctx->batchActive = wasBatch;
+	ctx->batchStatus = savedStatus;
+	ctx->outputMuted = wasMuted;
+
+	vm.pc = pos;
+	return vmPush((int32_t)code);
+}
+
+/**
+  * @brief  PRINT: a signed decimal line
+  * @param[IN]  ctx Shell instance of the script
+  * @param[IN]  value Value
+  * @retval NONE
+  */
+static void vmPrint(shell_ctx_t* ctx, int32_t value) {
+	SHELL_STR_DEFINE(str, 16);
+
+	if (value < 0) {
+		shellStrAppendChar(&str, '-');
+	}
+	shellStrAppendUnsigned(&str, (value < 0) ? (0U - (uint32_t)value) : (uint32_t)value, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/**
+  * @brief  Runs up to budget instructions
+  * @param[IN]  ctx Shell instance of the script
+  * @param[IN]  budget Instructions
+  * @retval vmState_t Why it stopped
+  */
+static vmState_t vmRun(shell_ctx_t* ctx, uint32_t budget) {
+	int32_t a;
+	int32_t b;
+	bool ok;
+
+	while (budget-- > 0) {
+		if (vm.pc >= vm.len) {
+			vm.faultPc = vm.pc;
+			vm.fault = vmFault_code;
+			return vmState_faulted;
+		}
+
+		uint8_t op = vm.code[vm.pc];
+		vm.faultPc = vm.pc;
+		vm.steps++;
+		ok = true;
+
+		switch (op) {
+		case vmOp_halt:
+			return vmState_halted;
+
+		case vmOp_push8:
+			ok = vmOperand(1) && vmPush((int8_t)vm.code[vm.pc + 1]);
+			vm.pc += 2;
+			break;
+
+		case vmOp_push32:
+			if ((ok = vmOperand(4))) {
+				uint32_t value = (uint32_t)vmRead16(vm.pc + 1) | ((uint32_t)vmRead16(vm.pc + 3) << 16);
+				ok = vmPush((int32_t)value);
+			}
+			vm.pc += 5;
+			break;
+
+		case vmOp_load:
+		case vmOp_store:
+			if ((ok = vmOperand(1))) {
+				uint8_t v = vm.code[vm.pc + 1];
+
+				if (v >= SHELL_VM_VARS) {
+					ok = vmFault(vmFault_var);
+				} else if (op == vmOp_load) {
+					ok = vmPush(vm.var[v]);
+				} else {
+					ok = vmPop(&vm.var[v]);
+				}
+			}
+			vm.pc += 2;
+			break;
+
+		case vmOp_add: case vmOp_sub: case vmOp_mul: case vmOp_div: case vmOp_mod:
+		case vmOp_and: case vmOp_or: case vmOp_xor: case vmOp_shl: case vmOp_shr:
+		case vmOp_eq: case vmOp_lt: case vmOp_gt:
+			if ((ok = vmPop(&b) && vmPop(&a))) {
+				int32_t r = 0;
+
+				switch (op) {
+				case vmOp_add:	r = (int32_t)((uint32_t)a + (uint32_t)b);	break;
+				case vmOp_sub:	r = (int32_t)((uint32_t)a - (uint32_t)b);	break;
+				case vmOp_mul:	r = (int32_t)((uint32_t)a * (uint32_t)b);	break;
+				case vmOp_div:
+				case vmOp_mod:
+					if (b == 0) {
+						ok = vmFault(vmFault_divZero);
+					} else if (b == -1) {
+						// INT32_MIN / -1 does not fit, wrap like the other operations
+						r = (op == vmOp_div) ? (int32_t)(0U - (uint32_t)a) : 0;
+					} else {
+						r = (op == vmOp_div) ? (a / b) : (a % b);
+					}
+					break;
+				case vmOp_and:	r = a & b;									break;
+				case vmOp_or:	r = a | b;									break;
+				case vmOp_xor:	r = a ^ b;									break;
+				case vmOp_shl:	r = (int32_t)((uint32_t)a << (b & 31));		break;
+				case vmOp_shr:	r = (int32_t)((uint32_t)a >> (b & 31));		break;
+				case vmOp_eq:	r = (a == b);								break;
+				case vmOp_lt:	r = (a < b);								break;
+				default:		r = (a > b);								break;
+				}
+				ok = ok && vmPush(r);
+			}
+			vm.pc += 1;
+			break;
+
+		case vmOp_not:
+			ok = vmPop(&a) && vmPush(a == 0);
+			vm.pc += 1;
+			break;
+
+		case vmOp_dup:
+			ok = vmPop(&a) && vmPush(a) && vmPush(a);
+			vm.pc += 1;
+			break;
+
+		case vmOp_drop:
+			ok = vmPop(&a);
+			vm.pc += 1;
+			break;
+
+		case vmOp_swap:
+			ok = vmPop(&b) && vmPop(&a) && vmPush(b) && vmPush(a);
+			vm.pc += 1;
+			break;
+
+		case vmOp_jmp:
+		case vmOp_jz:
+		case vmOp_jnz:
+			if ((ok = vmOperand(2))) {
+				uint16_t target = vmRead16(vm.pc + 1);
+				bool jump = true;
+
+				if (op != vmOp_jmp) {
+					// An underflow leaves pc on the jump, the VM stops there
+					if (!(ok = vmPop(&a))) {
+						break;
+					}
+					jump = (op == vmOp_jz) ? (a == 0) : (a != 0);
+				}
+				vm.pc = jump ? target : (uint16_t)(vm.pc + 3);
+			}
+			break;
+
+		case vmOp_djnz:
+			if ((ok = vmOperand(3))) {
+				uint8_t v = vm.code[vm.pc + 1];
+
+				if (v >= SHELL_VM_VARS) {
+					ok = vmFault(vmFault_var);
+				} else {
+					vm.var[v]--;
+					vm.pc = (vm.var[v] != 0) ? vmRead16(vm.pc + 2) : (uint16_t)(vm.pc + 4);
+				}
+			}
+			break;
+
+		case vmOp_call:
+			ok = vmCall(ctx);
+			break;
+
+		case vmOp_print:
+			if ((ok = vmPop(&a))) {
+				vmPrint(ctx, a);
+			}
+			vm.pc += 1;
+			break;
+
+		case vmOp_ticks:
+			ok = vmPush((int32_t)HAL_GetTick());
+			vm.pc += 1;
+			break;
+
+		case vmOp_wait:
+			vm.pc += 1;
+			if (vmPop(&a)) {
+				vm.waitMs = (uint32_t)a;
+				vm.waitStart = HAL_GetTick();
+				return vmState_waiting;
+			}
+			ok = false;
+			break;
+
+		case vmOp_mute:
+			if ((ok = vmPop(&a))) {
+				vm.mute = (a != 0);
+			}
+			vm.pc += 1;
+			break;
+
+		default:
+			ok = vmFault(vmFault_opcode);
+			break;
+		}
+
+		if (!ok) {
+			return vmState_faulted;
+		}
+	}
+
+	return vmState_running;
+}
+
+/**
+  * @brief  Poll function of "vm r1"
+  * @param[IN]  job The script
+  * @retval shell_error SHELL_BUSY while it runs, SHELL_ERR on a fault
+  */
+static shell_error vmJob(shellJob_t* job) {
+	if (job->cancel) {
+		vm.state = vmState_halted;
+		return SHELL_OK;
+	}
+
+	SHELL_JOB_BEGIN(job);
+
+	while (true) {
+		vm.state = vmRun(job->ctx, SHELL_VM_STEPS_PER_POLL);
+		if (vm.state == vmState_running) {
+			SHELL_JOB_YIELD(job);
+		} else if (vm.state == vmState_waiting) {
+			SHELL_JOB_WAIT_UNTIL(job, (HAL_GetTick() - vm.waitStart) >= vm.waitMs);
+		} else {
+			break;
+		}
+	}
+
+	if (vm.state == vmState_faulted) {
+		SHELL_STR_DEFINE(str, 40);
+
+		shellStrAppend(&str, "VM fault ");
+		shellStrAppendUnsigned(&str, vm.fault, 0);
+		shellStrAppend(&str, " at ");
+		shellStrAppendUnsigned(&str, vm.faultPc, 0);
+		shellStrAppend(&str, ": ");
+		shellStrSend(job->ctx, &str);
+		job->state = 0;
+		return SHELL_ERR;
+	}
+
+	SHELL_RESULT_DEFINE(res, job->ctx, 32);
+	shellResultSigned(&res, "result", (vm.sp > 0) ? vm.stack[vm.sp - 1] : 0);
+	shellResultUnsigned(&res, "steps", vm.steps);
+	shellResultUnsigned(&res, "ms", HAL_GetTick() - job->startTick);
+	shellResultEnd(&res);
+
+	SHELL_JOB_END(job);
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Loads, clears, shows or runs the script
+  * @note	See CLI_SHELL_VM.h for the arguments and the bytecode.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error SHELL_BUSY while the script runs, SHELL_ERR for a piece past the code or
+  * 		a running job
+  */
+shell_error VmBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	bool running = shellJobRunning() && (vm.state == vmState_running || vm.state == vmState_waiting);
+
+	// The code of a running script stays as it is
+	if (running && (shellHasArg(parserInput, argTkn_c) || shellHasArg(parserInput, argTkn_l))) {
+		return SHELL_ERR;
+	}
+
+	if (shellHasArg(parserInput, argTkn_c) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_c)).u8 == 1) {
+		vm.len = 0;
+	}
+
+	if (shellHasArg(parserInput, argTkn_l)) {
+		uint8_t piece[SHELL_ARRAY_MAX];
+		uint8_t len = shellArgArray(parserInput, shellFindArg(parserInput, argTkn_l), piece, SHELL_ARRAY_MAX);
+		uint16_t offset = 0;
+
+		if (shellHasArg(parserInput, argTkn_o)) {
+			offset = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_o)).u16;
+		}
+		if ((uint32_t)offset + len > SHELL_VM_CODE_LEN || offset > vm.len) {
+			return SHELL_ERR;
+		}
+		memcpy(&vm.code[offset], piece, len);
+		if (offset + len > vm.len) {
+			vm.len = offset + len;
+		}
+	}
+
+	if (shellHasArg(parserInput, argTkn_r) && shellArgValue(parserInput, shellFindArg(parserInput, argTkn_r)).u8 == 1) {
+		if (vm.len == 0 || shellJobRunning() || shellJobStart(ctx, vmJob) == NULL) {
+			return SHELL_ERR;
+		}
+
+		memset(vm.stack, 0, sizeof(vm.stack));
+		memset(vm.var, 0, sizeof(vm.var));
+		vm.sp = 0;
+		vm.pc = 0;
+		vm.fault = vmFault_none;
+		vm.state = vmState_running;
+		vm.mute = false;
+		vm.steps = 0;
+		return SHELL_BUSY;
+	}
+
+	SHELL_RESULT_DEFINE(res, ctx, 32);
+	shellResultUnsigned(&res, "code", vm.len);
+	shellResultUnsigned(&res, "max", SHELL_VM_CODE_LEN);
+	shellResultEnd(&res);
+	return SHELL_OK;
+}
+
+/*** end of file ***/
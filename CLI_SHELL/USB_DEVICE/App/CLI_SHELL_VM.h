@@ -0,0 +1,127 @@
+/** @file CLI_SHELL_VM.h
+ *
+ * @brief Script VM of the CLI Shell: stack bytecode with variables, jumps and command calls, "vm"
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-15-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - A script is bytecode compiled on the host. "vm o<offset> l<bytes>" stores a piece of it in
+ *    RAM (any number of pieces, up to SHELL_VM_CODE_LEN bytes), "vm r1" runs it from offset 0,
+ *    "vm" shows the code length. The pieces are u8 arrays, raw bytes of TLV l in a binary
+ *    session or "l1,10,4,0" as text. "vm c1" clears the code.
+ *  - The machine: a stack of SHELL_VM_STACK_DEPTH int32 values, SHELL_VM_VARS int32 variables
+ *    (all 0 at the start), pc. Operands follow the opcode, little-endian. Jump targets are code
+ *    offsets. Binary operations pop b, then a, and push a op b.
+ *      0x00 HALT                   end, the top of the stack (or 0) is the result
+ *      0x01 PUSH8 i8               0x02 PUSH32 i32
+ *      0x03 LOAD v                 0x04 STORE v (pops)
+ *      0x05 ADD  0x06 SUB  0x07 MUL  0x08 DIV  0x09 MOD (signed, b = 0 is an error)
+ *      0x0A AND  0x0B OR   0x0C XOR  0x0D SHL  0x0E SHR (logical)
+ *      0x10 EQ   0x11 LT   0x12 GT (1 or 0)   0x13 NOT (1 if 0, else 0)
+ *      0x14 DUP  0x15 DROP  0x16 SWAP
+ *      0x18 JMP a16   0x19 JZ a16 (pops)   0x1A JNZ a16 (pops)
+ *      0x1B DJNZ v a16             v -= 1, jump while v != 0: a counted loop in one instruction
+ *      0x20 CALL c16 n {token len value}*n
+ *                                  runs command c (Command Table index, "help" order) with n
+ *                                  arguments in the TLV form of the binary protocol
+ *                                  (CLI_SHELL_BINARY.h). len 0x81, 0x82 or 0x84 takes a 1, 2 or
+ *                                  4 byte value from the stack instead (pops, the last argument
+ *                                  first). Pushes the responseCode_t, 0 for OK.
+ *      0x21 PRINT                  pops and sends "<value>\r\n"
+ *      0x22 TICKS                  pushes the ms tick (HAL_GetTick())
+ *      0x23 WAIT                   pops ms and waits, the main loop runs meanwhile
+ *      0x24 MUTE                   pops, not 0: the output of later CALLs is dropped
+ *    e.g. 10000 times "setLed l1 s<i & 1>":
+ *      PUSH32 10000, STORE 0, loop: LOAD 0, PUSH8 1, AND, CALL setLed 2 {l 1 1} {s 0x81},
+ *      DROP, DJNZ 0 loop, HALT
+ *  - The script runs as a job (CLI_SHELL_JOB.h): SHELL_VM_STEPS_PER_POLL instructions per main
+ *    loop pass, then the USB and the other instances get their turn. "cancel" stops it.
+ *  - Called commands run like the commands of a batch: their output goes out, their responses
+ *    are held back and only the code is pushed. Commands that run as jobs themselves cannot be
+ *    called (the script is the job), they push RESPONSE_FNC_ERR.
+ *  - The response is the result fields "result", "steps" and "ms". A fault (bad opcode, stack
+ *    over- or underflow, division by 0, pc or variable out of range) answers SHELL_ERR after
+ *    "VM fault <code> at <pc>".
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_VM_H_
+#define CLI_SHELL_VM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_VM_CODE_LEN				1024		/*!< Bytes of bytecode					*/
+#define SHELL_VM_STACK_DEPTH			16
+#define SHELL_VM_VARS					16
+#define SHELL_VM_STEPS_PER_POLL			2000		/*!< Instructions between main loop passes	*/
+
+#define SHELL_VM_ARG_FROM_STACK			0x80		/*!< CALL argument len: the value is popped	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  Opcodes
+  */
+typedef enum {
+	vmOp_halt = 0x00,
+	vmOp_push8 = 0x01,
+	vmOp_push32 = 0x02,
+	vmOp_load = 0x03,
+	vmOp_store = 0x04,
+	vmOp_add = 0x05,
+	vmOp_sub = 0x06,
+	vmOp_mul = 0x07,
+	vmOp_div = 0x08,
+	vmOp_mod = 0x09,
+	vmOp_and = 0x0A,
+	vmOp_or = 0x0B,
+	vmOp_xor = 0x0C,
+	vmOp_shl = 0x0D,
+	vmOp_shr = 0x0E,
+	vmOp_eq = 0x10,
+	vmOp_lt = 0x11,
+	vmOp_gt = 0x12,
+	vmOp_not = 0x13,
+	vmOp_dup = 0x14,
+	vmOp_drop = 0x15,
+	vmOp_swap = 0x16,
+	vmOp_jmp = 0x18,
+	vmOp_jz = 0x19,
+	vmOp_jnz = 0x1A,
+	vmOp_djnz = 0x1B,
+	vmOp_call = 0x20,
+	vmOp_print = 0x21,
+	vmOp_ticks = 0x22,
+	vmOp_wait = 0x23,
+	vmOp_mute = 0x24
+} shellVmOp_t;
+
+/**
+  * @brief  Faults, in "VM fault <code> at <pc>"
+  */
+typedef enum {
+	vmFault_none = 0,
+	vmFault_opcode,							/*!< Unknown opcode							*/
+	vmFault_code,							/*!< pc, an operand or a jump past the code	*/
+	vmFault_stackOver,
+	vmFault_stackUnder,
+	vmFault_var,							/*!< Variable out of range					*/
+	vmFault_divZero,
+	vmFault_call							/*!< Malformed CALL arguments				*/
+} shellVmFault_t;
+
+#endif // CLI_SHELL_VM_H_
+
+/*** end of file ***/
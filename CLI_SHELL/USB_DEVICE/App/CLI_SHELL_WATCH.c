@@ -0,0 +1,494 @@
+/** @file CLI_SHELL_WATCH.c
+ *
+ * @brief Watch list of the CLI Shell: sampled values, only the changes are sent ("watch")
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "CLI_SHELL.h"
+#include "CLI_SHELL_BINARY.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_MEM.h"
+#include "CLI_SHELL_POOL.h"
+#include "CLI_SHELL_WATCH.h"
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define WATCH_NO_GETTER			0xFF		/*!< Entry is a memory location				*/
+
+/**
+  * @brief  Longest text line: "W <tick>*:" and one " <id>=0x<value>" per entry
+  */
+#define WATCH_LINE_LEN			(14 + SHELL_WATCH_ENTRIES * 14 + 2)
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+/**
+  * @brief  A named value kept by a module
+  */
+typedef struct {
+	const char* name;
+	uint32_t (*read)(void);
+} shellWatchGetter_t;
+
+/**
+  * @brief  One watched value
+  */
+typedef struct {
+	bool used;
+	uint8_t getter;							/*!< watchGetters index, WATCH_NO_GETTER		*/
+	uint8_t width;							/*!< Memory: bytes per access				*/
+	uint32_t address;						/*!< Memory: location						*/
+	uint32_t last;							/*!< Value last reported					*/
+} shellWatchEntry_t;
+
+/**
+  * @brief  The watch list and its sampling
+  */
+typedef struct {
+	shellWatchEntry_t entries[SHELL_WATCH_ENTRIES];
+	shell_ctx_t* ctx;						/*!< Instance sampling, NULL when stopped	*/
+	bool binary;							/*!< Delta frames instead of text lines		*/
+	bool full;								/*!< Next sample reports every entry		*/
+	bool skipped;							/*!< A sample found no room since the last	*/
+	uint16_t period;						/*!< ms										*/
+	uint32_t nextTick;						/*!< HAL_GetTick() of the next sample		*/
+	uint8_t frameSeq;
+	uint32_t samples;						/*!< Since the start						*/
+	uint32_t reports;						/*!< Samples with something to send			*/
+	uint32_t changes;						/*!< Values sent							*/
+	uint32_t bytes;							/*!< Bytes sent								*/
+	uint32_t skips;							/*!< Samples lost for lack of room			*/
+} shellWatch_t;
+
+/********************************************************************************
+ * PRIVATE PROTOTYPES
+ *******************************************************************************/
+static uint32_t watchPool(void);
+static uint32_t watchPasses(void);
+static uint32_t watchSleeps(void);
+static uint32_t watchUsbFrames(void);
+static uint32_t watchUsbNaks(void);
+static uint32_t watchRead(const shellWatchEntry_t* entry);
+static int8_t watchAdd(uint8_t getter, uint32_t address, uint8_t width);
+static bool watchSendText(uint32_t changed, uint32_t* values);
+static bool watchSendFrame(uint32_t changed, uint32_t* values);
+static void watchSample(void);
+static void watchList(shell_ctx_t* ctx);
+
+/********************************************************************************
+ * MODULAR VARIABLES
+ *******************************************************************************/
+static shellWatch_t watch;
+
+static const shellWatchGetter_t watchGetters[] = {
+	{ "pool",		watchPool },
+	{ "passes",		watchPasses },
+	{ "sleeps",		watchSleeps },
+	{ "usbFrames",	watchUsbFrames },
+	{ "usbNaks",	watchUsbNaks },
+};
+
+#define WATCH_GETTERS			(sizeof(watchGetters) / sizeof(watchGetters[0]))
+
+_Static_assert(WATCH_GETTERS < WATCH_NO_GETTER, "Getter index must fit below WATCH_NO_GETTER");
+
+/********************************************************************************
+ * PRIVATE FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Getters of watchGetters
+  * @param  NONE
+  * @retval uint32_t Current value
+  */
+static uint32_t watchPool(void) {
+	return shellPoolInUse();
+}
+
+static uint32_t watchPasses(void) {
+	return shellEventStats()->passes;
+}
+
+static uint32_t watchSleeps(void) {
+	return shellEventStats()->sleeps;
+}
+
+static uint32_t watchUsbFrames(void) {
+	return CDC_FrameStats_FS()->frames;
+}
+
+static uint32_t watchUsbNaks(void) {
+	return CDC_FrameStats_FS()->nakFrames;
+}
+
+/**
+  * @brief  Current value of an entry
+  * @note	Memory is read with one access of the entry's width, registers exactly once.
+  * @param[IN]  entry Entry in use
+  * @retval uint32_t Value
+  */
+static uint32_t watchRead(const shellWatchEntry_t* entry) {
+	if (entry->getter != WATCH_NO_GETTER) {
+		return watchGetters[entry->getter].read();
+	}
+	if (entry->width == 1) {
+		return *(volatile uint8_t*)entry->address;
+	}
+	if (entry->width == 2) {
+		return *(volatile uint16_t*)entry->address;
+	}
+	return *(volatile uint32_t*)entry->address;
+}
+
+/**
+  * @brief  Adds an entry in the first free slot
+  * @param[IN]  getter watchGetters index, WATCH_NO_GETTER for memory
+  * @param[IN]  address Memory: location
+  * @param[IN]  width Memory: bytes per access
+  * @retval int8_t Entry id, -1 if the list is full
+  */
+static int8_t watchAdd(uint8_t getter, uint32_t address, uint8_t width) {
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		shellWatchEntry_t* entry = &watch.entries[id];
+
+		if (!entry->used) {
+			entry->getter = getter;
+			entry->address = address;
+			entry->width = width;
+			entry->last = watchRead(entry);
+			entry->used = true;
+			// A host decoding deltas needs the new entry's value
+			watch.full = true;
+			return (int8_t)id;
+		}
+	}
+	return -1;
+}
+
+/**
+  * @brief  Sends one text line with the changed values
+  * @param[IN]  changed Bit per entry to send
+  * @param[IN]  values Sampled value per entry
+  * @retval bool Returns false if the transmit queue had no room
+  */
+static bool watchSendText(uint32_t changed, uint32_t* values) {
+	SHELL_STR_DEFINE(str, WATCH_LINE_LEN);
+
+	shellStrAppend(&str, "W ");
+	shellStrAppendUnsigned(&str, HAL_GetTick(), 0);
+	shellStrAppend(&str, watch.full ? "*:" : ":");
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		if ((changed & (1UL << id)) == 0) {
+			continue;
+		}
+		const shellWatchEntry_t* entry = &watch.entries[id];
+
+		shellStrAppendChar(&str, ' ');
+		shellStrAppendUnsigned(&str, id, 0);
+		shellStrAppend(&str, "=0x");
+		shellStrAppendHex(&str, values[id], (entry->getter == WATCH_NO_GETTER) ? entry->width * 2 : 8);
+	}
+	shellStrAppend(&str, "\r\n");
+
+	// Never wait for room, the sample is skipped and the next one reports everything
+	if (transportFree(watch.ctx) < (uint32_t)str.len + SHELL_TX_RESERVE_MARGIN) {
+		return false;
+	}
+	watch.bytes += str.len;
+	shellStrSend(watch.ctx, &str);
+	return true;
+}
+
+/**
+  * @brief  Queues one delta frame with the changed values
+  * @param[IN]  changed Bit per entry to send
+  * @param[IN]  values Sampled value per entry
+  * @retval bool Returns false if the stream queue had no room
+  */
+static bool watchSendFrame(uint32_t changed, uint32_t* values) {
+	uint8_t frame[SHELL_WATCH_FRAME_LEN];
+	uint16_t len = SHELL_WATCH_FRAME_HEADER_LEN;
+	uint8_t count = 0;
+
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		if ((changed & (1UL << id)) == 0) {
+			continue;
+		}
+		frame[len++] = id;
+		frame[len++] = (uint8_t)values[id];
+		frame[len++] = (uint8_t)(values[id] >> 8);
+		frame[len++] = (uint8_t)(values[id] >> 16);
+		frame[len++] = (uint8_t)(values[id] >> 24);
+		count++;
+	}
+
+	frame[0] = SHELL_WATCH_SOF;
+	frame[1] = watch.frameSeq;
+	frame[2] = count;
+	frame[3] = (watch.full ? SHELL_WATCH_FLAG_FULL : 0) | (watch.skipped ? SHELL_WATCH_FLAG_SKIPPED : 0);
+
+	uint16_t crc = shellCrc16(SHELL_BIN_CRC_INIT, &frame[1], len - 1);
+	frame[len++] = (uint8_t)crc;
+	frame[len++] = (uint8_t)(crc >> 8);
+
+	if (!transportStreamWrite(frame, len)) {
+		return false;
+	}
+	watch.frameSeq++;
+	watch.bytes += len;
+	return true;
+}
+
+/**
+  * @brief  Samples every entry, sends what changed
+  * @note	A value only counts as reported once it has been queued. A sample without room
+  * 		changes nothing, the next one reports every entry.
+  * @param  NONE
+  * @retval NONE
+  */
+static void watchSample(void) {
+	uint32_t values[SHELL_WATCH_ENTRIES];
+	uint32_t changed = 0;
+	uint8_t count = 0;
+
+	watch.samples++;
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		shellWatchEntry_t* entry = &watch.entries[id];
+
+		if (!entry->used) {
+			continue;
+		}
+		values[id] = watchRead(entry);
+		if (watch.full || values[id] != entry->last) {
+			changed |= (1UL << id);
+			count++;
+		}
+	}
+
+	if (changed == 0) {
+		return;
+	}
+
+	if (!(watch.binary ? watchSendFrame(changed, values) : watchSendText(changed, values))) {
+		watch.skips++;
+		watch.skipped = true;
+		watch.full = true;
+		return;
+	}
+
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		if ((changed & (1UL << id)) != 0) {
+			watch.entries[id].last = values[id];
+		}
+	}
+	watch.reports++;
+	watch.changes += count;
+	watch.full = false;
+	watch.skipped = false;
+}
+
+/**
+  * @brief  Lists the entries and the sampling statistics
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+static void watchList(shell_ctx_t* ctx) {
+	SHELL_STR_DEFINE(str, 80);
+
+	for (uint8_t id = 0; id < SHELL_WATCH_ENTRIES; id++) {
+		const shellWatchEntry_t* entry = &watch.entries[id];
+
+		if (!entry->used) {
+			continue;
+		}
+		shellStrAppendUnsigned(&str, id, 0);
+		shellStrAppend(&str, ": ");
+		if (entry->getter != WATCH_NO_GETTER) {
+			shellStrAppend(&str, watchGetters[entry->getter].name);
+			shellStrAppend(&str, " = 0x");
+			shellStrAppendHex(&str, watchRead(entry), 8);
+		} else {
+			shellStrAppend(&str, "0x");
+			shellStrAppendHex(&str, entry->address, 8);
+			shellStrAppend(&str, " w");
+			shellStrAppendUnsigned(&str, entry->width, 0);
+			shellStrAppend(&str, " = 0x");
+			shellStrAppendHex(&str, watchRead(entry), entry->width * 2);
+		}
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+	}
+
+	if (watch.ctx == NULL) {
+		shellStrAppend(&str, "Stopped");
+	} else {
+		shellStrAppend(&str, "Every ");
+		shellStrAppendUnsigned(&str, watch.period, 0);
+		shellStrAppend(&str, " ms");
+	}
+	shellStrAppend(&str, ", samples ");
+	shellStrAppendUnsigned(&str, watch.samples, 0);
+	shellStrAppend(&str, ", reports ");
+	shellStrAppendUnsigned(&str, watch.reports, 0);
+	shellStrAppend(&str, ", values ");
+	shellStrAppendUnsigned(&str, watch.changes, 0);
+	shellStrAppend(&str, ", bytes ");
+	shellStrAppendUnsigned(&str, watch.bytes, 0);
+	shellStrAppend(&str, ", skipped ");
+	shellStrAppendUnsigned(&str, watch.skips, 0);
+	shellStrAppend(&str, "\r\n");
+	shellStrSend(ctx, &str);
+}
+
+/********************************************************************************
+ * PUBLIC FUNCTIONS
+ *******************************************************************************/
+/**
+  * @brief  Takes a sample when one is due
+  * @note	Called by checkShellStatus() of every instance, only the watching one samples. A main
+  * 		loop held up for more than a period takes one sample and goes on from now.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellWatchPoll(shell_ctx_t* ctx) {
+	if (watch.ctx != ctx) {
+		return;
+	}
+
+	uint32_t now = HAL_GetTick();
+	if ((int32_t)(now - watch.nextTick) < 0) {
+		return;
+	}
+
+	watch.nextTick += watch.period;
+	if ((int32_t)(now - watch.nextTick) >= 0) {
+		watch.nextTick = now + watch.period;
+	}
+	watchSample();
+}
+
+/**
+  * @brief  Stops the sampling of an instance (Ctrl-C or break)
+  * @note	The list stays.
+  * @param[IN]  ctx Shell instance
+  * @retval NONE
+  */
+void shellWatchStop(shell_ctx_t* ctx) {
+	if (watch.ctx == ctx) {
+		watch.ctx = NULL;
+	}
+}
+
+/********************************************************************************
+ * BRIDGES
+ *******************************************************************************/
+/**
+  * @brief  Adds, removes or lists watch entries, starts and stops the sampling
+  * @note	See CLI_SHELL_WATCH.h for the arguments and the output.
+  * @param[IN]  ctx Shell instance
+  * @param[IN]  parserInput	snapshot input from the command line parser
+  * @retval shell_error Error Return Value
+  */
+shell_error WatchBridge(shell_ctx_t* ctx, shellParserOutput_t* parserInput) {
+	SHELL_STR_DEFINE(str, 16);
+	int8_t id = -1;
+
+	if (shellHasArg(parserInput, argTkn_d)) {
+		uint8_t remove = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_d)).u8;
+
+		if (remove >= SHELL_WATCH_ENTRIES || !watch.entries[remove].used) {
+			return SHELL_ERR;
+		}
+		watch.entries[remove].used = false;
+		watch.full = true;
+		return SHELL_OK;
+	}
+
+	if (shellHasArg(parserInput, argTkn_g)) {
+		const char* name = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_g)).str;
+
+		for (uint8_t getter = 0; getter < WATCH_GETTERS; getter++) {
+			if (strcmp(name, watchGetters[getter].name) == 0) {
+				id = watchAdd(getter, 0, 0);
+				break;
+			}
+		}
+		if (id < 0) {
+			return SHELL_ERR;
+		}
+	} else if (shellHasArg(parserInput, argTkn_a)) {
+		uint32_t address = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_a)).u32;
+		uint8_t width = 4;
+
+		if (shellHasArg(parserInput, argTkn_w)) {
+			width = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_w)).u8;
+		}
+		if ((width != 1 && width != 2 && width != 4) || !shellMemReadable(address, width, width)) {
+			return SHELL_ERR;
+		}
+		id = watchAdd(WATCH_NO_GETTER, address, width);
+		if (id < 0) {
+			return SHELL_ERR;
+		}
+	}
+
+	if (id >= 0) {
+		shellStrAppend(&str, "Watch ");
+		shellStrAppendUnsigned(&str, (uint32_t)id, 0);
+		shellStrAppend(&str, "\r\n");
+		shellStrSend(ctx, &str);
+		return SHELL_OK;
+	}
+
+	if (!shellHasArg(parserInput, argTkn_p)) {
+		watchList(ctx);
+		return SHELL_OK;
+	}
+
+	uint16_t period = shellArgValue(parserInput, shellFindArg(parserInput, argTkn_p)).u16;
+	if (period == 0) {
+		if (watch.ctx == NULL) {
+			return SHELL_ERR;
+		}
+		watch.ctx = NULL;
+		return SHELL_OK;
+	}
+
+	bool binary = (ctx->mode == SHELL_MODE_BINARY);
+	if (period > SHELL_WATCH_MAX_PERIOD_MS || (watch.ctx != NULL && watch.ctx != ctx)) {
+		return SHELL_ERR;
+	}
+	// Delta frames go through the stream queue, which goes to the port of this command
+	if (binary && !transportStreamAttach(ctx)) {
+		return SHELL_ERR;
+	}
+
+	watch.ctx = ctx;
+	watch.binary = binary;
+	watch.period = period;
+	watch.nextTick = HAL_GetTick();
+	watch.full = true;
+	watch.skipped = false;
+	watch.samples = 0;
+	watch.reports = 0;
+	watch.changes = 0;
+	watch.bytes = 0;
+	watch.skips = 0;
+
+	return SHELL_OK;
+}
+
+/*** end of file ***/
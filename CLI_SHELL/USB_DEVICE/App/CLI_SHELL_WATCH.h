@@ -0,0 +1,71 @@
+/** @file CLI_SHELL_WATCH.h
+ *
+ * @brief Watch list of the CLI Shell: sampled values, only the changes are sent ("watch")
+ *
+ * @author Colton Crandell
+ * @revision history:
+ * - 1.0: 10-14-2026 (Crandell) Original
+ *
+ * Usage Notes:
+ *  - "watch a<address> w<width>" adds a memory location (register or variable) of w bytes (1, 2
+ *    or 4, default 4), checked against the memory map like "mrd". "watch g<name>" adds a getter,
+ *    a value a module keeps (watchGetters in CLI_SHELL_WATCH.c, add new ones there): "pool"
+ *    blocks in use, "passes" and "sleeps" of the main loop, "usbFrames" and "usbNaks" (frames
+ *    with IN data but no transfer armed) of the CDC port.
+ *    Each add answers "Watch <id>". "watch d<id>" removes one entry, "watch" lists them.
+ *  - "watch p<ms>" samples every entry every p ms (1 to 60000), "watch p0" or Ctrl-C stops. Only
+ *    the values that changed since their last report are sent, nothing while nothing changes:
+ *    - text session: "W <tick>: <id>=0x<value> ..." one line per sample with changes, tick in
+ *      ms (HAL_GetTick), the value with 2 digits per byte of the width.
+ *    - binary session (CLI_SHELL_BINARY.h): delta frames through the stream queue (USB only),
+ *        | 0x5C | seq | count | flags | count x (id, value (4, LE)) | CRC16 (2, LE) |
+ *      CRC16 as CLI_SHELL_BINARY.h over every byte after the SOF. They come between the response
+ *      frames (0x5A), tell them apart by the SOF.
+ *    The first sample, the first after a change of the list and the first after a sample that
+ *    found no room in the queue report every entry (SHELL_WATCH_FLAG_FULL, text "W <tick>* ...").
+ *    A skipped sample is counted, the host never misses a change for good.
+ *  - Sampling runs in checkShellStatus() of the instance that started it, not as a job. Other
+ *    commands and jobs keep running, sample times follow the main loop (1 ms SysTick wakeups).
+ *  - The list is shared by all instances, one instance watches at a time.
+ *
+ * COPYRIGHT NOTICE: (c) 2020.  All rights reserved.
+ */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef CLI_SHELL_WATCH_H_
+#define CLI_SHELL_WATCH_H_
+
+/*******************************************************************************
+ * INCLUDES
+ *******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+/********************************************************************************
+ * DEFINES
+ *******************************************************************************/
+#define SHELL_WATCH_ENTRIES				16
+#define SHELL_WATCH_MAX_PERIOD_MS		60000
+
+#define SHELL_WATCH_SOF					0x5C		/*!< Delta frame start					*/
+#define SHELL_WATCH_FRAME_HEADER_LEN	4			/*!< SOF, seq, count, flags				*/
+#define SHELL_WATCH_FRAME_ITEM_LEN		5			/*!< id, value							*/
+#define SHELL_WATCH_FRAME_LEN			(SHELL_WATCH_FRAME_HEADER_LEN + SHELL_WATCH_ENTRIES * SHELL_WATCH_FRAME_ITEM_LEN + 2)
+
+#define SHELL_WATCH_FLAG_FULL			0x01		/*!< Every entry, not only the changes	*/
+#define SHELL_WATCH_FLAG_SKIPPED		0x02		/*!< Samples were skipped before this	*/
+
+/********************************************************************************
+ * TYPES
+ *******************************************************************************/
+typedef struct shellCtxTypeDef shell_ctx_t;
+
+/********************************************************************************
+ * PROTOTYPES
+ *******************************************************************************/
+void shellWatchPoll(shell_ctx_t* ctx);
+void shellWatchStop(shell_ctx_t* ctx);
+
+#endif // CLI_SHELL_WATCH_H_
+
+/*** end of file ***/
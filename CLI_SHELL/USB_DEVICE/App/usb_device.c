@@ -28,7 +28,7 @@
 #include "usbd_cdc_if.h"
 
 /* USER CODE BEGIN Includes */
-
+#include "usbd_composite.h"
 /* USER CODE END Includes */
 
 /* USER CODE BEGIN PV */
@@ -73,7 +73,8 @@ void MX_USB_DEVICE_Init(void)
   {
     Error_Handler();
   }
-  if (USBD_RegisterClass(&hUsbDeviceFS, &USBD_CDC) != USBD_OK)
+  /* CDC ACM (operator port) + vendor bulk interface (automation port), see usbd_composite.h */
+  if (USBD_RegisterClass(&hUsbDeviceFS, &USBD_COMPOSITE) != USBD_OK)
   {
     Error_Handler();
   }
@@ -81,6 +82,10 @@ void MX_USB_DEVICE_Init(void)
   {
     Error_Handler();
   }
+  if (USBD_VND_RegisterInterface(&hUsbDeviceFS, &USBD_VND_Interface_fops_FS) != USBD_OK)
+  {
+    Error_Handler();
+  }
   if (USBD_Start(&hUsbDeviceFS) != USBD_OK)
   {
     Error_Handler();
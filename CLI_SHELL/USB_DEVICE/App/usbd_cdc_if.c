@@ -24,6 +24,10 @@
 
 /* USER CODE BEGIN INCLUDE */
 #include "CLI_SHELL.h"
+#include "CLI_SHELL_EVENT.h"
+#include "CLI_SHELL_TRACE.h"
+#include "CLI_SHELL_BOOT.h"
+#include "CLI_SHELL_NOTIFY.h"
 /* USER CODE END INCLUDE */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -50,7 +54,19 @@
   */
 
 /* USER CODE BEGIN PRIVATE_TYPES */
-
+/** One shell port: its receive slots, transmit queue and the transfer in flight */
+typedef struct
+{
+  shellRing_t txQueue;              /* Transmit queue, transfers run straight out of its storage */
+  shellRing_t *txInFlightQueue;     /* Queue the transfer in flight was taken from */
+  volatile uint32_t txInFlightLen;  /* Length of the transfer owned by the IN endpoint (0 = idle) */
+  volatile uint32_t txDropped;      /* Bytes rejected by CDC_Write_FS because the queue was full */
+  uint8_t *rxBuffer;                /* CDC_RX_SLOT_COUNT packet slots */
+  uint8_t rxSlot;                   /* Receive slot the OUT endpoint is armed with */
+  volatile uint8_t rxHeld;          /* OUT endpoint left unarmed until the shell ring has room */
+  uint8_t inEp;                     /* Data IN endpoint */
+  shell_ctx_t *shell;               /* Shell instance fed by this port (CDC_AttachShell_FS) */
+} CDC_Channel_t;
 /* USER CODE END PRIVATE_TYPES */
 
 /**
@@ -65,8 +81,25 @@
 /* USER CODE BEGIN PRIVATE_DEFINES */
 /* Define size for the receive and transmit buffer over CDC */
 /* It's up to user to redefine and/or remove those define */
-#define APP_RX_DATA_SIZE  1024
-#define APP_TX_DATA_SIZE  1024
+/* The receive buffer is split into CDC_RX_SLOT_COUNT packet slots that the OUT endpoint rotates through */
+#define CDC_RX_SLOT_COUNT 2
+#define APP_RX_DATA_SIZE  (CDC_RX_SLOT_COUNT * CDC_DATA_FS_MAX_PACKET_SIZE)
+/* Queue sizes follow the shell sizing profile (CLI_SHELL_CONFIG.h) */
+#define APP_TX_DATA_SIZE  SHELL_TX_QUEUE_LEN
+/* Transmit queue of the automation (vendor) port */
+#define APP_VND_TX_DATA_SIZE  SHELL_TX_QUEUE_LEN
+/* Telemetry stream queue (power of two, multiple of the packet size) and the largest stream transfer */
+#define APP_STREAM_DATA_SIZE     SHELL_STREAM_QUEUE_LEN
+#define APP_STREAM_MAX_TRANSFER  512
+/* OUT endpoints are held back below one packet of room (CDC_ReceiveNext_FS), the ring must take two
+   packets besides the line start the urgent lane holds */
+_Static_assert(SHELL_RX_RING_LEN >= 2 * CDC_DATA_FS_MAX_PACKET_SIZE + SHELL_URGENT_LINE_LEN, "SHELL_RX_RING_LEN too small for the USB packets");
+_Static_assert(APP_STREAM_DATA_SIZE % CDC_DATA_FS_MAX_PACKET_SIZE == 0 && APP_STREAM_DATA_SIZE >= APP_STREAM_MAX_TRANSFER, "SHELL_STREAM_QUEUE_LEN must hold whole packets and one stream transfer");
+/* Shell event notifications waiting for the notification endpoint (power of two) */
+#define CDC_NOTIFY_QUEUE         8U
+_Static_assert((CDC_NOTIFY_LEN % CDC_CMD_PACKET_SIZE) != 0U, "CDC_NOTIFY_LEN must not need a ZLP");
+/* The class data comes from the static block pool (USBD_malloc) */
+_Static_assert(sizeof(USBD_CDC_HandleTypeDef) <= SHELL_POOL_BLOCK_SIZE, "SHELL_POOL_BLOCK_SIZE too small for the CDC class data");
 /* USER CODE END PRIVATE_DEFINES */
 
 /**
@@ -93,13 +126,47 @@
 /* Create buffer for reception and transmission           */
 /* It's up to user to redefine and/or remove those define */
 /** Received data over USB are stored in this buffer      */
-uint8_t UserRxBufferFS[APP_RX_DATA_SIZE];
+/** Word aligned for the FIFO copy fast path in USB_ReadPacket / USB_WritePacket */
+/** Not zeroed at reset (SHELL_NOINIT), the queues and slots are always written before read */
+SHELL_NOINIT __ALIGNED(4) uint8_t UserRxBufferFS[APP_RX_DATA_SIZE];
 
 /** Data to send over USB CDC are stored in this buffer   */
-uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
+SHELL_NOINIT __ALIGNED(4) uint8_t UserTxBufferFS[APP_TX_DATA_SIZE];
 
 /* USER CODE BEGIN PRIVATE_VARIABLES */
 static uint8_t lineCoding[7] = {0x00, 0xC2, 0x01, 0x00, 0x00, 0x00, 0x08};
+
+/** Receive slots and transmit queue storage of the automation port, not zeroed at reset (SHELL_NOINIT) */
+SHELL_NOINIT __ALIGNED(4) static uint8_t VndRxBufferFS[APP_RX_DATA_SIZE];
+SHELL_NOINIT __ALIGNED(4) static uint8_t VndTxBufferFS[APP_VND_TX_DATA_SIZE];
+
+/** The shell ports, indexed by CDC_CH_ */
+static CDC_Channel_t channels[CDC_CH_COUNT] =
+{
+  [CDC_CH_OPERATOR] = { .txQueue = SHELL_RING_STATIC_INIT(UserTxBufferFS), .rxBuffer = UserRxBufferFS, .inEp = CDC_IN_EP },
+  [CDC_CH_AUTOMATION] = { .txQueue = SHELL_RING_STATIC_INIT(VndTxBufferFS), .rxBuffer = VndRxBufferFS, .inEp = VND_IN_EP },
+};
+
+/** Telemetry stream queue, sent on the attached port whenever its transmit queue is empty */
+SHELL_NOINIT __ALIGNED(4) static uint8_t UserStreamBufferFS[APP_STREAM_DATA_SIZE];
+static shellRing_t streamQueue = SHELL_RING_STATIC_INIT(UserStreamBufferFS);
+static volatile uint8_t streamChannel = CDC_CH_OPERATOR;
+
+/** Frame statistics and the IN packets completed in the current frame */
+static CDC_FrameStats_t frameStats;
+static uint32_t framePackets = 0;
+
+/** Link health counters, receive drops relative to the shell rings at the last clear */
+static CDC_LinkStats_t linkStats;
+static uint32_t linkRxDroppedBase[CDC_CH_COUNT];
+static uint32_t linkTxDroppedBase[CDC_CH_COUNT];
+
+/** Notifications not yet sent. Queued from any context (head), sent from the USB interrupt (tail) */
+static uint8_t notifyQueue[CDC_NOTIFY_QUEUE][CDC_NOTIFY_LEN];
+static volatile uint8_t notifyHead = 0;
+static volatile uint8_t notifyTail = 0;
+static volatile uint8_t notifyBusy = 0;
+static uint8_t notifySeq = 0;
 /* USER CODE END PRIVATE_VARIABLES */
 
 /**
@@ -130,9 +197,41 @@ static int8_t CDC_Init_FS(void);
 static int8_t CDC_DeInit_FS(void);
 static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length);
 static int8_t CDC_Receive_FS(uint8_t* pbuf, uint32_t *Len);
+static int8_t CDC_TransmitCplt_FS(uint8_t *pbuf, uint32_t *Len, uint8_t epnum);
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_DECLARATION */
+static int8_t VND_Init_FS(void);
+static int8_t VND_DeInit_FS(void);
+static int8_t VND_Receive_FS(uint8_t* Buf, uint32_t *Len);
+static int8_t VND_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum);
+static void CDC_ArmNextSlot_FS(uint8_t Ch);
+static void CDC_ReceiveNext_FS(uint8_t Ch, uint32_t Len);
+static void CDC_TransferDone_FS(uint8_t Ch);
+static uint32_t CDC_Pending_FS(uint8_t Ch);
+static void CDC_StartNextTransfer_FS(uint8_t Ch);
+static void CDC_NotifyNext_FS(void);
+static void CDC_NotifyCplt_FS(void);
 
+USBD_VND_ItfTypeDef USBD_VND_Interface_fops_FS =
+{
+  VND_Init_FS,
+  VND_DeInit_FS,
+  VND_Receive_FS,
+  VND_TransmitCplt_FS
+};
+
+const shellTransport_t CDC_Transport_FS =
+{
+  CDC_AttachShell_FS,
+  CDC_Write_FS,
+  CDC_Flush_FS,
+  CDC_TxFree_FS,
+  CDC_StreamAttach_FS,
+  CDC_RxResume_FS,
+  CDC_Notify_FS,
+  CDC_TxSpan_FS,
+  CDC_TxCommit_FS
+};
 /* USER CODE END PRIVATE_FUNCTIONS_DECLARATION */
 
 /**
@@ -144,7 +243,8 @@ USBD_CDC_ItfTypeDef USBD_Interface_fops_FS =
   CDC_Init_FS,
   CDC_DeInit_FS,
   CDC_Control_FS,
-  CDC_Receive_FS
+  CDC_Receive_FS,
+  CDC_TransmitCplt_FS
 };
 
 /* Private functions ---------------------------------------------------------*/
@@ -157,7 +257,16 @@ static int8_t CDC_Init_FS(void)
   /* USER CODE BEGIN 3 */
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, UserTxBufferFS, 0);
+  channels[CDC_CH_OPERATOR].rxSlot = 0;
+  channels[CDC_CH_OPERATOR].rxHeld = 0;
   USBD_CDC_SetRxBuffer(&hUsbDeviceFS, UserRxBufferFS);
+
+  /* A transfer cut off by a reset never completes - resend it from the queue */
+  channels[CDC_CH_OPERATOR].txInFlightLen = 0;
+  notifyBusy = 0;
+  USBD_NTF_RegisterCallback(&hUsbDeviceFS, CDC_NotifyCplt_FS);
+  /* SET_CONFIGURATION, the host has enumerated the device */
+  shellBootStamp(bootStage_usbConfig);
   return (USBD_OK);
   /* USER CODE END 3 */
 }
@@ -235,7 +344,11 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
     break;
 
     case CDC_SEND_BREAK:
-
+      // Host side break (e.g. the terminal's "send break") stops the running command
+      if (channels[CDC_CH_OPERATOR].shell != NULL)
+      {
+        shellAbort(channels[CDC_CH_OPERATOR].shell);
+      }
     break;
 
   default:
@@ -263,11 +376,18 @@ static int8_t CDC_Control_FS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_FS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 6 */
-  USBD_CDC_SetRxBuffer(&hUsbDeviceFS, &Buf[0]);
-  USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  // Arm the endpoint with the next slot first, so the host can keep streaming into it
+  // while this packet is still being handed to the shell. Buf is never re-armed until
+  // every other slot has been used. Without room for another packet the endpoint stays
+  // unarmed and NAKs the host until the shell has caught up (CDC_RxResume_FS).
+  CDC_ReceiveNext_FS(CDC_CH_OPERATOR, *Len);
+  SHELL_TRACE(traceEvt_rx, CDC_CH_OPERATOR, *Len);
 
   // Feed the buffer through to the CLI parser
-  rxShellInput(Buf, Len);
+  if (channels[CDC_CH_OPERATOR].shell != NULL)
+  {
+    rxShellInput(channels[CDC_CH_OPERATOR].shell, Buf, Len);
+  }
 
   return (USBD_OK);
   /* USER CODE END 6 */
@@ -290,16 +410,716 @@ uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len)
   /* USER CODE BEGIN 7 */
   USBD_CDC_HandleTypeDef *hcdc = (USBD_CDC_HandleTypeDef*)hUsbDeviceFS.pClassData;
   if (hcdc->TxState != 0){
+    linkStats.txBusy[CDC_CH_OPERATOR]++;
     return USBD_BUSY;
   }
   USBD_CDC_SetTxBuffer(&hUsbDeviceFS, Buf, Len);
+  SHELL_TRACE(traceEvt_txStart, CDC_CH_OPERATOR, Len);
   result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
   /* USER CODE END 7 */
   return result;
 }
 
+/**
+  * @brief  CDC_TransmitCplt_FS
+  *         Called from the DataIn stage once the IN transfer (and any ZLP) is done.
+  *         Releases the sent bytes from the transmit queue and chains the next transfer.
+  *
+  * @param  Buf: Buffer of data that was sent
+  * @param  Len: Number of data sent (in bytes)
+  * @param  epnum: Endpoint number
+  * @retval Result of the operation: USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t CDC_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
+{
+  uint8_t result = USBD_OK;
+  /* USER CODE BEGIN 13 */
+  UNUSED(Buf);
+  UNUSED(Len);
+  UNUSED(epnum);
+
+  CDC_TransferDone_FS(CDC_CH_OPERATOR);
+  /* USER CODE END 13 */
+  return result;
+}
+
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
+/**
+  * @brief  VND_Init_FS
+  *         Initializes the automation port (vendor interface)
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t VND_Init_FS(void)
+{
+  channels[CDC_CH_AUTOMATION].rxSlot = 0;
+  channels[CDC_CH_AUTOMATION].rxHeld = 0;
+  USBD_VND_SetRxBuffer(&hUsbDeviceFS, VndRxBufferFS);
+
+  /* A transfer cut off by a reset never completes - resend it from the queue */
+  channels[CDC_CH_AUTOMATION].txInFlightLen = 0;
+  return (USBD_OK);
+}
+
+/**
+  * @brief  VND_DeInit_FS
+  *         DeInitializes the automation port
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t VND_DeInit_FS(void)
+{
+  return (USBD_OK);
+}
+
+/**
+  * @brief  VND_Receive_FS
+  *         Data received on the automation port, handed to its shell instance.
+  * @param  Buf: Buffer of data to be received
+  * @param  Len: Number of data received (in bytes)
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t VND_Receive_FS(uint8_t* Buf, uint32_t *Len)
+{
+  CDC_ReceiveNext_FS(CDC_CH_AUTOMATION, *Len);
+  SHELL_TRACE(traceEvt_rx, CDC_CH_AUTOMATION, *Len);
+  if (channels[CDC_CH_AUTOMATION].shell != NULL)
+  {
+    rxShellInput(channels[CDC_CH_AUTOMATION].shell, Buf, Len);
+  }
+  return (USBD_OK);
+}
+
+/**
+  * @brief  VND_TransmitCplt_FS
+  *         The IN transfer (and any ZLP) of the automation port is done.
+  * @param  Buf: Buffer of data that was sent
+  * @param  Len: Number of data sent (in bytes)
+  * @param  epnum: Endpoint number
+  * @retval USBD_OK if all operations are OK else USBD_FAIL
+  */
+static int8_t VND_TransmitCplt_FS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
+{
+  UNUSED(Buf);
+  UNUSED(Len);
+  UNUSED(epnum);
+
+  CDC_TransferDone_FS(CDC_CH_AUTOMATION);
+  return (USBD_OK);
+}
+
+/**
+  * @brief  CDC_ArmNextSlot_FS
+  *         Arms the OUT endpoint of a port with its next receive slot.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval None
+  */
+static void CDC_ArmNextSlot_FS(uint8_t Ch)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+  uint8_t *slot;
+
+  chan->rxSlot = (uint8_t)((chan->rxSlot + 1U) % CDC_RX_SLOT_COUNT);
+  slot = &chan->rxBuffer[chan->rxSlot * CDC_DATA_FS_MAX_PACKET_SIZE];
+
+  if (Ch == CDC_CH_OPERATOR)
+  {
+    USBD_CDC_SetRxBuffer(&hUsbDeviceFS, slot);
+    USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+  }
+  else
+  {
+    USBD_VND_SetRxBuffer(&hUsbDeviceFS, slot);
+    USBD_VND_ReceivePacket(&hUsbDeviceFS);
+  }
+}
+
+/**
+  * @brief  CDC_ReceiveNext_FS
+  *         Arms the OUT endpoint of a port for the next packet if the shell ring can take it
+  *         after the one just received. Otherwise the endpoint is held back, the host's OUT
+  *         tokens are NAKed and nothing is lost.
+  * @param  Ch: Port (CDC_CH_)
+  * @param  Len: Length of the packet just received, not yet in the ring
+  * @retval None
+  */
+static void CDC_ReceiveNext_FS(uint8_t Ch, uint32_t Len)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+
+  if (chan->shell != NULL && shellRxFree(chan->shell) < Len + CDC_DATA_FS_MAX_PACKET_SIZE)
+  {
+    chan->rxHeld = 1;
+    linkStats.rxHeld[Ch]++;
+    shellNotify(chan->shell, notifyEvt_rxHeld, shellRxFree(chan->shell));
+    return;
+  }
+  CDC_ArmNextSlot_FS(Ch);
+}
+
+/**
+  * @brief  CDC_TransferDone_FS
+  *         Releases the sent bytes of a port from their queue and chains the next transfer.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval None
+  */
+static void CDC_TransferDone_FS(uint8_t Ch)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+
+  if (chan->txInFlightLen != 0U)
+  {
+    SHELL_TRACE(traceEvt_txDone, Ch, chan->txInFlightLen);
+    framePackets += (chan->txInFlightLen + CDC_DATA_FS_MAX_PACKET_SIZE - 1U) / CDC_DATA_FS_MAX_PACKET_SIZE;
+    shellRingSkip(chan->txInFlightQueue, chan->txInFlightLen);
+    chan->txInFlightLen = 0;
+  }
+  CDC_StartNextTransfer_FS(Ch);
+  shellEventSignal(SHELL_EVENT_TX);
+}
+
+/**
+  * @brief  CDC_Pending_FS
+  *         Bytes waiting for a port, the stream queue included if it is attached there.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval Number of queued bytes
+  */
+static uint32_t CDC_Pending_FS(uint8_t Ch)
+{
+  uint32_t pending = shellRingUsed(&channels[Ch].txQueue);
+
+  if (Ch == streamChannel)
+  {
+    pending += shellRingUsed(&streamQueue);
+  }
+  return pending;
+}
+
+/**
+  * @brief  CDC_StartNextTransfer_FS
+  *         Starts one IN transfer on a port covering everything queued that is contiguous in
+  *         its transmit queue. Small writes queued since the last transfer go out together,
+  *         so the host sees full 64 byte packets instead of many short ones.
+  *         Shell output goes first. The stream queue is sent on the port it is attached to
+  *         when that transmit queue is empty, in whole packets while more than one packet is
+  *         waiting, so the transfers chain full packets back to back and shell output only
+  *         falls between them.
+  *         A transfer of whole packets is normally closed with a ZLP. When more data is
+  *         already queued the ZLP is skipped - the next transfer follows straight from the
+  *         completion callback and the host never waits on the boundary.
+  *         @note
+  *         Only the owner of the endpoint may call this: the main loop while no transfer
+  *         is in flight, or the DataIn completion callback.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval None
+  */
+static void CDC_StartNextTransfer_FS(uint8_t Ch)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+  uint8_t *block;
+  uint32_t len;
+  uint32_t primask;
+  uint8_t result;
+
+  if ((hUsbDeviceFS.pClassData == NULL) || (hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED))
+  {
+    return;
+  }
+
+  chan->txInFlightQueue = &chan->txQueue;
+  len = shellRingPeekContiguous(&chan->txQueue, &block);
+  if ((len == 0U) && (Ch == streamChannel))
+  {
+    chan->txInFlightQueue = &streamQueue;
+    len = shellRingPeekContiguous(&streamQueue, &block);
+    if (len > APP_STREAM_MAX_TRANSFER)
+    {
+      len = APP_STREAM_MAX_TRANSFER;
+    }
+    else if (len > CDC_DATA_FS_MAX_PACKET_SIZE)
+    {
+      len -= len % CDC_DATA_FS_MAX_PACKET_SIZE;
+    }
+  }
+  if (len == 0U)
+  {
+    return;
+  }
+
+  chan->txInFlightLen = len;
+  SHELL_TRACE(traceEvt_txStart, Ch, len);
+
+  /* The FIFO is loaded inside TransmitPacket, so a short transfer can complete before it
+     returns. Keep the completion out until the ZLP decision is made. */
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (Ch == CDC_CH_OPERATOR)
+  {
+    USBD_CDC_SetTxBuffer(&hUsbDeviceFS, block, (uint16_t)len);
+    result = USBD_CDC_TransmitPacket(&hUsbDeviceFS);
+  }
+  else
+  {
+    result = USBD_VND_TransmitPacket(&hUsbDeviceFS, block, len);
+  }
+
+  if (result != USBD_OK)
+  {
+    linkStats.txBusy[Ch]++;
+    chan->txInFlightLen = 0;
+  }
+  else if (((len % CDC_DATA_FS_MAX_PACKET_SIZE) == 0U) && (CDC_Pending_FS(Ch) > len))
+  {
+    /* The DataIn stage only sends the ZLP while total_length is set */
+    hUsbDeviceFS.ep_in[chan->inEp & 0xFU].total_length = 0U;
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CDC_AttachShell_FS
+  *         Hands everything received on a port (and its breaks) to a shell instance.
+  *         Called by shellInit(). Data arriving before that is discarded.
+  *
+  * @param  Ch: Port (CDC_CH_)
+  * @param  Shell: Shell instance
+  * @retval None
+  */
+void CDC_AttachShell_FS(uint8_t Ch, struct shellCtxTypeDef* Shell)
+{
+  channels[Ch].shell = Shell;
+}
+
+/**
+  * @brief  CDC_RxResume_FS
+  *         Arms the OUT endpoint of a port held back by CDC_ReceiveNext_FS once the shell
+  *         ring has room for a full packet. Called by checkShellStatus() after reading the ring.
+  *
+  * @param  Ch: Port (CDC_CH_)
+  * @retval None
+  */
+void CDC_RxResume_FS(uint8_t Ch)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+  uint32_t primask;
+
+  if (chan->rxHeld == 0U || shellRxFree(chan->shell) < CDC_DATA_FS_MAX_PACKET_SIZE)
+  {
+    return;
+  }
+
+  // A bus reset in between re-arms the endpoint itself and clears rxHeld
+  primask = __get_PRIMASK();
+  __disable_irq();
+  if (chan->rxHeld != 0U)
+  {
+    chan->rxHeld = 0;
+    CDC_ArmNextSlot_FS(Ch);
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CDC_Write_FS
+  *         Queues data for the IN endpoint of a port. Never blocks - the data is copied, so
+  *         the caller's buffer may go out of scope straight away. Call CDC_Flush_FS() to
+  *         start sending if the endpoint is idle.
+  *
+  * @param  Ch: Port (CDC_CH_)
+  * @param  Buf: Buffer of data to be sent
+  * @param  Len: Number of data to be sent (in bytes)
+  *         The shell waits for room before every response write (shellOutputReserve()),
+  *         so only output for a host that stopped reading is cut.
+  * @retval Number of bytes queued. Anything short of Len is counted as dropped.
+  */
+uint16_t CDC_Write_FS(uint8_t Ch, const uint8_t* Buf, uint16_t Len)
+{
+  CDC_Channel_t *chan = &channels[Ch];
+  uint32_t queued = shellRingWrite(&chan->txQueue, Buf, Len);
+
+  if (queued < Len)
+  {
+    chan->txDropped += Len - queued;
+  }
+  return (uint16_t)queued;
+}
+
+/**
+  * @brief  CDC_Flush_FS
+  *         Starts a transfer of the queued data on every port whose IN endpoint is idle.
+  *         While a transfer is running nothing is done there - the completion callback
+  *         picks up the rest. With USBD_SOF_TX_FLUSH set this does nothing, the next SOF
+  *         starts the transfers.
+  * @retval None
+  */
+void CDC_Flush_FS(void)
+{
+#if (USBD_SOF_TX_FLUSH == 0U)
+  for (uint8_t ch = 0; ch < CDC_CH_COUNT; ch++)
+  {
+    if (channels[ch].txInFlightLen == 0U)
+    {
+      CDC_StartNextTransfer_FS(ch);
+    }
+  }
+#endif
+}
+
+/**
+  * @brief  CDC_TxFree_FS
+  *         Free space in the transmit queue of a port.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval Number of bytes that CDC_Write_FS can accept right now
+  */
+uint32_t CDC_TxFree_FS(uint8_t Ch)
+{
+  return shellRingFree(&channels[Ch].txQueue);
+}
+
+/**
+  * @brief  CDC_TxSpan_FS
+  *         Contiguous free block of the transmit queue of a port, the caller writes into it
+  *         and publishes the bytes with CDC_TxCommit_FS (zero-copy output).
+  * @param  Ch: Port (CDC_CH_)
+  * @param  Buf: Start of the block
+  * @retval Length of the block
+  */
+uint32_t CDC_TxSpan_FS(uint8_t Ch, uint8_t** Buf)
+{
+  return shellRingReserveContiguous(&channels[Ch].txQueue, Buf);
+}
+
+/**
+  * @brief  CDC_TxCommit_FS
+  *         Queues bytes written into the block of CDC_TxSpan_FS. Call CDC_Flush_FS() to start
+  *         sending if the endpoint is idle.
+  * @param  Ch: Port (CDC_CH_)
+  * @param  Len: Number of bytes written, at most the length of the block
+  * @retval None
+  */
+void CDC_TxCommit_FS(uint8_t Ch, uint16_t Len)
+{
+  shellRingCommit(&channels[Ch].txQueue, Len);
+}
+
+/**
+  * @brief  CDC_TxDropped_FS
+  *         Bytes rejected by CDC_Write_FS on a port since startup.
+  * @param  Ch: Port (CDC_CH_)
+  * @retval Dropped byte count
+  */
+uint32_t CDC_TxDropped_FS(uint8_t Ch)
+{
+  return channels[Ch].txDropped;
+}
+
+/**
+  * @brief  CDC_StreamAttach_FS
+  *         Sends the stream queue on a port from now on. The queue moves only once it is
+  *         empty, so a running stream is never split between ports.
+  *
+  * @param  Ch: Port (CDC_CH_)
+  * @retval 1 if the stream queue is attached to Ch, 0 if it is still draining elsewhere
+  */
+uint8_t CDC_StreamAttach_FS(uint8_t Ch)
+{
+  if (Ch == streamChannel)
+  {
+    return 1;
+  }
+  /* Sent bytes stay queued until their transfer completes, so empty also means none in flight */
+  if (shellRingUsed(&streamQueue) != 0U)
+  {
+    return 0;
+  }
+  streamChannel = Ch;
+  return 1;
+}
+
+/**
+  * @brief  CDC_StreamWrite_FS
+  *         Queues a telemetry record. Records are queued whole or not at all, so a full
+  *         queue never leaves a partial record behind. Call CDC_Flush_FS() to start sending.
+  *
+  * @param  Buf: Record
+  * @param  Len: Record length (in bytes)
+  * @retval 1 if the record was queued, 0 if there was no room for it
+  */
+uint8_t CDC_StreamWrite_FS(const uint8_t* Buf, uint16_t Len)
+{
+  if (shellRingFree(&streamQueue) < Len)
+  {
+    return 0;
+  }
+  shellRingWrite(&streamQueue, Buf, Len);
+  return 1;
+}
+
+/**
+  * @brief  CDC_StreamFree_FS
+  *         Free space in the stream queue.
+  * @retval Number of bytes CDC_StreamWrite_FS can accept right now
+  */
+uint32_t CDC_StreamFree_FS(void)
+{
+  return shellRingFree(&streamQueue);
+}
+
+/**
+  * @brief  CDC_StreamUsed_FS
+  *         Telemetry bytes not yet sent.
+  * @retval Number of bytes in the stream queue
+  */
+uint32_t CDC_StreamUsed_FS(void)
+{
+  return shellRingUsed(&streamQueue);
+}
+
+/**
+  * @brief  CDC_SOF_FS
+  *         Called from the SOF interrupt at the start of every 1 ms frame. Closes the
+  *         statistics of the frame that ended and, with USBD_SOF_TX_FLUSH set, starts the
+  *         transfer of everything queued during it.
+  *         @note
+  *         Runs at the USB interrupt priority, so it owns the endpoint like the completion
+  *         callback does.
+  * @retval None
+  */
+void CDC_SOF_FS(void)
+{
+  uint8_t starved = 0;
+
+  frameStats.frames++;
+  if (framePackets != 0U)
+  {
+    frameStats.busyFrames++;
+    frameStats.inPackets += framePackets;
+    if (framePackets > frameStats.maxPacketsPerFrame)
+    {
+      frameStats.maxPacketsPerFrame = framePackets;
+    }
+    framePackets = 0;
+  }
+
+  for (uint8_t ch = 0; ch < CDC_CH_COUNT; ch++)
+  {
+#if (USBD_SOF_TX_FLUSH != 0U)
+    if (channels[ch].txInFlightLen == 0U)
+    {
+      CDC_StartNextTransfer_FS(ch);
+    }
+#endif
+
+    if ((channels[ch].txInFlightLen == 0U) && (CDC_Pending_FS(ch) != 0U))
+    {
+      starved = 1;
+    }
+  }
+
+  if (starved != 0U)
+  {
+    frameStats.nakFrames++;
+  }
+
+  CDC_NotifyNext_FS();
+}
+
+/**
+  * @brief  CDC_FrameStats_FS
+  *         USB frame statistics since startup or the last CDC_FrameStatsClear_FS().
+  * @retval Statistics, updated from the SOF interrupt
+  */
+const CDC_FrameStats_t* CDC_FrameStats_FS(void)
+{
+  return &frameStats;
+}
+
+/**
+  * @brief  CDC_FrameStatsClear_FS
+  *         Restarts the frame statistics.
+  * @retval None
+  */
+void CDC_FrameStatsClear_FS(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  memset(&frameStats, 0, sizeof(frameStats));
+  framePackets = 0;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CDC_LinkTransfer_FS
+  *         Counts a completed transfer, called from the DataIn/DataOut stage callbacks.
+  * @param  EpAddr: Endpoint address, bit 7 set for IN
+  * @param  Len: Bytes transferred
+  * @retval None
+  */
+void CDC_LinkTransfer_FS(uint8_t EpAddr, uint32_t Len)
+{
+  uint8_t ep = EpAddr & 0x0FU;
+
+  if (ep >= CDC_LINK_EP_COUNT)
+  {
+    return;
+  }
+  if ((EpAddr & 0x80U) != 0U)
+  {
+    linkStats.inTransfers[ep]++;
+    linkStats.inBytes[ep] += Len;
+  }
+  else
+  {
+    linkStats.outTransfers[ep]++;
+    linkStats.outBytes[ep] += Len;
+  }
+}
+
+/**
+  * @brief  CDC_LinkEvent_FS
+  *         Counts a bus event, called from the PCD callbacks in usbd_conf.c.
+  * @param  Event: CDC_LINK_ event
+  * @retval None
+  */
+void CDC_LinkEvent_FS(CDC_LinkEvent_t Event)
+{
+  if (Event < CDC_LINK_EVENTS)
+  {
+    linkStats.events[Event]++;
+  }
+}
 
+/**
+  * @brief  CDC_LinkIsr_FS
+  *         Records the duration of one OTG_FS interrupt (stm32f4xx_it.c).
+  * @param  Cycles: Core cycles spent in HAL_PCD_IRQHandler
+  * @retval None
+  */
+void CDC_LinkIsr_FS(uint32_t Cycles)
+{
+  linkStats.isrCount++;
+  if (Cycles > linkStats.isrMaxCycles)
+  {
+    linkStats.isrMaxCycles = Cycles;
+  }
+}
+
+/**
+  * @brief  CDC_LinkStats_FS
+  *         Consistent copy of the link counters since startup or the last CDC_LinkStatsClear_FS().
+  * @param  Stats: Snapshot
+  * @retval None
+  */
+void CDC_LinkStats_FS(CDC_LinkStats_t* Stats)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  *Stats = linkStats;
+  for (uint8_t ch = 0; ch < CDC_CH_COUNT; ch++)
+  {
+    Stats->txDropped[ch] = channels[ch].txDropped - linkTxDroppedBase[ch];
+    if (channels[ch].shell != NULL)
+    {
+      Stats->rxDropped[ch] = channels[ch].shell->rxRing.dropped - linkRxDroppedBase[ch];
+    }
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CDC_LinkStatsClear_FS
+  *         Restarts the link counters.
+  * @retval None
+  */
+void CDC_LinkStatsClear_FS(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  memset(&linkStats, 0, sizeof(linkStats));
+  for (uint8_t ch = 0; ch < CDC_CH_COUNT; ch++)
+  {
+    linkTxDroppedBase[ch] = channels[ch].txDropped;
+    linkRxDroppedBase[ch] = (channels[ch].shell != NULL) ? channels[ch].shell->rxRing.dropped : 0U;
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  CDC_Notify_FS
+  *         Queues a shell event for the CDC notification endpoint (EP 0x82). It goes out
+  *         with the next SOF, the host reads it within CDC_FS_BINTERVAL frames:
+  *           | 0xA1 | CDC_NOTIFY_SHELL_EVENT | event | seq | wIndex (2, LE) | 4, 0 | value (4, LE) |
+  *         wIndex is the interface of the port (0 operator, VND_INTERFACE automation), seq
+  *         counts the queued notifications so the host sees when some were dropped.
+  *         @note
+  *         Interrupt safe. Both ports share the endpoint.
+  * @param  Ch: Port (CDC_CH_) the event belongs to
+  * @param  Event: Event code
+  * @param  Value: Event value
+  * @retval 1 if queued, 0 if the queue is full
+  */
+uint8_t CDC_Notify_FS(uint8_t Ch, uint8_t Event, uint32_t Value)
+{
+  uint16_t itf = (Ch == CDC_CH_AUTOMATION) ? VND_INTERFACE : 0U;
+  uint32_t primask = __get_PRIMASK();
+  uint8_t *record;
+
+  __disable_irq();
+  if ((uint8_t)(notifyHead - notifyTail) >= CDC_NOTIFY_QUEUE)
+  {
+    __set_PRIMASK(primask);
+    return 0;
+  }
+
+  record = notifyQueue[notifyHead % CDC_NOTIFY_QUEUE];
+  record[0] = 0xA1U;
+  record[1] = CDC_NOTIFY_SHELL_EVENT;
+  record[2] = Event;
+  record[3] = notifySeq++;
+  record[4] = LOBYTE(itf);
+  record[5] = HIBYTE(itf);
+  record[6] = CDC_NOTIFY_LEN - 8U;
+  record[7] = 0U;
+  record[8] = (uint8_t)Value;
+  record[9] = (uint8_t)(Value >> 8);
+  record[10] = (uint8_t)(Value >> 16);
+  record[11] = (uint8_t)(Value >> 24);
+  notifyHead++;
+  __set_PRIMASK(primask);
+  return 1;
+}
+
+/**
+  * @brief  CDC_NotifyNext_FS
+  *         Sends the oldest queued notification unless one is on its way.
+  *         @note
+  *         Called from the SOF and the notification completion, both in the USB interrupt.
+  * @retval None
+  */
+static void CDC_NotifyNext_FS(void)
+{
+  if ((notifyBusy != 0U) || (notifyTail == notifyHead))
+  {
+    return;
+  }
+  if (USBD_NTF_TransmitPacket(&hUsbDeviceFS, notifyQueue[notifyTail % CDC_NOTIFY_QUEUE], CDC_NOTIFY_LEN) == USBD_OK)
+  {
+    notifyBusy = 1;
+  }
+}
+
+/**
+  * @brief  CDC_NotifyCplt_FS
+  *         The host has read a notification, the next one follows.
+  * @retval None
+  */
+static void CDC_NotifyCplt_FS(void)
+{
+  notifyTail++;
+  notifyBusy = 0;
+  CDC_NotifyNext_FS();
+}
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
@@ -31,7 +31,7 @@
 #include "usbd_cdc.h"
 
 /* USER CODE BEGIN INCLUDE */
-
+#include "usbd_composite.h"
 /* USER CODE END INCLUDE */
 
 /** @addtogroup STM32_USB_OTG_DEVICE_LIBRARY
@@ -49,7 +49,17 @@
   * @{
   */
 /* USER CODE BEGIN EXPORTED_DEFINES */
-
+/* Shell ports (channels) of the composite device, see usbd_composite.h */
+#define CDC_CH_OPERATOR     0U  /* CDC ACM virtual COM port */
+#define CDC_CH_AUTOMATION   1U  /* Vendor bulk interface */
+#define CDC_CH_COUNT        2U
+
+/* Endpoints counted by the link statistics, EP0 control, EP1 CDC data, EP2 CDC notification, EP3 vendor */
+#define CDC_LINK_EP_COUNT   4U
+/* Shell event notification on the CDC notification endpoint (CDC_Notify_FS): the 8 byte
+   notification header with this vendor bNotification code, then the 4 byte event value */
+#define CDC_NOTIFY_SHELL_EVENT  0xE0U
+#define CDC_NOTIFY_LEN          12U
 /* USER CODE END EXPORTED_DEFINES */
 
 /**
@@ -62,6 +72,50 @@
   */
 
 /* USER CODE BEGIN EXPORTED_TYPES */
+/** Shell instance fed by a port (shell_ctx_t, CLI_SHELL.h) */
+struct shellCtxTypeDef;
+
+/** Shell transport table (shellTransport_t, CLI_SHELL.h) */
+struct shellTransportTypeDef;
+
+/** USB frame statistics, counted in the SOF interrupt */
+typedef struct
+{
+  uint32_t frames;              /*!< SOFs seen since the last clear                           */
+  uint32_t busyFrames;          /*!< Frames in which IN data packets completed                */
+  uint32_t inPackets;           /*!< IN data packets sent (ZLPs not counted)                  */
+  uint32_t maxPacketsPerFrame;  /*!< Most IN packets completed within one frame               */
+  uint32_t nakFrames;           /*!< Frames that started with IN data queued but no transfer
+                                     armed, so the host's IN tokens were NAKed                */
+} CDC_FrameStats_t;
+
+/** Bus events counted by CDC_LinkEvent_FS() */
+typedef enum
+{
+  CDC_LINK_RESET = 0,
+  CDC_LINK_SUSPEND,
+  CDC_LINK_RESUME,
+  CDC_LINK_CONNECT,
+  CDC_LINK_DISCONNECT,
+  CDC_LINK_EVENTS
+} CDC_LinkEvent_t;
+
+/** USB link health counters, all uint32_t so the snapshot layout is fixed */
+typedef struct
+{
+  uint32_t inTransfers[CDC_LINK_EP_COUNT];   /*!< IN transfers completed per endpoint      */
+  uint32_t inBytes[CDC_LINK_EP_COUNT];
+  uint32_t outTransfers[CDC_LINK_EP_COUNT];  /*!< OUT transfers received per endpoint      */
+  uint32_t outBytes[CDC_LINK_EP_COUNT];
+  uint32_t txBusy[CDC_CH_COUNT];             /*!< Transfers refused by the class (BUSY/FAIL) */
+  uint32_t txDropped[CDC_CH_COUNT];          /*!< Bytes the transmit queue had no room for */
+  uint32_t rxDropped[CDC_CH_COUNT];          /*!< Bytes the shell receive ring had no room for */
+  uint32_t rxHeld[CDC_CH_COUNT];             /*!< Times the OUT endpoint was held back (NAK)
+                                                  until the shell receive ring had room    */
+  uint32_t events[CDC_LINK_EVENTS];          /*!< CDC_LinkEvent_t                          */
+  uint32_t isrCount;                         /*!< OTG_FS interrupts                        */
+  uint32_t isrMaxCycles;                     /*!< Longest OTG_FS interrupt (core cycles)   */
+} CDC_LinkStats_t;
 
 /* USER CODE END EXPORTED_TYPES */
 
@@ -91,6 +145,10 @@
 extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 
 /* USER CODE BEGIN EXPORTED_VARIABLES */
+extern USBD_VND_ItfTypeDef USBD_VND_Interface_fops_FS;
+
+/** Shell transport over the CDC ACM and vendor ports, pass it to shellInit() */
+extern const struct shellTransportTypeDef CDC_Transport_FS;
 
 /* USER CODE END EXPORTED_VARIABLES */
 
@@ -106,7 +164,27 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_FS;
 uint8_t CDC_Transmit_FS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
-
+void CDC_AttachShell_FS(uint8_t Ch, struct shellCtxTypeDef* Shell);
+uint16_t CDC_Write_FS(uint8_t Ch, const uint8_t* Buf, uint16_t Len);
+void CDC_Flush_FS(void);
+uint32_t CDC_TxFree_FS(uint8_t Ch);
+uint32_t CDC_TxSpan_FS(uint8_t Ch, uint8_t** Buf);
+void CDC_TxCommit_FS(uint8_t Ch, uint16_t Len);
+uint32_t CDC_TxDropped_FS(uint8_t Ch);
+uint8_t CDC_StreamAttach_FS(uint8_t Ch);
+void CDC_RxResume_FS(uint8_t Ch);
+uint8_t CDC_StreamWrite_FS(const uint8_t* Buf, uint16_t Len);
+uint32_t CDC_StreamFree_FS(void);
+uint32_t CDC_StreamUsed_FS(void);
+void CDC_SOF_FS(void);
+const CDC_FrameStats_t* CDC_FrameStats_FS(void);
+void CDC_FrameStatsClear_FS(void);
+void CDC_LinkTransfer_FS(uint8_t EpAddr, uint32_t Len);
+void CDC_LinkEvent_FS(CDC_LinkEvent_t Event);
+void CDC_LinkIsr_FS(uint32_t Cycles);
+void CDC_LinkStats_FS(CDC_LinkStats_t* Stats);
+void CDC_LinkStatsClear_FS(void);
+uint8_t CDC_Notify_FS(uint8_t Ch, uint8_t Event, uint32_t Value);
 /* USER CODE END EXPORTED_FUNCTIONS */
 
 /**
@@ -0,0 +1,606 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_composite.c
+  * @brief          : CDC ACM + vendor bulk composite class for the CLI Shell ports.
+  ******************************************************************************
+  * The CDC ACM function is the unmodified ST class (USBD_CDC): every request
+  * and endpoint that is not the vendor interface's is passed through to it.
+  * The vendor interface has no class requests, only its bulk pair, so it is
+  * handled here directly. ZLPs follow the CDC class rules: a transfer of whole
+  * packets is closed with a ZLP while ep_in[].total_length is set.
+  * The class never sends on the CDC notification endpoint. Its completions are
+  * taken here as well, so they do not end a data transfer of the class.
+  * The MS OS 1.0 descriptors (USBD_MS_OS_DESC) are served here too: string
+  * 0xEE through GetUsrStrDescriptor and the Extended Compat ID as a vendor
+  * device request, naming WINUSB for the vendor interface.
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_composite.h"
+#include "usbd_ctlreq.h"
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  USBD_VND_ItfTypeDef *fops;
+  uint8_t *RxBuffer;
+  uint8_t *TxBuffer;
+  uint32_t RxLength;
+  uint32_t TxLength;
+  __IO uint32_t TxState;
+} USBD_VND_HandleTypeDef;
+
+typedef struct
+{
+  void (*TransmitCplt)(void);
+  __IO uint32_t TxState;
+} USBD_NTF_HandleTypeDef;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t USBD_COMPOSITE_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
+static uint8_t USBD_COMPOSITE_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx);
+static uint8_t USBD_COMPOSITE_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req);
+static uint8_t USBD_COMPOSITE_EP0_RxReady(USBD_HandleTypeDef *pdev);
+static uint8_t USBD_COMPOSITE_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum);
+static uint8_t USBD_COMPOSITE_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum);
+static uint8_t *USBD_COMPOSITE_GetCfgDesc(uint16_t *length);
+static uint8_t *USBD_COMPOSITE_GetDeviceQualifierDesc(uint16_t *length);
+#if (USBD_MS_OS_DESC == 1U)
+static uint8_t *USBD_COMPOSITE_GetUsrStrDesc(USBD_HandleTypeDef *pdev, uint8_t index, uint16_t *length);
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+static USBD_VND_HandleTypeDef hvnd;
+static USBD_NTF_HandleTypeDef hntf;
+
+USBD_ClassTypeDef USBD_COMPOSITE =
+{
+  USBD_COMPOSITE_Init,
+  USBD_COMPOSITE_DeInit,
+  USBD_COMPOSITE_Setup,
+  NULL,                 /* EP0_TxSent, */
+  USBD_COMPOSITE_EP0_RxReady,
+  USBD_COMPOSITE_DataIn,
+  USBD_COMPOSITE_DataOut,
+  NULL,
+  NULL,
+  NULL,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetCfgDesc,
+  USBD_COMPOSITE_GetDeviceQualifierDesc,
+#if (USBD_SUPPORT_USER_STRING == 1U)
+#if (USBD_MS_OS_DESC == 1U)
+  USBD_COMPOSITE_GetUsrStrDesc,
+#else
+  NULL,
+#endif
+#endif
+};
+
+/* USB Standard Device Qualifier Descriptor */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_DeviceQualifierDesc[USB_LEN_DEV_QUALIFIER_DESC] __ALIGN_END =
+{
+  USB_LEN_DEV_QUALIFIER_DESC,
+  USB_DESC_TYPE_DEVICE_QUALIFIER,
+  0x00,
+  0x02,
+  0xEF,
+  0x02,
+  0x01,
+  0x40,
+  0x01,
+  0x00,
+};
+
+/* Configuration Descriptor: IAD + CDC ACM (interfaces 0, 1) + vendor bulk (interface 2) */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_CfgDesc[USB_COMPOSITE_CONFIG_DESC_SIZ] __ALIGN_END =
+{
+  /*Configuration Descriptor*/
+  0x09,   /* bLength: Configuration Descriptor size */
+  USB_DESC_TYPE_CONFIGURATION,      /* bDescriptorType: Configuration */
+  LOBYTE(USB_COMPOSITE_CONFIG_DESC_SIZ),  /* wTotalLength:no of returned bytes */
+  HIBYTE(USB_COMPOSITE_CONFIG_DESC_SIZ),
+  0x03,   /* bNumInterfaces: 3 interfaces */
+  0x01,   /* bConfigurationValue: Configuration value */
+  0x00,   /* iConfiguration: Index of string descriptor describing the configuration */
+  0xC0,   /* bmAttributes: self powered */
+  0x32,   /* MaxPower 100 mA */
+
+  /*---------------------------------------------------------------------------*/
+
+  /*Interface Association Descriptor: CDC ACM function*/
+  0x08,   /* bLength */
+  0x0B,   /* bDescriptorType: IAD */
+  0x00,   /* bFirstInterface */
+  0x02,   /* bInterfaceCount */
+  0x02,   /* bFunctionClass: CDC */
+  0x02,   /* bFunctionSubClass: ACM */
+  0x01,   /* bFunctionProtocol: AT commands */
+  0x00,   /* iFunction */
+
+  /*Interface Descriptor */
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  0x00,   /* bInterfaceNumber: Number of Interface */
+  0x00,   /* bAlternateSetting: Alternate setting */
+  0x01,   /* bNumEndpoints: One endpoints used */
+  0x02,   /* bInterfaceClass: Communication Interface Class */
+  0x02,   /* bInterfaceSubClass: Abstract Control Model */
+  0x01,   /* bInterfaceProtocol: Common AT commands */
+  0x00,   /* iInterface: */
+
+  /*Header Functional Descriptor*/
+  0x05,   /* bLength: Endpoint Descriptor size */
+  0x24,   /* bDescriptorType: CS_INTERFACE */
+  0x00,   /* bDescriptorSubtype: Header Func Desc */
+  0x10,   /* bcdCDC: spec release number */
+  0x01,
+
+  /*Call Management Functional Descriptor*/
+  0x05,   /* bFunctionLength */
+  0x24,   /* bDescriptorType: CS_INTERFACE */
+  0x01,   /* bDescriptorSubtype: Call Management Func Desc */
+  0x00,   /* bmCapabilities: D0+D1 */
+  0x01,   /* bDataInterface: 1 */
+
+  /*ACM Functional Descriptor*/
+  0x04,   /* bFunctionLength */
+  0x24,   /* bDescriptorType: CS_INTERFACE */
+  0x02,   /* bDescriptorSubtype: Abstract Control Management desc */
+  0x02,   /* bmCapabilities */
+
+  /*Union Functional Descriptor*/
+  0x05,   /* bFunctionLength */
+  0x24,   /* bDescriptorType: CS_INTERFACE */
+  0x06,   /* bDescriptorSubtype: Union func desc */
+  0x00,   /* bMasterInterface: Communication class interface */
+  0x01,   /* bSlaveInterface0: Data Class Interface */
+
+  /*Endpoint 2 Descriptor*/
+  0x07,                           /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,   /* bDescriptorType: Endpoint */
+  CDC_CMD_EP,                     /* bEndpointAddress */
+  0x03,                           /* bmAttributes: Interrupt */
+  LOBYTE(CDC_CMD_PACKET_SIZE),     /* wMaxPacketSize: */
+  HIBYTE(CDC_CMD_PACKET_SIZE),
+  CDC_FS_BINTERVAL,                           /* bInterval: */
+
+  /*Data class interface descriptor*/
+  0x09,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: */
+  0x01,   /* bInterfaceNumber: Number of Interface */
+  0x00,   /* bAlternateSetting: Alternate setting */
+  0x02,   /* bNumEndpoints: Two endpoints used */
+  0x0A,   /* bInterfaceClass: CDC */
+  0x00,   /* bInterfaceSubClass: */
+  0x00,   /* bInterfaceProtocol: */
+  0x00,   /* iInterface: */
+
+  /*Endpoint OUT Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  CDC_OUT_EP,                        /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),
+  0x00,                              /* bInterval: ignore for Bulk transfer */
+
+  /*Endpoint IN Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  CDC_IN_EP,                         /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(CDC_DATA_FS_MAX_PACKET_SIZE),
+  0x00,                              /* bInterval: ignore for Bulk transfer */
+
+  /*---------------------------------------------------------------------------*/
+
+  /*Vendor interface descriptor*/
+  0x09,   /* bLength: Interface Descriptor size */
+  USB_DESC_TYPE_INTERFACE,  /* bDescriptorType: Interface */
+  VND_INTERFACE,  /* bInterfaceNumber: Number of Interface */
+  0x00,   /* bAlternateSetting: Alternate setting */
+  0x02,   /* bNumEndpoints: Two endpoints used */
+  0xFF,   /* bInterfaceClass: Vendor specific */
+  0x00,   /* bInterfaceSubClass: */
+  0x00,   /* bInterfaceProtocol: */
+  0x00,   /* iInterface: */
+
+  /*Endpoint OUT Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  VND_OUT_EP,                        /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(VND_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(VND_DATA_FS_MAX_PACKET_SIZE),
+  0x00,                              /* bInterval: ignore for Bulk transfer */
+
+  /*Endpoint IN Descriptor*/
+  0x07,   /* bLength: Endpoint Descriptor size */
+  USB_DESC_TYPE_ENDPOINT,      /* bDescriptorType: Endpoint */
+  VND_IN_EP,                         /* bEndpointAddress */
+  0x02,                              /* bmAttributes: Bulk */
+  LOBYTE(VND_DATA_FS_MAX_PACKET_SIZE),  /* wMaxPacketSize: */
+  HIBYTE(VND_DATA_FS_MAX_PACKET_SIZE),
+  0x00                               /* bInterval: ignore for Bulk transfer */
+};
+
+#if (USBD_MS_OS_DESC == 1U)
+/* MS OS string descriptor: signature and the bRequest of the feature requests */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_MsOsStrDesc[USBD_MS_OS_STRING_DESC_SIZ] __ALIGN_END =
+{
+  USBD_MS_OS_STRING_DESC_SIZ,  /* bLength */
+  USB_DESC_TYPE_STRING,        /* bDescriptorType */
+  'M', 0x00, 'S', 0x00, 'F', 0x00, 'T', 0x00, '1', 0x00, '0', 0x00, '0', 0x00,  /* qwSignature: "MSFT100" */
+  USBD_MS_OS_VENDOR_CODE,      /* bMS_VendorCode */
+  0x00                         /* bPad */
+};
+
+/* Extended Compat ID OS feature descriptor: WinUSB for the vendor interface */
+__ALIGN_BEGIN static uint8_t USBD_COMPOSITE_CompatIdDesc[USBD_MS_OS_COMPAT_ID_DESC_SIZ] __ALIGN_END =
+{
+  USBD_MS_OS_COMPAT_ID_DESC_SIZ, 0x00, 0x00, 0x00,  /* dwLength */
+  0x00, 0x01,                  /* bcdVersion: 1.00 */
+  LOBYTE(USBD_MS_OS_COMPAT_ID_INDEX),  /* wIndex: Extended Compat ID */
+  HIBYTE(USBD_MS_OS_COMPAT_ID_INDEX),
+  0x01,                        /* bCount: one function section */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* Reserved */
+
+  VND_INTERFACE,               /* bFirstInterfaceNumber */
+  0x01,                        /* Reserved */
+  'W', 'I', 'N', 'U', 'S', 'B', 0x00, 0x00,  /* compatibleID */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  /* subCompatibleID */
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* Reserved */
+};
+#endif
+
+/* Private functions ---------------------------------------------------------*/
+/**
+  * @brief  USBD_COMPOSITE_Init
+  *         Initialize the CDC function and the vendor interface
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_Init(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  /* A notification cut off by a reset never completes */
+  hntf.TxState = 0U;
+
+  uint8_t ret = USBD_CDC.Init(pdev, cfgidx);
+
+  USBD_LL_OpenEP(pdev, VND_IN_EP, USBD_EP_TYPE_BULK, VND_DATA_FS_MAX_PACKET_SIZE);
+  pdev->ep_in[VND_IN_EP & 0xFU].is_used = 1U;
+
+  USBD_LL_OpenEP(pdev, VND_OUT_EP, USBD_EP_TYPE_BULK, VND_DATA_FS_MAX_PACKET_SIZE);
+  pdev->ep_out[VND_OUT_EP & 0xFU].is_used = 1U;
+
+  hvnd.TxState = 0U;
+  if (hvnd.fops != NULL)
+  {
+    hvnd.fops->Init();
+    USBD_VND_ReceivePacket(pdev);
+  }
+
+  return ret;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DeInit
+  *         DeInitialize both functions
+  * @param  pdev: device instance
+  * @param  cfgidx: Configuration index
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_DeInit(USBD_HandleTypeDef *pdev, uint8_t cfgidx)
+{
+  USBD_LL_CloseEP(pdev, VND_IN_EP);
+  pdev->ep_in[VND_IN_EP & 0xFU].is_used = 0U;
+  USBD_LL_CloseEP(pdev, VND_OUT_EP);
+  pdev->ep_out[VND_OUT_EP & 0xFU].is_used = 0U;
+
+  if (hvnd.fops != NULL)
+  {
+    hvnd.fops->DeInit();
+  }
+  hvnd.TxState = 0U;
+  hntf.TxState = 0U;
+
+  return USBD_CDC.DeInit(pdev, cfgidx);
+}
+
+/**
+  * @brief  USBD_COMPOSITE_Setup
+  *         The vendor interface defines no requests of its own, everything else
+  *         (standard requests included) is answered by the CDC class, except the
+  *         MS OS Extended Compat ID request.
+  * @param  pdev: device instance
+  * @param  req: usb requests
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_Setup(USBD_HandleTypeDef *pdev, USBD_SetupReqTypedef *req)
+{
+#if (USBD_MS_OS_DESC == 1U)
+  if (((req->bmRequest & USB_REQ_RECIPIENT_MASK) == USB_REQ_RECIPIENT_DEVICE) &&
+      ((req->bmRequest & USB_REQ_TYPE_MASK) == USB_REQ_TYPE_VENDOR) &&
+      (req->bRequest == USBD_MS_OS_VENDOR_CODE))
+  {
+    if ((req->wIndex != USBD_MS_OS_COMPAT_ID_INDEX) || ((req->bmRequest & 0x80U) == 0U))
+    {
+      USBD_CtlError(pdev, req);
+      return USBD_FAIL;
+    }
+    USBD_CtlSendData(pdev, USBD_COMPOSITE_CompatIdDesc,
+                     MIN(USBD_MS_OS_COMPAT_ID_DESC_SIZ, req->wLength));
+    return USBD_OK;
+  }
+#endif
+
+  if (((req->bmRequest & USB_REQ_RECIPIENT_MASK) == USB_REQ_RECIPIENT_INTERFACE) &&
+      (LOBYTE(req->wIndex) == VND_INTERFACE) &&
+      ((req->bmRequest & USB_REQ_TYPE_MASK) != USB_REQ_TYPE_STANDARD))
+  {
+    USBD_CtlError(pdev, req);
+    return USBD_FAIL;
+  }
+
+  return USBD_CDC.Setup(pdev, req);
+}
+
+/**
+  * @brief  USBD_COMPOSITE_EP0_RxReady
+  *         Data stage of a CDC class request (e.g. SET_LINE_CODING)
+  * @param  pdev: device instance
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_EP0_RxReady(USBD_HandleTypeDef *pdev)
+{
+  return USBD_CDC.EP0_RxReady(pdev);
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DataIn
+  *         Data sent on a non-control IN endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint number
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_DataIn(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+  if (epnum == (CDC_CMD_EP & 0xFU))
+  {
+    hntf.TxState = 0U;
+    if (hntf.TransmitCplt != NULL)
+    {
+      hntf.TransmitCplt();
+    }
+    return USBD_OK;
+  }
+
+  if (epnum != (VND_IN_EP & 0xFU))
+  {
+    return USBD_CDC.DataIn(pdev, epnum);
+  }
+
+  if ((pdev->ep_in[epnum].total_length > 0U) &&
+      ((pdev->ep_in[epnum].total_length % VND_DATA_FS_MAX_PACKET_SIZE) == 0U))
+  {
+    /* Send ZLP */
+    pdev->ep_in[epnum].total_length = 0U;
+    USBD_LL_Transmit(pdev, VND_IN_EP, NULL, 0U);
+  }
+  else
+  {
+    hvnd.TxState = 0U;
+    if (hvnd.fops != NULL)
+    {
+      hvnd.fops->TransmitCplt(hvnd.TxBuffer, &hvnd.TxLength, epnum);
+    }
+  }
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_DataOut
+  *         Data received on a non-control OUT endpoint
+  * @param  pdev: device instance
+  * @param  epnum: endpoint number
+  * @retval status
+  */
+static uint8_t USBD_COMPOSITE_DataOut(USBD_HandleTypeDef *pdev, uint8_t epnum)
+{
+  if (epnum != (VND_OUT_EP & 0xFU))
+  {
+    return USBD_CDC.DataOut(pdev, epnum);
+  }
+
+  hvnd.RxLength = USBD_LL_GetRxDataSize(pdev, epnum);
+  if (hvnd.fops != NULL)
+  {
+    hvnd.fops->Receive(hvnd.RxBuffer, &hvnd.RxLength);
+  }
+
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_GetCfgDesc
+  *         Full speed only, so every speed returns the same descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_COMPOSITE_GetCfgDesc(uint16_t *length)
+{
+  *length = sizeof(USBD_COMPOSITE_CfgDesc);
+  return USBD_COMPOSITE_CfgDesc;
+}
+
+/**
+  * @brief  USBD_COMPOSITE_GetDeviceQualifierDesc
+  *         return Device Qualifier descriptor
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer
+  */
+static uint8_t *USBD_COMPOSITE_GetDeviceQualifierDesc(uint16_t *length)
+{
+  *length = sizeof(USBD_COMPOSITE_DeviceQualifierDesc);
+  return USBD_COMPOSITE_DeviceQualifierDesc;
+}
+
+#if (USBD_MS_OS_DESC == 1U)
+/**
+  * @brief  USBD_COMPOSITE_GetUsrStrDesc
+  *         return the MS OS string descriptor, the device has no other
+  *         strings beyond the standard ones
+  * @param  pdev: device instance
+  * @param  index : string index
+  * @param  length : pointer data length
+  * @retval pointer to descriptor buffer, length 0 after stalling EP0
+  */
+static uint8_t *USBD_COMPOSITE_GetUsrStrDesc(USBD_HandleTypeDef *pdev, uint8_t index, uint16_t *length)
+{
+  if (index == USBD_MS_OS_STRING_IDX)
+  {
+    *length = sizeof(USBD_COMPOSITE_MsOsStrDesc);
+    return USBD_COMPOSITE_MsOsStrDesc;
+  }
+
+  USBD_CtlError(pdev, &pdev->request);
+  *length = 0U;
+  return USBD_COMPOSITE_MsOsStrDesc;
+}
+#endif
+
+/* Exported functions --------------------------------------------------------*/
+/**
+  * @brief  USBD_VND_RegisterInterface
+  * @param  pdev: device instance
+  * @param  fops: vendor interface callbacks
+  * @retval status
+  */
+uint8_t USBD_VND_RegisterInterface(USBD_HandleTypeDef *pdev, USBD_VND_ItfTypeDef *fops)
+{
+  UNUSED(pdev);
+
+  if (fops == NULL)
+  {
+    return USBD_FAIL;
+  }
+  hvnd.fops = fops;
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_VND_SetRxBuffer
+  *         Buffer the next OUT packet is received into (one packet, 64 bytes)
+  * @param  pdev: device instance
+  * @param  pbuff: Rx Buffer
+  * @retval status
+  */
+uint8_t USBD_VND_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff)
+{
+  UNUSED(pdev);
+
+  hvnd.RxBuffer = pbuff;
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_VND_ReceivePacket
+  *         Arms the OUT endpoint with the Rx buffer
+  * @param  pdev: device instance
+  * @retval status
+  */
+uint8_t USBD_VND_ReceivePacket(USBD_HandleTypeDef *pdev)
+{
+  if ((pdev->pClassData == NULL) || (hvnd.RxBuffer == NULL))
+  {
+    return USBD_FAIL;
+  }
+  USBD_LL_PrepareReceive(pdev, VND_OUT_EP, hvnd.RxBuffer, VND_DATA_FS_MAX_PACKET_SIZE);
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_VND_TransmitPacket
+  *         Starts an IN transfer, several packets long if needed
+  * @param  pdev: device instance
+  * @param  pbuff: data to send
+  * @param  length: number of bytes
+  * @retval USBD_OK, USBD_BUSY while a transfer runs or USBD_FAIL if not configured
+  */
+uint8_t USBD_VND_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t *pbuff, uint32_t length)
+{
+  if (pdev->pClassData == NULL)
+  {
+    return USBD_FAIL;
+  }
+  if (hvnd.TxState != 0U)
+  {
+    return USBD_BUSY;
+  }
+
+  hvnd.TxState = 1U;
+  hvnd.TxBuffer = pbuff;
+  hvnd.TxLength = length;
+  pdev->ep_in[VND_IN_EP & 0xFU].total_length = length;
+  USBD_LL_Transmit(pdev, VND_IN_EP, pbuff, (uint16_t)length);
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_VND_TxBusy
+  * @param  pdev: device instance
+  * @retval 1 while an IN transfer (or its ZLP) is running
+  */
+uint8_t USBD_VND_TxBusy(USBD_HandleTypeDef *pdev)
+{
+  UNUSED(pdev);
+
+  return (hvnd.TxState != 0U) ? 1U : 0U;
+}
+
+/**
+  * @brief  USBD_NTF_RegisterCallback
+  * @param  pdev: device instance
+  * @param  TransmitCplt: called from the DataIn stage once a notification is sent
+  * @retval status
+  */
+uint8_t USBD_NTF_RegisterCallback(USBD_HandleTypeDef *pdev, void (*TransmitCplt)(void))
+{
+  UNUSED(pdev);
+
+  hntf.TransmitCplt = TransmitCplt;
+  return USBD_OK;
+}
+
+/**
+  * @brief  USBD_NTF_TransmitPacket
+  *         Sends a notification on the CDC notification endpoint. Several packets
+  *         of CDC_CMD_PACKET_SIZE if needed, never a multiple of it (no ZLP).
+  * @param  pdev: device instance
+  * @param  pbuff: notification (header and data)
+  * @param  length: number of bytes
+  * @retval USBD_OK, USBD_BUSY while one is sent or USBD_FAIL if not configured
+  */
+uint8_t USBD_NTF_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t *pbuff, uint16_t length)
+{
+  if ((pdev->pClassData == NULL) || (pdev->dev_state != USBD_STATE_CONFIGURED))
+  {
+    return USBD_FAIL;
+  }
+  if (hntf.TxState != 0U)
+  {
+    return USBD_BUSY;
+  }
+
+  hntf.TxState = 1U;
+  USBD_LL_Transmit(pdev, CDC_CMD_EP, pbuff, length);
+  return USBD_OK;
+}
@@ -0,0 +1,79 @@
+/* USER CODE BEGIN Header */
+/**
+  ******************************************************************************
+  * @file           : usbd_composite.h
+  * @brief          : CDC ACM + vendor bulk composite class for the CLI Shell ports.
+  ******************************************************************************
+  * The device exposes two shell ports:
+  *  - Interfaces 0/1: CDC ACM (virtual COM port) for the operator terminal,
+  *    EP 0x81/0x01 data and EP 0x82 notification. Handled by the ST CDC class,
+  *    except the notification endpoint, which carries the shell event records
+  *    (USBD_NTF_TransmitPacket, CDC_Notify_FS).
+  *  - Interface 2: vendor specific bulk pair for automation (libusb, WinUSB),
+  *    EP 0x83/0x03. No serial driver or line coding on the path, the shell's
+  *    binary protocol goes straight to the bulk pipes. With USBD_MS_OS_DESC the
+  *    device answers the MS OS 1.0 requests (string 0xEE, Extended Compat ID
+  *    "WINUSB"), so Windows binds WinUSB on its own. Windows reads them once
+  *    per VID/PID/bcdDevice: a device seen before needs its usbflags registry
+  *    key removed. Linux and macOS need no driver. The host client is
+  *    Tools/shell_usb.py (libusb through pyusb), shell_client.py opens the
+  *    same link as port "usb[:<serial>]".
+  * The OTG FS core of the F411 has three IN endpoints besides EP0, so a second
+  * CDC ACM function (data IN + notification IN) does not fit next to the first.
+  ******************************************************************************
+  */
+/* USER CODE END Header */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __USBD_COMPOSITE_H__
+#define __USBD_COMPOSITE_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "usbd_ioreq.h"
+#include "usbd_cdc.h"
+
+/* Exported defines ----------------------------------------------------------*/
+#define VND_IN_EP                       0x83U  /* EP3 for vendor data IN */
+#define VND_OUT_EP                      0x03U  /* EP3 for vendor data OUT */
+#define VND_INTERFACE                   0x02U
+#define VND_DATA_FS_MAX_PACKET_SIZE     64U
+
+#define USBD_MS_OS_STRING_IDX           0xEEU  /* String index Windows reads the signature from */
+#define USBD_MS_OS_VENDOR_CODE          0x20U  /* bRequest of the MS OS feature requests */
+#define USBD_MS_OS_COMPAT_ID_INDEX      0x0004U
+#define USBD_MS_OS_STRING_DESC_SIZ      0x12U
+#define USBD_MS_OS_COMPAT_ID_DESC_SIZ   0x28U  /* Header and one function section */
+
+#define USB_COMPOSITE_CONFIG_DESC_SIZ   (USB_CDC_CONFIG_DESC_SIZ + 8U + 23U)
+
+/* Exported types ------------------------------------------------------------*/
+/** Application callbacks of the vendor interface, same shape as USBD_CDC_ItfTypeDef */
+typedef struct
+{
+  int8_t (* Init)          (void);
+  int8_t (* DeInit)        (void);
+  int8_t (* Receive)       (uint8_t *Buf, uint32_t *Len);
+  int8_t (* TransmitCplt)  (uint8_t *Buf, uint32_t *Len, uint8_t epnum);
+} USBD_VND_ItfTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern USBD_ClassTypeDef USBD_COMPOSITE;
+
+/* Exported functions --------------------------------------------------------*/
+uint8_t USBD_VND_RegisterInterface(USBD_HandleTypeDef *pdev, USBD_VND_ItfTypeDef *fops);
+uint8_t USBD_VND_SetRxBuffer(USBD_HandleTypeDef *pdev, uint8_t *pbuff);
+uint8_t USBD_VND_ReceivePacket(USBD_HandleTypeDef *pdev);
+uint8_t USBD_VND_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t *pbuff, uint32_t length);
+uint8_t USBD_VND_TxBusy(USBD_HandleTypeDef *pdev);
+uint8_t USBD_NTF_RegisterCallback(USBD_HandleTypeDef *pdev, void (*TransmitCplt)(void));
+uint8_t USBD_NTF_TransmitPacket(USBD_HandleTypeDef *pdev, uint8_t *pbuff, uint16_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __USBD_COMPOSITE_H__ */
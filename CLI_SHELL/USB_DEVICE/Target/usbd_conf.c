@@ -26,7 +26,10 @@
 #include "usbd_core.h"
 
 /* USER CODE BEGIN Includes */
-
+#include "usbd_cdc_if.h"
+#include "CLI_SHELL_BOOT.h"
+#include "CLI_SHELL_SUSPEND.h"
+#include "CLI_SHELL_TSYNC.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -45,6 +48,13 @@ void Error_Handler(void);
 void SystemClock_Config(void);
 
 /* USER CODE BEGIN 0 */
+_Static_assert((USBD_FS_RX_FIFO_WORDS + USBD_FS_EP0_TX_FIFO_WORDS + USBD_FS_EP1_TX_FIFO_WORDS +
+                USBD_FS_EP2_TX_FIFO_WORDS + USBD_FS_EP3_TX_FIFO_WORDS) <= USBD_FS_FIFO_TOTAL_WORDS, "OTG FS FIFOs exceed 1.25 KB");
+_Static_assert(USBD_FS_EP1_TX_FIFO_WORDS >= 32U, "CDC IN FIFO must hold two full packets");
+_Static_assert(USBD_FS_EP3_TX_FIFO_WORDS >= 32U, "Vendor IN FIFO must hold two full packets");
+
+/* Device mode registers of the core behind a PCD handle (USBx_DEVICE of stm32f4xx_ll_usb.h) */
+#define PCD_DEVICE_REGS(hpcd)   ((USB_OTG_DeviceTypeDef *)((uint32_t)(hpcd)->Instance + USB_OTG_DEVICE_BASE))
 
 /* USER CODE END 0 */
 
@@ -93,6 +103,12 @@ void HAL_PCD_MspInit(PCD_HandleTypeDef* pcdHandle)
     HAL_NVIC_SetPriority(OTG_FS_IRQn, 0, 0);
     HAL_NVIC_EnableIRQ(OTG_FS_IRQn);
   /* USER CODE BEGIN USB_OTG_FS_MspInit 1 */
+    /* Resume and reset signalling wake the core from STOP (CLI_SHELL_SUSPEND.h) */
+    __HAL_USB_OTG_FS_WAKEUP_EXTI_CLEAR_FLAG();
+    __HAL_USB_OTG_FS_WAKEUP_EXTI_ENABLE_RISING_EDGE();
+    __HAL_USB_OTG_FS_WAKEUP_EXTI_ENABLE_IT();
+    HAL_NVIC_SetPriority(OTG_FS_WKUP_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(OTG_FS_WKUP_IRQn);
 
   /* USER CODE END USB_OTG_FS_MspInit 1 */
   }
@@ -149,6 +165,8 @@ static void PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
 void HAL_PCD_DataOutStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
+  /* Counted first, the class arms the next OUT transfer from inside the stage */
+  CDC_LinkTransfer_FS(epnum, hpcd->OUT_ep[epnum].xfer_count);
   USBD_LL_DataOutStage((USBD_HandleTypeDef*)hpcd->pData, epnum, hpcd->OUT_ep[epnum].xfer_buff);
 }
 
@@ -164,6 +182,7 @@ static void PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
 void HAL_PCD_DataInStageCallback(PCD_HandleTypeDef *hpcd, uint8_t epnum)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
+  CDC_LinkTransfer_FS(epnum | 0x80U, hpcd->IN_ep[epnum].xfer_count);
   USBD_LL_DataInStage((USBD_HandleTypeDef*)hpcd->pData, epnum, hpcd->IN_ep[epnum].xfer_buff);
 }
 
@@ -178,7 +197,10 @@ static void PCD_SOFCallback(PCD_HandleTypeDef *hpcd)
 void HAL_PCD_SOFCallback(PCD_HandleTypeDef *hpcd)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
+  /* Frame number and cycle count first, the time sync depends on a steady latency */
+  shellTsyncSof((PCD_DEVICE_REGS(hpcd)->DSTS & USB_OTG_DSTS_FNSOF) >> USB_OTG_DSTS_FNSOF_Pos);
   USBD_LL_SOF((USBD_HandleTypeDef*)hpcd->pData);
+  CDC_SOF_FS();
 }
 
 /**
@@ -203,6 +225,9 @@ void HAL_PCD_ResetCallback(PCD_HandleTypeDef *hpcd)
 
   /* Reset Device. */
   USBD_LL_Reset((USBD_HandleTypeDef*)hpcd->pData);
+  CDC_LinkEvent_FS(CDC_LINK_RESET);
+  shellSuspendWake();
+  shellBootStamp(bootStage_usbReset);
 }
 
 /**
@@ -219,14 +244,13 @@ void HAL_PCD_SuspendCallback(PCD_HandleTypeDef *hpcd)
 {
   /* Inform USB library that core enters in suspend Mode. */
   USBD_LL_Suspend((USBD_HandleTypeDef*)hpcd->pData);
+  CDC_LinkEvent_FS(CDC_LINK_SUSPEND);
   __HAL_PCD_GATE_PHYCLOCK(hpcd);
   /* Enter in STOP mode. */
   /* USER CODE BEGIN 2 */
-  if (hpcd->Init.low_power_enable)
-  {
-    /* Set SLEEPDEEP bit and SleepOnExit of Cortex System Control Register. */
-    SCB->SCR |= (uint32_t)((uint32_t)(SCB_SCR_SLEEPDEEP_Msk | SCB_SCR_SLEEPONEXIT_Msk));
-  }
+  /* The main loop enters STOP and brings the clocks back itself, the session is kept.
+     low_power_enable stays off: sleep-on-exit would stop the core before the main loop. */
+  shellSuspendEnter();
   /* USER CODE END 2 */
 }
 
@@ -243,7 +267,8 @@ void HAL_PCD_ResumeCallback(PCD_HandleTypeDef *hpcd)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
   /* USER CODE BEGIN 3 */
-
+  CDC_LinkEvent_FS(CDC_LINK_RESUME);
+  shellSuspendWake();
   /* USER CODE END 3 */
   USBD_LL_Resume((USBD_HandleTypeDef*)hpcd->pData);
 }
@@ -290,6 +315,7 @@ void HAL_PCD_ConnectCallback(PCD_HandleTypeDef *hpcd)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
   USBD_LL_DevConnected((USBD_HandleTypeDef*)hpcd->pData);
+  CDC_LinkEvent_FS(CDC_LINK_CONNECT);
 }
 
 /**
@@ -304,6 +330,7 @@ void HAL_PCD_DisconnectCallback(PCD_HandleTypeDef *hpcd)
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
 {
   USBD_LL_DevDisconnected((USBD_HandleTypeDef*)hpcd->pData);
+  CDC_LinkEvent_FS(CDC_LINK_DISCONNECT);
 }
 
 /*******************************************************************************
@@ -328,7 +355,7 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   hpcd_USB_OTG_FS.Init.speed = PCD_SPEED_FULL;
   hpcd_USB_OTG_FS.Init.dma_enable = DISABLE;
   hpcd_USB_OTG_FS.Init.phy_itface = PCD_PHY_EMBEDDED;
-  hpcd_USB_OTG_FS.Init.Sof_enable = DISABLE;
+  hpcd_USB_OTG_FS.Init.Sof_enable = ENABLE;
   hpcd_USB_OTG_FS.Init.low_power_enable = DISABLE;
   hpcd_USB_OTG_FS.Init.lpm_enable = DISABLE;
   hpcd_USB_OTG_FS.Init.vbus_sensing_enable = DISABLE;
@@ -353,9 +380,11 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   HAL_PCD_RegisterIsoOutIncpltCallback(&hpcd_USB_OTG_FS, PCD_ISOOUTIncompleteCallback);
   HAL_PCD_RegisterIsoInIncpltCallback(&hpcd_USB_OTG_FS, PCD_ISOINIncompleteCallback);
 #endif /* USE_HAL_PCD_REGISTER_CALLBACKS */
-  HAL_PCDEx_SetRxFiFo(&hpcd_USB_OTG_FS, 0x80);
-  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 0, 0x40);
-  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 1, 0x80);
+  HAL_PCDEx_SetRxFiFo(&hpcd_USB_OTG_FS, USBD_FS_RX_FIFO_WORDS);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 0, USBD_FS_EP0_TX_FIFO_WORDS);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 1, USBD_FS_EP1_TX_FIFO_WORDS);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 2, USBD_FS_EP2_TX_FIFO_WORDS);
+  HAL_PCDEx_SetTxFiFo(&hpcd_USB_OTG_FS, 3, USBD_FS_EP3_TX_FIFO_WORDS);
   }
   return USBD_OK;
 }
@@ -36,7 +36,56 @@
 #include "stm32f4xx_hal.h"
 
 /* USER CODE BEGIN INCLUDE */
+#include "CLI_SHELL_POOL.h"
+#include "CLI_SHELL_ITM.h"
+
+/* OTG FS FIFO layout in 32-bit words. The F411 has 320 words (1.25 KB) for all FIFOs.
+ * RX holds several 64 byte OUT packets plus their status words, so the host can keep
+ * sending while the core is busy. The data IN FIFOs of both shell ports (EP1 CDC, EP3
+ * vendor) hold several full packets, so multi-packet transfers never wait for the FIFO
+ * between packets. EP0 and the CDC notification endpoint (EP2) need one packet each
+ * (16 words minimum). */
+#ifndef USBD_FS_RX_FIFO_WORDS
+#define USBD_FS_RX_FIFO_WORDS       0x60U
+#endif
+#ifndef USBD_FS_EP0_TX_FIFO_WORDS
+#define USBD_FS_EP0_TX_FIFO_WORDS   0x10U
+#endif
+#ifndef USBD_FS_EP1_TX_FIFO_WORDS
+#define USBD_FS_EP1_TX_FIFO_WORDS   0x80U
+#endif
+#ifndef USBD_FS_EP2_TX_FIFO_WORDS
+#define USBD_FS_EP2_TX_FIFO_WORDS   0x10U
+#endif
+#ifndef USBD_FS_EP3_TX_FIFO_WORDS
+#define USBD_FS_EP3_TX_FIFO_WORDS   0x40U
+#endif
+#define USBD_FS_FIFO_TOTAL_WORDS    320U
+
+/* IN transfer scheduling. 0: CDC_Flush_FS starts a transfer as soon as the main loop flushes.
+ * 1: transfers are only started from the 1 ms SOF interrupt, so every write made within a
+ * frame goes out together, for at most 1 ms of added latency. A running transfer chains the
+ * next one from its completion in both modes. The SOF interrupt also counts the frame
+ * statistics (CDC_FrameStats_FS), so it is enabled either way. */
+#ifndef USBD_SOF_TX_FLUSH
+#define USBD_SOF_TX_FLUSH           0U
+#endif
+
+/* Polling interval of the CDC notification endpoint (EP2) in frames. Shell event notifications
+ * (CDC_Notify_FS) reach the host within this many ms. The ST class default is 16. */
+#ifndef CDC_FS_BINTERVAL
+#define CDC_FS_BINTERVAL            0x01U
+#endif
 
+/* MS OS 1.0 descriptors of the vendor interface (usbd_composite.c). 1: Windows binds WinUSB to
+ * interface 2 without an INF or driver package, libusb and the WinUSB API open it directly.
+ * Needs the class hook for string index 0xEE (USBD_SUPPORT_USER_STRING). */
+#ifndef USBD_MS_OS_DESC
+#define USBD_MS_OS_DESC             1U
+#endif
+#if (USBD_MS_OS_DESC == 1U)
+#define USBD_SUPPORT_USER_STRING    1U
+#endif
 /* USER CODE END INCLUDE */
 
 /** @addtogroup USBD_OTG_DRIVER
@@ -64,7 +113,7 @@
   */
 
 /*---------- -----------*/
-#define USBD_MAX_NUM_INTERFACES     1U
+#define USBD_MAX_NUM_INTERFACES     3U
 /*---------- -----------*/
 #define USBD_MAX_NUM_CONFIGURATION     1U
 /*---------- -----------*/
@@ -92,11 +141,11 @@
 
 /* Memory management macros */
 
-/** Alias for memory allocation. */
-#define USBD_malloc         malloc
+/** Alias for memory allocation (static block pool, no heap). */
+#define USBD_malloc         shellPoolAlloc
 
 /** Alias for memory release. */
-#define USBD_free           free
+#define USBD_free           shellPoolFree
 
 /** Alias for memory set. */
 #define USBD_memset         memset
@@ -107,28 +156,23 @@
 /** Alias for delay. */
 #define USBD_Delay          HAL_Delay
 
-/* DEBUG macros */
+/* DEBUG macros, over SWO (CLI_SHELL_ITM.h) with the shell log levels */
 
 #if (USBD_DEBUG_LEVEL > 0)
-#define USBD_UsrLog(...)    printf(__VA_ARGS__);\
-                            printf("\n");
+#define USBD_UsrLog(...)    SHELL_LOG(SHELL_LOG_INFO, __VA_ARGS__);
 #else
 #define USBD_UsrLog(...)
 #endif
 
 #if (USBD_DEBUG_LEVEL > 1)
 
-#define USBD_ErrLog(...)    printf("ERROR: ") ;\
-                            printf(__VA_ARGS__);\
-                            printf("\n");
+#define USBD_ErrLog(...)    SHELL_LOG(SHELL_LOG_ERR, __VA_ARGS__);
 #else
 #define USBD_ErrLog(...)
 #endif
 
 #if (USBD_DEBUG_LEVEL > 2)
-#define USBD_DbgLog(...)    printf("DEBUG : ") ;\
-                            printf(__VA_ARGS__);\
-                            printf("\n");
+#define USBD_DbgLog(...)    SHELL_LOG(SHELL_LOG_DBG, __VA_ARGS__);
 #else
 #define USBD_DbgLog(...)
 #endif